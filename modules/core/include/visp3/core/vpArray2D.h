@@ -48,6 +48,7 @@
 
 #include <visp3/core/vpConfig.h>
 #include <visp3/core/vpException.h>
+#include <visp3/core/vpArrayWorkspace.h>
 
 /*!
   \class vpArray2D
@@ -78,6 +79,12 @@ protected:
   Type **rowPtrs;
   //! Current array size (rowNum * colNum)
   unsigned int dsize;
+  //! True if data and rowPtrs are allocated by the array, false if they are bound to an external storage
+  bool ownMemory;
+  //! Workspace providing the storage when the array is resized, or NULL
+  vpArrayWorkspace *workspace;
+  //! True if data and rowPtrs are served by the workspace
+  bool workspaceMemory;
 
 public:
   //! Address of the first element of the data array
@@ -89,13 +96,13 @@ public:
   Number of columns and rows are set to zero.
   */
   vpArray2D<Type>()
-    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), ownMemory(true), workspace(NULL), workspaceMemory(false), data(NULL)
   {}
   /*!
   Copy constructor of a 2D array.
   */
   vpArray2D<Type>(const vpArray2D<Type> & A)
-    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), ownMemory(true), workspace(NULL), workspaceMemory(false), data(NULL)
   {
     resize(A.rowNum, A.colNum);
     memcpy(data, A.data, rowNum*colNum*sizeof(Type));
@@ -107,7 +114,7 @@ public:
   \param c : Array number of columns.
   */
   vpArray2D<Type>(unsigned int r, unsigned int c)
-    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), ownMemory(true), workspace(NULL), workspaceMemory(false), data(NULL)
   {
     resize(r, c);
   }
@@ -119,7 +126,7 @@ public:
   \param val : Each element of the array is set to \e val.
   */
   vpArray2D<Type>(unsigned int r, unsigned int c, Type val)
-    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), data(NULL)
+    : rowNum(0), colNum(0), rowPtrs(NULL), dsize(0), ownMemory(true), workspace(NULL), workspaceMemory(false), data(NULL)
   {
     resize(r, c);
     *this = val;
@@ -129,16 +136,9 @@ public:
   */
   virtual ~vpArray2D<Type>()
   {
-    if (data != NULL ) {
-      free(data);
-      data=NULL;
-    }
-
-    if (rowPtrs!=NULL) {
-      free(rowPtrs);
-      rowPtrs=NULL ;
-    }
-    rowNum = colNum = dsize = 0;
+    if (workspace != NULL)
+      workspace->detach(this);
+    releaseStorage();
   }
 
   /** @name Inherited functionalities from vpArray2D */
@@ -154,6 +154,27 @@ public:
   inline unsigned int getCols() const { return colNum; }
   //! Return the number of elements of the 2D array.
   inline unsigned int size() const { return colNum*rowNum; }
+
+  /*!
+    Bind the array to a workspace that provides its storage each time the
+    array is resized, see vpArrayWorkspace. Passing NULL unbinds the array;
+    its content is then moved on the heap.
+  */
+  void setWorkspace(vpArrayWorkspace *ws)
+  {
+    if (ws == workspace)
+      return;
+    if (workspace != NULL) {
+      if (workspaceMemory)
+        copyToHeap();
+      workspace->detach(this);
+    }
+    workspace = ws;
+    if (workspace != NULL)
+      workspace->attach(static_cast<void *>(this), &vpArray2D<Type>::releaseWorkspaceMemory);
+  }
+  //! Return the workspace the array is bound to, or NULL.
+  inline vpArrayWorkspace *getWorkspace() const { return workspace; }
   /*!
   Set the size of the array and initialize all the values to zero.
 
@@ -172,7 +193,16 @@ public:
         memset(this->data, 0, this->dsize*sizeof(Type));
       }
     }
+    else if (workspace != NULL) {
+      resizeInWorkspace(nrows, ncols, flagNullify);
+    }
     else {
+      if (! ownMemory) {
+        // The array is bound to an external storage that cannot be
+        // reallocated. Continue with a heap allocated copy.
+        copyToHeap();
+      }
+
       const bool recopyNeeded = (ncols != this ->colNum);
       Type * copyTmp = NULL;
       unsigned int rowTmp = 0, colTmp=0;
@@ -288,6 +318,138 @@ public:
   }
   //@}
 
+protected:
+  /*!
+    Bind the array to an external storage of \e nrows x \e ncols elements.
+    This storage is not freed by the array. It is used by vpFixedArray2D to
+    provide an inline storage that doesn't need any allocation.
+
+    If the array is then resized to an other size, a heap allocated copy is
+    created and the external storage is no more used.
+
+    \param nrows : Number of rows.
+    \param ncols : Number of columns.
+    \param storage : Buffer of at least nrows*ncols elements.
+    \param rowStorage : Buffer of at least nrows pointers used for rowPtrs.
+  */
+  void bindStorage(unsigned int nrows, unsigned int ncols, Type *storage, Type **rowStorage)
+  {
+    releaseStorage();
+    data = storage;
+    rowPtrs = rowStorage;
+    rowNum = nrows;
+    colNum = ncols;
+    dsize = nrows*ncols;
+    ownMemory = false;
+    for (unsigned int i=0; i<nrows; i++)
+      rowPtrs[i] = data + i*ncols;
+  }
+
+  /*!
+    Free the storage if it is owned by the array and leave the array empty.
+  */
+  void releaseStorage()
+  {
+    if (ownMemory) {
+      if (data != NULL)
+        free(data);
+      if (rowPtrs != NULL)
+        free(rowPtrs);
+    }
+    data = NULL;
+    rowPtrs = NULL;
+    rowNum = colNum = dsize = 0;
+    ownMemory = true;
+    workspaceMemory = false;
+  }
+
+  /*!
+    Replace a storage that is not owned by the array by a heap allocated
+    copy.
+  */
+  void copyToHeap()
+  {
+    Type *extData = this->data;
+    this->data = (Type*)malloc(this->dsize*sizeof(Type));
+    this->rowPtrs = (Type**)malloc(this->rowNum*sizeof(Type*));
+    if (((NULL == this->data) || (NULL == this->rowPtrs)) && (0 != this->dsize)) {
+      throw(vpException(vpException::memoryAllocationError,
+        "Memory allocation error when allocating 2D array data")) ;
+    }
+    if (this->dsize)
+      memcpy(this->data, extData, this->dsize*sizeof(Type));
+    for (unsigned int i=0; i<this->rowNum; i++)
+      this->rowPtrs[i] = this->data + i*this->colNum;
+    ownMemory = true;
+    workspaceMemory = false;
+  }
+
+  /*!
+    Resize the array using a block of the workspace, or the heap if the
+    workspace is full. The previous storage is not reused.
+  */
+  void resizeInWorkspace(const unsigned int nrows, const unsigned int ncols, const bool flagNullify)
+  {
+    const unsigned int newSize = nrows*ncols;
+    const size_t dataBytes = vpArrayWorkspace::alignSize(newSize*sizeof(Type));
+    unsigned char *block = (unsigned char *)workspace->allocate(dataBytes + nrows*sizeof(Type*));
+    Type *newData;
+    Type **newRowPtrs;
+    if (block != NULL) {
+      newData = (Type*)block;
+      newRowPtrs = (Type**)(block + dataBytes);
+    }
+    else {
+      newData = (Type*)malloc(newSize*sizeof(Type));
+      newRowPtrs = (Type**)malloc(nrows*sizeof(Type*));
+      if (((NULL == newData) || (NULL == newRowPtrs)) && (0 != newSize)) {
+        free(newData);
+        free(newRowPtrs);
+        throw(vpException(vpException::memoryAllocationError,
+          "Memory allocation error when allocating 2D array data")) ;
+      }
+    }
+    for (unsigned int i=0; i<nrows; i++)
+      newRowPtrs[i] = newData + i*ncols;
+
+    if (flagNullify) {
+      memset(newData, 0, newSize*sizeof(Type));
+    }
+    else {
+      const unsigned int minRow = (nrows<rowNum)?nrows:rowNum;
+      const unsigned int minCol = (ncols<colNum)?ncols:colNum;
+      for (unsigned int i=0; i<nrows; ++i) {
+        for (unsigned int j=0; j<ncols; ++j) {
+          newRowPtrs[i][j] = ((minRow > i) && (minCol > j)) ? rowPtrs[i][j] : 0;
+        }
+      }
+    }
+
+    releaseStorage();
+    data = newData;
+    rowPtrs = newRowPtrs;
+    rowNum = nrows;
+    colNum = ncols;
+    dsize = newSize;
+    ownMemory = (block == NULL);
+    workspaceMemory = (block != NULL);
+  }
+
+  /*!
+    Called by the workspace to empty the array when it is reset, and to
+    unbind the array when it is destroyed. In the latter case an array which
+    storage is on the heap keeps its content.
+  */
+  static void releaseWorkspaceMemory(void *array, bool detach)
+  {
+    vpArray2D<Type> *A = static_cast<vpArray2D<Type> *>(array);
+    if (A->workspaceMemory || (A->ownMemory && ! detach))
+      A->releaseStorage();
+    if (detach)
+      A->workspace = NULL;
+  }
+
+public:
   //---------------------------------
   // Inherited array I/O  Static Public Member Functions
   //---------------------------------
@@ -0,0 +1,137 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Arena providing the storage of 2D arrays within iterative algorithms.
+ *
+ *****************************************************************************/
+
+#ifndef __vpArrayWorkspace_h_
+#define __vpArrayWorkspace_h_
+
+#include <stddef.h>
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+
+/*!
+  \class vpArrayWorkspace
+  \ingroup group_core_matrices
+
+  \brief Arena that provides the storage of the vpArray2D, vpMatrix or
+  vpColVector bound to it with vpArray2D::setWorkspace().
+
+  Resizing an array bound to a workspace only moves a pointer within a
+  buffer owned by the workspace, instead of calling realloc(). The memory
+  is never given back until reset() is called, typically once per frame of
+  a tracking loop. When the buffer is full, the arrays fall back to a heap
+  allocation and the workspace records the capacity that would have been
+  needed; the buffer is enlarged accordingly at the next reset(). After a
+  warm-up frame, the bound arrays are thus resized without any allocation.
+
+  getBytesRequested() and getBytesServed() count the bytes asked by the
+  bound arrays and the bytes actually served by the workspace. When both
+  counters stay equal, no heap allocation occurred.
+
+  \code
+  vpArrayWorkspace workspace;
+  vpMatrix L;
+  vpColVector e;
+  L.setWorkspace(&workspace);
+  e.setWorkspace(&workspace);
+  for (;;) { // For each frame
+    workspace.reset();
+    for (unsigned int iter = 0; iter < 30; iter++) {
+      L.resize(n, 6); // n may change between the iterations
+      e.resize(n);
+      ...
+    }
+  }
+  \endcode
+
+  \warning reset() releases the storage of the bound arrays, including the
+  ones that fell back to the heap. These arrays become empty and have to be
+  resized before being used again. The workspace is not thread safe.
+*/
+class VISP_EXPORT vpArrayWorkspace
+{
+public:
+  //! Alignment in bytes of the blocks served by the workspace.
+  static const size_t alignment = 32;
+
+  explicit vpArrayWorkspace(size_t capacity = 0);
+  virtual ~vpArrayWorkspace();
+
+  void *allocate(size_t bytes);
+  void reset();
+
+  //! Return the size in bytes of the buffer owned by the workspace.
+  inline size_t getCapacity() const { return m_capacity; }
+  //! Return the number of bytes used in the buffer since the last reset().
+  inline size_t getUsed() const { return m_used; }
+  //! Return the number of bytes requested by the bound arrays since the last resetCounters().
+  inline size_t getBytesRequested() const { return m_bytesRequested; }
+  //! Return the number of bytes served by the workspace since the last resetCounters().
+  inline size_t getBytesServed() const { return m_bytesServed; }
+  //! Reset the bytes requested and served counters.
+  inline void resetCounters() { m_bytesRequested = m_bytesServed = 0; }
+
+  /*!
+    Round \e bytes up to a multiple of the alignment.
+  */
+  static inline size_t alignSize(size_t bytes) { return (bytes + alignment - 1) & ~(alignment - 1); }
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  //! Function called to release the storage of a bound array.
+  typedef void (*vpReleaseFunction)(void *array, bool detach);
+
+  void attach(void *array, vpReleaseFunction release);
+  void detach(void *array);
+#endif
+
+private:
+  vpArrayWorkspace(const vpArrayWorkspace &);
+  vpArrayWorkspace &operator=(const vpArrayWorkspace &);
+
+  void releaseArrays(bool detach);
+
+  //! Buffer as returned by malloc()
+  unsigned char *m_buffer;
+  //! First aligned address of the buffer
+  unsigned char *m_begin;
+  size_t m_capacity;
+  size_t m_used;
+  //! Bytes that would have been used since the last reset() if the buffer was large enough
+  size_t m_needed;
+  size_t m_bytesRequested;
+  size_t m_bytesServed;
+  std::vector<std::pair<void *, vpReleaseFunction> > m_arrays;
+};
+
+#endif
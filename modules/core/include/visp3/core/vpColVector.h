@@ -41,6 +41,7 @@
 #define vpColVector_H
 
 #include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpMatrixExpression.h>
 #include <visp3/core/vpRowVector.h>
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpRotationVector.h>
@@ -94,6 +95,15 @@ public:
   vpColVector(const vpMatrix &M, unsigned int j);
   vpColVector(const std::vector<double> &v);
   vpColVector(const std::vector<float> &v);
+  /*!
+    Create a column vector from the evaluation of a lazy expression built with
+    vpTranspose() or vpDiag(), see vpMatrixExpression.h.
+    \code
+    vpColVector LtWe = vpTranspose(L) * vpDiag(w) * e;
+    \endcode
+  */
+  template<class E>
+  vpColVector(const vpMatrixExpr<E> &e) : vpArray2D<double>() { *this = e; }
   /*!
     Destructor.
   */
@@ -105,16 +115,7 @@ public:
   */
   void clear()
   {
-    if (data != NULL ) {
-      free(data);
-      data=NULL;
-    }
-
-    if (rowPtrs!=NULL) {
-      free(rowPtrs);
-      rowPtrs=NULL ;
-    }
-    rowNum = colNum = dsize = 0;
+    releaseStorage();
   }
 
   std::ostream & cppPrint(std::ostream & os, const std::string &matrixName="A", bool octet = false) const;
@@ -181,6 +182,20 @@ public:
   vpColVector &operator=(const std::vector<double> &v);
   vpColVector &operator=(const std::vector<float> &v);
   vpColVector &operator=(double x);
+  /*!
+    Evaluate a lazy expression built with vpTranspose() or vpDiag(), see
+    vpMatrixExpression.h, without intermediate matrices.
+  */
+  template<class E>
+  vpColVector &operator=(const vpMatrixExpr<E> &e)
+  {
+    if (e.derived().getCols() != 1)
+      throw vpException(vpException::dimensionError,
+                        "Cannot assign a (%dx%d) matrix to a column vector",
+                        e.derived().getRows(), e.derived().getCols());
+    e.assignTo(*this);
+    return *this;
+  }
 
   double operator*(const vpColVector &x) const;
   vpMatrix  operator*(const vpRowVector &v) const;
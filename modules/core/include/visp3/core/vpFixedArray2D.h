@@ -0,0 +1,128 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * 2D array with a compile-time size and an inline storage.
+ *
+ *****************************************************************************/
+
+#ifndef __vpFixedArray2D_h_
+#define __vpFixedArray2D_h_
+
+#include <string.h>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpArray2D.h>
+
+/*!
+  \class vpFixedArray2D
+  \ingroup group_core_matrices
+
+  \brief 2D array which size is known at compile time and which elements are
+  stored inline, within the object itself.
+
+  Contrary to vpArray2D that allocates its elements and its row pointers on the
+  heap, constructing, copying or destroying a vpFixedArray2D doesn't allocate
+  any memory. It is the base class of the small fixed size containers such as
+  vpRotationMatrix (3x3), vpHomogeneousMatrix (4x4), vpVelocityTwistMatrix and
+  vpForceTwistMatrix (6x6), vpTranslationVector (3x1) and vpPoseVector (6x1),
+  so that computing a pose or a twist in a control loop is allocation free.
+
+  Since vpFixedArray2D inherits from vpArray2D, the whole vpArray2D API
+  remains available. If the array is resized to an other size through the
+  vpArray2D interface, it falls back to a heap allocated storage.
+
+  The static mult() function provides the product of fixed size arrays with
+  compile-time bounds that the compiler fully unrolls.
+*/
+template<class Type, unsigned int R, unsigned int C>
+class vpFixedArray2D : public vpArray2D<Type>
+{
+private:
+  //! Inline storage of the elements
+  Type fixedData[R*C];
+  //! Inline storage of the row pointers
+  Type *fixedRowPtrs[R];
+
+public:
+  /*!
+    Default constructor that initializes all the elements to zero.
+  */
+  vpFixedArray2D<Type, R, C>()
+    : vpArray2D<Type>()
+  {
+    this->bindStorage(R, C, fixedData, fixedRowPtrs);
+    memset(fixedData, 0, R*C*sizeof(Type));
+  }
+  /*!
+    Copy constructor.
+  */
+  vpFixedArray2D<Type, R, C>(const vpFixedArray2D<Type, R, C> &A)
+    : vpArray2D<Type>()
+  {
+    this->bindStorage(R, C, fixedData, fixedRowPtrs);
+    vpArray2D<Type>::operator=(A);
+  }
+  /*!
+    Destructor. Nothing is freed since the storage is inline.
+  */
+  virtual ~vpFixedArray2D<Type, R, C>() {}
+
+  /*!
+    Copy operator.
+  */
+  vpFixedArray2D<Type, R, C> &operator=(const vpFixedArray2D<Type, R, C> &A)
+  {
+    if (this != &A)
+      vpArray2D<Type>::operator=(A);
+    return *this;
+  }
+
+  /*!
+    Compute the product \f$ P = A B \f$ of a RxK array A by a KxC array B, both
+    stored as contiguous row-major arrays. Since all the bounds are known at
+    compile time, the loops are fully unrolled by the compiler.
+
+    \warning P must not overlap A or B.
+  */
+  template<unsigned int K>
+  static inline void mult(const Type *A, const Type *B, Type *P)
+  {
+    for (unsigned int i = 0; i < R; i++) {
+      for (unsigned int j = 0; j < C; j++) {
+        Type s = A[i*K] * B[j];
+        for (unsigned int k = 1; k < K; k++)
+          s += A[i*K + k] * B[k*C + j];
+        P[i*C + j] = s;
+      }
+    }
+  }
+};
+
+#endif
@@ -0,0 +1,320 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Kalman filter with a state and a measure of fixed sizes.
+ *
+ *****************************************************************************/
+
+#ifndef __vpFixedKalmanFilter_h_
+#define __vpFixedKalmanFilter_h_
+
+/*!
+  \file vpFixedKalmanFilter.h
+  \brief Kalman filter with a state and a measure of fixed sizes.
+*/
+
+#include <math.h>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpException.h>
+
+/*!
+  \class vpFixedKalmanFilter
+  \ingroup group_core_kalman
+
+  \brief Kalman filter whose state and measure sizes \e N and \e M are known
+  at compile time.
+
+  The filter implements the prediction and filtering equations detailed in
+  vpKalmanFilter, with the same public members named after the same
+  notations. The matrices are fixed size arrays stored in the filter itself,
+  so that prediction() and filtering() do not allocate any memory and their
+  loops are unrolled by the compiler. It is intended for small states, like
+  the position, velocity and acceleration of one signal.
+
+  The innovation covariance \f${\bf S}_k\f$ is inverted by a Cholesky
+  factorization. With setJosephForm(), the updated covariance is computed
+  with the Joseph form
+  \f[
+  {\bf P}_{k \mid k} = \left({\bf I} - {\bf W}_k {\bf H} \right) {\bf P}_{k
+  \mid k-1} \left({\bf I} - {\bf W}_k {\bf H} \right)^T + {\bf W}_k {\bf R}_k
+  {\bf W}^T_k
+  \f]
+
+  \code
+  vpFixedKalmanFilter<2, 1> kalman; // Constant velocity, measured position
+  kalman.F[0][0] = 1; kalman.F[0][1] = dt; kalman.F[1][1] = 1;
+  kalman.H[0][0] = 1;
+  kalman.R[0][0] = sigma_measure;
+  ... // Set Q, Pest and Xest
+  kalman.prediction();
+  for (;;) {
+    double z = ...; // Measured position
+    kalman.filtering(&z);
+    kalman.prediction();
+  }
+  \endcode
+
+  To filter many independent signals with the same state model, see
+  vpKalmanFilterBatch.
+*/
+template <unsigned int N, unsigned int M = 1> class vpFixedKalmanFilter
+{
+public:
+  /*!
+    Create a filter with null matrices and a null state.
+  */
+  vpFixedKalmanFilter() : iter(0), joseph_form(false)
+  {
+    for (unsigned int i = 0; i < N; i++) {
+      Xest[i] = Xpre[i] = 0;
+      for (unsigned int j = 0; j < N; j++)
+        F[i][j] = Q[i][j] = Ppre[i][j] = Pest[i][j] = 0;
+      for (unsigned int j = 0; j < M; j++)
+        W[i][j] = 0;
+    }
+    for (unsigned int i = 0; i < M; i++) {
+      for (unsigned int j = 0; j < N; j++)
+        H[i][j] = 0;
+      for (unsigned int j = 0; j < M; j++)
+        R[i][j] = 0;
+    }
+  }
+
+  /*!
+    Apply the prediction equations
+    \f${\bf x}_{k|k-1} = {\bf F} {\bf x}_{k-1\mid k-1}\f$ and
+    \f${\bf P}_{k \mid k-1} = {\bf F} {\bf P}_{k-1 \mid k-1} {\bf F}^T + {\bf Q}\f$.
+  */
+  void prediction()
+  {
+    double FP[N][N];
+    for (unsigned int i = 0; i < N; i++) {
+      double x = 0;
+      for (unsigned int k = 0; k < N; k++)
+        x += F[i][k] * Xest[k];
+      Xpre[i] = x;
+      for (unsigned int j = 0; j < N; j++) {
+        double s = 0;
+        for (unsigned int k = 0; k < N; k++)
+          s += F[i][k] * Pest[k][j];
+        FP[i][j] = s;
+      }
+    }
+    for (unsigned int i = 0; i < N; i++) {
+      for (unsigned int j = i; j < N; j++) {
+        double s = Q[i][j];
+        for (unsigned int k = 0; k < N; k++)
+          s += FP[i][k] * F[j][k];
+        Ppre[i][j] = Ppre[j][i] = s;
+      }
+    }
+  }
+
+  /*!
+    Apply the filtering equations with the measure \e z of size \e M and
+    increment the iteration number.
+
+    \exception vpException::fatalError : If the innovation covariance
+    \f${\bf S}_k\f$ is not positive definite.
+  */
+  void filtering(const double *z)
+  {
+    // P H^T and S = H P H^T + R
+    double PHt[N][M], S[M][M];
+    for (unsigned int i = 0; i < N; i++) {
+      for (unsigned int j = 0; j < M; j++) {
+        double s = 0;
+        for (unsigned int k = 0; k < N; k++)
+          s += Ppre[i][k] * H[j][k];
+        PHt[i][j] = s;
+      }
+    }
+    for (unsigned int i = 0; i < M; i++) {
+      for (unsigned int j = i; j < M; j++) {
+        double s = R[i][j];
+        for (unsigned int k = 0; k < N; k++)
+          s += H[i][k] * PHt[k][j];
+        S[i][j] = S[j][i] = s;
+      }
+    }
+
+    // Cholesky factorization S = L L^T, L in the lower triangle of S
+    for (unsigned int j = 0; j < M; j++) {
+      double d = S[j][j];
+      for (unsigned int k = 0; k < j; k++)
+        d -= S[j][k] * S[j][k];
+      if (!(d > 0))
+        throw(vpException(vpException::fatalError, "The innovation covariance is not positive definite"));
+      d = sqrt(d);
+      S[j][j] = d;
+      for (unsigned int i = j + 1; i < M; i++) {
+        double s = S[i][j];
+        for (unsigned int k = 0; k < j; k++)
+          s -= S[i][k] * S[j][k];
+        S[i][j] = s / d;
+      }
+    }
+
+    // Gain W = P H^T S^-1, each row solving S w = (P H^T)_i
+    for (unsigned int i = 0; i < N; i++) {
+      double w[M];
+      for (unsigned int j = 0; j < M; j++) {
+        double s = PHt[i][j];
+        for (unsigned int k = 0; k < j; k++)
+          s -= S[j][k] * w[k];
+        w[j] = s / S[j][j];
+      }
+      for (unsigned int j = M; j-- > 0;) {
+        double s = w[j];
+        for (unsigned int k = j + 1; k < M; k++)
+          s -= S[k][j] * w[k];
+        w[j] = s / S[j][j];
+      }
+      for (unsigned int j = 0; j < M; j++)
+        W[i][j] = w[j];
+    }
+
+    // State update with the innovation z - H x
+    double innovation[M];
+    for (unsigned int i = 0; i < M; i++) {
+      double s = z[i];
+      for (unsigned int k = 0; k < N; k++)
+        s -= H[i][k] * Xpre[k];
+      innovation[i] = s;
+    }
+    for (unsigned int i = 0; i < N; i++) {
+      double s = Xpre[i];
+      for (unsigned int j = 0; j < M; j++)
+        s += W[i][j] * innovation[j];
+      Xest[i] = s;
+    }
+
+    if (joseph_form) {
+      // A = I - W H, Pest = A Ppre A^T + W R W^T
+      double A[N][N], AP[N][N], WR[N][M];
+      for (unsigned int i = 0; i < N; i++) {
+        for (unsigned int j = 0; j < N; j++) {
+          double s = (i == j) ? 1. : 0.;
+          for (unsigned int k = 0; k < M; k++)
+            s -= W[i][k] * H[k][j];
+          A[i][j] = s;
+        }
+        for (unsigned int j = 0; j < M; j++) {
+          double s = 0;
+          for (unsigned int k = 0; k < M; k++)
+            s += W[i][k] * R[k][j];
+          WR[i][j] = s;
+        }
+      }
+      for (unsigned int i = 0; i < N; i++) {
+        for (unsigned int j = 0; j < N; j++) {
+          double s = 0;
+          for (unsigned int k = 0; k < N; k++)
+            s += A[i][k] * Ppre[k][j];
+          AP[i][j] = s;
+        }
+      }
+      for (unsigned int i = 0; i < N; i++) {
+        for (unsigned int j = i; j < N; j++) {
+          double s = 0;
+          for (unsigned int k = 0; k < N; k++)
+            s += AP[i][k] * A[j][k];
+          for (unsigned int k = 0; k < M; k++)
+            s += WR[i][k] * W[j][k];
+          Pest[i][j] = Pest[j][i] = s;
+        }
+      }
+    } else {
+      // Pest = Ppre - W S W^T = Ppre - W (P H^T)^T
+      for (unsigned int i = 0; i < N; i++) {
+        for (unsigned int j = i; j < N; j++) {
+          double s = Ppre[i][j];
+          for (unsigned int k = 0; k < M; k++)
+            s -= W[i][k] * PHt[j][k];
+          Pest[i][j] = Pest[j][i] = s;
+        }
+      }
+    }
+
+    iter++;
+  }
+
+  /*!
+    Apply the filtering equations with the measure \e z of size \e M.
+
+    \exception vpException::dimensionError : If the size of \e z is not \e M.
+  */
+  void filtering(const vpColVector &z)
+  {
+    if (z.size() != M)
+      throw(vpException(vpException::dimensionError, "The measure vector size %d differs from %d", z.size(), M));
+    filtering(z.data);
+  }
+
+  //! Return the iteration number.
+  inline long getIteration() const { return iter; }
+  //! Set the iteration number, for instance to restart the filter.
+  inline void setIteration(long iteration) { iter = iteration; }
+  //! Return true if filtering() updates the covariance with the Joseph form.
+  inline bool getJosephForm() const { return joseph_form; }
+  //! Update the covariance with the Joseph form in filtering().
+  inline void setJosephForm(bool on) { joseph_form = on; }
+  //! Return the size of the state vector.
+  static unsigned int getStateSize() { return N; }
+  //! Return the size of the measure vector.
+  static unsigned int getMeasureSize() { return M; }
+
+  //! The updated state estimate \f${\bf x}_{k \mid k}\f$.
+  double Xest[N];
+  //! The predicted state \f${\bf x}_{k \mid k-1}\f$.
+  double Xpre[N];
+  //! Transition matrix \f${\bf F}\f$ that describes the evolution of the state.
+  double F[N][N];
+  //! Matrix \f${\bf H}\f$ that describes the evolution of the measurements.
+  double H[M][N];
+  //! Measurement noise covariance matrix \f${\bf R}\f$.
+  double R[M][M];
+  //! Process noise covariance matrix \f${\bf Q}\f$.
+  double Q[N][N];
+  //! The state prediction covariance \f${\bf P}_{k \mid k-1}\f$.
+  double Ppre[N][N];
+  //! The updated covariance of the state \f${\bf P}_{k \mid k}\f$.
+  double Pest[N][N];
+  //! Filter gain \f${\bf W}_k\f$ computed by the last filtering().
+  double W[N][M];
+
+private:
+  long iter;
+  bool joseph_form;
+};
+
+#endif
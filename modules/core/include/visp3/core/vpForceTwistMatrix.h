@@ -39,7 +39,7 @@
 #ifndef vpForceTwistMatrix_h
 #define vpForceTwistMatrix_h
 
-#include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpFixedArray2D.h>
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpRotationMatrix.h>
@@ -56,7 +56,9 @@
   transformation matrix that allows to transform a force/troque vector
   from one frame to an other.
 
-  The vpForceTwistMatrix class is derived from vpArray2D<double>.
+  The vpForceTwistMatrix class is derived from vpFixedArray2D<double, 6, 6>, itself
+  derived from vpArray2D<double>. Its elements are stored inline so that it
+  never allocates memory.
 
   The twist transformation matrix that allows to transform the
   force/torque vector expressed at frame \f${\cal F}_b\f$ into the
@@ -99,7 +101,7 @@ int main()
 }
   \endcode
 */
-class VISP_EXPORT vpForceTwistMatrix : public vpArray2D<double>
+class VISP_EXPORT vpForceTwistMatrix : public vpFixedArray2D<double, 6, 6>
 {
  public:
   // basic constructor
@@ -134,157 +134,44 @@ inline void GEMMsize<7>(const vpArray2D<double> & A,const vpArray2D<double> & B,
   Bcols= B.getRows();
 }
 
-template<unsigned int>
-inline void GEMM1(const unsigned int &/*Arows*/,const unsigned int &/*Brows*/, const unsigned int &/*Bcols*/, const vpArray2D<double> & /*A*/, const vpArray2D<double> & /*B*/, const double & /*alpha*/,vpArray2D<double> &/*D*/){}
+VISP_EXPORT void vpGEMMBlocked(unsigned int M, unsigned int N, unsigned int K, double alpha,
+                               const double *A, unsigned int lda, bool transA,
+                               const double *B, unsigned int ldb, bool transB,
+                               double beta, double *C, unsigned int ldc);
+VISP_EXPORT const char *vpGEMMKernelName();
 
-template<>
-inline void GEMM1<0>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A, const vpArray2D<double> & B, const double & alpha,vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[n][c]*alpha;
-      D[r][c]=sum;
-    }
-}
-
-template<>
-inline void GEMM1<1>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A, const vpArray2D<double> & B, const double & alpha,vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[n][c]*alpha;
-      D[r][c]=sum;
-    }
-}
-
-template<>
-inline void GEMM1<2>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha,vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[c][n]*alpha;
-      D[r][c]=sum;
-    }
-}
-
-template<>
-inline void GEMM1<3>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha,vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[c][n]*alpha;
-      D[r][c]=sum;
-    }
-}
-
-template<unsigned int>
-inline void GEMM2(const unsigned int &/*Arows*/,const unsigned int &/*Brows*/, const unsigned int &/*Bcols*/, const vpArray2D<double> & /*A*/,const vpArray2D<double> & /*B*/, const double & /*alpha*/, const vpArray2D<double> & /*C*/ , const double &/*beta*/, vpArray2D<double> &/*D*/)
-{}
-
-template<>
-inline void GEMM2<0>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[n][c]*alpha;
-      D[r][c]=sum+C[r][c]*beta;
-    }
-}
-
-template<>
-inline void GEMM2<1>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[n][c]*alpha;
-      D[r][c]=sum+C[r][c]*beta;
-    }
-}
-
-template<>
-inline void GEMM2<2>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[c][n]*alpha;
-      D[r][c]=sum+C[r][c]*beta;
-    }
-}
-
-template<>
-inline void GEMM2<3>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[c][n]*alpha;
-      D[r][c]=sum+C[r][c]*beta;
-    }
-}
-
-
-template<>
-inline void GEMM2<4>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[n][c]*alpha;
-      D[r][c]=sum+C[c][r]*beta;
-    }
-}
-
-template<>
-inline void GEMM2<5>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
+template<unsigned int T>
+inline void GEMM1(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A, const vpArray2D<double> & B, const double & alpha,vpArray2D<double> &D)
 {
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[n][c]*alpha;
-      D[r][c]=sum+C[c][r]*beta;
-    }
-
+  vpGEMMBlocked(Arows, Bcols, Brows, alpha,
+                A.data, A.getCols(), (T & VP_GEMM_A_T) != 0,
+                B.data, B.getCols(), (T & VP_GEMM_B_T) != 0,
+                0., D.data, D.getCols());
 }
 
-template<>
-inline void GEMM2<6>(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
+template<unsigned int T>
+inline void GEMM2(const unsigned int &Arows,const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
 {
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[r][n]*B[c][n]*alpha;
-      D[r][c]=sum+C[c][r]*beta;
-    }
-}
+  // D = beta*op(C) first, then accumulate alpha*op(A)*op(B) into D
+  if (T & VP_GEMM_C_T) {
+    for(unsigned int r=0;r<Arows;r++)
+      for(unsigned int c=0;c<Bcols;c++)
+        D[r][c]=C[c][r]*beta;
+  }
+  else if (D.data != C.data) {
+    for(unsigned int r=0;r<Arows;r++)
+      for(unsigned int c=0;c<Bcols;c++)
+        D[r][c]=C[r][c]*beta;
+  }
+  else {
+    for(unsigned int i=0;i<D.size();i++)
+      D.data[i]*=beta;
+  }
 
-template<>
-inline void GEMM2<7>(const unsigned int &Arows, const unsigned int &Brows, const unsigned int &Bcols, const vpArray2D<double> & A,const vpArray2D<double> & B, const double & alpha, const vpArray2D<double> & C , const double &beta, vpArray2D<double> &D)
-{
-  for(unsigned int r=0;r<Arows;r++)
-    for(unsigned int c=0;c<Bcols;c++){
-      double sum=0;
-      for(unsigned int n=0;n<Brows;n++)
-        sum+=A[n][r]*B[c][n]*alpha;
-      D[r][c]=sum+C[c][r]*beta;
-    }
+  vpGEMMBlocked(Arows, Bcols, Brows, alpha,
+                A.data, A.getCols(), (T & VP_GEMM_A_T) != 0,
+                B.data, B.getCols(), (T & VP_GEMM_B_T) != 0,
+                1., D.data, D.getCols());
 }
 
 template<unsigned int T>
@@ -311,10 +198,12 @@ inline void vpTGEMM(const vpArray2D<double> & A, const vpArray2D<double> & B, co
   }
   
   if(C.getRows()!=0 && C.getCols()!=0){
-    if ((Arows != C.getRows()) || (Bcols != C.getCols())) {
+    unsigned int Crows = (T & VP_GEMM_C_T) ? C.getCols() : C.getRows();
+    unsigned int Ccols = (T & VP_GEMM_C_T) ? C.getRows() : C.getCols();
+    if ((Arows != Crows) || (Bcols != Ccols)) {
       throw(vpException(vpException::dimensionError,
                         "In vpGEMM, cannot add resulting (%dx%d) matrix to (%dx%d) matrix",
-                        Arows, Bcols, C.getRows(), C.getCols())) ;
+                        Arows, Bcols, Crows, Ccols)) ;
     }
     
     GEMM2<T>(Arows,Brows,Bcols,A,B,alpha,C,beta,D);
@@ -329,6 +218,10 @@ inline void vpTGEMM(const vpArray2D<double> & A, const vpArray2D<double> & B, co
    D = alpha*op(A)*op(B) + beta*op(C), where op(X) is X or X^T.
    Operation on A, B and C matrices is described by enumeration vpGEMMmethod().
    
+   The product is computed by vpGEMMBlocked(), a packed and cache blocked
+   implementation that uses SIMD micro kernels selected at runtime and does
+   not require any third-party library.
+
    For example, to compute D = alpha*A^T*B^T+beta*C we need to call :
    \code
    vpGEMM(A, B, alpha, C, beta, D, VP_GEMM_A_T + VP_GEMM_B_T);
@@ -50,6 +50,7 @@
 #include <sstream>
 
 #include <visp3/core/vpImage.h>
+#include <visp3/core/vpImageView.h>
 #include <visp3/core/vpHistogramPeak.h>
 #include <visp3/core/vpHistogramValey.h>
 #include <visp3/core/vpColor.h>
@@ -109,6 +110,10 @@
   threshold = valey.getLevel();
   \endcode
 
+  calculate() accepts a vpImageView to compute the histogram of a region of
+  interest, and an optional mask to only count some pixels. The histogram
+  equalizations built on it are vpImageTools::equalizeHistogram() and
+  vpImageTools::clahe().
 */
 class VISP_EXPORT vpHistogram
 {
@@ -239,7 +244,9 @@ public:
     }
   };
 
-  void     calculate(const vpImage<unsigned char> &I, const unsigned int nbins=256, const unsigned int nbThreads=1);
+  void     calculate(const vpImageView<unsigned char> &I, const unsigned int nbins=256, const unsigned int nbThreads=1);
+  void     calculate(const vpImageView<unsigned char> &I, const vpImageView<unsigned char> &mask,
+                     const unsigned int nbins=256, const unsigned int nbThreads=1);
 
   void     display(const vpImage<unsigned char> &I, const vpColor &color=vpColor::white, const unsigned int thickness=2,
                    const unsigned int maxValue_=0);
@@ -307,6 +314,7 @@ public:
 
 private:
   void init(unsigned size = 256);
+  void setLevels(const unsigned int *levels, const unsigned int nbins);
 
   unsigned int *histogram;
   unsigned size; // Histogram size (max allowed 256)
@@ -50,6 +50,7 @@
 #include <visp3/core/vpImageException.h>
 #include <visp3/core/vpImagePoint.h>
 #include <visp3/core/vpRGBa.h>
+#include <visp3/core/vpThreadPool.h>
 #if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
 #  include <visp3/core/vpThread.h>
 #endif
@@ -57,6 +58,8 @@
 #include <fstream>
 #include <iostream>
 #include <math.h>
+#include <new>
+#include <stdlib.h>
 #include <string.h>
 
 class vpDisplay;
@@ -85,6 +88,12 @@ class vpDisplay;
   if i is the ith rows and j the jth columns the value of this pixel
   is given by I[i][j] (that is equivalent to row[i][j]).
 
+  The bitmap allocated by the image starts on a vpImage::alignment bytes
+  boundary, which allows the SIMD kernels to use aligned loads on the first
+  pixel of the image and of the rows which size is a multiple of the
+  alignment. To process a region of the image, or an external buffer whose
+  rows are padded, without copying the pixels, see vpImageView.
+
   <h3>Example</h3>
   The following example available in tutorial-image-manipulation.cpp shows how
   to create gray level and color images and how to access to the pixels.
@@ -116,6 +125,9 @@ class vpImage
   friend class vpImageConvert;
 
 public:
+  //! Alignment in bytes of the bitmap allocated by the image.
+  static const unsigned int alignment = 64;
+
   Type *bitmap ;  //!< points toward the bitmap
   vpDisplay *display ;
 
@@ -314,154 +326,85 @@ public:
   //@}
 
 private:
+  void allocateBitmap();
+  void releaseBitmap();
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  class vpImageLutTask;
+  class vpImageLutRGBaTask;
+#endif
+
   unsigned int npixels ; ///! number of pixel in the image
   unsigned int width ;   ///! number of columns
   unsigned int height ;  ///! number of rows
   Type **row ;    //!< points the row pointer array
+  //! Block holding the aligned bitmap, NULL when the bitmap was given to init(array, height, width, false)
+  void *m_allocation;
 };
 
 
-#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
-namespace {
-  struct ImageLut_Param_t {
-    unsigned int m_start_index;
-    unsigned int m_end_index;
-
-    unsigned char m_lut[256];
-    unsigned char *m_bitmap;
-
-    ImageLut_Param_t() : m_start_index(0), m_end_index(0), m_lut(), m_bitmap(NULL) {
-    }
-
-    ImageLut_Param_t(const unsigned int start_index, const unsigned int end_index,
-        unsigned char *bitmap) :
-      m_start_index(start_index), m_end_index(end_index), m_lut(), m_bitmap(bitmap) {
-    }
-  };
-
-  vpThread::Return performLutThread(vpThread::Args args) {
-    ImageLut_Param_t *imageLut_param = ( (ImageLut_Param_t *) args );
-    unsigned int start_index = imageLut_param->m_start_index;
-    unsigned int end_index = imageLut_param->m_end_index;
-
-    unsigned char *bitmap = imageLut_param->m_bitmap;
-
-    unsigned char *ptrStart = bitmap + start_index;
-    unsigned char *ptrEnd = bitmap + end_index;
-    unsigned char *ptrCurrent = ptrStart;
-
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+// Look-up table applied to the pixels [begin, end) of a gray level image
+template<class Type>
+class vpImage<Type>::vpImageLutTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpImageLutTask(unsigned char *bitmap, const unsigned char (&lut)[256]) : m_bitmap(bitmap), m_lut(lut) {}
 
-//    while(ptrCurrent != ptrEnd) {
-//      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-//      ++ptrCurrent;
-//    }
+  void run(unsigned int begin, unsigned int end)
+  {
+    unsigned char *ptrCurrent = m_bitmap + begin;
+    unsigned char *ptrEnd = m_bitmap + end;
 
-    if(end_index - start_index >= 8) {
+    if(end - begin >= 8) {
       //Unroll loop version
-      for(; ptrCurrent <= ptrEnd - 8;) {
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-        ++ptrCurrent;
-
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-        ++ptrCurrent;
-
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-        ++ptrCurrent;
-
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-        ++ptrCurrent;
-
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-        ++ptrCurrent;
-
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-        ++ptrCurrent;
-
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-        ++ptrCurrent;
-
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
-        ++ptrCurrent;
+      for(; ptrCurrent <= ptrEnd - 8; ptrCurrent += 8) {
+        ptrCurrent[0] = m_lut[ptrCurrent[0]];
+        ptrCurrent[1] = m_lut[ptrCurrent[1]];
+        ptrCurrent[2] = m_lut[ptrCurrent[2]];
+        ptrCurrent[3] = m_lut[ptrCurrent[3]];
+        ptrCurrent[4] = m_lut[ptrCurrent[4]];
+        ptrCurrent[5] = m_lut[ptrCurrent[5]];
+        ptrCurrent[6] = m_lut[ptrCurrent[6]];
+        ptrCurrent[7] = m_lut[ptrCurrent[7]];
       }
     }
 
     for(; ptrCurrent != ptrEnd; ++ptrCurrent) {
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent];
+      *ptrCurrent = m_lut[*ptrCurrent];
     }
-
-    return 0;
   }
 
+private:
+  unsigned char *m_bitmap;
+  const unsigned char (&m_lut)[256];
+};
 
-  struct ImageLutRGBa_Param_t {
-    unsigned int m_start_index;
-    unsigned int m_end_index;
-
-    vpRGBa m_lut[256];
-    unsigned char *m_bitmap;
-
-    ImageLutRGBa_Param_t() : m_start_index(0), m_end_index(0), m_lut(), m_bitmap(NULL) {
-    }
-
-    ImageLutRGBa_Param_t(const unsigned int start_index, const unsigned int end_index,
-        unsigned char *bitmap) :
-      m_start_index(start_index), m_end_index(end_index), m_lut(), m_bitmap(bitmap) {
-    }
-  };
-
-  vpThread::Return performLutRGBaThread(vpThread::Args args) {
-    ImageLutRGBa_Param_t *imageLut_param = ( (ImageLutRGBa_Param_t *) args );
-    unsigned int start_index = imageLut_param->m_start_index;
-    unsigned int end_index = imageLut_param->m_end_index;
-
-    unsigned char *bitmap = imageLut_param->m_bitmap;
-
-    unsigned char *ptrStart = bitmap + start_index*4;
-    unsigned char *ptrEnd = bitmap + end_index*4;
-    unsigned char *ptrCurrent = ptrStart;
-
-
-    if(end_index - start_index >= 4*2) {
-      //Unroll loop version
-      for(; ptrCurrent <= ptrEnd - 4*2;) {
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].R;
-        ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].G;
-        ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].B;
-        ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].A;
-        ptrCurrent++;
-
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].R;
-        ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].G;
-        ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].B;
-        ptrCurrent++;
-        *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].A;
-        ptrCurrent++;
-      }
-    }
-
-    while(ptrCurrent != ptrEnd) {
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].R;
-      ptrCurrent++;
-
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].G;
-      ptrCurrent++;
-
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].B;
-      ptrCurrent++;
+// Look-up table applied to the pixels [begin, end) of a color image
+template<class Type>
+class vpImage<Type>::vpImageLutRGBaTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpImageLutRGBaTask(unsigned char *bitmap, const vpRGBa (&lut)[256]) : m_bitmap(bitmap), m_lut(lut) {}
 
-      *ptrCurrent = imageLut_param->m_lut[*ptrCurrent].A;
-      ptrCurrent++;
+  void run(unsigned int begin, unsigned int end)
+  {
+    unsigned char *ptrCurrent = m_bitmap + 4 * (size_t)begin;
+    unsigned char *ptrEnd = m_bitmap + 4 * (size_t)end;
+
+    for(; ptrCurrent != ptrEnd; ptrCurrent += 4) {
+      ptrCurrent[0] = m_lut[ptrCurrent[0]].R;
+      ptrCurrent[1] = m_lut[ptrCurrent[1]].G;
+      ptrCurrent[2] = m_lut[ptrCurrent[2]].B;
+      ptrCurrent[3] = m_lut[ptrCurrent[3]].A;
     }
-
-    return 0;
   }
-}
-#endif
+
+private:
+  unsigned char *m_bitmap;
+  const vpRGBa (&m_lut)[256];
+};
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
 
 /*!
@@ -527,11 +470,8 @@ vpImage<Type>::init(unsigned int h, unsigned int w)
 
   if ((h != this->height) || (w != this->width))
   {
-    if (bitmap != NULL) {
-      vpDEBUG_TRACE(10,"Destruction bitmap[]") ;
-      delete [] bitmap;
-      bitmap = NULL;
-    }
+    vpDEBUG_TRACE(10,"Destruction bitmap[]") ;
+    releaseBitmap();
   }
 
   this->width = w ;
@@ -539,15 +479,7 @@ vpImage<Type>::init(unsigned int h, unsigned int w)
 
   npixels=width*height;
 
-  if (bitmap == NULL)  bitmap = new  Type[npixels] ;
-
-  //  vpERROR_TRACE("Allocate bitmap %p",bitmap) ;
-  if (bitmap == NULL)
-  {
-        vpERROR_TRACE("cannot allocate bitmap ") ;
-    throw(vpException(vpException::memoryAllocationError,
-          "cannot allocate bitmap ")) ;
-  }
+  if (bitmap == NULL)  allocateBitmap();
 
   if (row == NULL)  row = new  Type*[height] ;
 //  vpERROR_TRACE("Allocate row %p",row) ;
@@ -588,10 +520,7 @@ vpImage<Type>::init(Type * const array, const unsigned int h, const unsigned int
 
   //Delete bitmap if copyData==false, otherwise only if the dimension differs
   if ( (copyData && ((h != this->height) || (w != this->width))) || !copyData ) {
-    if (bitmap != NULL) {
-      delete [] bitmap;
-      bitmap = NULL;
-    }
+    releaseBitmap();
   }
 
   this->width = w ;
@@ -600,12 +529,7 @@ vpImage<Type>::init(Type * const array, const unsigned int h, const unsigned int
   npixels = width*height;
 
   if(copyData) {
-    if (bitmap == NULL)  bitmap = new  Type[npixels];
-
-    if (bitmap == NULL) {
-      throw(vpException(vpException::memoryAllocationError,
-            "cannot allocate bitmap ")) ;
-    }
+    if (bitmap == NULL)  allocateBitmap();
 
     //Copy the image data
     memcpy(bitmap, array, (size_t) (npixels * sizeof(Type)));
@@ -645,7 +569,7 @@ vpImage<Type>::init(Type * const array, const unsigned int h, const unsigned int
 */
 template<class Type>
 vpImage<Type>::vpImage(unsigned int h, unsigned int w)
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), m_allocation(NULL)
 {
   try
   {
@@ -676,7 +600,7 @@ vpImage<Type>::vpImage(unsigned int h, unsigned int w)
 */
 template<class Type>
 vpImage<Type>::vpImage (unsigned int h, unsigned int w, Type value)
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), m_allocation(NULL)
 {
   try
   {
@@ -705,7 +629,7 @@ vpImage<Type>::vpImage (unsigned int h, unsigned int w, Type value)
 */
 template<class Type>
 vpImage<Type>::vpImage (Type * const array, const unsigned int h, const unsigned int w, const bool copyData)
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), m_allocation(NULL)
 {
   try
   {
@@ -728,7 +652,7 @@ vpImage<Type>::vpImage (Type * const array, const unsigned int h, const unsigned
 */
 template<class Type>
 vpImage<Type>::vpImage()
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), m_allocation(NULL)
 {
 }
 
@@ -815,13 +739,9 @@ vpImage<Type>::destroy()
  //   vpERROR_TRACE("Deallocate ") ;
 
 
-  if (bitmap!=NULL)
-  {
   //  vpERROR_TRACE("Deallocate bitmap memory %p",bitmap) ;
 //    vpDEBUG_TRACE(20,"Deallocate bitmap memory %p",bitmap) ;
-    delete [] bitmap ;
-    bitmap = NULL;
-  }
+  releaseBitmap();
 
 
   if (row!=NULL)
@@ -853,7 +773,7 @@ vpImage<Type>::~vpImage()
 */
 template<class Type>
 vpImage<Type>::vpImage(const vpImage<Type>& I)
-  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL)
+  : bitmap(NULL), display(NULL), npixels(0), width(0), height(0), row(NULL), m_allocation(NULL)
 {
   try
   {
@@ -922,48 +842,17 @@ void vpImage<Type>::getMinMaxValue(Type &min, Type &max) const
 template<class Type>
 vpImage<Type> & vpImage<Type>::operator=(const vpImage<Type> &I)
 {
-    /* we first have to set the initial values of the image because resize function calls init function that test the actual size of the image */
-  if(bitmap != NULL){
-    delete[] bitmap;
-    bitmap = NULL ;
-  }
+  if (this == &I)
+    return (* this);
 
-  if(row != NULL){
-    delete[] row;
-    row = NULL ;
-  }
-  this->width = I.width;
-  this->height = I.height;
-  this->npixels = I.npixels;
+  // The bitmap given to init(array, height, width, false) is not overwritten
+  if (m_allocation == NULL)
+    destroy();
   try
   {
-    if(I.npixels != 0)
-    {
-      if (bitmap == NULL){
-        bitmap = new  Type[npixels] ;
-      }
-
-      if (bitmap == NULL){
-            vpERROR_TRACE("cannot allocate bitmap ") ;
-        throw(vpException(vpException::memoryAllocationError,
-              "cannot allocate bitmap ")) ;
-      }
-
-      if (row == NULL){
-        row = new  Type*[height] ;
-      }
-      if (row == NULL){
-        vpERROR_TRACE("cannot allocate row ") ;
-        throw(vpException(vpException::memoryAllocationError,
-              "cannot allocate row ")) ;
-      }
-
+    init(I.height, I.width);
+    if (I.npixels != 0)
       memcpy(bitmap, I.bitmap, I.npixels*sizeof(Type)) ;
-
-      for (unsigned int i=0; i<this->height; i++){
-        row[i] = bitmap + i*this->width;
-      }
-    }
   }
   catch(vpException &)
   {
@@ -973,6 +862,46 @@ vpImage<Type> & vpImage<Type>::operator=(const vpImage<Type> &I)
   return (* this);
 }
 
+/*!
+  Allocate a bitmap of npixels elements starting on a vpImage::alignment
+  bytes boundary.
+
+  \exception vpException::memoryAllocationError
+*/
+template<class Type>
+void vpImage<Type>::allocateBitmap()
+{
+  m_allocation = malloc((size_t)npixels * sizeof(Type) + alignment);
+  if (m_allocation == NULL) {
+    vpERROR_TRACE("cannot allocate bitmap ") ;
+    throw(vpException(vpException::memoryAllocationError,
+          "cannot allocate bitmap ")) ;
+  }
+  size_t offset = (alignment - ((size_t)m_allocation & (alignment - 1))) & (alignment - 1);
+  bitmap = (Type *)((unsigned char *)m_allocation + offset);
+  for (unsigned int i = 0; i < npixels; i++)
+    new (bitmap + i) Type;
+}
+
+/*!
+  Release the bitmap allocated by allocateBitmap() or given to
+  init(array, height, width, false).
+*/
+template<class Type>
+void vpImage<Type>::releaseBitmap()
+{
+  if (m_allocation != NULL) {
+    for (unsigned int i = 0; i < npixels; i++)
+      bitmap[i].~Type();
+    free(m_allocation);
+    m_allocation = NULL;
+  }
+  else if (bitmap != NULL) {
+    delete [] bitmap;
+  }
+  bitmap = NULL;
+}
+
 
 /*!
   \brief = operator : Set all the element of the bitmap to a given  value \e v.
@@ -1675,169 +1604,30 @@ void vpImage<Type>::performLut(const Type (&)[256], const unsigned int)
   Modify the intensities of a grayscale image using the look-up table passed in parameter.
 
   \param lut : Look-up table (unsigned char array of size=256) which maps each intensity to his new value.
-  \param nbThreads : Number of threads to use for the computation.
+  \param nbThreads : Maximum number of threads of vpThreadPool::getInstance() used for the computation.
 */
 template<>
 inline void vpImage<unsigned char>::performLut(const unsigned char (&lut)[256], const unsigned int nbThreads) {
-  unsigned int size = getWidth()*getHeight();
-  unsigned char *ptrStart = (unsigned char*) bitmap;
-  unsigned char *ptrEnd = ptrStart + size;
-  unsigned char *ptrCurrent = ptrStart;
-
-
-  bool use_single_thread = (nbThreads == 0 || nbThreads == 1);
-#if !defined(VISP_HAVE_PTHREAD) && !defined(_WIN32)
-  use_single_thread = true;
-#endif
-
-  if(!use_single_thread && getSize() <= nbThreads) {
-    use_single_thread = true;
-  }
-
-
-  if(use_single_thread) {
-    //Single thread
-
-    while(ptrCurrent != ptrEnd) {
-      *ptrCurrent = lut[*ptrCurrent];
-      ++ptrCurrent;
-    }
-  } else {
-#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
-    //Multi-threads
-
-    std::vector<vpThread *> threadpool;
-    std::vector<ImageLut_Param_t *> imageLutParams;
-
-    ImageLut_Param_t *imageLut_param = NULL;
-    vpThread *imageLut_thread = NULL;
-
-    unsigned int image_size = getSize();
-    unsigned int step = image_size / nbThreads;
-    unsigned int last_step = image_size - step * (nbThreads-1);
-
-    for(unsigned int index = 0; index < nbThreads; index++) {
-      unsigned int start_index = index*step;
-      unsigned int end_index = (index+1)*step;
-
-      if(index == nbThreads-1) {
-        end_index = start_index+last_step;
-      }
-
-      imageLut_param = new ImageLut_Param_t(start_index, end_index, bitmap);
-      memcpy(imageLut_param->m_lut, lut, 256*sizeof(unsigned char));
-
-      imageLutParams.push_back(imageLut_param);
-
-      // Start the threads
-      imageLut_thread = new vpThread((vpThread::Fn) performLutThread, (vpThread::Args) imageLut_param);
-      threadpool.push_back(imageLut_thread);
-    }
-
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      // Wait until thread ends up
-      threadpool[cpt]->join();
-    }
-
-
-    //Delete
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      delete threadpool[cpt];
-    }
-
-    for(size_t cpt = 0; cpt < imageLutParams.size(); cpt++) {
-      delete imageLutParams[cpt];
-    }
-#endif
-  }
+  vpImageLutTask task(bitmap, lut);
+  if (nbThreads <= 1 || getSize() <= nbThreads)
+    task.run(0, getSize());
+  else
+    vpThreadPool::getInstance().parallelFor(0, getSize(), task, 0, nbThreads);
 }
 
 /*!
   Modify the intensities of a color image using the look-up table passed in parameter.
 
   \param lut : Look-up table (vpRGBa array of size=256) which maps each intensity to his new value.
-  \param nbThreads : Number of threads to use for the computation.
+  \param nbThreads : Maximum number of threads of vpThreadPool::getInstance() used for the computation.
 */
 template<>
 inline void vpImage<vpRGBa>::performLut(const vpRGBa (&lut)[256], const unsigned int nbThreads) {
-  unsigned int size = getWidth()*getHeight();
-  unsigned char *ptrStart = (unsigned char*) bitmap;
-  unsigned char *ptrEnd = ptrStart + size*4;
-  unsigned char *ptrCurrent = ptrStart;
-
-
-  bool use_single_thread = (nbThreads == 0 || nbThreads == 1);
-#if !defined(VISP_HAVE_PTHREAD) && !defined(_WIN32)
-  use_single_thread = true;
-#endif
-
-  if(!use_single_thread && getSize() <= nbThreads) {
-    use_single_thread = true;
-  }
-
-
-  if(use_single_thread) {
-    //Single thread
-    while(ptrCurrent != ptrEnd) {
-      *ptrCurrent = lut[*ptrCurrent].R;
-      ++ptrCurrent;
-
-      *ptrCurrent = lut[*ptrCurrent].G;
-      ++ptrCurrent;
-
-      *ptrCurrent = lut[*ptrCurrent].B;
-      ++ptrCurrent;
-
-      *ptrCurrent = lut[*ptrCurrent].A;
-      ++ptrCurrent;
-    }
-  } else {
-#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
-    //Multi-threads
-    std::vector<vpThread *> threadpool;
-    std::vector<ImageLutRGBa_Param_t *> imageLutParams;
-
-    ImageLutRGBa_Param_t *imageLut_param = NULL;
-    vpThread *imageLut_thread = NULL;
-
-    unsigned int image_size = getSize();
-    unsigned int step = image_size / nbThreads;
-    unsigned int last_step = image_size - step * (nbThreads-1);
-
-    for(unsigned int index = 0; index < nbThreads; index++) {
-      unsigned int start_index = index*step;
-      unsigned int end_index = (index+1)*step;
-
-      if(index == nbThreads-1) {
-        end_index = start_index+last_step;
-      }
-
-      imageLut_param = new ImageLutRGBa_Param_t(start_index, end_index, (unsigned char *) bitmap);
-      memcpy(imageLut_param->m_lut, lut, 256*sizeof(vpRGBa));
-
-      imageLutParams.push_back(imageLut_param);
-
-      // Start the threads
-      imageLut_thread = new vpThread((vpThread::Fn) performLutRGBaThread, (vpThread::Args) imageLut_param);
-      threadpool.push_back(imageLut_thread);
-    }
-
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      // Wait until thread ends up
-      threadpool[cpt]->join();
-    }
-
-
-    //Delete
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      delete threadpool[cpt];
-    }
-
-    for(size_t cpt = 0; cpt < imageLutParams.size(); cpt++) {
-      delete imageLutParams[cpt];
-    }
-#endif
-  }
+  vpImageLutRGBaTask task((unsigned char *)bitmap, lut);
+  if (nbThreads <= 1 || getSize() <= nbThreads)
+    task.run(0, getSize());
+  else
+    vpThreadPool::getInstance().parallelFor(0, getSize(), task, 0, nbThreads);
 }
 
 #endif
@@ -50,6 +50,7 @@
 // image
 #include <visp3/core/vpConfig.h>
 #include <visp3/core/vpImage.h>
+#include <visp3/core/vpImageView.h>
 #include <visp3/core/vpDebug.h>
 // color
 #include <visp3/core/vpRGBa.h>
@@ -101,6 +102,8 @@ public:
   static void createDepthHistogram(const vpImage<uint16_t> &src_depth, vpImage<vpRGBa> &dest_rgba);
   static void convert(const vpImage<unsigned char> &src, vpImage<vpRGBa> & dest) ;
   static void convert(const vpImage<vpRGBa> &src, vpImage<unsigned char> & dest) ;
+  static void convert(const vpImageView<unsigned char> &src, vpImage<vpRGBa> &dest);
+  static void convert(const vpImageView<vpRGBa> &src, vpImage<unsigned char> &dest, unsigned int nbThreads=1);
           
   static void convert(const vpImage<float> &src, vpImage<unsigned char> &dest);
   static void convert(const vpImage<unsigned char> &src, vpImage<float> &dest);
@@ -196,7 +199,7 @@ public:
       b = (unsigned char) db;
     }
   static void YUYVToRGBa(unsigned char* yuyv, unsigned char* rgba,
-      unsigned int width, unsigned int height);
+      unsigned int width, unsigned int height, unsigned int nbThreads=1);
   static void YUYVToRGB(unsigned char* yuyv, unsigned char* rgb,
       unsigned int width, unsigned int height);
   static void YUYVToGrey(unsigned char* yuyv, unsigned char* grey,
@@ -212,9 +215,9 @@ public:
   static void YUV422ToRGB(unsigned char* yuv,
         unsigned char* rgb, unsigned int size);
   static void YUV422ToGrey(unsigned char* yuv,
-        unsigned char* grey, unsigned int size);
+        unsigned char* grey, unsigned int size, unsigned int nbThreads=1);
   static void YUV420ToRGBa(unsigned char* yuv,
-        unsigned char* rgba, unsigned int width, unsigned int height);
+        unsigned char* rgba, unsigned int width, unsigned int height, unsigned int nbThreads=1);
   static void YUV420ToRGB(unsigned char* yuv,
         unsigned char* rgb, unsigned int width, unsigned int height);
   static void YUV420ToGrey(unsigned char* yuv,
@@ -241,12 +244,13 @@ public:
       unsigned char* rgb, unsigned int size);
 
   static void RGBToGrey(unsigned char* rgb, unsigned char* grey, unsigned int size);
-  static void RGBaToGrey(unsigned char* rgba, unsigned char* grey, unsigned int size);
+  static void RGBaToGrey(unsigned char* rgba, unsigned char* grey, unsigned int size,
+      unsigned int nbThreads=1);
 
   static void RGBToRGBa(unsigned char * rgb, unsigned char * rgba,
       unsigned int width, unsigned int height, bool flip = false);
   static void RGBToGrey(unsigned char * rgb, unsigned char * grey,
-      unsigned int width, unsigned int height, bool flip = false);
+      unsigned int width, unsigned int height, bool flip = false, unsigned int nbThreads=1);
 
   static void GreyToRGBa(unsigned char* grey,
       unsigned char* rgba, unsigned int size);
@@ -257,7 +261,7 @@ public:
       unsigned int width, unsigned int height, bool flip=false);
 
   static void BGRToGrey(unsigned char * bgr, unsigned char * grey,
-      unsigned int width, unsigned int height, bool flip=false);
+      unsigned int width, unsigned int height, bool flip=false, unsigned int nbThreads=1);
 
   static void YCbCrToRGB(unsigned char *ycbcr, unsigned char *rgb,
       unsigned int size);
@@ -48,6 +48,7 @@
 
 #include <visp3/core/vpImage.h>
 #include <visp3/core/vpImageException.h>
+#include <visp3/core/vpImageView.h>
 #include <visp3/core/vpMatrix.h>
 #include <visp3/core/vpMath.h>
 
@@ -63,18 +64,60 @@
 
   \brief  Various image filter, convolution, etc...
 
+  The separable filters (filterX(), filterY(), filter(), gaussianBlur(),
+  getGradX(), getGradY(), getGradXGauss2D() and getGradYGauss2D()) process
+  the image by whole rows with SIMD row and column passes. The double
+  versions give exactly the same values than the per pixel functions such as
+  filterX(const vpImage<unsigned char> &, unsigned int, unsigned int, const double *, unsigned int).
+
+  They exist in three output flavors:
+  - vpImage<double> images, compatible with the per pixel functions;
+  - vpImage<float> images, that halve the memory bandwidth and double the
+    SIMD width. The filter kernels are then float arrays that could be
+    initialized with getGaussianKernel(float *, unsigned int, double, bool) and
+    getGaussianDerivativeKernel(float *, unsigned int, double, bool);
+  - vpImage<short> fixed-point images computed from a vpImage<unsigned char>,
+    where a filtered value \f$ v \f$ is stored as
+    \f$ round(v \; 2^{fixedPointBits}) \f$.
+
+  The last parameter \e nbThreads splits the image in horizontal bands that
+  are filtered in parallel. The result doesn't depend on the number of threads.
+
+  The filters of a vpImage<unsigned char> and canny() take a vpImageView,
+  so that a region of interest or a padded camera buffer is filtered without
+  copying its pixels. A vpImage is implicitly converted to a view.
+
+  \code
+  vpImage<unsigned char> I;
+  vpImage<float> Iblur, dIx, dIy;
+  vpImageFilter::gaussianBlur(I, Iblur, 7, 0., true, 4);
+  vpImageFilter::getGradX(Iblur, dIx, fgd, 7, 4);
+  vpImageFilter::getGradY(Iblur, dIy, fgd, 7, 4);
+  \endcode
+
+  The Canny edge detector canny() doesn't need OpenCV: it relies on the
+  same float passes for the Gaussian and Sobel filters, then on a non-maximum
+  suppression and a hysteresis thresholding, also split in bands.
 */
 class VISP_EXPORT vpImageFilter
 {
 
 public:
-#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
+  //! Number of fractional bits of the fixed-point vpImage<short> filtered images.
+  static const unsigned int fixedPointBits = 6;
+
   static void canny(const vpImage<unsigned char>& I,
                     vpImage<unsigned char>& Ic,
                     const unsigned int gaussianFilterSize,
                     const double thresholdCanny,
                     const unsigned int apertureSobel);
-#endif
+  static void canny(const vpImageView<unsigned char>& I,
+                    vpImage<unsigned char>& Ic,
+                    unsigned int gaussianFilterSize,
+                    double lowerThreshold,
+                    double upperThreshold,
+                    unsigned int apertureSobel,
+                    unsigned int nbThreads=1);
 
   /*!
    Apply a 1x3 derivative filter to an image pixel.
@@ -178,8 +221,14 @@ public:
                      const vpMatrix& M) ;
 
 
-  static void filter(const vpImage<unsigned char> &I, vpImage<double>& GI, const double *filter,unsigned  int size);
-  static void filter(const vpImage<double> &I, vpImage<double>& GI, const double *filter,unsigned  int size);
+  static void filter(const vpImageView<unsigned char> &I, vpImage<double>& GI, const double *filter,unsigned  int size,
+                     unsigned int nbThreads=1);
+  static void filter(const vpImage<double> &I, vpImage<double>& GI, const double *filter,unsigned  int size,
+                     unsigned int nbThreads=1);
+  static void filter(const vpImageView<unsigned char> &I, vpImage<float>& GI, const float *filter, unsigned int size,
+                     unsigned int nbThreads=1);
+  static void filter(const vpImage<float> &I, vpImage<float>& GI, const float *filter, unsigned int size,
+                     unsigned int nbThreads=1);
 
   static inline unsigned char filterGaussXPyramidal(const vpImage<unsigned char> &I, unsigned int i, unsigned int j)
   {
@@ -190,8 +239,14 @@ public:
     return (unsigned char)((1.*I[i-2][j]+4.*I[i-1][j]+6.*I[i][j]+4.*I[i+1][j]+1.*I[i+2][j])/16.);
   }
 
-  static void filterX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter,unsigned  int size);
-  static void filterX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter,unsigned  int size);
+  static void filterX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter,unsigned  int size,
+                      unsigned int nbThreads=1);
+  static void filterX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter,unsigned  int size,
+                      unsigned int nbThreads=1);
+  static void filterX(const vpImage<unsigned char> &I, vpImage<float>& dIx, const float *filter, unsigned int size,
+                      unsigned int nbThreads=1);
+  static void filterX(const vpImage<float> &I, vpImage<float>& dIx, const float *filter, unsigned int size,
+                      unsigned int nbThreads=1);
 
   static inline double filterX(const vpImage<unsigned char> &I,
                                unsigned int r, unsigned int c,
@@ -296,8 +351,14 @@ public:
     return result+filter[0]*I[r][c];
   }
 
-  static void filterY(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter,unsigned  int size);
-  static void filterY(const vpImage<double> &I, vpImage<double>& dIx, const double *filter,unsigned  int size);
+  static void filterY(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *filter,unsigned  int size,
+                      unsigned int nbThreads=1);
+  static void filterY(const vpImage<double> &I, vpImage<double>& dIy, const double *filter,unsigned  int size,
+                      unsigned int nbThreads=1);
+  static void filterY(const vpImage<unsigned char> &I, vpImage<float>& dIy, const float *filter, unsigned int size,
+                      unsigned int nbThreads=1);
+  static void filterY(const vpImage<float> &I, vpImage<float>& dIy, const float *filter, unsigned int size,
+                      unsigned int nbThreads=1);
   static inline double filterY(const vpImage<unsigned char> &I,
                                unsigned int r, unsigned int c,
                                const double *filter,unsigned  int size)
@@ -392,8 +453,16 @@ public:
     return result+filter[0]*I[r][c];
   }
 
-  static void gaussianBlur(const vpImage<unsigned char> &I, vpImage<double>& GI, unsigned int size=7, double sigma=0., bool normalize=true);
-  static void gaussianBlur(const vpImage<double> &I, vpImage<double>& GI, unsigned int size=7, double sigma=0., bool normalize=true);
+  static void gaussianBlur(const vpImageView<unsigned char> &I, vpImage<double>& GI, unsigned int size=7, double sigma=0., bool normalize=true,
+                           unsigned int nbThreads=1);
+  static void gaussianBlur(const vpImage<double> &I, vpImage<double>& GI, unsigned int size=7, double sigma=0., bool normalize=true,
+                           unsigned int nbThreads=1);
+  static void gaussianBlur(const vpImageView<unsigned char> &I, vpImage<float>& GI, unsigned int size=7, double sigma=0., bool normalize=true,
+                           unsigned int nbThreads=1);
+  static void gaussianBlur(const vpImage<float> &I, vpImage<float>& GI, unsigned int size=7, double sigma=0., bool normalize=true,
+                           unsigned int nbThreads=1);
+  static void gaussianBlur(const vpImageView<unsigned char> &I, vpImage<short>& GI, unsigned int size=7, double sigma=0., bool normalize=true,
+                           unsigned int nbThreads=1);
   /*!
    Apply a 5x5 Gaussian filter to an image pixel.
 
@@ -423,21 +492,47 @@ public:
   static void getGaussYPyramidal(const vpImage<unsigned char> &I, vpImage<unsigned char>& GI);
 
   static void getGaussianKernel(double *filter, unsigned int size, double sigma=0., bool normalize=true);
+  static void getGaussianKernel(float *filter, unsigned int size, double sigma=0., bool normalize=true);
   static void getGaussianDerivativeKernel(double *filter, unsigned int size, double sigma=0., bool normalize=true);
+  static void getGaussianDerivativeKernel(float *filter, unsigned int size, double sigma=0., bool normalize=true);
 
   //fonction renvoyant le gradient en X de l'image I pour traitement pyramidal => dimension /2
-  static void getGradX(const vpImage<unsigned char> &I, vpImage<double>& dIx);
-  static void getGradX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter, unsigned int size);
-  static void getGradX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter, unsigned int size);
+  static void getGradX(const vpImage<unsigned char> &I, vpImage<double>& dIx, unsigned int nbThreads=1);
+  static void getGradX(const vpImage<unsigned char> &I, vpImage<float>& dIx, unsigned int nbThreads=1);
+  static void getGradX(const vpImage<unsigned char> &I, vpImage<short>& dIx, unsigned int nbThreads=1);
+  static void getGradX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter, unsigned int size,
+                       unsigned int nbThreads=1);
+  static void getGradX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter, unsigned int size,
+                       unsigned int nbThreads=1);
+  static void getGradX(const vpImage<unsigned char> &I, vpImage<float>& dIx, const float *filter, unsigned int size,
+                       unsigned int nbThreads=1);
+  static void getGradX(const vpImage<float> &I, vpImage<float>& dIx, const float *filter, unsigned int size,
+                       unsigned int nbThreads=1);
   static void getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *gaussianKernel,
-                              const double *gaussianDerivativeKernel, unsigned  int size);
+                              const double *gaussianDerivativeKernel, unsigned  int size, unsigned int nbThreads=1);
+  static void getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<float>& dIx, const float *gaussianKernel,
+                              const float *gaussianDerivativeKernel, unsigned int size, unsigned int nbThreads=1);
+  static void getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<short>& dIx, const float *gaussianKernel,
+                              const float *gaussianDerivativeKernel, unsigned int size, unsigned int nbThreads=1);
 
   //fonction renvoyant le gradient en Y de l'image I
-  static void getGradY(const vpImage<unsigned char> &I, vpImage<double>& dIy);
-  static void getGradY(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *filter, unsigned int size);
-  static void getGradY(const vpImage<double> &I, vpImage<double>& dIy, const double *filter, unsigned int size);
+  static void getGradY(const vpImage<unsigned char> &I, vpImage<double>& dIy, unsigned int nbThreads=1);
+  static void getGradY(const vpImage<unsigned char> &I, vpImage<float>& dIy, unsigned int nbThreads=1);
+  static void getGradY(const vpImage<unsigned char> &I, vpImage<short>& dIy, unsigned int nbThreads=1);
+  static void getGradY(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *filter, unsigned int size,
+                       unsigned int nbThreads=1);
+  static void getGradY(const vpImage<double> &I, vpImage<double>& dIy, const double *filter, unsigned int size,
+                       unsigned int nbThreads=1);
+  static void getGradY(const vpImage<unsigned char> &I, vpImage<float>& dIy, const float *filter, unsigned int size,
+                       unsigned int nbThreads=1);
+  static void getGradY(const vpImage<float> &I, vpImage<float>& dIy, const float *filter, unsigned int size,
+                       unsigned int nbThreads=1);
   static void getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *gaussianKernel,
-                              const double *gaussianDerivativeKernel,unsigned  int size);
+                              const double *gaussianDerivativeKernel,unsigned  int size, unsigned int nbThreads=1);
+  static void getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<float>& dIy, const float *gaussianKernel,
+                              const float *gaussianDerivativeKernel, unsigned int size, unsigned int nbThreads=1);
+  static void getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<short>& dIy, const float *gaussianKernel,
+                              const float *gaussianDerivativeKernel, unsigned int size, unsigned int nbThreads=1);
 
 } ;
 
@@ -0,0 +1,155 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Integral and squared integral images.
+ *
+ *****************************************************************************/
+
+#ifndef __vpImageIntegral_h_
+#define __vpImageIntegral_h_
+
+#include <stdint.h>
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpImageView.h>
+#include <visp3/core/vpRect.h>
+
+/*!
+  \class vpImageIntegral
+  \ingroup group_core_image
+
+  \brief Integral image (summed-area table) and squared integral image of a
+  vpImage<unsigned char>, giving the sum, the mean and the variance of the
+  pixels of any rectangular window in constant time.
+
+  The tables have one more row and column than the image: the element
+  \f$ (i, j) \f$ is the sum of the pixels \f$ I(r, c) \f$ with
+  \f$ r < i \f$ and \f$ c < j \f$. The sums are stored as 32 bits unsigned
+  integers and the sums of squares as 64 bits ones. The table of the sums
+  may wrap around on large images, but the window sums stay exact as long
+  as the window holds less than \f$ 2^{32} / 255 \f$ pixels, that is more
+  than 16 millions pixels.
+
+  The tables are computed row by row with SSE2 prefix sums when available.
+  When only a part of the image changes, update() refreshes the tables
+  without reading the pixels below or on the left of the region.
+
+  \code
+  vpImage<unsigned char> I;
+  vpImageIntegral integral(I);
+  // Mean and variance of the 21x21 window centered on (i, j)
+  double mean = integral.getMean(i-10, j-10, 21, 21);
+  double variance = integral.getVariance(i-10, j-10, 21, 21);
+  \endcode
+
+  \warning For speed, the window accessors don't check that the window lies
+  in the image.
+
+  \sa vpImageTools::templateMatching()
+*/
+class VISP_EXPORT vpImageIntegral
+{
+public:
+  vpImageIntegral();
+  explicit vpImageIntegral(const vpImageView<unsigned char> &I, bool squared = true);
+
+  void build(const vpImageView<unsigned char> &I, bool squared = true);
+  void update(const vpImageView<unsigned char> &I, unsigned int top, unsigned int left,
+              unsigned int height, unsigned int width);
+  void update(const vpImageView<unsigned char> &I, const vpRect &roi);
+
+  //! Return the height of the image the tables are built from.
+  inline unsigned int getHeight() const { return m_sum.getHeight() > 0 ? m_sum.getHeight() - 1 : 0; }
+  //! Return the width of the image the tables are built from.
+  inline unsigned int getWidth() const { return m_sum.getWidth() > 0 ? m_sum.getWidth() - 1 : 0; }
+  //! Return true if the squared integral image is computed.
+  inline bool hasSquaredSum() const { return m_squared; }
+  //! Return the integral image, that has one more row and column than the image.
+  inline const vpImage<unsigned int> &getSumImage() const { return m_sum; }
+  //! Return the squared integral image, that has one more row and column than the image.
+  inline const vpImage<uint64_t> &getSquaredSumImage() const { return m_sqsum; }
+
+  /*!
+    Return the sum of the pixels of the window which top left pixel is
+    (\e top, \e left) and size is \e height x \e width.
+  */
+  inline unsigned int getSum(unsigned int top, unsigned int left, unsigned int height, unsigned int width) const
+  {
+    const unsigned int *t = m_sum[top] + left;
+    const unsigned int *b = m_sum[top + height] + left;
+    return b[width] - b[0] - t[width] + t[0];
+  }
+
+  /*!
+    Return the sum of the squares of the pixels of the window which top left
+    pixel is (\e top, \e left) and size is \e height x \e width. The
+    squared integral image has to be computed.
+  */
+  inline uint64_t getSquaredSum(unsigned int top, unsigned int left, unsigned int height, unsigned int width) const
+  {
+    const uint64_t *t = m_sqsum[top] + left;
+    const uint64_t *b = m_sqsum[top + height] + left;
+    return b[width] - b[0] - t[width] + t[0];
+  }
+
+  /*!
+    Return the mean of the pixels of a non empty window which top left pixel
+    is (\e top, \e left) and size is \e height x \e width.
+  */
+  inline double getMean(unsigned int top, unsigned int left, unsigned int height, unsigned int width) const
+  {
+    return (double)getSum(top, left, height, width) / ((double)height * width);
+  }
+
+  /*!
+    Return the variance of the pixels of a non empty window which top left
+    pixel is (\e top, \e left) and size is \e height x \e width. The squared
+    integral image has to be computed.
+  */
+  inline double getVariance(unsigned int top, unsigned int left, unsigned int height, unsigned int width) const
+  {
+    double n = (double)height * width;
+    double mean = (double)getSum(top, left, height, width) / n;
+    double variance = (double)getSquaredSum(top, left, height, width) / n - mean * mean;
+    return variance > 0. ? variance : 0.;
+  }
+
+private:
+  vpImage<unsigned int> m_sum;
+  vpImage<uint64_t> m_sqsum;
+  bool m_squared;
+  //! Difference of the last updated row of the tables, added to the rows below
+  std::vector<unsigned int> m_sumDelta;
+  std::vector<uint64_t> m_sqsumDelta;
+};
+
+#endif
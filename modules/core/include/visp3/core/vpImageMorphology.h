@@ -62,7 +62,21 @@
 
   \author Fabien Spindler  (Fabien.Spindler@irisa.fr) Irisa / Inria Rennes
 
-
+  Besides the 3x3 neighbourhoods given by the connexity, the grey level
+  erosion() and dilatation() accept a flat rectangular structuring element
+  of any size. A horizontal or vertical line is a rectangle of height or
+  width 1. The rectangle is decomposed in a horizontal and a vertical line,
+  each one processed with the van Herk/Gil-Werman running minimum or
+  maximum, that costs 3 comparisons per pixel whatever the size of the
+  element. opening(), closing(), topHat() and blackTopHat() are built on
+  them.
+
+  \code
+  vpImage<unsigned char> Imask; // Binarised image, blobs at 255
+  // Remove the blobs thinner than 5 pixels and fill the holes smaller than 9 pixels
+  vpImageMorphology::opening(Imask, 5, 5);
+  vpImageMorphology::closing(Imask, 9, 9);
+  \endcode
 */
 class VISP_EXPORT vpImageMorphology
 {
@@ -88,6 +102,19 @@ public:
 
   static void erosion(vpImage<unsigned char> &I, const vpConnexityType &connexity = CONNEXITY_4);
   static void dilatation(vpImage<unsigned char> &I, const vpConnexityType &connexity = CONNEXITY_4);
+
+  static void erosion(vpImage<unsigned char> &I, unsigned int width, unsigned int height,
+                      unsigned int nbThreads = 1);
+  static void dilatation(vpImage<unsigned char> &I, unsigned int width, unsigned int height,
+                         unsigned int nbThreads = 1);
+  static void opening(vpImage<unsigned char> &I, unsigned int width, unsigned int height,
+                      unsigned int nbThreads = 1);
+  static void closing(vpImage<unsigned char> &I, unsigned int width, unsigned int height,
+                      unsigned int nbThreads = 1);
+  static void topHat(vpImage<unsigned char> &I, unsigned int width, unsigned int height,
+                     unsigned int nbThreads = 1);
+  static void blackTopHat(vpImage<unsigned char> &I, unsigned int width, unsigned int height,
+                          unsigned int nbThreads = 1);
 } ;
 
 /*!
@@ -0,0 +1,131 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Multi-resolution pyramid of images reusing its buffers across frames.
+ *
+ *****************************************************************************/
+
+#ifndef __vpImagePyramid_h_
+#define __vpImagePyramid_h_
+
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+
+/*!
+  \class vpImagePyramid
+  \ingroup group_core_image
+
+  \brief Pyramid of images where each level is half the size of the
+  previous one.
+
+  The level 0 is the image given to build(). The other levels are stored in
+  buffers owned by the pyramid and kept across the calls to build(): when
+  the images of a sequence share the same size, no memory is allocated after
+  the first frame. A pyramid can be built once per frame and handed to
+  several trackers, see vpTemplateTracker::track(const vpImagePyramid &) and
+  vpMbEdgeTracker::setImagePyramid().
+
+  The levels are computed either with a Gaussian 5-tap [1 4 6 4 1]/16 kernel
+  followed by a decimation by two, which gives the same images as
+  vpImageFilter::getGaussPyramidal() without OpenCV, or with a plain
+  decimation by two. Both reductions are vectorized with SSE2 when available.
+
+  \code
+#include <visp3/core/vpImagePyramid.h>
+
+int main()
+{
+  vpImage<unsigned char> I(480, 640);
+  vpImagePyramid pyramid;
+  for (;;) { // For each frame
+    // Acquire I
+    pyramid.build(I, 3);
+    const vpImage<unsigned char> &I2 = pyramid[2]; // 120 x 160 image
+  }
+}
+  \endcode
+
+  \warning The level 0 is not a copy: the image given to build() has to
+  outlive the use of the pyramid.
+*/
+class VISP_EXPORT vpImagePyramid
+{
+public:
+  /*! Reduction used to compute a level from the previous one. */
+  typedef enum {
+    GAUSSIAN,   /*!< Gaussian [1 4 6 4 1]/16 smoothing along the rows and the columns followed by a decimation by two. */
+    SUBSAMPLING /*!< Decimation by two without smoothing nor interpolation. */
+  } vpPyramidType;
+
+  explicit vpImagePyramid(vpPyramidType type = GAUSSIAN);
+
+  void build(const vpImage<unsigned char> &I, unsigned int nbLevels);
+  void clear();
+  const vpImage<unsigned char> &getLevel(unsigned int level) const;
+  /*!
+    Return the image given to the last call to build(), that is the level 0,
+    or NULL if the pyramid was not built.
+  */
+  inline const vpImage<unsigned char> *getBaseImage() const { return m_base; }
+  /*!
+    Return the number of calls to build(). A user of the pyramid can keep it
+    to know if the pyramid was built again since its last use.
+  */
+  inline unsigned long getBuildCount() const { return m_buildCount; }
+  //! Return the number of levels computed by the last call to build().
+  inline unsigned int getNbLevels() const { return m_nbLevels; }
+  //! Return the reduction used to compute the levels.
+  inline vpPyramidType getType() const { return m_type; }
+  void setType(vpPyramidType type);
+
+  /*!
+    Return the level \e level of the pyramid.
+    \sa getLevel()
+  */
+  inline const vpImage<unsigned char> &operator[](unsigned int level) const { return getLevel(level); }
+
+  static void subsample(const vpImage<unsigned char> &I, vpImage<unsigned char> &Is);
+
+private:
+  vpPyramidType m_type;
+  unsigned int m_nbLevels;
+  //! Image given to the last call to build()
+  const vpImage<unsigned char> *m_base;
+  //! Number of calls to build()
+  unsigned long m_buildCount;
+  //! Levels 1 and above, kept across the calls to build()
+  std::vector<vpImage<unsigned char> > m_levels;
+  //! Result of the smoothing along the rows of a Gaussian pyramid
+  vpImage<unsigned char> m_tmp;
+};
+
+#endif
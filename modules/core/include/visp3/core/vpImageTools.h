@@ -49,14 +49,13 @@
 
 #include <visp3/core/vpImage.h>
 
-#ifdef VISP_HAVE_PTHREAD
-#  include <pthread.h>
-#endif
-
 #include <visp3/core/vpImageException.h>
+#include <visp3/core/vpImageIntegral.h>
+#include <visp3/core/vpImageView.h>
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpRect.h>
 #include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpThreadPool.h>
 
 #include <fstream>
 #include <iostream>
@@ -76,6 +75,16 @@ class VISP_EXPORT vpImageTools
 {
 
 public:
+  /*!
+    Interpolation method used by resize().
+  */
+  typedef enum {
+    INTERPOLATION_NEAREST, /*!< Nearest neighbour. */
+    INTERPOLATION_LINEAR,  /*!< Bilinear interpolation. */
+    INTERPOLATION_CUBIC,   /*!< Bicubic interpolation (Catmull-Rom spline). */
+    INTERPOLATION_AREA     /*!< Mean over the area covered by each resized pixel, the method of choice to downscale. */
+  } vpImageInterpolationType;
+
   template<class Type>
   static inline void binarise(vpImage<Type> &I,
                               Type threshold1, Type threshold2,
@@ -123,10 +132,36 @@ public:
                             vpImage<unsigned char> &Ires,
                             const bool saturate=false);
 
+  static void templateMatching(const vpImageView<unsigned char> &I,
+                               const vpImage<unsigned char> &Itpl,
+                               vpImage<double> &Iscore,
+                               unsigned int step_u=1, unsigned int step_v=1);
+  static void templateMatching(const vpImageView<unsigned char> &I,
+                               const vpImageIntegral &integral,
+                               const vpImage<unsigned char> &Itpl,
+                               vpImage<double> &Iscore,
+                               unsigned int step_u=1, unsigned int step_v=1);
+
+  static void equalizeHistogram(const vpImageView<unsigned char> &I, vpImage<unsigned char> &Iout,
+                                unsigned int nbThreads=1);
+  static void clahe(const vpImageView<unsigned char> &I, vpImage<unsigned char> &Iout,
+                    unsigned int tilesX=8, unsigned int tilesY=8, double clipLimit=40.,
+                    unsigned int nbThreads=1);
+
+  static void resize(const vpImageView<unsigned char> &I, vpImage<unsigned char> &Ires,
+                     unsigned int height, unsigned int width,
+                     vpImageInterpolationType method=INTERPOLATION_LINEAR, unsigned int nbThreads=1);
+  static void resize(const vpImageView<float> &I, vpImage<float> &Ires,
+                     unsigned int height, unsigned int width,
+                     vpImageInterpolationType method=INTERPOLATION_LINEAR, unsigned int nbThreads=1);
+  static void resize(const vpImageView<vpRGBa> &I, vpImage<vpRGBa> &Ires,
+                     unsigned int height, unsigned int width,
+                     vpImageInterpolationType method=INTERPOLATION_LINEAR, unsigned int nbThreads=1);
+
   template<class Type>
   static void undistort(const vpImage<Type> &I,
                         const vpCameraParameters &cam,
-                        vpImage<Type> &newI);
+                        vpImage<Type> &newI, unsigned int nbThreads=2);
 
 #if defined(VISP_BUILD_DEPRECATED_FUNCTIONS)
   /*!
@@ -143,6 +178,11 @@ public:
   vp_deprecated static void createSubImage(const vpImage<Type> &I, const vpRect &rect, vpImage<Type> &S);
   //@}
 #endif
+
+private:
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  template<class Type> class vpUndistortTask;
+#endif
 } ;
 
 #if defined(VISP_BUILD_DEPRECATED_FUNCTIONS)
@@ -401,112 +441,91 @@ inline void vpImageTools::binarise(vpImage<unsigned char> &I,
   }
 }
 
-#ifdef VISP_HAVE_PTHREAD
-
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*
+  Undistortion of the rows [begin, end) of an image, run by
+  vpThreadPool::parallelFor().
+*/
 template<class Type>
-class vpUndistortInternalType
+class vpImageTools::vpUndistortTask : public vpThreadPool::vpRangeTask
 {
 public:
-  Type *src;
-  Type *dst;
-  unsigned int width;
-  unsigned int height;
-  vpCameraParameters cam;
-  unsigned int nthreads;
-  unsigned int threadid;
-public:
-  vpUndistortInternalType()
-    : src(NULL), dst(NULL), width(0), height(0), cam(), nthreads(0), threadid(0)
-  {};
-
-  vpUndistortInternalType(const vpUndistortInternalType<Type> &u) {
-    *this = u;
-  };
-  vpUndistortInternalType &operator=(const vpUndistortInternalType<Type> &u) {
-    src = u.src;
-    dst = u.dst;
-    width = u.width;
-    height = u.height;
-    cam = u.cam;
-    nthreads = u.nthreads;
-    threadid = u.threadid;
+  vpUndistortTask(const vpImage<Type> &I, const vpCameraParameters &cam, vpImage<Type> &undistI)
+    : m_I(I), m_cam(cam), m_undistI(undistI)
+  {
   }
 
-  static void *vpUndistort_threaded(void *arg);
-};
-
-
-template<class Type>
-void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
-{
-  vpUndistortInternalType<Type> *undistortSharedData = (vpUndistortInternalType<Type>*)arg;
-  int offset   = (int)undistortSharedData->threadid;
-  int width    = (int)undistortSharedData->width;
-  int height   = (int)undistortSharedData->height;
-  int nthreads = (int)undistortSharedData->nthreads;
-
-  double u0 = undistortSharedData->cam.get_u0();
-  double v0 = undistortSharedData->cam.get_v0();
-  double px = undistortSharedData->cam.get_px();
-  double py = undistortSharedData->cam.get_py();
-  double kud = undistortSharedData->cam.get_kud();
-
-  double invpx = 1.0/px;
-  double invpy = 1.0/py;
-
-  double kud_px2 = kud * invpx * invpx;
-  double kud_py2 = kud * invpy * invpy;
-
-  Type *dst = undistortSharedData->dst+(height/nthreads*offset)*width;
-  Type *src = undistortSharedData->src;
-
-  for (double v = height/nthreads*offset;v < height/nthreads*(offset+1) ; v++) {
-    double  deltav  = v - v0;
-    //double fr1 = 1.0 + kd * (vpMath::sqr(deltav * invpy));
-    double fr1 = 1.0 + kud_py2 * deltav * deltav;
-
-    for (double u = 0 ; u < width ; u++) {
-      //computation of u,v : corresponding pixel coordinates in I.
-      double  deltau  = u - u0;
-      //double fr2 = fr1 + kd * (vpMath::sqr(deltau * invpx));
-      double fr2 = fr1 + kud_px2 * deltau * deltau;
-
-      double u_double = deltau * fr2 + u0;
-      double v_double = deltav * fr2 + v0;
-
-      //computation of the bilinear interpolation
-
-      //declarations
-      int u_round  = (int) (u_double);
-      int v_round  = (int) (v_double);
-      if (u_round < 0.f) u_round = -1;
-      if (v_round < 0.f) v_round = -1;
-      double  du_double  = (u_double) - (double) u_round;
-      double  dv_double  = (v_double) - (double) v_round;
-      Type v01;
-      Type v23;
-      if ( (0 <= u_round) && (0 <= v_round) &&
-           (u_round < ((width) - 1)) && (v_round < ((height) - 1)) ) {
-        //process interpolation
-        const Type* _mp = &src[v_round*width+u_round];
-        v01 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-        _mp += width;
-        v23 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-        *dst = (Type)(v01 + ((v23 - v01) * dv_double));
-      }
-      else {
-        *dst = 0;
+  void run(unsigned int begin, unsigned int end)
+  {
+    int width = (int)m_I.getWidth();
+    int height = (int)m_I.getHeight();
+
+    double u0 = m_cam.get_u0();
+    double v0 = m_cam.get_v0();
+    double px = m_cam.get_px();
+    double py = m_cam.get_py();
+    double kud = m_cam.get_kud();
+
+    double invpx = 1.0/px;
+    double invpy = 1.0/py;
+
+    double kud_px2 = kud * invpx * invpx;
+    double kud_py2 = kud * invpy * invpy;
+
+    Type *dst = m_undistI[begin];
+    const Type *src = m_I.bitmap;
+
+    for (double v = begin; v < end; v++) {
+      double  deltav  = v - v0;
+      //double fr1 = 1.0 + kd * (vpMath::sqr(deltav * invpy));
+      double fr1 = 1.0 + kud_py2 * deltav * deltav;
+
+      for (double u = 0 ; u < width ; u++) {
+        //computation of u,v : corresponding pixel coordinates in I.
+        double  deltau  = u - u0;
+        //double fr2 = fr1 + kd * (vpMath::sqr(deltau * invpx));
+        double fr2 = fr1 + kud_px2 * deltau * deltau;
+
+        double u_double = deltau * fr2 + u0;
+        double v_double = deltav * fr2 + v0;
+
+        //computation of the bilinear interpolation
+
+        //declarations
+        int u_round  = (int) (u_double);
+        int v_round  = (int) (v_double);
+        if (u_round < 0.f) u_round = -1;
+        if (v_round < 0.f) v_round = -1;
+        double  du_double  = (u_double) - (double) u_round;
+        double  dv_double  = (v_double) - (double) v_round;
+        Type v01;
+        Type v23;
+        if ( (0 <= u_round) && (0 <= v_round) &&
+             (u_round < ((width) - 1)) && (v_round < ((height) - 1)) ) {
+          //process interpolation
+          const Type* _mp = &src[v_round*width+u_round];
+          v01 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
+          _mp += width;
+          v23 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
+          *dst = (Type)(v01 + ((v23 - v01) * dv_double));
+        }
+        else {
+          *dst = 0;
+        }
+        dst++;
       }
-      dst++;
     }
   }
 
-  pthread_exit((void*) 0);
-  return NULL;
-}
+private:
+  vpUndistortTask(const vpUndistortTask &);
+  vpUndistortTask &operator=(const vpUndistortTask &);
+
+  const vpImage<Type> &m_I;
+  const vpCameraParameters &m_cam;
+  vpImage<Type> &m_undistI;
+};
 #endif // DOXYGEN_SHOULD_SKIP_THIS
-#endif // VISP_HAVE_PTHREAD
 
 /*!
   Undistort an image
@@ -520,22 +539,23 @@ void *vpUndistortInternalType<Type>::vpUndistort_threaded(void *arg)
   parameter \f$K_d\f$ is null (see cam.get_kd_mp()), \e undistI is
   just a copy of \e I.
 
+  \param nbThreads : Number of threads of vpThreadPool::getInstance()
+  sharing the rows of \e undistI.
+
   \warning This function works only with Types authorizing "+,-,
   multiplication by a scalar" operators.
 
   \warning This function is time consuming :
     - On "Rhea"(Intel Core 2 Extreme X6800 2.93GHz, 2Go RAM)
       or "Charon"(Intel Xeon 3 GHz, 2Go RAM) : ~8 ms for a 640x480 image.
+    When the camera parameters do not change between the images, build a
+    vpUndistortionMap once and call vpUndistortionMap::remap() instead.
 */
 template<class Type>
 void vpImageTools::undistort(const vpImage<Type> &I,
                              const vpCameraParameters &cam,
-                             vpImage<Type> &undistI)
+                             vpImage<Type> &undistI, unsigned int nbThreads)
 {
-#ifdef VISP_HAVE_PTHREAD
-  //
-  // Optimized version using pthreads
-  //
   unsigned int width = I.getWidth();
   unsigned int height = I.getHeight();
 
@@ -550,112 +570,11 @@ void vpImageTools::undistort(const vpImage<Type> &I,
     return;
   }
 
-  unsigned int nthreads = 2;
-  pthread_attr_t attr;
-  pthread_t *callThd = new pthread_t [nthreads];
-  pthread_attr_init(&attr);
-  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_JOINABLE);
-
-  vpUndistortInternalType<Type> *undistortSharedData;
-  undistortSharedData = new vpUndistortInternalType<Type> [nthreads];
-
-  for(unsigned int i=0;i<nthreads;i++) {
-    // Each thread works on a different set of data.
-    //    vpTRACE("create thread %d", i);
-    undistortSharedData[i].src      = I.bitmap;
-    undistortSharedData[i].dst      = undistI.bitmap;
-    undistortSharedData[i].width    = I.getWidth();
-    undistortSharedData[i].height   = I.getHeight();
-    undistortSharedData[i].cam      = cam;
-    undistortSharedData[i].nthreads = nthreads;
-    undistortSharedData[i].threadid = i;
-    pthread_create( &callThd[i], &attr,
-                    &vpUndistortInternalType<Type>::vpUndistort_threaded,
-                    &undistortSharedData[i]);
-  }
-  pthread_attr_destroy(&attr);
-  /* Wait on the other threads */
-
-  for(unsigned int i=0;i<nthreads;i++) {
-    //  vpTRACE("join thread %d", i);
-    pthread_join( callThd[i], NULL);
-  }
-
-  delete [] callThd;
-  delete [] undistortSharedData;
-#else // VISP_HAVE_PTHREAD
-  //
-  // optimized version without pthreads
-  //
-  unsigned int width = I.getWidth();
-  unsigned int height = I.getHeight();
-
-  undistI.resize(height, width);
-
-  double u0 = cam.get_u0();
-  double v0 = cam.get_v0();
-  double px = cam.get_px();
-  double py = cam.get_py();
-  double kud = cam.get_kud();
-
-  //if (kud == 0) {
-  if (std::fabs(kud) <= std::numeric_limits<double>::epsilon()) {
-    // There is no need to undistort the image
-    undistI = I;
-    return;
-  }
-
-  double invpx = 1.0/px;
-  double invpy = 1.0/py;
-
-  double kud_px2 = kud * invpx * invpx;
-  double kud_py2 = kud * invpy * invpy;
-
-  Type *dst = undistI.bitmap;
-  for (double v = 0;v < height ; v++) {
-    double  deltav  = v - v0;
-    //double fr1 = 1.0 + kd * (vpMath::sqr(deltav * invpy));
-    double fr1 = 1.0 + kud_py2 * deltav * deltav;
-
-    for (double u = 0 ; u < width ; u++) {
-      //computation of u,v : corresponding pixel coordinates in I.
-      double  deltau  = u - u0;
-      //double fr2 = fr1 + kd * (vpMath::sqr(deltau * invpx));
-      double fr2 = fr1 + kud_px2 * deltau * deltau;
-
-      double u_double = deltau * fr2 + u0;
-      double v_double = deltav * fr2 + v0;
-
-      //printf("[%g][%g] %g %g : ", u, v, u_double, v_double );
-
-      //computation of the bilinear interpolation
-
-      //declarations
-      int u_round  = (int) (u_double);
-      int v_round  = (int) (v_double);
-      if (u_round < 0.f) u_round = -1;
-      if (v_round < 0.f) v_round = -1;
-      double  du_double  = (u_double) - (double) u_round;
-      double  dv_double  = (v_double) - (double) v_round;
-      Type  v01;
-      Type  v23;
-      if ( (0 <= u_round) && (0 <= v_round) &&
-           (u_round < (((int)width) - 1)) && (v_round < (((int)height) - 1)) ) {
-        //process interpolation
-        const Type* _mp = &I[(unsigned int)v_round][(unsigned int)u_round];
-        v01 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-        _mp += width;
-        v23 = (Type)(_mp[0] + ((_mp[1] - _mp[0]) * du_double));
-        *dst = (Type)(v01 + ((v23 - v01) * dv_double));
-        //printf("R %d G %d B %d\n", dst->R, dst->G, dst->B);
-      }
-      else {
-        *dst = 0;
-      }
-      dst++;
-    }
-  }
-#endif // VISP_HAVE_PTHREAD
+  vpUndistortTask<Type> task(I, cam, undistI);
+  if (nbThreads <= 1)
+    task.run(0, height);
+  else
+    vpThreadPool::getInstance().parallelFor(0, height, task, 0, nbThreads);
 
 
 
@@ -0,0 +1,236 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * View on the pixels of an image or of an external buffer.
+ *
+ *****************************************************************************/
+
+#ifndef __vpImageView_h_
+#define __vpImageView_h_
+
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpImageException.h>
+#include <visp3/core/vpRect.h>
+
+/*!
+  \class vpImageView
+  \ingroup group_core_image
+
+  \brief View on a rectangle of pixels, described by the address of its first
+  pixel, its size and the number of bytes between two consecutive rows.
+
+  A view is taken on a vpImage, on a region of interest of a vpImage or on an
+  external buffer, like a camera frame whose rows are padded, without copying
+  the pixels. The view doesn't own the pixels: they have to outlive it.
+
+  The functions that accept a view, like vpImageFilter::gaussianBlur(),
+  vpImageConvert::convert() or vpImageIntegral::build(), thus process a region
+  of interest without copying the frame. A vpImage is implicitly converted to
+  a view on all its pixels.
+
+  \code
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpImageView.h>
+
+int main()
+{
+  vpImage<unsigned char> I(480, 640);
+  vpImage<float> Iblur;
+  // Blur the 100x200 window which top left pixel is (50, 120)
+  vpImageFilter::gaussianBlur(vpImageView<unsigned char>(I, 50, 120, 100, 200), Iblur);
+
+  // Wrap a camera buffer with rows of 656 bytes
+  unsigned char buffer[480 * 656];
+  vpImageView<unsigned char> frame(buffer, 480, 640, 656);
+}
+  \endcode
+
+  \warning A view taken on a constant image gives a write access to its
+  pixels.
+*/
+template<class Type>
+class vpImageView
+{
+public:
+  /*!
+    Create an empty view.
+  */
+  vpImageView()
+    : m_data(NULL), m_height(0), m_width(0), m_stride(0)
+  {
+  }
+
+  /*!
+    Create a view on an external buffer.
+    \param data : Address of the first pixel.
+    \param height, width : Size of the view.
+    \param stride : Number of bytes between the first pixels of two
+    consecutive rows. If 0, the rows are contiguous.
+  */
+  vpImageView(Type *data, unsigned int height, unsigned int width, size_t stride = 0)
+    : m_data(data), m_height(height), m_width(width), m_stride(stride != 0 ? stride : width * sizeof(Type))
+  {
+  }
+
+  /*!
+    Create a view on all the pixels of an image.
+  */
+  vpImageView(const vpImage<Type> &I)
+    : m_data(I.bitmap), m_height(I.getHeight()), m_width(I.getWidth()), m_stride(I.getWidth() * sizeof(Type))
+  {
+  }
+
+  /*!
+    Create a view on a region of interest of an image.
+    \param I : Image.
+    \param top, left : Position of the top left pixel of the region in \e I.
+    \param height, width : Size of the region.
+
+    \exception vpImageException::notInTheImage : If the region is not
+    included in the image.
+  */
+  vpImageView(const vpImage<Type> &I, unsigned int top, unsigned int left, unsigned int height, unsigned int width)
+    : m_data(NULL), m_height(0), m_width(0), m_stride(I.getWidth() * sizeof(Type))
+  {
+    if (top > I.getHeight() || left > I.getWidth() || height > I.getHeight() - top || width > I.getWidth() - left) {
+      throw(vpImageException(vpImageException::notInTheImage,
+                             "Region (%u, %u) %ux%u out of a %ux%u image",
+                             top, left, height, width, I.getHeight(), I.getWidth()));
+    }
+    m_data = I.bitmap + (size_t)top * I.getWidth() + left;
+    m_height = height;
+    m_width = width;
+  }
+
+  /*!
+    Create a view on a region of interest of an image. The region is clipped
+    to the image as in vpImageTools::crop(const vpImage<Type> &, const vpRect &, vpImage<Type> &).
+  */
+  vpImageView(const vpImage<Type> &I, const vpRect &roi)
+    : m_data(NULL), m_height(0), m_width(0), m_stride(I.getWidth() * sizeof(Type))
+  {
+    if (I.getSize() == 0)
+      return;
+    unsigned int left = clip(roi.getLeft(), I.getWidth());
+    unsigned int top = clip(roi.getTop(), I.getHeight());
+    unsigned int right = clip(ceil(roi.getRight()), I.getWidth());
+    unsigned int bottom = clip(ceil(roi.getBottom()), I.getHeight());
+    if (right < left || bottom < top)
+      return;
+    m_data = I.bitmap + (size_t)top * I.getWidth() + left;
+    m_height = bottom - top + 1;
+    m_width = right - left + 1;
+  }
+
+  /*!
+    Return a view on a region of interest of this view.
+
+    \exception vpImageException::notInTheImage : If the region is not
+    included in the view.
+  */
+  vpImageView<Type> getSubView(unsigned int top, unsigned int left, unsigned int height, unsigned int width) const
+  {
+    if (top > m_height || left > m_width || height > m_height - top || width > m_width - left) {
+      throw(vpImageException(vpImageException::notInTheImage,
+                             "Region (%u, %u) %ux%u out of a %ux%u view",
+                             top, left, height, width, m_height, m_width));
+    }
+    return vpImageView<Type>((*this)[top] + left, height, width, m_stride);
+  }
+
+  /*!
+    Copy the pixels of the view in an image of the same size.
+  */
+  void copyTo(vpImage<Type> &I) const
+  {
+    I.resize(m_height, m_width);
+    for (unsigned int i = 0; i < m_height; i++)
+      memcpy(I[i], (*this)[i], m_width * sizeof(Type));
+  }
+
+  //! Return the address of the first pixel.
+  inline Type *getData() const { return m_data; }
+  //! Return the number of rows.
+  inline unsigned int getHeight() const { return m_height; }
+  //! Return the number of pixels of the view.
+  inline unsigned int getSize() const { return m_height * m_width; }
+  //! Return the number of bytes between the first pixels of two consecutive rows.
+  inline size_t getStride() const { return m_stride; }
+  //! Return the number of columns.
+  inline unsigned int getWidth() const { return m_width; }
+  //! Return true if the rows are stored contiguously, without padding.
+  inline bool isContiguous() const { return m_stride == m_width * sizeof(Type) || m_height <= 1; }
+
+  //! Return the address of the first pixel of the row \e i.
+  inline Type *operator[](unsigned int i) const
+  {
+    return (Type *)((unsigned char *)m_data + (size_t)i * m_stride);
+  }
+
+  /*!
+    Return true if the pixels of the view and the bitmap of \e I share
+    memory, for instance when the view is a region of interest of \e I.
+    A function writing in \e I, or resizing it, would then modify or release
+    the pixels it reads.
+  */
+  template<class Type2>
+  bool overlaps(const vpImage<Type2> &I) const
+  {
+    if (getSize() == 0 || I.getSize() == 0)
+      return false;
+    const unsigned char *begin = (const unsigned char *)m_data;
+    const unsigned char *end = begin + (size_t)(m_height - 1) * m_stride + (size_t)m_width * sizeof(Type);
+    const unsigned char *beginI = (const unsigned char *)I.bitmap;
+    const unsigned char *endI = beginI + (size_t)I.getSize() * sizeof(Type2);
+    return begin < endI && beginI < end;
+  }
+
+private:
+  static unsigned int clip(double v, unsigned int size)
+  {
+    if (v < 0.)
+      return 0;
+    if (v >= size)
+      return size - 1;
+    return (unsigned int)v;
+  }
+
+  Type *m_data;
+  unsigned int m_height;
+  unsigned int m_width;
+  size_t m_stride;
+};
+
+#endif
@@ -123,6 +123,9 @@ protected :
   //! When set to true, print the content of internal variables during filtering() and prediction().
   bool verbose_mode;
 
+  //! When set to true, filtering() updates the covariance with the Joseph form.
+  bool joseph_form;
+
 public:
   vpKalmanFilter() ;
   vpKalmanFilter(unsigned int n_signal) ;
@@ -163,6 +166,21 @@ public:
     filter internal values.
   */
   void verbose(bool on) { verbose_mode = on;};
+  /*!
+    Return true if filtering() updates the covariance with the Joseph form.
+  */
+  bool getJosephForm() const { return joseph_form; }
+  /*!
+    Sets the covariance update used by filtering().
+    \param on : If true, the updated covariance is computed with the Joseph form
+    \f[
+    {\bf P}_{k \mid k} = \left({\bf I} - {\bf W}_k {\bf H} \right) {\bf P}_{k \mid k-1}
+    \left({\bf I} - {\bf W}_k {\bf H} \right)^T + {\bf W}_k {\bf R}_k {\bf W}^T_k
+    \f]
+    that keeps it symmetric and positive definite despite rounding errors,
+    at the price of a few more matrix products.
+  */
+  void setJosephForm(bool on) { joseph_form = on; }
 
 public:
   /*!
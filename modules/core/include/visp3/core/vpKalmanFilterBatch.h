@@ -0,0 +1,148 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Kalman filtering of many independent signals at once.
+ *
+ *****************************************************************************/
+
+#ifndef __vpKalmanFilterBatch_h_
+#define __vpKalmanFilterBatch_h_
+
+/*!
+  \file vpKalmanFilterBatch.h
+  \brief Kalman filtering of many independent signals at once.
+*/
+
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpLinearKalmanFilterInstantiation.h>
+
+/*!
+  \class vpKalmanFilterBatch
+  \ingroup group_core_kalman
+
+  \brief Filter many independent signals with the state models of
+  vpLinearKalmanFilterInstantiation.
+
+  vpLinearKalmanFilterInstantiation filters \e n signals with a single
+  Kalman filter whose matrices are block diagonal, so that each prediction
+  and filtering step costs products and an inversion of matrices whose size
+  grows with \e n, although the signals are decoupled. vpKalmanFilterBatch
+  runs instead one small filter per signal. The states and the covariances
+  of all the signals are stored as a structure of arrays, one array per
+  coefficient, and updated with SIMD instructions. The cost of a step is
+  linear in the number of signals and no memory is allocated after
+  initFilter().
+
+  The state models, their initialization and the sequence of filter() are
+  the same as in vpLinearKalmanFilterInstantiation, so that both classes
+  give the same estimates.
+
+  \code
+  vpKalmanFilterBatch kalman;
+  kalman.initFilter(vpLinearKalmanFilterInstantiation::stateConstVel_MeasurePos, nsignal,
+                    sigma_state, sigma_measure, 0, dt);
+  for (;;) {
+    ... // Measured position of each signal in z
+    kalman.filter(z);
+    const double *position = kalman.getStateEstimate(0);
+    const double *velocity = kalman.getStateEstimate(1);
+  }
+  \endcode
+
+  With setJosephForm(), the covariance is updated with the Joseph form
+  \f[
+  {\bf P}_{k \mid k} = \left({\bf I} - {\bf W}_k {\bf H} \right) {\bf P}_{k
+  \mid k-1} \left({\bf I} - {\bf W}_k {\bf H} \right)^T + {\bf W}_k {\bf R}_k
+  {\bf W}^T_k
+  \f]
+  that keeps it symmetric positive definite despite rounding errors.
+*/
+class VISP_EXPORT vpKalmanFilterBatch
+{
+public:
+  vpKalmanFilterBatch();
+
+  void initFilter(vpLinearKalmanFilterInstantiation::vpStateModel model, unsigned int nsignal,
+                  const vpColVector &sigma_state, const vpColVector &sigma_measure, double rho, double dt);
+  void filter(const vpColVector &z);
+  void filter(const double *z);
+
+  void getStateEstimate(vpColVector &Xest) const;
+  /*!
+    Return the component \e k of the updated state of all the signals.
+  */
+  inline const double *getStateEstimate(unsigned int k) const { return m_nsignal ? &m_x[k][0] : NULL; }
+  /*!
+    Return the component \e k of the predicted state of all the signals.
+  */
+  inline const double *getStatePrediction(unsigned int k) const { return m_nsignal ? &m_xp[k][0] : NULL; }
+  double getCovarianceEstimate(unsigned int signal, unsigned int k, unsigned int l) const;
+
+  //! Return the iteration number.
+  inline long getIteration() const { return m_iter; }
+  //! Return the number of signals to filter.
+  inline unsigned int getNumberOfSignal() const { return m_nsignal; }
+  //! Return the size of the state vector of one signal.
+  inline unsigned int getStateSize() const { return m_stateSize; }
+  //! Return the state model.
+  inline vpLinearKalmanFilterInstantiation::vpStateModel getStateModel() const { return m_model; }
+  //! Return true if the covariance is updated with the Joseph form.
+  inline bool getJosephForm() const { return m_josephForm; }
+  /*!
+    Update the covariance with the Joseph form, more stable but slower than
+    the default \f${\bf P}_{k \mid k} = {\bf P}_{k \mid k-1} - {\bf W}_k {\bf
+    S}_k {\bf W}^T_k\f$.
+  */
+  inline void setJosephForm(bool on) { m_josephForm = on; }
+
+private:
+  void prediction();
+  void filtering(const double *z);
+
+  vpLinearKalmanFilterInstantiation::vpStateModel m_model;
+  unsigned int m_stateSize;
+  unsigned int m_nsignal;
+  long m_iter;
+  double m_dt;
+  bool m_josephForm;
+  //! Transition matrix, common to all the signals
+  double m_F[3][3];
+  //! Components of the updated and predicted states
+  std::vector<double> m_x[3], m_xp[3];
+  //! Upper triangles of the updated and predicted state covariances and of the process noise covariance
+  std::vector<double> m_P[6], m_Pp[6], m_Q[6];
+  //! Measurement noise variances
+  std::vector<double> m_R;
+};
+
+#endif
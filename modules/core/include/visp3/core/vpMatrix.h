@@ -46,6 +46,7 @@
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpVelocityTwistMatrix.h>
 #include <visp3/core/vpForceTwistMatrix.h>
+#include <visp3/core/vpMatrixExpression.h>
 
 #ifdef VISP_HAVE_GSL
 #  include <gsl/gsl_math.h>
@@ -134,6 +135,15 @@ class VISP_EXPORT vpMatrix : public vpArray2D<double>
      \endcode
    */
   vpMatrix(const vpArray2D<double>& A) : vpArray2D<double>(A) {};
+  /*!
+     Create a matrix from the evaluation of a lazy expression built with
+     vpTranspose() or vpDiag(), see vpMatrixExpression.h.
+     \code
+     vpMatrix LtWL = vpTranspose(L) * vpDiag(w) * L;
+     \endcode
+   */
+  template<class E>
+  vpMatrix(const vpMatrixExpr<E> &e) : vpArray2D<double>(0, 0) { e.assignTo(*this); }
 
   //! Destructor (Memory de-allocation)
   virtual ~vpMatrix() {};
@@ -144,16 +154,7 @@ class VISP_EXPORT vpMatrix : public vpArray2D<double>
   */
   void clear()
   {
-    if (data != NULL ) {
-      free(data);
-      data=NULL;
-    }
-
-    if (rowPtrs!=NULL) {
-      free(rowPtrs);
-      rowPtrs=NULL ;
-    }
-    rowNum = colNum = dsize = 0;
+    releaseStorage();
   }
 
   //-------------------------------------------------
@@ -178,6 +179,12 @@ class VISP_EXPORT vpMatrix : public vpArray2D<double>
   vpMatrix &operator<<(double*);
   vpMatrix &operator=(const vpArray2D<double> &A);
   vpMatrix &operator=(const double x);
+  /*!
+    Evaluate a lazy expression built with vpTranspose() or vpDiag(), see
+    vpMatrixExpression.h, without intermediate matrices.
+  */
+  template<class E>
+  vpMatrix &operator=(const vpMatrixExpr<E> &e) { e.assignTo(*this); return *this; }
   //@}
 
   //-------------------------------------------------
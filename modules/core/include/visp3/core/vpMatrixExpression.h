@@ -0,0 +1,498 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Lazy evaluation of matrix products, transpositions and weightings.
+ *
+ *****************************************************************************/
+
+#ifndef __vpMatrixExpression_h_
+#define __vpMatrixExpression_h_
+
+#include <string.h>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpException.h>
+
+/*!
+  \file vpMatrixExpression.h
+
+  \brief Lazy evaluation of matrix expressions built with vpTranspose(),
+  vpDiag(), scalar scaling and products.
+
+  Contrary to the vpMatrix operators that create a temporary matrix for each
+  intermediate result, the expressions built from vpTranspose() and vpDiag()
+  are only evaluated when they are assigned to a vpMatrix or a vpColVector.
+  The transposition, the scaling and the diagonal weighting are then fused in
+  the product loops so that neither \f${\bf L}^T\f$ nor the weighted matrix are
+  built. The following example computes \f${\bf L}^T {\bf W} {\bf L}\f$ and
+  \f${\bf L}^T {\bf W} {\bf e}\f$ with \f${\bf W} = diag({\bf w})\f$ in a single
+  pass over \f${\bf L}\f$ and without any intermediate allocation:
+  \code
+  vpMatrix L;
+  vpColVector w, e;
+  ...
+  vpMatrix LtWL = vpTranspose(L) * vpDiag(w) * L;
+  vpColVector v = -lambda * (vpTranspose(L) * vpDiag(w) * e);
+  \endcode
+
+  Since the operands are referenced and not copied, an expression must be
+  assigned within the statement that builds it. Assigning an expression to
+  one of its operands is allowed. When a product is itself an operand of
+  another product or of a transposition, it is evaluated once in a temporary.
+*/
+
+/*!
+  \class vpMatrixExpr
+  \ingroup group_core_matrices
+
+  \brief Base class of the lazy matrix expressions, see vpMatrixExpression.h.
+
+  Each expression E provides getRows(), getCols(), operator()(i, j) that
+  returns the element \f$(i, j)\f$, evalTo() that writes the result in an
+  array, aliases() that tells if an array is one of the operands, and the
+  constants \e Cheap (elements accessed in O(1)) and \e ColumnMajor (elements
+  faster accessed column by column).
+*/
+template<class E>
+class vpMatrixExpr
+{
+public:
+  //! Return the expression as its actual type.
+  inline const E &derived() const { return static_cast<const E &>(*this); }
+
+  /*!
+    Evaluate the expression element by element into \e A.
+  */
+  void evalTo(vpArray2D<double> &A) const
+  {
+    const E &e = derived();
+    unsigned int nrows = e.getRows(), ncols = e.getCols();
+    A.resize(nrows, ncols, false);
+    for (unsigned int i = 0; i < nrows; i++) {
+      double *a = A[i];
+      for (unsigned int j = 0; j < ncols; j++)
+        a[j] = e(i, j);
+    }
+  }
+
+  /*!
+    Evaluate the expression into \e A, through a temporary when \e A is one
+    of its operands.
+  */
+  void assignTo(vpArray2D<double> &A) const
+  {
+    const E &e = derived();
+    if (e.aliases(A)) {
+      vpArray2D<double> tmp;
+      e.evalTo(tmp);
+      A = tmp;
+    }
+    else
+      e.evalTo(A);
+  }
+};
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+/*
+  Leaf referencing an existing array.
+*/
+class vpMatrixLeafExpr : public vpMatrixExpr<vpMatrixLeafExpr>
+{
+private:
+  const vpArray2D<double> &A;
+
+public:
+  enum { Cheap = 1, ColumnMajor = 0 };
+
+  explicit vpMatrixLeafExpr(const vpArray2D<double> &M) : A(M) {}
+  inline unsigned int getRows() const { return A.getRows(); }
+  inline unsigned int getCols() const { return A.getCols(); }
+  inline double operator()(unsigned int i, unsigned int j) const { return A[i][j]; }
+  inline bool aliases(const vpArray2D<double> &M) const { return &M == &A; }
+};
+
+/*
+  Leaf owning the result of a sub-expression that is too expensive to be
+  accessed element by element.
+*/
+class vpMatrixTempExpr : public vpMatrixExpr<vpMatrixTempExpr>
+{
+private:
+  vpArray2D<double> A;
+
+public:
+  enum { Cheap = 1, ColumnMajor = 0 };
+
+  template<class E>
+  explicit vpMatrixTempExpr(const vpMatrixExpr<E> &e) : A() { e.derived().evalTo(A); }
+  inline unsigned int getRows() const { return A.getRows(); }
+  inline unsigned int getCols() const { return A.getCols(); }
+  inline double operator()(unsigned int i, unsigned int j) const { return A[i][j]; }
+  inline bool aliases(const vpArray2D<double> &) const { return false; }
+};
+
+/*
+  Type used to store an operand E in a transposition or a product: E itself
+  when its elements are cheap to access, a temporary otherwise.
+*/
+template<class E, bool cheap = (E::Cheap != 0)>
+struct vpMatrixExprOperand
+{
+  typedef E type;
+};
+
+template<class E>
+struct vpMatrixExprOperand<E, false>
+{
+  typedef vpMatrixTempExpr type;
+};
+
+template<class E>
+class vpMatrixTransposeExpr : public vpMatrixExpr<vpMatrixTransposeExpr<E> >
+{
+private:
+  typedef typename vpMatrixExprOperand<E>::type Operand;
+  Operand e;
+
+public:
+  enum { Cheap = 1, ColumnMajor = !Operand::ColumnMajor };
+
+  explicit vpMatrixTransposeExpr(const E &expr) : e(expr) {}
+  inline unsigned int getRows() const { return e.getCols(); }
+  inline unsigned int getCols() const { return e.getRows(); }
+  inline double operator()(unsigned int i, unsigned int j) const { return e(j, i); }
+  inline bool aliases(const vpArray2D<double> &M) const { return e.aliases(M); }
+};
+
+template<class E>
+class vpMatrixScaledExpr : public vpMatrixExpr<vpMatrixScaledExpr<E> >
+{
+private:
+  E e;
+  double s;
+
+public:
+  enum { Cheap = E::Cheap, ColumnMajor = E::ColumnMajor };
+
+  vpMatrixScaledExpr(const E &expr, double scale) : e(expr), s(scale) {}
+  inline unsigned int getRows() const { return e.getRows(); }
+  inline unsigned int getCols() const { return e.getCols(); }
+  inline double operator()(unsigned int i, unsigned int j) const { return s * e(i, j); }
+  inline bool aliases(const vpArray2D<double> &M) const { return e.aliases(M); }
+  void evalTo(vpArray2D<double> &A) const
+  {
+    e.evalTo(A);
+    for (unsigned int i = 0; i < A.size(); i++)
+      A.data[i] *= s;
+  }
+};
+
+/*
+  diag(w) * E
+*/
+template<class E>
+class vpMatrixRowScaledExpr : public vpMatrixExpr<vpMatrixRowScaledExpr<E> >
+{
+private:
+  E e;
+  const double *w;
+
+public:
+  enum { Cheap = E::Cheap, ColumnMajor = E::ColumnMajor };
+
+  vpMatrixRowScaledExpr(const vpArray2D<double> &weights, const E &expr) : e(expr), w(weights.data)
+  {
+    if (weights.size() != expr.getRows())
+      throw vpException(vpException::dimensionError,
+                        "Cannot multiply a (%dx%d) diagonal matrix by a (%dx%d) matrix",
+                        weights.size(), weights.size(), expr.getRows(), expr.getCols());
+  }
+  inline unsigned int getRows() const { return e.getRows(); }
+  inline unsigned int getCols() const { return e.getCols(); }
+  inline double operator()(unsigned int i, unsigned int j) const { return w[i] * e(i, j); }
+  inline bool aliases(const vpArray2D<double> &M) const { return (M.data == w) || e.aliases(M); }
+  void evalTo(vpArray2D<double> &A) const
+  {
+    e.evalTo(A);
+    unsigned int ncols = A.getCols();
+    for (unsigned int i = 0; i < A.getRows(); i++) {
+      double *a = A[i];
+      for (unsigned int j = 0; j < ncols; j++)
+        a[j] *= w[i];
+    }
+  }
+};
+
+/*
+  E * diag(w)
+*/
+template<class E>
+class vpMatrixColScaledExpr : public vpMatrixExpr<vpMatrixColScaledExpr<E> >
+{
+private:
+  E e;
+  const double *w;
+
+public:
+  enum { Cheap = E::Cheap, ColumnMajor = E::ColumnMajor };
+
+  vpMatrixColScaledExpr(const E &expr, const vpArray2D<double> &weights) : e(expr), w(weights.data)
+  {
+    if (weights.size() != expr.getCols())
+      throw vpException(vpException::dimensionError,
+                        "Cannot multiply a (%dx%d) matrix by a (%dx%d) diagonal matrix",
+                        expr.getRows(), expr.getCols(), weights.size(), weights.size());
+  }
+  inline unsigned int getRows() const { return e.getRows(); }
+  inline unsigned int getCols() const { return e.getCols(); }
+  inline double operator()(unsigned int i, unsigned int j) const { return e(i, j) * w[j]; }
+  inline bool aliases(const vpArray2D<double> &M) const { return (M.data == w) || e.aliases(M); }
+  void evalTo(vpArray2D<double> &A) const
+  {
+    e.evalTo(A);
+    unsigned int ncols = A.getCols();
+    for (unsigned int i = 0; i < A.getRows(); i++) {
+      double *a = A[i];
+      for (unsigned int j = 0; j < ncols; j++)
+        a[j] *= w[j];
+    }
+  }
+};
+
+template<class L, class R>
+class vpMatrixProductExpr : public vpMatrixExpr<vpMatrixProductExpr<L, R> >
+{
+private:
+  typedef typename vpMatrixExprOperand<L>::type LOperand;
+  typedef typename vpMatrixExprOperand<R>::type ROperand;
+  LOperand l;
+  ROperand r;
+
+public:
+  enum { Cheap = 0, ColumnMajor = 0 };
+
+  vpMatrixProductExpr(const L &lhs, const R &rhs) : l(lhs), r(rhs)
+  {
+    if (l.getCols() != r.getRows())
+      throw vpException(vpException::dimensionError,
+                        "Cannot multiply a (%dx%d) matrix by a (%dx%d) matrix",
+                        l.getRows(), l.getCols(), r.getRows(), r.getCols());
+  }
+  inline unsigned int getRows() const { return l.getRows(); }
+  inline unsigned int getCols() const { return r.getCols(); }
+  inline double operator()(unsigned int i, unsigned int j) const
+  {
+    double s = 0;
+    for (unsigned int k = 0; k < l.getCols(); k++)
+      s += l(i, k) * r(k, j);
+    return s;
+  }
+  inline bool aliases(const vpArray2D<double> &M) const { return l.aliases(M) || r.aliases(M); }
+
+  /*
+    Accumulate the product as a sum of outer products. When the left operand
+    is faster accessed by columns, as a transposed matrix, the loop over the
+    inner dimension is the outer one so that both operands are read row by
+    row in a single pass.
+  */
+  void evalTo(vpArray2D<double> &A) const
+  {
+    unsigned int m = l.getRows(), n = r.getCols(), nk = l.getCols();
+    A.resize(m, n, false);
+    memset(A.data, 0, m * n * sizeof(double));
+    if (LOperand::ColumnMajor) {
+      for (unsigned int k = 0; k < nk; k++) {
+        for (unsigned int i = 0; i < m; i++) {
+          double lik = l(i, k);
+          if (lik == 0.)
+            continue;
+          double *a = A[i];
+          for (unsigned int j = 0; j < n; j++)
+            a[j] += lik * r(k, j);
+        }
+      }
+    }
+    else {
+      for (unsigned int i = 0; i < m; i++) {
+        double *a = A[i];
+        for (unsigned int k = 0; k < nk; k++) {
+          double lik = l(i, k);
+          if (lik == 0.)
+            continue;
+          for (unsigned int j = 0; j < n; j++)
+            a[j] += lik * r(k, j);
+        }
+      }
+    }
+  }
+};
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  \class vpMatrixDiagExpr
+  \ingroup group_core_matrices
+
+  \brief Diagonal matrix \f$diag({\bf w})\f$ that only exists as a left or right
+  operand of a lazy product, see vpDiag().
+*/
+class vpMatrixDiagExpr
+{
+public:
+  //! Diagonal elements.
+  const vpArray2D<double> &w;
+
+  explicit vpMatrixDiagExpr(const vpArray2D<double> &weights) : w(weights) {}
+
+private:
+  vpMatrixDiagExpr &operator=(const vpMatrixDiagExpr &);
+};
+
+/*!
+  \relates vpMatrixExpr
+  Lazy transposition of \e A.
+*/
+inline vpMatrixTransposeExpr<vpMatrixLeafExpr> vpTranspose(const vpArray2D<double> &A)
+{
+  return vpMatrixTransposeExpr<vpMatrixLeafExpr>(vpMatrixLeafExpr(A));
+}
+
+/*!
+  \relates vpMatrixExpr
+  Lazy transposition of the expression \e e.
+*/
+template<class E>
+inline vpMatrixTransposeExpr<E> vpTranspose(const vpMatrixExpr<E> &e)
+{
+  return vpMatrixTransposeExpr<E>(e.derived());
+}
+
+/*!
+  \relates vpMatrixExpr
+  Diagonal matrix which diagonal is the vector \e w, for instance the weights
+  of a robust estimation. It is never built: multiplying a matrix by it only
+  scales the rows or the columns of that matrix during the evaluation.
+*/
+inline vpMatrixDiagExpr vpDiag(const vpArray2D<double> &w)
+{
+  return vpMatrixDiagExpr(w);
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+
+template<class E1, class E2>
+inline vpMatrixProductExpr<E1, E2> operator*(const vpMatrixExpr<E1> &e1, const vpMatrixExpr<E2> &e2)
+{
+  return vpMatrixProductExpr<E1, E2>(e1.derived(), e2.derived());
+}
+
+template<class E>
+inline vpMatrixProductExpr<E, vpMatrixLeafExpr> operator*(const vpMatrixExpr<E> &e, const vpArray2D<double> &B)
+{
+  return vpMatrixProductExpr<E, vpMatrixLeafExpr>(e.derived(), vpMatrixLeafExpr(B));
+}
+
+// True when T is vpArray2D<double> or derives from it.
+template<class T>
+struct vpMatrixExprIsArray
+{
+  static char test(const vpArray2D<double> *);
+  static long test(...);
+  static const bool value = (sizeof(test((const T *)NULL)) == sizeof(char));
+};
+
+template<bool enable, class T>
+struct vpMatrixExprEnableIf
+{
+};
+
+template<class T>
+struct vpMatrixExprEnableIf<true, T>
+{
+  typedef T type;
+};
+
+// The left operand is deduced so that it is an exact match. With a
+// vpArray2D<double> parameter, vpMatrix * e would be ambiguous with
+// vpMatrix::operator*(const vpMatrix &), e being implicitly converted to a
+// vpMatrix, and likewise for the other arrays multiplied by a vpMatrix or a
+// vpColVector.
+template<class A, class E>
+inline typename vpMatrixExprEnableIf<vpMatrixExprIsArray<A>::value, vpMatrixProductExpr<vpMatrixLeafExpr, E> >::type
+operator*(const A &a, const vpMatrixExpr<E> &e)
+{
+  return vpMatrixProductExpr<vpMatrixLeafExpr, E>(vpMatrixLeafExpr(a), e.derived());
+}
+
+template<class E>
+inline vpMatrixScaledExpr<E> operator*(double s, const vpMatrixExpr<E> &e)
+{
+  return vpMatrixScaledExpr<E>(e.derived(), s);
+}
+
+template<class E>
+inline vpMatrixScaledExpr<E> operator*(const vpMatrixExpr<E> &e, double s)
+{
+  return vpMatrixScaledExpr<E>(e.derived(), s);
+}
+
+template<class E>
+inline vpMatrixScaledExpr<E> operator-(const vpMatrixExpr<E> &e)
+{
+  return vpMatrixScaledExpr<E>(e.derived(), -1.);
+}
+
+template<class E>
+inline vpMatrixRowScaledExpr<E> operator*(const vpMatrixDiagExpr &D, const vpMatrixExpr<E> &e)
+{
+  return vpMatrixRowScaledExpr<E>(D.w, e.derived());
+}
+
+inline vpMatrixRowScaledExpr<vpMatrixLeafExpr> operator*(const vpMatrixDiagExpr &D, const vpArray2D<double> &A)
+{
+  return vpMatrixRowScaledExpr<vpMatrixLeafExpr>(D.w, vpMatrixLeafExpr(A));
+}
+
+template<class E>
+inline vpMatrixColScaledExpr<E> operator*(const vpMatrixExpr<E> &e, const vpMatrixDiagExpr &D)
+{
+  return vpMatrixColScaledExpr<E>(e.derived(), D.w);
+}
+
+inline vpMatrixColScaledExpr<vpMatrixLeafExpr> operator*(const vpArray2D<double> &A, const vpMatrixDiagExpr &D)
+{
+  return vpMatrixColScaledExpr<vpMatrixLeafExpr>(vpMatrixLeafExpr(A), D.w);
+}
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+#endif
@@ -237,8 +237,10 @@ public:
   */
   virtual ~vpMomentObject();
 
-  void fromImage(const vpImage<unsigned char>& image,unsigned char threshold, const vpCameraParameters& cam); // Binary version
-  void fromImage(const vpImage<unsigned char>& image, const vpCameraParameters& cam, vpCameraImgBckGrndType bg_type, bool normalize_with_pix_size = true); // Photometric version
+  void fromImage(const vpImage<unsigned char>& image,unsigned char threshold, const vpCameraParameters& cam,
+                 unsigned int nbThreads = 1); // Binary version
+  void fromImage(const vpImage<unsigned char>& image, const vpCameraParameters& cam, vpCameraImgBckGrndType bg_type,
+                 bool normalize_with_pix_size = true, unsigned int nbThreads = 1); // Photometric version
 
   void fromVector(std::vector<vpPoint>& points);
   const std::vector<double>& get() const;
@@ -286,7 +288,6 @@ protected:
   void cacheValues(std::vector<double>& cache,double x, double y);
 
 private:
-  void cacheValues(std::vector<double>& cache,double x, double y, double IntensityNormalized);
   double calc_mom_polygon(unsigned int p, unsigned int q, const std::vector<vpPoint>& points);
 
 };
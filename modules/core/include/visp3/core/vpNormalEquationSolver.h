@@ -0,0 +1,130 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Normal equations of a 6 dof least-squares problem.
+ *
+ *****************************************************************************/
+
+#ifndef __vpNormalEquationSolver_h_
+#define __vpNormalEquationSolver_h_
+
+#include <limits>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpMatrix.h>
+
+/*!
+  \class vpNormalEquationSolver
+  \ingroup group_core_matrices
+
+  \brief Solve a least-squares problem with 6 unknowns, typically a pose
+  increment in a virtual visual servoing loop, from its normal equations.
+
+  Instead of stacking the N rows of the (weighted) interaction matrix \f$\bf
+  J\f$ and computing its pseudo inverse with a SVD of a Nx6 matrix, the rows
+  are accumulated on the fly in the 6x6 matrix \f${\bf J}^\top {\bf W} {\bf
+  J}\f$ and in the 6-dimension vector \f${\bf J}^\top {\bf W} {\bf e}\f$.
+  solve() then computes
+  \f[ {\bf x} = ({\bf J}^\top {\bf W} {\bf J} + \mu {\bf I})^{-1} {\bf
+  J}^\top {\bf W} {\bf e} \f]
+  with a LDLT factorization, where \f$\mu\f$ is the Levenberg-Marquardt
+  damping. When the system is rank deficient, the 6x6 matrix is inverted
+  with a SVD instead and the minimal norm solution is returned, as
+  vpMatrix::pseudoInverse() does.
+
+  \code
+  vpNormalEquationSolver solver;
+  for (unsigned int iter = 0; iter < 30; iter++) {
+    solver.reset();
+    for (unsigned int i = 0; i < n; i++) {
+      double J[6];
+      ... // Row i of the interaction matrix and error e[i]
+      solver.addRow(J, e[i], w[i]);
+    }
+    vpColVector v;
+    solver.solve(v);
+    cMo = vpExponentialMap::direct(-lambda * v).inverse() * cMo;
+  }
+  \endcode
+
+  The solver holds no dynamically allocated memory. Several solvers filled
+  by concurrent threads can be merged with add().
+*/
+class VISP_EXPORT vpNormalEquationSolver
+{
+public:
+  vpNormalEquationSolver();
+
+  void reset();
+
+  /*!
+    Add a row of the least-squares problem.
+
+    \param J : Row of the interaction matrix, 6 values.
+    \param e : Error associated to the row.
+    \param w : Weight of the row. Note that for a weighted matrix
+    \f${\bf D J}\f$ and error \f${\bf D e}\f$, the weight is the square of the
+    diagonal coefficient of \f${\bf D}\f$.
+  */
+  inline void addRow(const double *J, double e, double w = 1.0)
+  {
+    double *JTJ = m_JTJ;
+    for (unsigned int i = 0; i < 6; i++) {
+      const double wJi = w * J[i];
+      m_JTe[i] += wJi * e;
+      for (unsigned int j = i; j < 6; j++)
+        *JTJ++ += wJi * J[j];
+    }
+    m_nbRows++;
+  }
+
+  void addRows(const vpMatrix &J, const vpColVector &e);
+  void addRows(const vpMatrix &J, const vpColVector &e, const vpColVector &w);
+  void add(const vpNormalEquationSolver &solver);
+  void transform(const vpMatrix &M);
+
+  void getJTJ(vpMatrix &JTJ) const;
+  void getJTe(vpColVector &JTe) const;
+  //! Return the number of rows added since the last reset().
+  inline unsigned int getNbRows() const { return m_nbRows; }
+
+  unsigned int getRank(double svThreshold = 6 * std::numeric_limits<double>::epsilon()) const;
+  unsigned int solve(vpColVector &x, double mu = 0.0,
+                     double svThreshold = 6 * std::numeric_limits<double>::epsilon()) const;
+
+private:
+  //! Upper triangle of the 6x6 matrix, row by row
+  double m_JTJ[21];
+  double m_JTe[6];
+  unsigned int m_nbRows;
+};
+
+#endif
@@ -0,0 +1,141 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Set of 3D points stored as a structure of arrays.
+ *
+ *****************************************************************************/
+
+#ifndef __vpPointSet_h_
+#define __vpPointSet_h_
+
+/*!
+  \file vpPointSet.h
+  \brief Set of 3D points stored as a structure of arrays.
+*/
+
+#include <list>
+#include <vector>
+
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpHomogeneousMatrix.h>
+#include <visp3/core/vpPoint.h>
+
+/*!
+  \class vpPointSet
+  \ingroup group_core_geometry
+
+  \brief Set of 3D points that are changed of frame and projected all at
+  once.
+
+  A vpPoint stores its coordinates in several vpColVector and is projected
+  through virtual calls. The same operations on a CAD model or on a
+  calibration grid are thus dominated by the memory allocations and the
+  indirections. vpPointSet stores the coordinates of all the points in
+  contiguous arrays, one per coordinate. track() computes in a single SIMD
+  loop the coordinates in the camera frame, the normalized coordinates and,
+  when camera parameters are given, the pixel coordinates of all the points.
+
+  \code
+  vpPointSet model;
+  model.buildFrom(points); // std::list<vpPoint> or std::vector<vpPoint>
+  model.track(cMo, cam);
+  const double *u = model.get_u();
+  const double *v = model.get_v();
+  for (unsigned int i = 0; i < model.size(); i++) {
+    ... // Pixel coordinates of point i are (u[i], v[i])
+  }
+  \endcode
+
+  The points are expected to have a unit homogeneous coordinate in the
+  object frame, that is the usual case. Points added from a vpPoint with
+  another homogeneous coordinate are normalized.
+*/
+class VISP_EXPORT vpPointSet
+{
+public:
+  vpPointSet();
+  explicit vpPointSet(const std::list<vpPoint> &points);
+  explicit vpPointSet(const std::vector<vpPoint> &points);
+
+  void addPoint(double oX, double oY, double oZ);
+  void addPoint(const vpPoint &P);
+  void buildFrom(const std::list<vpPoint> &points);
+  void buildFrom(const std::vector<vpPoint> &points);
+  void clear();
+  void reserve(unsigned int n);
+  void setWorldCoordinates(unsigned int i, double oX, double oY, double oZ);
+  //! Return the number of points.
+  inline unsigned int size() const { return (unsigned int)m_oX.size(); }
+
+  void changeFrame(const vpHomogeneousMatrix &cMo);
+  void projection();
+  void meterToPixel(const vpCameraParameters &cam);
+  void track(const vpHomogeneousMatrix &cMo);
+  void track(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam);
+
+  void getPoint(unsigned int i, vpPoint &P) const;
+
+  /** @name Coordinates of the points  */
+  //@{
+  //! Coordinates along the X axis in the object frame.
+  inline const double *get_oX() const { return data(m_oX); }
+  //! Coordinates along the Y axis in the object frame.
+  inline const double *get_oY() const { return data(m_oY); }
+  //! Coordinates along the Z axis in the object frame.
+  inline const double *get_oZ() const { return data(m_oZ); }
+  //! Coordinates along the X axis in the camera frame, updated by changeFrame() and track().
+  inline const double *get_X() const { return data(m_X); }
+  //! Coordinates along the Y axis in the camera frame, updated by changeFrame() and track().
+  inline const double *get_Y() const { return data(m_Y); }
+  //! Coordinates along the Z axis in the camera frame, updated by changeFrame() and track().
+  inline const double *get_Z() const { return data(m_Z); }
+  //! Normalized coordinates along the x axis, updated by projection() and track().
+  inline const double *get_x() const { return data(m_x); }
+  //! Normalized coordinates along the y axis, updated by projection() and track().
+  inline const double *get_y() const { return data(m_y); }
+  //! Pixel coordinates along the u axis, updated by meterToPixel() and track() with camera parameters.
+  inline const double *get_u() const { return data(m_u); }
+  //! Pixel coordinates along the v axis, updated by meterToPixel() and track() with camera parameters.
+  inline const double *get_v() const { return data(m_v); }
+  //@}
+
+private:
+  static inline const double *data(const std::vector<double> &v) { return v.empty() ? NULL : &v[0]; }
+
+  void transform(const vpHomogeneousMatrix &cMo, bool storeNormalized, const vpCameraParameters *cam);
+
+  std::vector<double> m_oX, m_oY, m_oZ;
+  std::vector<double> m_X, m_Y, m_Z;
+  std::vector<double> m_x, m_y;
+  std::vector<double> m_u, m_v;
+};
+
+#endif
@@ -55,7 +55,7 @@ class vpTranslationVector;
 class vpThetaUVector;
 class vpRowVector;
 
-#include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpFixedArray2D.h>
 #include <visp3/core/vpMatrix.h>
 #include <visp3/core/vpRotationMatrix.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
@@ -71,7 +71,9 @@ class vpRowVector;
   The vpPose class implements a complete representation of every rigid motion in the
   euclidian space.
 
-  The vpPose class is derived from vpArray2D<double>.
+  The vpPose class is derived from vpFixedArray2D<double, 6, 1>, itself
+  derived from vpArray2D<double>. Its elements are stored inline so that it
+  never allocates memory.
 
   The pose is composed of a translation and a rotation
   minimaly represented by a 6 dimension pose vector as: \f[ ^{a}{\bf
@@ -90,7 +92,7 @@ class vpRowVector;
   see vpThetaUVector documentation.
 
 */
-class VISP_EXPORT vpPoseVector : public vpArray2D<double>
+class VISP_EXPORT vpPoseVector : public vpFixedArray2D<double, 6, 1>
 {
 public:
   // constructor
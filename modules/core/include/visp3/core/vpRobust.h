@@ -45,6 +45,8 @@
 #ifndef CROBUST_HH
 #define CROBUST_HH
 
+#include <vector>
+
 #include <visp3/core/vpConfig.h>
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpMath.h>
@@ -56,6 +58,14 @@
   \brief Contains an M-Estimator and various influence function.
 
   Supported methods: M-estimation, Tukey, Cauchy and Huber
+
+  The median and the median absolute deviation are selected in linear time
+  (introselect) within scratch buffers owned by the estimator. These
+  buffers only grow, so that calling MEstimator() at each iteration of a
+  tracking loop does not allocate once the largest residue vector has been
+  seen. For very large residue vectors, setMedianHistogramThreshold() makes
+  the selection go through a histogram of the residues, which avoids copying
+  the whole vector in the scratch buffer.
 */
 class VISP_EXPORT vpRobust
 {
@@ -73,11 +83,15 @@ public:
 private:
 
   //!Normalized residue
-  vpColVector normres; 
-  //!Sorted normalized Residues
-  vpColVector sorted_normres;
-  //!Sorted residues
-  vpColVector sorted_residues;
+  std::vector<double> normres;
+  //!Partially sorted residues used by the median selection
+  std::vector<double> sorted_residues;
+  //!Normalized residues of the whole data set
+  std::vector<double> m_allNormres;
+  //!Histogram used by the median selection of large vectors
+  std::vector<unsigned int> m_histogram;
+  //!Size from which the median is selected from a histogram, 0 to disable
+  unsigned int m_histogramThreshold;
 
   //!Noise threshold
   double NoiseThreshold;
@@ -85,8 +99,6 @@ private:
   double sig_prev;
   //!
   unsigned int it;
-  //! Vairiable used in swap method
-  double swap;
   //! Size of the containers
   unsigned int size;
 
@@ -127,6 +139,24 @@ public:
     NoiseThreshold=noise_threshold;
   }
 
+  /*!
+    Select the median and the median absolute deviation from a histogram of
+    the residues when the residue vector has at least \e n_data elements.
+    The result is exactly the same as the default introselect, but the
+    residues are not copied in a scratch buffer. This is worth it from a few
+    hundreds of thousands of residues.
+
+    \param n_data : Minimal size of the residue vector, 0 to disable the
+    histogram selection (default).
+  */
+  inline void setMedianHistogramThreshold(const unsigned int n_data) {
+    m_histogramThreshold = n_data;
+  }
+  //! Return the size from which the median is selected from a histogram.
+  inline unsigned int getMedianHistogramThreshold() const {
+    return m_histogramThreshold;
+  }
+
 //public :
 //double residualMedian ;
 //double normalizedResidualMedian ;
@@ -136,7 +166,7 @@ public:
 
  private:
   //!Compute normalized median
-  double computeNormalizedMedian(vpColVector &all_normres,
+  double computeNormalizedMedian(std::vector<double> &all_normres,
 				 const vpColVector &residues,
 				 const vpColVector &all_residues,
 				 const vpColVector &weights				 
@@ -154,13 +184,13 @@ public:
   /** @name PsiFunctions  */
   //@{
   //! Tuckey influence function 
-  void psiTukey(double sigma, vpColVector &x, vpColVector &w);
+  void psiTukey(double sigma, const double *x, unsigned int n, double *w);
   //! Caucht influence function 
-  void psiCauchy(double sigma, vpColVector &x, vpColVector &w);
+  void psiCauchy(double sigma, const double *x, unsigned int n, double *w);
   //! McLure influence function 
-  void psiMcLure(double sigma, vpColVector &x, vpColVector &w);
+  void psiMcLure(double sigma, const double *x, unsigned int n, double *w);
   //! Huber influence function 
-  void psiHuber(double sigma, vpColVector &x, vpColVector &w);
+  void psiHuber(double sigma, const double *x, unsigned int n, double *w);
   //@}
 
   //! Partial derivative of loss function
@@ -196,14 +226,12 @@ public:
   //@}
 #endif
   
-  /** @name Sort function  */
+  /** @name Selection functions  */
   //@{
-  //! Swap two value
-  void exch(double &A, double &B){swap = A; A = B;  B = swap;}
-  //! Sort function using partition method
-  int partition(vpColVector &a, int l, int r);
-  //! Sort the vector and select a value in the sorted vector
-  double select(vpColVector &a, int l, int r, int k);
+  //! Select the k-th smallest value of a vector
+  double select(const double *x, unsigned int n, unsigned int k);
+  //! Select the k-th smallest value of a vector from its histogram
+  double selectFromHistogram(const double *x, unsigned int n, unsigned int k);
   //@}
 };
 
@@ -45,7 +45,7 @@
 */
 
 #include <visp3/core/vpHomogeneousMatrix.h>
-#include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpFixedArray2D.h>
 #include <visp3/core/vpRxyzVector.h>
 #include <visp3/core/vpRzyxVector.h>
 #include <visp3/core/vpRzyzVector.h>
@@ -64,10 +64,12 @@
   The vpRotationMatrix considers the particular case of
   a rotation matrix.
 
-  The vpRotationMatrix class is derived from vpArray2D<double>.
+  The vpRotationMatrix class is derived from vpFixedArray2D<double, 3, 3>, itself
+  derived from vpArray2D<double>. Its elements are stored inline so that it
+  never allocates memory.
 
 */
-class VISP_EXPORT vpRotationMatrix : public vpArray2D<double>
+class VISP_EXPORT vpRotationMatrix : public vpFixedArray2D<double, 3, 3>
 {
 public:
   vpRotationMatrix();
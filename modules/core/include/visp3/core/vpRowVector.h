@@ -94,16 +94,7 @@ public:
   */
   void clear()
   {
-    if (data != NULL ) {
-      free(data);
-      data=NULL;
-    }
-
-    if (rowPtrs!=NULL) {
-      free(rowPtrs);
-      rowPtrs=NULL ;
-    }
-    rowNum = colNum = dsize = 0;
+    releaseStorage();
   }
 
   std::ostream & cppPrint(std::ostream & os, const std::string &matrixName="A", bool octet = false) const;
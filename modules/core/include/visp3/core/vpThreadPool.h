@@ -0,0 +1,210 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Process-wide work-stealing thread pool.
+ *
+ *****************************************************************************/
+
+#ifndef __vpThreadPool_h_
+#define __vpThreadPool_h_
+
+#include <vector>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpException.h>
+
+/*!
+  \class vpThreadPool
+  \ingroup group_core_threading
+
+  \brief Pool of persistent worker threads executing tasks and parallel
+  loops, shared by the multi-threaded functions of ViSP.
+
+  The workers are created once and wait for tasks, instead of creating and
+  joining threads at each call. Each worker owns a queue of tasks: it runs
+  the tasks of its own queue and, when it is empty, steals the tasks of the
+  other queues. The thread waiting for a task group helps running the queued
+  tasks.
+
+  The pool returned by getInstance() is shared by the whole process. Its
+  number of threads, the calling thread included, is given by the
+  VISP_NUM_THREADS environment variable, or by the number of processors if
+  the variable is not set. It may be changed with setNbThreads(). With a
+  single thread, the tasks are run sequentially by the calling thread.
+
+  A parallel loop over an index range is written by deriving vpRangeTask:
+  \code
+#include <visp3/core/vpThreadPool.h>
+
+class vpSquare : public vpThreadPool::vpRangeTask
+{
+public:
+  vpSquare(std::vector<double> &v) : m_v(v) {}
+  void run(unsigned int begin, unsigned int end)
+  {
+    for (unsigned int i = begin; i < end; i++)
+      m_v[i] *= m_v[i];
+  }
+private:
+  std::vector<double> &m_v;
+};
+
+int main()
+{
+  std::vector<double> v(1000000, 2.);
+  vpSquare square(v);
+  vpThreadPool::getInstance().parallelFor(0, (unsigned int)v.size(), square);
+}
+  \endcode
+
+  Heterogeneous tasks are run with a vpTaskGroup:
+  \code
+  vpThreadPool::vpTaskGroup group;
+  group.run(task1); // task1 and task2 derive from vpThreadPool::vpTask
+  group.run(task2);
+  group.wait();
+  \endcode
+
+  An exception thrown by a task is caught and thrown again, as a
+  vpException, by vpTaskGroup::wait() or parallelFor() once all the tasks
+  are finished.
+*/
+class VISP_EXPORT vpThreadPool
+{
+public:
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  class vpImpl;
+#endif
+
+  /*!
+    \class vpTask
+    Task run by a vpTaskGroup.
+  */
+  class VISP_EXPORT vpTask
+  {
+  public:
+    virtual ~vpTask() {}
+    //! Work of the task.
+    virtual void run() = 0;
+  };
+
+  /*!
+    \class vpRangeTask
+    Body of a parallelFor() loop.
+  */
+  class VISP_EXPORT vpRangeTask
+  {
+  public:
+    virtual ~vpRangeTask() {}
+    //! Process the indexes [begin, end). Called concurrently on disjoint ranges.
+    virtual void run(unsigned int begin, unsigned int end) = 0;
+  };
+
+  /*!
+    \class vpTaskGroup
+    Set of tasks run by a pool, which completion is waited for together.
+    The tasks are not copied: they have to remain valid until wait()
+    returns. The destructor waits for the tasks still running.
+  */
+  class VISP_EXPORT vpTaskGroup
+  {
+  public:
+    explicit vpTaskGroup(vpThreadPool &pool = vpThreadPool::getInstance());
+    ~vpTaskGroup();
+
+    void run(vpTask &task);
+    void wait();
+
+  private:
+    vpTaskGroup(const vpTaskGroup &);
+    vpTaskGroup &operator=(const vpTaskGroup &);
+
+    friend class vpThreadPool::vpImpl;
+    vpThreadPool &m_pool;
+    //! Tasks queued or running, protected by the lock of the pool
+    unsigned int m_remaining;
+    bool m_failed;
+    vpException m_exception;
+  };
+
+  explicit vpThreadPool(unsigned int nbThreads = 0);
+  virtual ~vpThreadPool();
+
+  static vpThreadPool &getInstance();
+  static unsigned int getDefaultNbThreads();
+
+  unsigned int getNbThreads() const;
+  void setNbThreads(unsigned int nbThreads);
+
+  void parallelFor(unsigned int begin, unsigned int end, vpRangeTask &body,
+                   unsigned int grain = 0, unsigned int maxThreads = 0);
+
+  /*!
+    Call the run() function of all the \e jobs in parallel and wait for
+    them. This is the executor of the jobs of the image processing
+    functions, that process a band of an image in their run() function.
+  */
+  template<typename Job>
+  void run(std::vector<Job> &jobs)
+  {
+    if (getNbThreads() <= 1 || jobs.size() <= 1) {
+      for (size_t i = 0; i < jobs.size(); i++)
+        jobs[i].run();
+      return;
+    }
+    std::vector<vpJobTask<Job> > tasks(jobs.size());
+    vpTaskGroup group(*this);
+    for (size_t i = 0; i < jobs.size(); i++) {
+      tasks[i].job = &jobs[i];
+      group.run(tasks[i]);
+    }
+    group.wait();
+  }
+
+private:
+  vpThreadPool(const vpThreadPool &);
+  vpThreadPool &operator=(const vpThreadPool &);
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  template<typename Job>
+  class vpJobTask : public vpTask
+  {
+  public:
+    vpJobTask() : job(NULL) {}
+    void run() { job->run(); }
+    Job *job;
+  };
+#endif
+
+  friend class vpTaskGroup;
+  vpImpl *m_impl;
+};
+
+#endif
@@ -46,7 +46,7 @@
   \brief Class that consider the case of a translation vector.
 */
 
-#include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpFixedArray2D.h>
 #include <visp3/core/vpMatrix.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
 #include <visp3/core/vpPoseVector.h>
@@ -90,7 +90,7 @@ int main()
 }
   \endcode
 */
-class VISP_EXPORT vpTranslationVector : public vpArray2D<double>
+class VISP_EXPORT vpTranslationVector : public vpFixedArray2D<double, 3, 1>
 {
 public:
 
@@ -98,7 +98,7 @@ public:
       Default constructor.
       The translation vector is initialized to zero.
     */
-  vpTranslationVector() : vpArray2D<double>(3, 1) {};
+  vpTranslationVector() : vpFixedArray2D<double, 3, 1>() {};
   vpTranslationVector(const double tx, const double ty, const double tz) ;
   vpTranslationVector(const vpTranslationVector &tv);
   vpTranslationVector(const vpHomogeneousMatrix &M);
@@ -0,0 +1,122 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Precomputed remap of the pixels of an image to undistort it.
+ *
+ *****************************************************************************/
+
+#ifndef __vpUndistortionMap_h_
+#define __vpUndistortionMap_h_
+
+#include <vector>
+
+#include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpCameraParameters.h>
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpImage.h>
+#include <visp3/core/vpRGBa.h>
+
+/*!
+  \class vpUndistortionMap
+  \ingroup group_core_image
+
+  \brief Map giving, for each pixel of an undistorted image, its position in
+  the distorted image, computed once from the camera parameters.
+
+  vpImageTools::undistort() evaluates the distortion model for each pixel at
+  each call. When the camera parameters don't change, build() stores the
+  source position of each pixel once, as 16 bits integer coordinates and
+  fractional parts on interpolationBits bits. remap() then only gathers the
+  4 neighbours of each position and interpolates them in fixed point, with
+  SSE2 when available, over several threads.
+
+  The map can also include a homography applied to the pixels before the
+  distortion, which rectifies and/or resizes the image in the same pass:
+
+  \code
+#include <visp3/core/vpUndistortionMap.h>
+
+int main()
+{
+  vpCameraParameters cam(600, 600, 320, 240, -0.2, 0.2);
+  vpImage<unsigned char> I(480, 640), Iu, Ihalf;
+  vpUndistortionMap map(cam, I.getHeight(), I.getWidth());
+  vpUndistortionMap half;
+  half.build(cam, I.getHeight(), I.getWidth(), 240, 320); // Undistort and resize
+  for (;;) { // For each frame
+    // Acquire I
+    map.remap(I, Iu, 2);
+    half.remap(I, Ihalf, 2);
+  }
+}
+  \endcode
+
+  The pixels which source position is outside the image, or on its last row
+  or column, are set to 0 as done by vpImageTools::undistort().
+*/
+class VISP_EXPORT vpUndistortionMap
+{
+public:
+  //! Number of bits of the fractional part of the source positions.
+  static const unsigned int interpolationBits = 7;
+
+  vpUndistortionMap();
+  vpUndistortionMap(const vpCameraParameters &cam, unsigned int height, unsigned int width);
+
+  void build(const vpCameraParameters &cam, unsigned int height, unsigned int width);
+  void build(const vpCameraParameters &cam, unsigned int height, unsigned int width,
+             unsigned int dstHeight, unsigned int dstWidth);
+  void build(const vpCameraParameters &cam, unsigned int height, unsigned int width,
+             const vpArray2D<double> &H, unsigned int dstHeight, unsigned int dstWidth);
+
+  //! Return the height of the remapped images.
+  inline unsigned int getHeight() const { return m_height; }
+  //! Return the width of the remapped images.
+  inline unsigned int getWidth() const { return m_width; }
+  //! Return the height of the images accepted by remap().
+  inline unsigned int getSourceHeight() const { return m_srcHeight; }
+  //! Return the width of the images accepted by remap().
+  inline unsigned int getSourceWidth() const { return m_srcWidth; }
+
+  void remap(const vpImage<unsigned char> &I, vpImage<unsigned char> &Iout, unsigned int nbThreads = 1) const;
+  void remap(const vpImage<vpRGBa> &I, vpImage<vpRGBa> &Iout, unsigned int nbThreads = 1) const;
+
+private:
+  unsigned int m_height;
+  unsigned int m_width;
+  unsigned int m_srcHeight;
+  unsigned int m_srcWidth;
+  //! Column and row of the top left neighbour of each pixel, -1 outside the source image
+  std::vector<short> m_coords;
+  //! Fractional parts of the column and row of each pixel
+  std::vector<unsigned char> m_fractions;
+};
+
+#endif
@@ -39,7 +39,7 @@
 #ifndef vpVelocityRwistMatrix_h
 #define vpVelocityRwistMatrix_h
 
-#include <visp3/core/vpArray2D.h>
+#include <visp3/core/vpFixedArray2D.h>
 #include <visp3/core/vpMatrix.h>
 #include <visp3/core/vpColVector.h>
 #include <visp3/core/vpHomogeneousMatrix.h>
@@ -59,7 +59,9 @@ class vpColVector;
   transformation matrix that allows to transform a velocity skew from
   one frame to an other.
 
-  The vpVelocityTwistMatrix class is derived from vpArray2D<double>.
+  The vpVelocityTwistMatrix class is derived from vpFixedArray2D<double, 6, 6>, itself
+  derived from vpArray2D<double>. Its elements are stored inline so that it
+  never allocates memory.
 
   A twist transformation matrix is a 6x6 matrix that express a velocity in frame <em>a</em> knowing
   velocity in <em>b</em>. This matrix is defined as:
@@ -74,7 +76,7 @@ class vpColVector;
   where \f$ ^a{\bf R}_b \f$ is a rotation matrix and
   \f$ ^a{\bf t}_b \f$ is a translation vector.
 
-  The vpVelocityTwistMatrix is derived from vpArray2D.
+  The vpVelocityTwistMatrix is derived from vpFixedArray2D.
 
   The code belows shows for example how to convert a velocity skew
   from camera frame to a fix frame.
@@ -102,7 +104,7 @@ int main()
 }
   \endcode
 */
-class VISP_EXPORT vpVelocityTwistMatrix : public vpArray2D<double>
+class VISP_EXPORT vpVelocityTwistMatrix : public vpFixedArray2D<double, 6, 6>
 {
   friend class vpMatrix;
 
@@ -45,9 +45,11 @@
 
 #include <sstream>
 #include <map>
+#include <vector>
 
 // image
 #include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpThreadPool.h>
 
 #if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
 #  include <emmintrin.h>
@@ -63,6 +65,14 @@
 #  endif
 #endif
 
+// AVX2 kernels compiled with a function level target attribute and selected
+// at runtime, so that the library does not need to be built with -mavx2
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    ((defined(__GNUC__) && (__GNUC__ >= 5)) || defined(__clang__))
+#  include <immintrin.h>
+#  define VISP_HAVE_AVX2_DISPATCH 1
+#endif
+
 
 bool vpImageConvert::YCbCrLUTcomputed = false;
 int vpImageConvert::vpCrr[256];
@@ -1172,60 +1182,569 @@ void vpImageConvert::convert(const yarp::sig::ImageOf< yarp::sig::PixelRgb > *sr
 
 #define vpSAT(c) \
         if (c & (~255)) { if (c < 0) c = 0; else c = 255; }
-/*!
-  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...) to RGB32.
-  Destination rgba memory area has to be allocated before.
 
-  \sa YUV422ToRGBa()
-*/
-void vpImageConvert::YUYVToRGBa(unsigned char* yuyv, unsigned char* rgba,
-                                unsigned int width, unsigned int height)
-{
-  unsigned char *s;
-  unsigned char *d;
-  int w, h;
-  int r, g, b, cr, cg, cb, y1, y2;
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  /*
+    Run a job, that converts the items [begin, end) in its run() function, on
+    nbThreads chunks of the n items run by the thread pool. Each chunk, except the last
+    one, holds a multiple of granularity items so that the pixels processed by
+    the SIMD and the scalar code don't depend on the number of threads.
+  */
+  template<typename Job>
+  void runInChunks(const Job &job, unsigned int n, unsigned int granularity, unsigned int nbThreads)
+  {
+    unsigned int nbBlocks = (n + granularity - 1) / granularity;
+    if (nbThreads > nbBlocks)
+      nbThreads = nbBlocks;
+
+    if (nbThreads <= 1) {
+      Job chunk(job);
+      chunk.begin = 0;
+      chunk.end = n;
+      chunk.run();
+      return;
+    }
 
-  h = (int)height;
-  w = (int)width;
-  s = yuyv;
-  d = rgba;
-  while (h--) {
-    int c = w >> 1;
-    while (c--) {
-      y1 = *s++;
-      cb = ((*s - 128) * 454) >> 8;
-      cg = (*s++ - 128) * 88;
-      y2 = *s++;
-      cr = ((*s - 128) * 359) >> 8;
-      cg = (cg + (*s++ - 128) * 183) >> 8;
+    std::vector<Job> chunks(nbThreads, job);
+    for (unsigned int i = 0; i < nbThreads; i++) {
+      chunks[i].begin = (unsigned int)(((size_t)nbBlocks * i) / nbThreads) * granularity;
+      chunks[i].end = (i + 1 == nbThreads) ? n : (unsigned int)(((size_t)nbBlocks * (i+1)) / nbThreads) * granularity;
+    }
+    vpThreadPool::getInstance().run(chunks);
+  }
 
-      r = y1 + cr;
-      b = y1 + cb;
-      g = y1 - cg;
-      vpSAT(r);
-      vpSAT(g);
-      vpSAT(b);
+  // Number of pixels converted at once by the SIMD RGB to grey code
+  const unsigned int greyBlockSize = 16;
 
-      *d++ = static_cast<unsigned char>(r);
-      *d++ = static_cast<unsigned char>(g);
-      *d++ = static_cast<unsigned char>(b);
-      *d++ = 0;
+#if VISP_HAVE_SSE2 && VISP_HAVE_AVX2_DISPATCH
+  bool vpSelectAVX2()
+  {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+  }
 
-      r = y2 + cr;
-      b = y2 + cb;
-      g = y2 - cg;
-      vpSAT(r);
-      vpSAT(g);
-      vpSAT(b);
+  bool vpHasAVX2()
+  {
+    static bool avx2 = vpSelectAVX2();
+    return avx2;
+  }
+#endif
 
-      *d++ = static_cast<unsigned char>(r);
-      *d++ = static_cast<unsigned char>(g);
-      *d++ = static_cast<unsigned char>(b);
-      *d++ = 0;
+#if VISP_HAVE_SSSE3 && VISP_HAVE_AVX2_DISPATCH
+  /*
+    Convert the blocks of 32 pixels among the n first pixels of an RGBa (or
+    BGRa) image into grey, with the fixed-point weights of the SSSE3 code.
+    Returns the number of converted pixels.
+  */
+  __attribute__((target("avx2")))
+  unsigned int vpRGBaToGreyAVX2(const unsigned char *s, unsigned char *d, unsigned int n, bool bgr)
+  {
+    const __m256i lowByte = _mm256_set1_epi32(0xff);
+    const __m256i coeff_R = _mm256_set1_epi16(13933);
+    const __m256i coeff_G = _mm256_set1_epi16((short int)46871);
+    const __m256i coeff_B = _mm256_set1_epi16(4732);
+    // Restores the pixel order after the in-lane packs
+    const __m256i order = _mm256_set_epi32(7, 3, 6, 2, 5, 1, 4, 0);
+    const unsigned int shiftR = bgr ? 16 : 0;
+    const unsigned int shiftB = bgr ? 0 : 16;
+
+    unsigned int i = 0;
+    for (; i + 2 * greyBlockSize <= n; i += 2 * greyBlockSize) {
+      __m256i grays[2];
+      for (unsigned int k = 0; k < 2; k++) {
+        const __m256i a = _mm256_loadu_si256((const __m256i *)(s + 64 * k));
+        const __m256i b = _mm256_loadu_si256((const __m256i *)(s + 64 * k + 32));
+        // Channels as 16 bits values v << 8, as selected by the SSSE3 masks
+        const __m256i red = _mm256_slli_epi16(
+              _mm256_packus_epi32(_mm256_and_si256(_mm256_srli_epi32(a, shiftR), lowByte),
+                                  _mm256_and_si256(_mm256_srli_epi32(b, shiftR), lowByte)), 8);
+        const __m256i green = _mm256_slli_epi16(
+              _mm256_packus_epi32(_mm256_and_si256(_mm256_srli_epi32(a, 8), lowByte),
+                                  _mm256_and_si256(_mm256_srli_epi32(b, 8), lowByte)), 8);
+        const __m256i blue = _mm256_slli_epi16(
+              _mm256_packus_epi32(_mm256_and_si256(_mm256_srli_epi32(a, shiftB), lowByte),
+                                  _mm256_and_si256(_mm256_srli_epi32(b, shiftB), lowByte)), 8);
+        grays[k] = _mm256_srli_epi16(_mm256_adds_epu16(_mm256_mulhi_epu16(red, coeff_R),
+                                                       _mm256_adds_epu16(_mm256_mulhi_epu16(green, coeff_G),
+                                                                         _mm256_mulhi_epu16(blue, coeff_B))), 8);
+      }
+      _mm256_storeu_si256((__m256i *)d,
+                          _mm256_permutevar8x32_epi32(_mm256_packus_epi16(grays[0], grays[1]), order));
+      s += 8 * greyBlockSize;
+      d += 2 * greyBlockSize;
+    }
+    return i;
+  }
+#endif
+
+  /*
+    Convert the pixels [begin, end) of an RGB, BGR or RGBa image into grey.
+    The blocks of 16 pixels use the SSSE3 fixed-point weights, the remaining
+    pixels the floating point ones, as done since ViSP 3.0.
+  */
+  template<unsigned int step, bool bgr>
+  struct vpGreyConversion
+  {
+    vpGreyConversion() : src(NULL), dst(NULL), begin(0), end(0) {}
+
+    const unsigned char *src;
+    unsigned char *dst;
+    unsigned int begin;
+    unsigned int end;
+
+    void run()
+    {
+      const unsigned char *s = src + (size_t)begin * step;
+      unsigned char *d = dst + begin;
+      unsigned int i = begin;
+#if VISP_HAVE_SSSE3
+      // Masks that select the channel 0, 1 and 2 of 8 pixels as 16 bits values
+      __m128i mask0[4], mask1[4], mask2[4];
+      if (step == 3) {
+        mask0[0] = _mm_set_epi8(-1, -1, -1, -1, 15, -1, 12, -1, 9, -1, 6, -1, 3, -1, 0, -1);
+        mask0[1] = _mm_set_epi8(5, -1, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        mask0[2] = _mm_set_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 14, -1, 11, -1, 8, -1);
+        mask0[3] = _mm_set_epi8(13, -1, 10, -1, 7, -1, 4, -1, 1, -1, -1, -1, -1, -1, -1, -1);
+        mask1[0] = _mm_set_epi8(-1, -1, -1, -1, -1, -1, 13, -1, 10, -1, 7, -1, 4, -1, 1, -1);
+        mask1[1] = _mm_set_epi8(6, -1, 3, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        mask1[2] = _mm_set_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 15, -1, 12, -1, 9, -1);
+        mask1[3] = _mm_set_epi8(14, -1, 11, -1, 8, -1, 5, -1, 2, -1, -1, -1, -1, -1, -1, -1);
+        mask2[0] = _mm_set_epi8(-1, -1, -1, -1, -1, -1, 14, -1, 11, -1, 8, -1, 5, -1, 2, -1);
+        mask2[1] = _mm_set_epi8(7, -1, 4, -1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        mask2[2] = _mm_set_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 13, -1, 10, -1);
+        mask2[3] = _mm_set_epi8(15, -1, 12, -1, 9, -1, 6, -1, 3, -1, 0, -1, -1, -1, -1, -1);
+      }
+      else {
+        mask0[0] = mask0[2] = _mm_set_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 12, -1, 8, -1, 4, -1, 0, -1);
+        mask0[1] = mask0[3] = _mm_set_epi8(12, -1, 8, -1, 4, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        mask1[0] = mask1[2] = _mm_set_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 13, -1, 9, -1, 5, -1, 1, -1);
+        mask1[1] = mask1[3] = _mm_set_epi8(13, -1, 9, -1, 5, -1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+        mask2[0] = mask2[2] = _mm_set_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 14, -1, 10, -1, 6, -1, 2, -1);
+        mask2[1] = mask2[3] = _mm_set_epi8(14, -1, 10, -1, 6, -1, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+      }
+      const __m128i mask_low1 = _mm_set_epi8(-1, -1, -1, -1, -1, -1, -1, -1, 15, 13, 11, 9, 7, 5, 3, 1);
+      const __m128i mask_low2 = _mm_set_epi8(15, 13, 11, 9, 7, 5, 3, 1, -1, -1, -1, -1, -1, -1, -1, -1);
+      const __m128i coeff_R = _mm_set1_epi16(13933);
+      const __m128i coeff_G = _mm_set1_epi16((short int)46871);
+      const __m128i coeff_B = _mm_set1_epi16(4732);
+
+#if VISP_HAVE_AVX2_DISPATCH
+      if (step == 4 && vpHasAVX2()) {
+        const unsigned int n = vpRGBaToGreyAVX2(s, d, end - i, bgr);
+        i += n;
+        s += (size_t)n * step;
+        d += n;
+      }
+#endif
+      for (; i + greyBlockSize <= end; i += greyBlockSize) {
+        // The 8 first pixels lie in the 2 first vectors, the 8 next in the vectors 2 and 3 (RGB) or 3 and 4 (RGBa)
+        __m128i data[4];
+        data[0] = _mm_loadu_si128((const __m128i *)s);
+        data[1] = _mm_loadu_si128((const __m128i *)(s + 16));
+        data[2] = _mm_loadu_si128((const __m128i *)(s + 32));
+        if (step == 4)
+          data[3] = _mm_loadu_si128((const __m128i *)(s + 48));
+        __m128i grays[2];
+        for (unsigned int k = 0; k < 2; k++) {
+          const __m128i &a = (step == 3) ? data[k] : data[2*k];
+          const __m128i &b = (step == 3) ? data[k+1] : data[2*k+1];
+          const __m128i c0 = _mm_or_si128(_mm_shuffle_epi8(a, mask0[2*k]), _mm_shuffle_epi8(b, mask0[2*k+1]));
+          const __m128i c1 = _mm_or_si128(_mm_shuffle_epi8(a, mask1[2*k]), _mm_shuffle_epi8(b, mask1[2*k+1]));
+          const __m128i c2 = _mm_or_si128(_mm_shuffle_epi8(a, mask2[2*k]), _mm_shuffle_epi8(b, mask2[2*k+1]));
+          const __m128i red = bgr ? c2 : c0;
+          const __m128i blue = bgr ? c0 : c2;
+          grays[k] = _mm_adds_epu16(_mm_mulhi_epu16(red, coeff_R),
+                                    _mm_adds_epu16(_mm_mulhi_epu16(c1, coeff_G), _mm_mulhi_epu16(blue, coeff_B)));
+        }
+        _mm_storeu_si128((__m128i *)d, _mm_or_si128(_mm_shuffle_epi8(grays[0], mask_low1),
+                                                     _mm_shuffle_epi8(grays[1], mask_low2)));
+        s += greyBlockSize * step;
+        d += greyBlockSize;
+      }
+#endif
+      for (; i < end; i++) {
+        *d++ = (unsigned char)(0.2126 * s[bgr ? 2 : 0] + 0.7152 * s[1] + 0.0722 * s[bgr ? 0 : 2]);
+        s += step;
+      }
+    }
+  };
+
+  /*
+    Convert the rows [begin, end) of an RGB or BGR image into grey, the first
+    row of the source image being the last row of the destination one.
+  */
+  template<bool bgr>
+  struct vpGreyFlipConversion
+  {
+    vpGreyFlipConversion() : src(NULL), dst(NULL), width(0), height(0), begin(0), end(0) {}
+
+    const unsigned char *src;
+    unsigned char *dst;
+    unsigned int width;
+    unsigned int height;
+    unsigned int begin;
+    unsigned int end;
+
+    void run()
+    {
+      vpGreyConversion<3, bgr> row;
+      row.begin = 0;
+      row.end = width;
+      for (unsigned int i = begin; i < end; i++) {
+        row.src = src + (size_t)(height - 1 - i) * width * 3;
+        row.dst = dst + (size_t)i * width;
+        row.run();
+      }
+    }
+  };
+
+  /*
+    Convert the rows [begin, end) of a view on an RGBa image into grey.
+  */
+  struct vpGreyViewConversion
+  {
+    vpGreyViewConversion() : src(), dst(NULL), begin(0), end(0) {}
+
+    vpImageView<vpRGBa> src;
+    vpImage<unsigned char> *dst;
+    unsigned int begin;
+    unsigned int end;
 
+    void run()
+    {
+      vpGreyConversion<4, false> row;
+      row.begin = 0;
+      row.end = src.getWidth();
+      for (unsigned int i = begin; i < end; i++) {
+        row.src = (const unsigned char *)src[i];
+        row.dst = (*dst)[i];
+        row.run();
+      }
     }
+  };
+
+#if VISP_HAVE_SSE2
+  /*
+    Saturate the 16 bits R, G, B values of 8 pixels and store them as RGBa
+    with a null alpha channel.
+  */
+  inline void storeRGBa(unsigned char *d, const __m128i &r, const __m128i &g, const __m128i &b)
+  {
+    const __m128i rg = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), _mm_packus_epi16(g, g));
+    const __m128i b0 = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), _mm_setzero_si128());
+    _mm_storeu_si128((__m128i *)d, _mm_unpacklo_epi16(rg, b0));
+    _mm_storeu_si128((__m128i *)(d + 16), _mm_unpackhi_epi16(rg, b0));
   }
+#endif
+
+#if VISP_HAVE_SSE2 && VISP_HAVE_AVX2_DISPATCH
+  /*
+    Convert the blocks of 8 pixel pairs among the n first pairs of a YUYV
+    image into RGBa, with the integer arithmetic of the SSE2 code. Returns
+    the number of converted pairs.
+  */
+  __attribute__((target("avx2")))
+  unsigned int vpYUYVToRGBaAVX2(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    const __m256i lowByte = _mm256_set1_epi16(0xff);
+    const __m256i offset = _mm256_set1_epi16(128);
+    const __m256i coeffB = _mm256_set1_epi32(454);
+    const __m256i coeffG = _mm256_set1_epi32((183 << 16) | 88);
+    const __m256i coeffR = _mm256_set1_epi32(359 << 16);
+    const __m256i zero = _mm256_setzero_si256();
+
+    unsigned int c = 0;
+    for (; c + 8 <= n; c += 8) {
+      // Same as the SSE2 code on each 128 bits lane
+      const __m256i data = _mm256_loadu_si256((const __m256i *)s);
+      const __m256i y = _mm256_and_si256(data, lowByte);
+      const __m256i uv = _mm256_sub_epi16(_mm256_srli_epi16(data, 8), offset);
+      __m256i cb = _mm256_srai_epi32(_mm256_madd_epi16(uv, coeffB), 8);
+      __m256i cg = _mm256_srai_epi32(_mm256_madd_epi16(uv, coeffG), 8);
+      __m256i cr = _mm256_srai_epi32(_mm256_madd_epi16(uv, coeffR), 8);
+      cb = _mm256_packs_epi32(cb, cb);
+      cg = _mm256_packs_epi32(cg, cg);
+      cr = _mm256_packs_epi32(cr, cr);
+      const __m256i r = _mm256_add_epi16(y, _mm256_unpacklo_epi16(cr, cr));
+      const __m256i g = _mm256_sub_epi16(y, _mm256_unpacklo_epi16(cg, cg));
+      const __m256i b = _mm256_add_epi16(y, _mm256_unpacklo_epi16(cb, cb));
+
+      const __m256i rg = _mm256_unpacklo_epi8(_mm256_packus_epi16(r, r), _mm256_packus_epi16(g, g));
+      const __m256i b0 = _mm256_unpacklo_epi8(_mm256_packus_epi16(b, b), zero);
+      // Pixels 0-3 and 8-11, then 4-7 and 12-15
+      const __m256i lo = _mm256_unpacklo_epi16(rg, b0);
+      const __m256i hi = _mm256_unpackhi_epi16(rg, b0);
+      _mm256_storeu_si256((__m256i *)d, _mm256_permute2x128_si256(lo, hi, 0x20));
+      _mm256_storeu_si256((__m256i *)(d + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+      s += 32;
+      d += 64;
+    }
+    return c;
+  }
+
+  /*
+    Extract the luminance of the blocks of 16 pixel pairs among the n first
+    pairs of a YUV 4:2:2 image. Returns the number of converted pairs.
+  */
+  __attribute__((target("avx2")))
+  unsigned int vpYUV422ToGreyAVX2(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    unsigned int c = 0;
+    for (; c + 16 <= n; c += 16) {
+      const __m256i a = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i *)s), 8);
+      const __m256i b = _mm256_srli_epi16(_mm256_loadu_si256((const __m256i *)(s + 32)), 8);
+      // The in-lane pack gives the pixels 0-7, 16-23, 8-15, 24-31
+      _mm256_storeu_si256((__m256i *)d, _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), 0xD8));
+      s += 64;
+      d += 32;
+    }
+    return c;
+  }
+#endif
+
+  /*
+    Convert the pixel pairs [begin, end) of a YUYV image into RGBa with the
+    integer arithmetic of vpImageConvert::YUYVToRGBa().
+  */
+  struct vpYUYVToRGBaConversion
+  {
+    vpYUYVToRGBaConversion() : src(NULL), dst(NULL), begin(0), end(0) {}
+
+    const unsigned char *src;
+    unsigned char *dst;
+    unsigned int begin;
+    unsigned int end;
+
+    void run()
+    {
+      const unsigned char *s = src + (size_t)begin * 4;
+      unsigned char *d = dst + (size_t)begin * 8;
+      unsigned int c = begin;
+#if VISP_HAVE_SSE2
+      const __m128i lowByte = _mm_set1_epi16(0xff);
+      const __m128i offset = _mm_set1_epi16(128);
+      // Weights of the (u, v) pairs
+      const __m128i coeffB = _mm_set_epi16(0, 454, 0, 454, 0, 454, 0, 454);
+      const __m128i coeffG = _mm_set_epi16(183, 88, 183, 88, 183, 88, 183, 88);
+      const __m128i coeffR = _mm_set_epi16(359, 0, 359, 0, 359, 0, 359, 0);
+#if VISP_HAVE_AVX2_DISPATCH
+      if (vpHasAVX2()) {
+        const unsigned int n = vpYUYVToRGBaAVX2(s, d, end - c);
+        c += n;
+        s += (size_t)n * 4;
+        d += (size_t)n * 8;
+      }
+#endif
+      for (; c + 4 <= end; c += 4) {
+        // 8 pixels read as the 16 bits words y0 | u01 << 8, y1 | v01 << 8, ...
+        const __m128i data = _mm_loadu_si128((const __m128i *)s);
+        const __m128i y = _mm_and_si128(data, lowByte);
+        const __m128i uv = _mm_sub_epi16(_mm_srli_epi16(data, 8), offset);
+        // One value per pair, then duplicated for the 2 pixels of the pair
+        __m128i cb = _mm_srai_epi32(_mm_madd_epi16(uv, coeffB), 8);
+        __m128i cg = _mm_srai_epi32(_mm_madd_epi16(uv, coeffG), 8);
+        __m128i cr = _mm_srai_epi32(_mm_madd_epi16(uv, coeffR), 8);
+        cb = _mm_packs_epi32(cb, cb);
+        cg = _mm_packs_epi32(cg, cg);
+        cr = _mm_packs_epi32(cr, cr);
+        storeRGBa(d, _mm_add_epi16(y, _mm_unpacklo_epi16(cr, cr)), _mm_sub_epi16(y, _mm_unpacklo_epi16(cg, cg)),
+                  _mm_add_epi16(y, _mm_unpacklo_epi16(cb, cb)));
+        s += 16;
+        d += 32;
+      }
+#endif
+      for (; c < end; c++) {
+        int y1 = *s++;
+        int cb = ((*s - 128) * 454) >> 8;
+        int cg = (*s++ - 128) * 88;
+        int y2 = *s++;
+        int cr = ((*s - 128) * 359) >> 8;
+        cg = (cg + (*s++ - 128) * 183) >> 8;
+
+        int r = y1 + cr, g = y1 - cg, b = y1 + cb;
+        vpSAT(r);
+        vpSAT(g);
+        vpSAT(b);
+        *d++ = static_cast<unsigned char>(r);
+        *d++ = static_cast<unsigned char>(g);
+        *d++ = static_cast<unsigned char>(b);
+        *d++ = 0;
+
+        r = y2 + cr;
+        g = y2 - cg;
+        b = y2 + cb;
+        vpSAT(r);
+        vpSAT(g);
+        vpSAT(b);
+        *d++ = static_cast<unsigned char>(r);
+        *d++ = static_cast<unsigned char>(g);
+        *d++ = static_cast<unsigned char>(b);
+        *d++ = 0;
+      }
+    }
+  };
+
+  /*
+    Extract the luminance of the pixel pairs [begin, end) of a YUV 4:2:2
+    (u01 y0 v01 y1 ...) image.
+  */
+  struct vpYUV422ToGreyConversion
+  {
+    vpYUV422ToGreyConversion() : src(NULL), dst(NULL), begin(0), end(0) {}
+
+    const unsigned char *src;
+    unsigned char *dst;
+    unsigned int begin;
+    unsigned int end;
+
+    void run()
+    {
+      const unsigned char *s = src + (size_t)begin * 4;
+      unsigned char *d = dst + (size_t)begin * 2;
+      unsigned int c = begin;
+#if VISP_HAVE_SSE2
+#if VISP_HAVE_AVX2_DISPATCH
+      if (vpHasAVX2()) {
+        const unsigned int n = vpYUV422ToGreyAVX2(s, d, end - c);
+        c += n;
+        s += (size_t)n * 4;
+        d += (size_t)n * 2;
+      }
+#endif
+      for (; c + 8 <= end; c += 8) {
+        const __m128i a = _mm_srli_epi16(_mm_loadu_si128((const __m128i *)s), 8);
+        const __m128i b = _mm_srli_epi16(_mm_loadu_si128((const __m128i *)(s + 16)), 8);
+        _mm_storeu_si128((__m128i *)d, _mm_packus_epi16(a, b));
+        s += 32;
+        d += 16;
+      }
+#endif
+      for (; c < end; c++) {
+        *d++ = s[1];
+        *d++ = s[3];
+        s += 4;
+      }
+    }
+  };
+
+  inline void setYUV420Pixel(int Y, int V2, int UV, int U5, unsigned char *d)
+  {
+    int R = Y + V2;
+    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
+    int G = Y + UV;
+    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
+    int B = Y + U5;
+    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
+    d[0] = (unsigned char)R;
+    d[1] = (unsigned char)G;
+    d[2] = (unsigned char)B;
+    d[3] = 0;
+  }
+
+#if VISP_HAVE_SSE2
+  /*
+    Return (int)(x * k / 65536.) for 16 bits signed values x, the product
+    being truncated toward zero. With k = 23200 and 46334, this gives the
+    same values than (int)(x * 0.354) and (int)(x * 0.707) for x in
+    [-128, 127].
+  */
+  inline __m128i mulTruncate(const __m128i &x, const __m128i &k)
+  {
+    const __m128i sign = _mm_srai_epi16(x, 15);
+    const __m128i q = _mm_mulhi_epu16(_mm_sub_epi16(_mm_xor_si128(x, sign), sign), k);
+    return _mm_sub_epi16(_mm_xor_si128(q, sign), sign);
+  }
+#endif
+
+  /*
+    Convert the pairs of rows [begin, end) of a YUV 4:2:0 image into RGBa
+    with the arithmetic of vpImageConvert::YUV420ToRGBa().
+  */
+  struct vpYUV420ToRGBaConversion
+  {
+    vpYUV420ToRGBaConversion() : src(NULL), dst(NULL), width(0), height(0), begin(0), end(0) {}
+
+    const unsigned char *src;
+    unsigned char *dst;
+    unsigned int width;
+    unsigned int height;
+    unsigned int begin;
+    unsigned int end;
+
+    void run()
+    {
+      const unsigned int size = width * height;
+      const unsigned int halfWidth = width / 2;
+#if VISP_HAVE_SSE2
+      const __m128i offset = _mm_set1_epi16(128);
+      const __m128i coeffU = _mm_set1_epi16(23200);
+      const __m128i coeffV = _mm_set1_epi16((short int)46334);
+      const __m128i zero = _mm_setzero_si128();
+#endif
+      for (unsigned int i = begin; i < end; i++) {
+        const unsigned char *y0 = src + (size_t)2 * i * width;
+        const unsigned char *y1 = y0 + width;
+        const unsigned char *iU = src + size + (size_t)i * halfWidth;
+        const unsigned char *iV = src + 5 * size / 4 + (size_t)i * halfWidth;
+        unsigned char *d0 = dst + (size_t)8 * i * width;
+        unsigned char *d1 = d0 + 4 * width;
+        unsigned int j = 0;
+#if VISP_HAVE_SSE2
+        for (; j + 8 <= halfWidth; j += 8) {
+          const __m128i U = mulTruncate(_mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(iU + j)), zero), offset), coeffU);
+          const __m128i V = mulTruncate(_mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(iV + j)), zero), offset), coeffV);
+          const __m128i U5 = _mm_add_epi16(_mm_slli_epi16(U, 2), U);
+          const __m128i V2 = _mm_add_epi16(V, V);
+          const __m128i UV = _mm_sub_epi16(_mm_sub_epi16(zero, U), V);
+          // Chroma values of the 16 pixels of the block
+          const __m128i V2s[2] = { _mm_unpacklo_epi16(V2, V2), _mm_unpackhi_epi16(V2, V2) };
+          const __m128i UVs[2] = { _mm_unpacklo_epi16(UV, UV), _mm_unpackhi_epi16(UV, UV) };
+          const __m128i U5s[2] = { _mm_unpacklo_epi16(U5, U5), _mm_unpackhi_epi16(U5, U5) };
+          const unsigned char *ys[2] = { y0 + 2 * j, y1 + 2 * j };
+          unsigned char *ds[2] = { d0 + 8 * j, d1 + 8 * j };
+          for (unsigned int r = 0; r < 2; r++) {
+            const __m128i Y = _mm_loadu_si128((const __m128i *)ys[r]);
+            const __m128i Ys[2] = { _mm_unpacklo_epi8(Y, zero), _mm_unpackhi_epi8(Y, zero) };
+            for (unsigned int k = 0; k < 2; k++)
+              storeRGBa(ds[r] + 32 * k, _mm_add_epi16(Ys[k], V2s[k]), _mm_add_epi16(Ys[k], UVs[k]),
+                        _mm_add_epi16(Ys[k], U5s[k]));
+          }
+        }
+#endif
+        for (; j < halfWidth; j++) {
+          int U = (int)((iU[j] - 128) * 0.354);
+          int U5 = 5 * U;
+          int V = (int)((iV[j] - 128) * 0.707);
+          int V2 = 2 * V;
+          int UV = - U - V;
+          setYUV420Pixel(y0[2*j], V2, UV, U5, d0 + 8 * j);
+          setYUV420Pixel(y0[2*j+1], V2, UV, U5, d0 + 8 * j + 4);
+          setYUV420Pixel(y1[2*j], V2, UV, U5, d1 + 8 * j);
+          setYUV420Pixel(y1[2*j+1], V2, UV, U5, d1 + 8 * j + 4);
+        }
+      }
+    }
+  };
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+/*!
+  Convert an image from YUYV 4:2:2 (y0 u01 y1 v01 y2 u23 y3 v23 ...) to RGB32.
+  Destination rgba memory area has to be allocated before.
+
+  The image is converted by blocks of 8 pixels with SSE2 when available.
+  \e nbThreads threads convert each a part of the image.
+
+  \sa YUV422ToRGBa()
+*/
+void vpImageConvert::YUYVToRGBa(unsigned char* yuyv, unsigned char* rgba,
+                                unsigned int width, unsigned int height,
+                                unsigned int nbThreads)
+{
+  vpYUYVToRGBaConversion job;
+  job.src = yuyv;
+  job.dst = rgba;
+  runInChunks(job, (width >> 1) * height, 1, nbThreads);
 }
 /*!
 
@@ -1606,20 +2125,18 @@ void vpImageConvert::YUV422ToRGB(unsigned char* yuv, unsigned char* rgb, unsigne
 
   Convert YUV 4:2:2 (u01 y0 v01 y1 u23 y2 v23 y3 ...) images into Grey.
   Destination grey memory area has to be allocated before.
+  \e nbThreads threads convert each a part of the image.
 
   \sa YUYVToGrey()
 
 */
-void vpImageConvert::YUV422ToGrey(unsigned char* yuv, unsigned char* grey, unsigned int size)
+void vpImageConvert::YUV422ToGrey(unsigned char* yuv, unsigned char* grey, unsigned int size,
+                                  unsigned int nbThreads)
 {
- unsigned int i=0,j=0;
-
- while( j < size*2)
- {
-   grey[i++] = yuv[j+1];
-   grey[i++] = yuv[j+3];
-   j+=4;
- }
+  vpYUV422ToGreyConversion job;
+  job.src = yuv;
+  job.dst = grey;
+  runInChunks(job, (size + 1) / 2, 1, nbThreads);
 }
 
 /*!
@@ -1748,100 +2265,21 @@ void vpImageConvert::YUV411ToRGB(unsigned char* yuv, unsigned char* rgb, unsigne
   Convert YUV420 into RGBa
   yuv420 : Y(NxM), U(N/2xM/2), V(N/2xM/2)
 
+  The image is converted by blocks of 16x2 pixels with SSE2 when available,
+  giving the same values than the scalar code. \e nbThreads threads convert
+  each a band of rows.
+
 */
 void vpImageConvert::YUV420ToRGBa(unsigned char* yuv, unsigned char* rgba,
-                                  unsigned int width, unsigned int height)
+                                  unsigned int width, unsigned int height,
+                                  unsigned int nbThreads)
 {
-  //  std::cout << "call optimized ConvertYUV420ToRGBa()" << std::endl;
-  int U, V, R, G, B, V2, U5, UV;
-  int Y0, Y1, Y2, Y3;
-  unsigned int size = width*height;
-  unsigned char* iU = yuv + size;
-  unsigned char* iV = yuv + 5*size/4;
-  for(unsigned int i = 0; i<height/2; i++)
-  {
-  for(unsigned int j = 0; j < width/2 ; j++)
-    {
-    U   = (int)((*iU++ - 128) * 0.354);
-    U5  = 5*U;
-    V   = (int)((*iV++ - 128) * 0.707);
-    V2  = 2*V;
-    UV  = - U - V;
-    Y0  = *yuv++;
-    Y1  = *yuv;
-    yuv = yuv+width-1;
-    Y2  = *yuv++;
-    Y3  = *yuv;
-    yuv = yuv-width+1;
-
-    // Original equations
-    // R = Y           + 1.402 V
-    // G = Y - 0.344 U - 0.714 V
-    // B = Y + 1.772 U
-    R = Y0 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y0 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y0 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = 0;
-
-    //---
-    R = Y1 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y1 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y1 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba = 0;
-    rgba = rgba + 4*width-7;
-
-    //---
-    R = Y2 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y2 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y2 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba++ = 0;
-
-    //---
-    R = Y3 + V2;
-    if ((R >> 8) > 0) R = 255; else if (R < 0) R = 0;
-
-    G = Y3 + UV;
-    if ((G >> 8) > 0) G = 255; else if (G < 0) G = 0;
-
-    B = Y3 + U5;
-    if ((B >> 8) > 0) B = 255; else if (B < 0) B = 0;
-
-    *rgba++ = (unsigned char)R;
-    *rgba++ = (unsigned char)G;
-    *rgba++ = (unsigned char)B;
-    *rgba = 0;
-    rgba = rgba -4*width+1;
-    }
-  yuv+=width;
-  rgba+=4*width;
-  }
+  vpYUV420ToRGBaConversion job;
+  job.src = yuv;
+  job.dst = rgba;
+  job.width = width;
+  job.height = height;
+  runInChunks(job, height / 2, 1, nbThreads);
 }
 /*!
 
@@ -2853,133 +3291,17 @@ void vpImageConvert::RGBaToRGB(unsigned char* rgba, unsigned char* rgb, unsigned
   modern monitor. See Charles Pontyon's Colour FAQ
   http://www.poynton.com/notes/colour_and_gamma/ColorFAQ.html
 
+  With SSSE3, the blocks of 16 pixels are converted with fixed-point
+  weights. To convert the image with several threads, use
+  RGBToGrey(unsigned char *, unsigned char *, unsigned int, unsigned int, bool, unsigned int).
+
 */
 void vpImageConvert::RGBToGrey(unsigned char* rgb, unsigned char* grey, unsigned int size)
 {
-#if VISP_HAVE_SSSE3
-  unsigned int i = 0;
-
-  if(size >= 16) {
-    //Mask to select R component
-    const __m128i mask_R1 = _mm_set_epi8(
-          -1, -1, -1, -1, 15, -1, 12, -1, 9, -1, 6, -1, 3, -1, 0, -1
-          );
-    const __m128i mask_R2 = _mm_set_epi8(
-          5, -1, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-    const __m128i mask_R3 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 14, -1, 11, -1, 8, -1
-          );
-    const __m128i mask_R4 = _mm_set_epi8(
-          13, -1, 10, -1, 7, -1, 4, -1, 1, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select G component
-    const __m128i mask_G1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, 13, -1, 10, -1, 7, -1, 4, -1, 1, -1
-          );
-    const __m128i mask_G2 = _mm_set_epi8(
-          6, -1, 3, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-    const __m128i mask_G3 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 15, -1, 12, -1, 9, -1
-          );
-    const __m128i mask_G4 = _mm_set_epi8(
-          14, -1, 11, -1, 8, -1, 5, -1, 2, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select B component
-    const __m128i mask_B1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, 14, -1, 11, -1, 8, -1, 5, -1, 2, -1
-          );
-    const __m128i mask_B2 = _mm_set_epi8(
-          7, -1, 4, -1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-    const __m128i mask_B3 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 13, -1, 10, -1
-          );
-    const __m128i mask_B4 = _mm_set_epi8(
-          15, -1, 12, -1, 9, -1, 6, -1, 3, -1, 0, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select the gray component
-    const __m128i mask_low1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, 15, 13, 11, 9, 7, 5, 3, 1
-          );
-    const __m128i mask_low2 = _mm_set_epi8(
-          15, 13, 11, 9, 7, 5, 3, 1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Coefficients RGB to Gray
-    const __m128i coeff_R = _mm_set_epi16(
-          13933, 13933, 13933, 13933, 13933, 13933, 13933, 13933
-          );
-    const __m128i coeff_G = _mm_set_epi16(
-          (short int) 46871, (short int) 46871, (short int) 46871, (short int) 46871,
-          (short int) 46871, (short int) 46871, (short int) 46871, (short int) 46871
-          );
-    const __m128i coeff_B = _mm_set_epi16(
-          4732, 4732, 4732, 4732, 4732, 4732, 4732, 4732
-          );
-
-    for(; i <= size - 16; i+=16) {
-      //Process 16 color pixels
-      const __m128i data1 = _mm_loadu_si128((const __m128i*) rgb);
-      const __m128i data2 = _mm_loadu_si128((const __m128i*) (rgb + 16));
-      const __m128i data3 = _mm_loadu_si128((const __m128i*) (rgb + 32));
-
-      const __m128i red_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_R1), _mm_shuffle_epi8(data2, mask_R2) );
-      const __m128i green_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_G1), _mm_shuffle_epi8(data2, mask_G2) );
-      const __m128i blue_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_B1), _mm_shuffle_epi8(data2, mask_B2) );
-
-      const __m128i grays_0_7 =
-          _mm_adds_epu16(
-            _mm_mulhi_epu16(red_0_7, coeff_R),
-            _mm_adds_epu16(
-              _mm_mulhi_epu16(green_0_7, coeff_G),
-              _mm_mulhi_epu16(blue_0_7,  coeff_B)
-              ));
-
-      const __m128i red_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_R3), _mm_shuffle_epi8(data3, mask_R4) );
-      const __m128i green_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_G3), _mm_shuffle_epi8(data3, mask_G4) );
-      const __m128i blue_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_B3), _mm_shuffle_epi8(data3, mask_B4) );
-
-      const __m128i grays_8_15 =
-          _mm_adds_epu16(
-            _mm_mulhi_epu16(red_8_15, coeff_R),
-            _mm_adds_epu16(
-              _mm_mulhi_epu16(green_8_15, coeff_G),
-              _mm_mulhi_epu16(blue_8_15,  coeff_B)
-              ));
-
-      _mm_storeu_si128( (__m128i*) grey, _mm_or_si128(_mm_shuffle_epi8(grays_0_7, mask_low1), _mm_shuffle_epi8(grays_8_15, mask_low2)) );
-
-      rgb += 48;
-      grey += 16;
-    }
-  }
-
-  for(; i < size; i++) {
-    *grey = (unsigned char) (0.2126 * (*rgb)
-      + 0.7152 * (*(rgb + 1))
-      + 0.0722 * (*(rgb + 2)) );
-
-    rgb += 3;
-    ++grey;
-  }
-#else
-  unsigned char *pt_input = rgb;
-  unsigned char* pt_end = rgb + size*3;
-  unsigned char *pt_output = grey;
-
-  while(pt_input != pt_end) {
-    *pt_output = (unsigned char) (0.2126 * (*pt_input)
-      + 0.7152 * (*(pt_input + 1))
-      + 0.0722 * (*(pt_input + 2)) );
-    pt_input += 3;
-    pt_output ++;
-  }
-#endif
+  vpGreyConversion<3, false> job;
+  job.src = rgb;
+  job.dst = grey;
+  runInChunks(job, size, greyBlockSize, 1);
 }
 /*!
 
@@ -2987,118 +3309,57 @@ void vpImageConvert::RGBToGrey(unsigned char* rgb, unsigned char* grey, unsigned
   modern monitor. See Charles Pontyon's Colour FAQ
   http://www.poynton.com/notes/colour_and_gamma/ColorFAQ.html
 
+  With SSSE3, the blocks of 16 pixels are converted with fixed-point
+  weights. \e nbThreads threads convert each a part of the image.
+
 */
-void vpImageConvert::RGBaToGrey(unsigned char* rgba, unsigned char* grey, unsigned int size)
+void vpImageConvert::RGBaToGrey(unsigned char* rgba, unsigned char* grey, unsigned int size,
+                                unsigned int nbThreads)
 {
-#if VISP_HAVE_SSSE3
-  unsigned int i = 0;
-
-  if(size >= 16) {
-    //Mask to select R component
-    const __m128i mask_R1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, 12, -1, 8, -1, 4, -1, 0, -1
-          );
-    const __m128i mask_R2 = _mm_set_epi8(
-          12, -1, 8, -1, 4, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select G component
-    const __m128i mask_G1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, 13, -1, 9, -1, 5, -1, 1, -1
-          );
-    const __m128i mask_G2 = _mm_set_epi8(
-          13, -1, 9, -1, 5, -1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select B component
-    const __m128i mask_B1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, 14, -1, 10, -1, 6, -1, 2, -1
-          );
-    const __m128i mask_B2 = _mm_set_epi8(
-          14, -1, 10, -1, 6, -1, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select the gray component
-    const __m128i mask_low1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, 15, 13, 11, 9, 7, 5, 3, 1
-          );
-    const __m128i mask_low2 = _mm_set_epi8(
-          15, 13, 11, 9, 7, 5, 3, 1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Coefficients RGB to Gray
-    const __m128i coeff_R = _mm_set_epi16(
-          13933, 13933, 13933, 13933, 13933, 13933, 13933, 13933
-          );
-    const __m128i coeff_G = _mm_set_epi16(
-          (short int) 46871, (short int) 46871, (short int) 46871, (short int) 46871,
-          (short int) 46871, (short int) 46871, (short int) 46871, (short int) 46871
-          );
-    const __m128i coeff_B = _mm_set_epi16(
-          4732, 4732, 4732, 4732, 4732, 4732, 4732, 4732
-          );
-
-    for(; i <= size - 16; i+=16) {
-      //Process 2*4 color pixels
-      const __m128i data1 = _mm_loadu_si128((const __m128i*) rgba);
-      const __m128i data2 = _mm_loadu_si128((const __m128i*) (rgba + 16));
-
-      const __m128i red_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_R1), _mm_shuffle_epi8(data2, mask_R2) );
-      const __m128i green_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_G1), _mm_shuffle_epi8(data2, mask_G2) );
-      const __m128i blue_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_B1), _mm_shuffle_epi8(data2, mask_B2) );
-
-      const __m128i grays_0_7 =
-          _mm_adds_epu16(
-            _mm_mulhi_epu16(red_0_7, coeff_R),
-            _mm_adds_epu16(
-              _mm_mulhi_epu16(green_0_7, coeff_G),
-              _mm_mulhi_epu16(blue_0_7,  coeff_B)
-              ));
-
-      //Process next 2*4 color pixels
-      const __m128i data3 = _mm_loadu_si128((const __m128i*) (rgba + 32));
-      const __m128i data4 = _mm_loadu_si128((const __m128i*) (rgba + 48));
-
-      const __m128i red_8_15 = _mm_or_si128( _mm_shuffle_epi8(data3, mask_R1), _mm_shuffle_epi8(data4, mask_R2) );
-      const __m128i green_8_15 = _mm_or_si128( _mm_shuffle_epi8(data3, mask_G1), _mm_shuffle_epi8(data4, mask_G2) );
-      const __m128i blue_8_15 = _mm_or_si128( _mm_shuffle_epi8(data3, mask_B1), _mm_shuffle_epi8(data4, mask_B2) );
-
-      const __m128i grays_8_15 =
-          _mm_adds_epu16(
-            _mm_mulhi_epu16(red_8_15, coeff_R),
-            _mm_adds_epu16(
-              _mm_mulhi_epu16(green_8_15, coeff_G),
-              _mm_mulhi_epu16(blue_8_15,  coeff_B)
-              ));
-
-      _mm_storeu_si128( (__m128i*) grey, _mm_or_si128(_mm_shuffle_epi8(grays_0_7, mask_low1), _mm_shuffle_epi8(grays_8_15, mask_low2)) );
-
-      rgba += 64;
-      grey += 16;
-    }
-  }
+  vpGreyConversion<4, false> job;
+  job.src = rgba;
+  job.dst = grey;
+  runInChunks(job, size, greyBlockSize, nbThreads);
+}
 
-  for(; i < size; i++) {
-    *grey = (unsigned char) (0.2126 * (*rgba)
-      + 0.7152 * (*(rgba + 1))
-      + 0.0722 * (*(rgba + 2)) );
+/*!
+  Convert a view on a vpImage\<vpRGBa\>, or on an RGBa buffer which rows may
+  be padded, to a vpImage\<unsigned char\> with the weights of RGBaToGrey().
+  Only the pixels of the view are read.
 
-    rgba += 4;
-    ++grey;
-  }
-#else
-  unsigned char *pt_input = rgba;
-  unsigned char* pt_end = rgba + size*4;
-  unsigned char *pt_output = grey;
+  \param src : Source view.
+  \param dest : Destination image, resized to the size of the view.
+  \param nbThreads : Number of threads, each one converting a part of the rows.
+*/
+void vpImageConvert::convert(const vpImageView<vpRGBa> &src, vpImage<unsigned char> &dest, unsigned int nbThreads)
+{
+  dest.resize(src.getHeight(), src.getWidth());
+  if (src.getSize() == 0)
+    return;
 
-  while(pt_input != pt_end) {
-    *pt_output = (unsigned char) (0.2126 * (*pt_input)
-      + 0.7152 * (*(pt_input + 1))
-      + 0.0722 * (*(pt_input + 2)) );
-    pt_input += 4;
-    pt_output ++;
+  if (src.isContiguous()) {
+    RGBaToGrey((unsigned char *)src.getData(), dest.bitmap, src.getSize(), nbThreads);
+    return;
   }
-#endif
+  vpGreyViewConversion job;
+  job.src = src;
+  job.dst = &dest;
+  runInChunks(job, src.getHeight(), 1, nbThreads);
+}
+
+/*!
+  Convert a view on a vpImage\<unsigned char\>, or on a grey level buffer
+  which rows may be padded, to a vpImage\<vpRGBa\>. Only the pixels of the
+  view are read.
+
+  \param src : Source view.
+  \param dest : Destination image, resized to the size of the view.
+*/
+void vpImageConvert::convert(const vpImageView<unsigned char> &src, vpImage<vpRGBa> &dest)
+{
+  dest.resize(src.getHeight(), src.getWidth());
+  for (unsigned int i = 0; i < src.getHeight(); i++)
+    GreyToRGBa(src[i], (unsigned char *)dest[i], src.getWidth());
 }
 
 /*!
@@ -3184,237 +3445,27 @@ vpImageConvert::BGRToRGBa(unsigned char * bgr, unsigned char * rgba,
   Converts a BGR image to greyscale
   Flips the image verticaly if needed
   assumes that grey is already resized
+  Uses nbThreads threads that convert each a part of the image
 */
 void
 vpImageConvert::BGRToGrey(unsigned char * bgr, unsigned char * grey,
-                          unsigned int width, unsigned int height, bool flip)
+                          unsigned int width, unsigned int height, bool flip,
+                          unsigned int nbThreads)
 {
-#if VISP_HAVE_SSSE3
-  //Mask to select B component
-  const __m128i mask_B1 = _mm_set_epi8(
-        -1, -1, -1, -1, 15, -1, 12, -1, 9, -1, 6, -1, 3, -1, 0, -1
-        );
-  const __m128i mask_B2 = _mm_set_epi8(
-        5, -1, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-        );
-  const __m128i mask_B3 = _mm_set_epi8(
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 14, -1, 11, -1, 8, -1
-        );
-  const __m128i mask_B4 = _mm_set_epi8(
-        13, -1, 10, -1, 7, -1, 4, -1, 1, -1, -1, -1, -1, -1, -1, -1
-        );
-
-  //Mask to select G component
-  const __m128i mask_G1 = _mm_set_epi8(
-        -1, -1, -1, -1, -1, -1, 13, -1, 10, -1, 7, -1, 4, -1, 1, -1
-        );
-  const __m128i mask_G2 = _mm_set_epi8(
-        6, -1, 3, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-        );
-  const __m128i mask_G3 = _mm_set_epi8(
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 15, -1, 12, -1, 9, -1
-        );
-  const __m128i mask_G4 = _mm_set_epi8(
-        14, -1, 11, -1, 8, -1, 5, -1, 2, -1, -1, -1, -1, -1, -1, -1
-        );
-
-  //Mask to select R component
-  const __m128i mask_R1 = _mm_set_epi8(
-        -1, -1, -1, -1, -1, -1, 14, -1, 11, -1, 8, -1, 5, -1, 2, -1
-        );
-  const __m128i mask_R2 = _mm_set_epi8(
-        7, -1, 4, -1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-        );
-  const __m128i mask_R3 = _mm_set_epi8(
-        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 13, -1, 10, -1
-        );
-  const __m128i mask_R4 = _mm_set_epi8(
-        15, -1, 12, -1, 9, -1, 6, -1, 3, -1, 0, -1, -1, -1, -1, -1
-        );
-
-  //Mask to select the gray component
-  const __m128i mask_low1 = _mm_set_epi8(
-        -1, -1, -1, -1, -1, -1, -1, -1, 15, 13, 11, 9, 7, 5, 3, 1
-        );
-  const __m128i mask_low2 = _mm_set_epi8(
-        15, 13, 11, 9, 7, 5, 3, 1, -1, -1, -1, -1, -1, -1, -1, -1
-        );
-
-  //Coefficients RGB to Gray
-//  const __m128i coeff_R = _mm_set_epi8(
-//        54, -1, 54, -1, 54, -1, 54, -1, 54, -1, 54, -1, 54, -1, 54, -1
-//        );
-//  const __m128i coeff_G = _mm_set_epi8(
-//        183, -1, 183, -1, 183, -1, 183, -1, 183, -1, 183, -1, 183, -1, 183, -1
-//        );
-//  const __m128i coeff_B = _mm_set_epi8(
-//        18, -1, 18, -1, 18, -1, 18, -1, 18, -1, 18, -1, 18, -1, 18, -1
-//        );
-//  const __m128i coeff_R = _mm_set_epi16(
-//        6969*2, 6969*2, 6969*2, 6969*2, 6969*2, 6969*2, 6969*2, 6969*2
-//        );
-//  const __m128i coeff_G = _mm_set_epi16(
-//        23434*2, 23434*2, 23434*2, 23434*2, 23434*2, 23434*2, 23434*2, 23434*2
-//        );
-//  const __m128i coeff_B = _mm_set_epi16(
-//        2365*2, 2365*2, 2365*2, 2365*2, 2365*2, 2365*2, 2365*2, 2365*2
-//        );
-  const __m128i coeff_R = _mm_set_epi16(
-        13933, 13933, 13933, 13933, 13933, 13933, 13933, 13933
-        );
-  const __m128i coeff_G = _mm_set_epi16(
-        (short int) 46871, (short int) 46871, (short int) 46871, (short int) 46871,
-        (short int) 46871, (short int) 46871, (short int) 46871, (short int) 46871
-        );
-  const __m128i coeff_B = _mm_set_epi16(
-        4732, 4732, 4732, 4732, 4732, 4732, 4732, 4732
-        );
-
-  if(flip) {
-    int i = ((int) height) - 1;
-    int lineStep = -(int) (width*3);
-    bgr = bgr + (width * (height-1) * 3);
-
-    unsigned char *linePtr = bgr;
-    unsigned char r,g,b;
-
-    if(width >= 16) {
-      for(; i >= 0; i--) {
-        unsigned int j = 0;
-
-        for(; j <= width - 16; j+=16) {
-          //Process 16 color pixels
-          const __m128i data1 = _mm_loadu_si128((const __m128i*) bgr);
-          const __m128i data2 = _mm_loadu_si128((const __m128i*) (bgr + 16));
-          const __m128i data3 = _mm_loadu_si128((const __m128i*) (bgr + 32));
-
-          const __m128i red_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_R1), _mm_shuffle_epi8(data2, mask_R2) );
-          const __m128i green_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_G1), _mm_shuffle_epi8(data2, mask_G2) );
-          const __m128i blue_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_B1), _mm_shuffle_epi8(data2, mask_B2) );
-
-          const __m128i grays_0_7 =
-              _mm_adds_epu16(
-                _mm_mulhi_epu16(red_0_7, coeff_R),
-                _mm_adds_epu16(
-                  _mm_mulhi_epu16(green_0_7, coeff_G),
-                  _mm_mulhi_epu16(blue_0_7,  coeff_B)
-                  ));
-
-          const __m128i red_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_R3), _mm_shuffle_epi8(data3, mask_R4) );
-          const __m128i green_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_G3), _mm_shuffle_epi8(data3, mask_G4) );
-          const __m128i blue_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_B3), _mm_shuffle_epi8(data3, mask_B4) );
-
-          const __m128i grays_8_15 =
-              _mm_adds_epu16(
-                _mm_mulhi_epu16(red_8_15, coeff_R),
-                _mm_adds_epu16(
-                  _mm_mulhi_epu16(green_8_15, coeff_G),
-                  _mm_mulhi_epu16(blue_8_15,  coeff_B)
-                  ));
-
-          _mm_storeu_si128( (__m128i*) grey, _mm_or_si128(_mm_shuffle_epi8(grays_0_7, mask_low1), _mm_shuffle_epi8(grays_8_15, mask_low2)) );
-
-          bgr += 48;
-          grey += 16;
-        }
-
-        for(; j < width; j++) {
-          b = *(bgr++);
-          g = *(bgr++);
-          r = *(bgr++);
-          *grey++ = (unsigned char) ( 0.2126 * r + 0.7152 * g + 0.0722 * b);
-        }
-
-        linePtr += lineStep;
-        bgr = linePtr;
-      }
-    }
-
-    for(; i >= 0; i--) {
-      for(unsigned int j = 0; j < width; j++) {
-        b = *(bgr++);
-        g = *(bgr++);
-        r = *(bgr++);
-        *grey++ = (unsigned char) ( 0.2126 * r + 0.7152 * g + 0.0722 * b);
-      }
-
-      linePtr += lineStep;
-      bgr = linePtr;
-    }
-  } else {
-    unsigned int i = 0;
-    unsigned int size = width * height;
-
-    if(size >= 16) {
-      for(; i <= size - 16; i+=16) {
-        //Process 16 color pixels
-        const __m128i data1 = _mm_loadu_si128((const __m128i*) bgr);
-        const __m128i data2 = _mm_loadu_si128((const __m128i*) (bgr + 16));
-        const __m128i data3 = _mm_loadu_si128((const __m128i*) (bgr + 32));
-
-        const __m128i red_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_R1), _mm_shuffle_epi8(data2, mask_R2) );
-        const __m128i green_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_G1), _mm_shuffle_epi8(data2, mask_G2) );
-        const __m128i blue_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_B1), _mm_shuffle_epi8(data2, mask_B2) );
-
-        const __m128i grays_0_7 =
-            _mm_adds_epu16(
-              _mm_mulhi_epu16(red_0_7, coeff_R),
-              _mm_adds_epu16(
-                _mm_mulhi_epu16(green_0_7, coeff_G),
-                _mm_mulhi_epu16(blue_0_7,  coeff_B)
-                ));
-
-        const __m128i red_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_R3), _mm_shuffle_epi8(data3, mask_R4) );
-        const __m128i green_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_G3), _mm_shuffle_epi8(data3, mask_G4) );
-        const __m128i blue_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_B3), _mm_shuffle_epi8(data3, mask_B4) );
-
-        const __m128i grays_8_15 =
-            _mm_adds_epu16(
-              _mm_mulhi_epu16(red_8_15, coeff_R),
-              _mm_adds_epu16(
-                _mm_mulhi_epu16(green_8_15, coeff_G),
-                _mm_mulhi_epu16(blue_8_15,  coeff_B)
-                ));
-
-        _mm_storeu_si128( (__m128i*) grey, _mm_or_si128(_mm_shuffle_epi8(grays_0_7, mask_low1), _mm_shuffle_epi8(grays_8_15, mask_low2)) );
-
-        bgr += 48;
-        grey += 16;
-      }
-    }
-
-    for(; i < size; i++) {
-      *grey = (unsigned char) (0.2126 * (*(bgr + 2))
-                               + 0.7152 * (*(bgr + 1))
-                               + 0.0722 * (*bgr) );
-
-      bgr += 3;
-      ++grey;
-    }
+  if (flip) {
+    vpGreyFlipConversion<true> job;
+    job.src = bgr;
+    job.dst = grey;
+    job.width = width;
+    job.height = height;
+    runInChunks(job, height, 1, nbThreads);
   }
-#else
-  //if we have to flip the image, we start from the end last scanline so the
-  //step is negative
-  int lineStep = (flip) ? -(int)(width*3) : (int)(width*3);
-
-  //starting source address = last line if we need to flip the image
-  unsigned char * src = (flip) ? bgr+(width*height*3)+lineStep : bgr;
-
-  for(unsigned int i=0 ; i < height ; i++)
-  {
-    unsigned char *line = src;
-    for(unsigned int j=0 ; j < width ; j++)
-    {
-      *grey++ = (unsigned char)( 0.2126 * *(line+2)
-         + 0.7152 * *(line+1)
-         + 0.0722 * *(line+0)) ;
-      line+=3;
-    }
-
-    //go to the next line
-    src+=lineStep;
+  else {
+    vpGreyConversion<3, true> job;
+    job.src = bgr;
+    job.dst = grey;
+    runInChunks(job, width * height, greyBlockSize, nbThreads);
   }
-#endif
 }
 
 /*!
@@ -3455,175 +3506,26 @@ vpImageConvert::RGBToRGBa(unsigned char * rgb, unsigned char * rgba,
   Converts a RGB image to greyscale
   Flips the image verticaly if needed
   assumes that grey is already resized
+  Uses nbThreads threads that convert each a part of the image
 */
 void
 vpImageConvert::RGBToGrey(unsigned char * rgb, unsigned char * grey,
-                          unsigned int width, unsigned int height, bool flip)
+                          unsigned int width, unsigned int height, bool flip,
+                          unsigned int nbThreads)
 {
-  if(flip) {
-#if VISP_HAVE_SSSE3
-    int i = ((int) height) - 1;
-    int lineStep = -(int) (width*3);
-    rgb = rgb + (width * (height-1) * 3);
-
-    unsigned char *linePtr = rgb;
-    unsigned char r,g,b;
-
-  if(width >= 16) {
-    //Mask to select R component
-    const __m128i mask_R1 = _mm_set_epi8(
-          -1, -1, -1, -1, 15, -1, 12, -1, 9, -1, 6, -1, 3, -1, 0, -1
-          );
-    const __m128i mask_R2 = _mm_set_epi8(
-          5, -1, 2, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-    const __m128i mask_R3 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 14, -1, 11, -1, 8, -1
-          );
-    const __m128i mask_R4 = _mm_set_epi8(
-          13, -1, 10, -1, 7, -1, 4, -1, 1, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select G component
-    const __m128i mask_G1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, 13, -1, 10, -1, 7, -1, 4, -1, 1, -1
-          );
-    const __m128i mask_G2 = _mm_set_epi8(
-          6, -1, 3, -1, 0, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-    const __m128i mask_G3 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 15, -1, 12, -1, 9, -1
-          );
-    const __m128i mask_G4 = _mm_set_epi8(
-          14, -1, 11, -1, 8, -1, 5, -1, 2, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select B component
-    const __m128i mask_B1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, 14, -1, 11, -1, 8, -1, 5, -1, 2, -1
-          );
-    const __m128i mask_B2 = _mm_set_epi8(
-          7, -1, 4, -1, 1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-    const __m128i mask_B3 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 13, -1, 10, -1
-          );
-    const __m128i mask_B4 = _mm_set_epi8(
-          15, -1, 12, -1, 9, -1, 6, -1, 3, -1, 0, -1, -1, -1, -1, -1
-          );
-
-    //Mask to select the gray component
-    const __m128i mask_low1 = _mm_set_epi8(
-          -1, -1, -1, -1, -1, -1, -1, -1, 15, 13, 11, 9, 7, 5, 3, 1
-          );
-    const __m128i mask_low2 = _mm_set_epi8(
-          15, 13, 11, 9, 7, 5, 3, 1, -1, -1, -1, -1, -1, -1, -1, -1
-          );
-
-    //Coefficients RGB to Gray
-    const __m128i coeff_R = _mm_set_epi16(
-          13933, 13933, 13933, 13933, 13933, 13933, 13933, 13933
-          );
-    const __m128i coeff_G = _mm_set_epi16(
-          (short int) 46871, (short int) 46871, (short int) 46871, (short int) 46871,
-          (short int) 46871, (short int) 46871, (short int) 46871, (short int) 46871
-          );
-    const __m128i coeff_B = _mm_set_epi16(
-          4732, 4732, 4732, 4732, 4732, 4732, 4732, 4732
-          );
-
-    for(; i >= 0; i--) {
-      unsigned int j = 0;
-
-      for(; j <= width - 16; j+=16) {
-        //Process 16 color pixels
-        const __m128i data1 = _mm_loadu_si128((const __m128i*) rgb);
-        const __m128i data2 = _mm_loadu_si128((const __m128i*) (rgb + 16));
-        const __m128i data3 = _mm_loadu_si128((const __m128i*) (rgb + 32));
-
-        const __m128i red_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_R1), _mm_shuffle_epi8(data2, mask_R2) );
-        const __m128i green_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_G1), _mm_shuffle_epi8(data2, mask_G2) );
-        const __m128i blue_0_7 = _mm_or_si128( _mm_shuffle_epi8(data1, mask_B1), _mm_shuffle_epi8(data2, mask_B2) );
-
-        const __m128i grays_0_7 =
-            _mm_adds_epu16(
-              _mm_mulhi_epu16(red_0_7, coeff_R),
-              _mm_adds_epu16(
-                _mm_mulhi_epu16(green_0_7, coeff_G),
-                _mm_mulhi_epu16(blue_0_7,  coeff_B)
-                ));
-
-        const __m128i red_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_R3), _mm_shuffle_epi8(data3, mask_R4) );
-        const __m128i green_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_G3), _mm_shuffle_epi8(data3, mask_G4) );
-        const __m128i blue_8_15 = _mm_or_si128( _mm_shuffle_epi8(data2, mask_B3), _mm_shuffle_epi8(data3, mask_B4) );
-
-        const __m128i grays_8_15 =
-            _mm_adds_epu16(
-              _mm_mulhi_epu16(red_8_15, coeff_R),
-              _mm_adds_epu16(
-                _mm_mulhi_epu16(green_8_15, coeff_G),
-                _mm_mulhi_epu16(blue_8_15,  coeff_B)
-                ));
-
-        _mm_storeu_si128( (__m128i*) grey, _mm_or_si128(_mm_shuffle_epi8(grays_0_7, mask_low1), _mm_shuffle_epi8(grays_8_15, mask_low2)) );
-
-        rgb += 48;
-        grey += 16;
-      }
-
-      for(; j < width; j++) {
-        r = *(rgb++);
-        g = *(rgb++);
-        b = *(rgb++);
-        *grey++ = (unsigned char) ( 0.2126 * r + 0.7152 * g + 0.0722 * b);
-      }
-
-      linePtr += lineStep;
-      rgb = linePtr;
-    }
-  }
-
-  for(; i >= 0; i--) {
-    for(unsigned int j = 0; j < width; j++) {
-      r = *(rgb++);
-      g = *(rgb++);
-      b = *(rgb++);
-      *grey++ = (unsigned char) ( 0.2126 * r + 0.7152 * g + 0.0722 * b);
-    }
-
-    linePtr += lineStep;
-    rgb = linePtr;
-  }
-#else
-  //if we have to flip the image, we start from the end last scanline so the
-  //step is negative
-  int lineStep = (flip) ? -(int)(width*3) : (int)(width*3);
-
-  //starting source address = last line if we need to flip the image
-  unsigned char * src = (flip) ? rgb+(width*height*3)+lineStep : rgb;
-
-  unsigned int j=0;
-  unsigned int i=0;
-
-  unsigned r,g,b;
-
-  for(i=0 ; i < height ; i++)
-  {
-    unsigned char * line = src;
-    for( j=0 ; j < width ; j++)
-    {
-      r = *(line++);
-      g = *(line++);
-      b = *(line++);
-      *grey++ = (unsigned char)( 0.2126 * r + 0.7152 * g + 0.0722 * b) ;
-    }
-
-    //go to the next line
-    src+=lineStep;
+  if (flip) {
+    vpGreyFlipConversion<false> job;
+    job.src = rgb;
+    job.dst = grey;
+    job.width = width;
+    job.height = height;
+    runInChunks(job, height, 1, nbThreads);
   }
-#endif
-  } else {
-    RGBToGrey(rgb, grey, width*height);
+  else {
+    vpGreyConversion<3, false> job;
+    job.src = rgb;
+    job.dst = grey;
+    runInChunks(job, width * height, greyBlockSize, nbThreads);
   }
 }
 
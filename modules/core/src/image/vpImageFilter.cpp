@@ -37,6 +37,12 @@
 
 #include <visp3/core/vpImageFilter.h>
 #include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpThreadPool.h>
+
+#include <algorithm>
+#include <vector>
+#include <string.h>
+
 #if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020408)
 #  include <opencv2/imgproc/imgproc.hpp>
 #elif defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020101)
@@ -45,6 +51,568 @@
 #  include <cv.h>
 #endif
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  /*
+    One pass of a separable filter along the rows (horizontal) or the columns
+    (vertical) of an image. With the (size+1)/2 coefficients f, a symmetric
+    pass computes sum_i f[i]*(I[c+i]+I[c-i]) + f[0]*I[c] with mirrored
+    borders, while a derivative pass computes sum_i f[i]*(I[c+i]-I[c-i]) and
+    sets the (size-1)/2 border pixels to zero. The operations are done in the
+    same order than in the per pixel functions of vpImageFilter, so that the
+    results are the same.
+  */
+  template<typename Acc>
+  struct vpFilterPass
+  {
+    vpFilterPass()
+      : filter(NULL), half(0), horizontal(true), derivative(false), divisor(0) {}
+    vpFilterPass(const Acc *f, unsigned int size, bool h, bool d, Acc div=0)
+      : filter(f), half(size > 0 ? (size-1)/2 : 0), horizontal(h), derivative(d), divisor(div) {}
+
+    const Acc *filter;
+    unsigned int half;
+    bool horizontal;
+    bool derivative;
+    //! If not zero, the result of a derivative pass is divided by this value
+    Acc divisor;
+  };
+
+  // Numerator of the 7 taps derivative filter of derivativeFilterX() and derivativeFilterY()
+  const double derivative7Double[4] = { 0., 2047., 913., 112. };
+  const float derivative7Float[4] = { 0.f, 2047.f, 913.f, 112.f };
+
+#if defined VISP_HAVE_SSE2
+  /*
+    SIMD operations of the passes for an input pixel type Tin and an
+    accumulator type Acc.
+  */
+  template<typename Tin, typename Acc> struct vpFilterSimd;
+
+  template<> struct vpFilterSimd<float, float>
+  {
+    typedef __m128 V;
+    enum { lanes = 4 };
+    static inline V zero() { return _mm_setzero_ps(); }
+    static inline V set1(float v) { return _mm_set1_ps(v); }
+    static inline V add(const V &a, const V &b) { return _mm_add_ps(a, b); }
+    static inline V mul(const V &a, const V &b) { return _mm_mul_ps(a, b); }
+    static inline V div(const V &a, const V &b) { return _mm_div_ps(a, b); }
+    static inline void store(float *p, const V &v) { _mm_storeu_ps(p, v); }
+    static inline V load(const float *p) { return _mm_loadu_ps(p); }
+    static inline V sum(const float *a, const float *b) { return _mm_add_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)); }
+    static inline V diff(const float *a, const float *b) { return _mm_sub_ps(_mm_loadu_ps(a), _mm_loadu_ps(b)); }
+  };
+
+  template<> struct vpFilterSimd<unsigned char, float> : public vpFilterSimd<float, float>
+  {
+    static inline __m128i load4(const unsigned char *p)
+    {
+      int v;
+      memcpy(&v, p, sizeof(int));
+      const __m128i z = _mm_setzero_si128();
+      return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(v), z), z);
+    }
+    static inline V load(const unsigned char *p) { return _mm_cvtepi32_ps(load4(p)); }
+    static inline V sum(const unsigned char *a, const unsigned char *b) { return _mm_cvtepi32_ps(_mm_add_epi32(load4(a), load4(b))); }
+    static inline V diff(const unsigned char *a, const unsigned char *b) { return _mm_cvtepi32_ps(_mm_sub_epi32(load4(a), load4(b))); }
+  };
+
+  template<> struct vpFilterSimd<double, double>
+  {
+    typedef __m128d V;
+    enum { lanes = 2 };
+    static inline V zero() { return _mm_setzero_pd(); }
+    static inline V set1(double v) { return _mm_set1_pd(v); }
+    static inline V add(const V &a, const V &b) { return _mm_add_pd(a, b); }
+    static inline V mul(const V &a, const V &b) { return _mm_mul_pd(a, b); }
+    static inline V div(const V &a, const V &b) { return _mm_div_pd(a, b); }
+    static inline void store(double *p, const V &v) { _mm_storeu_pd(p, v); }
+    static inline V load(const double *p) { return _mm_loadu_pd(p); }
+    static inline V sum(const double *a, const double *b) { return _mm_add_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)); }
+    static inline V diff(const double *a, const double *b) { return _mm_sub_pd(_mm_loadu_pd(a), _mm_loadu_pd(b)); }
+  };
+
+  template<> struct vpFilterSimd<unsigned char, double> : public vpFilterSimd<double, double>
+  {
+    static inline V load(const unsigned char *p) { return _mm_set_pd((double)p[1], (double)p[0]); }
+    static inline V sum(const unsigned char *a, const unsigned char *b) { return _mm_set_pd((double)(a[1]+b[1]), (double)(a[0]+b[0])); }
+    static inline V diff(const unsigned char *a, const unsigned char *b) { return _mm_set_pd((double)(a[1]-b[1]), (double)(a[0]-b[0])); }
+  };
+#endif
+
+  /*
+    Apply a pass to n consecutive pixels: dst[j] is computed from plus[i][j]
+    and minus[i][j], the neighbors at distance i (1 <= i <= pass.half) on both
+    sides, and from center[j].
+  */
+  template<typename Tin, typename Acc>
+  void convolve(const Tin * const *plus, const Tin * const *minus, const Tin *center,
+                const vpFilterPass<Acc> &pass, Acc *dst, unsigned int n)
+  {
+    const Acc *f = pass.filter;
+    const unsigned int half = pass.half;
+    unsigned int j = 0;
+
+    if (pass.derivative) {
+#if defined VISP_HAVE_SSE2
+      typedef vpFilterSimd<Tin, Acc> S;
+      for (; j + S::lanes <= n; j += S::lanes) {
+        typename S::V s = S::zero();
+        for (unsigned int i = 1; i <= half; i++)
+          s = S::add(s, S::mul(S::set1(f[i]), S::diff(plus[i] + j, minus[i] + j)));
+        if (pass.divisor != 0)
+          s = S::div(s, S::set1(pass.divisor));
+        S::store(dst + j, s);
+      }
+#endif
+      for (; j < n; j++) {
+        Acc s = 0;
+        for (unsigned int i = 1; i <= half; i++)
+          s += f[i] * static_cast<Acc>(plus[i][j] - minus[i][j]);
+        if (pass.divisor != 0)
+          s = s / pass.divisor;
+        dst[j] = s;
+      }
+    }
+    else {
+#if defined VISP_HAVE_SSE2
+      typedef vpFilterSimd<Tin, Acc> S;
+      for (; j + S::lanes <= n; j += S::lanes) {
+        typename S::V s = S::zero();
+        for (unsigned int i = 1; i <= half; i++)
+          s = S::add(s, S::mul(S::set1(f[i]), S::sum(plus[i] + j, minus[i] + j)));
+        S::store(dst + j, S::add(s, S::mul(S::set1(f[0]), S::load(center + j))));
+      }
+#endif
+      for (; j < n; j++) {
+        Acc s = 0;
+        for (unsigned int i = 1; i <= half; i++)
+          s += f[i] * static_cast<Acc>(plus[i][j] + minus[i][j]);
+        dst[j] = s + f[0] * static_cast<Acc>(center[j]);
+      }
+    }
+  }
+
+  /*
+    Mirror an index out of [0, n) like the border functions of vpImageFilter:
+    -k is mapped to k and n-1+k to n-k.
+  */
+  inline unsigned int mirrorIndex(int k, unsigned int n)
+  {
+    if (k < 0)
+      k = -k;
+    if (k >= (int)n)
+      k = 2*(int)n - k - 1;
+    // Images smaller than the filter
+    if (k < 0)
+      k = 0;
+    else if (k >= (int)n)
+      k = (int)n - 1;
+    return (unsigned int)k;
+  }
+
+  // Buffers used by a thread to filter its band of the image
+  template<typename Tin, typename Acc>
+  struct vpFilterScratch
+  {
+    vpFilterScratch(unsigned int width, unsigned int half)
+      : pad(width + 2*half), padPlus(half+1), padMinus(half+1), inPlus(half+1), inMinus(half+1) {}
+
+    //! Row with mirrored borders
+    std::vector<Acc> pad;
+    std::vector<const Acc *> padPlus;
+    std::vector<const Acc *> padMinus;
+    std::vector<const Tin *> inPlus;
+    std::vector<const Tin *> inMinus;
+  };
+
+  // Horizontal pass over a row of the image.
+  template<typename Tin, typename Acc>
+  void filterRow(const Tin *src, unsigned int width, const vpFilterPass<Acc> &pass,
+                 vpFilterScratch<Tin, Acc> &scratch, Acc *dst)
+  {
+    const unsigned int h = pass.half;
+
+    if (pass.derivative) {
+      if (width <= 2*h) {
+        for (unsigned int j = 0; j < width; j++)
+          dst[j] = 0;
+        return;
+      }
+      for (unsigned int j = 0; j < h; j++) {
+        dst[j] = 0;
+        dst[width-1-j] = 0;
+      }
+      for (unsigned int i = 1; i <= h; i++) {
+        scratch.inPlus[i] = src + h + i;
+        scratch.inMinus[i] = src + h - i;
+      }
+      convolve(&scratch.inPlus[0], &scratch.inMinus[0], src + h, pass, dst + h, width - 2*h);
+    }
+    else {
+      Acc *p = &scratch.pad[0] + h;
+      for (unsigned int j = 0; j < width; j++)
+        p[j] = static_cast<Acc>(src[j]);
+      for (unsigned int i = 1; i <= h; i++) {
+        p[-(int)i] = p[mirrorIndex(-(int)i, width)];
+        p[width-1+i] = p[mirrorIndex((int)(width-1+i), width)];
+        scratch.padPlus[i] = p + i;
+        scratch.padMinus[i] = p - i;
+      }
+      convolve(&scratch.padPlus[0], &scratch.padMinus[0], (const Acc *)p, pass, dst, width);
+    }
+  }
+
+  // Row k of an image which rows are separated by stride bytes
+  template<typename T>
+  inline const T *rowAt(const T *base, size_t stride, unsigned int k)
+  {
+    return (const T *)((const unsigned char *)base + (size_t)k * stride);
+  }
+
+  /*
+    Vertical pass that computes row r of an image of the given height. The
+    rows [first, last) of the image are stored from base, separated by
+    stride bytes.
+  */
+  template<typename Tin, typename Acc>
+  void filterColumn(const Tin *base, size_t stride, unsigned int width, unsigned int first, unsigned int height,
+                    unsigned int r, const vpFilterPass<Acc> &pass, vpFilterScratch<Tin, Acc> &scratch, Acc *dst)
+  {
+    const unsigned int h = pass.half;
+
+    if (pass.derivative) {
+      if (r < h || r + h >= height) {
+        for (unsigned int j = 0; j < width; j++)
+          dst[j] = 0;
+        return;
+      }
+      for (unsigned int i = 1; i <= h; i++) {
+        scratch.inPlus[i] = rowAt(base, stride, r + i - first);
+        scratch.inMinus[i] = rowAt(base, stride, r - i - first);
+      }
+    }
+    else {
+      for (unsigned int i = 1; i <= h; i++) {
+        scratch.inPlus[i] = rowAt(base, stride, mirrorIndex((int)(r + i), height) - first);
+        scratch.inMinus[i] = rowAt(base, stride, mirrorIndex((int)r - (int)i, height) - first);
+      }
+    }
+    convolve(&scratch.inPlus[0], &scratch.inMinus[0], rowAt(base, stride, r - first), pass, dst, width);
+  }
+
+  /*
+    Destination of the passes: the rows of the output image when it has the
+    type of the accumulator, a temporary row that is then converted otherwise.
+  */
+  template<typename Acc, typename Tout> struct vpFilterOutput;
+
+  template<typename Acc> struct vpFilterOutput<Acc, Acc>
+  {
+    static inline Acc *row(Acc *out, std::vector<Acc> &) { return out; }
+    static inline void flush(const Acc *, Acc *, unsigned int) {}
+  };
+
+  template<> struct vpFilterOutput<float, short>
+  {
+    static inline float *row(short *, std::vector<float> &tmp) { return &tmp[0]; }
+    static inline void flush(const float *in, short *out, unsigned int n)
+    {
+      const float scale = (float)(1 << vpImageFilter::fixedPointBits);
+      unsigned int j = 0;
+#if defined VISP_HAVE_SSE2
+      const __m128 s = _mm_set1_ps(scale);
+      for (; j + 8 <= n; j += 8) {
+        __m128i lo = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + j), s));
+        __m128i hi = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + j + 4), s));
+        _mm_storeu_si128((__m128i *)(out + j), _mm_packs_epi32(lo, hi));
+      }
+      for (; j < n; j++) {
+        int v = _mm_cvtss_si32(_mm_set_ss(in[j] * scale));
+        out[j] = (short)(v < -32768 ? -32768 : (v > 32767 ? 32767 : v));
+      }
+#else
+      for (; j < n; j++) {
+        int v = vpMath::round(in[j] * scale);
+        out[j] = (short)(v < -32768 ? -32768 : (v > 32767 ? 32767 : v));
+      }
+#endif
+    }
+  };
+
+  /*
+    Filter the rows [rowStart, rowEnd) of an image with one or two passes.
+  */
+  template<typename Tin, typename Acc, typename Tout>
+  struct vpSeparableFilter
+  {
+    vpSeparableFilter()
+      : src(), dst(NULL), nbPasses(0), rowStart(0), rowEnd(0) {}
+
+    vpImageView<Tin> src;
+    vpImage<Tout> *dst;
+    vpFilterPass<Acc> pass[2];
+    unsigned int nbPasses;
+    unsigned int rowStart;
+    unsigned int rowEnd;
+
+    void run()
+    {
+      typedef vpFilterOutput<Acc, Tout> Output;
+      const unsigned int width = src.getWidth();
+      const unsigned int height = src.getHeight();
+      const Tin *bitmap = src.getData();
+      const size_t stride = src.getStride();
+      const unsigned int half = nbPasses > 1 ? std::max(pass[0].half, pass[1].half) : pass[0].half;
+      vpFilterScratch<Tin, Acc> scratch(width, half);
+      std::vector<Acc> out(width);
+
+      if (nbPasses == 1) {
+        for (unsigned int r = rowStart; r < rowEnd; r++) {
+          Acc *o = Output::row((*dst)[r], out);
+          if (pass[0].horizontal)
+            filterRow(rowAt(bitmap, stride, r), width, pass[0], scratch, o);
+          else
+            filterColumn(bitmap, stride, width, 0, height, r, pass[0], scratch, o);
+          Output::flush(o, (*dst)[r], width);
+        }
+      }
+      else if (! pass[0].horizontal) {
+        // Columns then rows: each row is filtered as soon as it is available
+        vpFilterScratch<Acc, Acc> scratchAcc(width, half);
+        std::vector<Acc> tmp(width);
+        for (unsigned int r = rowStart; r < rowEnd; r++) {
+          Acc *o = Output::row((*dst)[r], out);
+          filterColumn(bitmap, stride, width, 0, height, r, pass[0], scratch, &tmp[0]);
+          filterRow((const Acc *)&tmp[0], width, pass[1], scratchAcc, o);
+          Output::flush(o, (*dst)[r], width);
+        }
+      }
+      else {
+        // Rows then columns: the rows of the band and of its margins are
+        // filtered first
+        vpFilterScratch<Acc, Acc> scratchAcc(width, half);
+        unsigned int first = rowStart > pass[1].half ? rowStart - pass[1].half : 0;
+        unsigned int last = std::min(height, rowEnd + pass[1].half);
+        std::vector<Acc> band((size_t)(last - first) * width);
+        for (unsigned int r = first; r < last; r++)
+          filterRow(rowAt(bitmap, stride, r), width, pass[0], scratch, &band[(size_t)(r - first) * width]);
+        for (unsigned int r = rowStart; r < rowEnd; r++) {
+          Acc *o = Output::row((*dst)[r], out);
+          filterColumn((const Acc *)&band[0], width * sizeof(Acc), width, first, height, r, pass[1], scratchAcc, o);
+          Output::flush(o, (*dst)[r], width);
+        }
+      }
+    }
+  };
+
+  /*
+    Run a job, that processes the rows [rowStart, rowEnd) of an image of the
+    given height in its run() function, on nbThreads bands of rows run by
+    the thread pool. Return the number of bands.
+  */
+  template<typename Job>
+  unsigned int runInBands(const Job &job, unsigned int height, unsigned int nbThreads)
+  {
+    if (nbThreads > height)
+      nbThreads = height;
+
+    if (nbThreads <= 1) {
+      Job band(job);
+      band.rowStart = 0;
+      band.rowEnd = height;
+      band.run();
+      return 1;
+    }
+
+    std::vector<Job> bands(nbThreads, job);
+    for (unsigned int i = 0; i < nbThreads; i++) {
+      bands[i].rowStart = (unsigned int)(((size_t)height * i) / nbThreads);
+      bands[i].rowEnd = (unsigned int)(((size_t)height * (i+1)) / nbThreads);
+    }
+    vpThreadPool::getInstance().run(bands);
+    return nbThreads;
+  }
+
+  /*
+    Filter I with one or two passes. The image is split in nbThreads bands of
+    rows that are filtered in parallel.
+  */
+  template<typename Tin, typename Acc, typename Tout>
+  void separableFilter(const vpImageView<Tin> &I, vpImage<Tout> &O, const vpFilterPass<Acc> &first,
+                       const vpFilterPass<Acc> *second, unsigned int nbThreads)
+  {
+    // In place filtering goes through a temporary: a band would otherwise
+    // read the rows that it or its neighbor bands already overwrote, and
+    // resizing O could release the pixels of I
+    if (I.overlaps(O)) {
+      vpImage<Tout> tmp;
+      separableFilter(I, tmp, first, second, nbThreads);
+      O = tmp;
+      return;
+    }
+
+    O.resize(I.getHeight(), I.getWidth());
+    if (I.getSize() == 0)
+      return;
+
+    vpSeparableFilter<Tin, Acc, Tout> job;
+    job.src = I;
+    job.dst = &O;
+    job.pass[0] = first;
+    job.nbPasses = 1;
+    if (second != NULL) {
+      job.pass[1] = *second;
+      job.nbPasses = 2;
+    }
+    runInBands(job, I.getHeight(), nbThreads);
+  }
+
+  template<typename Tin, typename Acc, typename Tout>
+  void separableFilter(const vpImage<Tin> &I, vpImage<Tout> &O, const vpFilterPass<Acc> &first,
+                       const vpFilterPass<Acc> *second, unsigned int nbThreads)
+  {
+    separableFilter(vpImageView<Tin>(I), O, first, second, nbThreads);
+  }
+
+  // Labels of the pixels in the map of the Canny edge detector
+  enum vpCannyLabel { vpCannyNone = 0, vpCannyCandidate = 1, vpCannyEdge = 2 };
+
+  /*
+    Push the candidate 8-neighbors of the edge pixels of a stack on this stack
+    and label them as edges, until the stack is empty. Only the pixels of the
+    map in [begin, end) are considered.
+  */
+  void cannyHysteresis(std::vector<unsigned char *> &stack, unsigned int stride,
+                       const unsigned char *begin, const unsigned char *end)
+  {
+    const ptrdiff_t s = (ptrdiff_t)stride;
+    const ptrdiff_t offsets[8] = { -s-1, -s, -s+1, -1, 1, s-1, s, s+1 };
+    while (! stack.empty()) {
+      unsigned char *p = stack.back();
+      stack.pop_back();
+      for (unsigned int k = 0; k < 8; k++) {
+        unsigned char *q = p + offsets[k];
+        if (q >= begin && q < end && *q == vpCannyCandidate) {
+          *q = vpCannyEdge;
+          stack.push_back(q);
+        }
+      }
+    }
+  }
+
+  /*
+    L1 norm of the gradient of the rows [rowStart, rowEnd).
+  */
+  struct vpCannyMagnitude
+  {
+    vpCannyMagnitude() : gx(NULL), gy(NULL), magnitude(NULL), rowStart(0), rowEnd(0) {}
+
+    const vpImage<float> *gx;
+    const vpImage<float> *gy;
+    float *magnitude;
+    unsigned int rowStart;
+    unsigned int rowEnd;
+
+    void run()
+    {
+      const unsigned int width = gx->getWidth();
+      const size_t begin = (size_t)rowStart * width;
+      const size_t end = (size_t)rowEnd * width;
+      const float *x = gx->bitmap;
+      const float *y = gy->bitmap;
+      size_t i = begin;
+#if defined VISP_HAVE_SSE2
+      const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+      for (; i + 4 <= end; i += 4)
+        _mm_storeu_ps(magnitude + i, _mm_add_ps(_mm_and_ps(_mm_loadu_ps(x + i), absMask),
+                                                _mm_and_ps(_mm_loadu_ps(y + i), absMask)));
+#endif
+      for (; i < end; i++)
+        magnitude[i] = std::fabs(x[i]) + std::fabs(y[i]);
+    }
+  };
+
+  /*
+    Non-maximum suppression and double thresholding of the rows [rowStart,
+    rowEnd), followed by the hysteresis within these rows. The map has a one
+    pixel wide border that stays at vpCannyNone.
+  */
+  struct vpCannyNonMaxSuppression
+  {
+    vpCannyNonMaxSuppression()
+      : gx(NULL), gy(NULL), magnitude(NULL), map(NULL), lowerThreshold(0), upperThreshold(0),
+        rowStart(0), rowEnd(0) {}
+
+    const vpImage<float> *gx;
+    const vpImage<float> *gy;
+    const float *magnitude;
+    unsigned char *map;
+    float lowerThreshold;
+    float upperThreshold;
+    unsigned int rowStart;
+    unsigned int rowEnd;
+
+    void run()
+    {
+      const unsigned int width = gx->getWidth();
+      const unsigned int height = gx->getHeight();
+      const unsigned int stride = width + 2;
+      // tan(22.5 deg) and tan(67.5 deg)
+      const float tan22 = 0.4142135623f;
+      const float tan67 = 2.4142135623f;
+      std::vector<unsigned char *> stack;
+
+      for (unsigned int r = rowStart; r < rowEnd; r++) {
+        unsigned char *m = map + (size_t)(r+1) * stride + 1;
+        memset(m, vpCannyNone, width);
+        // The gradient is not defined on the first and last rows and columns
+        if (r == 0 || r + 1 >= height)
+          continue;
+
+        const float *mag = magnitude + (size_t)r * width;
+        const float *above = mag - width;
+        const float *below = mag + width;
+        const float *x = (*gx)[r];
+        const float *y = (*gy)[r];
+        for (unsigned int j = 1; j + 1 < width; j++) {
+          const float g = mag[j];
+          if (g <= lowerThreshold)
+            continue;
+          const float ax = std::fabs(x[j]);
+          const float ay = std::fabs(y[j]);
+          bool isMax;
+          if (ay < ax * tan22) // Horizontal gradient
+            isMax = g > mag[j-1] && g >= mag[j+1];
+          else if (ay > ax * tan67) // Vertical gradient
+            isMax = g > above[j] && g >= below[j];
+          else { // Diagonal gradient
+            unsigned int d = ((x[j] < 0) != (y[j] < 0)) ? 0 : 2;
+            isMax = g > above[j+1-d] && g > below[j-1+d];
+          }
+          if (isMax) {
+            if (g > upperThreshold) {
+              m[j] = vpCannyEdge;
+              stack.push_back(m + j);
+            }
+            else
+              m[j] = vpCannyCandidate;
+          }
+        }
+      }
+
+      cannyHysteresis(stack, stride, map + (size_t)(rowStart+1) * stride, map + (size_t)(rowEnd+1) * stride);
+    }
+  };
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Apply a filter to an image.
 
@@ -129,21 +697,19 @@ vpImageFilter::filter(const vpImage<double> &I,
 
 }
 
-#if defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100)
 /*!
   Apply the Canny edge operator on the image \e Isrc and return the resulting
-  image \e Ires.
+  image \e Ires. The same threshold is used for both the lower and the upper
+  hysteresis thresholds.
 
   The following example shows how to use the method:
 
   \code
-#include <visp3/core/vpConfig.h>
 #include <visp3/core/vpImage.h>
 #include <visp3/core/vpImageFilter.h>
 
 int main()
 {
-#if VISP_HAVE_OPENCV_VERSION >= 0x020100 // Canny uses OpenCV >=2.1.0
   // Constants for the Canny operator.
   const unsigned int gaussianFilterSize = 5;
   const double thresholdCanny = 15;
@@ -157,7 +723,6 @@ int main()
 
   //Apply the Canny edge operator and set the Icanny image.
   vpImageFilter::canny(Isrc, Icanny, gaussianFilterSize, thresholdCanny, apertureSobel);
-#endif
   return (0);
 }
   \endcode
@@ -169,6 +734,8 @@ int main()
   \param thresholdCanny : The threshold for the Canny operator. Only value
   greater than this value are marked as an edge).
   \param apertureSobel : Size of the mask for the Sobel operator (odd number).
+
+  \sa canny(const vpImageView<unsigned char> &, vpImage<unsigned char> &, unsigned int, double, double, unsigned int, unsigned int)
 */
 void
 vpImageFilter:: canny(const vpImage<unsigned char>& Isrc,
@@ -177,141 +744,281 @@ vpImageFilter:: canny(const vpImage<unsigned char>& Isrc,
                       const double thresholdCanny,
                       const unsigned int apertureSobel)
 {
-#if (VISP_HAVE_OPENCV_VERSION < 0x020408)
-  IplImage* img_ipl = NULL;
-  vpImageConvert::convert(Isrc, img_ipl);
-  IplImage* edges_ipl;
-  edges_ipl = cvCreateImage(cvSize(img_ipl->width, img_ipl->height), img_ipl->depth, img_ipl->nChannels);
+  canny(Isrc, Ires, gaussianFilterSize, thresholdCanny, thresholdCanny, apertureSobel, 1);
+}
 
-  cvSmooth(img_ipl, img_ipl, CV_GAUSSIAN, (int)gaussianFilterSize, (int)gaussianFilterSize, 0, 0);
-  cvCanny(img_ipl, edges_ipl, thresholdCanny, thresholdCanny, (int)apertureSobel);
+/*!
+  Apply the Canny edge operator on the image \e Isrc and return the resulting
+  image \e Ires.
 
-  vpImageConvert::convert(edges_ipl, Ires);
-  cvReleaseImage(&img_ipl);
-  cvReleaseImage(&edges_ipl);
-#else
-  cv::Mat img_cvmat, edges_cvmat;
-  vpImageConvert::convert(Isrc, img_cvmat);
-  cv::GaussianBlur(img_cvmat, img_cvmat, cv::Size((int)gaussianFilterSize, (int)gaussianFilterSize), 0, 0);
-  cv::Canny(img_cvmat, edges_cvmat, thresholdCanny, thresholdCanny, (int)apertureSobel);
-  vpImageConvert::convert(edges_cvmat, Ires);
-#endif
+  The image is first smoothed by a Gaussian filter which standard deviation
+  is computed from its size as sigma = 0.3*((size-1)/2 - 1) + 0.8. The
+  gradients are then computed with a Sobel operator, both filters being
+  applied by the SIMD separable passes used by gaussianBlur() and getGradX().
+  The pixels where the L1 norm of the gradient is maximal along the gradient
+  direction and greater than \e lowerThreshold are edge candidates. The ones
+  greater than \e upperThreshold are edges, as well as the candidates
+  connected to an edge. This hysteresis uses an explicit stack.
+
+  \param Isrc : Image, or view on a region of an image, to apply the Canny
+  edge detector to.
+  \param Ires : Filtered image (255 means an edge, 0 otherwise). It is only
+  reallocated if its size differs from the size of \e Isrc, and may be the
+  image viewed by \e Isrc.
+  \param gaussianFilterSize : The size of the mask of the Gaussian filter to
+  apply (an odd number). When lower than 3, the image is not smoothed.
+  \param lowerThreshold : The lower hysteresis threshold.
+  \param upperThreshold : The upper hysteresis threshold.
+  \param apertureSobel : Size of the mask for the Sobel operator (3, 5 or 7).
+  \param nbThreads : Number of threads; each one processes a horizontal band of the image.
+*/
+void
+vpImageFilter::canny(const vpImageView<unsigned char>& Isrc,
+                     vpImage<unsigned char>& Ires,
+                     unsigned int gaussianFilterSize,
+                     double lowerThreshold,
+                     double upperThreshold,
+                     unsigned int apertureSobel,
+                     unsigned int nbThreads)
+{
+  // Separable Sobel kernels: smoothing and derivative parts
+  static const float sobelSmooth3[2] = { 2.f, 1.f };
+  static const float sobelDerivative3[2] = { 0.f, 1.f };
+  static const float sobelSmooth5[3] = { 6.f, 4.f, 1.f };
+  static const float sobelDerivative5[3] = { 0.f, 2.f, 1.f };
+  static const float sobelSmooth7[4] = { 20.f, 15.f, 6.f, 1.f };
+  static const float sobelDerivative7[4] = { 0.f, 5.f, 4.f, 1.f };
+
+  const float *smooth, *derivative;
+  switch (apertureSobel) {
+  case 3: smooth = sobelSmooth3; derivative = sobelDerivative3; break;
+  case 5: smooth = sobelSmooth5; derivative = sobelDerivative5; break;
+  case 7: smooth = sobelSmooth7; derivative = sobelDerivative7; break;
+  default:
+    throw (vpImageException(vpImageException::incorrectInitializationError,
+                            "Bad Sobel aperture size %d, should be 3, 5 or 7", apertureSobel));
+  }
+  if (lowerThreshold > upperThreshold)
+    std::swap(lowerThreshold, upperThreshold);
+
+  const unsigned int height = Isrc.getHeight();
+  const unsigned int width = Isrc.getWidth();
+
+  vpImage<float> Iblur;
+  if (gaussianFilterSize >= 3) {
+    std::vector<float> fg((gaussianFilterSize+1)/2);
+    double sigma = 0.3 * ((gaussianFilterSize-1) * 0.5 - 1) + 0.8;
+    getGaussianKernel(&fg[0], gaussianFilterSize, sigma, true);
+    vpFilterPass<float> second(&fg[0], gaussianFilterSize, false, false);
+    separableFilter(Isrc, Iblur, vpFilterPass<float>(&fg[0], gaussianFilterSize, true, false), &second, nbThreads);
+  }
+  else {
+    Iblur.resize(height, width);
+    for (unsigned int i = 0; i < height; i++)
+      for (unsigned int j = 0; j < width; j++)
+        Iblur[i][j] = Isrc[i][j];
+  }
+
+  // Isrc is no more used and may be Ires
+  Ires.resize(height, width);
+  if (Isrc.getSize() == 0)
+    return;
+
+  vpImage<float> Igx, Igy;
+  vpFilterPass<float> derivativeX(derivative, apertureSobel, true, true);
+  vpFilterPass<float> derivativeY(derivative, apertureSobel, false, true);
+  separableFilter(Iblur, Igx, vpFilterPass<float>(smooth, apertureSobel, false, false), &derivativeX, nbThreads);
+  separableFilter(Iblur, Igy, vpFilterPass<float>(smooth, apertureSobel, true, false), &derivativeY, nbThreads);
+
+  std::vector<float> magnitude(Isrc.getSize());
+  vpCannyMagnitude magnitudeJob;
+  magnitudeJob.gx = &Igx;
+  magnitudeJob.gy = &Igy;
+  magnitudeJob.magnitude = &magnitude[0];
+  runInBands(magnitudeJob, height, nbThreads);
+
+  const unsigned int stride = width + 2;
+  std::vector<unsigned char> map((size_t)(height + 2) * stride, vpCannyNone);
+  vpCannyNonMaxSuppression nmsJob;
+  nmsJob.gx = &Igx;
+  nmsJob.gy = &Igy;
+  nmsJob.magnitude = &magnitude[0];
+  nmsJob.map = &map[0];
+  nmsJob.lowerThreshold = (float)lowerThreshold;
+  nmsJob.upperThreshold = (float)upperThreshold;
+  unsigned int nbBands = runInBands(nmsJob, height, nbThreads);
+
+  if (nbBands > 1) {
+    // Continue the hysteresis across the bands from the edges on their first and last rows
+    std::vector<unsigned char *> stack;
+    for (unsigned int b = 0; b < nbBands; b++) {
+      unsigned int rows[2];
+      rows[0] = (unsigned int)(((size_t)height * b) / nbBands);
+      rows[1] = (unsigned int)(((size_t)height * (b+1)) / nbBands) - 1;
+      for (unsigned int k = 0; k < 2; k++) {
+        unsigned char *m = &map[(size_t)(rows[k]+1) * stride + 1];
+        for (unsigned int j = 0; j < width; j++)
+          if (m[j] == vpCannyEdge)
+            stack.push_back(m + j);
+      }
+    }
+    cannyHysteresis(stack, stride, &map[0], &map[0] + map.size());
+  }
+
+  for (unsigned int i = 0; i < height; i++) {
+    const unsigned char *m = &map[(size_t)(i+1) * stride + 1];
+    unsigned char *dst = Ires[i];
+    for (unsigned int j = 0; j < width; j++)
+      dst[j] = (m[j] == vpCannyEdge) ? 255 : 0;
+  }
 }
-#endif
 
 /*!
   Apply a separable filter.
+
+  \param I : Image to filter.
+  \param GI : Filtered image.
+  \param filter : Coefficients of the symmetric filter: the central coefficient followed by the right ones.
+  \param size : Filter size. This value should be odd.
+  \param nbThreads : Number of threads used to filter the image.
  */
-void vpImageFilter::filter(const vpImage<unsigned char> &I, vpImage<double>& GI, const double *filter,unsigned  int size)
+void vpImageFilter::filter(const vpImageView<unsigned char> &I, vpImage<double>& GI, const double *filter, unsigned int size,
+                           unsigned int nbThreads)
 {
-  vpImage<double> GIx ;
-  filterX(I, GIx,filter,size);
-  filterY(GIx, GI,filter,size);
-  GIx.destroy();
+  vpFilterPass<double> second(filter, size, false, false);
+  separableFilter(I, GI, vpFilterPass<double>(filter, size, true, false), &second, nbThreads);
 }
 
 /*!
   Apply a separable filter.
+
+  \param I : Image to filter.
+  \param GI : Filtered image.
+  \param filter : Coefficients of the symmetric filter: the central coefficient followed by the right ones.
+  \param size : Filter size. This value should be odd.
+  \param nbThreads : Number of threads used to filter the image.
  */
-void vpImageFilter::filter(const vpImage<double> &I, vpImage<double>& GI, const double *filter,unsigned  int size)
+void vpImageFilter::filter(const vpImage<double> &I, vpImage<double>& GI, const double *filter, unsigned int size,
+                           unsigned int nbThreads)
 {
-  vpImage<double> GIx ;
-  filterX(I, GIx,filter,size);
-  filterY(GIx, GI,filter,size);
-  GIx.destroy();
+  vpFilterPass<double> second(filter, size, false, false);
+  separableFilter(I, GI, vpFilterPass<double>(filter, size, true, false), &second, nbThreads);
 }
 
-void vpImageFilter::filterX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter,unsigned  int size)
+/*!
+  Apply a separable filter with a float precision.
+
+  \param I : Image to filter.
+  \param GI : Filtered image.
+  \param filter : Coefficients of the symmetric filter: the central coefficient followed by the right ones.
+  \param size : Filter size. This value should be odd.
+  \param nbThreads : Number of threads used to filter the image.
+ */
+void vpImageFilter::filter(const vpImageView<unsigned char> &I, vpImage<float>& GI, const float *filter, unsigned int size,
+                           unsigned int nbThreads)
 {
-  dIx.resize(I.getHeight(),I.getWidth()) ;
-  for (unsigned int i=0 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < (size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterXLeftBorder(I,i,j,filter,size);
-      //dIx[i][j]=0;
-    }
-    for (unsigned int j=(size-1)/2 ; j < I.getWidth()-(size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterX(I,i,j,filter,size);
-    }
-    for (unsigned int j=I.getWidth()-(size-1)/2 ; j < I.getWidth() ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterXRightBorder(I,i,j,filter,size);
-      //dIx[i][j]=0;
-    }
-  }
+  vpFilterPass<float> second(filter, size, false, false);
+  separableFilter(I, GI, vpFilterPass<float>(filter, size, true, false), &second, nbThreads);
 }
-void vpImageFilter::filterX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter,unsigned  int size)
+
+/*!
+  Apply a separable filter with a float precision.
+
+  \param I : Image to filter.
+  \param GI : Filtered image.
+  \param filter : Coefficients of the symmetric filter: the central coefficient followed by the right ones.
+  \param size : Filter size. This value should be odd.
+  \param nbThreads : Number of threads used to filter the image.
+ */
+void vpImageFilter::filter(const vpImage<float> &I, vpImage<float>& GI, const float *filter, unsigned int size,
+                           unsigned int nbThreads)
 {
-  dIx.resize(I.getHeight(),I.getWidth()) ;
-  for (unsigned int i=0 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < (size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterXLeftBorder(I,i,j,filter,size);
-      //dIx[i][j]=0;
-    }
-    for (unsigned int j=(size-1)/2 ; j < I.getWidth()-(size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterX(I,i,j,filter,size);
-    }
-    for (unsigned int j=I.getWidth()-(size-1)/2 ; j < I.getWidth() ; j++)
-    {
-      dIx[i][j]=vpImageFilter::filterXRightBorder(I,i,j,filter,size);
-      //dIx[i][j]=0;
-    }
-  }
+  vpFilterPass<float> second(filter, size, false, false);
+  separableFilter(I, GI, vpFilterPass<float>(filter, size, true, false), &second, nbThreads);
 }
-void vpImageFilter::filterY(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *filter,unsigned  int size)
+
+/*!
+  Apply a symmetric filter along the rows of an image. The borders are mirrored.
+
+  \param I : Image to filter.
+  \param dIx : Filtered image.
+  \param filter : Coefficients of the filter: the central coefficient followed by the right ones.
+  \param size : Filter size. This value should be odd.
+  \param nbThreads : Number of threads used to filter the image.
+ */
+void vpImageFilter::filterX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter, unsigned int size,
+                            unsigned int nbThreads)
 {
-  dIy.resize(I.getHeight(),I.getWidth()) ;
-  for (unsigned int i=0 ; i < (size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterYTopBorder(I,i,j,filter,size);
-    }
-  }
-  for (unsigned int i=(size-1)/2 ; i < I.getHeight()-(size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterY(I,i,j,filter,size);
-    }
-  }
-  for (unsigned int i=I.getHeight()-(size-1)/2 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterYBottomBorder(I,i,j,filter,size);
-    }
-  }
+  separableFilter(I, dIx, vpFilterPass<double>(filter, size, true, false), (const vpFilterPass<double> *)NULL, nbThreads);
 }
-void vpImageFilter::filterY(const vpImage<double> &I, vpImage<double>& dIy, const double *filter,unsigned  int size)
+
+/*!
+  \overload
+ */
+void vpImageFilter::filterX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter, unsigned int size,
+                            unsigned int nbThreads)
 {
-  dIy.resize(I.getHeight(),I.getWidth()) ;
-  for (unsigned int i=0 ; i < (size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterYTopBorder(I,i,j,filter,size);
-    }
-  }
-  for (unsigned int i=(size-1)/2 ; i < I.getHeight()-(size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterY(I,i,j,filter,size);
-    }
-  }
-  for (unsigned int i=I.getHeight()-(size-1)/2 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::filterYBottomBorder(I,i,j,filter,size);
-    }
-  }
+  separableFilter(I, dIx, vpFilterPass<double>(filter, size, true, false), (const vpFilterPass<double> *)NULL, nbThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::filterX(const vpImage<unsigned char> &I, vpImage<float>& dIx, const float *filter, unsigned int size,
+                            unsigned int nbThreads)
+{
+  separableFilter(I, dIx, vpFilterPass<float>(filter, size, true, false), (const vpFilterPass<float> *)NULL, nbThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::filterX(const vpImage<float> &I, vpImage<float>& dIx, const float *filter, unsigned int size,
+                            unsigned int nbThreads)
+{
+  separableFilter(I, dIx, vpFilterPass<float>(filter, size, true, false), (const vpFilterPass<float> *)NULL, nbThreads);
+}
+
+/*!
+  Apply a symmetric filter along the columns of an image. The borders are mirrored.
+
+  \param I : Image to filter.
+  \param dIy : Filtered image.
+  \param filter : Coefficients of the filter: the central coefficient followed by the bottom ones.
+  \param size : Filter size. This value should be odd.
+  \param nbThreads : Number of threads used to filter the image.
+ */
+void vpImageFilter::filterY(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *filter, unsigned int size,
+                            unsigned int nbThreads)
+{
+  separableFilter(I, dIy, vpFilterPass<double>(filter, size, false, false), (const vpFilterPass<double> *)NULL, nbThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::filterY(const vpImage<double> &I, vpImage<double>& dIy, const double *filter, unsigned int size,
+                            unsigned int nbThreads)
+{
+  separableFilter(I, dIy, vpFilterPass<double>(filter, size, false, false), (const vpFilterPass<double> *)NULL, nbThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::filterY(const vpImage<unsigned char> &I, vpImage<float>& dIy, const float *filter, unsigned int size,
+                            unsigned int nbThreads)
+{
+  separableFilter(I, dIy, vpFilterPass<float>(filter, size, false, false), (const vpFilterPass<float> *)NULL, nbThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::filterY(const vpImage<float> &I, vpImage<float>& dIy, const float *filter, unsigned int size,
+                            unsigned int nbThreads)
+{
+  separableFilter(I, dIy, vpFilterPass<float>(filter, size, false, false), (const vpFilterPass<float> *)NULL, nbThreads);
 }
 
 /*!
@@ -321,17 +1028,15 @@ void vpImageFilter::filterY(const vpImage<double> &I, vpImage<double>& dIy, cons
   \param size : Filter size. This value should be odd.
   \param sigma : Gaussian standard deviation. If it is equal to zero or negative, it is computed from filter size as sigma = (size-1)/6.
   \param normalize : Flag indicating whether to normalize the filter coefficients or not.
+  \param nbThreads : Number of threads used to filter the image.
 
  */
-void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<double>& GI, unsigned int size, double sigma, bool normalize)
+void vpImageFilter::gaussianBlur(const vpImageView<unsigned char> &I, vpImage<double>& GI, unsigned int size, double sigma, bool normalize,
+                                 unsigned int nbThreads)
 {
-  double *fg=new double[(size+1)/2] ;
-  vpImageFilter::getGaussianKernel(fg, size, sigma, normalize) ;
-  vpImage<double> GIx ;
-  vpImageFilter::filterX(I, GIx,fg,size);
-  vpImageFilter::filterY(GIx, GI,fg,size);
-  GIx.destroy();
-  delete[] fg;
+  std::vector<double> fg((size+1)/2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, normalize) ;
+  vpImageFilter::filter(I, GI, &fg[0], size, nbThreads);
 }
 
 /*!
@@ -341,17 +1046,73 @@ void vpImageFilter::gaussianBlur(const vpImage<unsigned char> &I, vpImage<double
   \param size : Filter size. This value should be odd.
   \param sigma : Gaussian standard deviation. If it is equal to zero or negative, it is computed from filter size as sigma = (size-1)/6.
   \param normalize : Flag indicating whether to normalize the filter coefficients or not.
+  \param nbThreads : Number of threads used to filter the image.
 
  */
-void vpImageFilter::gaussianBlur(const vpImage<double> &I, vpImage<double>& GI, unsigned int size, double sigma, bool normalize)
+void vpImageFilter::gaussianBlur(const vpImage<double> &I, vpImage<double>& GI, unsigned int size, double sigma, bool normalize,
+                                 unsigned int nbThreads)
 {
-  double *fg=new double[(size+1)/2] ;
-  vpImageFilter::getGaussianKernel(fg, size, sigma, normalize) ;
-  vpImage<double> GIx ;
-  vpImageFilter::filterX(I, GIx,fg,size);
-  vpImageFilter::filterY(GIx, GI,fg,size);
-  GIx.destroy();
-  delete[] fg;
+  std::vector<double> fg((size+1)/2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, normalize) ;
+  vpImageFilter::filter(I, GI, &fg[0], size, nbThreads);
+}
+
+/*!
+  Apply a Gaussian blur to an image with a float precision.
+  \param I : Input image.
+  \param GI : Filtered image.
+  \param size : Filter size. This value should be odd.
+  \param sigma : Gaussian standard deviation. If it is equal to zero or negative, it is computed from filter size as sigma = (size-1)/6.
+  \param normalize : Flag indicating whether to normalize the filter coefficients or not.
+  \param nbThreads : Number of threads used to filter the image.
+
+ */
+void vpImageFilter::gaussianBlur(const vpImageView<unsigned char> &I, vpImage<float>& GI, unsigned int size, double sigma, bool normalize,
+                                 unsigned int nbThreads)
+{
+  std::vector<float> fg((size+1)/2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, normalize) ;
+  vpImageFilter::filter(I, GI, &fg[0], size, nbThreads);
+}
+
+/*!
+  Apply a Gaussian blur to a float image.
+  \param I : Input float image.
+  \param GI : Filtered image.
+  \param size : Filter size. This value should be odd.
+  \param sigma : Gaussian standard deviation. If it is equal to zero or negative, it is computed from filter size as sigma = (size-1)/6.
+  \param normalize : Flag indicating whether to normalize the filter coefficients or not.
+  \param nbThreads : Number of threads used to filter the image.
+
+ */
+void vpImageFilter::gaussianBlur(const vpImage<float> &I, vpImage<float>& GI, unsigned int size, double sigma, bool normalize,
+                                 unsigned int nbThreads)
+{
+  std::vector<float> fg((size+1)/2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, normalize) ;
+  vpImageFilter::filter(I, GI, &fg[0], size, nbThreads);
+}
+
+/*!
+  Apply a Gaussian blur to an image and store the result as a fixed-point
+  image: a blurred value \f$ v \f$ is stored as \f$ round(v \; 2^{fixedPointBits}) \f$.
+  The computation is done with a float precision.
+
+  \param I : Input image.
+  \param GI : Filtered fixed-point image.
+  \param size : Filter size. This value should be odd.
+  \param sigma : Gaussian standard deviation. If it is equal to zero or negative, it is computed from filter size as sigma = (size-1)/6.
+  \param normalize : Flag indicating whether to normalize the filter coefficients or not.
+  \param nbThreads : Number of threads used to filter the image.
+
+ */
+void vpImageFilter::gaussianBlur(const vpImageView<unsigned char> &I, vpImage<short>& GI, unsigned int size, double sigma, bool normalize,
+                                 unsigned int nbThreads)
+{
+  std::vector<float> fg((size+1)/2);
+  vpImageFilter::getGaussianKernel(&fg[0], size, sigma, normalize) ;
+  vpFilterPass<float> second(&fg[0], size, false, false);
+  separableFilter(I, GI, vpFilterPass<float>(&fg[0], size, true, false), &second, nbThreads);
 }
 
 /*!
@@ -435,150 +1196,202 @@ void vpImageFilter::getGaussianDerivativeKernel(double *filter, unsigned int siz
   }
 }
 
+/*!
+  Return the coefficients of a Gaussian filter as float values.
 
-void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<double>& dIx)
+  \param filter : Pointer to the filter kernel that should refer to a (size+1)/2 array.
+  \param size : Filter size. This value should be odd.
+  \param sigma : Gaussian standard deviation. If it is equal to zero or negative, it is computed from filter size as sigma = (size-1)/6.
+  \param normalize : Flag indicating whether to normalize the filter coefficients or not.
+
+  \sa getGaussianKernel(double *, unsigned int, double, bool)
+*/
+void vpImageFilter::getGaussianKernel(float *filter, unsigned int size, double sigma, bool normalize)
 {
-  dIx.resize(I.getHeight(),I.getWidth()) ;
-  //dIx=0;
-  for (unsigned int i=0 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < 3 ; j++)
-    {
-      dIx[i][j]=0;
-    }
-    for (unsigned int j=3 ; j < I.getWidth()-3 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::derivativeFilterX(I,i,j);
-    }
-    for (unsigned int j=I.getWidth()-3 ; j < I.getWidth() ; j++)
-    {
-      dIx[i][j]=0;
-    }
-  }
+  std::vector<double> f((size+1)/2);
+  getGaussianKernel(&f[0], size, sigma, normalize);
+  for (size_t i = 0; i < f.size(); i++)
+    filter[i] = (float)f[i];
 }
 
-void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<double>& dIy)
+/*!
+  Return the coefficients of a Gaussian derivative filter as float values.
+
+  \param filter : Pointer to the filter kernel that should refer to a (size+1)/2 array.
+  \param size : Filter size. This value should be odd.
+  \param sigma : Gaussian standard deviation. If it is equal to zero or negative, it is computed from filter size as sigma = (size-1)/6.
+  \param normalize : Flag indicating whether to normalize the filter coefficients or not.
+
+  \sa getGaussianDerivativeKernel(double *, unsigned int, double, bool)
+*/
+void vpImageFilter::getGaussianDerivativeKernel(float *filter, unsigned int size, double sigma, bool normalize)
 {
-  dIy.resize(I.getHeight(),I.getWidth()) ;
-  //dIy=0;
-  for (unsigned int i=0 ; i < 3 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=0;
-    }
-  }
-  for (unsigned int i=3 ; i < I.getHeight()-3 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::derivativeFilterY(I,i,j);
-    }
-  }
-  for (unsigned int i=I.getHeight()-3 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=0;
-    }
-  }
+  std::vector<double> f((size+1)/2);
+  getGaussianDerivativeKernel(&f[0], size, sigma, normalize);
+  for (size_t i = 0; i < f.size(); i++)
+    filter[i] = (float)f[i];
 }
 
-void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter,unsigned  int size)
+/*!
+  Compute the gradient along X with the 7 taps filter of derivativeFilterX().
+  The 3 pixels wide left and right borders are set to zero.
+
+  \param I : Input image.
+  \param dIx : Gradient along X.
+  \param nbThreads : Number of threads used to filter the image.
+ */
+void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<double>& dIx, unsigned int nbThreads)
 {
-  dIx.resize(I.getHeight(),I.getWidth()) ;
-  //#pragma omp parallel for
-  for (unsigned int i=0 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < (size-1)/2 ; j++)
-    {
-      dIx[i][j]=0;
-    }
-    for (unsigned int j=(size-1)/2 ; j < I.getWidth()-(size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::derivativeFilterX(I,i,j,filter,size);
-    }
-    for (unsigned int j=I.getWidth()-(size-1)/2 ; j < I.getWidth() ; j++)
-    {
-      dIx[i][j]=0;
-    }
-  }
+  separableFilter(I, dIx, vpFilterPass<double>(derivative7Double, 7, true, true, 8418.),
+                  (const vpFilterPass<double> *)NULL, nbThreads);
 }
-void vpImageFilter::getGradX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter,unsigned  int size)
+
+/*!
+  \overload
+ */
+void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<float>& dIx, unsigned int nbThreads)
 {
-  dIx.resize(I.getHeight(),I.getWidth()) ;
-  //dIx=0;
-  for (unsigned int i=0 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < (size-1)/2 ; j++)
-    {
-      dIx[i][j]=0;
-    }
-    for (unsigned int j=(size-1)/2 ; j < I.getWidth()-(size-1)/2 ; j++)
-    {
-      dIx[i][j]=vpImageFilter::derivativeFilterX(I,i,j,filter,size);
-    }
-    for (unsigned int j=I.getWidth()-(size-1)/2 ; j < I.getWidth() ; j++)
-    {
-      dIx[i][j]=0;
-    }
-  }
+  separableFilter(I, dIx, vpFilterPass<float>(derivative7Float, 7, true, true, 8418.f),
+                  (const vpFilterPass<float> *)NULL, nbThreads);
 }
 
-void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *filter,unsigned  int size)
+/*!
+  Compute the gradient along X with the 7 taps filter of derivativeFilterX()
+  and store it as a fixed-point image: a gradient \f$ g \f$ is stored as
+  \f$ round(g \; 2^{fixedPointBits}) \f$.
+
+  \param I : Input image.
+  \param dIx : Gradient along X.
+  \param nbThreads : Number of threads used to filter the image.
+ */
+void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<short>& dIx, unsigned int nbThreads)
 {
-  dIy.resize(I.getHeight(),I.getWidth()) ;
-  //#pragma omp parallel for
-  for (unsigned int i=0 ; i < (size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=0;
-    }
-  }
-  //#pragma omp parallel for
-  for (unsigned int i=(size-1)/2 ; i < I.getHeight()-(size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::derivativeFilterY(I,i,j,filter,size);
-    }
-  }
-  //#pragma omp parallel for
-  for (unsigned int i=I.getHeight()-(size-1)/2 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=0;
-    }
-  }
+  separableFilter(I, dIx, vpFilterPass<float>(derivative7Float, 7, true, true, 8418.f),
+                  (const vpFilterPass<float> *)NULL, nbThreads);
+}
+
+/*!
+  Compute the gradient along Y with the 7 taps filter of derivativeFilterY().
+  The 3 pixels high top and bottom borders are set to zero.
+
+  \param I : Input image.
+  \param dIy : Gradient along Y.
+  \param nbThreads : Number of threads used to filter the image.
+ */
+void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<double>& dIy, unsigned int nbThreads)
+{
+  separableFilter(I, dIy, vpFilterPass<double>(derivative7Double, 7, false, true, 8418.),
+                  (const vpFilterPass<double> *)NULL, nbThreads);
 }
 
-void vpImageFilter::getGradY(const vpImage<double> &I, vpImage<double>& dIy, const double *filter,unsigned  int size)
+/*!
+  \overload
+ */
+void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<float>& dIy, unsigned int nbThreads)
 {
-  dIy.resize(I.getHeight(),I.getWidth()) ;
-  //dIy=0;
-  for (unsigned int i=0 ; i < (size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=0;
-    }
-  }
-  for (unsigned int i=(size-1)/2 ; i < I.getHeight()-(size-1)/2 ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=vpImageFilter::derivativeFilterY(I,i,j,filter,size);
-    }
-  }
-  for (unsigned int i=I.getHeight()-(size-1)/2 ; i < I.getHeight() ; i++)
-  {
-    for (unsigned int j=0 ; j < I.getWidth() ; j++)
-    {
-      dIy[i][j]=0;
-    }
-  }
+  separableFilter(I, dIy, vpFilterPass<float>(derivative7Float, 7, false, true, 8418.f),
+                  (const vpFilterPass<float> *)NULL, nbThreads);
+}
+
+/*!
+  Compute the gradient along Y with the 7 taps filter of derivativeFilterY()
+  and store it as a fixed-point image: a gradient \f$ g \f$ is stored as
+  \f$ round(g \; 2^{fixedPointBits}) \f$.
+
+  \param I : Input image.
+  \param dIy : Gradient along Y.
+  \param nbThreads : Number of threads used to filter the image.
+ */
+void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<short>& dIy, unsigned int nbThreads)
+{
+  separableFilter(I, dIy, vpFilterPass<float>(derivative7Float, 7, false, true, 8418.f),
+                  (const vpFilterPass<float> *)NULL, nbThreads);
+}
+
+/*!
+  Compute the gradient along X with a derivative filter. The (size-1)/2
+  pixels wide left and right borders are set to zero.
+
+  \param I : Input image.
+  \param dIx : Gradient along X.
+  \param filter : Coefficients of the filter computed using vpImageFilter::getGaussianDerivativeKernel().
+  \param size : Filter size. This value should be odd.
+  \param nbThreads : Number of threads used to filter the image.
+ */
+void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *filter, unsigned int size,
+                             unsigned int nbThreads)
+{
+  separableFilter(I, dIx, vpFilterPass<double>(filter, size, true, true), (const vpFilterPass<double> *)NULL, nbThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::getGradX(const vpImage<double> &I, vpImage<double>& dIx, const double *filter, unsigned int size,
+                             unsigned int nbThreads)
+{
+  separableFilter(I, dIx, vpFilterPass<double>(filter, size, true, true), (const vpFilterPass<double> *)NULL, nbThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::getGradX(const vpImage<unsigned char> &I, vpImage<float>& dIx, const float *filter, unsigned int size,
+                             unsigned int nbThreads)
+{
+  separableFilter(I, dIx, vpFilterPass<float>(filter, size, true, true), (const vpFilterPass<float> *)NULL, nbThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::getGradX(const vpImage<float> &I, vpImage<float>& dIx, const float *filter, unsigned int size,
+                             unsigned int nbThreads)
+{
+  separableFilter(I, dIx, vpFilterPass<float>(filter, size, true, true), (const vpFilterPass<float> *)NULL, nbThreads);
+}
+
+/*!
+  Compute the gradient along Y with a derivative filter. The (size-1)/2
+  pixels high top and bottom borders are set to zero.
+
+  \param I : Input image.
+  \param dIy : Gradient along Y.
+  \param filter : Coefficients of the filter computed using vpImageFilter::getGaussianDerivativeKernel().
+  \param size : Filter size. This value should be odd.
+  \param nbThreads : Number of threads used to filter the image.
+ */
+void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *filter, unsigned int size,
+                             unsigned int nbThreads)
+{
+  separableFilter(I, dIy, vpFilterPass<double>(filter, size, false, true), (const vpFilterPass<double> *)NULL, nbThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::getGradY(const vpImage<double> &I, vpImage<double>& dIy, const double *filter, unsigned int size,
+                             unsigned int nbThreads)
+{
+  separableFilter(I, dIy, vpFilterPass<double>(filter, size, false, true), (const vpFilterPass<double> *)NULL, nbThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::getGradY(const vpImage<unsigned char> &I, vpImage<float>& dIy, const float *filter, unsigned int size,
+                             unsigned int nbThreads)
+{
+  separableFilter(I, dIy, vpFilterPass<float>(filter, size, false, true), (const vpFilterPass<float> *)NULL, nbThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::getGradY(const vpImage<float> &I, vpImage<float>& dIy, const float *filter, unsigned int size,
+                             unsigned int nbThreads)
+{
+  separableFilter(I, dIy, vpFilterPass<float>(filter, size, false, true), (const vpFilterPass<float> *)NULL, nbThreads);
 }
 
 /*!
@@ -588,12 +1401,35 @@ void vpImageFilter::getGradY(const vpImage<double> &I, vpImage<double>& dIy, con
    \param gaussianKernel : Gaussian kernel which values should be computed using vpImageFilter::getGaussianKernel().
    \param gaussianDerivativeKernel : Gaussian derivative kernel which values should be computed using vpImageFilter::getGaussianDerivativeKernel().
    \param size : Size of the Gaussian and Gaussian derivative kernels.
+   \param nbThreads : Number of threads used to filter the image.
+ */
+void vpImageFilter::getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *gaussianKernel,
+                                    const double *gaussianDerivativeKernel, unsigned int size, unsigned int nbThreads)
+{
+  vpFilterPass<double> second(gaussianDerivativeKernel, size, true, true);
+  separableFilter(I, dIx, vpFilterPass<double>(gaussianKernel, size, false, false), &second, nbThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<float>& dIx, const float *gaussianKernel,
+                                    const float *gaussianDerivativeKernel, unsigned int size, unsigned int nbThreads)
+{
+  vpFilterPass<float> second(gaussianDerivativeKernel, size, true, true);
+  separableFilter(I, dIx, vpFilterPass<float>(gaussianKernel, size, false, false), &second, nbThreads);
+}
+
+/*!
+  \overload
+
+  The gradient \f$ g \f$ is stored as \f$ round(g \; 2^{fixedPointBits}) \f$.
  */
-void vpImageFilter::getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<double>& dIx, const double *gaussianKernel, const double *gaussianDerivativeKernel, unsigned  int size)
+void vpImageFilter::getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<short>& dIx, const float *gaussianKernel,
+                                    const float *gaussianDerivativeKernel, unsigned int size, unsigned int nbThreads)
 {
-  vpImage<double> GIy;
-  vpImageFilter::filterY(I,  GIy, gaussianKernel, size);
-  vpImageFilter::getGradX(GIy, dIx, gaussianDerivativeKernel, size);
+  vpFilterPass<float> second(gaussianDerivativeKernel, size, true, true);
+  separableFilter(I, dIx, vpFilterPass<float>(gaussianKernel, size, false, false), &second, nbThreads);
 }
 
 /*!
@@ -603,12 +1439,35 @@ void vpImageFilter::getGradXGauss2D(const vpImage<unsigned char> &I, vpImage<dou
    \param gaussianKernel : Gaussian kernel which values should be computed using vpImageFilter::getGaussianKernel().
    \param gaussianDerivativeKernel : Gaussian derivative kernel which values should be computed using vpImageFilter::getGaussianDerivativeKernel().
    \param size : Size of the Gaussian and Gaussian derivative kernels.
+   \param nbThreads : Number of threads used to filter the image.
+ */
+void vpImageFilter::getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *gaussianKernel,
+                                    const double *gaussianDerivativeKernel, unsigned int size, unsigned int nbThreads)
+{
+  vpFilterPass<double> second(gaussianDerivativeKernel, size, false, true);
+  separableFilter(I, dIy, vpFilterPass<double>(gaussianKernel, size, true, false), &second, nbThreads);
+}
+
+/*!
+  \overload
+ */
+void vpImageFilter::getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<float>& dIy, const float *gaussianKernel,
+                                    const float *gaussianDerivativeKernel, unsigned int size, unsigned int nbThreads)
+{
+  vpFilterPass<float> second(gaussianDerivativeKernel, size, false, true);
+  separableFilter(I, dIy, vpFilterPass<float>(gaussianKernel, size, true, false), &second, nbThreads);
+}
+
+/*!
+  \overload
+
+  The gradient \f$ g \f$ is stored as \f$ round(g \; 2^{fixedPointBits}) \f$.
  */
-void vpImageFilter::getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<double>& dIy, const double *gaussianKernel, const double *gaussianDerivativeKernel,unsigned  int size)
+void vpImageFilter::getGradYGauss2D(const vpImage<unsigned char> &I, vpImage<short>& dIy, const float *gaussianKernel,
+                                    const float *gaussianDerivativeKernel, unsigned int size, unsigned int nbThreads)
 {
-  vpImage<double> GIx;
-  vpImageFilter::filterX(I,  GIx, gaussianKernel, size);
-  vpImageFilter::getGradY(GIx, dIy, gaussianDerivativeKernel, size);
+  vpFilterPass<float> second(gaussianDerivativeKernel, size, false, true);
+  separableFilter(I, dIy, vpFilterPass<float>(gaussianKernel, size, true, false), &second, nbThreads);
 }
 
 //operation pour pyramide gaussienne
@@ -661,14 +1520,44 @@ void vpImageFilter::getGaussXPyramidal(const vpImage<unsigned char> &I, vpImage<
   unsigned int w = I.getWidth()/2;
 
   GI.resize(I.getHeight(), w) ;
+  if (w == 0)
+    return;
+#if VISP_HAVE_SSE2
+  const __m128i mask = _mm_set1_epi16(0xFF);
+#endif
   for (unsigned int i=0 ; i < I.getHeight() ; i++)
   {
-    GI[i][0]=I[i][0];
-    for (unsigned int j=1 ; j < w-1 ; j++)
+    const unsigned char *src = I[i];
+    unsigned char *dst = GI[i];
+    dst[0]=src[0];
+    unsigned int j=1;
+#if VISP_HAVE_SSE2
+    // Eight outputs per iteration from src[2j-2] to src[2j+21]. The even and
+    // odd pixels are split in 16 bits lanes, the taps are then lane shifts.
+    for ( ; j+8 < w && 2*j+22 <= I.getWidth() ; j += 8)
     {
-      GI[i][j]=vpImageFilter::filterGaussXPyramidal(I,i,2*j);
+      const unsigned char *s = src + 2*j - 2;
+      const __m128i v0 = _mm_loadu_si128((const __m128i *)s);
+      const __m128i v1 = _mm_loadl_epi64((const __m128i *)(s + 16));
+      const __m128i e0 = _mm_and_si128(v0, mask);
+      const __m128i o0 = _mm_srli_epi16(v0, 8);
+      const __m128i e1 = _mm_and_si128(v1, mask);
+      const __m128i o1 = _mm_srli_epi16(v1, 8);
+      const __m128i c = _mm_or_si128(_mm_srli_si128(e0, 2), _mm_slli_si128(e1, 14));
+      const __m128i e2 = _mm_or_si128(_mm_srli_si128(e0, 4), _mm_slli_si128(e1, 12));
+      const __m128i o2 = _mm_or_si128(_mm_srli_si128(o0, 2), _mm_slli_si128(o1, 14));
+      __m128i sum = _mm_add_epi16(_mm_add_epi16(e0, e2), _mm_slli_epi16(_mm_add_epi16(o0, o2), 2));
+      sum = _mm_add_epi16(sum, _mm_add_epi16(_mm_slli_epi16(c, 2), _mm_slli_epi16(c, 1)));
+      sum = _mm_srli_epi16(sum, 4);
+      _mm_storel_epi64((__m128i *)(dst + j), _mm_packus_epi16(sum, sum));
     }
-    GI[i][w-1]=I[i][2*w-1];
+#endif
+    for ( ; j < w-1 ; j++)
+    {
+      const unsigned char *s = src + 2*j;
+      dst[j] = (unsigned char)((s[-2] + 4*(s[-1] + s[1]) + 6*s[0] + s[2]) >> 4);
+    }
+    dst[w-1]=src[2*w-1];
   }
 
 #endif
@@ -690,17 +1579,48 @@ void vpImageFilter::getGaussYPyramidal(const vpImage<unsigned char> &I, vpImage<
 
 #else
   unsigned int h = I.getHeight()/2;
-
-  GI.resize(h, I.getWidth()) ;
-  for (unsigned int j=0 ; j < I.getWidth() ; j++)
+  unsigned int width = I.getWidth();
+
+  GI.resize(h, width) ;
+  if (h == 0 || width == 0)
+    return;
+  memcpy(GI[0], I[0], width);
+#if VISP_HAVE_SSE2
+  const __m128i zero = _mm_setzero_si128();
+#endif
+  for (unsigned int i=1 ; i < h-1 ; i++)
   {
-    GI[0][j]=I[0][j];
-    for (unsigned int i=1 ; i < h-1 ; i++)
+    const unsigned char *r0 = I[2*i-2], *r1 = I[2*i-1], *r2 = I[2*i], *r3 = I[2*i+1], *r4 = I[2*i+2];
+    unsigned char *dst = GI[i];
+    unsigned int j=0;
+#if VISP_HAVE_SSE2
+    for ( ; j+16 <= width ; j += 16)
     {
-         GI[i][j]=vpImageFilter::filterGaussYPyramidal(I,2*i,j);
+      const __m128i a = _mm_loadu_si128((const __m128i *)(r0 + j));
+      const __m128i b = _mm_loadu_si128((const __m128i *)(r1 + j));
+      const __m128i c = _mm_loadu_si128((const __m128i *)(r2 + j));
+      const __m128i d = _mm_loadu_si128((const __m128i *)(r3 + j));
+      const __m128i e = _mm_loadu_si128((const __m128i *)(r4 + j));
+
+      __m128i ae = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(e, zero));
+      __m128i bd = _mm_add_epi16(_mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(d, zero));
+      __m128i cc = _mm_unpacklo_epi8(c, zero);
+      __m128i lo = _mm_add_epi16(_mm_add_epi16(ae, _mm_slli_epi16(bd, 2)),
+                                 _mm_add_epi16(_mm_slli_epi16(cc, 2), _mm_slli_epi16(cc, 1)));
+
+      ae = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(e, zero));
+      bd = _mm_add_epi16(_mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi8(d, zero));
+      cc = _mm_unpackhi_epi8(c, zero);
+      __m128i hi = _mm_add_epi16(_mm_add_epi16(ae, _mm_slli_epi16(bd, 2)),
+                                 _mm_add_epi16(_mm_slli_epi16(cc, 2), _mm_slli_epi16(cc, 1)));
+
+      _mm_storeu_si128((__m128i *)(dst + j), _mm_packus_epi16(_mm_srli_epi16(lo, 4), _mm_srli_epi16(hi, 4)));
     }
-    GI[h-1][j]=I[2*h-1][j];
+#endif
+    for ( ; j < width ; j++)
+      dst[j] = (unsigned char)((r0[j] + 4*(r1[j] + r3[j]) + 6*r2[j] + r4[j]) >> 4);
   }
+  memcpy(GI[h-1], I[2*h-1], width);
 #endif
 }
 
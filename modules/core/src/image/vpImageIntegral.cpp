@@ -0,0 +1,266 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Integral and squared integral images.
+ *
+ *****************************************************************************/
+
+#include <math.h>
+#include <string.h>
+
+#include <visp3/core/vpImageIntegral.h>
+#include <visp3/core/vpImageException.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Set out[k] = prev[k] + carry + src[0] + ... + src[k] for k < n
+  void integralRow(const unsigned char *src, const unsigned int *prev, unsigned int *out,
+                   unsigned int n, unsigned int carry)
+  {
+    unsigned int k = 0;
+#if VISP_HAVE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    __m128i c = _mm_set1_epi32((int)carry);
+    for (; k + 16 <= n; k += 16) {
+      const __m128i v = _mm_loadu_si128((const __m128i *)(src + k));
+      const __m128i lo = _mm_unpacklo_epi8(v, zero);
+      const __m128i hi = _mm_unpackhi_epi8(v, zero);
+      __m128i x[4] = { _mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+                       _mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero) };
+      for (unsigned int l = 0; l < 4; l++) {
+        // Prefix sum of 4 values
+        __m128i p = _mm_add_epi32(x[l], _mm_slli_si128(x[l], 4));
+        p = _mm_add_epi32(p, _mm_slli_si128(p, 8));
+        p = _mm_add_epi32(p, c);
+        c = _mm_shuffle_epi32(p, 0xff);
+        _mm_storeu_si128((__m128i *)(out + k + 4*l),
+                         _mm_add_epi32(p, _mm_loadu_si128((const __m128i *)(prev + k + 4*l))));
+      }
+    }
+    carry = (unsigned int)_mm_cvtsi128_si32(c);
+#endif
+    for (; k < n; k++) {
+      carry += src[k];
+      out[k] = prev[k] + carry;
+    }
+  }
+
+  // Set out[k] = prev[k] + carry + src[0]^2 + ... + src[k]^2 for k < n
+  void squaredIntegralRow(const unsigned char *src, const uint64_t *prev, uint64_t *out,
+                          unsigned int n, uint64_t carry)
+  {
+    unsigned int k = 0;
+#if VISP_HAVE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    __m128i c = _mm_loadl_epi64((const __m128i *)&carry);
+    c = _mm_unpacklo_epi64(c, c);
+    for (; k + 16 <= n; k += 16) {
+      const __m128i v = _mm_loadu_si128((const __m128i *)(src + k));
+      // The squares of 8 bits values fit in 16 bits
+      __m128i lo = _mm_unpacklo_epi8(v, zero);
+      __m128i hi = _mm_unpackhi_epi8(v, zero);
+      lo = _mm_mullo_epi16(lo, lo);
+      hi = _mm_mullo_epi16(hi, hi);
+      __m128i x[4] = { _mm_unpacklo_epi16(lo, zero), _mm_unpackhi_epi16(lo, zero),
+                       _mm_unpacklo_epi16(hi, zero), _mm_unpackhi_epi16(hi, zero) };
+      for (unsigned int l = 0; l < 4; l++) {
+        // Prefix sum of 4 values in 32 bits, then widened to 64 bits
+        __m128i p = _mm_add_epi32(x[l], _mm_slli_si128(x[l], 4));
+        p = _mm_add_epi32(p, _mm_slli_si128(p, 8));
+        const __m128i p0 = _mm_add_epi64(_mm_unpacklo_epi32(p, zero), c);
+        const __m128i p1 = _mm_add_epi64(_mm_unpackhi_epi32(p, zero), c);
+        c = _mm_unpackhi_epi64(p1, p1);
+        uint64_t *o = out + k + 4*l;
+        const uint64_t *q = prev + k + 4*l;
+        _mm_storeu_si128((__m128i *)o, _mm_add_epi64(p0, _mm_loadu_si128((const __m128i *)q)));
+        _mm_storeu_si128((__m128i *)(o + 2), _mm_add_epi64(p1, _mm_loadu_si128((const __m128i *)(q + 2))));
+      }
+    }
+    _mm_storel_epi64((__m128i *)&carry, c);
+#endif
+    for (; k < n; k++) {
+      carry += (uint64_t)(src[k] * src[k]);
+      out[k] = prev[k] + carry;
+    }
+  }
+
+  // Add delta[k] to row[k] for k < n
+  template<typename Type>
+  void addDelta(Type *row, const Type *delta, unsigned int n)
+  {
+    for (unsigned int k = 0; k < n; k++)
+      row[k] += delta[k];
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Default constructor. Call build() to compute the tables.
+*/
+vpImageIntegral::vpImageIntegral()
+  : m_sum(), m_sqsum(), m_squared(false), m_sumDelta(), m_sqsumDelta()
+{
+}
+
+/*!
+  Compute the integral image of \e I, and its squared integral image if
+  \e squared is true.
+*/
+vpImageIntegral::vpImageIntegral(const vpImageView<unsigned char> &I, bool squared)
+  : m_sum(), m_sqsum(), m_squared(false), m_sumDelta(), m_sqsumDelta()
+{
+  build(I, squared);
+}
+
+/*!
+  Compute the integral image of \e I, and its squared integral image if
+  \e squared is true. The tables are only reallocated when the size of the
+  image changes.
+*/
+void vpImageIntegral::build(const vpImageView<unsigned char> &I, bool squared)
+{
+  const unsigned int height = I.getHeight();
+  const unsigned int width = I.getWidth();
+  m_squared = squared;
+  m_sum.resize(height + 1, width + 1);
+  memset(m_sum[0], 0, (width + 1) * sizeof(unsigned int));
+  if (squared) {
+    m_sqsum.resize(height + 1, width + 1);
+    memset(m_sqsum[0], 0, (width + 1) * sizeof(uint64_t));
+  }
+
+  for (unsigned int i = 0; i < height; i++) {
+    m_sum[i+1][0] = 0;
+    integralRow(I[i], m_sum[i] + 1, m_sum[i+1] + 1, width, 0);
+    if (squared) {
+      m_sqsum[i+1][0] = 0;
+      squaredIntegralRow(I[i], m_sqsum[i] + 1, m_sqsum[i+1] + 1, width, 0);
+    }
+  }
+}
+
+/*!
+  Update the tables after a change of the pixels of \e I in the window which
+  top left pixel is (\e top, \e left) and size is \e height x \e width. The
+  other pixels are supposed unchanged since the last build() or update().
+
+  The rows of the window are summed again from the column \e left, while
+  the rows below the window only get the difference of the last row of the
+  window. The cost is thus proportional to \e height times the number of
+  columns from \e left to the right of the image, plus a single addition per
+  element below the window.
+
+  \exception vpImageException::notInTheImage : If the window doesn't fit in
+  the image, or if the size of the image changed since build().
+*/
+void vpImageIntegral::update(const vpImageView<unsigned char> &I, unsigned int top, unsigned int left,
+                             unsigned int height, unsigned int width)
+{
+  if (I.getHeight() != getHeight() || I.getWidth() != getWidth()) {
+    throw(vpImageException(vpImageException::notInTheImage,
+                           "Image size %dx%d differs from the integral image size %dx%d",
+                           I.getHeight(), I.getWidth(), getHeight(), getWidth()));
+  }
+  if (top + height > getHeight() || left + width > getWidth() || top + height < top || left + width < left) {
+    throw(vpImageException(vpImageException::notInTheImage,
+                           "Window (%d, %d) %dx%d is not in the %dx%d image",
+                           top, left, height, width, getHeight(), getWidth()));
+  }
+  if (height == 0 || width == 0)
+    return;
+
+  const unsigned int n = getWidth() - left;
+  const unsigned int bottom = top + height;
+  m_sumDelta.resize(n);
+  if (m_squared)
+    m_sqsumDelta.resize(n);
+
+  for (unsigned int i = top; i < bottom; i++) {
+    unsigned int *prev = m_sum[i] + left;
+    unsigned int *out = m_sum[i+1] + left;
+    const unsigned char *src = I[i] + left;
+    // The column left of the window doesn't depend on the window pixels
+    const bool last = (i + 1 == bottom);
+    if (last)
+      for (unsigned int k = 0; k < n; k++)
+        m_sumDelta[k] = out[k+1];
+    integralRow(src, prev + 1, out + 1, n, out[0] - prev[0]);
+    if (last)
+      for (unsigned int k = 0; k < n; k++)
+        m_sumDelta[k] = out[k+1] - m_sumDelta[k];
+
+    if (m_squared) {
+      uint64_t *prev2 = m_sqsum[i] + left;
+      uint64_t *out2 = m_sqsum[i+1] + left;
+      if (last)
+        for (unsigned int k = 0; k < n; k++)
+          m_sqsumDelta[k] = out2[k+1];
+      squaredIntegralRow(src, prev2 + 1, out2 + 1, n, out2[0] - prev2[0]);
+      if (last)
+        for (unsigned int k = 0; k < n; k++)
+          m_sqsumDelta[k] = out2[k+1] - m_sqsumDelta[k];
+    }
+  }
+
+  for (unsigned int i = bottom + 1; i <= getHeight(); i++) {
+    addDelta(m_sum[i] + left + 1, &m_sumDelta[0], n);
+    if (m_squared)
+      addDelta(m_sqsum[i] + left + 1, &m_sqsumDelta[0], n);
+  }
+}
+
+/*!
+  Update the tables after a change of the pixels of \e I in the region of
+  interest \e roi, which is clipped to the image.
+
+  \sa update(const vpImageView<unsigned char> &, unsigned int, unsigned int, unsigned int, unsigned int)
+*/
+void vpImageIntegral::update(const vpImageView<unsigned char> &I, const vpRect &roi)
+{
+  double dleft = roi.getLeft() < 0. ? 0. : roi.getLeft();
+  double dtop = roi.getTop() < 0. ? 0. : roi.getTop();
+  double dright = ceil(roi.getRight());
+  double dbottom = ceil(roi.getBottom());
+  if (dright >= (double)I.getWidth())
+    dright = (double)I.getWidth() - 1;
+  if (dbottom >= (double)I.getHeight())
+    dbottom = (double)I.getHeight() - 1;
+  if (dright < dleft || dbottom < dtop)
+    return;
+
+  unsigned int left = (unsigned int)dleft;
+  unsigned int top = (unsigned int)dtop;
+  update(I, top, left, (unsigned int)dbottom - top + 1, (unsigned int)dright - left + 1);
+}
@@ -35,13 +35,323 @@
  *
  *****************************************************************************/
 
+#include <vector>
+
 #include <visp3/core/vpImageMorphology.h>
+#include <visp3/core/vpThreadPool.h>
 
 #if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
 #  include <emmintrin.h>
 #  define VISP_HAVE_SSE2 1
 #endif
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Running minimum of the erosion, the pixels outside the image being at 255
+  struct vpMinOperator
+  {
+    static inline unsigned char neutral() { return 255; }
+    static inline unsigned char apply(unsigned char a, unsigned char b) { return a < b ? a : b; }
+#if VISP_HAVE_SSE2
+    static inline __m128i apply(const __m128i &a, const __m128i &b) { return _mm_min_epu8(a, b); }
+#endif
+  };
+
+  // Running maximum of the dilatation, the pixels outside the image being at 0
+  struct vpMaxOperator
+  {
+    static inline unsigned char neutral() { return 0; }
+    static inline unsigned char apply(unsigned char a, unsigned char b) { return a > b ? a : b; }
+#if VISP_HAVE_SSE2
+    static inline __m128i apply(const __m128i &a, const __m128i &b) { return _mm_max_epu8(a, b); }
+#endif
+  };
+
+  /*
+    d[j] = Op(a[j], b[j]) for j in [begin, end).
+  */
+  template<typename Op>
+  void applyRange(unsigned char *d, const unsigned char *a, const unsigned char *b,
+                  unsigned int begin, unsigned int end)
+  {
+    unsigned int j = begin;
+#if VISP_HAVE_SSE2
+    for (; j + 16 <= end; j += 16) {
+      const __m128i va = _mm_loadu_si128((const __m128i *)(a + j));
+      const __m128i vb = _mm_loadu_si128((const __m128i *)(b + j));
+      _mm_storeu_si128((__m128i *)(d + j), Op::apply(va, vb));
+    }
+#endif
+    for (; j < end; j++)
+      d[j] = Op::apply(a[j], b[j]);
+  }
+
+#if VISP_HAVE_SSE2
+  /*
+    Transpose the 16x16 bytes block which rows are r[0], ..., r[15]. Each
+    pass of interleaving rotates by one bit the 8 bits (row, column) index of
+    the bytes, four passes swap the row and column indexes.
+  */
+  inline void transpose16x16(__m128i *r)
+  {
+    __m128i t[16];
+    for (unsigned int n = 0; n < 4; n++) {
+      for (unsigned int k = 0; k < 8; k++) {
+        t[2*k] = _mm_unpacklo_epi8(r[k], r[k + 8]);
+        t[2*k + 1] = _mm_unpackhi_epi8(r[k], r[k + 8]);
+      }
+      for (unsigned int k = 0; k < 16; k++)
+        r[k] = t[k];
+    }
+  }
+#endif
+
+  /*
+    Van Herk/Gil-Werman running minimum or maximum over a line of size
+    pixels. The input, padded with the neutral value so that the window of
+    the output x is [x - before, x - before + size), is cut in blocks of size
+    pixels. Within each block, g holds the prefix and h the suffix
+    extrema. A window overlaps at most two blocks, its extremum is thus
+    Op(h[x], g[x + size - 1]).
+
+    vpHorizontalLine processes the rows [rowStart, rowEnd) of src. With SSE2
+    the rows are processed 16 at once: the blocks of 16x16 pixels are
+    transposed so that each element of the line is a vector holding the
+    pixels of a column in the 16 rows.
+  */
+  template<typename Op>
+  struct vpHorizontalLine
+  {
+    vpHorizontalLine() : src(NULL), dst(NULL), size(1), before(0), rowStart(0), rowEnd(0) {}
+
+    const vpImage<unsigned char> *src;
+    vpImage<unsigned char> *dst;
+    unsigned int size;
+    unsigned int before;
+    unsigned int rowStart;
+    unsigned int rowEnd;
+
+    void run()
+    {
+      const unsigned int width = src->getWidth();
+      const unsigned int length = width + size - 1;
+      unsigned int i = rowStart;
+#if VISP_HAVE_SSE2
+      if (i + 16 <= rowEnd) {
+        std::vector<unsigned char> lines((size_t)length * 16, Op::neutral()), g((size_t)length * 16),
+            h((size_t)length * 16);
+        for (; i + 16 <= rowEnd; i += 16)
+          run16(i, &lines[0], &g[0], &h[0]);
+      }
+#endif
+      // The padding of the line is written once, only its center changes with the rows
+      std::vector<unsigned char> line(length, Op::neutral()), g(length), h(length);
+      for (; i < rowEnd; i++) {
+        memcpy(&line[before], (*src)[i], width);
+        for (unsigned int b = 0; b < length; b += size) {
+          const unsigned int e = std::min(b + size, length);
+          g[b] = line[b];
+          for (unsigned int p = b + 1; p < e; p++)
+            g[p] = Op::apply(g[p - 1], line[p]);
+          h[e - 1] = line[e - 1];
+          for (unsigned int p = e - 1; p > b; p--)
+            h[p - 1] = Op::apply(h[p], line[p - 1]);
+        }
+        applyRange<Op>((*dst)[i], &h[0], &g[size - 1], 0, width);
+      }
+    }
+
+#if VISP_HAVE_SSE2
+    // Process the rows [i, i+16) with the vectors of the transposed line
+    void run16(unsigned int i, unsigned char *line, unsigned char *g, unsigned char *h)
+    {
+      const unsigned int width = src->getWidth();
+      const unsigned int length = width + size - 1;
+      __m128i r[16];
+      unsigned int c = 0;
+      for (; c + 16 <= width; c += 16) {
+        for (unsigned int k = 0; k < 16; k++)
+          r[k] = _mm_loadu_si128((const __m128i *)((*src)[i + k] + c));
+        transpose16x16(r);
+        for (unsigned int k = 0; k < 16; k++)
+          _mm_storeu_si128((__m128i *)(line + (size_t)(before + c + k) * 16), r[k]);
+      }
+      for (; c < width; c++)
+        for (unsigned int k = 0; k < 16; k++)
+          line[(size_t)(before + c) * 16 + k] = (*src)[i + k][c];
+
+      for (unsigned int b = 0; b < length; b += size) {
+        const unsigned int e = std::min(b + size, length);
+        __m128i acc = _mm_loadu_si128((const __m128i *)(line + (size_t)b * 16));
+        _mm_storeu_si128((__m128i *)(g + (size_t)b * 16), acc);
+        for (unsigned int p = b + 1; p < e; p++) {
+          acc = Op::apply(acc, _mm_loadu_si128((const __m128i *)(line + (size_t)p * 16)));
+          _mm_storeu_si128((__m128i *)(g + (size_t)p * 16), acc);
+        }
+        acc = _mm_loadu_si128((const __m128i *)(line + (size_t)(e - 1) * 16));
+        _mm_storeu_si128((__m128i *)(h + (size_t)(e - 1) * 16), acc);
+        for (unsigned int p = e - 1; p > b; p--) {
+          acc = Op::apply(acc, _mm_loadu_si128((const __m128i *)(line + (size_t)(p - 1) * 16)));
+          _mm_storeu_si128((__m128i *)(h + (size_t)(p - 1) * 16), acc);
+        }
+      }
+
+      const unsigned char *gs = g + (size_t)(size - 1) * 16;
+      for (c = 0; c + 16 <= width; c += 16) {
+        for (unsigned int k = 0; k < 16; k++)
+          r[k] = Op::apply(_mm_loadu_si128((const __m128i *)(h + (size_t)(c + k) * 16)),
+                           _mm_loadu_si128((const __m128i *)(gs + (size_t)(c + k) * 16)));
+        transpose16x16(r);
+        for (unsigned int k = 0; k < 16; k++)
+          _mm_storeu_si128((__m128i *)((*dst)[i + k] + c), r[k]);
+      }
+      for (; c < width; c++) {
+        unsigned char v[16];
+        _mm_storeu_si128((__m128i *)v, Op::apply(_mm_loadu_si128((const __m128i *)(h + (size_t)c * 16)),
+                                                 _mm_loadu_si128((const __m128i *)(gs + (size_t)c * 16))));
+        for (unsigned int k = 0; k < 16; k++)
+          (*dst)[i + k][c] = v[k];
+      }
+    }
+#endif
+  };
+
+  // Number of columns of the strips processed by vpVerticalLine
+  const unsigned int stripWidth = 64;
+
+  /*
+    Same running extremum along the columns [begin, end) of src. The columns
+    are processed by strips of stripWidth columns, so that the prefix and
+    suffix extrema of a strip stay in the cache, and each row of a strip is
+    processed 16 columns at once.
+  */
+  template<typename Op>
+  struct vpVerticalLine
+  {
+    vpVerticalLine() : src(NULL), dst(NULL), size(1), before(0), padding(NULL), begin(0), end(0) {}
+
+    const vpImage<unsigned char> *src;
+    vpImage<unsigned char> *dst;
+    unsigned int size;
+    unsigned int before;
+    const unsigned char *padding;
+    unsigned int begin;
+    unsigned int end;
+
+    const unsigned char *row(unsigned int p) const
+    {
+      return (p < before || p >= before + src->getHeight()) ? padding : (*src)[p - before];
+    }
+
+    void run()
+    {
+      const unsigned int length = src->getHeight() + size - 1;
+      std::vector<unsigned char> gs((size_t)length * stripWidth), hs((size_t)length * stripWidth);
+      unsigned char *g = &gs[0], *h = &hs[0];
+      for (unsigned int c = begin; c < end; c += stripWidth) {
+        const unsigned int n = std::min(stripWidth, end - c);
+        for (unsigned int b = 0; b < length; b += size) {
+          const unsigned int e = std::min(b + size, length);
+          memcpy(g + (size_t)b * stripWidth, row(b) + c, n);
+          for (unsigned int p = b + 1; p < e; p++) {
+            unsigned char *gp = g + (size_t)p * stripWidth;
+            applyRange<Op>(gp, gp - stripWidth, row(p) + c, 0, n);
+          }
+          memcpy(h + (size_t)(e - 1) * stripWidth, row(e - 1) + c, n);
+          for (unsigned int p = e - 1; p > b; p--) {
+            unsigned char *hp = h + (size_t)(p - 1) * stripWidth;
+            applyRange<Op>(hp, hp + stripWidth, row(p - 1) + c, 0, n);
+          }
+        }
+        for (unsigned int i = 0; i < src->getHeight(); i++)
+          applyRange<Op>((*dst)[i] + c, h + (size_t)i * stripWidth, g + (size_t)(i + size - 1) * stripWidth, 0, n);
+      }
+    }
+  };
+
+  /*
+    Run a job on nbThreads bands of the n rows or columns of an image with
+    the thread pool. The bands, except the last one, hold a multiple of granularity
+    items. The band limits are written through the setBand() function.
+  */
+  template<typename Job>
+  void runInBands(const Job &job, unsigned int n, unsigned int granularity, unsigned int nbThreads,
+                  void (*setBand)(Job &, unsigned int, unsigned int))
+  {
+    unsigned int nbBlocks = (n + granularity - 1) / granularity;
+    if (nbThreads > nbBlocks)
+      nbThreads = nbBlocks;
+
+    if (nbThreads <= 1) {
+      Job band(job);
+      setBand(band, 0, n);
+      band.run();
+      return;
+    }
+
+    std::vector<Job> bands(nbThreads, job);
+    for (unsigned int i = 0; i < nbThreads; i++) {
+      unsigned int first = (unsigned int)(((size_t)nbBlocks * i) / nbThreads) * granularity;
+      unsigned int last = (i + 1 == nbThreads) ? n : (unsigned int)(((size_t)nbBlocks * (i+1)) / nbThreads) * granularity;
+      setBand(bands[i], first, last);
+    }
+    vpThreadPool::getInstance().run(bands);
+  }
+
+  template<typename Op>
+  void setRows(vpHorizontalLine<Op> &job, unsigned int first, unsigned int last)
+  {
+    job.rowStart = first;
+    job.rowEnd = last;
+  }
+
+  template<typename Op>
+  void setColumns(vpVerticalLine<Op> &job, unsigned int first, unsigned int last)
+  {
+    job.begin = first;
+    job.end = last;
+  }
+
+  /*
+    Erosion (Op = vpMinOperator) or dilatation (Op = vpMaxOperator) of I by
+    a width x height rectangle. The dilatation uses the reflected element so
+    that opening and closing are idempotent.
+  */
+  template<typename Op>
+  void rectangleFilter(vpImage<unsigned char> &I, unsigned int width, unsigned int height,
+                       bool reflect, unsigned int nbThreads)
+  {
+    if (width == 0 || height == 0) {
+      throw(vpImageException(vpImageException::incorrectInitializationError,
+                             "Structuring element %dx%d is empty", height, width));
+    }
+    if (I.getSize() == 0 || (width == 1 && height == 1))
+      return;
+
+    // Both passes work in place: a band of rows, or a strip of columns, is
+    // entirely read before being written
+    if (width > 1) {
+      vpHorizontalLine<Op> job;
+      job.src = &I;
+      job.dst = &I;
+      job.size = width;
+      job.before = reflect ? width / 2 : (width - 1) / 2;
+      runInBands(job, I.getHeight(), 16, nbThreads, setRows<Op>);
+    }
+    if (height > 1) {
+      std::vector<unsigned char> padding(I.getWidth(), Op::neutral());
+      vpVerticalLine<Op> job;
+      job.src = &I;
+      job.dst = &I;
+      job.size = height;
+      job.before = reflect ? height / 2 : (height - 1) / 2;
+      job.padding = &padding[0];
+      runInBands(job, I.getWidth(), 16, nbThreads, setColumns<Op>);
+    }
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 
 /*!
   Erode a grayscale image using the given structuring element.
@@ -276,3 +586,136 @@ void vpImageMorphology::dilatation(vpImage<unsigned char> &I, const vpConnexityT
     }
   }
 }
+
+/*!
+  Erode a grayscale image with a flat rectangular structuring element of
+  \e width x \e height pixels, the pixels outside the image being considered
+  at 255. The output pixel (i, j) is the minimum of the window which rows are
+  [i - (height-1)/2, i + height/2] and columns [j - (width-1)/2, j + width/2].
+  A horizontal or vertical line is obtained with a height or a width of 1.
+
+  The rectangle is decomposed in a horizontal line followed by a vertical
+  line, both computed with the van Herk/Gil-Werman algorithm: the cost per
+  pixel doesn't depend on the size of the element.
+
+  \param I : Image to process.
+  \param width : Width of the structuring element.
+  \param height : Height of the structuring element.
+  \param nbThreads : Number of threads, each one processing a band of rows,
+  then of columns.
+
+  \exception vpImageException::incorrectInitializationError : If the width
+  or the height is null.
+
+  \sa dilatation(vpImage<unsigned char> &, unsigned int, unsigned int, unsigned int)
+*/
+void vpImageMorphology::erosion(vpImage<unsigned char> &I, unsigned int width, unsigned int height,
+                                unsigned int nbThreads)
+{
+  rectangleFilter<vpMinOperator>(I, width, height, false, nbThreads);
+}
+
+/*!
+  Dilate a grayscale image with a flat rectangular structuring element of
+  \e width x \e height pixels, the pixels outside the image being considered
+  at 0. The output pixel (i, j) is the maximum of the window which rows are
+  [i - height/2, i + (height-1)/2] and columns [j - width/2, j + (width-1)/2],
+  that is the element of erosion() reflected about its center. Both windows
+  are the same when the sizes are odd.
+
+  \param I : Image to process.
+  \param width : Width of the structuring element.
+  \param height : Height of the structuring element.
+  \param nbThreads : Number of threads, each one processing a band of rows,
+  then of columns.
+
+  \exception vpImageException::incorrectInitializationError : If the width
+  or the height is null.
+
+  \sa erosion(vpImage<unsigned char> &, unsigned int, unsigned int, unsigned int)
+*/
+void vpImageMorphology::dilatation(vpImage<unsigned char> &I, unsigned int width, unsigned int height,
+                                   unsigned int nbThreads)
+{
+  rectangleFilter<vpMaxOperator>(I, width, height, true, nbThreads);
+}
+
+/*!
+  Morphological opening, an erosion followed by a dilatation with a
+  \e width x \e height rectangle. Removes the bright structures in which the
+  rectangle doesn't fit, like the noise around the blobs of a binarised
+  image.
+
+  \param I : Image to process.
+  \param width : Width of the structuring element.
+  \param height : Height of the structuring element.
+  \param nbThreads : Number of threads.
+
+  \sa closing(), erosion(vpImage<unsigned char> &, unsigned int, unsigned int, unsigned int)
+*/
+void vpImageMorphology::opening(vpImage<unsigned char> &I, unsigned int width, unsigned int height,
+                                unsigned int nbThreads)
+{
+  erosion(I, width, height, nbThreads);
+  dilatation(I, width, height, nbThreads);
+}
+
+/*!
+  Morphological closing, a dilatation followed by an erosion with a
+  \e width x \e height rectangle. Fills the dark holes and gaps in which the
+  rectangle doesn't fit.
+
+  \param I : Image to process.
+  \param width : Width of the structuring element.
+  \param height : Height of the structuring element.
+  \param nbThreads : Number of threads.
+
+  \sa opening(), dilatation(vpImage<unsigned char> &, unsigned int, unsigned int, unsigned int)
+*/
+void vpImageMorphology::closing(vpImage<unsigned char> &I, unsigned int width, unsigned int height,
+                                unsigned int nbThreads)
+{
+  dilatation(I, width, height, nbThreads);
+  erosion(I, width, height, nbThreads);
+}
+
+/*!
+  White top-hat, the difference between the image and its opening(). Keeps
+  the bright structures smaller than the \e width x \e height rectangle.
+
+  \param I : Image to process.
+  \param width : Width of the structuring element.
+  \param height : Height of the structuring element.
+  \param nbThreads : Number of threads.
+
+  \sa blackTopHat()
+*/
+void vpImageMorphology::topHat(vpImage<unsigned char> &I, unsigned int width, unsigned int height,
+                               unsigned int nbThreads)
+{
+  vpImage<unsigned char> Iopen = I;
+  opening(Iopen, width, height, nbThreads);
+  for (unsigned int i = 0; i < I.getSize(); i++)
+    I.bitmap[i] = (unsigned char)(I.bitmap[i] - Iopen.bitmap[i]);
+}
+
+/*!
+  Black top-hat, the difference between the closing() of the image and the
+  image. Keeps the dark structures smaller than the \e width x \e height
+  rectangle.
+
+  \param I : Image to process.
+  \param width : Width of the structuring element.
+  \param height : Height of the structuring element.
+  \param nbThreads : Number of threads.
+
+  \sa topHat()
+*/
+void vpImageMorphology::blackTopHat(vpImage<unsigned char> &I, unsigned int width, unsigned int height,
+                                    unsigned int nbThreads)
+{
+  vpImage<unsigned char> Iclose = I;
+  closing(Iclose, width, height, nbThreads);
+  for (unsigned int i = 0; i < I.getSize(); i++)
+    I.bitmap[i] = (unsigned char)(Iclose.bitmap[i] - I.bitmap[i]);
+}
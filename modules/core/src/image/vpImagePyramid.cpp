@@ -0,0 +1,148 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Multi-resolution pyramid of images reusing its buffers across frames.
+ *
+ *****************************************************************************/
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpImagePyramid.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
+/*!
+  Create an empty pyramid.
+  \param type : Reduction used to compute a level from the previous one.
+*/
+vpImagePyramid::vpImagePyramid(vpPyramidType type)
+  : m_type(type), m_nbLevels(0), m_base(NULL), m_buildCount(0), m_levels(), m_tmp()
+{
+}
+
+/*!
+  Compute the pyramid of the image \e I. The buffers of the levels computed
+  by the previous calls are reused.
+
+  \param I : Image of the level 0. It is not copied and has to outlive the
+  use of the pyramid.
+  \param nbLevels : Number of levels including the level 0. The level
+  \f$ l \f$ has a size of \f$ h/2^l \times w/2^l \f$ where \f$ h \times w \f$
+  is the size of \e I.
+*/
+void vpImagePyramid::build(const vpImage<unsigned char> &I, unsigned int nbLevels)
+{
+  if (nbLevels > 1 && m_levels.size() < nbLevels - 1)
+    m_levels.resize(nbLevels - 1);
+
+  m_base = &I;
+  for (unsigned int l = 1; l < nbLevels; l++) {
+    const vpImage<unsigned char> &src = (l == 1) ? I : m_levels[l - 2];
+    if (m_type == GAUSSIAN) {
+      vpImageFilter::getGaussXPyramidal(src, m_tmp);
+      vpImageFilter::getGaussYPyramidal(m_tmp, m_levels[l - 1]);
+    }
+    else {
+      subsample(src, m_levels[l - 1]);
+    }
+  }
+  m_nbLevels = nbLevels;
+  m_buildCount++;
+}
+
+/*!
+  Release the buffers of the levels. The pyramid becomes empty.
+*/
+void vpImagePyramid::clear()
+{
+  m_levels.clear();
+  m_tmp.destroy();
+  m_base = NULL;
+  m_nbLevels = 0;
+}
+
+/*!
+  Return the level \e level of the pyramid, the level 0 being the image given
+  to the last call to build().
+
+  \exception vpException::badValue : If \e level is not lower than
+  getNbLevels().
+*/
+const vpImage<unsigned char> &vpImagePyramid::getLevel(unsigned int level) const
+{
+  if (level >= m_nbLevels) {
+    throw(vpException(vpException::badValue, "Level %u out of a pyramid of %u levels", level, m_nbLevels));
+  }
+  return (level == 0) ? *m_base : m_levels[level - 1];
+}
+
+/*!
+  Set the reduction used to compute the levels. The levels computed so far
+  are invalidated: build() has to be called again before accessing them.
+*/
+void vpImagePyramid::setType(vpPyramidType type)
+{
+  if (type != m_type) {
+    m_type = type;
+    m_nbLevels = 0;
+  }
+}
+
+/*!
+  Decimate the image \e I by two without smoothing: \f$ Is(i, j) = I(2i, 2j) \f$.
+  \param I : Input image.
+  \param Is : Image of size \f$ h/2 \times w/2 \f$ where \f$ h \times w \f$ is
+  the size of \e I.
+*/
+void vpImagePyramid::subsample(const vpImage<unsigned char> &I, vpImage<unsigned char> &Is)
+{
+  const unsigned int h = I.getHeight() / 2, w = I.getWidth() / 2;
+  Is.resize(h, w);
+#if VISP_HAVE_SSE2
+  const __m128i mask = _mm_set1_epi16(0xFF);
+#endif
+  for (unsigned int i = 0; i < h; i++) {
+    const unsigned char *src = I[2 * i];
+    unsigned char *dst = Is[i];
+    unsigned int j = 0;
+#if VISP_HAVE_SSE2
+    for (; j + 16 <= w; j += 16) {
+      const __m128i v0 = _mm_and_si128(_mm_loadu_si128((const __m128i *)(src + 2 * j)), mask);
+      const __m128i v1 = _mm_and_si128(_mm_loadu_si128((const __m128i *)(src + 2 * j + 16)), mask);
+      _mm_storeu_si128((__m128i *)(dst + j), _mm_packus_epi16(v0, v1));
+    }
+#endif
+    for (; j < w; j++)
+      dst[j] = src[2 * j];
+  }
+}
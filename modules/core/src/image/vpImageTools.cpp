@@ -35,7 +35,11 @@
  *
  *****************************************************************************/
 
+#include <vector>
+
+#include <visp3/core/vpHistogram.h>
 #include <visp3/core/vpImageTools.h>
+#include <visp3/core/vpThreadPool.h>
 
 #if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
 #  include <emmintrin.h>
@@ -279,3 +283,759 @@ vpImageTools::imageSubtract(const vpImage<unsigned char> &I1,
     *ptr_Ires = saturate ? vpMath::saturate<unsigned char>( (short int) *ptr_I1 - (short int) *ptr_I2 ) : *ptr_I1 - *ptr_I2;
   }
 }
+
+/*!
+  Compute the zero-mean normalized cross correlation (ZNCC) between the
+  template \e Itpl and each window of the same size in the image \e I.
+
+  \f[ score(i, j) = \frac{\sum_{r, c} (I(i+r, j+c) - \bar{I}_{ij}) (T(r, c) - \bar{T})}
+  {\sqrt{\sum_{r, c} (I(i+r, j+c) - \bar{I}_{ij})^2 \sum_{r, c} (T(r, c) - \bar{T})^2}} \f]
+
+  The means and variances of the image windows are read in constant time in
+  an integral image, so that only the cross products are computed for each
+  window. A window or a template with a constant gray level gets a null score.
+
+  \param I : Image where the template is searched.
+  \param Itpl : Template.
+  \param Iscore : Scores, in [-1, 1], of the windows which top left pixel is
+  (i, j). Its size is (I.getHeight() - Itpl.getHeight() + 1) x
+  (I.getWidth() - Itpl.getWidth() + 1).
+  \param step_u : Only the columns multiple of \e step_u are computed, the
+  other scores are set to 0.
+  \param step_v : Only the rows multiple of \e step_v are computed, the
+  other scores are set to 0.
+
+  \exception vpImageException::incorrectInitializationError : If the template
+  is empty or larger than the image.
+
+  \sa vpImageIntegral
+*/
+void
+vpImageTools::templateMatching(const vpImageView<unsigned char> &I,
+                               const vpImage<unsigned char> &Itpl,
+                               vpImage<double> &Iscore,
+                               unsigned int step_u, unsigned int step_v)
+{
+  vpImageIntegral integral(I, true);
+  templateMatching(I, integral, Itpl, Iscore, step_u, step_v);
+}
+
+/*!
+  Compute the zero-mean normalized cross correlation (ZNCC) between the
+  template \e Itpl and each window of the same size in the image \e I, the
+  integral and squared integral images of \e I being already computed in
+  \e integral. This allows to match several templates in the same image.
+
+  \sa templateMatching(const vpImageView<unsigned char> &, const vpImage<unsigned char> &, vpImage<double> &, unsigned int, unsigned int)
+*/
+void
+vpImageTools::templateMatching(const vpImageView<unsigned char> &I,
+                               const vpImageIntegral &integral,
+                               const vpImage<unsigned char> &Itpl,
+                               vpImage<double> &Iscore,
+                               unsigned int step_u, unsigned int step_v)
+{
+  const unsigned int h = Itpl.getHeight();
+  const unsigned int w = Itpl.getWidth();
+  if (h == 0 || w == 0 || h > I.getHeight() || w > I.getWidth()) {
+    throw(vpImageException(vpImageException::incorrectInitializationError,
+                           "Template %dx%d cannot be matched in a %dx%d image",
+                           h, w, I.getHeight(), I.getWidth()));
+  }
+  if (! integral.hasSquaredSum() || integral.getHeight() != I.getHeight() || integral.getWidth() != I.getWidth()) {
+    throw(vpImageException(vpImageException::incorrectInitializationError,
+                           "The integral image doesn't match the image"));
+  }
+  if (step_u == 0)
+    step_u = 1;
+  if (step_v == 0)
+    step_v = 1;
+
+  const double n = (double)h * w;
+  double sumT = 0, sumT2 = 0;
+  for (unsigned int k = 0; k < Itpl.getSize(); k++) {
+    sumT += Itpl.bitmap[k];
+    sumT2 += (double)Itpl.bitmap[k] * Itpl.bitmap[k];
+  }
+  const double varT = sumT2 - sumT * sumT / n;
+
+  Iscore.resize(I.getHeight() - h + 1, I.getWidth() - w + 1, 0.);
+  if (varT <= 0.)
+    return;
+
+  for (unsigned int i = 0; i < Iscore.getHeight(); i += step_v) {
+    for (unsigned int j = 0; j < Iscore.getWidth(); j += step_u) {
+      const double sumI = integral.getSum(i, j, h, w);
+      const double varI = (double)integral.getSquaredSum(i, j, h, w) - sumI * sumI / n;
+      if (varI <= 0.)
+        continue;
+
+      // Cross products of the window and the template
+      uint64_t cross = 0;
+      for (unsigned int r = 0; r < h; r++) {
+        const unsigned char *a = I[i + r] + j;
+        const unsigned char *b = Itpl[r];
+        unsigned int c = 0;
+#if VISP_HAVE_SSE2
+        const __m128i zero = _mm_setzero_si128();
+        __m128i acc = zero;
+        for (; c + 16 <= w; c += 16) {
+          const __m128i va = _mm_loadu_si128((const __m128i *)(a + c));
+          const __m128i vb = _mm_loadu_si128((const __m128i *)(b + c));
+          acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi8(va, zero), _mm_unpacklo_epi8(vb, zero)));
+          acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpackhi_epi8(va, zero), _mm_unpackhi_epi8(vb, zero)));
+        }
+        unsigned int lanes[4];
+        _mm_storeu_si128((__m128i *)lanes, acc);
+        cross += (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+#endif
+        for (; c < w; c++)
+          cross += (unsigned int)a[c] * b[c];
+      }
+
+      Iscore[i][j] = ((double)cross - sumI * sumT / n) / sqrt(varI * varT);
+    }
+  }
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  /*
+    Run a job, that processes the rows [rowStart, rowEnd) in its run()
+    function, on nbThreads bands of the n rows run by the thread pool.
+  */
+  template<typename Job>
+  void runInBands(const Job &job, unsigned int n, unsigned int nbThreads)
+  {
+    if (nbThreads > n)
+      nbThreads = n;
+
+    if (nbThreads <= 1) {
+      Job band(job);
+      band.rowStart = 0;
+      band.rowEnd = n;
+      band.run();
+      return;
+    }
+
+    std::vector<Job> bands(nbThreads, job);
+    for (unsigned int i = 0; i < nbThreads; i++) {
+      bands[i].rowStart = (unsigned int)(((size_t)n * i) / nbThreads);
+      bands[i].rowEnd = (unsigned int)(((size_t)n * (i+1)) / nbThreads);
+    }
+    vpThreadPool::getInstance().run(bands);
+  }
+
+  /*
+    Compute the clipped histogram equalization LUT of the tiles which rows
+    are [rowStart, rowEnd) in the tile grid. The bins above the limit are
+    clipped and their excess is redistributed uniformly over the bins.
+  */
+  struct vpClaheTiles
+  {
+    vpClaheTiles() : I(), x(NULL), y(NULL), tilesX(0), clipLimit(0.), luts(NULL), rowStart(0), rowEnd(0) {}
+
+    vpImageView<unsigned char> I;
+    const unsigned int *x;
+    const unsigned int *y;
+    unsigned int tilesX;
+    double clipLimit;
+    unsigned char *luts;
+    unsigned int rowStart;
+    unsigned int rowEnd;
+
+    void run()
+    {
+      vpHistogram hist;
+      for (unsigned int ty = rowStart; ty < rowEnd; ty++) {
+        for (unsigned int tx = 0; tx < tilesX; tx++) {
+          hist.calculate(I.getSubView(y[ty], x[tx], y[ty + 1] - y[ty], x[tx + 1] - x[tx]));
+          unsigned int *h = hist.getValues();
+          const unsigned int area = (y[ty + 1] - y[ty]) * (x[tx + 1] - x[tx]);
+
+          if (clipLimit > 0.) {
+            const unsigned int limit = std::max(1u, (unsigned int)(clipLimit * area / 256));
+            unsigned int excess = 0;
+            for (unsigned int l = 0; l < 256; l++) {
+              if (h[l] > limit) {
+                excess += h[l] - limit;
+                h[l] = limit;
+              }
+            }
+            const unsigned int batch = excess / 256;
+            unsigned int residual = excess - batch * 256;
+            for (unsigned int l = 0; l < 256; l++)
+              h[l] += batch;
+            if (residual > 0) {
+              const unsigned int step = std::max(256 / residual, 1u);
+              for (unsigned int l = 0; l < 256 && residual > 0; l += step, residual--)
+                h[l]++;
+            }
+          }
+
+          unsigned char *lut = luts + 256 * ((size_t)ty * tilesX + tx);
+          const float scale = 255.f / area;
+          unsigned int cdf = 0;
+          for (unsigned int l = 0; l < 256; l++) {
+            cdf += h[l];
+            lut[l] = vpMath::saturate<unsigned char>(cdf * scale + 0.5f);
+          }
+        }
+      }
+    }
+  };
+
+  /*
+    Interpolation, between the LUT of the tiles around a pixel, of the rows
+    [rowStart, rowEnd). t0, t1 are the indexes of the tiles around each row
+    or column, w the weight of t1.
+  */
+  struct vpClaheInterpolation
+  {
+    vpClaheInterpolation()
+      : I(), Iout(NULL), tilesX(0), luts(NULL), tx0(NULL), tx1(NULL), wx(NULL), ty0(NULL), ty1(NULL), wy(NULL),
+        rowStart(0), rowEnd(0) {}
+
+    vpImageView<unsigned char> I;
+    vpImage<unsigned char> *Iout;
+    unsigned int tilesX;
+    const unsigned char *luts;
+    const unsigned int *tx0, *tx1;
+    const float *wx;
+    const unsigned int *ty0, *ty1;
+    const float *wy;
+    unsigned int rowStart;
+    unsigned int rowEnd;
+
+    void run()
+    {
+      for (unsigned int i = rowStart; i < rowEnd; i++) {
+        const unsigned char *lutTop = luts + 256 * (size_t)ty0[i] * tilesX;
+        const unsigned char *lutBottom = luts + 256 * (size_t)ty1[i] * tilesX;
+        const unsigned char *src = I[i];
+        unsigned char *dst = (*Iout)[i];
+        for (unsigned int j = 0; j < I.getWidth(); j++) {
+          const unsigned char v = src[j];
+          const float top = (1.f - wx[j]) * lutTop[256 * tx0[j] + v] + wx[j] * lutTop[256 * tx1[j] + v];
+          const float bottom = (1.f - wx[j]) * lutBottom[256 * tx0[j] + v] + wx[j] * lutBottom[256 * tx1[j] + v];
+          dst[j] = (unsigned char)((1.f - wy[i]) * top + wy[i] * bottom + 0.5f);
+        }
+      }
+    }
+  };
+
+  /*
+    For each of the n pixels of a row or column, find the two tiles which
+    centers surround the pixel and the weight of the second one. The pixels
+    before the first center or after the last one only use the nearest
+    tile.
+  */
+  void claheWeights(const std::vector<unsigned int> &limits, unsigned int n, std::vector<unsigned int> &t0,
+                    std::vector<unsigned int> &t1, std::vector<float> &w)
+  {
+    const unsigned int nbTiles = (unsigned int)limits.size() - 1;
+    t0.resize(n);
+    t1.resize(n);
+    w.resize(n);
+    unsigned int k = 0;
+    for (unsigned int p = 0; p < n; p++) {
+      while (k + 1 < nbTiles && p >= (limits[k + 1] + limits[k + 2] - 1) / 2.f)
+        k++;
+      const float c0 = (limits[k] + limits[k + 1] - 1) / 2.f;
+      if (p < c0 || k + 1 == nbTiles) {
+        t0[p] = t1[p] = k;
+        w[p] = 0.f;
+      }
+      else {
+        const float c1 = (limits[k + 1] + limits[k + 2] - 1) / 2.f;
+        t0[p] = k;
+        t1[p] = k + 1;
+        w[p] = (p - c0) / (c1 - c0);
+      }
+    }
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Equalize the histogram of a gray level image, or of a region of interest
+  given by a vpImageView: the gray levels are remapped so that their
+  cumulative distribution becomes linear over [0, 255].
+
+  \param I : Image or view to equalize.
+  \param Iout : Equalized image, resized to the size of \e I.
+  \param nbThreads : Number of threads used to compute the histogram and to
+  apply the look up table.
+
+  \sa clahe(), vpHistogram::calculate()
+*/
+void vpImageTools::equalizeHistogram(const vpImageView<unsigned char> &I, vpImage<unsigned char> &Iout,
+                                     unsigned int nbThreads)
+{
+  I.copyTo(Iout);
+  if (I.getSize() == 0)
+    return;
+
+  vpHistogram hist;
+  hist.calculate(I, 256, nbThreads);
+  const unsigned int *h = hist.getValues();
+  unsigned int cdfMin = 0;
+  for (unsigned int l = 0; l < 256 && cdfMin == 0; l++)
+    cdfMin = h[l];
+  if (cdfMin == I.getSize())
+    return; // Constant image
+
+  unsigned char lut[256];
+  const double scale = 255. / (I.getSize() - cdfMin);
+  unsigned int cdf = 0;
+  for (unsigned int l = 0; l < 256; l++) {
+    cdf += h[l];
+    lut[l] = cdf > cdfMin ? vpMath::saturate<unsigned char>((cdf - cdfMin) * scale + 0.5) : 0;
+  }
+  Iout.performLut(lut, nbThreads);
+}
+
+/*!
+  Contrast Limited Adaptive Histogram Equalization (CLAHE) of a gray level
+  image, or of a region of interest given by a vpImageView.
+
+  The image is cut in \e tilesX x \e tilesY tiles. The histogram of each
+  tile, computed with vpHistogram::calculate(), is clipped at \e clipLimit
+  times its mean bin count and the clipped pixels are redistributed over all
+  the bins, which limits the amplification of the noise in the uniform
+  regions. The equalization LUT of each tile is then interpolated
+  bilinearly between the centers of the tiles.
+
+  \param I : Image or view to equalize.
+  \param Iout : Equalized image, resized to the size of \e I.
+  \param tilesX : Number of tiles along the columns.
+  \param tilesY : Number of tiles along the rows.
+  \param clipLimit : Clip limit relative to the mean bin count of a tile. A
+  value <= 0 disables the clipping (adaptive histogram equalization).
+  \param nbThreads : Number of threads, each one processing a band of tiles,
+  then a band of rows.
+
+  \exception vpImageException::incorrectInitializationError : If the number
+  of tiles is null.
+
+  \sa equalizeHistogram()
+*/
+void vpImageTools::clahe(const vpImageView<unsigned char> &I, vpImage<unsigned char> &Iout,
+                         unsigned int tilesX, unsigned int tilesY, double clipLimit, unsigned int nbThreads)
+{
+  if (tilesX == 0 || tilesY == 0) {
+    throw(vpImageException(vpImageException::incorrectInitializationError,
+                           "CLAHE needs at least one tile, not %dx%d", tilesY, tilesX));
+  }
+  Iout.resize(I.getHeight(), I.getWidth());
+  if (I.getSize() == 0)
+    return;
+
+  tilesX = std::min(tilesX, I.getWidth());
+  tilesY = std::min(tilesY, I.getHeight());
+  std::vector<unsigned int> x(tilesX + 1), y(tilesY + 1);
+  for (unsigned int k = 0; k <= tilesX; k++)
+    x[k] = (unsigned int)(((size_t)I.getWidth() * k) / tilesX);
+  for (unsigned int k = 0; k <= tilesY; k++)
+    y[k] = (unsigned int)(((size_t)I.getHeight() * k) / tilesY);
+
+  std::vector<unsigned char> luts(256 * (size_t)tilesX * tilesY);
+  vpClaheTiles tiles;
+  tiles.I = I;
+  tiles.x = &x[0];
+  tiles.y = &y[0];
+  tiles.tilesX = tilesX;
+  tiles.clipLimit = clipLimit;
+  tiles.luts = &luts[0];
+  runInBands(tiles, tilesY, nbThreads);
+
+  std::vector<unsigned int> tx0, tx1, ty0, ty1;
+  std::vector<float> wx, wy;
+  claheWeights(x, I.getWidth(), tx0, tx1, wx);
+  claheWeights(y, I.getHeight(), ty0, ty1, wy);
+
+  vpClaheInterpolation interpolation;
+  interpolation.I = I;
+  interpolation.Iout = &Iout;
+  interpolation.tilesX = tilesX;
+  interpolation.luts = &luts[0];
+  interpolation.tx0 = &tx0[0];
+  interpolation.tx1 = &tx1[0];
+  interpolation.wx = &wx[0];
+  interpolation.ty0 = &ty0[0];
+  interpolation.ty1 = &ty1[0];
+  interpolation.wy = &wy[0];
+  runInBands(interpolation, I.getHeight(), nbThreads);
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  /*
+    Coefficients of a 1D resampling: the output pixel x is the weighted sum
+    of the taps source pixels starting at offsets[x], with the weights
+    weights[x * taps + k]. The source pixels out of the image are replaced
+    by the nearest border pixel, their weight being added to it.
+    groupedWeights holds the same weights interleaved by groups of 4 output
+    pixels: groupedWeights[(x / 4) * 4 * taps + 4 * k + x % 4].
+  */
+  struct vpResizeTable
+  {
+    vpResizeTable() : taps(0), offsets(), weights(), groupedWeights() {}
+
+    unsigned int taps;
+    std::vector<unsigned int> offsets;
+    std::vector<float> weights;
+    std::vector<float> groupedWeights;
+  };
+
+  // Catmull-Rom cubic kernel
+  inline double cubicWeight(double d)
+  {
+    d = std::fabs(d);
+    if (d < 1.)
+      return (1.5 * d - 2.5) * d * d + 1.;
+    if (d < 2.)
+      return ((-0.5 * d + 2.5) * d - 4.) * d + 2.;
+    return 0.;
+  }
+
+  /*
+    Weights of the source pixels first, first + 1, ... contributing to the
+    output pixel x. The output pixel centers are aligned on the source ones:
+    the output pixel x is centered on (x + 0.5) scale - 0.5 in the source.
+  */
+  int rawWeights(unsigned int x, double scale, vpImageTools::vpImageInterpolationType method, std::vector<double> &w)
+  {
+    const double c = (x + 0.5) * scale - 0.5;
+    w.clear();
+    switch (method) {
+    case vpImageTools::INTERPOLATION_NEAREST:
+      w.push_back(1.);
+      return (int)floor((x + 0.5) * scale);
+
+    case vpImageTools::INTERPOLATION_LINEAR: {
+      const double i0 = floor(c);
+      w.push_back(1. - (c - i0));
+      w.push_back(c - i0);
+      return (int)i0;
+    }
+
+    case vpImageTools::INTERPOLATION_CUBIC: {
+      const double i0 = floor(c);
+      for (int k = -1; k <= 2; k++)
+        w.push_back(cubicWeight(c - (i0 + k)));
+      return (int)i0 - 1;
+    }
+
+    case vpImageTools::INTERPOLATION_AREA:
+    default: {
+      // Overlap of the source pixels with [x scale, (x + 1) scale)
+      // The bounds are snapped to tolerate the rounding errors on the scale
+      const double start = x * scale, end = (x + 1) * scale;
+      const int first = (int)floor(start + 1e-9);
+      for (int i = first; i < end - 1e-9; i++)
+        w.push_back((std::min(end, i + 1.) - std::max(start, (double)i)) / scale);
+      return first;
+    }
+    }
+  }
+
+  void resizeTable(unsigned int n, unsigned int dstN, vpImageTools::vpImageInterpolationType method,
+                   vpResizeTable &table)
+  {
+    const double scale = (double)n / dstN;
+    std::vector<int> first(dstN);
+    std::vector<std::vector<double> > w(dstN);
+    table.taps = 0;
+    for (unsigned int x = 0; x < dstN; x++) {
+      first[x] = rawWeights(x, scale, method, w[x]);
+      table.taps = std::max(table.taps, (unsigned int)w[x].size());
+    }
+    table.taps = std::min(table.taps, n);
+
+    table.offsets.resize(dstN);
+    table.weights.assign((size_t)dstN * table.taps, 0.f);
+    for (unsigned int x = 0; x < dstN; x++) {
+      const int start = std::min(std::max(first[x], 0), (int)(n - table.taps));
+      table.offsets[x] = (unsigned int)start;
+      for (size_t k = 0; k < w[x].size(); k++) {
+        const int i = std::min(std::max(first[x] + (int)k, 0), (int)n - 1);
+        table.weights[(size_t)x * table.taps + (i - start)] += (float)w[x][k];
+      }
+    }
+
+    table.groupedWeights.assign(((size_t)dstN + 3) / 4 * 4 * table.taps, 0.f);
+    for (unsigned int x = 0; x < dstN; x++)
+      for (unsigned int k = 0; k < table.taps; k++)
+        table.groupedWeights[(size_t)(x / 4) * 4 * table.taps + 4 * k + x % 4] = table.weights[(size_t)x * table.taps + k];
+  }
+
+  /*
+    Vertical pass: weighted sum of the taps rows into a float row.
+  */
+  void resizeColumns(const unsigned char *const *rows, const float *w, unsigned int taps, float *dst,
+                     unsigned int n)
+  {
+    unsigned int j = 0;
+#if VISP_HAVE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; j + 8 <= n; j += 8) {
+      __m128 lo = _mm_setzero_ps(), hi = _mm_setzero_ps();
+      for (unsigned int k = 0; k < taps; k++) {
+        const __m128i p = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(rows[k] + j)), zero);
+        const __m128 wk = _mm_set1_ps(w[k]);
+        lo = _mm_add_ps(lo, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpacklo_epi16(p, zero)), wk));
+        hi = _mm_add_ps(hi, _mm_mul_ps(_mm_cvtepi32_ps(_mm_unpackhi_epi16(p, zero)), wk));
+      }
+      _mm_storeu_ps(dst + j, lo);
+      _mm_storeu_ps(dst + j + 4, hi);
+    }
+#endif
+    for (; j < n; j++) {
+      float sum = 0.f;
+      for (unsigned int k = 0; k < taps; k++)
+        sum += rows[k][j] * w[k];
+      dst[j] = sum;
+    }
+  }
+
+  void resizeColumns(const float *const *rows, const float *w, unsigned int taps, float *dst, unsigned int n)
+  {
+    unsigned int j = 0;
+#if VISP_HAVE_SSE2
+    for (; j + 4 <= n; j += 4) {
+      __m128 sum = _mm_setzero_ps();
+      for (unsigned int k = 0; k < taps; k++)
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(rows[k] + j), _mm_set1_ps(w[k])));
+      _mm_storeu_ps(dst + j, sum);
+    }
+#endif
+    for (; j < n; j++) {
+      float sum = 0.f;
+      for (unsigned int k = 0; k < taps; k++)
+        sum += rows[k][j] * w[k];
+      dst[j] = sum;
+    }
+  }
+
+  // Rounded as vpMath::round() and saturated
+  inline void storeResized(float v, unsigned char &dst)
+  {
+    dst = v <= 0.f ? 0 : (v >= 255.f ? 255 : (unsigned char)(v + 0.5f));
+  }
+  inline void storeResized(float v, float &dst) { dst = v; }
+
+  /*
+    Horizontal pass of a row of interleaved pixels with the given number of
+    channels.
+  */
+  template<typename Elem, unsigned int channels>
+  void resizeRow(const float *src, const vpResizeTable &table, Elem *dst, unsigned int n)
+  {
+    const unsigned int taps = table.taps;
+    for (unsigned int x = 0; x < n; x++) {
+      const float *s = src + channels * table.offsets[x];
+      const float *w = &table.weights[(size_t)x * taps];
+      for (unsigned int c = 0; c < channels; c++) {
+        float sum = 0.f;
+        for (unsigned int k = 0; k < taps; k++)
+          sum += s[channels * k + c] * w[k];
+        storeResized(sum, dst[channels * x + c]);
+      }
+    }
+  }
+
+#if VISP_HAVE_SSE2
+  /*
+    4 output pixels of a single channel row at once: the taps source pixels
+    of each of them are gathered into a register and multiplied by the
+    grouped weights.
+  */
+  inline __m128 resizeGroup(const float *src, const vpResizeTable &table, unsigned int x)
+  {
+    const unsigned int taps = table.taps;
+    const float *s0 = src + table.offsets[x], *s1 = src + table.offsets[x + 1];
+    const float *s2 = src + table.offsets[x + 2], *s3 = src + table.offsets[x + 3];
+    const float *w = &table.groupedWeights[(size_t)x * taps];
+    __m128 sum = _mm_setzero_ps();
+    for (unsigned int k = 0; k < taps; k++)
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_setr_ps(s0[k], s1[k], s2[k], s3[k]), _mm_loadu_ps(w + 4 * k)));
+    return sum;
+  }
+
+  template<>
+  void resizeRow<unsigned char, 1>(const float *src, const vpResizeTable &table, unsigned char *dst, unsigned int n)
+  {
+    unsigned int x = 0;
+    for (; x + 4 <= n; x += 4) {
+      // Rounded as vpMath::round(), the negative values being saturated to 0
+      __m128i v = _mm_cvttps_epi32(_mm_add_ps(resizeGroup(src, table, x), _mm_set1_ps(0.5f)));
+      v = _mm_packs_epi32(v, v);
+      const int p = _mm_cvtsi128_si32(_mm_packus_epi16(v, v));
+      memcpy(dst + x, &p, 4);
+    }
+    for (; x < n; x++) {
+      float sum = 0.f;
+      for (unsigned int k = 0; k < table.taps; k++)
+        sum += src[table.offsets[x] + k] * table.weights[(size_t)x * table.taps + k];
+      storeResized(sum, dst[x]);
+    }
+  }
+
+  template<>
+  void resizeRow<float, 1>(const float *src, const vpResizeTable &table, float *dst, unsigned int n)
+  {
+    unsigned int x = 0;
+    for (; x + 4 <= n; x += 4)
+      _mm_storeu_ps(dst + x, resizeGroup(src, table, x));
+    for (; x < n; x++) {
+      float sum = 0.f;
+      for (unsigned int k = 0; k < table.taps; k++)
+        sum += src[table.offsets[x] + k] * table.weights[(size_t)x * table.taps + k];
+      dst[x] = sum;
+    }
+  }
+
+  // The 4 channels of a vpRGBa pixel are interpolated at once
+  template<>
+  void resizeRow<unsigned char, 4>(const float *src, const vpResizeTable &table, unsigned char *dst, unsigned int n)
+  {
+    const unsigned int taps = table.taps;
+    for (unsigned int x = 0; x < n; x++) {
+      const float *s = src + 4 * table.offsets[x];
+      const float *w = &table.weights[(size_t)x * taps];
+      __m128 sum = _mm_setzero_ps();
+      for (unsigned int k = 0; k < taps; k++)
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_loadu_ps(s + 4 * k), _mm_set1_ps(w[k])));
+      // Rounded as vpMath::round(), the negative values being saturated to 0
+      __m128i v = _mm_cvttps_epi32(_mm_add_ps(sum, _mm_set1_ps(0.5f)));
+      v = _mm_packs_epi32(v, v);
+      const int rgba = _mm_cvtsi128_si32(_mm_packus_epi16(v, v));
+      memcpy(dst + 4 * x, &rgba, 4);
+    }
+  }
+#endif
+
+  /*
+    Resize the rows [rowStart, rowEnd) of the output image: vertical pass
+    into a float row, then horizontal pass. Elem is the type of a channel.
+  */
+  template<typename Type, typename Elem, unsigned int channels>
+  struct vpResizeJob
+  {
+    vpResizeJob() : I(), Ires(NULL), tx(NULL), ty(NULL), rowStart(0), rowEnd(0) {}
+
+    vpImageView<Type> I;
+    vpImage<Type> *Ires;
+    const vpResizeTable *tx;
+    const vpResizeTable *ty;
+    unsigned int rowStart;
+    unsigned int rowEnd;
+
+    void run()
+    {
+      const unsigned int n = channels * I.getWidth();
+      std::vector<float> buffer(n);
+      std::vector<const Elem *> rows(ty->taps);
+      for (unsigned int i = rowStart; i < rowEnd; i++) {
+        for (unsigned int k = 0; k < ty->taps; k++)
+          rows[k] = (const Elem *)I[ty->offsets[i] + k];
+        resizeColumns(&rows[0], &ty->weights[(size_t)i * ty->taps], ty->taps, &buffer[0], n);
+        resizeRow<Elem, channels>(&buffer[0], *tx, (Elem *)(*Ires)[i], Ires->getWidth());
+      }
+    }
+  };
+
+  template<typename Type, typename Elem, unsigned int channels>
+  void resizeImage(const vpImageView<Type> &I, vpImage<Type> &Ires, unsigned int height, unsigned int width,
+                   vpImageTools::vpImageInterpolationType method, unsigned int nbThreads)
+  {
+    if (I.getSize() == 0 && (size_t)height * width > 0) {
+      throw(vpImageException(vpImageException::incorrectInitializationError,
+                             "Cannot resize an empty image to %dx%d", height, width));
+    }
+    // Resizing Ires would release the pixels of I when I is a view on Ires
+    if (I.overlaps(Ires)) {
+      vpImage<Type> tmp;
+      resizeImage<Type, Elem, channels>(I, tmp, height, width, method, nbThreads);
+      Ires = tmp;
+      return;
+    }
+    Ires.resize(height, width);
+    if (Ires.getSize() == 0)
+      return;
+
+    vpResizeTable tx, ty;
+    resizeTable(I.getWidth(), width, method, tx);
+    resizeTable(I.getHeight(), height, method, ty);
+
+    vpResizeJob<Type, Elem, channels> job;
+    job.I = I;
+    job.Ires = &Ires;
+    job.tx = &tx;
+    job.ty = &ty;
+    runInBands(job, height, nbThreads);
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Resize a gray level image, or a region of interest given by a vpImageView,
+  to an arbitrary size.
+
+  The resampling is separable: each row of \e Ires is interpolated
+  vertically from the rows of \e I then horizontally, with coefficients
+  precomputed once per row and per column. The pixel centers of both images
+  are aligned and the pixels out of \e I are replaced by the nearest border
+  pixel.
+
+  \param I : Image or view to resize.
+  \param Ires : Resized image of size \e height x \e width.
+  \param height, width : Size of the resized image.
+  \param method : Interpolation method. INTERPOLATION_AREA averages all the
+  pixels covered by a resized pixel and avoids the aliasing of the other
+  methods when downscaling.
+  \param nbThreads : Number of threads sharing the rows of \e Ires.
+
+  \exception vpImageException::incorrectInitializationError : If \e I is
+  empty while the resized image is not.
+
+  \e I may be a view on \e Ires, or on a region of interest of \e Ires: the
+  image is then resized through a temporary.
+
+  \sa vpImage::halfSizeImage(), vpImage::quarterSizeImage(), vpImage::doubleSizeImage()
+*/
+void vpImageTools::resize(const vpImageView<unsigned char> &I, vpImage<unsigned char> &Ires,
+                          unsigned int height, unsigned int width, vpImageInterpolationType method,
+                          unsigned int nbThreads)
+{
+  resizeImage<unsigned char, unsigned char, 1>(I, Ires, height, width, method, nbThreads);
+}
+
+/*!
+  Resize a float image, or a region of interest given by a vpImageView, to
+  an arbitrary size. The values are not clamped, the cubic interpolation
+  may thus slightly overshoot.
+
+  \sa resize(const vpImageView<unsigned char> &, vpImage<unsigned char> &, unsigned int, unsigned int, vpImageInterpolationType, unsigned int)
+*/
+void vpImageTools::resize(const vpImageView<float> &I, vpImage<float> &Ires,
+                          unsigned int height, unsigned int width, vpImageInterpolationType method,
+                          unsigned int nbThreads)
+{
+  resizeImage<float, float, 1>(I, Ires, height, width, method, nbThreads);
+}
+
+/*!
+  Resize a color image, or a region of interest given by a vpImageView, to
+  an arbitrary size. The 4 channels, alpha included, are interpolated
+  independently.
+
+  \sa resize(const vpImageView<unsigned char> &, vpImage<unsigned char> &, unsigned int, unsigned int, vpImageInterpolationType, unsigned int)
+*/
+void vpImageTools::resize(const vpImageView<vpRGBa> &I, vpImage<vpRGBa> &Ires,
+                          unsigned int height, unsigned int width, vpImageInterpolationType method,
+                          unsigned int nbThreads)
+{
+  resizeImage<vpRGBa, unsigned char, 4>(I, Ires, height, width, method, nbThreads);
+}
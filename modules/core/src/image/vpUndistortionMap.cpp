@@ -0,0 +1,422 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Precomputed remap of the pixels of an image to undistort it.
+ *
+ *****************************************************************************/
+
+#include <limits>
+#include <math.h>
+#include <string.h>
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpImageException.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpUndistortionMap.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  const int one = 1 << vpUndistortionMap::interpolationBits;
+  const int roundingShift = 2 * vpUndistortionMap::interpolationBits;
+  const int rounding = 1 << (roundingShift - 1);
+
+  /*
+    Bilinear interpolation of the rows [rowStart, rowEnd) of a remapped
+    image. Out of the source image, the pixels are set to 0.
+  */
+  template<typename Type>
+  struct vpRemapJob
+  {
+    vpRemapJob() : src(NULL), dst(NULL), coords(NULL), fractions(NULL), rowStart(0), rowEnd(0) {}
+
+    const vpImage<Type> *src;
+    vpImage<Type> *dst;
+    const short *coords;
+    const unsigned char *fractions;
+    unsigned int rowStart;
+    unsigned int rowEnd;
+
+    void run();
+  };
+
+  template<>
+  void vpRemapJob<unsigned char>::run()
+  {
+    const unsigned int width = dst->getWidth();
+    const unsigned int srcWidth = src->getWidth();
+    for (unsigned int i = rowStart; i < rowEnd; i++) {
+      const short *c = coords + 2 * (size_t)i * width;
+      const unsigned char *f = fractions + 2 * (size_t)i * width;
+      unsigned char *d = (*dst)[i];
+      unsigned int j = 0;
+#if VISP_HAVE_SSE2
+      // 4 pixels at once: the (left, right) neighbours are inserted as 16
+      // bits values in a register, widened to (left, right) pairs and
+      // interpolated along the columns then the rows with _mm_madd_epi16().
+      // The invalid pixels read the 2x2 first source pixels and are
+      // cleared. A source with a single row or column has no valid pixel and
+      // is left to the scalar code that doesn't read it.
+      const bool gather = srcWidth >= 2 && src->getHeight() >= 2;
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i round = _mm_set1_epi32(rounding);
+      const __m128i ones = _mm_set1_epi32(one);
+      const __m128i odd = _mm_set1_epi32((int)0xffff0000);
+      const unsigned char *b = src->bitmap;
+      for (; gather && j + 4 <= width; j += 4) {
+        const __m128i xy = _mm_loadu_si128((const __m128i *)(c + 2 * j));
+        const __m128i invalid = _mm_srai_epi32(_mm_slli_epi32(xy, 16), 16);
+        const __m128i mask = _mm_cmplt_epi32(invalid, zero);
+        size_t o0 = c[2*j] < 0 ? 0 : (size_t)c[2*j + 1] * srcWidth + c[2*j];
+        size_t o1 = c[2*j + 2] < 0 ? 0 : (size_t)c[2*j + 3] * srcWidth + c[2*j + 2];
+        size_t o2 = c[2*j + 4] < 0 ? 0 : (size_t)c[2*j + 5] * srcWidth + c[2*j + 4];
+        size_t o3 = c[2*j + 6] < 0 ? 0 : (size_t)c[2*j + 7] * srcWidth + c[2*j + 6];
+        __m128i n = _mm_cvtsi32_si128(b[o0] | (b[o0 + 1] << 8));
+        n = _mm_insert_epi16(n, b[o1] | (b[o1 + 1] << 8), 1);
+        n = _mm_insert_epi16(n, b[o2] | (b[o2 + 1] << 8), 2);
+        n = _mm_insert_epi16(n, b[o3] | (b[o3 + 1] << 8), 3);
+        n = _mm_insert_epi16(n, b[o0 + srcWidth] | (b[o0 + srcWidth + 1] << 8), 4);
+        n = _mm_insert_epi16(n, b[o1 + srcWidth] | (b[o1 + srcWidth + 1] << 8), 5);
+        n = _mm_insert_epi16(n, b[o2 + srcWidth] | (b[o2 + srcWidth + 1] << 8), 6);
+        n = _mm_insert_epi16(n, b[o3 + srcWidth] | (b[o3 + srcWidth + 1] << 8), 7);
+        const __m128i top = _mm_unpacklo_epi8(n, zero);
+        const __m128i bottom = _mm_unpackhi_epi8(n, zero);
+
+        // (fx, fy) pairs to (one - fx, fx) and (one - fy, fy) weights
+        const __m128i fxy = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(f + 2 * j)), zero);
+        const __m128i fx = _mm_shufflehi_epi16(_mm_shufflelo_epi16(fxy, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 2, 0, 0));
+        const __m128i fy = _mm_shufflehi_epi16(_mm_shufflelo_epi16(fxy, _MM_SHUFFLE(3, 3, 1, 1)), _MM_SHUFFLE(3, 3, 1, 1));
+        const __m128i wx = _mm_or_si128(_mm_and_si128(odd, fx), _mm_andnot_si128(odd, _mm_sub_epi16(ones, fx)));
+        const __m128i wy = _mm_or_si128(_mm_and_si128(odd, fy), _mm_andnot_si128(odd, _mm_sub_epi16(ones, fy)));
+
+        const __m128i t = _mm_madd_epi16(top, wx);
+        const __m128i bt = _mm_madd_epi16(bottom, wx);
+        __m128i r = _mm_madd_epi16(_mm_unpacklo_epi16(_mm_packs_epi32(t, t), _mm_packs_epi32(bt, bt)), wy);
+        r = _mm_andnot_si128(mask, _mm_srai_epi32(_mm_add_epi32(r, round), roundingShift));
+        r = _mm_packs_epi32(r, r);
+        const int v = _mm_cvtsi128_si32(_mm_packus_epi16(r, r));
+        memcpy(d + j, &v, 4);
+      }
+#endif
+      for (; j < width; j++) {
+        const short x = c[2 * j], y = c[2 * j + 1];
+        if (x < 0) {
+          d[j] = 0;
+          continue;
+        }
+        const unsigned char *s = src->bitmap + (size_t)y * srcWidth + x;
+        const int fx = f[2 * j], fy = f[2 * j + 1];
+        const int t = s[0] * (one - fx) + s[1] * fx;
+        const int b = s[srcWidth] * (one - fx) + s[srcWidth + 1] * fx;
+        d[j] = (unsigned char)((t * (one - fy) + b * fy + rounding) >> roundingShift);
+      }
+    }
+  }
+
+  template<>
+  void vpRemapJob<vpRGBa>::run()
+  {
+    const unsigned int width = dst->getWidth();
+    const unsigned int srcWidth = src->getWidth();
+    for (unsigned int i = rowStart; i < rowEnd; i++) {
+      const short *c = coords + 2 * (size_t)i * width;
+      const unsigned char *f = fractions + 2 * (size_t)i * width;
+      vpRGBa *d = (*dst)[i];
+      for (unsigned int j = 0; j < width; j++) {
+        const short x = c[2 * j], y = c[2 * j + 1];
+        if (x < 0) {
+          d[j] = vpRGBa(0, 0, 0, 0);
+          continue;
+        }
+        const unsigned char *s = (const unsigned char *)(src->bitmap + (size_t)y * srcWidth + x);
+        const unsigned char *sb = s + 4 * (size_t)srcWidth;
+        const int fx = f[2 * j], fy = f[2 * j + 1];
+#if VISP_HAVE_SSE2
+        // The 4 channels of the left and right neighbours are interleaved as
+        // 16 bits pairs and interpolated with _mm_madd_epi16()
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i vt = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)s), zero);
+        const __m128i vb = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)sb), zero);
+        const __m128i wx = _mm_set_epi16((short)fx, (short)(one - fx), (short)fx, (short)(one - fx),
+                                         (short)fx, (short)(one - fx), (short)fx, (short)(one - fx));
+        const __m128i wy = _mm_set_epi16((short)fy, (short)(one - fy), (short)fy, (short)(one - fy),
+                                         (short)fy, (short)(one - fy), (short)fy, (short)(one - fy));
+        const __m128i t = _mm_madd_epi16(_mm_unpacklo_epi16(vt, _mm_srli_si128(vt, 8)), wx);
+        const __m128i b = _mm_madd_epi16(_mm_unpacklo_epi16(vb, _mm_srli_si128(vb, 8)), wx);
+        __m128i r = _mm_madd_epi16(_mm_unpacklo_epi16(_mm_packs_epi32(t, t), _mm_packs_epi32(b, b)), wy);
+        r = _mm_srai_epi32(_mm_add_epi32(r, _mm_set1_epi32(rounding)), roundingShift);
+        r = _mm_packs_epi32(r, r);
+        const int v = _mm_cvtsi128_si32(_mm_packus_epi16(r, r));
+        memcpy((unsigned char *)&d[j], &v, 4);
+#else
+        unsigned char *o = (unsigned char *)&d[j];
+        for (unsigned int k = 0; k < 4; k++) {
+          const int t = s[k] * (one - fx) + s[4 + k] * fx;
+          const int b = sb[k] * (one - fx) + sb[4 + k] * fx;
+          o[k] = (unsigned char)((t * (one - fy) + b * fy + rounding) >> roundingShift);
+        }
+#endif
+      }
+    }
+  }
+
+  /*
+    Run a job, that processes the rows [rowStart, rowEnd) in its run()
+    function, on nbThreads bands of the n rows run by the thread pool.
+  */
+  template<typename Job>
+  void runInBands(const Job &job, unsigned int n, unsigned int nbThreads)
+  {
+    if (nbThreads > n)
+      nbThreads = n;
+
+    if (nbThreads <= 1) {
+      Job band(job);
+      band.rowStart = 0;
+      band.rowEnd = n;
+      band.run();
+      return;
+    }
+
+    std::vector<Job> bands(nbThreads, job);
+    for (unsigned int i = 0; i < nbThreads; i++) {
+      bands[i].rowStart = (unsigned int)(((size_t)n * i) / nbThreads);
+      bands[i].rowEnd = (unsigned int)(((size_t)n * (i+1)) / nbThreads);
+    }
+    vpThreadPool::getInstance().run(bands);
+  }
+
+  template<typename Type>
+  void remapImage(const vpImage<Type> &I, vpImage<Type> &Iout, unsigned int height, unsigned int width,
+                  unsigned int srcHeight, unsigned int srcWidth, const std::vector<short> &coords,
+                  const std::vector<unsigned char> &fractions, unsigned int nbThreads)
+  {
+    if (I.getHeight() != srcHeight || I.getWidth() != srcWidth) {
+      throw(vpImageException(vpImageException::incorrectInitializationError,
+                             "The map was built for %dx%d images, not %dx%d",
+                             srcHeight, srcWidth, I.getHeight(), I.getWidth()));
+    }
+    if (&I == &Iout) {
+      throw(vpImageException(vpImageException::incorrectInitializationError,
+                             "An image cannot be remapped in place"));
+    }
+    Iout.resize(height, width);
+    if (Iout.getSize() == 0)
+      return;
+
+    vpRemapJob<Type> job;
+    job.src = &I;
+    job.dst = &Iout;
+    job.coords = &coords[0];
+    job.fractions = &fractions[0];
+    runInBands(job, height, nbThreads);
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Build an empty map. Call build() before remap().
+*/
+vpUndistortionMap::vpUndistortionMap()
+  : m_height(0), m_width(0), m_srcHeight(0), m_srcWidth(0), m_coords(), m_fractions()
+{
+}
+
+/*!
+  Build the map undistorting the \e height x \e width images of the camera
+  \e cam.
+
+  \sa build(const vpCameraParameters &, unsigned int, unsigned int)
+*/
+vpUndistortionMap::vpUndistortionMap(const vpCameraParameters &cam, unsigned int height, unsigned int width)
+  : m_height(0), m_width(0), m_srcHeight(0), m_srcWidth(0), m_coords(), m_fractions()
+{
+  build(cam, height, width);
+}
+
+/*!
+  Build the map undistorting the \e height x \e width images of the camera
+  \e cam with the model used by vpImageTools::undistort(). The remapped
+  images have the same size than the source ones.
+
+  \param cam : Camera parameters with distortion.
+  \param height, width : Size of the distorted images.
+*/
+void vpUndistortionMap::build(const vpCameraParameters &cam, unsigned int height, unsigned int width)
+{
+  vpArray2D<double> H(3, 3, 0.);
+  H[0][0] = H[1][1] = H[2][2] = 1.;
+  build(cam, height, width, H, height, width);
+}
+
+/*!
+  Build the map undistorting the \e height x \e width images of the camera
+  \e cam and resizing them to \e dstHeight x \e dstWidth. The pixel centers
+  are aligned: the pixel (u, v) of the remapped image is taken at
+  ((u + 0.5) sx - 0.5, (v + 0.5) sy - 0.5) in the undistorted image, with
+  sx = width / dstWidth and sy = height / dstHeight.
+
+  \param cam : Camera parameters with distortion.
+  \param height, width : Size of the distorted images.
+  \param dstHeight, dstWidth : Size of the remapped images.
+*/
+void vpUndistortionMap::build(const vpCameraParameters &cam, unsigned int height, unsigned int width,
+                              unsigned int dstHeight, unsigned int dstWidth)
+{
+  vpArray2D<double> H(3, 3, 0.);
+  if (dstHeight > 0 && dstWidth > 0) {
+    H[0][0] = (double)width / dstWidth;
+    H[0][2] = (H[0][0] - 1.) / 2.;
+    H[1][1] = (double)height / dstHeight;
+    H[1][2] = (H[1][1] - 1.) / 2.;
+  }
+  H[2][2] = 1.;
+  build(cam, height, width, H, dstHeight, dstWidth);
+}
+
+/*!
+  Build a map combining a homography and the undistortion of the \e height x
+  \e width images of the camera \e cam.
+
+  The pixel (u, v) of the remapped image of size \e dstHeight x \e dstWidth
+  is taken in the undistorted image at the position (x/z, y/z) where
+  \f$ (x, y, z)^T = H (u, v, 1)^T \f$. \e H is typically a rectifying
+  homography expressed in pixels (a vpHomography or a vpMatrix), possibly
+  composed with a scaling to resize the images.
+
+  The distortion model is the one of vpImageTools::undistort(): the pixel
+  (u, v) of the undistorted image is read at
+  \f$ u_0 + (u - u_0)(1 + k_{ud} r^2), v_0 + (v - v_0)(1 + k_{ud} r^2) \f$
+  in the distorted image, with
+  \f$ r^2 = ((u - u_0)/p_x)^2 + ((v - v_0)/p_y)^2 \f$.
+
+  \param cam : Camera parameters with distortion.
+  \param height, width : Size of the distorted images.
+  \param H : 3x3 homography from the remapped pixels to the undistorted pixels.
+  \param dstHeight, dstWidth : Size of the remapped images.
+
+  \exception vpException::dimensionError : If \e H is not a 3x3 matrix.
+  \exception vpException::badValue : If an image size exceeds the 32767
+  pixels of the 16 bits coordinates.
+*/
+void vpUndistortionMap::build(const vpCameraParameters &cam, unsigned int height, unsigned int width,
+                              const vpArray2D<double> &H, unsigned int dstHeight, unsigned int dstWidth)
+{
+  if (H.getRows() != 3 || H.getCols() != 3) {
+    throw(vpException(vpException::dimensionError, "The homography is a %dx%d matrix instead of 3x3",
+                      H.getRows(), H.getCols()));
+  }
+  if (height > (unsigned int)std::numeric_limits<short>::max() || width > (unsigned int)std::numeric_limits<short>::max()) {
+    throw(vpException(vpException::badValue, "Image %dx%d too large for 16 bits coordinates", height, width));
+  }
+
+  m_height = dstHeight;
+  m_width = dstWidth;
+  m_srcHeight = height;
+  m_srcWidth = width;
+  m_coords.resize(2 * (size_t)dstHeight * dstWidth);
+  m_fractions.resize(2 * (size_t)dstHeight * dstWidth);
+
+  const double u0 = cam.get_u0();
+  const double v0 = cam.get_v0();
+  const double kud_px2 = cam.get_kud() / (cam.get_px() * cam.get_px());
+  const double kud_py2 = cam.get_kud() / (cam.get_py() * cam.get_py());
+
+  short *c = m_coords.empty() ? NULL : &m_coords[0];
+  unsigned char *f = m_fractions.empty() ? NULL : &m_fractions[0];
+  for (unsigned int v = 0; v < dstHeight; v++) {
+    for (unsigned int u = 0; u < dstWidth; u++, c += 2, f += 2) {
+      const double x = H[0][0] * u + H[0][1] * v + H[0][2];
+      const double y = H[1][0] * u + H[1][1] * v + H[1][2];
+      const double z = H[2][0] * u + H[2][1] * v + H[2][2];
+      c[0] = c[1] = -1;
+      f[0] = f[1] = 0;
+      if (std::fabs(z) <= std::numeric_limits<double>::epsilon())
+        continue;
+
+      const double du = x / z - u0;
+      const double dv = y / z - v0;
+      const double fr = 1. + kud_px2 * du * du + kud_py2 * dv * dv;
+      const double ud = du * fr + u0;
+      const double vd = dv * fr + v0;
+      if (! (ud >= 0. && vd >= 0. && ud < width && vd < height))
+        continue;
+
+      // Fixed-point position, the fractional parts being rounded
+      const int ui = (int)(ud * one + 0.5);
+      const int vi = (int)(vd * one + 0.5);
+      const int col = ui >> interpolationBits;
+      const int row = vi >> interpolationBits;
+      if (col < (int)width - 1 && row < (int)height - 1) {
+        c[0] = (short)col;
+        c[1] = (short)row;
+        f[0] = (unsigned char)(ui & (one - 1));
+        f[1] = (unsigned char)(vi & (one - 1));
+      }
+    }
+  }
+}
+
+/*!
+  Remap a gray level image. Each pixel is the bilinear interpolation, in
+  fixed point, of the 4 neighbours of its source position.
+
+  \param I : Distorted image, of the size given to build().
+  \param Iout : Remapped image, resized to getHeight() x getWidth().
+  \param nbThreads : Number of threads, each one processing a band of rows.
+
+  \exception vpImageException::incorrectInitializationError : If the size of
+  \e I is not the one given to build(), or if \e Iout is \e I.
+*/
+void vpUndistortionMap::remap(const vpImage<unsigned char> &I, vpImage<unsigned char> &Iout,
+                              unsigned int nbThreads) const
+{
+  remapImage(I, Iout, m_height, m_width, m_srcHeight, m_srcWidth, m_coords, m_fractions, nbThreads);
+}
+
+/*!
+  Remap a color image, the 4 channels being interpolated as in
+  remap(const vpImage<unsigned char> &, vpImage<unsigned char> &, unsigned int) const.
+
+  \param I : Distorted image, of the size given to build().
+  \param Iout : Remapped image, resized to getHeight() x getWidth().
+  \param nbThreads : Number of threads, each one processing a band of rows.
+
+  \exception vpImageException::incorrectInitializationError : If the size of
+  \e I is not the one given to build(), or if \e Iout is \e I.
+*/
+void vpUndistortionMap::remap(const vpImage<vpRGBa> &I, vpImage<vpRGBa> &Iout, unsigned int nbThreads) const
+{
+  remapImage(I, Iout, m_height, m_width, m_srcHeight, m_srcWidth, m_coords, m_fractions, nbThreads);
+}
@@ -75,7 +75,7 @@ vpKalmanFilter::init(unsigned int size_state_vector, unsigned int size_measure_v
 
   Pest.resize(size_state*nsignal, size_state*nsignal) ; Pest = 0 ;
 
-  I.resize(size_state*nsignal, size_state*nsignal) ;
+  I.eye(size_state*nsignal) ;
   //  init_done = false ;
   iter = 0 ;
   dt = -1 ;
@@ -88,7 +88,7 @@ vpKalmanFilter::init(unsigned int size_state_vector, unsigned int size_measure_v
   
 */
 vpKalmanFilter::vpKalmanFilter()
-  : iter(0), size_state(0), size_measure(0), nsignal(0), verbose_mode(false),
+  : iter(0), size_state(0), size_measure(0), nsignal(0), verbose_mode(false), joseph_form(false),
     Xest(), Xpre(), F(), H(), R(), Q(), dt(-1), Ppre(), Pest(), W(), I()
 {
 }
@@ -101,7 +101,7 @@ vpKalmanFilter::vpKalmanFilter()
   \param n_signal : Number of signal to filter.
 */
 vpKalmanFilter::vpKalmanFilter(unsigned int n_signal)
-  : iter(0), size_state(0), size_measure(0), nsignal(n_signal), verbose_mode(false),
+  : iter(0), size_state(0), size_measure(0), nsignal(n_signal), verbose_mode(false), joseph_form(false),
     Xest(), Xpre(), F(), H(), R(), Q(), dt(-1), Ppre(), Pest(), W(), I()
 {
 }
@@ -119,7 +119,7 @@ vpKalmanFilter::vpKalmanFilter(unsigned int n_signal)
   \param n_signal : Number of signal to filter.
 */
 vpKalmanFilter::vpKalmanFilter(unsigned int size_state_vector, unsigned int size_measure_vector, unsigned int n_signal)
-  : iter(0), size_state(0), size_measure(0), nsignal(0), verbose_mode(false),
+  : iter(0), size_state(0), size_measure(0), nsignal(0), verbose_mode(false), joseph_form(false),
     Xest(), Xpre(), F(), H(), R(), Q(), dt(-1), Ppre(), Pest(), W(), I()
 {
   init( size_state_vector, size_measure_vector, n_signal) ;
@@ -206,6 +206,11 @@ vpKalmanFilter::prediction()
   \f[
   {\bf S}_k = {\bf H P}_{k \mid k-1} {\bf H}^T + {\bf R}_k
   \f]
+  or, when the Joseph form is selected with setJosephForm(), by
+  \f[
+  {\bf P}_{k \mid k} = \left({\bf I} - {\bf W}_k {\bf H} \right) {\bf P}_{k \mid k-1}
+  \left({\bf I} - {\bf W}_k {\bf H} \right)^T + {\bf W}_k {\bf R}_k {\bf W}^T_k
+  \f]
 
 */
 void
@@ -221,8 +226,15 @@ vpKalmanFilter::filtering(const vpColVector &z)
   W = (Ppre * H.t())* (S).inverseByLU() ;
   if (verbose_mode)
     std::cout << "W " << std::endl << W << std::endl ;
-  // Bar-Shalom  5.2.3.15
-  Pest = Ppre - W*S*W.t() ;
+  if (joseph_form) {
+    // Joseph form, symmetric and positive definite whatever the gain
+    vpMatrix A = I - W*H ;
+    Pest = A*Ppre*A.t() + W*R*W.t() ;
+  }
+  else {
+    // Bar-Shalom  5.2.3.15
+    Pest = Ppre - W*S*W.t() ;
+  }
   if (verbose_mode)
     std::cout << "Pest " << std::endl << Pest << std::endl ;
 
@@ -0,0 +1,441 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Kalman filtering of many independent signals at once.
+ *
+ *****************************************************************************/
+
+#include <algorithm>
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpKalmanFilterBatch.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
+namespace {
+  // Index in the packed upper triangle of a symmetric n x n matrix
+  inline unsigned int sym(unsigned int n, unsigned int i, unsigned int j)
+  {
+    if (i > j) {
+      unsigned int t = i; i = j; j = t;
+    }
+    return i * n - i * (i - 1) / 2 + (j - i);
+  }
+
+  // Arithmetic on one signal
+  struct vpScalarLane
+  {
+    typedef double type;
+    static const unsigned int width = 1;
+    static inline type load(const double *p) { return *p; }
+    static inline void store(double *p, type a) { *p = a; }
+    static inline type set(double a) { return a; }
+    static inline type add(type a, type b) { return a + b; }
+    static inline type sub(type a, type b) { return a - b; }
+    static inline type mul(type a, type b) { return a * b; }
+    static inline type div(type a, type b) { return a / b; }
+  };
+
+#if VISP_HAVE_SSE2
+  // Arithmetic on two consecutive signals
+  struct vpSSE2Lane
+  {
+    typedef __m128d type;
+    static const unsigned int width = 2;
+    static inline type load(const double *p) { return _mm_loadu_pd(p); }
+    static inline void store(double *p, type a) { _mm_storeu_pd(p, a); }
+    static inline type set(double a) { return _mm_set1_pd(a); }
+    static inline type add(type a, type b) { return _mm_add_pd(a, b); }
+    static inline type sub(type a, type b) { return _mm_sub_pd(a, b); }
+    static inline type mul(type a, type b) { return _mm_mul_pd(a, b); }
+    static inline type div(type a, type b) { return _mm_div_pd(a, b); }
+  };
+#endif
+
+  // Pointers to the arrays of the filters, offset to the first signal to update
+  struct vpBatchArrays
+  {
+    double *x[3], *xp[3], *P[6], *Pp[6];
+    const double *Q[6], *R;
+  };
+
+  inline double *data(std::vector<double> &v) { return v.empty() ? NULL : &v[0]; }
+
+  void getArrays(vpBatchArrays &a, std::vector<double> *x, std::vector<double> *xp, std::vector<double> *P,
+                 std::vector<double> *Pp, std::vector<double> *Q, std::vector<double> &R)
+  {
+    for (unsigned int k = 0; k < 3; k++) {
+      a.x[k] = data(x[k]);
+      a.xp[k] = data(xp[k]);
+    }
+    for (unsigned int k = 0; k < 6; k++) {
+      a.P[k] = data(P[k]);
+      a.Pp[k] = data(Pp[k]);
+      a.Q[k] = data(Q[k]);
+    }
+    a.R = data(R);
+  }
+
+  // Filtering of the signals from i, with a measure of the first state component:
+  // S = Pp00 + R, K = Pp(:,0) / S, x = xp + K (z - xp0) and
+  // P = Pp - K S K^T or, with the Joseph form, P = (I - K H) Pp (I - K H)^T + K R K^T
+  template <unsigned int N, class L>
+  inline void filtering(const vpBatchArrays &a, const double *z, unsigned int i, bool joseph)
+  {
+    typedef typename L::type T;
+    T Pp[N][N], K[N];
+    for (unsigned int r = 0; r < N; r++)
+      for (unsigned int c = r; c < N; c++)
+        Pp[r][c] = Pp[c][r] = L::load(a.Pp[sym(N, r, c)] + i);
+
+    T R = L::load(a.R + i);
+    T invS = L::div(L::set(1.), L::add(Pp[0][0], R));
+    T innovation = L::sub(L::load(z + i), L::load(a.xp[0] + i));
+    for (unsigned int r = 0; r < N; r++) {
+      K[r] = L::mul(Pp[r][0], invS);
+      L::store(a.x[r] + i, L::add(L::load(a.xp[r] + i), L::mul(K[r], innovation)));
+    }
+
+    if (joseph) {
+      // AP = (I - K H) Pp, then P = AP (I - K H)^T + K R K^T
+      T AP[N][N];
+      for (unsigned int r = 0; r < N; r++)
+        for (unsigned int c = 0; c < N; c++)
+          AP[r][c] = L::sub(Pp[r][c], L::mul(K[r], Pp[0][c]));
+      for (unsigned int r = 0; r < N; r++) {
+        T KR = L::mul(K[r], R);
+        for (unsigned int c = r; c < N; c++)
+          L::store(a.P[sym(N, r, c)] + i,
+                   L::add(L::sub(AP[r][c], L::mul(AP[r][0], K[c])), L::mul(KR, K[c])));
+      }
+    } else {
+      for (unsigned int r = 0; r < N; r++)
+        for (unsigned int c = r; c < N; c++)
+          L::store(a.P[sym(N, r, c)] + i, L::sub(Pp[r][c], L::mul(K[r], Pp[c][0])));
+    }
+  }
+
+  // Prediction of the signals from i: xp = F x and Pp = F P F^T + Q
+  template <unsigned int N, class L>
+  inline void prediction(const vpBatchArrays &a, const double F[3][3], unsigned int i)
+  {
+    typedef typename L::type T;
+    T x[N], P[N][N], FP[N][N];
+    for (unsigned int r = 0; r < N; r++) {
+      x[r] = L::load(a.x[r] + i);
+      for (unsigned int c = r; c < N; c++)
+        P[r][c] = P[c][r] = L::load(a.P[sym(N, r, c)] + i);
+    }
+
+    for (unsigned int r = 0; r < N; r++) {
+      T s = L::set(0.);
+      for (unsigned int k = 0; k < N; k++)
+        if (F[r][k] != 0.)
+          s = L::add(s, L::mul(L::set(F[r][k]), x[k]));
+      L::store(a.xp[r] + i, s);
+
+      for (unsigned int c = 0; c < N; c++) {
+        T t = L::set(0.);
+        for (unsigned int k = 0; k < N; k++)
+          if (F[r][k] != 0.)
+            t = L::add(t, L::mul(L::set(F[r][k]), P[k][c]));
+        FP[r][c] = t;
+      }
+    }
+
+    for (unsigned int r = 0; r < N; r++) {
+      for (unsigned int c = r; c < N; c++) {
+        T s = L::load(a.Q[sym(N, r, c)] + i);
+        for (unsigned int k = 0; k < N; k++)
+          if (F[c][k] != 0.)
+            s = L::add(s, L::mul(FP[r][k], L::set(F[c][k])));
+        L::store(a.Pp[sym(N, r, c)] + i, s);
+      }
+    }
+  }
+
+  // One filtering step followed by a prediction step for all the signals
+  template <unsigned int N>
+  void update(const vpBatchArrays &a, const double F[3][3], const double *z, unsigned int n, bool joseph)
+  {
+    unsigned int i = 0;
+#if VISP_HAVE_SSE2
+    for (; i + vpSSE2Lane::width <= n; i += vpSSE2Lane::width) {
+      filtering<N, vpSSE2Lane>(a, z, i, joseph);
+      prediction<N, vpSSE2Lane>(a, F, i);
+    }
+#endif
+    for (; i < n; i++) {
+      filtering<N, vpScalarLane>(a, z, i, joseph);
+      prediction<N, vpScalarLane>(a, F, i);
+    }
+  }
+
+  template <unsigned int N>
+  void predict(const vpBatchArrays &a, const double F[3][3], unsigned int n)
+  {
+    unsigned int i = 0;
+#if VISP_HAVE_SSE2
+    for (; i + vpSSE2Lane::width <= n; i += vpSSE2Lane::width)
+      prediction<N, vpSSE2Lane>(a, F, i);
+#endif
+    for (; i < n; i++)
+      prediction<N, vpScalarLane>(a, F, i);
+  }
+}
+
+/*!
+  Default constructor. initFilter() has to be called before filter().
+*/
+vpKalmanFilterBatch::vpKalmanFilterBatch()
+  : m_model(vpLinearKalmanFilterInstantiation::unknown), m_stateSize(0), m_nsignal(0), m_iter(0), m_dt(-1),
+    m_josephForm(false), m_R()
+{
+  for (unsigned int i = 0; i < 3; i++)
+    for (unsigned int j = 0; j < 3; j++)
+      m_F[i][j] = 0;
+}
+
+/*!
+  Initialize the filters of all the signals with one of the state models of
+  vpLinearKalmanFilterInstantiation. The parameters are the ones of
+  vpLinearKalmanFilterInstantiation::initFilter().
+
+  \param model : State model, see vpLinearKalmanFilterInstantiation::vpStateModel.
+  \param nsignal : Number of signals to filter.
+  \param sigma_state : Variance of the state noise, of dimension the size of
+  the state of the model multiplied by \e nsignal.
+  \param sigma_measure : Variance of the measurement noise, of dimension \e nsignal.
+  \param rho : Degree of correlation between successive accelerations of the
+  models with colored noise, in [0:1[.
+  \param dt : Sampling time in second, not used by
+  vpLinearKalmanFilterInstantiation::stateConstVelWithColoredNoise_MeasureVel.
+
+  \exception vpException::notInitialized : If the state model is unknown.
+  \exception vpException::badValue : If \e rho is not in [0:1[.
+  \exception vpException::dimensionError : If the noise vectors do not have
+  the expected size.
+*/
+void vpKalmanFilterBatch::initFilter(vpLinearKalmanFilterInstantiation::vpStateModel model, unsigned int nsignal,
+                                     const vpColVector &sigma_state, const vpColVector &sigma_measure, double rho,
+                                     double dt)
+{
+  unsigned int n;
+  switch (model) {
+  case vpLinearKalmanFilterInstantiation::stateConstVel_MeasurePos:
+  case vpLinearKalmanFilterInstantiation::stateConstVelWithColoredNoise_MeasureVel:
+    n = 2;
+    break;
+  case vpLinearKalmanFilterInstantiation::stateConstAccWithColoredNoise_MeasureVel:
+    n = 3;
+    break;
+  default:
+    throw(vpException(vpException::notInitialized, "Kalman state model is not set"));
+  }
+  if (model != vpLinearKalmanFilterInstantiation::stateConstVel_MeasurePos && ((rho < 0) || (rho >= 1)))
+    throw(vpException(vpException::badValue, "Bad rho value %g; should be in [0:1[", rho));
+  if (sigma_state.size() != n * nsignal || sigma_measure.size() != nsignal)
+    throw(vpException(vpException::dimensionError, "Bad noise vector sizes %d and %d for %d signals",
+                      sigma_state.size(), sigma_measure.size(), nsignal));
+
+  m_model = model;
+  m_stateSize = n;
+  m_nsignal = nsignal;
+  m_iter = 0;
+  m_dt = dt;
+
+  for (unsigned int k = 0; k < 3; k++) {
+    m_x[k].assign(k < n ? nsignal : 0, 0.);
+    m_xp[k].assign(k < n ? nsignal : 0, 0.);
+  }
+  for (unsigned int k = 0; k < 6; k++) {
+    m_P[k].assign(k < n * (n + 1) / 2 ? nsignal : 0, 0.);
+    m_Pp[k].assign(k < n * (n + 1) / 2 ? nsignal : 0, 0.);
+    m_Q[k].assign(k < n * (n + 1) / 2 ? nsignal : 0, 0.);
+  }
+  m_R.resize(nsignal);
+  for (unsigned int i = 0; i < 3; i++)
+    for (unsigned int j = 0; j < 3; j++)
+      m_F[i][j] = 0;
+
+  // Same models as in vpLinearKalmanFilterInstantiation
+  double dt2 = dt * dt;
+  double dt3 = dt2 * dt;
+  switch (model) {
+  case vpLinearKalmanFilterInstantiation::stateConstVel_MeasurePos:
+    m_F[0][0] = 1;
+    m_F[0][1] = dt;
+    m_F[1][1] = 1;
+    for (unsigned int i = 0; i < nsignal; i++) {
+      double sR = sigma_measure[i];
+      double sQ = sigma_state[2 * i];
+      m_R[i] = sR;
+      m_Q[sym(2, 0, 0)][i] = sQ * dt3 / 3;
+      m_Q[sym(2, 0, 1)][i] = sQ * dt2 / 2;
+      m_Q[sym(2, 1, 1)][i] = sQ * dt;
+      m_P[sym(2, 0, 0)][i] = sR;
+      m_P[sym(2, 0, 1)][i] = sR / (2 * dt);
+      m_P[sym(2, 1, 1)][i] = sQ * 2 * dt / 3.0 + sR / (2 * dt2);
+    }
+    break;
+  case vpLinearKalmanFilterInstantiation::stateConstVelWithColoredNoise_MeasureVel:
+    m_F[0][0] = 1;
+    m_F[0][1] = 1;
+    m_F[1][1] = rho;
+    for (unsigned int i = 0; i < nsignal; i++) {
+      double sR = sigma_measure[i];
+      double sQ = sigma_state[2 * i + 1];
+      m_R[i] = sR;
+      m_Q[sym(2, 1, 1)][i] = sQ;
+      m_P[sym(2, 0, 0)][i] = sR;
+      m_P[sym(2, 1, 1)][i] = sQ / (1 - rho * rho);
+    }
+    break;
+  default:
+    m_F[0][0] = 1;
+    m_F[0][1] = 1;
+    m_F[0][2] = dt;
+    m_F[1][1] = rho;
+    m_F[2][2] = 1;
+    for (unsigned int i = 0; i < nsignal; i++) {
+      double sR = sigma_measure[i];
+      double sQ1 = sigma_state[3 * i + 1];
+      double sQ2 = sigma_state[3 * i + 2];
+      m_R[i] = sR;
+      m_Q[sym(3, 1, 1)][i] = sQ1;
+      m_Q[sym(3, 2, 2)][i] = sQ2;
+      m_P[sym(3, 0, 0)][i] = sR;
+      m_P[sym(3, 0, 2)][i] = sR / dt;
+      m_P[sym(3, 1, 1)][i] = sQ1 / (1 - rho * rho);
+      m_P[sym(3, 1, 2)][i] = -rho * sQ1 / ((1 - rho * rho) * dt);
+      m_P[sym(3, 2, 2)][i] = (2 * sR + sQ1 / (1 - rho * rho)) / (dt * dt);
+    }
+    break;
+  }
+}
+
+/*!
+  Do the filtering and the prediction of all the signals, following the same
+  sequence as vpLinearKalmanFilterInstantiation::filter(): the first
+  measures initialize the state, the next ones are filtered.
+
+  \param z : Measures of the signals, of dimension getNumberOfSignal().
+
+  \exception vpException::notInitialized : If the filter is not initialized.
+  \exception vpException::dimensionError : If \e z does not have the expected size.
+*/
+void vpKalmanFilterBatch::filter(const vpColVector &z)
+{
+  if (z.size() != m_nsignal)
+    throw(vpException(vpException::dimensionError, "The measure vector size %d differs from the number of signals %d",
+                      z.size(), m_nsignal));
+  filter(z.data);
+}
+
+/*!
+  Do the filtering and the prediction of all the signals.
+
+  \param z : Array of getNumberOfSignal() measures.
+
+  \exception vpException::notInitialized : If the filter is not initialized.
+*/
+void vpKalmanFilterBatch::filter(const double *z)
+{
+  if (m_nsignal < 1)
+    throw(vpException(vpException::notInitialized, "Bad signal number. You need to initialize the Kalman filter"));
+
+  if (m_iter == 0) {
+    for (unsigned int k = 0; k < m_stateSize; k++)
+      std::fill(m_x[k].begin(), m_x[k].end(), 0.);
+    std::copy(z, z + m_nsignal, m_x[0].begin());
+    prediction();
+    m_iter++;
+    return;
+  } else if (m_iter == 1 && m_model == vpLinearKalmanFilterInstantiation::stateConstVel_MeasurePos) {
+    for (unsigned int i = 0; i < m_nsignal; i++) {
+      double z_prev = m_x[0][i];
+      m_x[0][i] = z[i];
+      m_x[1][i] = (z[i] - z_prev) / m_dt;
+    }
+    prediction();
+    m_iter++;
+    return;
+  }
+
+  filtering(z);
+}
+
+void vpKalmanFilterBatch::prediction()
+{
+  vpBatchArrays a;
+  getArrays(a, m_x, m_xp, m_P, m_Pp, m_Q, m_R);
+  if (m_stateSize == 2)
+    predict<2>(a, m_F, m_nsignal);
+  else
+    predict<3>(a, m_F, m_nsignal);
+}
+
+void vpKalmanFilterBatch::filtering(const double *z)
+{
+  vpBatchArrays a;
+  getArrays(a, m_x, m_xp, m_P, m_Pp, m_Q, m_R);
+  if (m_stateSize == 2)
+    update<2>(a, m_F, z, m_nsignal, m_josephForm);
+  else
+    update<3>(a, m_F, z, m_nsignal, m_josephForm);
+  m_iter++;
+}
+
+/*!
+  Return the updated state of all the signals in a vector laid out as
+  vpKalmanFilter::Xest, the state of the signal \e i starting at index
+  \e i * getStateSize().
+*/
+void vpKalmanFilterBatch::getStateEstimate(vpColVector &Xest) const
+{
+  Xest.resize(m_stateSize * m_nsignal, false);
+  for (unsigned int i = 0; i < m_nsignal; i++)
+    for (unsigned int k = 0; k < m_stateSize; k++)
+      Xest[m_stateSize * i + k] = m_x[k][i];
+}
+
+/*!
+  Return the element (\e k, \e l) of the updated state covariance of the
+  signal \e signal.
+*/
+double vpKalmanFilterBatch::getCovarianceEstimate(unsigned int signal, unsigned int k, unsigned int l) const
+{
+  if (signal >= m_nsignal || k >= m_stateSize || l >= m_stateSize)
+    throw(vpException(vpException::dimensionError, "Bad covariance element (%d, %d) of signal %d", k, l, signal));
+  return m_P[sym(m_stateSize, k, l)][signal];
+}
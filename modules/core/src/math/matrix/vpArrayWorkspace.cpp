@@ -0,0 +1,138 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Arena providing the storage of 2D arrays within iterative algorithms.
+ *
+ *****************************************************************************/
+
+#include <stdlib.h>
+
+#include <visp3/core/vpArrayWorkspace.h>
+#include <visp3/core/vpException.h>
+
+/*!
+  Create a workspace which buffer has a size of \e capacity bytes. When the
+  capacity is not known in advance, keep the default value: the buffer is
+  sized at the first reset() from the needs of the first frame.
+*/
+vpArrayWorkspace::vpArrayWorkspace(size_t capacity)
+  : m_buffer(NULL), m_begin(NULL), m_capacity(0), m_used(0), m_needed(capacity),
+    m_bytesRequested(0), m_bytesServed(0), m_arrays()
+{
+  reset();
+}
+
+/*!
+  Destructor. The arrays still bound to the workspace lose the storage they
+  hold in it and are unbound.
+*/
+vpArrayWorkspace::~vpArrayWorkspace()
+{
+  releaseArrays(true);
+  m_arrays.clear();
+  if (m_buffer != NULL)
+    free(m_buffer);
+}
+
+/*!
+  Return a block of \e bytes bytes aligned on vpArrayWorkspace::alignment, or
+  NULL if the buffer is full. In the latter case the caller is expected to
+  allocate the block on the heap.
+*/
+void *vpArrayWorkspace::allocate(size_t bytes)
+{
+  size_t size = alignSize(bytes);
+  m_bytesRequested += bytes;
+  m_needed += size;
+  if (m_used + size > m_capacity)
+    return NULL;
+
+  void *block = m_begin + m_used;
+  m_used += size;
+  m_bytesServed += bytes;
+  return block;
+}
+
+/*!
+  Release all the blocks at once. The arrays bound to the workspace become
+  empty. If the buffer was too small since the previous reset(), it is
+  enlarged to the size that would have been needed.
+*/
+void vpArrayWorkspace::reset()
+{
+  releaseArrays(false);
+
+  if (m_needed > m_capacity) {
+    if (m_buffer != NULL)
+      free(m_buffer);
+    m_buffer = (unsigned char *)malloc(m_needed + alignment);
+    if (m_buffer == NULL) {
+      m_begin = NULL;
+      m_capacity = 0;
+      throw(vpException(vpException::memoryAllocationError,
+                        "Memory allocation error when allocating the workspace buffer"));
+    }
+    m_begin = m_buffer + (alignment - ((size_t)m_buffer & (alignment - 1))) % alignment;
+    m_capacity = m_needed;
+  }
+  m_used = 0;
+  m_needed = 0;
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+/*!
+  Register an array bound to the workspace. \e release is called by reset()
+  and by the destructor to release the storage of the array.
+*/
+void vpArrayWorkspace::attach(void *array, vpReleaseFunction release)
+{
+  m_arrays.push_back(std::make_pair(array, release));
+}
+
+/*!
+  Unregister an array bound to the workspace.
+*/
+void vpArrayWorkspace::detach(void *array)
+{
+  for (size_t i = 0; i < m_arrays.size(); i++) {
+    if (m_arrays[i].first == array) {
+      m_arrays[i] = m_arrays.back();
+      m_arrays.pop_back();
+      return;
+    }
+  }
+}
+#endif
+
+void vpArrayWorkspace::releaseArrays(bool detach)
+{
+  for (size_t i = 0; i < m_arrays.size(); i++)
+    m_arrays[i].second(m_arrays[i].first, detach);
+}
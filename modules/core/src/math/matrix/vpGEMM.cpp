@@ -0,0 +1,420 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Packed and cache blocked matrix multiplication.
+ *
+ *****************************************************************************/
+
+#include <vector>
+#include <string.h>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpGEMM.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
+#if defined(__ARM_NEON) && defined(__aarch64__)
+#  include <arm_neon.h>
+#  define VISP_HAVE_NEON_FP64 1
+#endif
+
+// AVX2/FMA micro kernel compiled with a function level target attribute and
+// selected at runtime, so that the library does not need to be built with -mavx2
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    ((defined(__GNUC__) && (__GNUC__ >= 5)) || defined(__clang__))
+#  include <immintrin.h>
+#  define VISP_HAVE_AVX2_DISPATCH 1
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+// Register block size of the micro kernels
+const unsigned int vpGemmMR = 4;
+const unsigned int vpGemmNR = 8;
+// Cache block sizes: a packed A block (MC x KC) fits in L2, a packed
+// B micro panel (KC x NR) fits in L1
+const unsigned int vpGemmMC = 128;
+const unsigned int vpGemmKC = 256;
+const unsigned int vpGemmNC = 2048;
+// Below this number of multiply-add the packing overhead is not worth it
+const double vpGemmSmallSize = 4096.;
+
+typedef void (*vpGemmMicroKernel)(unsigned int kc, const double *Ap, const double *Bp, double *tile);
+
+/*
+  Pack a mc x kc block of op(A) in row panels of vpGemmMR rows. Element
+  (i,k) of op(A) is A[i*rs + k*cs]. Incomplete panels are padded with zeros.
+*/
+void vpGemmPackA(unsigned int mc, unsigned int kc, const double *A, size_t rs, size_t cs, double *Ap)
+{
+  for (unsigned int i = 0; i < mc; i += vpGemmMR) {
+    unsigned int mr = (mc - i < vpGemmMR) ? (mc - i) : vpGemmMR;
+    const double *a = A + i*rs;
+    if (mr == vpGemmMR && rs == 1) {
+      for (unsigned int k = 0; k < kc; k++, a += cs, Ap += vpGemmMR) {
+        Ap[0] = a[0]; Ap[1] = a[1]; Ap[2] = a[2]; Ap[3] = a[3];
+      }
+    }
+    else if (rs == 1) {
+      // Unrolled partial copy; a loop would be turned into memcpy() calls
+      memset(Ap, 0, kc*vpGemmMR*sizeof(double));
+      for (unsigned int k = 0; k < kc; k++, a += cs, Ap += vpGemmMR) {
+        switch (mr) {
+        case 3: Ap[2] = a[2]; // fall through
+        case 2: Ap[1] = a[1]; // fall through
+        default: Ap[0] = a[0];
+        }
+      }
+    }
+    else {
+      for (unsigned int k = 0; k < kc; k++, a += cs, Ap += vpGemmMR) {
+        unsigned int r = 0;
+        for (; r < mr; r++)
+          Ap[r] = a[r*rs];
+        for (; r < vpGemmMR; r++)
+          Ap[r] = 0.;
+      }
+    }
+  }
+}
+
+/*
+  Pack a kc x nc block of op(B) in column panels of vpGemmNR columns. Element
+  (k,j) of op(B) is B[k*rs + j*cs]. Incomplete panels are padded with zeros.
+*/
+void vpGemmPackB(unsigned int kc, unsigned int nc, const double *B, size_t rs, size_t cs, double *Bp)
+{
+  for (unsigned int j = 0; j < nc; j += vpGemmNR) {
+    unsigned int nr = (nc - j < vpGemmNR) ? (nc - j) : vpGemmNR;
+    const double *b = B + j*cs;
+    if (nr == vpGemmNR && cs == 1) {
+      for (unsigned int k = 0; k < kc; k++, b += rs, Bp += vpGemmNR)
+        memcpy(Bp, b, vpGemmNR*sizeof(double));
+    }
+    else if (cs == 1) {
+      memset(Bp, 0, kc*vpGemmNR*sizeof(double));
+      for (unsigned int k = 0; k < kc; k++, b += rs, Bp += vpGemmNR) {
+        switch (nr) {
+        case 7: Bp[6] = b[6]; // fall through
+        case 6: Bp[5] = b[5]; // fall through
+        case 5: Bp[4] = b[4]; // fall through
+        case 4: Bp[3] = b[3]; // fall through
+        case 3: Bp[2] = b[2]; // fall through
+        case 2: Bp[1] = b[1]; // fall through
+        default: Bp[0] = b[0];
+        }
+      }
+    }
+    else {
+      for (unsigned int k = 0; k < kc; k++, b += rs, Bp += vpGemmNR) {
+        unsigned int c = 0;
+        for (; c < nr; c++)
+          Bp[c] = b[c*cs];
+        for (; c < vpGemmNR; c++)
+          Bp[c] = 0.;
+      }
+    }
+  }
+}
+
+void vpGemmKernelScalar(unsigned int kc, const double *Ap, const double *Bp, double *tile)
+{
+  double t[vpGemmMR*vpGemmNR];
+  for (unsigned int i = 0; i < vpGemmMR*vpGemmNR; i++)
+    t[i] = 0.;
+
+  for (unsigned int k = 0; k < kc; k++, Ap += vpGemmMR, Bp += vpGemmNR) {
+    for (unsigned int r = 0; r < vpGemmMR; r++) {
+      double a = Ap[r];
+      double *tr = t + r*vpGemmNR;
+      for (unsigned int c = 0; c < vpGemmNR; c++)
+        tr[c] += a * Bp[c];
+    }
+  }
+
+  memcpy(tile, t, sizeof(t));
+}
+
+#if VISP_HAVE_SSE2
+void vpGemmKernelSSE2(unsigned int kc, const double *Ap, const double *Bp, double *tile)
+{
+  // Two 4x4 halves to stay within the 16 xmm registers
+  for (unsigned int h = 0; h < vpGemmNR; h += 4) {
+    __m128d c00 = _mm_setzero_pd(), c01 = _mm_setzero_pd();
+    __m128d c10 = _mm_setzero_pd(), c11 = _mm_setzero_pd();
+    __m128d c20 = _mm_setzero_pd(), c21 = _mm_setzero_pd();
+    __m128d c30 = _mm_setzero_pd(), c31 = _mm_setzero_pd();
+    const double *a = Ap;
+    const double *b = Bp + h;
+    for (unsigned int k = 0; k < kc; k++, a += vpGemmMR, b += vpGemmNR) {
+      __m128d b0 = _mm_loadu_pd(b);
+      __m128d b1 = _mm_loadu_pd(b + 2);
+      __m128d av;
+      av = _mm_set1_pd(a[0]);
+      c00 = _mm_add_pd(c00, _mm_mul_pd(av, b0)); c01 = _mm_add_pd(c01, _mm_mul_pd(av, b1));
+      av = _mm_set1_pd(a[1]);
+      c10 = _mm_add_pd(c10, _mm_mul_pd(av, b0)); c11 = _mm_add_pd(c11, _mm_mul_pd(av, b1));
+      av = _mm_set1_pd(a[2]);
+      c20 = _mm_add_pd(c20, _mm_mul_pd(av, b0)); c21 = _mm_add_pd(c21, _mm_mul_pd(av, b1));
+      av = _mm_set1_pd(a[3]);
+      c30 = _mm_add_pd(c30, _mm_mul_pd(av, b0)); c31 = _mm_add_pd(c31, _mm_mul_pd(av, b1));
+    }
+    _mm_storeu_pd(tile + 0*vpGemmNR + h, c00); _mm_storeu_pd(tile + 0*vpGemmNR + h + 2, c01);
+    _mm_storeu_pd(tile + 1*vpGemmNR + h, c10); _mm_storeu_pd(tile + 1*vpGemmNR + h + 2, c11);
+    _mm_storeu_pd(tile + 2*vpGemmNR + h, c20); _mm_storeu_pd(tile + 2*vpGemmNR + h + 2, c21);
+    _mm_storeu_pd(tile + 3*vpGemmNR + h, c30); _mm_storeu_pd(tile + 3*vpGemmNR + h + 2, c31);
+  }
+}
+#endif
+
+#if VISP_HAVE_AVX2_DISPATCH
+__attribute__((target("avx2,fma")))
+void vpGemmKernelAVX2(unsigned int kc, const double *Ap, const double *Bp, double *tile)
+{
+  __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+  __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+  __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+  __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+  for (unsigned int k = 0; k < kc; k++, Ap += vpGemmMR, Bp += vpGemmNR) {
+    __m256d b0 = _mm256_loadu_pd(Bp);
+    __m256d b1 = _mm256_loadu_pd(Bp + 4);
+    __m256d av;
+    av = _mm256_broadcast_sd(Ap);
+    c00 = _mm256_fmadd_pd(av, b0, c00); c01 = _mm256_fmadd_pd(av, b1, c01);
+    av = _mm256_broadcast_sd(Ap + 1);
+    c10 = _mm256_fmadd_pd(av, b0, c10); c11 = _mm256_fmadd_pd(av, b1, c11);
+    av = _mm256_broadcast_sd(Ap + 2);
+    c20 = _mm256_fmadd_pd(av, b0, c20); c21 = _mm256_fmadd_pd(av, b1, c21);
+    av = _mm256_broadcast_sd(Ap + 3);
+    c30 = _mm256_fmadd_pd(av, b0, c30); c31 = _mm256_fmadd_pd(av, b1, c31);
+  }
+  _mm256_storeu_pd(tile,      c00); _mm256_storeu_pd(tile + 4,  c01);
+  _mm256_storeu_pd(tile + 8,  c10); _mm256_storeu_pd(tile + 12, c11);
+  _mm256_storeu_pd(tile + 16, c20); _mm256_storeu_pd(tile + 20, c21);
+  _mm256_storeu_pd(tile + 24, c30); _mm256_storeu_pd(tile + 28, c31);
+}
+#endif
+
+#if VISP_HAVE_NEON_FP64
+void vpGemmKernelNEON(unsigned int kc, const double *Ap, const double *Bp, double *tile)
+{
+  float64x2_t c[vpGemmMR][4];
+  for (unsigned int r = 0; r < vpGemmMR; r++)
+    for (unsigned int q = 0; q < 4; q++)
+      c[r][q] = vdupq_n_f64(0.);
+
+  for (unsigned int k = 0; k < kc; k++, Ap += vpGemmMR, Bp += vpGemmNR) {
+    float64x2_t b0 = vld1q_f64(Bp), b1 = vld1q_f64(Bp + 2);
+    float64x2_t b2 = vld1q_f64(Bp + 4), b3 = vld1q_f64(Bp + 6);
+    for (unsigned int r = 0; r < vpGemmMR; r++) {
+      c[r][0] = vfmaq_n_f64(c[r][0], b0, Ap[r]);
+      c[r][1] = vfmaq_n_f64(c[r][1], b1, Ap[r]);
+      c[r][2] = vfmaq_n_f64(c[r][2], b2, Ap[r]);
+      c[r][3] = vfmaq_n_f64(c[r][3], b3, Ap[r]);
+    }
+  }
+
+  for (unsigned int r = 0; r < vpGemmMR; r++)
+    for (unsigned int q = 0; q < 4; q++)
+      vst1q_f64(tile + r*vpGemmNR + 2*q, c[r][q]);
+}
+#endif
+
+vpGemmMicroKernel vpGemmSelectKernel()
+{
+#if VISP_HAVE_AVX2_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+    return vpGemmKernelAVX2;
+#endif
+#if VISP_HAVE_SSE2
+  return vpGemmKernelSSE2;
+#elif VISP_HAVE_NEON_FP64
+  return vpGemmKernelNEON;
+#else
+  return vpGemmKernelScalar;
+#endif
+}
+
+vpGemmMicroKernel vpGemmGetKernel()
+{
+  static vpGemmMicroKernel kernel = vpGemmSelectKernel();
+  return kernel;
+}
+
+const char *vpGemmKernelName(vpGemmMicroKernel kernel)
+{
+#if VISP_HAVE_AVX2_DISPATCH
+  if (kernel == vpGemmKernelAVX2)
+    return "AVX2";
+#endif
+#if VISP_HAVE_SSE2
+  if (kernel == vpGemmKernelSSE2)
+    return "SSE2";
+#endif
+#if VISP_HAVE_NEON_FP64
+  if (kernel == vpGemmKernelNEON)
+    return "NEON";
+#endif
+  if (kernel == vpGemmKernelScalar)
+    return "scalar";
+  return "unknown";
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Compute \f$ C = \alpha \, op(A) \, op(B) + \beta \, C \f$ on row-major arrays,
+  where \f$ op(X) \f$ is \f$ X \f$ or \f$ X^T \f$.
+
+  This is the computational engine behind vpGEMM(), vpMatrix::mult2Matrices(),
+  vpMatrix::AtA() and vpMatrix::AAt(). It does not depend on any third-party
+  library. Operands are packed in cache-sized blocks and the inner product is
+  computed by a register-blocked micro kernel that uses AVX2/FMA when the CPU
+  supports it (detected at runtime), SSE2 or NEON otherwise. Small products
+  are computed with a plain loop.
+
+  \param M : Number of rows of \f$ op(A) \f$ and \f$ C \f$.
+  \param N : Number of columns of \f$ op(B) \f$ and \f$ C \f$.
+  \param K : Number of columns of \f$ op(A) \f$ and rows of \f$ op(B) \f$.
+  \param alpha : Scalar applied to the product.
+  \param A : Pointer to the first element of A.
+  \param lda : Row stride of A, i.e. its number of columns.
+  \param transA : If true, \f$ op(A) = A^T \f$.
+  \param B : Pointer to the first element of B.
+  \param ldb : Row stride of B.
+  \param transB : If true, \f$ op(B) = B^T \f$.
+  \param beta : Scalar applied to C. When null, C is not read.
+  \param C : Pointer to the first element of the M-by-N result.
+  \param ldc : Row stride of C.
+
+  \warning C must not overlap A or B.
+
+  \relates vpArray2D
+*/
+void vpGEMMBlocked(unsigned int M, unsigned int N, unsigned int K, double alpha,
+                   const double *A, unsigned int lda, bool transA,
+                   const double *B, unsigned int ldb, bool transB,
+                   double beta, double *C, unsigned int ldc)
+{
+  if (M == 0 || N == 0)
+    return;
+
+  if (beta == 0.) {
+    for (unsigned int i = 0; i < M; i++)
+      memset(C + (size_t)i*ldc, 0, N*sizeof(double));
+  }
+  else if (beta != 1.) {
+    for (unsigned int i = 0; i < M; i++) {
+      double *c = C + (size_t)i*ldc;
+      for (unsigned int j = 0; j < N; j++)
+        c[j] *= beta;
+    }
+  }
+
+  if (K == 0 || alpha == 0.)
+    return;
+
+  // op(A)(i,k) = A[i*rsa + k*csa], op(B)(k,j) = B[k*rsb + j*csb]
+  size_t rsa = transA ? 1 : lda;
+  size_t csa = transA ? lda : 1;
+  size_t rsb = transB ? 1 : ldb;
+  size_t csb = transB ? ldb : 1;
+
+  if ((double)M * (double)N * (double)K < vpGemmSmallSize) {
+    for (unsigned int i = 0; i < M; i++) {
+      double *c = C + (size_t)i*ldc;
+      for (unsigned int j = 0; j < N; j++) {
+        const double *a = A + i*rsa;
+        const double *b = B + j*csb;
+        double s = 0.;
+        for (unsigned int k = 0; k < K; k++, a += csa, b += rsb)
+          s += (*a) * (*b);
+        c[j] += alpha * s;
+      }
+    }
+    return;
+  }
+
+  vpGemmMicroKernel kernel = vpGemmGetKernel();
+
+  unsigned int mcMax = (M < vpGemmMC) ? M : vpGemmMC;
+  unsigned int kcMax = (K < vpGemmKC) ? K : vpGemmKC;
+  unsigned int ncMax = (N < vpGemmNC) ? N : vpGemmNC;
+  unsigned int mcPad = ((mcMax + vpGemmMR - 1) / vpGemmMR) * vpGemmMR;
+  unsigned int ncPad = ((ncMax + vpGemmNR - 1) / vpGemmNR) * vpGemmNR;
+
+  std::vector<double> Ap((size_t)mcPad * kcMax);
+  std::vector<double> Bp((size_t)kcMax * ncPad);
+  double tile[vpGemmMR*vpGemmNR];
+
+  for (unsigned int jc = 0; jc < N; jc += vpGemmNC) {
+    unsigned int nc = (N - jc < vpGemmNC) ? (N - jc) : vpGemmNC;
+    for (unsigned int pc = 0; pc < K; pc += vpGemmKC) {
+      unsigned int kc = (K - pc < vpGemmKC) ? (K - pc) : vpGemmKC;
+      vpGemmPackB(kc, nc, B + pc*rsb + jc*csb, rsb, csb, &Bp[0]);
+
+      for (unsigned int ic = 0; ic < M; ic += vpGemmMC) {
+        unsigned int mc = (M - ic < vpGemmMC) ? (M - ic) : vpGemmMC;
+        vpGemmPackA(mc, kc, A + ic*rsa + pc*csa, rsa, csa, &Ap[0]);
+
+        for (unsigned int jr = 0; jr < nc; jr += vpGemmNR) {
+          unsigned int nr = (nc - jr < vpGemmNR) ? (nc - jr) : vpGemmNR;
+          const double *bp = &Bp[0] + (size_t)jr*kc;
+          for (unsigned int ir = 0; ir < mc; ir += vpGemmMR) {
+            unsigned int mr = (mc - ir < vpGemmMR) ? (mc - ir) : vpGemmMR;
+            kernel(kc, &Ap[0] + (size_t)ir*kc, bp, tile);
+
+            double *c = C + (size_t)(ic + ir)*ldc + jc + jr;
+            for (unsigned int r = 0; r < mr; r++, c += ldc) {
+              const double *t = tile + r*vpGemmNR;
+              for (unsigned int j = 0; j < nr; j++)
+                c[j] += alpha * t[j];
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+/*!
+  Return the name of the micro kernel selected at runtime by vpGEMMBlocked():
+  "AVX2", "SSE2", "NEON" or "scalar".
+
+  \relates vpArray2D
+*/
+const char *vpGEMMKernelName()
+{
+  return vpGemmKernelName(vpGemmGetKernel());
+}
@@ -87,20 +87,24 @@ vpMatrix vpMatrix::computeCovarianceMatrix(const vpMatrix &A, const vpColVector
 vpMatrix vpMatrix::computeCovarianceMatrix(const vpMatrix &A, const vpColVector &x, const vpColVector &b, const vpMatrix &W)
 {
   double denom = 0.0;
-  vpMatrix W2(W.getCols(),W.getCols());
+  vpColVector w(W.getCols()), w2(W.getCols());
   for(unsigned int i = 0 ; i < W.getCols() ; i++){
       denom += W[i][i];
-      W2[i][i] = W[i][i]*W[i][i];
+      w[i] = W[i][i];
+      w2[i] = W[i][i]*W[i][i];
   }
 
   if(denom <= std::numeric_limits<double>::epsilon())
       throw vpMatrixException(vpMatrixException::divideByZeroError, "Impossible to compute covariance matrix: not enough data");
 
 //  double sigma2 = ( ((W*b).t())*W*b - ( ((W*b).t())*W*A*x ) ); // Should be equivalent to line bellow.
-  double sigma2 = (W * b - (W * A * x)).t() * (W*b - (W * A * x));
+  // Since W is diagonal, only its diagonal is used to avoid the products by a dense (n x n) matrix
+  vpColVector Wr = vpDiag(w) * (b - A * x);
+  double sigma2 = Wr.sumSquare();
   sigma2 /= denom;
 
-  return (A.t()*(W2)*A).pseudoInverse(A.getCols()*std::numeric_limits<double>::epsilon())*sigma2;
+  vpMatrix AtW2A = vpTranspose(A) * vpDiag(w2) * A;
+  return AtW2A.pseudoInverse(A.getCols()*std::numeric_limits<double>::epsilon())*sigma2;
 }
 
 /*!
@@ -0,0 +1,297 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Normal equations of a 6 dof least-squares problem.
+ *
+ *****************************************************************************/
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpNormalEquationSolver.h>
+
+namespace {
+  // Full 6x6 matrix from its packed upper triangle, with mu added to the diagonal
+  void unpack(const double *packed, double mu, double A[6][6])
+  {
+    for (unsigned int i = 0; i < 6; i++) {
+      A[i][i] = *packed++ + mu;
+      for (unsigned int j = i + 1; j < 6; j++)
+        A[i][j] = A[j][i] = *packed++;
+    }
+  }
+
+  // In place LDLT factorization: L is stored below the diagonal and D on
+  // the diagonal. Return false as soon as a pivot is not larger than
+  // threshold times the largest diagonal element.
+  bool factorizeLDLT(double A[6][6], double threshold)
+  {
+    double maxDiag = 0;
+    for (unsigned int i = 0; i < 6; i++)
+      if (A[i][i] > maxDiag)
+        maxDiag = A[i][i];
+    if (!(maxDiag > 0))
+      return false;
+
+    for (unsigned int j = 0; j < 6; j++) {
+      double d = A[j][j];
+      for (unsigned int k = 0; k < j; k++)
+        d -= A[j][k] * A[j][k] * A[k][k];
+      if (!(d > threshold * maxDiag))
+        return false;
+      A[j][j] = d;
+
+      for (unsigned int i = j + 1; i < 6; i++) {
+        double s = A[i][j];
+        for (unsigned int k = 0; k < j; k++)
+          s -= A[i][k] * A[j][k] * A[k][k];
+        A[i][j] = s / d;
+      }
+    }
+    return true;
+  }
+}
+
+/*!
+  Default constructor, with empty normal equations.
+*/
+vpNormalEquationSolver::vpNormalEquationSolver()
+  : m_nbRows(0)
+{
+  reset();
+}
+
+/*!
+  Remove all the rows added so far.
+*/
+void vpNormalEquationSolver::reset()
+{
+  for (unsigned int i = 0; i < 21; i++)
+    m_JTJ[i] = 0;
+  for (unsigned int i = 0; i < 6; i++)
+    m_JTe[i] = 0;
+  m_nbRows = 0;
+}
+
+/*!
+  Add all the rows of a least-squares problem, with a unit weight.
+
+  \param J : Nx6 interaction matrix.
+  \param e : Error vector of size N.
+
+  \exception vpException::dimensionError : If the sizes of \e J and \e e are
+  not consistent.
+*/
+void vpNormalEquationSolver::addRows(const vpMatrix &J, const vpColVector &e)
+{
+  if (J.getCols() != 6 || J.getRows() != e.getRows()) {
+    throw(vpException(vpException::dimensionError,
+                      "Cannot add a (%dx%d) interaction matrix and a %d error vector to 6 dof normal equations",
+                      J.getRows(), J.getCols(), e.getRows()));
+  }
+  for (unsigned int i = 0; i < J.getRows(); i++)
+    addRow(J[i], e[i]);
+}
+
+/*!
+  Add all the rows of a weighted least-squares problem.
+
+  \param J : Nx6 interaction matrix.
+  \param e : Error vector of size N.
+  \param w : Weights of the rows, see addRow().
+
+  \exception vpException::dimensionError : If the sizes of \e J, \e e and \e
+  w are not consistent.
+*/
+void vpNormalEquationSolver::addRows(const vpMatrix &J, const vpColVector &e, const vpColVector &w)
+{
+  if (J.getCols() != 6 || J.getRows() != e.getRows() || J.getRows() != w.getRows()) {
+    throw(vpException(vpException::dimensionError,
+                      "Cannot add a (%dx%d) interaction matrix, a %d error vector and a %d weight vector to 6 dof "
+                      "normal equations",
+                      J.getRows(), J.getCols(), e.getRows(), w.getRows()));
+  }
+  for (unsigned int i = 0; i < J.getRows(); i++)
+    addRow(J[i], e[i], w[i]);
+}
+
+/*!
+  Add the rows accumulated in another solver, typically filled by another
+  thread on another part of the rows.
+*/
+void vpNormalEquationSolver::add(const vpNormalEquationSolver &solver)
+{
+  for (unsigned int i = 0; i < 21; i++)
+    m_JTJ[i] += solver.m_JTJ[i];
+  for (unsigned int i = 0; i < 6; i++)
+    m_JTe[i] += solver.m_JTe[i];
+  m_nbRows += solver.m_nbRows;
+}
+
+/*!
+  Change the unknowns of the normal equations from \f${\bf x}\f$ to
+  \f${\bf y}\f$ with \f${\bf x} = {\bf M y}\f$. The result is the same as
+  if all the rows \f${\bf J}\f$ had been added as \f${\bf J M}\f$, without
+  transforming them one by one.
+
+  \param M : 6x6 matrix.
+
+  \exception vpException::dimensionError : If \e M is not a 6x6 matrix.
+*/
+void vpNormalEquationSolver::transform(const vpMatrix &M)
+{
+  if (M.getRows() != 6 || M.getCols() != 6) {
+    throw(vpException(vpException::dimensionError, "Cannot transform 6 dof normal equations with a (%dx%d) matrix",
+                      M.getRows(), M.getCols()));
+  }
+  double A[6][6], AM[6][6];
+  unpack(m_JTJ, 0, A);
+  for (unsigned int i = 0; i < 6; i++) {
+    for (unsigned int j = 0; j < 6; j++) {
+      double s = 0;
+      for (unsigned int k = 0; k < 6; k++)
+        s += A[i][k] * M[k][j];
+      AM[i][j] = s;
+    }
+  }
+
+  double *JTJ = m_JTJ;
+  for (unsigned int i = 0; i < 6; i++) {
+    for (unsigned int j = i; j < 6; j++) {
+      double s = 0;
+      for (unsigned int k = 0; k < 6; k++)
+        s += M[k][i] * AM[k][j];
+      *JTJ++ = s;
+    }
+  }
+
+  double JTe[6];
+  for (unsigned int i = 0; i < 6; i++) {
+    JTe[i] = 0;
+    for (unsigned int k = 0; k < 6; k++)
+      JTe[i] += M[k][i] * m_JTe[k];
+  }
+  for (unsigned int i = 0; i < 6; i++)
+    m_JTe[i] = JTe[i];
+}
+
+/*!
+  Return the 6x6 matrix \f${\bf J}^\top {\bf W} {\bf J}\f$.
+*/
+void vpNormalEquationSolver::getJTJ(vpMatrix &JTJ) const
+{
+  double A[6][6];
+  unpack(m_JTJ, 0, A);
+  JTJ.resize(6, 6, false);
+  for (unsigned int i = 0; i < 6; i++)
+    for (unsigned int j = 0; j < 6; j++)
+      JTJ[i][j] = A[i][j];
+}
+
+/*!
+  Return the vector \f${\bf J}^\top {\bf W} {\bf e}\f$.
+*/
+void vpNormalEquationSolver::getJTe(vpColVector &JTe) const
+{
+  JTe.resize(6, false);
+  for (unsigned int i = 0; i < 6; i++)
+    JTe[i] = m_JTe[i];
+}
+
+/*!
+  Return the rank of \f${\bf J}^\top {\bf W} {\bf J}\f$.
+
+  \param svThreshold : Threshold on the singular values of the 6x6 matrix,
+  relative to the largest one, as in vpMatrix::pseudoInverse(). Since the
+  singular values of \f${\bf J}^\top {\bf J}\f$ are the square of the ones of
+  \f${\bf J}\f$, a threshold \e t on the interaction matrix corresponds to
+  \f$t^2\f$ here.
+
+  The matrix is considered as full rank without any SVD when all the
+  pivots of its LDLT factorization are above the threshold.
+*/
+unsigned int vpNormalEquationSolver::getRank(double svThreshold) const
+{
+  double A[6][6];
+  unpack(m_JTJ, 0, A);
+  if (factorizeLDLT(A, svThreshold))
+    return 6;
+
+  vpMatrix JTJ, JTJp;
+  getJTJ(JTJ);
+  return JTJ.pseudoInverse(JTJp, svThreshold);
+}
+
+/*!
+  Solve the normal equations \f$({\bf J}^\top {\bf W} {\bf J} + \mu {\bf
+  I}) {\bf x} = {\bf J}^\top {\bf W} {\bf e}\f$.
+
+  \param x : Solution, of size 6.
+  \param mu : Levenberg-Marquardt damping, 0 for a Gauss-Newton step.
+  \param svThreshold : Threshold used to detect a rank deficiency, see
+  getRank(). The default value is the one used by the model-based trackers.
+
+  \return The rank of the damped matrix. When it is 6, the system is solved
+  with a LDLT factorization. Otherwise the damped matrix is inverted with
+  vpMatrix::pseudoInverse() and \e x is the minimal norm solution.
+*/
+unsigned int vpNormalEquationSolver::solve(vpColVector &x, double mu, double svThreshold) const
+{
+  x.resize(6, false);
+
+  double A[6][6];
+  unpack(m_JTJ, mu, A);
+  if (!factorizeLDLT(A, svThreshold)) {
+    vpMatrix JTJ(6, 6), JTJp;
+    unpack(m_JTJ, mu, A);
+    for (unsigned int i = 0; i < 6; i++)
+      for (unsigned int j = 0; j < 6; j++)
+        JTJ[i][j] = A[i][j];
+    unsigned int rank = JTJ.pseudoInverse(JTJp, svThreshold);
+    for (unsigned int i = 0; i < 6; i++) {
+      x[i] = 0;
+      for (unsigned int j = 0; j < 6; j++)
+        x[i] += JTJp[i][j] * m_JTe[j];
+    }
+    return rank;
+  }
+
+  for (unsigned int i = 0; i < 6; i++) {
+    double s = m_JTe[i];
+    for (unsigned int k = 0; k < i; k++)
+      s -= A[i][k] * x[k];
+    x[i] = s;
+  }
+  for (unsigned int i = 0; i < 6; i++)
+    x[i] /= A[i][i];
+  for (int i = 4; i >= 0; i--) {
+    for (unsigned int k = (unsigned int)i + 1; k < 6; k++)
+      x[(unsigned int)i] -= A[k][(unsigned int)i] * x[k];
+  }
+  return 6;
+}
@@ -53,6 +53,12 @@
 #include <stdlib.h>
 #include <cmath>    // std::fabs
 #include <limits>   // numeric_limits
+#include <algorithm> // std::nth_element
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
 
 #define vpITMAX 100
 #define vpEPS 3.0e-7
@@ -66,12 +72,12 @@
 
 */
 vpRobust::vpRobust(unsigned int n_data)
-  : normres(), sorted_normres(), sorted_residues(), NoiseThreshold(0.0017), sig_prev(0), it(0), swap(0), size(n_data)
+  : normres(), sorted_residues(), m_allNormres(), m_histogram(), m_histogramThreshold(0),
+    NoiseThreshold(0.0017), sig_prev(0), it(0), size(n_data)
 {
   vpCDEBUG(2) << "vpRobust constructor reached" << std::endl;
 
   normres.resize(n_data); 
-  sorted_normres.resize(n_data); 
   sorted_residues.resize(n_data);
   // NoiseThreshold=0.0017; //Can not be more accurate than 1 pixel
 }
@@ -81,7 +87,8 @@ vpRobust::vpRobust(unsigned int n_data)
 
 */
 vpRobust::vpRobust()
-  : normres(), sorted_normres(), sorted_residues(), NoiseThreshold(0.0017), sig_prev(0), it(0), swap(0), size(0)
+  : normres(), sorted_residues(), m_allNormres(), m_histogram(), m_histogramThreshold(0),
+    NoiseThreshold(0.0017), sig_prev(0), it(0), size(0)
 {
   vpCDEBUG(2) << "vpRobust constructor with no argument reached" << std::endl;
 }
@@ -90,12 +97,13 @@ vpRobust::vpRobust()
   \brief Resize containers.
   \param n_data : size of input data vector.
 
+  The containers never give their memory back: resizing to a smaller size
+  and then back to a larger one does not allocate.
 */
 void vpRobust::resize(unsigned int n_data){
 
   if(n_data!=size){
   normres.resize(n_data); 
-  sorted_normres.resize(n_data); 
   sorted_residues.resize(n_data);
   size=n_data;
   }
@@ -150,26 +158,24 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method,
 
   // resize vector only if the size of residue vector has changed
   unsigned int n_data = residues.getRows();
+  if (n_data == 0)
+    return;
   resize(n_data); 
   
-  sorted_residues = residues;
-  
   unsigned int ind_med = (unsigned int)(ceil(n_data/2.0))-1;
 
   // Calculate median
-  med = select(sorted_residues, 0, (int)n_data-1, (int)ind_med/*(int)n_data/2*/);
+  med = select(residues.data, n_data, ind_med);
    //residualMedian = med ;
 
   // Normalize residues
   for(unsigned int i=0; i<n_data; i++)
   {
     normres[i] = (fabs(residues[i]- med));
-    sorted_normres[i] = (fabs(sorted_residues[i]- med));
-
   }
 
   // Calculate MAD
-  normmedian = select(sorted_normres, 0, (int)n_data-1, (int)ind_med/*(int)n_data/2*/);
+  normmedian = select(&normres[0], n_data, ind_med);
   //normalizedResidualMedian = normmedian ;
   // 1.48 keeps scale estimate consistent for a normal probability dist.
   sigma = 1.4826*normmedian; // median Absolute Deviation
@@ -185,7 +191,7 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method,
   {
   case TUKEY :
     {
-      psiTukey(sigma, normres,weights);
+      psiTukey(sigma, &normres[0], n_data, weights.data);
 
       vpCDEBUG(2) << "Tukey's function computed" << std::endl;
       break ;
@@ -193,7 +199,7 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method,
     }
   case CAUCHY :
     {
-      psiCauchy(sigma, normres,weights);
+      psiCauchy(sigma, &normres[0], n_data, weights.data);
       break ;
     }
     /*  case MCLURE :
@@ -203,7 +209,7 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method,
       }*/
   case HUBER :
     {
-      psiHuber(sigma, normres,weights);
+      psiHuber(sigma, &normres[0], n_data, weights.data);
       break ;
     }
   }
@@ -222,10 +228,12 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method,
   double sigma=0;// Standard Deviation
 
   unsigned int n_all_data = all_residues.getRows();
-  vpColVector all_normres(n_all_data); 
+  if (n_all_data == 0)
+    return;
+  m_allNormres.resize(n_all_data);
 
   // compute median with the residues vector, return all_normres which are the normalized all_residues vector.
-  normmedian = computeNormalizedMedian(all_normres,residues,all_residues,weights);
+  normmedian = computeNormalizedMedian(m_allNormres,residues,all_residues,weights);
 
 
   // 1.48 keeps scale estimate consistent for a normal probability dist.
@@ -243,7 +251,7 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method,
   {
   case TUKEY :
     {
-      psiTukey(sigma, all_normres,weights);
+      psiTukey(sigma, &m_allNormres[0], n_all_data, weights.data);
 
       vpCDEBUG(2) << "Tukey's function computed" << std::endl;
       break ;
@@ -251,7 +259,7 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method,
     }
   case CAUCHY :
     {
-      psiCauchy(sigma, all_normres,weights);
+      psiCauchy(sigma, &m_allNormres[0], n_all_data, weights.data);
       break ;
     }
     /*  case MCLURE :
@@ -261,7 +269,7 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method,
       }*/
   case HUBER :
     {
-      psiHuber(sigma, all_normres,weights);
+      psiHuber(sigma, &m_allNormres[0], n_all_data, weights.data);
       break ;
     }
 
@@ -271,7 +279,7 @@ void vpRobust::MEstimator(const vpRobustEstimatorType method,
 
 
 
-double vpRobust::computeNormalizedMedian(vpColVector &all_normres,
+double vpRobust::computeNormalizedMedian(std::vector<double> &all_normres,
 					 const vpColVector &residues,
 					 const vpColVector &all_residues,
 					 const vpColVector & weights
@@ -285,29 +293,18 @@ double vpRobust::computeNormalizedMedian(vpColVector &all_normres,
   
   // resize vector only if the size of residue vector has changed
   resize(n_data);
-    
-  sorted_residues = residues;
-  vpColVector no_null_weight_residues;
-  no_null_weight_residues.resize(n_data);
-  
-  //all_normres.resize(n_all_data); // Normalized Residue
-  //vpColVector sorted_normres(n_data); // Normalized Residue
-  //vpColVector sorted_residues = residues;
-  //vpColVector sorted_residues;
-  
 
+  // Keep the residues with a non null weight in normres
   unsigned int index =0;
   for(unsigned int j=0;j<n_data;j++)
   {
     //if(weights[j]!=0)
     if(std::fabs(weights[j]) > std::numeric_limits<double>::epsilon())
     {
-      no_null_weight_residues[index]=residues[j];
+      normres[index]=residues[j];
       index++;
     }
   }
-  sorted_residues.resize(index);
-  memcpy(sorted_residues.data,no_null_weight_residues.data,index*sizeof(double));
   n_data=index;
 
   vpCDEBUG(2) << "vpRobust MEstimator reached. No. data = " << n_data
@@ -317,8 +314,13 @@ double vpRobust::computeNormalizedMedian(vpColVector &all_normres,
   // Be careful to not use the rejected residues for the
   // calculation.
   
+  if (n_data == 0) {
+    for(unsigned int i=0; i<n_all_data; i++)
+      all_normres[i] = fabs(all_residues[i]);
+    return 0;
+  }
   unsigned int ind_med = (unsigned int)(ceil(n_data/2.0))-1;
-  med = select(sorted_residues, 0, (int)n_data-1, (int)ind_med/*(int)n_data/2*/);
+  med = select(&normres[0], n_data, ind_med);
 
   unsigned int i;
   // Normalize residues
@@ -329,13 +331,13 @@ double vpRobust::computeNormalizedMedian(vpColVector &all_normres,
 
   for(i=0; i<n_data; i++)
   {
-    sorted_normres[i] = (fabs(sorted_residues[i]- med));
+    normres[i] = (fabs(normres[i]- med));
   }
   // MAD calculated only on first iteration
 
   //normmedian = Median(normres, weights);
   //normmedian = Median(normres);
-  normmedian = select(sorted_normres, 0, (int)n_data-1, (int)ind_med/*(int)n_data/2*/);
+  normmedian = select(&normres[0], n_data, ind_med);
 
   return normmedian;
 }
@@ -364,8 +366,10 @@ vpRobust::simultMEstimator(vpColVector &residues)
 	      << std::endl;
 
   // Calculate Median
+  if (n_data == 0)
+    return w;
   unsigned int ind_med = (unsigned int)(ceil(n_data/2.0))-1;
-  med = select(residues, 0, (int)n_data-1, (int)ind_med/*(int)n_data/2*/);
+  med = select(residues.data, n_data, ind_med);
 
   // Normalize residues
   for(unsigned int i=0; i<n_data; i++)
@@ -376,7 +380,7 @@ vpRobust::simultMEstimator(vpColVector &residues)
   // For Others use MAD calculated on first iteration
   if(it==0)
   {
-    double normmedian = select(norm_res, 0, (int)n_data-1, (int)ind_med/*(int)n_data/2*/); // Normalized Median
+    double normmedian = select(norm_res.data, n_data, ind_med); // Normalized Median
     // 1.48 keeps scale estimate consistent for a normal probability dist.
     sigma = 1.4826*normmedian; // Median Absolute Deviation
   }
@@ -395,7 +399,7 @@ vpRobust::simultMEstimator(vpColVector &residues)
 
   vpCDEBUG(2) << "MAD and C computed" << std::endl;
 
-  psiHuber(sigma, norm_res,w);
+  psiHuber(sigma, norm_res.data, n_data, w.data);
 
   sig_prev = sigma;
 
@@ -621,34 +625,53 @@ vpRobust::simult_chi_huber(double x)
 
   return sct;
 }
-
 /*!
   \brief calculation of Tukey's influence function
 
-  \param sigma : sigma parameters
+  \param sig : sigma parameters
   \param x : normalized residue vector
+  \param n : size of the residue and weight vectors
   \param weights : weight vector
 */
 
-void vpRobust::psiTukey(double sig, vpColVector &x, vpColVector & weights)
+void vpRobust::psiTukey(double sig, const double *x, unsigned int n, double *weights)
 {
-
-  unsigned int n_data = x.getRows();
   double cst_const = vpCST*4.6851;
+  double eps = std::numeric_limits<double>::epsilon();
+  unsigned int i = 0;
 
-  for(unsigned int i=0; i<n_data; i++)
+  //if(sig==0)
+  if(std::fabs(sig) <= eps)
   {
-    //if(sig==0 && weights[i]!=0)
-    if(std::fabs(sig) <= std::numeric_limits<double>::epsilon() && std::fabs(weights[i]) > std::numeric_limits<double>::epsilon())
-    {
-      weights[i]=1;
-      continue;
-    }
+    for(; i<n; i++)
+      weights[i] = (std::fabs(weights[i]) > eps) ? 1 : 0;
+    return;
+  }
 
+#if VISP_HAVE_SSE2
+  const __m128d vsig = _mm_set1_pd(sig);
+  const __m128d vcst = _mm_set1_pd(cst_const);
+  const __m128d veps = _mm_set1_pd(eps);
+  const __m128d vone = _mm_set1_pd(1.0);
+  const __m128d vsign = _mm_set1_pd(-0.0);
+  for(; i+2<=n; i+=2)
+  {
+    __m128d xi_sig = _mm_div_pd(_mm_loadu_pd(x+i), vsig);
+    __m128d w = _mm_loadu_pd(weights+i);
+    __m128d inlier = _mm_and_pd(_mm_cmple_pd(_mm_andnot_pd(vsign, xi_sig), vcst),
+                                _mm_cmpgt_pd(_mm_andnot_pd(vsign, w), veps));
+    __m128d t = _mm_div_pd(xi_sig, vcst);
+    t = _mm_sub_pd(vone, _mm_mul_pd(t, t));
+    _mm_storeu_pd(weights+i, _mm_and_pd(inlier, _mm_mul_pd(t, t)));
+  }
+#endif
+
+  for(; i<n; i++)
+  {
     double xi_sig = x[i]/sig;
 
     //if((fabs(xi_sig)<=(cst_const)) && weights[i]!=0)
-    if((std::fabs(xi_sig)<=(cst_const)) && std::fabs(weights[i]) > std::numeric_limits<double>::epsilon())
+    if((std::fabs(xi_sig)<=(cst_const)) && std::fabs(weights[i]) > eps)
     {
       weights[i] = vpMath::sqr(1-vpMath::sqr(xi_sig/cst_const));
       //w[i] = vpMath::sqr(1-vpMath::sqr(x[i]/sig/4.7));
@@ -662,21 +685,40 @@ void vpRobust::psiTukey(double sig, vpColVector &x, vpColVector & weights)
 }
 
 /*!
-  \brief calculation of Tukey's influence function
+  \brief calculation of Huber's influence function
 
-  \param sigma : sigma parameters
+  \param sig : sigma parameters
   \param x : normalized residue vector
+  \param n : size of the residue and weight vectors
   \param weights : weight vector
 */
-void vpRobust::psiHuber(double sig, vpColVector &x, vpColVector &weights)
+void vpRobust::psiHuber(double sig, const double *x, unsigned int n, double *weights)
 {
   double c = 1.2107; //1.345;
-  unsigned int n_data = x.getRows();
+  double eps = std::numeric_limits<double>::epsilon();
+  unsigned int i = 0;
+
+#if VISP_HAVE_SSE2
+  const __m128d vsig = _mm_set1_pd(sig);
+  const __m128d vc = _mm_set1_pd(c);
+  const __m128d veps = _mm_set1_pd(eps);
+  const __m128d vone = _mm_set1_pd(1.0);
+  const __m128d vsign = _mm_set1_pd(-0.0);
+  for(; i+2<=n; i+=2)
+  {
+    __m128d w = _mm_loadu_pd(weights+i);
+    __m128d active = _mm_cmpgt_pd(_mm_andnot_pd(vsign, w), veps);
+    __m128d abs_xi_sig = _mm_andnot_pd(vsign, _mm_div_pd(_mm_loadu_pd(x+i), vsig));
+    __m128d inlier = _mm_cmple_pd(abs_xi_sig, vc);
+    __m128d psi = _mm_or_pd(_mm_and_pd(inlier, vone), _mm_andnot_pd(inlier, _mm_div_pd(vc, abs_xi_sig)));
+    _mm_storeu_pd(weights+i, _mm_or_pd(_mm_and_pd(active, psi), _mm_andnot_pd(active, w)));
+  }
+#endif
 
-  for(unsigned int i=0; i<n_data; i++)
+  for(; i<n; i++)
   {
     //if(weights[i]!=0)
-    if(std::fabs(weights[i]) > std::numeric_limits<double>::epsilon())
+    if(std::fabs(weights[i]) > eps)
     {
       double xi_sig = x[i]/sig;
       if(fabs(xi_sig)<=c)
@@ -690,18 +732,29 @@ void vpRobust::psiHuber(double sig, vpColVector &x, vpColVector &weights)
 /*!
   \brief calculation of Cauchy's influence function
 
-  \param sigma : sigma parameters
+  \param sig : sigma parameters
   \param x : normalized residue vector
+  \param n : size of the residue and weight vectors
   \param weights : weight vector
 */
 
-void vpRobust::psiCauchy(double sig, vpColVector &x, vpColVector &weights)
+void vpRobust::psiCauchy(double sig, const double *x, unsigned int n, double *weights)
 {
-  unsigned int n_data = x.getRows();
   double const_sig = 2.3849*sig;
+  unsigned int i = 0;
+
+#if VISP_HAVE_SSE2
+  const __m128d vconst_sig = _mm_set1_pd(const_sig);
+  const __m128d vone = _mm_set1_pd(1.0);
+  for(; i+2<=n; i+=2)
+  {
+    __m128d t = _mm_div_pd(_mm_loadu_pd(x+i), vconst_sig);
+    _mm_storeu_pd(weights+i, _mm_div_pd(vone, _mm_add_pd(vone, _mm_mul_pd(t, t))));
+  }
+#endif
 
   //Calculate Cauchy's equation
-  for(unsigned int i=0; i<n_data; i++)
+  for(; i<n; i++)
   {
     weights[i] = 1/(1+vpMath::sqr(x[i]/(const_sig)));
 
@@ -724,79 +777,107 @@ void vpRobust::psiCauchy(double sig, vpColVector &x, vpColVector &weights)
 /*!
   \brief calculation of McLure's influence function
 
-  \param sigma : sigma parameters
-  \param x : normalized residue vector
+  \param sig : sigma parameters
+  \param r : normalized residue vector
+  \param n : size of the residue and weight vectors
   \param weights : weight vector
 */
-void vpRobust::psiMcLure(double sig, vpColVector &r,vpColVector &weights)
+void vpRobust::psiMcLure(double sig, const double *r, unsigned int n, double *weights)
 {
-  unsigned int n_data = r.getRows();
-
   //McLure's function
-  for(unsigned int i=0; i<n_data; i++)
+  for(unsigned int i=0; i<n; i++)
   {
     weights[i] = 1/(vpMath::sqr(1+vpMath::sqr(r[i]/sig)));
     //w[i] = 2*mad/vpMath::sqr((mad+r[i]*r[i]));//odobez
-
-    // If one coordinate is an outlier the other is too!
-    // w[i] < 0.01 is a threshold to be set
-    /*if(w[i] < 0.01)
-      {
-      if(i%2 == 0)
-      {
-      w[i+1] = w[i];
-      i++;
-      }
-      else
-      w[i-1] = w[i];
-      }*/
   }
 }
 
 
 /*!
-  \brief partition function
-  \param a : vector to be sorted
-  \param l : first value to be considered
-  \param r : last value to be considered
+  \brief Select the k-th smallest value of a vector.
+
+  The vector is copied in a scratch buffer partially sorted with an
+  introselect, or goes through selectFromHistogram() when it is larger than
+  the threshold set with setMedianHistogramThreshold().
+
+  \param x : vector of n values, left untouched.
+  \param n : size of the vector, strictly positive.
+  \param k : rank of the value to be selected, in [0, n-1].
 */
-int
-vpRobust::partition(vpColVector &a, int l, int r)
+double
+vpRobust::select(const double *x, unsigned int n, unsigned int k)
 {
-  int i = l-1;
-  int j = r;
-  double v = a[(unsigned int)r];
+  if (m_histogramThreshold > 0 && n >= m_histogramThreshold)
+    return selectFromHistogram(x, n, k);
 
-  for (;;)
-  {
-    while (a[(unsigned int)++i] < v) ;
-    while (v < a[(unsigned int)--j]) if (j == l) break;
-    if (i >= j) break;
-    exch(a[(unsigned int)i], a[(unsigned int)j]);
-  }
-  exch(a[(unsigned int)i], a[(unsigned int)r]);
-  return i;
+  sorted_residues.assign(x, x + n);
+  std::nth_element(sorted_residues.begin(), sorted_residues.begin() + k, sorted_residues.end());
+  return sorted_residues[k];
 }
 
 /*!
-  \brief sort a part of a vector and select a value of this new vector
-  \param a : vector to be sorted
-  \param l : first value to be considered
-  \param r : last value to be considered
-  \param k : value to be selected
+  \brief Select the k-th smallest value of a vector from its histogram.
+
+  A first pass computes the range of the values and a second one their
+  histogram. Since the bin index is a non decreasing function of the value,
+  the k-th smallest value lies in the bin where the cumulated histogram
+  reaches k. Only the values of this bin are copied in the scratch buffer
+  to be partially sorted, so that the result is exactly the one of select().
+
+  \param x : vector of n values, left untouched.
+  \param n : size of the vector, strictly positive.
+  \param k : rank of the value to be selected, in [0, n-1].
 */
-double 
-vpRobust::select(vpColVector &a, int l, int r, int k)
+double
+vpRobust::selectFromHistogram(const double *x, unsigned int n, unsigned int k)
 {
-  while (r > l)
-  {
-    int i = partition(a, l, r);
-    if (i >= k) r = i-1;
-    if (i <= k) l = i+1;
+  const unsigned int nbins = 4096;
+
+  double xmin = x[0];
+  double xmax = x[0];
+  for (unsigned int i = 1; i < n; i++) {
+    if (x[i] < xmin)
+      xmin = x[i];
+    else if (x[i] > xmax)
+      xmax = x[i];
+  }
+  if (!(xmax > xmin))
+    return xmin;
+
+  double binScale = nbins / (xmax - xmin);
+  if (!(binScale <= std::numeric_limits<double>::max())) {
+    // Range too small to be divided in bins
+    sorted_residues.assign(x, x + n);
+    std::nth_element(sorted_residues.begin(), sorted_residues.begin() + k, sorted_residues.end());
+    return sorted_residues[k];
+  }
+
+  m_histogram.assign(nbins, 0);
+  unsigned int *histogram = &m_histogram[0];
+  for (unsigned int i = 0; i < n; i++) {
+    unsigned int bin = (unsigned int)((x[i] - xmin) * binScale);
+    histogram[bin < nbins ? bin : nbins - 1]++;
+  }
+
+  unsigned int kbin = 0;
+  unsigned int nbefore = 0;
+  while (nbefore + histogram[kbin] <= k) {
+    nbefore += histogram[kbin];
+    kbin++;
+  }
+
+  sorted_residues.resize(histogram[kbin]);
+  double *values = &sorted_residues[0];
+  unsigned int nvalues = 0;
+  for (unsigned int i = 0; i < n; i++) {
+    unsigned int bin = (unsigned int)((x[i] - xmin) * binScale);
+    if ((bin < nbins ? bin : nbins - 1) == kbin)
+      values[nvalues++] = x[i];
   }
-  return a[(unsigned int)k];
-}
 
+  std::nth_element(sorted_residues.begin(), sorted_residues.begin() + (k - nbefore), sorted_residues.end());
+  return sorted_residues[k - nbefore];
+}
 
 #if !defined(VISP_HAVE_FUNC_ERFC) && !defined(VISP_HAVE_FUNC_STD_ERFC)
 double
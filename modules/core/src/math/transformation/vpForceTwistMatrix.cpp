@@ -91,7 +91,7 @@ vpForceTwistMatrix::eye()
   Initialize a force/torque twist transformation matrix to identity.
 */
 vpForceTwistMatrix::vpForceTwistMatrix()
-  : vpArray2D<double>(6,6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   eye() ;
 }
@@ -104,7 +104,7 @@ vpForceTwistMatrix::vpForceTwistMatrix()
   \param F : Force/torque twist matrix used as initializer.
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpForceTwistMatrix &F)
-  : vpArray2D<double>(6,6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   *this = F ;
 }
@@ -134,7 +134,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpForceTwistMatrix &F)
 
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpHomogeneousMatrix &M)
-  : vpArray2D<double>(6,6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   buildFrom(M);
 }
@@ -151,7 +151,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpHomogeneousMatrix &M)
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t,
                                        const vpThetaUVector &thetau)
-  : vpArray2D<double>(6,6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   buildFrom(t, thetau) ;
 }
@@ -168,7 +168,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t,
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t,
                                        const vpRotationMatrix &R)
-  : vpArray2D<double>(6,6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   buildFrom(t, R) ;
 }
@@ -184,7 +184,7 @@ vpForceTwistMatrix::vpForceTwistMatrix(const vpTranslationVector &t,
 */
 vpForceTwistMatrix::vpForceTwistMatrix(const double tx, const double ty, const double tz,
                                        const double tux, const double tuy, const double tuz)
-  : vpArray2D<double>(6,6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   vpTranslationVector T(tx,ty,tz) ;
   vpThetaUVector tu(tux,tuy,tuz) ;
@@ -214,14 +214,8 @@ vpForceTwistMatrix::operator*(const vpForceTwistMatrix &F) const
 {
   vpForceTwistMatrix Fout ;
 
-  for (unsigned int i=0;i<6;i++) {
-    for (unsigned int j=0;j<6;j++) {
-      double s =0 ;
-      for (unsigned int k=0;k<6;k++)
-        s +=rowPtrs[i][k] * F.rowPtrs[k][j];
-      Fout[i][j] = s ;
-    }
-  }
+  vpFixedArray2D<double, 6, 6>::mult<6>(data, F.data, Fout.data);
+
   return Fout;
 }
 
@@ -338,13 +332,18 @@ vpForceTwistMatrix::buildFrom(const vpTranslationVector &t,
                               const vpRotationMatrix &R)
 {
   unsigned int i, j;
-  vpMatrix skewaR = t.skew(t)*R ;
-  
+  double skewt[9] = { 0., -t[2], t[1],
+                      t[2], 0., -t[0],
+                      -t[1], t[0], 0. };
+  double skewaR[9];
+  vpFixedArray2D<double, 3, 3>::mult<3>(skewt, R.data, skewaR);
+
   for (i=0 ; i < 3 ; i++) {
     for (j=0 ; j < 3 ; j++)	{
       (*this)[i][j] = R[i][j] ;
       (*this)[i+3][j+3] = R[i][j] ;
-      (*this)[i+3][j] = skewaR[i][j] ;
+      (*this)[i+3][j] = skewaR[3*i+j] ;
+      (*this)[i][j+3] = 0 ;
     }
   }
   return (*this) ;
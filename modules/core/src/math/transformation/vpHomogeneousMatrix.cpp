@@ -54,7 +54,7 @@
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
                                          const vpQuaternionVector &q)
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   buildFrom(t,q);
   (*this)[3][3] = 1.;
@@ -64,7 +64,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
   Default constructor that initialize an homogeneous matrix as identity.
 */
 vpHomogeneousMatrix::vpHomogeneousMatrix()
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   eye() ;
 }
@@ -73,7 +73,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix()
   Copy constructor that initialize an homogeneous matrix from another homogeneous matrix.
 */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpHomogeneousMatrix &M)
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   *this = M;
 }
@@ -83,7 +83,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpHomogeneousMatrix &M)
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
                                          const vpThetaUVector &tu)
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   buildFrom(t, tu);
   (*this)[3][3] = 1.;
@@ -94,7 +94,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
                                          const vpRotationMatrix &R)
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   insert(R);
   insert(t);
@@ -105,7 +105,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const vpTranslationVector &t,
   Construct an homogeneous matrix from a pose vector.
  */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const vpPoseVector &p)
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   buildFrom(p[0], p[1], p[2], p[3], p[4], p[5]) ;
   (*this)[3][3] = 1.;
@@ -150,7 +150,7 @@ M:
   \endcode
   */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<float> &v)
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   buildFrom(v) ;
   (*this)[3][3] = 1.;
@@ -195,7 +195,7 @@ M:
   \endcode
   */
 vpHomogeneousMatrix::vpHomogeneousMatrix(const std::vector<double> &v)
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   buildFrom(v) ;
   (*this)[3][3] = 1.;
@@ -211,7 +211,7 @@ vpHomogeneousMatrix::vpHomogeneousMatrix(const double tx,
                                          const double tux,
                                          const double tuy,
                                          const double tuz)
-  : vpArray2D<double>(4, 4)
+  : vpFixedArray2D<double, 4, 4>()
 {
   buildFrom(tx, ty, tz, tux, tuy, tuz);
   (*this)[3][3] = 1.;
@@ -422,21 +422,16 @@ vpHomogeneousMatrix::operator*(const vpHomogeneousMatrix &M) const
 {
   vpHomogeneousMatrix p;
 
-  vpRotationMatrix R1, R2, R ;
-  vpTranslationVector T1, T2 , T;
-
-  extract(T1) ;
-  M.extract(T2) ;
-
-  extract (R1) ;
-  M.extract (R2) ;
-
-  R = R1*R2 ;
-
-  T = R1*T2 + T1 ;
-
-  p.insert(T) ;
-  p.insert(R) ;
+  // Only the 3 first rows are computed, the last one stays [0 0 0 1]
+  const double *A = data;
+  const double *B = M.data;
+  double *P = p.data;
+  for (unsigned int i=0;i<3;i++, A+=4, P+=4) {
+    P[0] = A[0]*B[0] + A[1]*B[4] + A[2]*B[8];
+    P[1] = A[0]*B[1] + A[1]*B[5] + A[2]*B[9];
+    P[2] = A[0]*B[2] + A[1]*B[6] + A[2]*B[10];
+    P[3] = A[0]*B[3] + A[1]*B[7] + A[2]*B[11] + A[3];
+  }
 
   return p;
 }
@@ -674,14 +669,12 @@ vpHomogeneousMatrix::inverse() const
 {
   vpHomogeneousMatrix Mi ;
 
-  vpRotationMatrix R ;      extract(R) ;
-  vpTranslationVector T ;   extract(T) ;
-
-  vpTranslationVector RtT ; RtT = -(R.t()*T) ;
-
-
-  Mi.insert(R.t()) ;
-  Mi.insert(RtT) ;
+  // R^T and -R^T t
+  for (unsigned int i=0;i<3;i++) {
+    for (unsigned int j=0;j<3;j++)
+      Mi[i][j] = (*this)[j][i];
+    Mi[i][3] = -((*this)[0][i]*(*this)[0][3] + (*this)[1][i]*(*this)[1][3] + (*this)[2][i]*(*this)[2][3]);
+  }
 
   return Mi ;
 }
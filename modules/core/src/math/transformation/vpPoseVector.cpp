@@ -65,7 +65,7 @@
 
 */
 vpPoseVector::vpPoseVector()
-  : vpArray2D<double>(6, 1)
+  : vpFixedArray2D<double, 6, 1>()
 {}
 
 /*!  
@@ -89,7 +89,7 @@ vpPoseVector::vpPoseVector(const double tx,
                            const double tux,
                            const double tuy,
                            const double tuz)
-  : vpArray2D<double>(6, 1)
+  : vpFixedArray2D<double, 6, 1>()
 {
   (*this)[0] = tx;
   (*this)[1] = ty;
@@ -112,7 +112,7 @@ vpPoseVector::vpPoseVector(const double tx,
 */
 vpPoseVector::vpPoseVector(const vpTranslationVector& tv,
                            const vpThetaUVector& tu)
-  : vpArray2D<double>(6, 1)
+  : vpFixedArray2D<double, 6, 1>()
 {
   buildFrom(tv, tu) ;
 }
@@ -131,7 +131,7 @@ vpPoseVector::vpPoseVector(const vpTranslationVector& tv,
 */
 vpPoseVector::vpPoseVector(const vpTranslationVector& tv,
                            const vpRotationMatrix& R)
-  : vpArray2D<double>(6, 1)
+  : vpFixedArray2D<double, 6, 1>()
 {
   buildFrom(tv, R) ;
 }
@@ -147,7 +147,7 @@ vpPoseVector::vpPoseVector(const vpTranslationVector& tv,
 
 */
 vpPoseVector::vpPoseVector(const vpHomogeneousMatrix& M)
-  : vpArray2D<double>(6, 1)
+  : vpFixedArray2D<double, 6, 1>()
 {
   buildFrom(M) ;
 }
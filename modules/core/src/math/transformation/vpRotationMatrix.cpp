@@ -142,14 +142,8 @@ vpRotationMatrix::operator*(const vpRotationMatrix &R) const
 {
   vpRotationMatrix p ;
 
-  for (unsigned int i=0;i<3;i++) {
-    for (unsigned int j=0;j<3;j++) {
-      double s =0 ;
-      for (unsigned int k=0;k<3;k++)
-        s +=rowPtrs[i][k] * R.rowPtrs[k][j];
-      p[i][j] = s ;
-    }
-  }
+  vpFixedArray2D<double, 3, 3>::mult<3>(data, R.data, p.data);
+
   return p;
 }
 /*! 
@@ -245,14 +239,7 @@ vpRotationMatrix::operator*(const vpTranslationVector &tv) const
 {
   vpTranslationVector p ;
 
-  for (unsigned int j=0;j<3;j++)
-    p[j] = 0;
-
-  for (unsigned int j=0;j<3;j++) {
-    for (unsigned int i=0;i<3;i++) {
-      p[i] += rowPtrs[i][j] * tv[j];
-    }
-  }
+  vpFixedArray2D<double, 3, 1>::mult<3>(data, tv.data, p.data);
 
   return p;
 }
@@ -331,7 +318,7 @@ vpRotationMatrix::isARotationMatrix() const
 /*!
   Default constructor that initialise a 3-by-3 rotation matrix to identity.
 */
-vpRotationMatrix::vpRotationMatrix() : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix() : vpFixedArray2D<double, 3, 3>()
 {
   eye();
 }
@@ -340,14 +327,14 @@ vpRotationMatrix::vpRotationMatrix() : vpArray2D<double>(3,3)
 /*!
   Copy contructor that construct a 3-by-3 rotation matrix from another rotation matrix.
 */
-vpRotationMatrix::vpRotationMatrix(const vpRotationMatrix &M) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const vpRotationMatrix &M) : vpFixedArray2D<double, 3, 3>()
 {
   (*this) = M ;
 }
 /*!
   Construct a 3-by-3 rotation matrix from an homogeneous matrix.
 */
-vpRotationMatrix::vpRotationMatrix(const vpHomogeneousMatrix &M) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const vpHomogeneousMatrix &M) : vpFixedArray2D<double, 3, 3>()
 {
   buildFrom(M);
 }
@@ -355,7 +342,7 @@ vpRotationMatrix::vpRotationMatrix(const vpHomogeneousMatrix &M) : vpArray2D<dou
 /*!
   Construct a 3-by-3 rotation matrix from \f$ \theta {\bf u}\f$ angle representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpThetaUVector &tu) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const vpThetaUVector &tu) : vpFixedArray2D<double, 3, 3>()
 {
   buildFrom(tu) ;
 }
@@ -363,7 +350,7 @@ vpRotationMatrix::vpRotationMatrix(const vpThetaUVector &tu) : vpArray2D<double>
 /*!
   Construct a 3-by-3 rotation matrix from a pose vector.
  */
-vpRotationMatrix::vpRotationMatrix(const vpPoseVector &p) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const vpPoseVector &p) : vpFixedArray2D<double, 3, 3>()
 {
   buildFrom(p) ;
 }
@@ -371,7 +358,7 @@ vpRotationMatrix::vpRotationMatrix(const vpPoseVector &p) : vpArray2D<double>(3,
 /*!
   Construct a 3-by-3 rotation matrix from \f$ R(z,y,z) \f$ Euler angle representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpRzyzVector &euler) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const vpRzyzVector &euler) : vpFixedArray2D<double, 3, 3>()
 {
   buildFrom(euler) ;
 }
@@ -379,7 +366,7 @@ vpRotationMatrix::vpRotationMatrix(const vpRzyzVector &euler) : vpArray2D<double
 /*!
   Construct a 3-by-3 rotation matrix from \f$ R(x,y,z) \f$ Euler angle representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpRxyzVector &Rxyz) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const vpRxyzVector &Rxyz) : vpFixedArray2D<double, 3, 3>()
 {
   buildFrom(Rxyz) ;
 }
@@ -387,7 +374,7 @@ vpRotationMatrix::vpRotationMatrix(const vpRxyzVector &Rxyz) : vpArray2D<double>
 /*!
   Construct a 3-by-3 rotation matrix from \f$ R(z,y,x) \f$ Euler angle representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpRzyxVector &Rzyx) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const vpRzyxVector &Rzyx) : vpFixedArray2D<double, 3, 3>()
 {
   buildFrom(Rzyx) ;
 }
@@ -395,7 +382,7 @@ vpRotationMatrix::vpRotationMatrix(const vpRzyxVector &Rzyx) : vpArray2D<double>
 /*!
   Construct a 3-by-3 rotation matrix from \f$ \theta {\bf u}=(\theta u_x, \theta u_y, \theta u_z)^T\f$ angle representation.
  */
-vpRotationMatrix::vpRotationMatrix(const double tux, const double tuy, const double tuz) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const double tux, const double tuy, const double tuz) : vpFixedArray2D<double, 3, 3>()
 {
   buildFrom(tux, tuy, tuz) ;
 }
@@ -403,7 +390,7 @@ vpRotationMatrix::vpRotationMatrix(const double tux, const double tuy, const dou
 /*!
   Construct a 3-by-3 rotation matrix from quaternion angle representation.
  */
-vpRotationMatrix::vpRotationMatrix(const vpQuaternionVector& q) : vpArray2D<double>(3,3)
+vpRotationMatrix::vpRotationMatrix(const vpQuaternionVector& q) : vpFixedArray2D<double, 3, 3>()
 {
   buildFrom(q);
 }
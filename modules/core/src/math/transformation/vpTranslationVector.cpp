@@ -54,7 +54,7 @@
 
 */
 vpTranslationVector::vpTranslationVector(const double tx, const double ty, const double tz)
-  : vpArray2D<double>(3, 1)
+  : vpFixedArray2D<double, 3, 1>()
 {
   (*this)[0] = tx;
   (*this)[1] = ty;
@@ -69,7 +69,7 @@ vpTranslationVector::vpTranslationVector(const double tx, const double ty, const
 
 */
 vpTranslationVector::vpTranslationVector(const vpHomogeneousMatrix &M)
-  : vpArray2D<double>(3, 1)
+  : vpFixedArray2D<double, 3, 1>()
 {
   M.extract( *this );
 }
@@ -82,7 +82,7 @@ vpTranslationVector::vpTranslationVector(const vpHomogeneousMatrix &M)
 
 */
 vpTranslationVector::vpTranslationVector(const vpPoseVector &p)
-  : vpArray2D<double>(3, 1)
+  : vpFixedArray2D<double, 3, 1>()
 {
   (*this)[0] = p[0];
   (*this)[1] = p[1];
@@ -100,7 +100,7 @@ vpTranslationVector::vpTranslationVector(const vpPoseVector &p)
   \endcode
 */
 vpTranslationVector::vpTranslationVector (const vpTranslationVector &tv)
-  : vpArray2D<double>(tv)
+  : vpFixedArray2D<double, 3, 1>(tv)
 {
 }
 
@@ -118,12 +118,13 @@ vpTranslationVector::vpTranslationVector (const vpTranslationVector &tv)
 
 */
 vpTranslationVector::vpTranslationVector (const vpColVector &v)
-  : vpArray2D<double>(v)
+  : vpFixedArray2D<double, 3, 1>()
 {
   if (v.size() != 3) {
     throw(vpException(vpException::dimensionError,
                       "Cannot construct a translation vector from a %d-dimension column vector", v.size()));
   }
+  memcpy(data, v.data, 3*sizeof(double));
 }
 
 /*!
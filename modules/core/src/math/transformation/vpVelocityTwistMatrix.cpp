@@ -89,7 +89,7 @@ vpVelocityTwistMatrix::eye()
   Initialize a velocity twist transformation matrix as identity.
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix()
-  : vpArray2D<double>(6, 6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   eye() ;
 }
@@ -100,7 +100,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix()
   \param V : Velocity twist matrix used as initializer.
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpVelocityTwistMatrix &V)
-  : vpArray2D<double>(6, 6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   *this = V;
 }
@@ -116,7 +116,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpVelocityTwistMatrix &V)
 
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpHomogeneousMatrix &M)
-  : vpArray2D<double>(6, 6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   buildFrom(M);
 }
@@ -133,7 +133,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpHomogeneousMatrix &M)
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t,
                                              const vpThetaUVector &thetau)
-  : vpArray2D<double>(6, 6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   buildFrom(t, thetau) ;
 }
@@ -150,7 +150,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t,
 */
 vpVelocityTwistMatrix::vpVelocityTwistMatrix(const vpTranslationVector &t,
                                              const vpRotationMatrix &R)
-  : vpArray2D<double>(6, 6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   buildFrom(t,R) ;
 }
@@ -171,7 +171,7 @@ vpVelocityTwistMatrix::vpVelocityTwistMatrix(const double tx,
 					     const double tux,
 					     const double tuy,
                const double tuz)
-  : vpArray2D<double>(6, 6)
+  : vpFixedArray2D<double, 6, 6>()
 {
   vpTranslationVector T(tx,ty,tz) ;
   vpThetaUVector tu(tux,tuy,tuz) ;
@@ -189,14 +189,8 @@ vpVelocityTwistMatrix::operator*(const vpVelocityTwistMatrix &V) const
 {
   vpVelocityTwistMatrix p ;
 
-  for (unsigned int i=0;i<6;i++)
-    for (unsigned int j=0;j<6;j++)
-    {
-      double s =0 ;
-      for (int k=0;k<6;k++)
-        s +=rowPtrs[i][k] * V.rowPtrs[k][j];
-      p[i][j] = s ;
-    }
+  vpFixedArray2D<double, 6, 6>::mult<6>(data, V.data, p.data);
+
   return p;
 }
 
@@ -308,15 +302,19 @@ vpVelocityTwistMatrix::buildFrom(const vpTranslationVector &t,
                                  const vpRotationMatrix &R)
 {
   unsigned int i, j;
-  vpMatrix skewaR = t.skew(t)*R ;
+  double skewt[9] = { 0., -t[2], t[1],
+                      t[2], 0., -t[0],
+                      -t[1], t[0], 0. };
+  double skewaR[9];
+  vpFixedArray2D<double, 3, 3>::mult<3>(skewt, R.data, skewaR);
 
   for (i=0 ; i < 3 ; i++)
     for (j=0 ; j < 3 ; j++)
     {
       (*this)[i][j] = R[i][j] ;
       (*this)[i+3][j+3] = R[i][j] ;
-      (*this)[i][j+3] = skewaR[i][j] ;
-
+      (*this)[i][j+3] = skewaR[3*i+j] ;
+      (*this)[i+3][j] = 0 ;
     }
   return (*this) ;
 }
@@ -44,93 +44,137 @@
 
 */
 
+#include <stdint.h>
 #include <stdlib.h>
+#include <vector>
+
 #include <visp3/core/vpHistogram.h>
 #include <visp3/core/vpImageConvert.h>
 #include <visp3/core/vpDisplay.h>
 
 
-#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
-#include <visp3/core/vpThread.h>
+#include <visp3/core/vpThreadPool.h>
 
-namespace {
-  struct Histogram_Param_t {
-    unsigned int m_start_index;
-    unsigned int m_end_index;
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
 
-    unsigned int m_lut[256];
-    unsigned int *m_histogram;
-    const vpImage<unsigned char> *m_I;
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  // Number of sub-histograms incremented in turn by the counting kernel
+  const unsigned int nbBanks = 4;
+
+  /*
+    Count the grey levels of the rows [rowStart, rowEnd) of a view, only
+    where the mask is not null when a mask is given. Consecutive pixels are
+    counted in different banks, so that a run of pixels of the same level
+    doesn't serialize the increments on the same counter. The banks are
+    summed in counts at the end.
+  */
+  struct vpHistogramBand
+  {
+    vpHistogramBand() : I(), mask(), useMask(false), rowStart(0), rowEnd(0) {}
 
-    Histogram_Param_t() : m_start_index(0), m_end_index(0), m_lut(), m_histogram(NULL), m_I(NULL) {
-    }
+    vpImageView<unsigned char> I;
+    vpImageView<unsigned char> mask;
+    bool useMask;
+    unsigned int rowStart;
+    unsigned int rowEnd;
+    unsigned int counts[256];
 
-    Histogram_Param_t(const unsigned int start_index, const unsigned int end_index,
-        const vpImage<unsigned char> * const I) :
-      m_start_index(start_index), m_end_index(end_index), m_lut(), m_histogram(NULL), m_I(I) {
+    // Count 8 pixels, two per bank
+    static inline void count8(const unsigned char *p, unsigned int (*banks)[256])
+    {
+      uint64_t v;
+      memcpy(&v, p, 8);
+      banks[0][v & 0xff]++;
+      banks[1][(v >> 8) & 0xff]++;
+      banks[2][(v >> 16) & 0xff]++;
+      banks[3][(v >> 24) & 0xff]++;
+      banks[0][(v >> 32) & 0xff]++;
+      banks[1][(v >> 40) & 0xff]++;
+      banks[2][(v >> 48) & 0xff]++;
+      banks[3][v >> 56]++;
     }
 
-    ~Histogram_Param_t() {
-      if(m_histogram != NULL) {
-        delete []m_histogram;
+    void run()
+    {
+      unsigned int banks[nbBanks][256];
+      memset(banks, 0, sizeof(banks));
+      const unsigned int width = I.getWidth();
+      for (unsigned int i = rowStart; i < rowEnd; i++) {
+        const unsigned char *p = I[i];
+        unsigned int j = 0;
+        if (! useMask) {
+          for (; j + 8 <= width; j += 8)
+            count8(p + j, banks);
+          for (; j < width; j++)
+            banks[j & (nbBanks - 1)][p[j]]++;
+        }
+        else {
+          const unsigned char *m = mask[i];
+#if VISP_HAVE_SSE2
+          // Blocks of 16 pixels fully outside or inside the mask are skipped or counted at once
+          const __m128i zero = _mm_setzero_si128();
+          for (; j + 16 <= width; j += 16) {
+            const int outside = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(m + j)), zero));
+            if (outside == 0xffff)
+              continue;
+            if (outside == 0) {
+              count8(p + j, banks);
+              count8(p + j + 8, banks);
+              continue;
+            }
+            for (unsigned int k = j; k < j + 16; k++)
+              banks[k & (nbBanks - 1)][p[k]] += (m[k] != 0);
+          }
+#endif
+          for (; j < width; j++)
+            banks[j & (nbBanks - 1)][p[j]] += (m[j] != 0);
+        }
       }
+
+      for (unsigned int l = 0; l < 256; l++)
+        counts[l] = banks[0][l] + banks[1][l] + banks[2][l] + banks[3][l];
     }
   };
 
-  vpThread::Return computeHistogramThread(vpThread::Args args) {
-    Histogram_Param_t *histogram_param = static_cast<Histogram_Param_t *>(args);
-    unsigned int start_index = histogram_param->m_start_index;
-    unsigned int end_index = histogram_param->m_end_index;
-
-    const vpImage<unsigned char> *I = histogram_param->m_I;
-
-    unsigned char *ptrStart = (unsigned char*) (I->bitmap) + start_index;
-    unsigned char *ptrEnd = (unsigned char*) (I->bitmap) + end_index;
-    unsigned char *ptrCurrent = ptrStart;
-
-
-//    while(ptrCurrent != ptrEnd) {
-//      histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-//      ++ptrCurrent;
-//    }
-
-    if(end_index - start_index >= 8) {
-      //Unroll loop version
-      for(; ptrCurrent <= ptrEnd - 8;) {
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-        ++ptrCurrent;
-
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-        ++ptrCurrent;
-
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-        ++ptrCurrent;
-
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-        ++ptrCurrent;
-
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-        ++ptrCurrent;
-
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-        ++ptrCurrent;
-
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-        ++ptrCurrent;
-
-        histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
-        ++ptrCurrent;
-      }
+  /*
+    Count the grey levels of I over nbThreads bands of rows, and sum the
+    counts of the bands in levels.
+  */
+  void countLevels(const vpImageView<unsigned char> &I, const vpImageView<unsigned char> *mask,
+                   unsigned int nbThreads, unsigned int *levels)
+  {
+    memset(levels, 0, 256 * sizeof(unsigned int));
+    if (I.getSize() == 0)
+      return;
+    if (nbThreads > I.getHeight())
+      nbThreads = I.getHeight();
+    if (nbThreads == 0)
+      nbThreads = 1;
+
+    vpHistogramBand job;
+    job.I = I;
+    if (mask != NULL) {
+      job.mask = *mask;
+      job.useMask = true;
     }
-
-    for(; ptrCurrent != ptrEnd; ++ptrCurrent) {
-      histogram_param->m_histogram[ histogram_param->m_lut[ *ptrCurrent ] ] ++;
+    std::vector<vpHistogramBand> bands(nbThreads, job);
+    for (unsigned int i = 0; i < nbThreads; i++) {
+      bands[i].rowStart = (unsigned int)(((size_t)I.getHeight() * i) / nbThreads);
+      bands[i].rowEnd = (unsigned int)(((size_t)I.getHeight() * (i+1)) / nbThreads);
     }
 
-    return 0;
+    vpThreadPool::getInstance().run(bands);
+
+    for (unsigned int i = 0; i < nbThreads; i++)
+      for (unsigned int l = 0; l < 256; l++)
+        levels[l] += bands[i].counts[l];
   }
 }
-#endif
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
 bool compare_vpHistogramPeak (vpHistogramPeak first, vpHistogramPeak second);
 
@@ -234,13 +278,55 @@ vpHistogram::init(unsigned size_)
 
 /*!
 
-  Calculate the histogram from a gray level image.
+  Calculate the histogram from a gray level image, or from a region of
+  interest given by a vpImageView.
 
-  \param I : Gray level image.
+  The pixels are counted in 4 interleaved sub-histograms, so that the
+  uniform regions don't serialize the increments of the same counter. With
+  several threads, each thread counts a band of rows and the counts are
+  merged at the end.
+
+  \param I : Gray level image or view.
   \param nbins : Number of bins to compute the histogram.
   \param nbThreads : Number of threads to use for the computation.
 */
-void vpHistogram::calculate(const vpImage<unsigned char> &I, const unsigned int nbins, const unsigned int nbThreads)
+void vpHistogram::calculate(const vpImageView<unsigned char> &I, const unsigned int nbins, const unsigned int nbThreads)
+{
+  unsigned int levels[256];
+  countLevels(I, NULL, nbThreads, levels);
+  setLevels(levels, nbins);
+}
+
+/*!
+
+  Calculate the histogram of the pixels of a gray level image, or of a
+  view, where the mask is not null.
+
+  \param I : Gray level image or view.
+  \param mask : Mask of the same size than \e I.
+  \param nbins : Number of bins to compute the histogram.
+  \param nbThreads : Number of threads to use for the computation.
+
+  \exception vpException::dimensionError : If the mask and the image don't
+  have the same size.
+*/
+void vpHistogram::calculate(const vpImageView<unsigned char> &I, const vpImageView<unsigned char> &mask,
+                            const unsigned int nbins, const unsigned int nbThreads)
+{
+  if (mask.getHeight() != I.getHeight() || mask.getWidth() != I.getWidth()) {
+    throw(vpException(vpException::dimensionError, "Mask %dx%d and image %dx%d have different sizes",
+                      mask.getHeight(), mask.getWidth(), I.getHeight(), I.getWidth()));
+  }
+  unsigned int levels[256];
+  countLevels(I, &mask, nbThreads, levels);
+  setLevels(levels, nbins);
+}
+
+/*!
+  Resize the histogram to \e nbins and fill it from the number of pixels
+  of each grey level.
+*/
+void vpHistogram::setLevels(const unsigned int *levels, const unsigned int nbins)
 {
   if(size != nbins) {
     if (histogram != NULL) {
@@ -256,92 +342,8 @@ void vpHistogram::calculate(const vpImage<unsigned char> &I, const unsigned int
   }
 
   memset(histogram, 0, size * sizeof(unsigned int));
-
-
-  bool use_single_thread;
-#if !defined(VISP_HAVE_PTHREAD) && !defined(_WIN32)
-  use_single_thread = true;
-#else
-  use_single_thread = (nbThreads == 0 || nbThreads == 1);
-#endif
-
-  if(!use_single_thread && I.getSize() <= nbThreads) {
-    use_single_thread = true;
-  }
-
-
-  unsigned int lut[256];
   for(unsigned int i = 0; i < 256; i++) {
-    lut[i] = (unsigned int) (i * size / 256.0);
-  }
-
-  if(use_single_thread) {
-    //Single thread
-
-    unsigned int size_ = I.getWidth()*I.getHeight();
-    unsigned char *ptrStart = (unsigned char*) I.bitmap;
-    unsigned char *ptrEnd = ptrStart + size_;
-    unsigned char *ptrCurrent = ptrStart;
-
-    while(ptrCurrent != ptrEnd) {
-      histogram[ lut[ *ptrCurrent ] ] ++;
-      ++ptrCurrent;
-    }
-  } else {
-#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
-    //Multi-threads
-
-    std::vector<vpThread *> threadpool;
-    std::vector<Histogram_Param_t *> histogramParams;
-
-    unsigned int image_size = I.getSize();
-    unsigned int step = image_size / nbThreads;
-    unsigned int last_step = image_size - step * (nbThreads-1);
-
-    for(unsigned int index = 0; index < nbThreads; index++) {
-      unsigned int start_index = index*step;
-      unsigned int end_index = (index+1)*step;
-
-      if(index == nbThreads-1) {
-        end_index = start_index+last_step;
-      }
-
-      Histogram_Param_t *histogram_param = new Histogram_Param_t(start_index, end_index, &I);
-      histogram_param->m_histogram = new unsigned int[size];
-      memset(histogram_param->m_histogram, 0, size * sizeof(unsigned int));
-      memcpy(histogram_param->m_lut, lut, 256*sizeof(unsigned int));
-
-      histogramParams.push_back(histogram_param);
-
-      // Start the threads
-      vpThread *histogram_thread = new vpThread((vpThread::Fn) computeHistogramThread, (vpThread::Args) histogram_param);
-      threadpool.push_back(histogram_thread);
-    }
-
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      // Wait until thread ends up
-      threadpool[cpt]->join();
-    }
-
-    for(unsigned int cpt1 = 0; cpt1 < size; cpt1++) {
-      unsigned int sum = 0;
-
-      for(size_t cpt2 = 0; cpt2 < histogramParams.size(); cpt2++) {
-        sum += histogramParams[cpt2]->m_histogram[cpt1];
-      }
-
-      histogram[cpt1] = sum;
-    }
-
-    //Delete
-    for(size_t cpt = 0; cpt < threadpool.size(); cpt++) {
-      delete threadpool[cpt];
-    }
-
-    for(size_t cpt = 0; cpt < histogramParams.size(); cpt++) {
-      delete histogramParams[cpt];
-    }
-#endif
+    histogram[(unsigned int) (i * size / 256.0)] += levels[i];
   }
 }
 
@@ -0,0 +1,577 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Process-wide work-stealing thread pool.
+ *
+ *****************************************************************************/
+
+#include <deque>
+#include <stdlib.h>
+
+#include <visp3/core/vpThreadPool.h>
+
+#if defined(VISP_HAVE_PTHREAD)
+#  include <pthread.h>
+#  include <unistd.h>
+#elif defined(_WIN32)
+#  include <windows.h>
+#endif
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+#  include <visp3/core/vpThread.h>
+#endif
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+  /*
+    Mutex usable with vpCondition. vpMutex relies on a Windows mutex object,
+    that cannot be waited for with a condition variable.
+  */
+  class vpLock
+  {
+  public:
+#if defined(VISP_HAVE_PTHREAD)
+    vpLock() : m_mutex() { pthread_mutex_init(&m_mutex, NULL); }
+    ~vpLock() { pthread_mutex_destroy(&m_mutex); }
+    void lock() { pthread_mutex_lock(&m_mutex); }
+    void unlock() { pthread_mutex_unlock(&m_mutex); }
+    pthread_mutex_t m_mutex;
+#else
+    vpLock() : m_mutex() { InitializeCriticalSection(&m_mutex); }
+    ~vpLock() { DeleteCriticalSection(&m_mutex); }
+    void lock() { EnterCriticalSection(&m_mutex); }
+    void unlock() { LeaveCriticalSection(&m_mutex); }
+    CRITICAL_SECTION m_mutex;
+#endif
+
+  private:
+    vpLock(const vpLock &);
+    vpLock &operator=(const vpLock &);
+  };
+
+  class vpCondition
+  {
+  public:
+#if defined(VISP_HAVE_PTHREAD)
+    vpCondition() : m_condition() { pthread_cond_init(&m_condition, NULL); }
+    ~vpCondition() { pthread_cond_destroy(&m_condition); }
+    void wait(vpLock &lock) { pthread_cond_wait(&m_condition, &lock.m_mutex); }
+    void notifyAll() { pthread_cond_broadcast(&m_condition); }
+    pthread_cond_t m_condition;
+#else
+    vpCondition() : m_condition() { InitializeConditionVariable(&m_condition); }
+    void wait(vpLock &lock) { SleepConditionVariableCS(&m_condition, &lock.m_mutex, INFINITE); }
+    void notifyAll() { WakeAllConditionVariable(&m_condition); }
+    CONDITION_VARIABLE m_condition;
+#endif
+
+  private:
+    vpCondition(const vpCondition &);
+    vpCondition &operator=(const vpCondition &);
+  };
+
+  class vpScopedLock
+  {
+  public:
+    explicit vpScopedLock(vpLock &lock) : m_lock(lock) { m_lock.lock(); }
+    ~vpScopedLock() { m_lock.unlock(); }
+
+  private:
+    vpScopedLock(const vpScopedLock &);
+    vpScopedLock &operator=(const vpScopedLock &);
+    vpLock &m_lock;
+  };
+#endif
+
+  // Task queued with the group waiting for it
+  struct vpQueuedTask
+  {
+    vpQueuedTask() : task(NULL), group(NULL) {}
+    vpQueuedTask(vpThreadPool::vpTask *t, vpThreadPool::vpTaskGroup *g) : task(t), group(g) {}
+
+    vpThreadPool::vpTask *task;
+    vpThreadPool::vpTaskGroup *group;
+  };
+
+  // Chunk [begin, end) of a parallelFor() loop
+  class vpRangeChunk : public vpThreadPool::vpTask
+  {
+  public:
+    vpRangeChunk() : body(NULL), begin(0), end(0) {}
+    void run() { body->run(begin, end); }
+
+    vpThreadPool::vpRangeTask *body;
+    unsigned int begin;
+    unsigned int end;
+  };
+}
+
+/*
+  Workers and queues of a pool. Without thread support, the pool has no
+  worker and the tasks are run by the calling thread.
+*/
+class vpThreadPool::vpImpl
+{
+public:
+  vpImpl() : m_nbWorkers(0)
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+    , m_threads(), m_workers(), m_queues(), m_lock(), m_condition(), m_pending(0), m_next(0), m_stop(false)
+#endif
+  {
+  }
+
+  ~vpImpl() { stop(); }
+
+  unsigned int m_nbWorkers;
+
+  void start(unsigned int nbWorkers);
+  void stop();
+  void push(vpTask *task, vpTaskGroup *group);
+  bool runOne();
+  void wait(vpTaskGroup &group);
+
+  void execute(const vpQueuedTask &queued);
+  void fail(vpTaskGroup &group, const vpException &e);
+
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+  struct vpWorker
+  {
+    vpWorker() : impl(NULL), index(0) {}
+    vpImpl *impl;
+    unsigned int index;
+  };
+
+  // Queue of a worker: the worker pops its tasks at the back, the other
+  // threads steal them at the front
+  struct vpQueue
+  {
+    vpQueue() : lock(), tasks() {}
+    vpLock lock;
+    std::deque<vpQueuedTask> tasks;
+  };
+
+  std::vector<vpThread *> m_threads;
+  std::vector<vpWorker> m_workers;
+  std::vector<vpQueue *> m_queues;
+  //! Protects m_pending, m_stop and the counters of the groups
+  vpLock m_lock;
+  //! Notified when a task is queued, when a group completes and at stop()
+  vpCondition m_condition;
+  unsigned int m_pending;
+  unsigned int m_next;
+  bool m_stop;
+
+  int currentWorker() const;
+  bool pop(int worker, vpQueuedTask &queued);
+  void loop(unsigned int worker);
+  void finish(vpTaskGroup *group);
+
+  static vpThread::Return workerThread(vpThread::Args args)
+  {
+    vpWorker *worker = (vpWorker *)args;
+    worker->impl->loop(worker->index);
+    return 0;
+  }
+#endif
+};
+
+/*
+  Run a task, an exception being stored in its group and thrown again by
+  vpTaskGroup::wait().
+*/
+void vpThreadPool::vpImpl::execute(const vpQueuedTask &queued)
+{
+  try {
+    queued.task->run();
+  }
+  catch(const vpException &e) {
+    fail(*queued.group, e);
+  }
+  catch(...) {
+    fail(*queued.group, vpException(vpException::fatalError, "Unknown exception thrown by a task"));
+  }
+}
+
+void vpThreadPool::vpImpl::fail(vpTaskGroup &group, const vpException &e)
+{
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+  vpScopedLock lock(m_lock);
+#endif
+  if (! group.m_failed) {
+    group.m_failed = true;
+    group.m_exception = e;
+  }
+}
+
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+void vpThreadPool::vpImpl::start(unsigned int nbWorkers)
+{
+  m_stop = false;
+  m_nbWorkers = nbWorkers;
+  m_workers.resize(nbWorkers);
+  m_queues.resize(nbWorkers);
+  m_threads.resize(nbWorkers);
+  for (unsigned int i = 0; i < nbWorkers; i++)
+    m_queues[i] = new vpQueue;
+  for (unsigned int i = 0; i < nbWorkers; i++) {
+    m_workers[i].impl = this;
+    m_workers[i].index = i;
+    m_threads[i] = new vpThread((vpThread::Fn)workerThread, (vpThread::Args)&m_workers[i]);
+  }
+}
+
+void vpThreadPool::vpImpl::stop()
+{
+  {
+    vpScopedLock lock(m_lock);
+    m_stop = true;
+    m_condition.notifyAll();
+  }
+  for (size_t i = 0; i < m_threads.size(); i++) {
+    m_threads[i]->join();
+    delete m_threads[i];
+  }
+  for (size_t i = 0; i < m_queues.size(); i++)
+    delete m_queues[i];
+  m_threads.clear();
+  m_queues.clear();
+  m_workers.clear();
+  m_nbWorkers = 0;
+}
+
+/*
+  Index of the worker running the calling thread, -1 for a thread out of
+  the pool.
+*/
+int vpThreadPool::vpImpl::currentWorker() const
+{
+  for (size_t i = 0; i < m_threads.size(); i++) {
+#if defined(VISP_HAVE_PTHREAD)
+    if (pthread_equal(m_threads[i]->getHandle(), pthread_self()))
+      return (int)i;
+#else
+    if (GetThreadId(m_threads[i]->getHandle()) == GetCurrentThreadId())
+      return (int)i;
+#endif
+  }
+  return -1;
+}
+
+/*
+  A task queued by a worker goes to its own queue, the tasks queued by
+  other threads are spread over the queues. The task is counted as pending
+  before being queued, so that a thread popping it can't decrement
+  m_pending below 0.
+*/
+void vpThreadPool::vpImpl::push(vpTask *task, vpTaskGroup *group)
+{
+  int worker = currentWorker();
+  vpQueue *queue;
+  {
+    vpScopedLock lock(m_lock);
+    group->m_remaining++;
+    m_pending++;
+    if (worker < 0)
+      worker = (int)(m_next++ % m_nbWorkers);
+  }
+  queue = m_queues[(size_t)worker];
+  {
+    vpScopedLock lock(queue->lock);
+    queue->tasks.push_back(vpQueuedTask(task, group));
+  }
+  vpScopedLock lock(m_lock);
+  m_condition.notifyAll();
+}
+
+/*
+  Pop the last task of the own queue of the worker or steal the first task
+  of another queue.
+*/
+bool vpThreadPool::vpImpl::pop(int worker, vpQueuedTask &queued)
+{
+  if (worker >= 0) {
+    vpQueue *queue = m_queues[(size_t)worker];
+    vpScopedLock lock(queue->lock);
+    if (! queue->tasks.empty()) {
+      queued = queue->tasks.back();
+      queue->tasks.pop_back();
+      return true;
+    }
+  }
+  const unsigned int first = worker >= 0 ? (unsigned int)worker + 1 : 0;
+  for (unsigned int k = 0; k < m_nbWorkers; k++) {
+    vpQueue *queue = m_queues[(first + k) % m_nbWorkers];
+    vpScopedLock lock(queue->lock);
+    if (! queue->tasks.empty()) {
+      queued = queue->tasks.front();
+      queue->tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+void vpThreadPool::vpImpl::finish(vpTaskGroup *group)
+{
+  vpScopedLock lock(m_lock);
+  if (--group->m_remaining == 0)
+    m_condition.notifyAll();
+}
+
+bool vpThreadPool::vpImpl::runOne()
+{
+  vpQueuedTask queued;
+  if (! pop(currentWorker(), queued))
+    return false;
+  {
+    vpScopedLock lock(m_lock);
+    m_pending--;
+  }
+  execute(queued);
+  finish(queued.group);
+  return true;
+}
+
+void vpThreadPool::vpImpl::loop(unsigned int worker)
+{
+  for (;;) {
+    vpQueuedTask queued;
+    if (pop((int)worker, queued)) {
+      {
+        vpScopedLock lock(m_lock);
+        m_pending--;
+      }
+      execute(queued);
+      finish(queued.group);
+      continue;
+    }
+    vpScopedLock lock(m_lock);
+    while (m_pending == 0 && ! m_stop)
+      m_condition.wait(m_lock);
+    if (m_stop && m_pending == 0)
+      return;
+  }
+}
+
+/*
+  Wait for the tasks of a group, running the queued tasks meanwhile.
+*/
+void vpThreadPool::vpImpl::wait(vpTaskGroup &group)
+{
+  for (;;) {
+    {
+      vpScopedLock lock(m_lock);
+      if (group.m_remaining == 0)
+        return;
+    }
+    if (runOne())
+      continue;
+    vpScopedLock lock(m_lock);
+    while (group.m_remaining > 0 && m_pending == 0)
+      m_condition.wait(m_lock);
+  }
+}
+
+#else
+void vpThreadPool::vpImpl::start(unsigned int) {}
+void vpThreadPool::vpImpl::stop() {}
+void vpThreadPool::vpImpl::push(vpTask *, vpTaskGroup *) {}
+bool vpThreadPool::vpImpl::runOne() { return false; }
+void vpThreadPool::vpImpl::wait(vpTaskGroup &) {}
+#endif
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+/*!
+  Create a group of tasks run by \e pool.
+*/
+vpThreadPool::vpTaskGroup::vpTaskGroup(vpThreadPool &pool)
+  : m_pool(pool), m_remaining(0), m_failed(false), m_exception(vpException::notInitialized)
+{
+}
+
+/*!
+  Wait for the tasks still running. An exception thrown by a task is lost.
+*/
+vpThreadPool::vpTaskGroup::~vpTaskGroup()
+{
+  m_pool.m_impl->wait(*this);
+}
+
+/*!
+  Queue a task. Without any worker, the task is run immediately by the
+  calling thread.
+*/
+void vpThreadPool::vpTaskGroup::run(vpTask &task)
+{
+  if (m_pool.m_impl->m_nbWorkers == 0) {
+    m_pool.m_impl->execute(vpQueuedTask(&task, this));
+    return;
+  }
+  m_pool.m_impl->push(&task, this);
+}
+
+/*!
+  Wait for all the tasks of the group. The calling thread runs queued tasks
+  while waiting.
+
+  \exception vpException : The first exception thrown by a task of the
+  group, if any.
+*/
+void vpThreadPool::vpTaskGroup::wait()
+{
+  m_pool.m_impl->wait(*this);
+  if (m_failed) {
+    m_failed = false;
+    throw m_exception;
+  }
+}
+
+/*!
+  Create a pool of \e nbThreads threads, including the calling thread: the
+  pool has nbThreads - 1 workers. With 0, getDefaultNbThreads() threads are
+  used. Prefer the pool shared by the process, returned by getInstance().
+*/
+vpThreadPool::vpThreadPool(unsigned int nbThreads)
+  : m_impl(new vpImpl)
+{
+  setNbThreads(nbThreads);
+}
+
+/*!
+  Destructor. The workers finish the queued tasks then are joined.
+*/
+vpThreadPool::~vpThreadPool()
+{
+  delete m_impl;
+}
+
+/*!
+  Return the pool shared by the process, created at the first call with
+  getDefaultNbThreads() threads.
+*/
+vpThreadPool &vpThreadPool::getInstance()
+{
+  static vpThreadPool pool;
+  return pool;
+}
+
+/*!
+  Return the value of the VISP_NUM_THREADS environment variable if it is a
+  positive number, the number of processors otherwise.
+*/
+unsigned int vpThreadPool::getDefaultNbThreads()
+{
+  const char *env = getenv("VISP_NUM_THREADS");
+  if (env != NULL && atoi(env) > 0)
+    return (unsigned int)atoi(env);
+
+#if defined(VISP_HAVE_PTHREAD) && defined(_SC_NPROCESSORS_ONLN)
+  const long nbProcessors = sysconf(_SC_NPROCESSORS_ONLN);
+  return nbProcessors > 0 ? (unsigned int)nbProcessors : 1;
+#elif defined(_WIN32)
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors > 0 ? (unsigned int)info.dwNumberOfProcessors : 1;
+#else
+  return 1;
+#endif
+}
+
+/*!
+  Return the number of threads running the tasks, the thread waiting for
+  them included.
+*/
+unsigned int vpThreadPool::getNbThreads() const
+{
+  return m_impl->m_nbWorkers + 1;
+}
+
+/*!
+  Change the number of threads of the pool, the calling thread included.
+  With 0, getDefaultNbThreads() threads are used. Without thread support,
+  the pool always has a single thread.
+
+  \warning The workers are stopped and created again: the pool must not be
+  running tasks.
+*/
+void vpThreadPool::setNbThreads(unsigned int nbThreads)
+{
+  if (nbThreads == 0)
+    nbThreads = getDefaultNbThreads();
+  m_impl->stop();
+#if defined(VISP_HAVE_PTHREAD) || defined(_WIN32)
+  m_impl->start(nbThreads - 1);
+#endif
+}
+
+/*!
+  Call body.run(b, e) on chunks [b, e) covering [begin, end), in parallel,
+  and wait for all of them.
+
+  \param begin, end : Range of indexes.
+  \param body : Loop body.
+  \param grain : Number of indexes of a chunk. With 0, the range is split
+  into 4 chunks per thread, so that the threads finishing early steal the
+  remaining chunks.
+  \param maxThreads : If not 0, the range is split into at most
+  \e maxThreads chunks.
+
+  \exception vpException : The first exception thrown by \e body, if any.
+*/
+void vpThreadPool::parallelFor(unsigned int begin, unsigned int end, vpRangeTask &body,
+                               unsigned int grain, unsigned int maxThreads)
+{
+  if (end <= begin)
+    return;
+  const unsigned int n = end - begin;
+  unsigned int nbThreads = getNbThreads();
+  if (maxThreads > 0 && maxThreads < nbThreads)
+    nbThreads = maxThreads;
+  unsigned int nbChunks = grain > 0 ? (n + grain - 1) / grain : 4 * nbThreads;
+  if (maxThreads > 0 && nbChunks > maxThreads)
+    nbChunks = maxThreads;
+  if (nbChunks > n)
+    nbChunks = n;
+
+  if (nbThreads <= 1 || nbChunks <= 1) {
+    body.run(begin, end);
+    return;
+  }
+
+  std::vector<vpRangeChunk> chunks(nbChunks);
+  vpTaskGroup group(*this);
+  for (unsigned int i = 0; i < nbChunks; i++) {
+    chunks[i].body = &body;
+    chunks[i].begin = begin + (unsigned int)(((size_t)n * i) / nbChunks);
+    chunks[i].end = begin + (unsigned int)(((size_t)n * (i + 1)) / nbChunks);
+    group.run(chunks[i]);
+  }
+  group.wait();
+}
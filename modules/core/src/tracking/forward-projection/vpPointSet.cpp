@@ -0,0 +1,361 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Set of 3D points stored as a structure of arrays.
+ *
+ *****************************************************************************/
+
+#include <visp3/core/vpException.h>
+#include <visp3/core/vpPointSet.h>
+
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
+
+/*!
+  Default constructor, with an empty set.
+*/
+vpPointSet::vpPointSet()
+  : m_oX(), m_oY(), m_oZ(), m_X(), m_Y(), m_Z(), m_x(), m_y(), m_u(), m_v()
+{
+}
+
+/*!
+  Create a set from the coordinates in the object frame of a list of points.
+*/
+vpPointSet::vpPointSet(const std::list<vpPoint> &points)
+  : m_oX(), m_oY(), m_oZ(), m_X(), m_Y(), m_Z(), m_x(), m_y(), m_u(), m_v()
+{
+  buildFrom(points);
+}
+
+/*!
+  Create a set from the coordinates in the object frame of a vector of points.
+*/
+vpPointSet::vpPointSet(const std::vector<vpPoint> &points)
+  : m_oX(), m_oY(), m_oZ(), m_X(), m_Y(), m_Z(), m_x(), m_y(), m_u(), m_v()
+{
+  buildFrom(points);
+}
+
+/*!
+  Add a point given by its coordinates in the object frame.
+*/
+void vpPointSet::addPoint(double oX, double oY, double oZ)
+{
+  m_oX.push_back(oX);
+  m_oY.push_back(oY);
+  m_oZ.push_back(oZ);
+}
+
+/*!
+  Add a point given by its coordinates in the object frame, normalized by
+  its homogeneous coordinate.
+*/
+void vpPointSet::addPoint(const vpPoint &P)
+{
+  const double oW = P.get_oW();
+  if (oW == 1.)
+    addPoint(P.get_oX(), P.get_oY(), P.get_oZ());
+  else
+    addPoint(P.get_oX() / oW, P.get_oY() / oW, P.get_oZ() / oW);
+}
+
+/*!
+  Replace the points of the set by the points of a list.
+*/
+void vpPointSet::buildFrom(const std::list<vpPoint> &points)
+{
+  clear();
+  reserve((unsigned int)points.size());
+  for (std::list<vpPoint>::const_iterator it = points.begin(); it != points.end(); ++it)
+    addPoint(*it);
+}
+
+/*!
+  Replace the points of the set by the points of a vector.
+*/
+void vpPointSet::buildFrom(const std::vector<vpPoint> &points)
+{
+  clear();
+  reserve((unsigned int)points.size());
+  for (size_t i = 0; i < points.size(); i++)
+    addPoint(points[i]);
+}
+
+/*!
+  Remove all the points. The memory is kept for the next points.
+*/
+void vpPointSet::clear()
+{
+  m_oX.clear();
+  m_oY.clear();
+  m_oZ.clear();
+}
+
+/*!
+  Allocate the memory for \e n points.
+*/
+void vpPointSet::reserve(unsigned int n)
+{
+  m_oX.reserve(n);
+  m_oY.reserve(n);
+  m_oZ.reserve(n);
+}
+
+/*!
+  Modify the coordinates in the object frame of the point \e i.
+*/
+void vpPointSet::setWorldCoordinates(unsigned int i, double oX, double oY, double oZ)
+{
+  if (i >= size()) {
+    throw(vpException(vpException::dimensionError, "Cannot set point %d of a set of %d points", i, size()));
+  }
+  m_oX[i] = oX;
+  m_oY[i] = oY;
+  m_oZ[i] = oZ;
+}
+
+/*!
+  Compute the coordinates of all the points in the camera frame.
+
+  \param cMo : Transformation from camera to object frame.
+*/
+void vpPointSet::changeFrame(const vpHomogeneousMatrix &cMo)
+{
+  transform(cMo, false, NULL);
+}
+
+/*!
+  Compute the normalized coordinates of all the points from their
+  coordinates in the camera frame, as updated by changeFrame().
+
+  \exception vpException::notInitialized : If changeFrame() was not called
+  since points were added.
+*/
+void vpPointSet::projection()
+{
+  const unsigned int n = size();
+  if (m_X.size() != n) {
+    throw(vpException(vpException::notInitialized, "Cannot project a set of points not changed of frame"));
+  }
+  m_x.resize(n);
+  m_y.resize(n);
+  for (unsigned int i = 0; i < n; i++) {
+    const double d = 1 / m_Z[i];
+    m_x[i] = m_X[i] * d;
+    m_y[i] = m_Y[i] * d;
+  }
+}
+
+/*!
+  Compute the pixel coordinates of all the points from their normalized
+  coordinates, as updated by projection(), with the projection model of the
+  camera as vpMeterPixelConversion::convertPoint() does.
+
+  \exception vpException::notInitialized : If projection() was not called
+  since points were added.
+*/
+void vpPointSet::meterToPixel(const vpCameraParameters &cam)
+{
+  const unsigned int n = size();
+  if (m_x.size() != n) {
+    throw(vpException(vpException::notInitialized, "Cannot convert a set of points not projected in pixels"));
+  }
+  m_u.resize(n);
+  m_v.resize(n);
+  const double px = cam.get_px(), py = cam.get_py(), u0 = cam.get_u0(), v0 = cam.get_v0();
+  if (cam.get_projModel() == vpCameraParameters::perspectiveProjWithDistortion) {
+    const double kud = cam.get_kud();
+    for (unsigned int i = 0; i < n; i++) {
+      double r2 = 1. + kud * (m_x[i] * m_x[i] + m_y[i] * m_y[i]);
+      m_u[i] = u0 + px * m_x[i] * r2;
+      m_v[i] = v0 + py * m_y[i] * r2;
+    }
+  }
+  else {
+    for (unsigned int i = 0; i < n; i++) {
+      m_u[i] = m_x[i] * px + u0;
+      m_v[i] = m_y[i] * py + v0;
+    }
+  }
+}
+
+/*!
+  Compute the coordinates of all the points in the camera frame and their
+  normalized coordinates, in a single pass. This is equivalent to
+  changeFrame() followed by projection().
+
+  \param cMo : Transformation from camera to object frame.
+*/
+void vpPointSet::track(const vpHomogeneousMatrix &cMo)
+{
+  transform(cMo, true, NULL);
+}
+
+/*!
+  Compute the coordinates of all the points in the camera frame, their
+  normalized and their pixel coordinates, in a single pass. This is
+  equivalent to changeFrame(), projection() and meterToPixel().
+
+  \param cMo : Transformation from camera to object frame.
+  \param cam : Camera parameters.
+*/
+void vpPointSet::track(const vpHomogeneousMatrix &cMo, const vpCameraParameters &cam)
+{
+  transform(cMo, true, &cam);
+}
+
+/*!
+  Set the coordinates in the object frame, in the camera frame and the
+  normalized coordinates of a vpPoint from the point \e i of the set, as
+  updated by the last call to track().
+*/
+void vpPointSet::getPoint(unsigned int i, vpPoint &P) const
+{
+  if (i >= size()) {
+    throw(vpException(vpException::dimensionError, "Cannot get point %d of a set of %d points", i, size()));
+  }
+  P.setWorldCoordinates(m_oX[i], m_oY[i], m_oZ[i]);
+  if (i < m_X.size()) {
+    P.set_X(m_X[i]);
+    P.set_Y(m_Y[i]);
+    P.set_Z(m_Z[i]);
+    P.set_W(1);
+  }
+  if (i < m_x.size()) {
+    P.set_x(m_x[i]);
+    P.set_y(m_y[i]);
+    P.set_w(1);
+  }
+}
+
+/*!
+  Fused change of frame, projection and conversion to pixels. The
+  operations are done in the same order as in vpPoint::track() and
+  vpMeterPixelConversion::convertPoint() so that the results are the same.
+*/
+void vpPointSet::transform(const vpHomogeneousMatrix &cMo, bool storeNormalized, const vpCameraParameters *cam)
+{
+  const unsigned int n = size();
+  m_X.resize(n);
+  m_Y.resize(n);
+  m_Z.resize(n);
+  if (storeNormalized) {
+    m_x.resize(n);
+    m_y.resize(n);
+  }
+  if (cam != NULL) {
+    m_u.resize(n);
+    m_v.resize(n);
+  }
+  if (n == 0)
+    return;
+
+  const double r00 = cMo[0][0], r01 = cMo[0][1], r02 = cMo[0][2], t0 = cMo[0][3];
+  const double r10 = cMo[1][0], r11 = cMo[1][1], r12 = cMo[1][2], t1 = cMo[1][3];
+  const double r20 = cMo[2][0], r21 = cMo[2][1], r22 = cMo[2][2], t2 = cMo[2][3];
+  const bool distortion = cam != NULL && cam->get_projModel() == vpCameraParameters::perspectiveProjWithDistortion;
+  const double px = cam ? cam->get_px() : 0, py = cam ? cam->get_py() : 0;
+  const double u0 = cam ? cam->get_u0() : 0, v0 = cam ? cam->get_v0() : 0;
+  const double kud = cam ? cam->get_kud() : 0;
+
+  const double *oX = &m_oX[0], *oY = &m_oY[0], *oZ = &m_oZ[0];
+  double *X = &m_X[0], *Y = &m_Y[0], *Z = &m_Z[0];
+  double *x = storeNormalized ? &m_x[0] : NULL, *y = storeNormalized ? &m_y[0] : NULL;
+  double *u = cam ? &m_u[0] : NULL, *v = cam ? &m_v[0] : NULL;
+
+  unsigned int i = 0;
+#if VISP_HAVE_SSE2
+  const __m128d vr00 = _mm_set1_pd(r00), vr01 = _mm_set1_pd(r01), vr02 = _mm_set1_pd(r02), vt0 = _mm_set1_pd(t0);
+  const __m128d vr10 = _mm_set1_pd(r10), vr11 = _mm_set1_pd(r11), vr12 = _mm_set1_pd(r12), vt1 = _mm_set1_pd(t1);
+  const __m128d vr20 = _mm_set1_pd(r20), vr21 = _mm_set1_pd(r21), vr22 = _mm_set1_pd(r22), vt2 = _mm_set1_pd(t2);
+  const __m128d vpx = _mm_set1_pd(px), vpy = _mm_set1_pd(py), vu0 = _mm_set1_pd(u0), vv0 = _mm_set1_pd(v0);
+  const __m128d vkud = _mm_set1_pd(kud), vone = _mm_set1_pd(1.);
+  for (; i + 2 <= n; i += 2) {
+    const __m128d ox = _mm_loadu_pd(oX + i), oy = _mm_loadu_pd(oY + i), oz = _mm_loadu_pd(oZ + i);
+    const __m128d cx = _mm_add_pd(
+        _mm_add_pd(_mm_add_pd(_mm_mul_pd(vr00, ox), _mm_mul_pd(vr01, oy)), _mm_mul_pd(vr02, oz)), vt0);
+    const __m128d cy = _mm_add_pd(
+        _mm_add_pd(_mm_add_pd(_mm_mul_pd(vr10, ox), _mm_mul_pd(vr11, oy)), _mm_mul_pd(vr12, oz)), vt1);
+    const __m128d cz = _mm_add_pd(
+        _mm_add_pd(_mm_add_pd(_mm_mul_pd(vr20, ox), _mm_mul_pd(vr21, oy)), _mm_mul_pd(vr22, oz)), vt2);
+    _mm_storeu_pd(X + i, cx);
+    _mm_storeu_pd(Y + i, cy);
+    _mm_storeu_pd(Z + i, cz);
+    if (!storeNormalized && cam == NULL)
+      continue;
+
+    const __m128d d = _mm_div_pd(vone, cz);
+    const __m128d nx = _mm_mul_pd(cx, d), ny = _mm_mul_pd(cy, d);
+    if (storeNormalized) {
+      _mm_storeu_pd(x + i, nx);
+      _mm_storeu_pd(y + i, ny);
+    }
+    if (distortion) {
+      const __m128d r2 = _mm_add_pd(vone, _mm_mul_pd(vkud, _mm_add_pd(_mm_mul_pd(nx, nx), _mm_mul_pd(ny, ny))));
+      _mm_storeu_pd(u + i, _mm_add_pd(vu0, _mm_mul_pd(_mm_mul_pd(vpx, nx), r2)));
+      _mm_storeu_pd(v + i, _mm_add_pd(vv0, _mm_mul_pd(_mm_mul_pd(vpy, ny), r2)));
+    }
+    else if (cam != NULL) {
+      _mm_storeu_pd(u + i, _mm_add_pd(_mm_mul_pd(nx, vpx), vu0));
+      _mm_storeu_pd(v + i, _mm_add_pd(_mm_mul_pd(ny, vpy), vv0));
+    }
+  }
+#endif
+
+  for (; i < n; i++) {
+    const double cx = r00 * oX[i] + r01 * oY[i] + r02 * oZ[i] + t0;
+    const double cy = r10 * oX[i] + r11 * oY[i] + r12 * oZ[i] + t1;
+    const double cz = r20 * oX[i] + r21 * oY[i] + r22 * oZ[i] + t2;
+    X[i] = cx;
+    Y[i] = cy;
+    Z[i] = cz;
+    if (!storeNormalized && cam == NULL)
+      continue;
+
+    const double d = 1 / cz;
+    const double nx = cx * d, ny = cy * d;
+    if (storeNormalized) {
+      x[i] = nx;
+      y[i] = ny;
+    }
+    if (distortion) {
+      const double r2 = 1. + kud * (nx * nx + ny * ny);
+      u[i] = u0 + px * nx * r2;
+      v[i] = v0 + py * ny * r2;
+    }
+    else if (cam != NULL) {
+      u[i] = nx * px + u0;
+      v[i] = ny * py + v0;
+    }
+  }
+}
@@ -40,16 +40,152 @@
 #include <visp3/core/vpCameraParameters.h>
 #include <visp3/core/vpPixelMeterConversion.h>
 #include <visp3/core/vpConfig.h>
+#include <visp3/core/vpThreadPool.h>
 #include <stdexcept>
 
 #include <cmath>
 #include <limits>
 
-#ifdef VISP_HAVE_OPENMP
-#include <omp.h>
-#endif
 #include <cassert>
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace {
+  /*
+    Accumulate the moments m_pq, p+q < order, of the rows [rowStart, rowEnd)
+    of an image, each pixel being weighted by weights[I[i][j]]. The pixels
+    of null weight are skipped, and so are the columns of a row before the
+    first and after the last pixel of non null weight.
+
+    Without distortion, x only depends on the column and y on the row. The
+    powers of x are then read from the table xPowers, and the moments of a
+    row are y^q times the weighted sums of the powers of x over the row:
+    each pixel costs order additions. With distortion, the powers of x and
+    y are computed incrementally for each pixel.
+  */
+  struct vpMomentBand
+  {
+    vpMomentBand()
+      : image(NULL), cam(NULL), weights(NULL), xPowers(NULL), order(0), rowStart(0), rowEnd(0), moments()
+    {}
+
+    const vpImage<unsigned char> *image;
+    const vpCameraParameters *cam;
+    const double *weights;
+    const double *xPowers;
+    unsigned int order;
+    unsigned int rowStart;
+    unsigned int rowEnd;
+    std::vector<double> moments;
+
+    void run()
+    {
+      moments.assign(order * order, 0.);
+      std::vector<double> rowSums(order);
+      const unsigned int width = image->getWidth();
+
+      for (unsigned int j = rowStart; j < rowEnd; j++) {
+        const unsigned char *row = (*image)[j];
+        unsigned int first = 0, last = width;
+        while (first < last && weights[row[first]] == 0.)
+          first++;
+        while (last > first && weights[row[last - 1]] == 0.)
+          last--;
+        if (first == last)
+          continue;
+
+        if (xPowers != NULL) {
+          std::fill(rowSums.begin(), rowSums.end(), 0.);
+          for (unsigned int i = first; i < last; i++) {
+            const double w = weights[row[i]];
+            if (w == 0.)
+              continue;
+            const double *xp = xPowers + i * order;
+            for (unsigned int l = 0; l < order; l++)
+              rowSums[l] += w * xp[l];
+          }
+
+          double x = 0, y = 0;
+          vpPixelMeterConversion::convertPoint(*cam, 0, j, x, y);
+          double yval = 1.;
+          for (unsigned int k = 0; k < order; k++) {
+            for (unsigned int l = 0; l < order - k; l++)
+              moments[k * order + l] += yval * rowSums[l];
+            yval *= y;
+          }
+        }
+        else {
+          for (unsigned int i = first; i < last; i++) {
+            const double w = weights[row[i]];
+            if (w == 0.)
+              continue;
+            double x = 0, y = 0;
+            vpPixelMeterConversion::convertPoint(*cam, i, j, x, y);
+            double yval = w;
+            for (unsigned int k = 0; k < order; k++) {
+              double xyval = yval;
+              for (unsigned int l = 0; l < order - k; l++) {
+                moments[k * order + l] += xyval;
+                xyval *= x;
+              }
+              yval *= y;
+            }
+          }
+        }
+      }
+    }
+  };
+
+  /*
+    Compute in values the moments m_pq, p+q < order, of an image weighted by
+    weights, over nbThreads bands of rows which moments are summed at the end.
+  */
+  void computeImageMoments(const vpImage<unsigned char> &image, const vpCameraParameters &cam,
+                           const double (&weights)[256], unsigned int order, unsigned int nbThreads,
+                           std::vector<double> &values)
+  {
+    values.assign(order * order, 0.);
+    if (image.getSize() == 0)
+      return;
+    if (nbThreads > image.getHeight())
+      nbThreads = image.getHeight();
+    if (nbThreads == 0)
+      nbThreads = 1;
+
+    std::vector<double> xPowers;
+    if (cam.get_projModel() == vpCameraParameters::perspectiveProjWithoutDistortion) {
+      xPowers.resize((size_t)image.getWidth() * order);
+      for (unsigned int i = 0; i < image.getWidth(); i++) {
+        double x = 0, y = 0;
+        vpPixelMeterConversion::convertPoint(cam, i, 0, x, y);
+        double xval = 1.;
+        for (unsigned int l = 0; l < order; l++) {
+          xPowers[i * order + l] = xval;
+          xval *= x;
+        }
+      }
+    }
+
+    vpMomentBand job;
+    job.image = &image;
+    job.cam = &cam;
+    job.weights = weights;
+    job.xPowers = xPowers.empty() ? NULL : &xPowers[0];
+    job.order = order;
+    std::vector<vpMomentBand> bands(nbThreads, job);
+    for (unsigned int i = 0; i < nbThreads; i++) {
+      bands[i].rowStart = (unsigned int)(((size_t)image.getHeight() * i) / nbThreads);
+      bands[i].rowEnd = (unsigned int)(((size_t)image.getHeight() * (i+1)) / nbThreads);
+    }
+
+    vpThreadPool::getInstance().run(bands);
+
+    for (unsigned int i = 0; i < nbThreads; i++)
+      for (unsigned int k = 0; k < order * order; k++)
+        values[k] += bands[i].moments[k];
+  }
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Computes moments from a vector of points describing a polygon.
   The points must be stored in a clockwise order. Used internally.
@@ -133,32 +269,6 @@ void vpMomentObject::cacheValues(std::vector<double>& cache,double x, double y){
     }
 }
 
-/*!
- * Manikandan.B
- * Need to cache intensity along with the coordinates for photometric moments
- */
-void vpMomentObject::cacheValues(std::vector<double>& cache,double x, double y, double IntensityNormalized) {
-
-    cache[0]=IntensityNormalized;
-
-    double invIntensityNormalized = 0.;
-    if (std::fabs(IntensityNormalized)>=std::numeric_limits<double>::epsilon())
-         invIntensityNormalized = 1.0/IntensityNormalized;
-
-    for(unsigned int i=1;i<order;i++)
-        cache[i]=cache[i-1]*x;
-
-    for(unsigned int j=order;j<order*order;j+=order)
-        cache[j]=cache[j-order]*y;
-
-    for(unsigned int j=1;j<order;j++){
-        for(unsigned int i=1;i<order-j;i++){
-            cache[j*order+i] = cache[j*order]*cache[i]*invIntensityNormalized;
-        }
-    }
-}
-
-
 /*!
   Computes basic moments from a vector of points.
   There are two cases:
@@ -264,6 +374,11 @@ void vpMomentObject::fromVector(std::vector<vpPoint>& points){
   \param image : Image to consider.
   \param threshold : Pixels with a luminance lower than this threshold will be considered.
   \param cam : Camera parameters used to convert pixels coordinates in meters in the image plane.
+  \param nbThreads : Maximum number of threads of vpThreadPool::getInstance() used for the computation.
+
+  All the moments are accumulated in a single pass over the image, by bands
+  of rows summed at the end. Without distortion, the moments of a row are
+  computed from the sums of the powers of x over its pixels.
 
   The code below shows how to use this function.
   \code
@@ -286,71 +401,12 @@ int main()
   \endcode
 */
 
-void vpMomentObject::fromImage(const vpImage<unsigned char>& image, unsigned char threshold, const vpCameraParameters& cam){
-#ifdef VISP_HAVE_OPENMP
-  #pragma omp parallel shared(threshold)
-  {
-    std::vector<double> curvals(order*order);
-    curvals.assign(order*order,0.);
-    unsigned int i_, j_;
-
-    #pragma omp for nowait//automatically organize loop counter between threads
-    for(int i=0;i<(int)image.getCols();i++){
-      for(int j=0;j<(int)image.getRows();j++){
-        i_ = static_cast<unsigned int>(i);
-        j_ = static_cast<unsigned int>(j);
-        if(image[j_][i_]>threshold){
-          double x=0;
-          double y=0;
-          vpPixelMeterConversion::convertPoint(cam,i_,j_,x,y);
-
-          double yval=1.;
-          for(unsigned int k=0;k<order;k++){
-            double xval=1.;
-            for(unsigned int l=0;l<order-k;l++){
-              curvals[(k*order+l)]+=(xval*yval);
-              xval*=x;
-            }
-            yval*=y;
-          }
-        }
-      }
-    }
-
-    #pragma omp master //only set this variable in master thread
-    {
-      values.assign(order*order, 0.);
-    }
-
-    #pragma omp barrier
-
-    for(unsigned int k=0;k<order;k++){
-      for(unsigned int l=0;l<order-k;l++){
-        //#pragma omp atomic // Removed since causes a build issue with msvc14 2015
-        values[k*order+l]+= curvals[k*order+l];
-      }
-    }
-
-  }
-#else
-    std::vector<double> cache(order*order,0.);
-    values.assign(order*order,0);
-    for(unsigned int i=0;i<image.getCols();i++){
-        for(unsigned int j=0;j<image.getRows();j++){
-            if(image[j][i]>threshold){
-                double x=0;
-                double y=0;
-                vpPixelMeterConversion::convertPoint(cam,i,j,x,y);
-                cacheValues(cache,x,y);
-                for(unsigned int k=0;k<order;k++){
-                    for(unsigned int l=0;l<order-k;l++){
-                        values[k*order+l]+=cache[k*order+l];
-                    }
-                }
-            }
-        }
-    }
-#endif
+void vpMomentObject::fromImage(const vpImage<unsigned char>& image, unsigned char threshold, const vpCameraParameters& cam,
+                               unsigned int nbThreads){
+    double weights[256];
+    for (unsigned int i = 0; i < 256; i++)
+      weights[i] = (i > threshold) ? 1. : 0.;
+    computeImageMoments(image, cam, weights, order, nbThreads, values);
 
     //Normalisation equivalent to sampling interval/pixel size delX x delY
     double norm_factor = 1./(cam.get_px()*cam.get_py());
@@ -368,77 +424,25 @@ void vpMomentObject::fromImage(const vpImage<unsigned char>& image, unsigned cha
  * @param bg_type                 : White/Black background surrounding the image
  * @param normalize_with_pix_size : This flag if SET, the moments, after calculation are normalized w.r.t  pixel size
  *                                  available from camera parameters
+ * @param nbThreads               : Maximum number of threads of vpThreadPool::getInstance() used for the computation
  */
 void vpMomentObject::fromImage(const vpImage<unsigned char>& image, const vpCameraParameters& cam,
-    vpCameraImgBckGrndType bg_type, bool normalize_with_pix_size)
+    vpCameraImgBckGrndType bg_type, bool normalize_with_pix_size, unsigned int nbThreads)
 {
-  std::vector<double> cache(order*order,0.);
-  values.assign(order*order,0);
-
-  // (x,y) - Pixel co-ordinates in metres
-  double x=0;
-  double y=0;
-  //for indexing into cache[] and values[]
-  unsigned int idx = 0;
-  unsigned int kidx = 0;
-
-  double intensity = 0;
-
-  //double Imax = static_cast<double>(image.getMaxValue());
-
   double iscale = 1.0;
   if (flg_normalize_intensity) {                                            // This makes the image a probability density function
     double Imax = 255.;                                                     // To check the effect of gray level change. ISR Coimbra
     iscale = 1.0/Imax;
   }
 
-  if (bg_type == vpMomentObject::WHITE) {
-      /////////// WHITE BACKGROUND ///////////
-      for(unsigned int j=0;j<image.getRows();j++){
-          for(unsigned int i=0;i<image.getCols();i++){
-              x = 0;
-              y = 0;
-              intensity = (double)(image[j][i])*iscale;
-              double intensity_white = 1. - intensity;
-
-              vpPixelMeterConversion::convertPoint(cam,i,j,x,y);
-              cacheValues(cache,x,y, intensity_white);			// Modify 'cache' which has x^p*y^q to x^p*y^q*(1 - I(x,y))
-
-              // Copy to "values"
-              for(unsigned int k=0;k<order;k++){
-                  kidx = k*order;
-                  for(unsigned int l=0;l<order-k;l++){
-                      idx = kidx+l;
-                      values[idx]+= cache[idx];
-                  }
-              }
-          }
-      }
-  }
-  else {
-      /////////// BLACK BACKGROUND	///////////
-      for(unsigned int j=0;j<image.getRows();j++){
-          for(unsigned int i=0;i<image.getCols();i++){
-              x = 0;
-              y = 0;
-              intensity = (double)(image[j][i])*iscale;
-              vpPixelMeterConversion::convertPoint(cam,i,j,x,y);
-
-              // Cache values for fast moment calculation
-              cacheValues(cache,x,y, intensity);					// Modify 'cache' which has x^p*y^q to x^p*y^q*I(x,y)
-
-              // Copy to moments array 'values'
-              for(unsigned int k=0;k<order;k++){
-                  kidx = k*order;
-                  for(unsigned int l=0;l<order-k;l++){
-                      idx = kidx+l;
-                      values[idx]+= cache[idx];
-                  }
-              }
-
-          }
-      }
+  // Each pixel is weighted by its intensity x^p*y^q*I(x,y), or by
+  // x^p*y^q*(1 - I(x,y)) for a white background
+  double weights[256];
+  for (unsigned int i = 0; i < 256; i++) {
+    double intensity = (double)i*iscale;
+    weights[i] = (bg_type == vpMomentObject::WHITE) ? 1. - intensity : intensity;
   }
+  computeImageMoments(image, cam, weights, order, nbThreads, values);
 
   if (normalize_with_pix_size){
       // Normalisation equivalent to sampling interval/pixel size delX x delY
@@ -0,0 +1,201 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the SIMD and multithreaded colour conversions of vpImageConvert.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testColorConversion.cpp
+
+  \brief Test that the SIMD and multithreaded colour conversions of
+  vpImageConvert give exactly the values of the former per pixel code.
+*/
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <stdlib.h>
+
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+  // The former RGB to grey code converted the blocks of 16 pixels with SSSE3 fixed-point weights
+#if defined __SSSE3__ || (defined _MSC_VER && _MSC_VER >= 1500)
+  const bool fixedPointBlocks = true;
+#else
+  const bool fixedPointBlocks = false;
+#endif
+
+  unsigned char referenceGrey(unsigned int r, unsigned int g, unsigned int b, bool fixedPoint)
+  {
+    if (fixedPoint)
+      return (unsigned char)((((r << 8) * 13933 >> 16) + ((g << 8) * 46871 >> 16) + ((b << 8) * 4732 >> 16)) >> 8);
+    return (unsigned char)(0.2126 * r + 0.7152 * g + 0.0722 * b);
+  }
+
+  // Grey conversion of n pixels, the 16 pixels blocks being counted from the first one
+  void referenceGrey(const unsigned char *src, unsigned char *grey, unsigned int n, unsigned int step, bool bgr)
+  {
+    unsigned int nbBlocks = fixedPointBlocks ? n / 16 : 0;
+    for (unsigned int i = 0; i < n; i++, src += step)
+      grey[i] = referenceGrey(src[bgr ? 2 : 0], src[1], src[bgr ? 0 : 2], i < nbBlocks * 16);
+  }
+
+  void referenceYUYVToRGBa(const unsigned char *s, unsigned char *d, unsigned int n)
+  {
+    for (unsigned int c = 0; c < n; c++, s += 4) {
+      int cb = ((s[1] - 128) * 454) >> 8;
+      int cg = ((s[1] - 128) * 88 + (s[3] - 128) * 183) >> 8;
+      int cr = ((s[3] - 128) * 359) >> 8;
+      for (unsigned int k = 0; k < 2; k++) {
+        int y = s[2*k];
+        int rgb[3] = { y + cr, y - cg, y + cb };
+        for (unsigned int l = 0; l < 3; l++)
+          *d++ = (unsigned char)(rgb[l] < 0 ? 0 : (rgb[l] > 255 ? 255 : rgb[l]));
+        *d++ = 0;
+      }
+    }
+  }
+
+  void referenceYUV420ToRGBa(const unsigned char *yuv, unsigned char *rgba, unsigned int width, unsigned int height)
+  {
+    const unsigned char *iU = yuv + width * height;
+    const unsigned char *iV = yuv + 5 * width * height / 4;
+    for (unsigned int i = 0; i < height; i++) {
+      for (unsigned int j = 0; j < width; j++) {
+        int U = (int)((iU[(i/2) * (width/2) + j/2] - 128) * 0.354);
+        int V = (int)((iV[(i/2) * (width/2) + j/2] - 128) * 0.707);
+        int Y = yuv[i * width + j];
+        int rgb[3] = { Y + 2 * V, Y - U - V, Y + 5 * U };
+        unsigned char *d = rgba + 4 * (i * width + j);
+        for (unsigned int l = 0; l < 3; l++)
+          d[l] = (unsigned char)(rgb[l] < 0 ? 0 : (rgb[l] > 255 ? 255 : rgb[l]));
+        d[3] = 0;
+      }
+    }
+  }
+
+  bool isEqual(const std::string &name, const std::vector<unsigned char> &v, const std::vector<unsigned char> &ref)
+  {
+    for (size_t i = 0; i < ref.size(); i++) {
+      if (v[i] != ref[i]) {
+        std::cerr << name << ": different values at " << i << ": " << (int)v[i] << " instead of " << (int)ref[i] << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+int main()
+{
+  // Odd number of blocks and tails that don't fill a SIMD register
+  const unsigned int width = 662, height = 482, size = width * height;
+  std::vector<unsigned char> src(size * 4);
+  srand(0);
+  for (size_t i = 0; i < src.size(); i++)
+    src[i] = (unsigned char)(rand() % 256);
+
+  std::vector<unsigned char> ref(size * 4), dst(size * 4);
+  for (unsigned int nbThreads = 1; nbThreads <= 4; nbThreads++) {
+    std::ostringstream threads;
+    threads << " (" << nbThreads << " thread(s))";
+
+    referenceYUYVToRGBa(&src[0], &ref[0], size / 2);
+    vpImageConvert::YUYVToRGBa(&src[0], &dst[0], width, height, nbThreads);
+    if (! isEqual("YUYVToRGBa" + threads.str(), dst, ref))
+      return EXIT_FAILURE;
+
+    referenceYUV420ToRGBa(&src[0], &ref[0], width, height);
+    vpImageConvert::YUV420ToRGBa(&src[0], &dst[0], width, height, nbThreads);
+    if (! isEqual("YUV420ToRGBa" + threads.str(), dst, ref))
+      return EXIT_FAILURE;
+
+    ref.assign(size * 4, 0);
+    dst.assign(size * 4, 0);
+    for (unsigned int i = 0; i < size; i++)
+      ref[i] = src[2*i+1];
+    vpImageConvert::YUV422ToGrey(&src[0], &dst[0], size, nbThreads);
+    if (! isEqual("YUV422ToGrey" + threads.str(), dst, ref))
+      return EXIT_FAILURE;
+
+    referenceGrey(&src[0], &ref[0], size, 4, false);
+    vpImageConvert::RGBaToGrey(&src[0], &dst[0], size, nbThreads);
+    if (! isEqual("RGBaToGrey" + threads.str(), dst, ref))
+      return EXIT_FAILURE;
+
+    for (unsigned int bgr = 0; bgr < 2; bgr++) {
+      std::string name = bgr ? "BGRToGrey" : "RGBToGrey";
+      referenceGrey(&src[0], &ref[0], size, 3, bgr != 0);
+      if (bgr)
+        vpImageConvert::BGRToGrey(&src[0], &dst[0], width, height, false, nbThreads);
+      else
+        vpImageConvert::RGBToGrey(&src[0], &dst[0], width, height, false, nbThreads);
+      if (! isEqual(name + threads.str(), dst, ref))
+        return EXIT_FAILURE;
+
+      // The flipped images are converted row by row
+      for (unsigned int i = 0; i < height; i++)
+        referenceGrey(&src[(height - 1 - i) * width * 3], &ref[i * width], width, 3, bgr != 0);
+      if (bgr)
+        vpImageConvert::BGRToGrey(&src[0], &dst[0], width, height, true, nbThreads);
+      else
+        vpImageConvert::RGBToGrey(&src[0], &dst[0], width, height, true, nbThreads);
+      if (! isEqual(name + " (flip)" + threads.str(), dst, ref))
+        return EXIT_FAILURE;
+    }
+  }
+  vpImageConvert::RGBToGrey(&src[0], &dst[0], size);
+  referenceGrey(&src[0], &ref[0], size, 3, false);
+  if (! isEqual("RGBToGrey", dst, ref))
+    return EXIT_FAILURE;
+
+  // Benchmark on a 1080p image
+  const unsigned int bigWidth = 1920, bigHeight = 1080;
+  std::vector<unsigned char> big(bigWidth * bigHeight * 4, 128), bigDst(bigWidth * bigHeight * 4);
+  unsigned int nbIterations = 20;
+  double t = vpTime::measureTimeMs();
+  for (unsigned int iter = 0; iter < nbIterations; iter++)
+    vpImageConvert::YUYVToRGBa(&big[0], &bigDst[0], bigWidth, bigHeight);
+  std::cout << "YUYVToRGBa: " << (vpTime::measureTimeMs() - t) / nbIterations << " ms" << std::endl;
+  t = vpTime::measureTimeMs();
+  for (unsigned int iter = 0; iter < nbIterations; iter++)
+    vpImageConvert::YUV420ToRGBa(&big[0], &bigDst[0], bigWidth, bigHeight);
+  std::cout << "YUV420ToRGBa: " << (vpTime::measureTimeMs() - t) / nbIterations << " ms" << std::endl;
+  t = vpTime::measureTimeMs();
+  for (unsigned int iter = 0; iter < nbIterations; iter++)
+    vpImageConvert::RGBaToGrey(&big[0], &bigDst[0], bigWidth * bigHeight);
+  std::cout << "RGBaToGrey: " << (vpTime::measureTimeMs() - t) / nbIterations << " ms" << std::endl;
+
+  std::cout << "All tests succeed" << std::endl;
+  return EXIT_SUCCESS;
+}
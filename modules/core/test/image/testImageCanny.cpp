@@ -0,0 +1,175 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the Canny edge detector of vpImageFilter.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImageCanny.cpp
+
+  \brief Test the Canny edge detector of vpImageFilter on a synthetic disk:
+  edges have to lie on the disk boundary and close it, and the result has to
+  be the same whatever the number of threads.
+*/
+
+#include <iostream>
+#include <cmath>
+#include <stdlib.h>
+
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpImageException.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+  bool isEqual(const std::string &name, const vpImage<unsigned char> &I1, const vpImage<unsigned char> &I2)
+  {
+    if (I1.getHeight() != I2.getHeight() || I1.getWidth() != I2.getWidth()) {
+      std::cerr << name << ": bad size" << std::endl;
+      return false;
+    }
+    for (unsigned int i = 0; i < I1.getSize(); i++) {
+      if (I1.bitmap[i] != I2.bitmap[i]) {
+        std::cerr << name << ": different edges at " << i / I1.getWidth() << " " << i % I1.getWidth() << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Check that the edges lie on the circle of center (ci, cj) and radius r, and close it
+  bool checkCircle(const std::string &name, const vpImage<unsigned char> &Ic, double ci, double cj, double r)
+  {
+    unsigned int nbEdges = 0;
+    for (unsigned int i = 0; i < Ic.getHeight(); i++) {
+      for (unsigned int j = 0; j < Ic.getWidth(); j++) {
+        if (Ic[i][j] == 0)
+          continue;
+        if (Ic[i][j] != 255) {
+          std::cerr << name << ": bad edge value " << (int)Ic[i][j] << std::endl;
+          return false;
+        }
+        double d = sqrt((i - ci) * (i - ci) + (j - cj) * (j - cj));
+        if (std::fabs(d - r) > 2.) {
+          std::cerr << name << ": edge at " << i << " " << j << " far from the boundary" << std::endl;
+          return false;
+        }
+        nbEdges++;
+      }
+    }
+    // A closed 8-connected contour has about 2*pi*r/sqrt(2) pixels at least
+    if (nbEdges < 4.4 * r || nbEdges > 8 * r) {
+      std::cerr << name << ": bad number of edges " << nbEdges << std::endl;
+      return false;
+    }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    // Disk on a flat background, with a size that is not a multiple of the SIMD width
+    const double ci = 121.3, cj = 158.7, r = 70.;
+    vpImage<unsigned char> I(243, 323);
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        I[i][j] = ((i - ci) * (i - ci) + (j - cj) * (j - cj) < r * r) ? 180 : 60;
+
+    vpImage<unsigned char> Ic, Ic_mt;
+    vpImageFilter::canny(I, Ic, 5, 100., 3);
+    if (! checkCircle("canny", Ic, ci, cj, r))
+      return EXIT_FAILURE;
+
+    for (unsigned int aperture = 3; aperture <= 7; aperture += 2) {
+      vpImageFilter::canny(I, Ic, 5, 100., 200., aperture);
+      if (! checkCircle("canny (hysteresis)", Ic, ci, cj, r))
+        return EXIT_FAILURE;
+      for (unsigned int nbThreads = 2; nbThreads <= 7; nbThreads += 5) {
+        vpImageFilter::canny(I, Ic_mt, 5, 100., 200., aperture, nbThreads);
+        if (! isEqual("canny (threads)", Ic_mt, Ic))
+          return EXIT_FAILURE;
+      }
+    }
+
+    // The output image is reused, and may be the input image
+    unsigned char *bitmap = Ic_mt.bitmap;
+    vpImageFilter::canny(I, Ic_mt, 5, 200., 100., 7, 3);
+    if (Ic_mt.bitmap != bitmap || ! isEqual("canny (swapped thresholds)", Ic_mt, Ic))
+      return EXIT_FAILURE;
+    vpImage<unsigned char> Iin = I;
+    vpImageFilter::canny(Iin, Iin, 5, 100., 200., 7, 3);
+    if (! isEqual("canny (in place)", Iin, Ic))
+      return EXIT_FAILURE;
+
+    // No edge above the gradient magnitude, nor in a flat image
+    vpImageFilter::canny(I, Ic, 5, 1e5, 3);
+    vpImage<unsigned char> Iflat(50, 37, 90), Inone(243, 323, 0);
+    if (! isEqual("canny (high threshold)", Ic, Inone))
+      return EXIT_FAILURE;
+    vpImageFilter::canny(Iflat, Ic, 3, 1., 2., 3, 4);
+    Inone.resize(50, 37, 0);
+    if (! isEqual("canny (flat image)", Ic, Inone))
+      return EXIT_FAILURE;
+
+    bool exception = false;
+    try {
+      vpImageFilter::canny(I, Ic, 5, 100., 4);
+    }
+    catch(vpImageException &) {
+      exception = true;
+    }
+    if (! exception) {
+      std::cerr << "No exception for a bad Sobel aperture" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Benchmark on a 1080p image
+    vpImage<unsigned char> Ibig(1080, 1920);
+    srand(0);
+    for (unsigned int i = 0; i < Ibig.getHeight(); i++)
+      for (unsigned int j = 0; j < Ibig.getWidth(); j++)
+        Ibig[i][j] = (unsigned char)(((i / 40 + j / 40) % 2) * 120 + 60 + rand() % 16);
+    unsigned int nbIterations = 10;
+    for (unsigned int nbThreads = 1; nbThreads <= 4; nbThreads *= 4) {
+      double t = vpTime::measureTimeMs();
+      for (unsigned int iter = 0; iter < nbIterations; iter++)
+        vpImageFilter::canny(Ibig, Ic, 5, 50., 100., 3, nbThreads);
+      std::cout << "Canny, " << nbThreads << " thread(s): " << (vpTime::measureTimeMs() - t) / nbIterations << " ms" << std::endl;
+    }
+
+    std::cout << "All tests succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
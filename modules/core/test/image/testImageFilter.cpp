@@ -0,0 +1,291 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the separable filters of vpImageFilter.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImageFilter.cpp
+
+  \brief Test the separable filters of vpImageFilter: the double versions
+  against the per pixel functions, the float and fixed-point versions against
+  the double ones, and the multithreaded versions against the single thread
+  ones.
+*/
+
+#include <iostream>
+#include <cmath>
+#include <stdlib.h>
+
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+  // Per pixel filtering along X, as done before the separable filters
+  void referenceFilterX(const vpImage<unsigned char> &I, vpImage<double> &dIx, const double *filter, unsigned int size)
+  {
+    unsigned int h = (size-1)/2;
+    dIx.resize(I.getHeight(), I.getWidth());
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < h; j++)
+        dIx[i][j] = vpImageFilter::filterXLeftBorder(I, i, j, filter, size);
+      for (unsigned int j = h; j < I.getWidth()-h; j++)
+        dIx[i][j] = vpImageFilter::filterX(I, i, j, filter, size);
+      for (unsigned int j = I.getWidth()-h; j < I.getWidth(); j++)
+        dIx[i][j] = vpImageFilter::filterXRightBorder(I, i, j, filter, size);
+    }
+  }
+
+  // Per pixel filtering along Y, as done before the separable filters
+  template<class Type>
+  void referenceFilterY(const vpImage<Type> &I, vpImage<double> &dIy, const double *filter, unsigned int size)
+  {
+    unsigned int h = (size-1)/2;
+    dIy.resize(I.getHeight(), I.getWidth());
+    for (unsigned int j = 0; j < I.getWidth(); j++) {
+      for (unsigned int i = 0; i < h; i++)
+        dIy[i][j] = vpImageFilter::filterYTopBorder(I, i, j, filter, size);
+      for (unsigned int i = h; i < I.getHeight()-h; i++)
+        dIy[i][j] = vpImageFilter::filterY(I, i, j, filter, size);
+      for (unsigned int i = I.getHeight()-h; i < I.getHeight(); i++)
+        dIy[i][j] = vpImageFilter::filterYBottomBorder(I, i, j, filter, size);
+    }
+  }
+
+  // Per pixel 7 taps gradients
+  void referenceGrad(const vpImage<unsigned char> &I, vpImage<double> &dIx, vpImage<double> &dIy)
+  {
+    dIx.resize(I.getHeight(), I.getWidth(), 0.);
+    dIy.resize(I.getHeight(), I.getWidth(), 0.);
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 3; j < I.getWidth()-3; j++)
+        dIx[i][j] = vpImageFilter::derivativeFilterX(I, i, j);
+    for (unsigned int i = 3; i < I.getHeight()-3; i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        dIy[i][j] = vpImageFilter::derivativeFilterY(I, i, j);
+  }
+
+  template<class Type>
+  bool isEqual(const std::string &name, const vpImage<Type> &A, const vpImage<Type> &B)
+  {
+    if (A.getHeight() != B.getHeight() || A.getWidth() != B.getWidth()) {
+      std::cerr << name << ": bad size" << std::endl;
+      return false;
+    }
+    for (unsigned int i = 0; i < A.getSize(); i++) {
+      if (A.bitmap[i] != B.bitmap[i]) {
+        std::cerr << name << ": " << A.bitmap[i] << " != " << B.bitmap[i] << " at pixel " << i << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  // Check that |A/scale - B| <= tolerance
+  template<class Type>
+  bool isNear(const std::string &name, const vpImage<Type> &A, const vpImage<double> &B, double scale, double tolerance)
+  {
+    if (A.getHeight() != B.getHeight() || A.getWidth() != B.getWidth()) {
+      std::cerr << name << ": bad size" << std::endl;
+      return false;
+    }
+    double maxError = 0;
+    for (unsigned int i = 0; i < A.getSize(); i++)
+      maxError = std::max(maxError, std::fabs(A.bitmap[i] / scale - B.bitmap[i]));
+    std::cout << name << ": max error " << maxError << std::endl;
+    if (maxError > tolerance) {
+      std::cerr << name << ": error larger than " << tolerance << std::endl;
+      return false;
+    }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    // Textured image whose size is not a multiple of the SIMD width
+    vpImage<unsigned char> I(243, 323);
+    srand(0);
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        I[i][j] = (unsigned char)((i*7 + j*3 + (i*j) % 17 + rand() % 64) % 256);
+
+    const unsigned int size = 7;
+    double fg[(size+1)/2], fgd[(size+1)/2];
+    float fgf[(size+1)/2], fgdf[(size+1)/2];
+    vpImageFilter::getGaussianKernel(fg, size);
+    vpImageFilter::getGaussianDerivativeKernel(fgd, size);
+    vpImageFilter::getGaussianKernel(fgf, size);
+    vpImageFilter::getGaussianDerivativeKernel(fgdf, size);
+
+    // Double versions against the per pixel functions
+    vpImage<double> Iref, Itmp, Iref2, I_d, I2_d;
+    referenceFilterX(I, Iref, fg, size);
+    vpImageFilter::filterX(I, I_d, fg, size);
+    if (! isEqual("filterX", I_d, Iref))
+      return EXIT_FAILURE;
+
+    referenceFilterY(I, Iref, fg, size);
+    vpImageFilter::filterY(I, I_d, fg, size);
+    if (! isEqual("filterY", I_d, Iref))
+      return EXIT_FAILURE;
+
+    referenceFilterX(I, Itmp, fg, size);
+    referenceFilterY(Itmp, Iref, fg, size);
+    vpImageFilter::gaussianBlur(I, I_d, size);
+    if (! isEqual("gaussianBlur", I_d, Iref))
+      return EXIT_FAILURE;
+    vpImage<double> Iblur = Iref;
+
+    referenceGrad(I, Iref, Iref2);
+    vpImageFilter::getGradX(I, I_d);
+    vpImageFilter::getGradY(I, I2_d);
+    if (! isEqual("getGradX", I_d, Iref) || ! isEqual("getGradY", I2_d, Iref2))
+      return EXIT_FAILURE;
+    vpImage<double> Igx = Iref, Igy = Iref2;
+
+    referenceFilterY(I, Itmp, fg, size);
+    Iref.resize(I.getHeight(), I.getWidth(), 0.);
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 3; j < I.getWidth()-3; j++)
+        Iref[i][j] = vpImageFilter::derivativeFilterX(Itmp, i, j, fgd, size);
+    vpImageFilter::getGradXGauss2D(I, I_d, fg, fgd, size);
+    if (! isEqual("getGradXGauss2D", I_d, Iref))
+      return EXIT_FAILURE;
+    vpImage<double> Igx2D = Iref;
+
+    referenceFilterX(I, Itmp, fg, size);
+    Iref.resize(I.getHeight(), I.getWidth(), 0.);
+    for (unsigned int i = 3; i < I.getHeight()-3; i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        Iref[i][j] = vpImageFilter::derivativeFilterY(Itmp, i, j, fgd, size);
+    vpImageFilter::getGradYGauss2D(I, I_d, fg, fgd, size);
+    if (! isEqual("getGradYGauss2D", I_d, Iref))
+      return EXIT_FAILURE;
+    vpImage<double> Igy2D = Iref;
+
+    // Multithreaded versions against the single thread ones
+    vpImageFilter::getGradYGauss2D(I, I2_d, fg, fgd, size, 4);
+    if (! isEqual("getGradYGauss2D (4 threads)", I2_d, I_d))
+      return EXIT_FAILURE;
+    vpImageFilter::gaussianBlur(I, I_d, size, 0., true, 3);
+    if (! isEqual("gaussianBlur (3 threads)", I_d, Iblur))
+      return EXIT_FAILURE;
+
+    // In place versions against the out of place ones
+    vpImage<double> Iin = Iblur;
+    vpImageFilter::filter(Iblur, I_d, fg, size);
+    vpImageFilter::filter(Iin, Iin, fg, size, 4);
+    if (! isEqual("filter (in place, 4 threads)", Iin, I_d))
+      return EXIT_FAILURE;
+    Iin = Iblur;
+    vpImageFilter::filterY(Iblur, I_d, fg, size);
+    vpImageFilter::filterY(Iin, Iin, fg, size);
+    if (! isEqual("filterY (in place)", Iin, I_d))
+      return EXIT_FAILURE;
+
+    // Float versions against the double ones
+    vpImage<float> I_f, I2_f;
+    vpImageFilter::gaussianBlur(I, I_f, size);
+    vpImageFilter::gaussianBlur(I, I2_f, size, 0., true, 4);
+    if (! isNear("gaussianBlur (float)", I_f, Iblur, 1., 1e-3) || ! isEqual("gaussianBlur (float, 4 threads)", I2_f, I_f))
+      return EXIT_FAILURE;
+    vpImageFilter::getGradX(I, I_f);
+    vpImageFilter::getGradY(I, I2_f, 4);
+    if (! isNear("getGradX (float)", I_f, Igx, 1., 1e-4) || ! isNear("getGradY (float)", I2_f, Igy, 1., 1e-4))
+      return EXIT_FAILURE;
+    vpImageFilter::getGradXGauss2D(I, I_f, fgf, fgdf, size, 2);
+    vpImageFilter::getGradYGauss2D(I, I2_f, fgf, fgdf, size, 5);
+    if (! isNear("getGradXGauss2D (float)", I_f, Igx2D, 1., 1e-4) || ! isNear("getGradYGauss2D (float)", I2_f, Igy2D, 1., 1e-4))
+      return EXIT_FAILURE;
+
+    // Fixed-point versions against the double ones
+    const double scale = (double)(1 << vpImageFilter::fixedPointBits);
+    const double tolerance = 0.5 / scale + 1e-3;
+    vpImage<short> I_s, I2_s;
+    vpImageFilter::gaussianBlur(I, I_s, size);
+    vpImageFilter::gaussianBlur(I, I2_s, size, 0., true, 4);
+    if (! isNear("gaussianBlur (int16)", I_s, Iblur, scale, tolerance) || ! isEqual("gaussianBlur (int16, 4 threads)", I2_s, I_s))
+      return EXIT_FAILURE;
+    vpImageFilter::getGradX(I, I_s);
+    vpImageFilter::getGradY(I, I2_s);
+    if (! isNear("getGradX (int16)", I_s, Igx, scale, tolerance) || ! isNear("getGradY (int16)", I2_s, Igy, scale, tolerance))
+      return EXIT_FAILURE;
+    vpImageFilter::getGradXGauss2D(I, I_s, fgf, fgdf, size, 3);
+    vpImageFilter::getGradYGauss2D(I, I2_s, fgf, fgdf, size, 3);
+    if (! isNear("getGradXGauss2D (int16)", I_s, Igx2D, scale, tolerance) || ! isNear("getGradYGauss2D (int16)", I2_s, Igy2D, scale, tolerance))
+      return EXIT_FAILURE;
+
+    // Images smaller than the filter
+    vpImage<unsigned char> Ismall(2, 3, 100);
+    vpImageFilter::gaussianBlur(Ismall, I_f, size, 0., true, 4);
+    vpImageFilter::getGradXGauss2D(Ismall, I_f, fgf, fgdf, size);
+    if (std::fabs(I_f[0][0]) > 1e-6) {
+      std::cerr << "Bad gradient of a small image" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Benchmark on a 1080p image
+    vpImage<unsigned char> Ibig(1080, 1920);
+    for (unsigned int i = 0; i < Ibig.getSize(); i++)
+      Ibig.bitmap[i] = (unsigned char)(rand() % 256);
+    unsigned int nbIterations = 10;
+    double t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIterations; iter++) {
+      vpImageFilter::gaussianBlur(Ibig, I_d, size);
+      vpImageFilter::getGradXGauss2D(Ibig, I_d, fg, fgd, size);
+      vpImageFilter::getGradYGauss2D(Ibig, I_d, fg, fgd, size);
+    }
+    std::cout << "Blur and gradients, double: " << (vpTime::measureTimeMs() - t) / nbIterations << " ms" << std::endl;
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIterations; iter++) {
+      vpImageFilter::gaussianBlur(Ibig, I_f, size);
+      vpImageFilter::getGradXGauss2D(Ibig, I_f, fgf, fgdf, size);
+      vpImageFilter::getGradYGauss2D(Ibig, I_f, fgf, fgdf, size);
+    }
+    std::cout << "Blur and gradients, float: " << (vpTime::measureTimeMs() - t) / nbIterations << " ms" << std::endl;
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIterations; iter++) {
+      vpImageFilter::gaussianBlur(Ibig, I_s, size, 0., true, 4);
+      vpImageFilter::getGradXGauss2D(Ibig, I_s, fgf, fgdf, size, 4);
+      vpImageFilter::getGradYGauss2D(Ibig, I_s, fgf, fgdf, size, 4);
+    }
+    std::cout << "Blur and gradients, int16, 4 threads: " << (vpTime::measureTimeMs() - t) / nbIterations << " ms" << std::endl;
+
+    std::cout << "All tests succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
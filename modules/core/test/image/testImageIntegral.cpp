@@ -0,0 +1,208 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the integral images and the template matching.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImageIntegral.cpp
+
+  \brief Test the window statistics given by vpImageIntegral against brute
+  force sums, its incremental update against a full computation, and the
+  ZNCC template matching of vpImageTools.
+*/
+
+#include <iostream>
+#include <cmath>
+#include <stdlib.h>
+
+#include <visp3/core/vpImageIntegral.h>
+#include <visp3/core/vpImageTools.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+  bool checkWindow(const vpImage<unsigned char> &I, const vpImageIntegral &integral,
+                   unsigned int top, unsigned int left, unsigned int height, unsigned int width)
+  {
+    unsigned int sum = 0;
+    uint64_t sqsum = 0;
+    for (unsigned int i = top; i < top + height; i++) {
+      for (unsigned int j = left; j < left + width; j++) {
+        sum += I[i][j];
+        sqsum += I[i][j] * I[i][j];
+      }
+    }
+    double n = (double)height * width;
+    double variance = (double)sqsum / n - (sum / n) * (sum / n);
+    if (integral.getSum(top, left, height, width) != sum || integral.getSquaredSum(top, left, height, width) != sqsum
+        || std::fabs(integral.getMean(top, left, height, width) - sum / n) > 1e-9
+        || std::fabs(integral.getVariance(top, left, height, width) - variance) > 1e-6) {
+      std::cerr << "Bad statistics of the window (" << top << ", " << left << ") " << height << "x" << width << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  bool isEqual(const std::string &name, const vpImageIntegral &integral, const vpImageIntegral &ref)
+  {
+    const vpImage<unsigned int> &S = integral.getSumImage(), &Sref = ref.getSumImage();
+    const vpImage<uint64_t> &S2 = integral.getSquaredSumImage(), &S2ref = ref.getSquaredSumImage();
+    for (unsigned int k = 0; k < Sref.getSize(); k++) {
+      if (S.bitmap[k] != Sref.bitmap[k] || S2.bitmap[k] != S2ref.bitmap[k]) {
+        std::cerr << name << ": different tables at " << k / Sref.getWidth() << " " << k % Sref.getWidth() << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  double zncc(const vpImage<unsigned char> &I, const vpImage<unsigned char> &T, unsigned int i0, unsigned int j0)
+  {
+    double n = T.getSize(), meanI = 0, meanT = 0;
+    for (unsigned int i = 0; i < T.getHeight(); i++) {
+      for (unsigned int j = 0; j < T.getWidth(); j++) {
+        meanI += I[i0+i][j0+j] / n;
+        meanT += T[i][j] / n;
+      }
+    }
+    double cross = 0, varI = 0, varT = 0;
+    for (unsigned int i = 0; i < T.getHeight(); i++) {
+      for (unsigned int j = 0; j < T.getWidth(); j++) {
+        cross += (I[i0+i][j0+j] - meanI) * (T[i][j] - meanT);
+        varI += (I[i0+i][j0+j] - meanI) * (I[i0+i][j0+j] - meanI);
+        varT += (T[i][j] - meanT) * (T[i][j] - meanT);
+      }
+    }
+    return cross / sqrt(varI * varT);
+  }
+}
+
+int main()
+{
+  try {
+    vpImage<unsigned char> I(123, 157);
+    srand(0);
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        I[i][j] = (unsigned char)((i * 5 + j * 3 + rand() % 96) % 256);
+
+    vpImageIntegral integral(I);
+    if (integral.getHeight() != I.getHeight() || integral.getWidth() != I.getWidth())
+      return EXIT_FAILURE;
+    if (! checkWindow(I, integral, 0, 0, I.getHeight(), I.getWidth()) || ! checkWindow(I, integral, 122, 156, 1, 1))
+      return EXIT_FAILURE;
+    for (unsigned int k = 0; k < 200; k++) {
+      unsigned int top = rand() % I.getHeight(), left = rand() % I.getWidth();
+      unsigned int height = 1 + rand() % (I.getHeight() - top), width = 1 + rand() % (I.getWidth() - left);
+      if (! checkWindow(I, integral, top, left, height, width))
+        return EXIT_FAILURE;
+    }
+
+    // Incremental updates against a full computation
+    for (unsigned int k = 0; k < 20; k++) {
+      unsigned int top = rand() % I.getHeight(), left = rand() % I.getWidth();
+      unsigned int height = 1 + rand() % (I.getHeight() - top), width = 1 + rand() % (I.getWidth() - left);
+      for (unsigned int i = top; i < top + height; i++)
+        for (unsigned int j = left; j < left + width; j++)
+          I[i][j] = (unsigned char)(rand() % 256);
+      if (k % 2)
+        integral.update(I, top, left, height, width);
+      else
+        integral.update(I, vpRect(left, top, width, height));
+      if (! isEqual("update", integral, vpImageIntegral(I)))
+        return EXIT_FAILURE;
+    }
+
+    bool exception = false;
+    try {
+      integral.update(I, 100, 100, 30, 10);
+    }
+    catch(vpImageException &) {
+      exception = true;
+    }
+    if (! exception) {
+      std::cerr << "No exception for a window out of the image" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Template matching
+    vpImage<unsigned char> Itpl;
+    vpImageTools::crop(I, 37, 51, 21, 34, Itpl);
+    vpImage<double> Iscore;
+    vpImageTools::templateMatching(I, Itpl, Iscore);
+    if (Iscore.getHeight() != I.getHeight() - 20 || Iscore.getWidth() != I.getWidth() - 33)
+      return EXIT_FAILURE;
+    unsigned int iMax = 0, jMax = 0;
+    for (unsigned int i = 0; i < Iscore.getHeight(); i++)
+      for (unsigned int j = 0; j < Iscore.getWidth(); j++)
+        if (Iscore[i][j] > Iscore[iMax][jMax]) {
+          iMax = i;
+          jMax = j;
+        }
+    if (iMax != 37 || jMax != 51 || std::fabs(Iscore[iMax][jMax] - 1.) > 1e-9) {
+      std::cerr << "Template found at " << iMax << " " << jMax << " with a score " << Iscore[iMax][jMax] << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (unsigned int k = 0; k < 50; k++) {
+      unsigned int i = rand() % Iscore.getHeight(), j = rand() % Iscore.getWidth();
+      if (std::fabs(Iscore[i][j] - zncc(I, Itpl, i, j)) > 1e-9) {
+        std::cerr << "Bad score at " << i << " " << j << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    vpImageTools::templateMatching(I, integral, Itpl, Iscore, 3, 2);
+    if (Iscore[37][51] != 0. || std::fabs(Iscore[36][48] - zncc(I, Itpl, 36, 48)) > 1e-9) {
+      std::cerr << "Bad scores with steps" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Benchmark on a 1080p image
+    vpImage<unsigned char> Ibig(1080, 1920);
+    for (unsigned int i = 0; i < Ibig.getSize(); i++)
+      Ibig.bitmap[i] = (unsigned char)(rand() % 256);
+    unsigned int nbIterations = 10;
+    double t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIterations; iter++)
+      integral.build(Ibig);
+    std::cout << "Integral and squared integral images: " << (vpTime::measureTimeMs() - t) / nbIterations << " ms" << std::endl;
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIterations; iter++)
+      integral.update(Ibig, 500, 900, 64, 64);
+    std::cout << "Update of a 64x64 window: " << (vpTime::measureTimeMs() - t) / nbIterations << " ms" << std::endl;
+
+    std::cout << "All tests succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
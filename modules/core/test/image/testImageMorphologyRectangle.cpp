@@ -0,0 +1,177 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the grey level morphology with rectangular structuring elements.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImageMorphologyRectangle.cpp
+
+  \brief Test the van Herk/Gil-Werman erosion and dilatation of
+  vpImageMorphology against a brute force computation, and the opening,
+  closing and top-hat operators built on them.
+*/
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <visp3/core/vpImageMorphology.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+  // Brute force minimum or maximum over the window of each pixel
+  void bruteForce(const vpImage<unsigned char> &I, vpImage<unsigned char> &O, unsigned int width,
+                  unsigned int height, bool dilate)
+  {
+    const int before_i = (int)(dilate ? height / 2 : (height - 1) / 2);
+    const int before_j = (int)(dilate ? width / 2 : (width - 1) / 2);
+    O.resize(I.getHeight(), I.getWidth());
+    for (int i = 0; i < (int)I.getHeight(); i++) {
+      for (int j = 0; j < (int)I.getWidth(); j++) {
+        unsigned char v = dilate ? 0 : 255;
+        for (int r = i - before_i; r < i - before_i + (int)height; r++) {
+          for (int c = j - before_j; c < j - before_j + (int)width; c++) {
+            if (r < 0 || c < 0 || r >= (int)I.getHeight() || c >= (int)I.getWidth())
+              continue;
+            v = dilate ? std::max(v, I[r][c]) : std::min(v, I[r][c]);
+          }
+        }
+        O[i][j] = v;
+      }
+    }
+  }
+
+  bool check(unsigned int rows, unsigned int cols, unsigned int width, unsigned int height)
+  {
+    vpImage<unsigned char> I(rows, cols);
+    for (unsigned int i = 0; i < I.getSize(); i++)
+      I.bitmap[i] = (unsigned char)(rand() % 256);
+
+    for (unsigned int dilate = 0; dilate < 2; dilate++) {
+      vpImage<unsigned char> Iref;
+      bruteForce(I, Iref, width, height, dilate != 0);
+      for (unsigned int nbThreads = 1; nbThreads <= 3; nbThreads += 2) {
+        vpImage<unsigned char> Ires = I;
+        if (dilate)
+          vpImageMorphology::dilatation(Ires, width, height, nbThreads);
+        else
+          vpImageMorphology::erosion(Ires, width, height, nbThreads);
+        if (Ires != Iref) {
+          std::cerr << (dilate ? "Dilatation" : "Erosion") << " of a " << rows << "x" << cols << " image by a "
+                    << height << "x" << width << " rectangle with " << nbThreads << " threads differs" << std::endl;
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    srand(0);
+    const unsigned int sizes[][2] = { {1, 1}, {3, 3}, {2, 4}, {1, 7}, {9, 1}, {5, 12}, {31, 17}, {80, 80} };
+    for (unsigned int k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+      if (! check(47, 61, sizes[k][0], sizes[k][1]) || ! check(5, 130, sizes[k][0], sizes[k][1]))
+        return EXIT_FAILURE;
+    }
+
+    // A 3x3 rectangle gives the same result than the 8-connexity
+    vpImage<unsigned char> I(120, 160);
+    for (unsigned int i = 0; i < I.getSize(); i++)
+      I.bitmap[i] = (unsigned char)(rand() % 256);
+    vpImage<unsigned char> I8 = I, Irect = I;
+    vpImageMorphology::erosion(I8, vpImageMorphology::CONNEXITY_8);
+    vpImageMorphology::erosion(Irect, 3, 3);
+    if (I8 != Irect) {
+      std::cerr << "3x3 erosion differs from the 8-connexity" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Opening and closing are idempotent, top-hats are their residues
+    vpImage<unsigned char> Iopen = I, Iclose = I, Itop = I, Iblack = I;
+    vpImageMorphology::opening(Iopen, 6, 4);
+    vpImageMorphology::closing(Iclose, 6, 4);
+    vpImageMorphology::topHat(Itop, 6, 4);
+    vpImageMorphology::blackTopHat(Iblack, 6, 4);
+    vpImage<unsigned char> Iopen2 = Iopen, Iclose2 = Iclose;
+    vpImageMorphology::opening(Iopen2, 6, 4);
+    vpImageMorphology::closing(Iclose2, 6, 4);
+    if (Iopen2 != Iopen || Iclose2 != Iclose) {
+      std::cerr << "Opening or closing is not idempotent" << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (unsigned int i = 0; i < I.getSize(); i++) {
+      if (Iopen.bitmap[i] > I.bitmap[i] || Iclose.bitmap[i] < I.bitmap[i]
+          || Itop.bitmap[i] != I.bitmap[i] - Iopen.bitmap[i] || Iblack.bitmap[i] != Iclose.bitmap[i] - I.bitmap[i]) {
+        std::cerr << "Bad opening, closing or top-hat at " << i << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    bool exception = false;
+    try {
+      vpImageMorphology::erosion(I, 0, 3);
+    }
+    catch(vpException &) {
+      exception = true;
+    }
+    if (! exception) {
+      std::cerr << "No exception for an empty structuring element" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Benchmark: 11x11 erosion against 5 passes of the 8-connexity erosion
+    vpImage<unsigned char> Ibig(1080, 1920);
+    for (unsigned int i = 0; i < Ibig.getSize(); i++)
+      Ibig.bitmap[i] = (unsigned char)(rand() % 256);
+    vpImage<unsigned char> Ipasses = Ibig, Ivhgw = Ibig;
+    double t = vpTime::measureTimeMs();
+    for (unsigned int k = 0; k < 5; k++)
+      vpImageMorphology::erosion(Ipasses, vpImageMorphology::CONNEXITY_8);
+    std::cout << "5 passes of 3x3 erosion: " << vpTime::measureTimeMs() - t << " ms" << std::endl;
+    t = vpTime::measureTimeMs();
+    vpImageMorphology::erosion(Ivhgw, 11, 11);
+    std::cout << "11x11 van Herk/Gil-Werman erosion: " << vpTime::measureTimeMs() - t << " ms" << std::endl;
+    if (Ipasses != Ivhgw) {
+      std::cerr << "11x11 erosion differs from 5 passes of 3x3 erosion" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    std::cout << "All tests succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
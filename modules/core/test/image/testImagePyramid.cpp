@@ -0,0 +1,190 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the image pyramid.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImagePyramid.cpp
+
+  \brief Test the levels of vpImagePyramid against the scalar Gaussian and
+  subsampling reductions, and check that the buffers of the levels are kept
+  across the frames.
+*/
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpImagePyramid.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+  // Reference Gaussian reduction computed with the scalar filters of vpImageFilter
+  void gaussReference(const vpImage<unsigned char> &I, vpImage<unsigned char> &GI)
+  {
+    unsigned int w = I.getWidth() / 2, h = I.getHeight() / 2;
+    vpImage<unsigned char> GIx(I.getHeight(), w);
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      GIx[i][0] = I[i][0];
+      for (unsigned int j = 1; j + 1 < w; j++)
+        GIx[i][j] = vpImageFilter::filterGaussXPyramidal(I, i, 2 * j);
+      GIx[i][w - 1] = I[i][2 * w - 1];
+    }
+    GI.resize(h, w);
+    for (unsigned int j = 0; j < w; j++) {
+      GI[0][j] = GIx[0][j];
+      for (unsigned int i = 1; i + 1 < h; i++)
+        GI[i][j] = vpImageFilter::filterGaussYPyramidal(GIx, 2 * i, j);
+      GI[h - 1][j] = GIx[2 * h - 1][j];
+    }
+  }
+
+  bool isEqual(const std::string &name, const vpImage<unsigned char> &I, const vpImage<unsigned char> &Iref)
+  {
+    if (I.getHeight() != Iref.getHeight() || I.getWidth() != Iref.getWidth()) {
+      std::cerr << name << ": bad size " << I.getHeight() << "x" << I.getWidth() << std::endl;
+      return false;
+    }
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        if (I[i][j] != Iref[i][j]) {
+          std::cerr << name << ": different pixels at " << i << " " << j << std::endl;
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  bool checkPyramids(unsigned int height, unsigned int width)
+  {
+    vpImage<unsigned char> I(height, width);
+    for (unsigned int i = 0; i < I.getSize(); i++)
+      I.bitmap[i] = (unsigned char)(rand() % 256);
+
+    vpImagePyramid gaussian, subsampling(vpImagePyramid::SUBSAMPLING);
+    gaussian.build(I, 4);
+    subsampling.build(I, 4);
+    if (gaussian.getNbLevels() != 4 || &gaussian[0] != &I || &subsampling[0] != &I)
+      return false;
+
+    vpImage<unsigned char> Iref = I, Itmp;
+    for (unsigned int l = 1; l < 4; l++) {
+      gaussReference(Iref, Itmp);
+      Iref = Itmp;
+      if (! isEqual("Gaussian level", gaussian[l], Iref))
+        return false;
+
+      vpImage<unsigned char> Isub(height >> l, width >> l);
+      for (unsigned int i = 0; i < Isub.getHeight(); i++)
+        for (unsigned int j = 0; j < Isub.getWidth(); j++)
+          Isub[i][j] = I[i << l][j << l];
+      if (! isEqual("Subsampled level", subsampling[l], Isub))
+        return false;
+    }
+
+    // Same results from getGaussPyramidal() when computed by ViSP
+#if !defined(VISP_HAVE_OPENCV) || (VISP_HAVE_OPENCV_VERSION < 0x020100)
+    vpImageFilter::getGaussPyramidal(I, Itmp);
+    if (! isEqual("getGaussPyramidal()", Itmp, gaussian[1]))
+      return false;
+#endif
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    srand(0);
+    if (! checkPyramids(240, 320) || ! checkPyramids(123, 157) || ! checkPyramids(37, 91) || ! checkPyramids(9, 11))
+      return EXIT_FAILURE;
+
+    // The buffers of the levels are kept from one frame to the next
+    vpImage<unsigned char> I1(120, 160, 10), I2(120, 160, 200);
+    vpImagePyramid pyramid;
+    pyramid.build(I1, 3);
+    const unsigned char *bitmap1 = pyramid[1].bitmap, *bitmap2 = pyramid[2].bitmap;
+    pyramid.build(I2, 3);
+    if (pyramid[1].bitmap != bitmap1 || pyramid[2].bitmap != bitmap2 || pyramid[2][5][7] != 200) {
+      std::cerr << "The buffers of the levels are not reused" << std::endl;
+      return EXIT_FAILURE;
+    }
+    pyramid.build(I1, 2);
+    if (pyramid.getNbLevels() != 2 || pyramid[1][0][0] != 10)
+      return EXIT_FAILURE;
+
+    // The image and the build of the levels can be identified
+    if (pyramid.getBaseImage() != &I1 || pyramid.getBuildCount() != 3) {
+      std::cerr << "Wrong base image or build count" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    bool exception = false;
+    try {
+      pyramid.getLevel(2);
+    }
+    catch(vpException &) {
+      exception = true;
+    }
+    if (! exception) {
+      std::cerr << "No exception for a level out of the pyramid" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Benchmark against getGaussPyramidal() on a 1080p image
+    vpImage<unsigned char> Ibig(1080, 1920);
+    for (unsigned int i = 0; i < Ibig.getSize(); i++)
+      Ibig.bitmap[i] = (unsigned char)(rand() % 256);
+    unsigned int nbIterations = 10;
+    double t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIterations; iter++) {
+      vpImage<unsigned char> *levels = new vpImage<unsigned char>[4];
+      levels[0] = Ibig;
+      for (unsigned int l = 1; l < 4; l++)
+        vpImageFilter::getGaussPyramidal(levels[l - 1], levels[l]);
+      delete[] levels;
+    }
+    std::cout << "Pyramid of 4 levels allocated at each frame: " << (vpTime::measureTimeMs() - t) / nbIterations << " ms" << std::endl;
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIterations; iter++)
+      pyramid.build(Ibig, 4);
+    std::cout << "vpImagePyramid of 4 levels: " << (vpTime::measureTimeMs() - t) / nbIterations << " ms" << std::endl;
+
+    std::cout << "All tests succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,252 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the image resize.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImageResize.cpp
+
+  \brief Test vpImageTools::resize() against a direct floating point
+  resampling, for all the interpolation methods and the unsigned char, float
+  and vpRGBa images.
+*/
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <visp3/core/vpImageTools.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+  // Source pixels and weights of the output pixel x, out of image pixels
+  // being clamped to the border
+  void referenceWeights(unsigned int x, unsigned int n, unsigned int dstN,
+                        vpImageTools::vpImageInterpolationType method,
+                        std::vector<int> &index, std::vector<double> &w)
+  {
+    const double s = (double)n / dstN;
+    const double c = (x + 0.5) * s - 0.5;
+    index.clear();
+    w.clear();
+    if (method == vpImageTools::INTERPOLATION_NEAREST) {
+      index.push_back((int)((x + 0.5) * s));
+      w.push_back(1.);
+    }
+    else if (method == vpImageTools::INTERPOLATION_LINEAR) {
+      index.push_back((int)floor(c));
+      index.push_back((int)floor(c) + 1);
+      w.push_back(1. - (c - floor(c)));
+      w.push_back(c - floor(c));
+    }
+    else if (method == vpImageTools::INTERPOLATION_CUBIC) {
+      for (int k = -1; k <= 2; k++) {
+        const double d = std::fabs(c - (floor(c) + k));
+        index.push_back((int)floor(c) + k);
+        w.push_back(d < 1. ? 1.5 * d * d * d - 2.5 * d * d + 1. : -0.5 * d * d * d + 2.5 * d * d - 4. * d + 2.);
+      }
+    }
+    else {
+      for (unsigned int i = 0; i < n; i++) {
+        const double overlap = std::min((x + 1) * s, i + 1.) - std::max(x * s, (double)i);
+        if (overlap > 1e-9) {
+          index.push_back((int)i);
+          w.push_back(overlap / s);
+        }
+      }
+    }
+    for (size_t k = 0; k < index.size(); k++)
+      index[k] = std::min(std::max(index[k], 0), (int)n - 1);
+  }
+
+  void referenceResize(const vpImage<float> &I, vpImage<double> &Ires, unsigned int height, unsigned int width,
+                       vpImageTools::vpImageInterpolationType method)
+  {
+    Ires.resize(height, width);
+    std::vector<int> ii, jj;
+    std::vector<double> wi, wj;
+    for (unsigned int i = 0; i < height; i++) {
+      referenceWeights(i, I.getHeight(), height, method, ii, wi);
+      for (unsigned int j = 0; j < width; j++) {
+        referenceWeights(j, I.getWidth(), width, method, jj, wj);
+        double sum = 0.;
+        for (size_t k = 0; k < ii.size(); k++)
+          for (size_t l = 0; l < jj.size(); l++)
+            sum += wi[k] * wj[l] * I[ii[k]][jj[l]];
+        Ires[i][j] = sum;
+      }
+    }
+  }
+}
+
+int main()
+{
+  try {
+    srand(0);
+    vpImage<unsigned char> I(57, 83);
+    vpImage<float> If(I.getHeight(), I.getWidth());
+    vpImage<vpRGBa> Ic(I.getHeight(), I.getWidth());
+    for (unsigned int i = 0; i < I.getSize(); i++) {
+      I.bitmap[i] = (unsigned char)(rand() % 256);
+      If.bitmap[i] = I.bitmap[i];
+      Ic.bitmap[i] = vpRGBa(I.bitmap[i], (unsigned char)(255 - I.bitmap[i]), (unsigned char)(rand() % 256),
+                            (unsigned char)(rand() % 256));
+    }
+
+    const char *names[] = { "nearest", "linear", "cubic", "area" };
+    const unsigned int sizes[][2] = { { 57, 83 }, { 28, 41 }, { 19, 27 }, { 40, 60 }, { 100, 150 }, { 1, 7 }, { 13, 1 } };
+    for (unsigned int m = 0; m < 4; m++) {
+      vpImageTools::vpImageInterpolationType method = (vpImageTools::vpImageInterpolationType)m;
+      for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        const unsigned int h = sizes[s][0], w = sizes[s][1];
+        vpImage<double> Iref;
+        referenceResize(If, Iref, h, w, method);
+
+        vpImage<unsigned char> Ires, Ires_mt;
+        vpImage<float> Ifres;
+        vpImageTools::resize(I, Ires, h, w, method);
+        vpImageTools::resize(I, Ires_mt, h, w, method, 3);
+        vpImageTools::resize(If, Ifres, h, w, method);
+        if (Ires.getHeight() != h || Ires.getWidth() != w || Ires != Ires_mt) {
+          std::cerr << names[m] << " " << h << "x" << w << ": wrong size or different result with 3 threads" << std::endl;
+          return EXIT_FAILURE;
+        }
+        for (unsigned int i = 0; i < Iref.getSize(); i++) {
+          const double ref = Iref.bitmap[i];
+          if (std::fabs(Ifres.bitmap[i] - ref) > 1e-3 ||
+              std::fabs(Ires.bitmap[i] - std::min(std::max(ref, 0.), 255.)) > 0.501) {
+            std::cerr << names[m] << " " << h << "x" << w << ": pixel " << i << " is " << (int)Ires.bitmap[i]
+                      << " and " << Ifres.bitmap[i] << " instead of " << ref << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+
+        // The channels of a color image are resized as gray level images
+        vpImage<vpRGBa> Icres;
+        vpImage<unsigned char> Ichannel(I.getHeight(), I.getWidth()), Ichannel_res;
+        vpImageTools::resize(Ic, Icres, h, w, method, 2);
+        for (unsigned int c = 0; c < 4; c++) {
+          for (unsigned int i = 0; i < I.getSize(); i++)
+            Ichannel.bitmap[i] = ((unsigned char *)&Ic.bitmap[i])[c];
+          vpImageTools::resize(Ichannel, Ichannel_res, h, w, method);
+          for (unsigned int i = 0; i < Icres.getSize(); i++) {
+            if (((unsigned char *)&Icres.bitmap[i])[c] != Ichannel_res.bitmap[i]) {
+              std::cerr << names[m] << " " << h << "x" << w << ": channel " << c
+                        << " of the color image differs at " << i << std::endl;
+              return EXIT_FAILURE;
+            }
+          }
+        }
+      }
+    }
+
+    // Keeping the size is a copy, for all the methods
+    for (unsigned int m = 0; m < 4; m++) {
+      vpImage<unsigned char> Ires;
+      vpImageTools::resize(I, Ires, I.getHeight(), I.getWidth(), (vpImageTools::vpImageInterpolationType)m);
+      if (Ires != I) {
+        std::cerr << names[m] << ": the resize to the same size is not a copy" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Halving with INTERPOLATION_AREA is the rounded mean of 2x2 blocks, here in a region of interest
+    vpImageView<unsigned char> roi(I, 5, 7, 40, 60);
+    vpImage<unsigned char> Ihalf;
+    vpImageTools::resize(roi, Ihalf, 20, 30, vpImageTools::INTERPOLATION_AREA);
+    for (unsigned int i = 0; i < 20; i++) {
+      for (unsigned int j = 0; j < 30; j++) {
+        const int sum = roi[2*i][2*j] + roi[2*i][2*j + 1] + roi[2*i + 1][2*j] + roi[2*i + 1][2*j + 1];
+        if (Ihalf[i][j] != (sum + 2) / 4) {
+          std::cerr << "Wrong 2x2 mean at " << i << " " << j << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // Resizing a region of interest of the resized image itself
+    for (unsigned int m = 0; m < 4; m++) {
+      vpImage<unsigned char> Ires = I, Iroi, Iref;
+      vpImageView<unsigned char> inner(Ires, 5, 7, 40, 60);
+      inner.copyTo(Iroi);
+      vpImageTools::resize(Iroi, Iref, 70, 90, (vpImageTools::vpImageInterpolationType)m);
+      vpImageTools::resize(inner, Ires, 70, 90, (vpImageTools::vpImageInterpolationType)m, 2);
+      if (Ires != Iref) {
+        std::cerr << names[m] << ": wrong resize of a region of interest of the resized image" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    bool exception = false;
+    try {
+      vpImage<unsigned char> Iempty, Ires;
+      vpImageTools::resize(Iempty, Ires, 10, 10);
+    }
+    catch(vpException &) {
+      exception = true;
+    }
+    if (! exception) {
+      std::cerr << "No exception when resizing an empty image" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Benchmark: 4K to full HD
+    vpImage<unsigned char> Ibig(2160, 3840), Ires;
+    vpImage<vpRGBa> Icbig(2160, 3840), Icres;
+    for (unsigned int i = 0; i < Ibig.getSize(); i++) {
+      Ibig.bitmap[i] = (unsigned char)(rand() % 256);
+      Icbig.bitmap[i] = vpRGBa(Ibig.bitmap[i]);
+    }
+    const unsigned int nbIterations = 10;
+    double t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIterations; iter++)
+      Ibig.halfSizeImage(Ires);
+    std::cout << "vpImage::halfSizeImage(): " << (vpTime::measureTimeMs() - t) / nbIterations << " ms" << std::endl;
+    for (unsigned int m = 0; m < 4; m++) {
+      t = vpTime::measureTimeMs();
+      for (unsigned int iter = 0; iter < nbIterations; iter++)
+        vpImageTools::resize(Ibig, Ires, 1080, 1920, (vpImageTools::vpImageInterpolationType)m);
+      std::cout << "vpImageTools::resize(), " << names[m] << ": " << (vpTime::measureTimeMs() - t) / nbIterations
+                << " ms, color: ";
+      t = vpTime::measureTimeMs();
+      for (unsigned int iter = 0; iter < nbIterations; iter++)
+        vpImageTools::resize(Icbig, Icres, 1080, 1920, (vpImageTools::vpImageInterpolationType)m);
+      std::cout << (vpTime::measureTimeMs() - t) / nbIterations << " ms" << std::endl;
+    }
+
+    std::cout << "All tests succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,232 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the image views and the aligned storage of vpImage.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testImageView.cpp
+
+  \brief Test that the bitmap of vpImage is aligned, that the regions of
+  interest processed through a vpImageView give the same results as the
+  cropped images, and that external strided buffers are processed in place.
+*/
+
+#include <iostream>
+#include <stdlib.h>
+#include <string.h>
+
+#include <visp3/core/vpImageConvert.h>
+#include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpImageIntegral.h>
+#include <visp3/core/vpImageTools.h>
+#include <visp3/core/vpImageView.h>
+
+namespace {
+  template <class Type>
+  bool isEqual(const std::string &name, const vpImage<Type> &I, const vpImage<Type> &Iref)
+  {
+    if (I.getHeight() != Iref.getHeight() || I.getWidth() != Iref.getWidth()) {
+      std::cerr << name << ": bad size " << I.getHeight() << "x" << I.getWidth() << std::endl;
+      return false;
+    }
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        if (memcmp(&I[i][j], &Iref[i][j], sizeof(Type)) != 0) {
+          std::cerr << name << ": different pixels at " << i << " " << j << std::endl;
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+
+  bool isAligned(const void *ptr)
+  {
+    return ((size_t)ptr % vpImage<unsigned char>::alignment) == 0;
+  }
+}
+
+int main()
+{
+  try {
+    srand(0);
+
+    // Aligned storage
+    for (unsigned int size = 1; size < 100; size += 7) {
+      vpImage<unsigned char> I(size, size + 3);
+      vpImage<vpRGBa> Irgba(size + 1, size);
+      vpImage<double> Id(size, size);
+      if (! isAligned(I.bitmap) || ! isAligned(Irgba.bitmap) || ! isAligned(Id.bitmap)) {
+        std::cerr << "The bitmap is not aligned" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // A copy into an image of the same size keeps its bitmap
+    vpImage<unsigned char> I(123, 157);
+    for (unsigned int i = 0; i < I.getSize(); i++)
+      I.bitmap[i] = (unsigned char)(rand() % 256);
+    vpImage<unsigned char> Icopy(123, 157);
+    const unsigned char *bitmap = Icopy.bitmap;
+    Icopy = I;
+    Icopy = Icopy;
+    if (Icopy.bitmap != bitmap || ! isEqual("Copy", Icopy, I))
+      return EXIT_FAILURE;
+
+    // An image still takes the ownership of an array allocated with new[]
+    unsigned char *array = new unsigned char[6 * 4];
+    memset(array, 7, 6 * 4);
+    {
+      vpImage<unsigned char> Iarray(array, 6, 4, false);
+      if (Iarray.bitmap != array || Iarray[5][3] != 7)
+        return EXIT_FAILURE;
+    }
+
+    // Views on a region of interest
+    vpImageView<unsigned char> view(I, 20, 30, 64, 75);
+    vpImage<unsigned char> Icrop(64, 75);
+    for (unsigned int i = 0; i < 64; i++)
+      for (unsigned int j = 0; j < 75; j++)
+        Icrop[i][j] = I[20 + i][30 + j];
+    vpImage<unsigned char> Iview;
+    view.copyTo(Iview);
+    if (view.isContiguous() || view[0] != I[20] + 30 || ! isEqual("View", Iview, Icrop))
+      return EXIT_FAILURE;
+    view.getSubView(10, 5, 20, 30).copyTo(Iview);
+    if (Iview[0][0] != I[30][35] || Iview[19][29] != I[49][64])
+      return EXIT_FAILURE;
+    vpImageView<unsigned char>(I, vpRect(30, 20, 75, 64)).copyTo(Iview);
+    if (! isEqual("View from a rectangle", Iview, Icrop))
+      return EXIT_FAILURE;
+
+    bool exception = false;
+    try {
+      vpImageView<unsigned char> outside(I, 100, 100, 24, 58);
+    }
+    catch(vpException &) {
+      exception = true;
+    }
+    if (! exception) {
+      std::cerr << "No exception for a view out of the image" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // External buffer which rows are padded
+    const unsigned int stride = 160;
+    unsigned char *buffer = new unsigned char[123 * stride];
+    for (unsigned int i = 0; i < 123; i++)
+      memcpy(buffer + i * stride, I[i], 157);
+    vpImageView<unsigned char> frame(buffer, 123, 157, stride);
+    frame.copyTo(Iview);
+    bool success = isEqual("External buffer", Iview, I);
+
+    // Filters
+    vpImage<double> Iblur, Iblur_ref;
+    vpImage<float> Iblurf, Iblurf_ref;
+    vpImage<short> Iblurs, Iblurs_ref;
+    vpImageFilter::gaussianBlur(view, Iblur);
+    vpImageFilter::gaussianBlur(Icrop, Iblur_ref);
+    vpImageFilter::gaussianBlur(view, Iblurf);
+    vpImageFilter::gaussianBlur(Icrop, Iblurf_ref);
+    vpImageFilter::gaussianBlur(frame, Iblurs, 5);
+    vpImageFilter::gaussianBlur(I, Iblurs_ref, 5);
+    success = success && isEqual("gaussianBlur() double", Iblur, Iblur_ref);
+    success = success && isEqual("gaussianBlur() float", Iblurf, Iblurf_ref);
+    success = success && isEqual("gaussianBlur() short", Iblurs, Iblurs_ref);
+
+    vpImage<unsigned char> Ic, Ic_ref;
+    vpImageFilter::canny(view, Ic, 5, 20, 60, 3);
+    vpImageFilter::canny(Icrop, Ic_ref, 5, 20, 60, 3);
+    success = success && isEqual("canny()", Ic, Ic_ref);
+
+    // Conversions
+    vpImage<vpRGBa> Irgba, Irgba_ref;
+    vpImageConvert::convert(view, Irgba);
+    vpImageConvert::convert(Icrop, Irgba_ref);
+    success = success && isEqual("Grey view to RGBa", Irgba, Irgba_ref);
+    vpImage<vpRGBa> Icolor(123, 157);
+    for (unsigned int i = 0; i < Icolor.getSize(); i++)
+      Icolor.bitmap[i] = vpRGBa((unsigned char)(rand() % 256), (unsigned char)(rand() % 256),
+                                (unsigned char)(rand() % 256));
+    vpImage<vpRGBa> Icolor_crop(64, 75);
+    for (unsigned int i = 0; i < 64; i++)
+      for (unsigned int j = 0; j < 75; j++)
+        Icolor_crop[i][j] = Icolor[20 + i][30 + j];
+    vpImage<unsigned char> Igrey, Igrey_ref;
+    vpImageConvert::convert(vpImageView<vpRGBa>(Icolor, 20, 30, 64, 75), Igrey, 2);
+    vpImageConvert::convert(Icolor_crop, Igrey_ref);
+    success = success && Igrey.getHeight() == 64 && Igrey.getWidth() == 75;
+    // The SIMD and scalar paths of RGBaToGrey() may differ by one grey level
+    for (unsigned int i = 0; i < Igrey.getSize(); i++) {
+      if (Igrey.bitmap[i] > Igrey_ref.bitmap[i] + 1 || Igrey_ref.bitmap[i] > Igrey.bitmap[i] + 1) {
+        std::cerr << "RGBa view to grey: different pixels at " << i << std::endl;
+        success = false;
+        break;
+      }
+    }
+
+    // Integral image and template matching
+    vpImageIntegral integral(view), integral_ref(Icrop);
+    for (unsigned int i = 0; i < 64; i += 9) {
+      for (unsigned int j = 0; j < 75; j += 11) {
+        if (integral.getSum(0, 0, i + 1, j + 1) != integral_ref.getSum(0, 0, i + 1, j + 1)
+            || integral.getSquaredSum(i, j, 64 - i, 75 - j) != integral_ref.getSquaredSum(i, j, 64 - i, 75 - j)) {
+          std::cerr << "Integral image of a view: different sums at " << i << " " << j << std::endl;
+          success = false;
+        }
+      }
+    }
+    vpImage<unsigned char> Itpl(12, 17);
+    for (unsigned int i = 0; i < 12; i++)
+      for (unsigned int j = 0; j < 17; j++)
+        Itpl[i][j] = Icrop[25 + i][40 + j];
+    vpImage<double> Iscore, Iscore_ref;
+    vpImageTools::templateMatching(view, Itpl, Iscore);
+    vpImageTools::templateMatching(Icrop, Itpl, Iscore_ref);
+    success = success && isEqual("templateMatching()", Iscore, Iscore_ref);
+    if (Iscore[25][40] < 0.999) {
+      std::cerr << "The template is not found in the view" << std::endl;
+      success = false;
+    }
+
+    delete[] buffer;
+    if (! success)
+      return EXIT_FAILURE;
+
+    std::cout << "All tests succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
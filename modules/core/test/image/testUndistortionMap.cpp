@@ -0,0 +1,233 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the precomputed undistortion map.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testUndistortionMap.cpp
+
+  \brief Test vpUndistortionMap against a floating point bilinear
+  interpolation and against vpImageTools::undistort(), with and without a
+  homography, on gray level and color images.
+*/
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <visp3/core/vpImageTools.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/core/vpUndistortionMap.h>
+
+namespace {
+  // Floating point reference of the remap
+  double referencePixel(const vpImage<unsigned char> &I, const vpCameraParameters &cam, const vpMatrix &H,
+                        unsigned int u, unsigned int v, bool &valid)
+  {
+    double x = H[0][0] * u + H[0][1] * v + H[0][2];
+    double y = H[1][0] * u + H[1][1] * v + H[1][2];
+    double z = H[2][0] * u + H[2][1] * v + H[2][2];
+    double du = x / z - cam.get_u0(), dv = y / z - cam.get_v0();
+    double r2 = vpMath::sqr(du / cam.get_px()) + vpMath::sqr(dv / cam.get_py());
+    double ud = du * (1 + cam.get_kud() * r2) + cam.get_u0();
+    double vd = dv * (1 + cam.get_kud() * r2) + cam.get_v0();
+    int col = (int)floor(ud), row = (int)floor(vd);
+    valid = col >= 0 && row >= 0 && col < (int)I.getWidth() - 1 && row < (int)I.getHeight() - 1;
+    if (! valid)
+      return 0.;
+    double fx = ud - col, fy = vd - row;
+    return (1 - fy) * ((1 - fx) * I[row][col] + fx * I[row][col + 1])
+        + fy * ((1 - fx) * I[row + 1][col] + fx * I[row + 1][col + 1]);
+  }
+
+  bool checkMap(const vpImage<unsigned char> &I, const vpCameraParameters &cam, const vpMatrix &H,
+                const vpUndistortionMap &map)
+  {
+    vpImage<unsigned char> Iout, Iout_mt;
+    map.remap(I, Iout);
+    map.remap(I, Iout_mt, 3);
+    if (Iout != Iout_mt) {
+      std::cerr << "The remap differs with 3 threads" << std::endl;
+      return false;
+    }
+
+    // The fixed-point position is rounded on 1/128 pixel, so that the pixels
+    // very close to the last row or column may change of validity
+    unsigned int nbBorderChanges = 0;
+    for (unsigned int v = 0; v < Iout.getHeight(); v++) {
+      for (unsigned int u = 0; u < Iout.getWidth(); u++) {
+        bool valid;
+        double ref = referencePixel(I, cam, H, u, v, valid);
+        if (! valid && Iout[v][u] != 0) {
+          nbBorderChanges++;
+          continue;
+        }
+        if (std::fabs(ref - Iout[v][u]) > 1.5) {
+          if (Iout[v][u] == 0) {
+            nbBorderChanges++;
+            continue;
+          }
+          std::cerr << "Pixel " << v << " " << u << " is " << (int)Iout[v][u] << " instead of " << ref << std::endl;
+          return false;
+        }
+      }
+    }
+    if (nbBorderChanges > Iout.getHeight() + Iout.getWidth()) {
+      std::cerr << nbBorderChanges << " pixels differ on the border" << std::endl;
+      return false;
+    }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    srand(0);
+    vpImage<unsigned char> I(240, 320);
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        I[i][j] = (unsigned char)(i / 2 + j / 3 + rand() % 16);
+    vpCameraParameters cam(300, 310, 161.3, 118.7, -0.25, 0.27);
+
+    vpMatrix H(3, 3);
+    H.eye();
+    vpUndistortionMap map(cam, I.getHeight(), I.getWidth());
+    if (map.getHeight() != 240 || map.getWidth() != 320 || ! checkMap(I, cam, H, map))
+      return EXIT_FAILURE;
+
+    // Same map than vpImageTools::undistort() up to the truncations of the latter
+    vpImage<unsigned char> Iu, Iref;
+    map.remap(I, Iu);
+    vpImageTools::undistort(I, cam, Iref);
+    unsigned int nbDifferent = 0;
+    for (unsigned int i = 0; i < Iu.getSize(); i++)
+      if (std::abs((int)Iu.bitmap[i] - (int)Iref.bitmap[i]) > 2)
+        nbDifferent++;
+    if (nbDifferent > I.getHeight() + I.getWidth()) {
+      std::cerr << nbDifferent << " pixels differ from vpImageTools::undistort()" << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (unsigned int nbThreads = 1; nbThreads <= 4; nbThreads += 3) {
+      vpImage<unsigned char> Ithreads;
+      vpImageTools::undistort(I, cam, Ithreads, nbThreads);
+      if (! (Ithreads == Iref)) {
+        std::cerr << "vpImageTools::undistort() depends on the number of threads" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // A single row source has no pixel to interpolate
+    vpImage<unsigned char> Irow(1, 64, 255);
+    vpUndistortionMap rowMap(cam, 1, 64);
+    rowMap.remap(Irow, Iu);
+    for (unsigned int i = 0; i < Iu.getSize(); i++) {
+      if (Iu.bitmap[i] != 0) {
+        std::cerr << "Interpolated pixel in a single row image" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Undistortion and resize
+    vpUndistortionMap half;
+    half.build(cam, I.getHeight(), I.getWidth(), 120, 160);
+    H[0][0] = H[1][1] = 2.;
+    H[0][2] = H[1][2] = 0.5;
+    if (half.getHeight() != 120 || half.getWidth() != 160 || ! checkMap(I, cam, H, half))
+      return EXIT_FAILURE;
+
+    // Rectifying homography
+    H[0][0] = 0.98; H[0][1] = 0.05; H[0][2] = 4.;
+    H[1][0] = -0.03; H[1][1] = 1.02; H[1][2] = -2.;
+    H[2][0] = 1e-5; H[2][1] = -2e-5; H[2][2] = 1.;
+    vpUndistortionMap rectify;
+    rectify.build(cam, I.getHeight(), I.getWidth(), H, 200, 300);
+    if (! checkMap(I, cam, H, rectify))
+      return EXIT_FAILURE;
+
+    // The channels of a color image are remapped as gray level images
+    vpImage<vpRGBa> Ic(I.getHeight(), I.getWidth()), Icu;
+    vpImage<unsigned char> Ichannel(I.getHeight(), I.getWidth()), Ichannel_u;
+    for (unsigned int i = 0; i < I.getSize(); i++)
+      Ic.bitmap[i] = vpRGBa(I.bitmap[i], (unsigned char)(255 - I.bitmap[i]), (unsigned char)(rand() % 256), 0);
+    rectify.remap(Ic, Icu, 2);
+    for (unsigned int k = 0; k < 3; k++) {
+      for (unsigned int i = 0; i < I.getSize(); i++)
+        Ichannel.bitmap[i] = ((unsigned char *)&Ic.bitmap[i])[k];
+      rectify.remap(Ichannel, Ichannel_u);
+      for (unsigned int i = 0; i < Icu.getSize(); i++) {
+        if (((unsigned char *)&Icu.bitmap[i])[k] != Ichannel_u.bitmap[i]) {
+          std::cerr << "Channel " << k << " of the color remap differs at " << i << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    bool exception = false;
+    try {
+      vpImage<unsigned char> Ismall(10, 10);
+      map.remap(Ismall, Iu);
+    }
+    catch(vpException &) {
+      exception = true;
+    }
+    if (! exception) {
+      std::cerr << "No exception for an image of a wrong size" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Benchmark on a full HD image
+    vpImage<unsigned char> Ibig(1080, 1920);
+    for (unsigned int i = 0; i < Ibig.getSize(); i++)
+      Ibig.bitmap[i] = (unsigned char)(rand() % 256);
+    vpCameraParameters camBig(1400, 1400, 960, 540, -0.2, 0.21);
+    unsigned int nbIterations = 10;
+    double t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIterations; iter++)
+      vpImageTools::undistort(Ibig, camBig, Iu);
+    std::cout << "vpImageTools::undistort(): " << (vpTime::measureTimeMs() - t) / nbIterations << " ms" << std::endl;
+    t = vpTime::measureTimeMs();
+    vpUndistortionMap mapBig(camBig, Ibig.getHeight(), Ibig.getWidth());
+    std::cout << "vpUndistortionMap::build(): " << vpTime::measureTimeMs() - t << " ms" << std::endl;
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIterations; iter++)
+      mapBig.remap(Ibig, Iu);
+    std::cout << "vpUndistortionMap::remap(): " << (vpTime::measureTimeMs() - t) / nbIterations << " ms" << std::endl;
+
+    std::cout << "All tests succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
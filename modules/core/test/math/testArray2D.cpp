@@ -46,6 +46,7 @@
 #include <limits>
 
 #include <visp3/core/vpTranslationVector.h>
+#include <visp3/core/vpFixedArray2D.h>
 
 template<typename Type>
 bool test(const std::string &s, const vpArray2D<Type> &A, const std::vector<Type> &bench)
@@ -158,6 +159,49 @@ int main()
     if (test("A", A, bench3) == false)
       return err;
   }
+
+  // Test with inline storage
+  {
+    vpFixedArray2D<double, 2, 3> A;
+    std::vector<double> bench1(6, 0);
+    if (test("A", A, bench1) == false)
+      return err;
+
+    std::vector<double> bench2(6);
+    for(unsigned int i=0; i<6; i++) {
+      A.data[i] = (double)i;
+      bench2[i] = (double)i;
+    }
+    vpFixedArray2D<double, 2, 3> B(A);
+    if (test("B", B, bench2) == false)
+      return err;
+
+    vpArray2D<double> C;
+    C = B;
+    if (test("C", C, bench2) == false)
+      return err;
+
+    // Resizing falls back to a heap allocated storage
+    B.resize(4, 5);
+    std::vector<double> bench3(20, 0);
+    if (test("B", B, bench3) == false)
+      return err;
+    if (B.data == A.data) {
+      std::cout << "Test fails: storage shared after resize" << std::endl;
+      return err;
+    }
+  }
+  {
+    // Product of fixed size arrays
+    double a[6] = { 1., 2., 3., 4., 5., 6. };
+    double b[6] = { 1., -1., 2., 0., -2., 1. };
+    vpFixedArray2D<double, 2, 2> P;
+    vpFixedArray2D<double, 2, 2>::mult<3>(a, b, P.data);
+    std::vector<double> bench(4);
+    bench[0] = -1.; bench[1] = 2.; bench[2] = 2.; bench[3] = 2.;
+    if (test("P", P, bench) == false)
+      return err;
+  }
   std::cout << "All tests succeed" << std::endl;
   return 0;
 }
@@ -0,0 +1,149 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the storage of matrices and vectors in a vpArrayWorkspace.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testArrayWorkspace.cpp
+
+  Test the storage of matrices and vectors in a vpArrayWorkspace.
+*/
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpArrayWorkspace.h>
+
+namespace {
+// Emulate an iterative solver which number of measures changes at each iteration
+bool frame(vpArrayWorkspace &workspace, vpMatrix &L, vpColVector &e, unsigned int n)
+{
+  workspace.reset();
+  if (L.size() != 0 || e.size() != 0) {
+    std::cout << "Bound arrays should be empty after a reset" << std::endl;
+    return false;
+  }
+  for (unsigned int iter = 0; iter < 10; iter++) {
+    unsigned int rows = n + 7 * iter;
+    L.resize(rows, 6);
+    e.resize(rows);
+    for (unsigned int i = 0; i < rows; i++) {
+      e[i] = i;
+      for (unsigned int j = 0; j < 6; j++)
+        L[i][j] = i + j;
+    }
+    // Keep the content of the common part
+    L.resize(rows + 1, 6, false);
+    for (unsigned int i = 0; i < rows; i++)
+      for (unsigned int j = 0; j < 6; j++)
+        if (L[i][j] != i + j) {
+          std::cout << "Bad content after a resize" << std::endl;
+          return false;
+        }
+    for (unsigned int j = 0; j < 6; j++)
+      if (L[rows][j] != 0) {
+        std::cout << "Bad content after a resize" << std::endl;
+        return false;
+      }
+    vpColVector Le = L * vpColVector(L.getCols(), 1.);
+    if (Le.getRows() != rows + 1)
+      return false;
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    vpArrayWorkspace workspace;
+    vpMatrix L;
+    vpColVector e;
+    L.setWorkspace(&workspace);
+    e.setWorkspace(&workspace);
+
+    // Warm-up: the workspace is too small and arrays fall back to the heap
+    if (! frame(workspace, L, e, 100))
+      return EXIT_FAILURE;
+    std::cout << "Warm-up: " << workspace.getBytesRequested() << " bytes requested, "
+              << workspace.getBytesServed() << " bytes served" << std::endl;
+    if (workspace.getBytesServed() == workspace.getBytesRequested()) {
+      std::cout << "An empty workspace cannot serve all the requests" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    for (unsigned int f = 0; f < 5; f++) {
+      workspace.resetCounters();
+      if (! frame(workspace, L, e, 100 - 3*f))
+        return EXIT_FAILURE;
+      std::cout << "Frame " << f << ": " << workspace.getBytesRequested() << " bytes requested, "
+                << workspace.getBytesServed() << " bytes served" << std::endl;
+      if (workspace.getBytesServed() != workspace.getBytesRequested()) {
+        std::cout << "The workspace should serve all the requests after warm-up" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Copies are not bound to the workspace
+    vpMatrix M(L);
+    if (M.getWorkspace() != NULL || M.getRows() != L.getRows())
+      return EXIT_FAILURE;
+
+    // Unbinding keeps the content
+    e.resize(3);
+    e[2] = 2.;
+    e.setWorkspace(NULL);
+    workspace.reset();
+    if (e.getRows() != 3 || e[2] != 2.)
+      return EXIT_FAILURE;
+
+    // Arrays bound to a destroyed workspace are unbound
+    {
+      vpArrayWorkspace ws(1024);
+      M.setWorkspace(&ws);
+      M.resize(4, 4);
+    }
+    if (M.getWorkspace() != NULL || M.size() != 0)
+      return EXIT_FAILURE;
+    M.resize(2, 2);
+
+    std::cout << "All tests succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,154 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test matrix multiplication with vpGEMM, vpMatrix::AtA() and vpMatrix::AAt().
+ *
+ *****************************************************************************/
+
+/*!
+  \example testGEMM.cpp
+
+  Test the packed matrix multiplication used by vpGEMM(), vpMatrix::mult2Matrices(),
+  vpMatrix::AtA() and vpMatrix::AAt() against a naive implementation.
+*/
+
+#include <iostream>
+#include <cmath>
+#include <stdlib.h>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpGEMM.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+void randomMatrix(vpMatrix &M, unsigned int rows, unsigned int cols, unsigned int seed)
+{
+  M.resize(rows, cols);
+  for (unsigned int i = 0; i < M.size(); i++) {
+    seed = seed * 1103515245 + 12345;
+    M.data[i] = ((seed >> 8) % 2001) / 1000. - 1.;
+  }
+}
+
+vpMatrix naiveProduct(const vpMatrix &A, const vpMatrix &B)
+{
+  vpMatrix C(A.getRows(), B.getCols());
+  for (unsigned int i = 0; i < A.getRows(); i++)
+    for (unsigned int j = 0; j < B.getCols(); j++) {
+      double s = 0;
+      for (unsigned int k = 0; k < A.getCols(); k++)
+        s += A[i][k] * B[k][j];
+      C[i][j] = s;
+    }
+  return C;
+}
+
+bool equal(const vpMatrix &M1, const vpMatrix &M2, double threshold)
+{
+  if (M1.getRows() != M2.getRows() || M1.getCols() != M2.getCols())
+    return false;
+  for (unsigned int i = 0; i < M1.size(); i++) {
+    if (std::fabs(M1.data[i] - M2.data[i]) > threshold)
+      return false;
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    std::cout << "GEMM micro kernel: " << vpGEMMKernelName() << std::endl;
+
+    // Sizes chosen to exercise the small path, the micro kernel edges and several cache blocks
+    unsigned int sizes[][3] = { {3, 3, 3}, {6, 6, 2000}, {2000, 6, 6}, {37, 41, 29}, {130, 270, 300}, {5, 2100, 9} };
+    for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+      unsigned int m = sizes[s][0], n = sizes[s][1], k = sizes[s][2];
+      vpMatrix A, B, C;
+      randomMatrix(A, m, k, 1+s);
+      randomMatrix(B, k, n, 11+s);
+      randomMatrix(C, m, n, 21+s);
+      vpMatrix ref = naiveProduct(A, B);
+      double threshold = 1e-12 * k;
+
+      if (! equal(A*B, ref, threshold)) {
+        std::cout << "A*B failed for " << m << "x" << k << " * " << k << "x" << n << std::endl;
+        return EXIT_FAILURE;
+      }
+
+      vpMatrix At = A.t(), Bt = B.t(), Ct = C.t();
+      vpMatrix D, Dref = 2. * ref + 3. * C;
+      for (unsigned int ops = 0; ops < 8; ops++) {
+        const vpMatrix &opA = (ops & VP_GEMM_A_T) ? At : A;
+        const vpMatrix &opB = (ops & VP_GEMM_B_T) ? Bt : B;
+        const vpMatrix &opC = (ops & VP_GEMM_C_T) ? Ct : C;
+        vpGEMM(opA, opB, 2., opC, 3., D, ops);
+        if (! equal(D, Dref, 3 * threshold)) {
+          std::cout << "vpGEMM(ops=" << ops << ") failed for " << m << "x" << k << " * " << k << "x" << n << std::endl;
+          return EXIT_FAILURE;
+        }
+        vpGEMM(opA, opB, 2., null, 0., D, ops);
+        if (! equal(D, 2. * ref, 3 * threshold)) {
+          std::cout << "vpGEMM(ops=" << ops << ") without C failed for " << m << "x" << k << " * " << k << "x" << n << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+
+      if (! equal(A.AtA(), naiveProduct(At, A), 1e-12 * m) || ! equal(A.AAt(), naiveProduct(A, At), threshold)) {
+        std::cout << "AtA() or AAt() failed for " << m << "x" << k << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // Typical interaction matrix of a tracker
+    vpMatrix L, LtL;
+    randomMatrix(L, 2000, 6, 3);
+    double t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < 100; i++)
+      L.AtA(LtL);
+    t = vpTime::measureTimeMs() - t;
+    std::cout << "L^T L with L 2000x6: " << t / 100 << " ms" << std::endl;
+
+    vpMatrix LLtL;
+    t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < 100; i++)
+      vpMatrix::mult2Matrices(L, LtL, LLtL);
+    t = vpTime::measureTimeMs() - t;
+    std::cout << "L * (L^T L) with L 2000x6: " << t / 100 << " ms" << std::endl;
+
+    std::cout << "All tests succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,268 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the fixed size and batched Kalman filters.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testKalmanBatch.cpp
+
+  \brief Test vpFixedKalmanFilter and vpKalmanFilterBatch against
+  vpLinearKalmanFilterInstantiation for all its state models, with the
+  standard and the Joseph covariance updates.
+*/
+
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+#include <visp3/core/vpFixedKalmanFilter.h>
+#include <visp3/core/vpKalmanFilterBatch.h>
+#include <visp3/core/vpLinearKalmanFilterInstantiation.h>
+#include <visp3/core/vpMath.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+  double random(double a, double b) { return a + (b - a) * rand() / RAND_MAX; }
+
+  bool equal(double a, double b, double precision) { return std::fabs(a - b) <= precision * (1 + std::fabs(b)); }
+
+  const char *modelName(vpLinearKalmanFilterInstantiation::vpStateModel model)
+  {
+    switch (model) {
+    case vpLinearKalmanFilterInstantiation::stateConstVel_MeasurePos:
+      return "stateConstVel_MeasurePos";
+    case vpLinearKalmanFilterInstantiation::stateConstVelWithColoredNoise_MeasureVel:
+      return "stateConstVelWithColoredNoise_MeasureVel";
+    default:
+      return "stateConstAccWithColoredNoise_MeasureVel";
+    }
+  }
+
+  // Measure of the signal i at iteration k
+  double measure(unsigned int i, unsigned int k) { return (i + 1) * sin(vpMath::rad(3. * k + 10 * i)) + random(-0.01, 0.01); }
+
+  // Copy the state and the matrices of one signal of the reference filter into a fixed size filter
+  template <unsigned int N>
+  void copySignal(const vpLinearKalmanFilterInstantiation &ref, unsigned int i, vpFixedKalmanFilter<N, 1> &kalman)
+  {
+    kalman.H[0][0] = 1;
+    kalman.R[0][0] = ref.R[i][i];
+    for (unsigned int r = 0; r < N; r++) {
+      kalman.Xpre[r] = ref.Xpre[N * i + r];
+      for (unsigned int c = 0; c < N; c++) {
+        kalman.F[r][c] = ref.F[N * i + r][N * i + c];
+        kalman.Q[r][c] = ref.Q[N * i + r][N * i + c];
+        kalman.Ppre[r][c] = ref.Ppre[N * i + r][N * i + c];
+      }
+    }
+  }
+
+  template <unsigned int N>
+  bool test(vpLinearKalmanFilterInstantiation::vpStateModel model, bool joseph)
+  {
+    const unsigned int nsignal = 5, niter = 200;
+    const double precision = 1e-9;
+    vpColVector sigma_state(N * nsignal), sigma_measure(nsignal);
+    for (unsigned int i = 0; i < nsignal; i++) {
+      sigma_measure[i] = random(1e-6, 1e-4);
+      for (unsigned int k = 0; k < N; k++)
+        sigma_state[N * i + k] = random(1e-6, 1e-4);
+    }
+    double rho = 0.5, dt = 0.04;
+
+    vpLinearKalmanFilterInstantiation ref;
+    ref.setStateModel(model);
+    ref.initFilter(nsignal, sigma_state, sigma_measure, rho, dt);
+    ref.setJosephForm(joseph);
+
+    vpKalmanFilterBatch batch;
+    batch.initFilter(model, nsignal, sigma_state, sigma_measure, rho, dt);
+    batch.setJosephForm(joseph);
+
+    std::vector<vpFixedKalmanFilter<N, 1> > fixed(nsignal);
+    for (unsigned int i = 0; i < nsignal; i++)
+      fixed[i].setJosephForm(joseph);
+
+    vpColVector z(nsignal), Xest;
+    for (unsigned int k = 0; k < niter; k++) {
+      for (unsigned int i = 0; i < nsignal; i++)
+        z[i] = measure(i, k);
+      ref.filter(z);
+      batch.filter(z);
+
+      batch.getStateEstimate(Xest);
+      for (unsigned int j = 0; j < N * nsignal; j++) {
+        if (!equal(Xest[j], ref.Xest[j], precision)) {
+          std::cerr << "Batch " << modelName(model) << " state " << j << " at iteration " << k << ": " << Xest[j]
+                    << " instead of " << ref.Xest[j] << std::endl;
+          return false;
+        }
+      }
+      for (unsigned int i = 0; i < nsignal; i++) {
+        for (unsigned int r = 0; r < N; r++) {
+          for (unsigned int c = 0; c < N; c++) {
+            if (!equal(batch.getCovarianceEstimate(i, r, c), ref.Pest[N * i + r][N * i + c], precision)) {
+              std::cerr << "Batch " << modelName(model) << " covariance (" << r << ", " << c << ") of signal " << i
+                        << " at iteration " << k << std::endl;
+              return false;
+            }
+          }
+        }
+      }
+
+      // The fixed size filters start from the predictions of the reference
+      // once it runs the filtering equations
+      if (ref.getIteration() == 2 && batch.getIteration() == 2 && k < 2) {
+        for (unsigned int i = 0; i < nsignal; i++)
+          copySignal(ref, i, fixed[i]);
+      } else if (k >= 2) {
+        for (unsigned int i = 0; i < nsignal; i++) {
+          fixed[i].filtering(&z[i]);
+          for (unsigned int r = 0; r < N; r++) {
+            if (!equal(fixed[i].Xest[r], ref.Xest[N * i + r], precision)) {
+              std::cerr << "Fixed " << modelName(model) << " state " << r << " of signal " << i << " at iteration " << k
+                        << ": " << fixed[i].Xest[r] << " instead of " << ref.Xest[N * i + r] << std::endl;
+              return false;
+            }
+            for (unsigned int c = 0; c < N; c++) {
+              if (!equal(fixed[i].Pest[r][c], ref.Pest[N * i + r][N * i + c], precision)) {
+                std::cerr << "Fixed " << modelName(model) << " covariance (" << r << ", " << c << ") of signal " << i
+                          << " at iteration " << k << std::endl;
+                return false;
+              }
+            }
+          }
+          fixed[i].prediction();
+        }
+      }
+    }
+    std::cout << modelName(model) << (joseph ? " with Joseph form" : "") << " is ok" << std::endl;
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    srand(0);
+    for (unsigned int j = 0; j < 2; j++) {
+      bool joseph = (j == 1);
+      if (!test<2>(vpLinearKalmanFilterInstantiation::stateConstVel_MeasurePos, joseph) ||
+          !test<2>(vpLinearKalmanFilterInstantiation::stateConstVelWithColoredNoise_MeasureVel, joseph) ||
+          !test<3>(vpLinearKalmanFilterInstantiation::stateConstAccWithColoredNoise_MeasureVel, joseph))
+        return EXIT_FAILURE;
+    }
+
+    // The estimates of the Joseph form are close to the standard ones
+    {
+      const unsigned int nsignal = 3;
+      vpColVector sigma_state(3 * nsignal, 1e-5), sigma_measure(nsignal, 1e-5), z(nsignal);
+      vpKalmanFilterBatch standard, joseph;
+      standard.initFilter(vpLinearKalmanFilterInstantiation::stateConstAccWithColoredNoise_MeasureVel, nsignal,
+                          sigma_state, sigma_measure, 0.5, 0.04);
+      joseph.initFilter(vpLinearKalmanFilterInstantiation::stateConstAccWithColoredNoise_MeasureVel, nsignal,
+                        sigma_state, sigma_measure, 0.5, 0.04);
+      joseph.setJosephForm(true);
+      for (unsigned int k = 0; k < 1000; k++) {
+        for (unsigned int i = 0; i < nsignal; i++)
+          z[i] = measure(i, k);
+        standard.filter(z);
+        joseph.filter(z);
+      }
+      for (unsigned int i = 0; i < nsignal; i++) {
+        if (!equal(joseph.getStateEstimate(1)[i], standard.getStateEstimate(1)[i], 1e-6)) {
+          std::cerr << "The Joseph form diverges from the standard update" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // Timings with many signals
+    {
+      const unsigned int nsignal = 500, niter = 1000;
+      vpColVector sigma_state(2 * nsignal, 1e-5), sigma_measure(nsignal, 1e-5), z(nsignal);
+      std::vector<vpColVector> measures(niter, vpColVector(nsignal));
+      for (unsigned int k = 0; k < niter; k++)
+        for (unsigned int i = 0; i < nsignal; i++)
+          measures[k][i] = measure(i, k);
+
+      vpKalmanFilterBatch batch;
+      batch.initFilter(vpLinearKalmanFilterInstantiation::stateConstVel_MeasurePos, nsignal, sigma_state,
+                       sigma_measure, 0, 0.04);
+      double t = vpTime::measureTimeMs();
+      for (unsigned int k = 0; k < niter; k++)
+        batch.filter(measures[k]);
+      double t_batch = vpTime::measureTimeMs() - t;
+
+      std::vector<vpFixedKalmanFilter<2, 1> > fixed(nsignal);
+      for (unsigned int i = 0; i < nsignal; i++) {
+        fixed[i].F[0][0] = fixed[i].F[1][1] = 1;
+        fixed[i].F[0][1] = 0.04;
+        fixed[i].H[0][0] = 1;
+        fixed[i].R[0][0] = 1e-5;
+        fixed[i].Q[1][1] = 1e-5;
+        fixed[i].Ppre[0][0] = fixed[i].Ppre[1][1] = 1;
+      }
+      t = vpTime::measureTimeMs();
+      for (unsigned int k = 0; k < niter; k++) {
+        for (unsigned int i = 0; i < nsignal; i++) {
+          fixed[i].filtering(&measures[k][i]);
+          fixed[i].prediction();
+        }
+      }
+      double t_fixed = vpTime::measureTimeMs() - t;
+
+      const unsigned int nsignal_ref = 50, niter_ref = 20;
+      vpLinearKalmanFilterInstantiation ref;
+      vpColVector sigma_state_ref(2 * nsignal_ref, 1e-5), sigma_measure_ref(nsignal_ref, 1e-5),
+          z_ref(nsignal_ref);
+      ref.setStateModel(vpLinearKalmanFilterInstantiation::stateConstVel_MeasurePos);
+      ref.initFilter(nsignal_ref, sigma_state_ref, sigma_measure_ref, 0, 0.04);
+      t = vpTime::measureTimeMs();
+      for (unsigned int k = 0; k < niter_ref; k++) {
+        for (unsigned int i = 0; i < nsignal_ref; i++)
+          z_ref[i] = measures[k][i];
+        ref.filter(z_ref);
+      }
+      double t_ref = vpTime::measureTimeMs() - t;
+
+      std::cout << "Time per step and per signal: vpKalmanFilterBatch " << 1e6 * t_batch / (niter * nsignal)
+                << " ns, vpFixedKalmanFilter " << 1e6 * t_fixed / (niter * nsignal)
+                << " ns, vpLinearKalmanFilterInstantiation with " << nsignal_ref << " signals "
+                << 1e6 * t_ref / (niter_ref * nsignal_ref) << " ns" << std::endl;
+    }
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
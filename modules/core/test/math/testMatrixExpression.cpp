@@ -0,0 +1,192 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test lazy matrix expressions built with vpTranspose() and vpDiag().
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMatrixExpression.cpp
+
+  Test lazy matrix expressions built with vpTranspose() and vpDiag() against
+  the vpMatrix operators.
+*/
+
+#include <iostream>
+#include <cmath>
+#include <stdlib.h>
+
+#include <visp3/core/vpConfig.h>
+#include <visp3/core/vpMatrix.h>
+#include <visp3/core/vpColVector.h>
+#include <visp3/core/vpRowVector.h>
+#include <visp3/core/vpRotationMatrix.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+void randomArray(vpArray2D<double> &M, unsigned int rows, unsigned int cols, unsigned int seed)
+{
+  M.resize(rows, cols);
+  for (unsigned int i = 0; i < M.size(); i++) {
+    seed = seed * 1103515245 + 12345;
+    M.data[i] = ((seed >> 8) % 2001) / 1000. - 1.;
+  }
+}
+
+vpMatrix diag(const vpColVector &w)
+{
+  vpMatrix W(w.getRows(), w.getRows());
+  for (unsigned int i = 0; i < w.getRows(); i++)
+    W[i][i] = w[i];
+  return W;
+}
+
+bool equal(const vpArray2D<double> &M1, const vpArray2D<double> &M2, double threshold)
+{
+  if (M1.getRows() != M2.getRows() || M1.getCols() != M2.getCols())
+    return false;
+  for (unsigned int i = 0; i < M1.size(); i++) {
+    if (std::fabs(M1.data[i] - M2.data[i]) > threshold)
+      return false;
+  }
+  return true;
+}
+
+bool check(const std::string &name, const vpArray2D<double> &M, const vpArray2D<double> &ref)
+{
+  if (! equal(M, ref, 1e-10)) {
+    std::cout << name << " failed" << std::endl;
+    return false;
+  }
+  return true;
+}
+}
+
+int main()
+{
+  try {
+    vpMatrix L, A, B;
+    vpColVector w, e;
+    randomArray(L, 200, 6, 1);
+    randomArray(A, 6, 5, 2);
+    randomArray(B, 5, 7, 3);
+    randomArray(w, 200, 1, 4);
+    randomArray(e, 200, 1, 5);
+    vpMatrix W = diag(w);
+    double lambda = 0.7;
+
+    vpMatrix M = vpTranspose(L) * vpDiag(w) * L;
+    if (! check("L^T W L", M, L.t() * W * L))
+      return EXIT_FAILURE;
+
+    vpColVector v = -lambda * (vpTranspose(L) * vpDiag(w) * e);
+    if (! check("-lambda L^T W e", v, -lambda * (L.t() * W * e)))
+      return EXIT_FAILURE;
+
+    M = vpDiag(w) * L;
+    if (! check("W L", M, W * L))
+      return EXIT_FAILURE;
+
+    M = 2. * (A * vpTranspose(vpTranspose(B)));
+    if (! check("2 A B", M, 2. * A * B))
+      return EXIT_FAILURE;
+
+    M = vpTranspose(A * B) * vpDiag(w.extract(0, 6)) * A;
+    if (! check("(A B)^T W A", M, (A * B).t() * diag(w.extract(0, 6)) * A))
+      return EXIT_FAILURE;
+
+    M = vpTranspose(L) * vpDiag(w) * L * A * B;
+    if (! check("L^T W L A B", M, L.t() * W * L * A * B))
+      return EXIT_FAILURE;
+
+    // Arrays that have their own operator*(const vpMatrix &) as left operand
+    vpRowVector r = L.getRow(0);
+    M = r * vpTranspose(A.t());
+    if (! check("r A", M, r * A))
+      return EXIT_FAILURE;
+
+    vpRotationMatrix R(0.1, 0.2, 0.3);
+    vpMatrix D;
+    randomArray(D, 4, 3, 8);
+    M = R * vpTranspose(D);
+    if (! check("R D^T", M, (vpMatrix)R * D.t()))
+      return EXIT_FAILURE;
+
+    vpMatrix C = A;
+    C = vpTranspose(C) * C;
+    if (! check("A^T A", C, A.t() * A))
+      return EXIT_FAILURE;
+
+    // Dimension mismatch
+    try {
+      M = vpTranspose(L) * A;
+      std::cout << "L^T A should throw an exception" << std::endl;
+      return EXIT_FAILURE;
+    }
+    catch(const vpException &) {
+    }
+    try {
+      v = vpTranspose(L) * L;
+      std::cout << "Assigning L^T L to a vector should throw an exception" << std::endl;
+      return EXIT_FAILURE;
+    }
+    catch(const vpException &) {
+    }
+
+    // Typical robust least square normal equations of a tracker
+    randomArray(L, 2000, 6, 6);
+    randomArray(w, 2000, 1, 7);
+    W = diag(w);
+    vpMatrix LtWL;
+    double t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < 100; i++)
+      LtWL = vpTranspose(L) * vpDiag(w) * L;
+    t = vpTime::measureTimeMs() - t;
+    std::cout << "L^T W L with L 2000x6 (lazy): " << t / 100 << " ms" << std::endl;
+
+    vpMatrix WL(2000, 6);
+    t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < 100; i++) {
+      for (unsigned int r = 0; r < 2000; r++)
+        for (unsigned int c = 0; c < 6; c++)
+          WL[r][c] = w[r] * L[r][c];
+      LtWL = L.t() * WL;
+    }
+    t = vpTime::measureTimeMs() - t;
+    std::cout << "L^T W L with L 2000x6 (operators): " << t / 100 << " ms" << std::endl;
+
+    std::cout << "All tests succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,192 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the 6 dof normal equation solver.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testNormalEquationSolver.cpp
+
+  \brief Test vpNormalEquationSolver against the pseudo inverse of the
+  stacked interaction matrix, with and without weights, damping or rank
+  deficiency.
+*/
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <visp3/core/vpNormalEquationSolver.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+  double random(double a, double b) { return a + (b - a) * rand() / RAND_MAX; }
+
+  bool equal(const vpColVector &a, const vpColVector &b, double precision, const std::string &what)
+  {
+    for (unsigned int i = 0; i < a.getRows(); i++)
+      if (!(std::fabs(a[i] - b[i]) <= precision * (1 + std::fabs(b[i])))) {
+        std::cerr << what << " failed:\n" << a.t() << "\ninstead of\n" << b.t() << std::endl;
+        return false;
+      }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    srand(0);
+    const unsigned int n = 500;
+    vpMatrix J(n, 6);
+    vpColVector e(n), w(n), d(n);
+    for (unsigned int i = 0; i < n; i++) {
+      for (unsigned int j = 0; j < 6; j++)
+        J[i][j] = random(-1, 1);
+      e[i] = random(-1, 1);
+      d[i] = random(0, 1);
+      w[i] = d[i] * d[i];
+    }
+
+    // Least squares
+    vpNormalEquationSolver solver;
+    vpColVector x;
+    solver.addRows(J, e);
+    if (solver.solve(x) != 6 || solver.getNbRows() != n ||
+        !equal(x, J.pseudoInverse(1e-16) * e, 1e-10, "Least squares"))
+      return EXIT_FAILURE;
+
+    // Weighted least squares, as in the robust virtual visual servoing
+    vpMatrix DJ = vpDiag(d) * J;
+    vpColVector De(n);
+    for (unsigned int i = 0; i < n; i++)
+      De[i] = d[i] * e[i];
+    solver.reset();
+    solver.addRows(J, e, w);
+    solver.solve(x);
+    if (!equal(x, DJ.pseudoInverse(1e-6) * De, 1e-10, "Weighted least squares"))
+      return EXIT_FAILURE;
+
+    // Levenberg-Marquardt damping
+    vpMatrix JTJ;
+    vpColVector JTe;
+    solver.getJTJ(JTJ);
+    solver.getJTe(JTe);
+    vpMatrix I;
+    I.eye(6);
+    solver.solve(x, 10.);
+    if (!equal(x, (JTJ + 10. * I).pseudoInverse() * JTe, 1e-10, "Damped least squares"))
+      return EXIT_FAILURE;
+
+    // Same normal equations when the rows are accumulated in several solvers
+    vpNormalEquationSolver half1, half2;
+    for (unsigned int i = 0; i < n; i++)
+      (i < n / 2 ? half1 : half2).addRow(J[i], e[i], w[i]);
+    half1.add(half2);
+    vpColVector x12;
+    half1.solve(x12);
+    solver.solve(x);
+    if (half1.getNbRows() != n || !equal(x12, x, 1e-12, "Merged normal equations"))
+      return EXIT_FAILURE;
+
+    // Change of unknowns, as for the rows J * cVo * oJo of the model-based trackers
+    vpMatrix M(6, 6);
+    for (unsigned int i = 0; i < 6; i++)
+      for (unsigned int j = 0; j < 6; j++)
+        M[i][j] = random(-1, 1);
+    vpMatrix JM = J * M;
+    vpNormalEquationSolver solverJM;
+    solverJM.addRows(JM, e, w);
+    half1 = solver;
+    half1.transform(M);
+    vpColVector xM;
+    half1.solve(xM);
+    solverJM.solve(x);
+    if (!equal(xM, x, 1e-8, "Transformed normal equations"))
+      return EXIT_FAILURE;
+
+    // Rank deficiency: minimal norm solution as with the pseudo inverse
+    for (unsigned int i = 0; i < n; i++) {
+      J[i][4] = J[i][1];
+      J[i][5] = 0;
+    }
+    solver.reset();
+    solver.addRows(J, e);
+    if (solver.getRank() != 4 || solver.solve(x) != 4 ||
+        !equal(x, J.pseudoInverse(1e-10) * e, 1e-8, "Rank deficient least squares"))
+      return EXIT_FAILURE;
+
+    // Empty normal equations
+    solver.reset();
+    if (solver.solve(x) != 0 || x.euclideanNorm() != 0) {
+      std::cerr << "Empty normal equations should have a null solution" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    try {
+      solver.addRows(J, vpColVector(n + 1));
+      std::cerr << "An exception should be thrown for inconsistent sizes" << std::endl;
+      return EXIT_FAILURE;
+    }
+    catch(vpException &) {
+    }
+
+    // Benchmark on the typical size of a moving-edge tracker
+    const unsigned int nbIterations = 100;
+    const unsigned int N = 2000;
+    J.resize(N, 6);
+    e.resize(N);
+    for (unsigned int i = 0; i < N; i++) {
+      for (unsigned int j = 0; j < 6; j++)
+        J[i][j] = random(-1, 1);
+      e[i] = random(-1, 1);
+    }
+    double t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbIterations; i++)
+      x = J.pseudoInverse(1e-16) * e;
+    std::cout << "Pseudo inverse of a " << N << "x6 matrix: " << (vpTime::measureTimeMs() - t) / nbIterations
+              << " ms" << std::endl;
+    t = vpTime::measureTimeMs();
+    for (unsigned int i = 0; i < nbIterations; i++) {
+      solver.reset();
+      solver.addRows(J, e);
+      solver.solve(x);
+    }
+    std::cout << "Normal equations of " << N << " rows: " << (vpTime::measureTimeMs() - t) / nbIterations << " ms"
+              << std::endl;
+
+    std::cout << "All tests succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cerr << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
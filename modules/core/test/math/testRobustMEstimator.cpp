@@ -0,0 +1,211 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the M-estimator of vpRobust.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testRobustMEstimator.cpp
+
+  \brief Test vpRobust::MEstimator() against a straightforward implementation
+  based on a full sort of the residues, for the Tukey, Cauchy and Huber
+  influence functions, with and without the histogram median selection.
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <stdlib.h>
+#include <vector>
+
+#include <visp3/core/vpRobust.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+  double median(const double *x, unsigned int n)
+  {
+    std::vector<double> v(x, x + n);
+    std::sort(v.begin(), v.end());
+    return v[(unsigned int)(ceil(n / 2.0)) - 1];
+  }
+
+  // Weights of the residues r, computed from the median absolute deviation
+  // of the residues having a non null weight in the initial weights w0
+  void referenceMEstimator(vpRobust::vpRobustEstimatorType method, const vpColVector &r,
+                           const vpColVector &w0, vpColVector &w)
+  {
+    const double eps = std::numeric_limits<double>::epsilon();
+    std::vector<double> selected;
+    for (unsigned int i = 0; i < r.getRows(); i++)
+      if (std::fabs(w0[i]) > eps)
+        selected.push_back(r[i]);
+    const unsigned int n = (unsigned int)selected.size();
+    const double med = median(&selected[0], n);
+    for (unsigned int i = 0; i < n; i++)
+      selected[i] = fabs(selected[i] - med);
+    double sigma = 1.4826 * median(&selected[0], n);
+    if (sigma < 0.0017)
+      sigma = 0.0017;
+
+    w = w0;
+    for (unsigned int i = 0; i < r.getRows(); i++) {
+      const double xi_sig = fabs(r[i] - med) / sigma;
+      if (method == vpRobust::TUKEY) {
+        const double c = 4.6851;
+        w[i] = (std::fabs(xi_sig) <= c && std::fabs(w[i]) > eps) ? vpMath::sqr(1 - vpMath::sqr(xi_sig / c)) : 0;
+      }
+      else if (method == vpRobust::CAUCHY) {
+        w[i] = 1 / (1 + vpMath::sqr(fabs(r[i] - med) / (2.3849 * sigma)));
+      }
+      else if (std::fabs(w[i]) > eps) {
+        const double c = 1.2107;
+        w[i] = std::fabs(xi_sig) <= c ? 1 : c / std::fabs(xi_sig);
+      }
+    }
+  }
+
+  // Inliers around 0.1 with a few gross outliers
+  void generateResidues(unsigned int n, vpColVector &r)
+  {
+    r.resize(n);
+    for (unsigned int i = 0; i < n; i++) {
+      r[i] = 0.1 + 0.01 * ((double)rand() / RAND_MAX - 0.5) + 0.01 * ((double)rand() / RAND_MAX - 0.5);
+      if (rand() % 10 == 0)
+        r[i] += (double)rand() / RAND_MAX - 0.5;
+    }
+  }
+
+  bool equal(const vpColVector &a, const vpColVector &b)
+  {
+    for (unsigned int i = 0; i < a.getRows(); i++)
+      if (!(std::fabs(a[i] - b[i]) <= 1e-12)) {
+        std::cerr << "Weight " << i << ": " << a[i] << " instead of " << b[i] << std::endl;
+        return false;
+      }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    const vpRobust::vpRobustEstimatorType methods[3] = { vpRobust::TUKEY, vpRobust::CAUCHY, vpRobust::HUBER };
+    const char *names[3] = { "Tukey", "Cauchy", "Huber" };
+    const unsigned int sizes[8] = { 1, 2, 3, 8, 101, 5000, 1000, 300001 };
+
+    srand(0);
+    vpRobust robust;
+    vpRobust histogramRobust;
+    histogramRobust.setMedianHistogramThreshold(1000);
+
+    // The same estimators are used for decreasing and increasing sizes
+    for (unsigned int s = 0; s < 8; s++) {
+      vpColVector r, ones(sizes[s], 1.), w0(sizes[s], 1.), w, wref;
+      generateResidues(sizes[s], r);
+      for (unsigned int i = 0; i < sizes[s]; i++)
+        if (i % 7 == 3)
+          w0[i] = 0;
+
+      for (unsigned int m = 0; m < 3; m++) {
+        referenceMEstimator(methods[m], r, ones, wref);
+        w = ones;
+        robust.MEstimator(methods[m], r, w);
+        if (!equal(w, wref)) {
+          std::cerr << names[m] << " M-estimator failed for " << sizes[s] << " residues" << std::endl;
+          return EXIT_FAILURE;
+        }
+        w = ones;
+        histogramRobust.MEstimator(methods[m], r, w);
+        if (!equal(w, wref)) {
+          std::cerr << names[m] << " M-estimator with the histogram median failed for " << sizes[s] << " residues"
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+
+        // Median computed on the residues having a non null weight only
+        referenceMEstimator(methods[m], r, w0, wref);
+        for (unsigned int k = 0; k < 2; k++) {
+          w = w0;
+          (k == 0 ? robust : histogramRobust).MEstimator(methods[m], r, r, w);
+          if (!equal(w, wref)) {
+            std::cerr << names[m] << " M-estimator on the whole residues failed for " << sizes[s] << " residues"
+                      << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+      }
+    }
+
+    // Constant residues: null median absolute deviation
+    vpColVector r(100, 0.5), w(100, 1.);
+    histogramRobust.setMedianHistogramThreshold(10);
+    histogramRobust.MEstimator(vpRobust::TUKEY, r, w);
+    for (unsigned int i = 0; i < r.getRows(); i++)
+      if (w[i] != 1.) {
+        std::cerr << "Constant residues should be inliers" << std::endl;
+        return EXIT_FAILURE;
+      }
+
+    // Benchmark on the typical size of a moving-edge tracker
+    const unsigned int nbIterations = 1000;
+    generateResidues(5000, r);
+    w.resize(r.getRows());
+    for (unsigned int m = 0; m < 3; m++) {
+      double t = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < nbIterations; i++) {
+        w = 1.;
+        robust.MEstimator(methods[m], r, w);
+      }
+      std::cout << names[m] << " M-estimator of 5000 residues: " << (vpTime::measureTimeMs() - t) / nbIterations
+                << " ms" << std::endl;
+    }
+
+    generateResidues(2000000, r);
+    w.resize(r.getRows());
+    histogramRobust.setMedianHistogramThreshold(1);
+    for (unsigned int k = 0; k < 2; k++) {
+      double t = vpTime::measureTimeMs();
+      for (unsigned int i = 0; i < 10; i++) {
+        w = 1.;
+        (k == 0 ? robust : histogramRobust).MEstimator(vpRobust::TUKEY, r, w);
+      }
+      std::cout << "Tukey M-estimator of 2000000 residues" << (k == 0 ? "" : " with the histogram median") << ": "
+                << (vpTime::measureTimeMs() - t) / 10 << " ms" << std::endl;
+    }
+
+    std::cout << "All tests succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cerr << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
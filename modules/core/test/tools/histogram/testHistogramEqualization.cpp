@@ -0,0 +1,224 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the histogram kernel, its ROI and mask variants and the equalizations.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testHistogramEqualization.cpp
+
+  \brief Test vpHistogram::calculate() against a naive count on images,
+  views and masks, with several threads, and test the histogram
+  equalization and CLAHE of vpImageTools.
+*/
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <visp3/core/vpHistogram.h>
+#include <visp3/core/vpImageTools.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+  bool checkHistogram(const std::string &name, const vpHistogram &hist, const vpImageView<unsigned char> &I,
+                      const vpImageView<unsigned char> *mask, unsigned int nbins)
+  {
+    std::vector<unsigned int> ref(nbins, 0);
+    for (unsigned int i = 0; i < I.getHeight(); i++)
+      for (unsigned int j = 0; j < I.getWidth(); j++)
+        if (mask == NULL || (*mask)[i][j] != 0)
+          ref[(unsigned int)(I[i][j] * nbins / 256.0)]++;
+
+    if (hist.getSize() != nbins) {
+      std::cerr << name << ": bad histogram size " << hist.getSize() << std::endl;
+      return false;
+    }
+    for (unsigned int l = 0; l < nbins; l++) {
+      if (hist[(unsigned char)l] != ref[l]) {
+        std::cerr << name << ": bin " << l << " is " << hist[(unsigned char)l] << " instead of " << ref[l] << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+
+  void randomImage(vpImage<unsigned char> &I, unsigned int height, unsigned int width, int range, int offset)
+  {
+    I.resize(height, width);
+    for (unsigned int i = 0; i < I.getSize(); i++)
+      I.bitmap[i] = (unsigned char)(offset + rand() % range);
+  }
+}
+
+int main()
+{
+  try {
+    srand(0);
+    vpImage<unsigned char> I, Imask;
+    randomImage(I, 97, 131, 256, 0);
+    randomImage(Imask, 97, 131, 2, 0);
+    vpHistogram hist;
+    for (unsigned int nbThreads = 1; nbThreads <= 3; nbThreads += 2) {
+      for (unsigned int nbins = 101; nbins <= 256; nbins += 155) {
+        hist.calculate(I, nbins, nbThreads);
+        if (! checkHistogram("Image", hist, I, NULL, nbins))
+          return EXIT_FAILURE;
+
+        vpImageView<unsigned char> roi(I, 13, 7, 50, 111);
+        hist.calculate(roi, nbins, nbThreads);
+        if (! checkHistogram("View", hist, roi, NULL, nbins))
+          return EXIT_FAILURE;
+
+        vpImageView<unsigned char> mask(Imask);
+        hist.calculate(I, mask, nbins, nbThreads);
+        if (! checkHistogram("Mask", hist, I, &mask, nbins))
+          return EXIT_FAILURE;
+      }
+    }
+
+    // Masks with blocks fully inside or outside
+    Imask = 0;
+    for (unsigned int i = 20; i < 60; i++)
+      for (unsigned int j = 16; j < 100; j++)
+        Imask[i][j] = 255;
+    vpImageView<unsigned char> mask(Imask);
+    hist.calculate(I, mask, 256, 2);
+    if (! checkHistogram("Rectangular mask", hist, I, &mask, 256))
+      return EXIT_FAILURE;
+
+    bool exception = false;
+    try {
+      hist.calculate(I, vpImageView<unsigned char>(Imask, 0, 0, 10, 10));
+    }
+    catch(vpException &) {
+      exception = true;
+    }
+    if (! exception) {
+      std::cerr << "No exception for a mask of a different size" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Histogram equalization stretches a narrow range of levels over [0, 255]
+    vpImage<unsigned char> Inarrow, Ieq;
+    randomImage(Inarrow, 120, 160, 11, 100);
+    vpImageTools::equalizeHistogram(Inarrow, Ieq, 2);
+    unsigned char lut[256];
+    for (unsigned int l = 0; l < 256; l++)
+      lut[l] = 0;
+    unsigned char vmin = 255, vmax = 0;
+    for (unsigned int i = 0; i < Inarrow.getSize(); i++) {
+      if (Ieq.bitmap[i] < lut[Inarrow.bitmap[i]]) {
+        std::cerr << "The equalization is not a function of the gray level" << std::endl;
+        return EXIT_FAILURE;
+      }
+      lut[Inarrow.bitmap[i]] = Ieq.bitmap[i];
+      vmin = std::min(vmin, Ieq.bitmap[i]);
+      vmax = std::max(vmax, Ieq.bitmap[i]);
+    }
+    for (unsigned int l = 101; l <= 110; l++) {
+      if (lut[l] <= lut[l - 1]) {
+        std::cerr << "The equalization is not increasing" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+    if (vmin != 0 || vmax != 255) {
+      std::cerr << "Equalized levels in [" << (int)vmin << ", " << (int)vmax << "]" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // CLAHE with one tile and no clipping maps the levels with the cumulative histogram
+    vpImage<unsigned char> Iclahe, Iclahe_mt;
+    vpImageTools::clahe(Inarrow, Iclahe, 1, 1, 0.);
+    hist.calculate(Inarrow);
+    unsigned int cdf = 0;
+    for (unsigned int l = 0; l < 256; l++) {
+      cdf += hist[(unsigned char)l];
+      lut[l] = vpMath::saturate<unsigned char>(cdf * (255.f / Inarrow.getSize()) + 0.5f);
+    }
+    for (unsigned int i = 0; i < Inarrow.getSize(); i++) {
+      if (Iclahe.bitmap[i] != lut[Inarrow.bitmap[i]]) {
+        std::cerr << "CLAHE with one tile differs from the cumulative histogram" << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+
+    // The clip limit bounds the contrast, the threads don't change the result
+    vpImageTools::clahe(Inarrow, Iclahe, 4, 3, 1.5);
+    vpImageTools::clahe(Inarrow, Iclahe_mt, 4, 3, 1.5, 3);
+    if (Iclahe != Iclahe_mt) {
+      std::cerr << "CLAHE differs with 3 threads" << std::endl;
+      return EXIT_FAILURE;
+    }
+    vmin = 255;
+    vmax = 0;
+    for (unsigned int i = 0; i < Iclahe.getSize(); i++) {
+      vmin = std::min(vmin, Iclahe.bitmap[i]);
+      vmax = std::max(vmax, Iclahe.bitmap[i]);
+    }
+    if (vmax - vmin >= 255 || vmax - vmin <= 11) {
+      std::cerr << "Clipped CLAHE levels in [" << (int)vmin << ", " << (int)vmax << "]" << std::endl;
+      return EXIT_FAILURE;
+    }
+    vpImageTools::clahe(vpImageView<unsigned char>(I, 10, 20, 40, 50), Iclahe, 8, 8);
+    if (Iclahe.getHeight() != 40 || Iclahe.getWidth() != 50)
+      return EXIT_FAILURE;
+
+    // Benchmark on a 1080p image with large uniform regions
+    vpImage<unsigned char> Ibig(1080, 1920);
+    for (unsigned int i = 0; i < Ibig.getHeight(); i++)
+      for (unsigned int j = 0; j < Ibig.getWidth(); j++)
+        Ibig[i][j] = (unsigned char)((i / 270) * 60 + (j / 480) * 10);
+    unsigned int nbIterations = 20;
+    unsigned int counts[256];
+    double t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIterations; iter++) {
+      memset(counts, 0, sizeof(counts));
+      for (unsigned int i = 0; i < Ibig.getSize(); i++)
+        counts[Ibig.bitmap[i]]++;
+    }
+    std::cout << "Single counter array: " << (vpTime::measureTimeMs() - t) / nbIterations << " ms" << std::endl;
+    t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIterations; iter++)
+      hist.calculate(Ibig);
+    std::cout << "vpHistogram::calculate(): " << (vpTime::measureTimeMs() - t) / nbIterations << " ms" << std::endl;
+    for (unsigned int l = 0; l < 256; l++) {
+      if (hist[(unsigned char)l] != counts[l])
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "All tests succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -0,0 +1,223 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the thread pool.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testThreadPool.cpp
+
+  \brief Test vpThreadPool: parallel loops, task groups, nested parallelism,
+  exceptions and the functions ported to the pool.
+*/
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <visp3/core/vpImageTools.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+  // Count the visits of each index
+  class vpVisitTask : public vpThreadPool::vpRangeTask
+  {
+  public:
+    vpVisitTask(std::vector<unsigned int> &visits) : m_visits(visits) {}
+    void run(unsigned int begin, unsigned int end)
+    {
+      for (unsigned int i = begin; i < end; i++)
+        m_visits[i]++;
+    }
+  private:
+    std::vector<unsigned int> &m_visits;
+  };
+
+  // Task running a nested parallel loop on a slice of the indexes
+  class vpNestedTask : public vpThreadPool::vpTask
+  {
+  public:
+    vpNestedTask() : pool(NULL), visits(NULL), begin(0), end(0) {}
+    void run()
+    {
+      vpVisitTask body(*visits);
+      pool->parallelFor(begin, end, body, 100);
+    }
+    vpThreadPool *pool;
+    std::vector<unsigned int> *visits;
+    unsigned int begin, end;
+  };
+
+  class vpThrowingTask : public vpThreadPool::vpRangeTask
+  {
+  public:
+    void run(unsigned int begin, unsigned int end)
+    {
+      if (begin <= 500 && 500 < end)
+        throw vpException(vpException::badValue, "Index 500");
+    }
+  };
+
+  bool checkVisits(const std::vector<unsigned int> &visits, const char *name)
+  {
+    for (size_t i = 0; i < visits.size(); i++) {
+      if (visits[i] != 1) {
+        std::cerr << name << ": index " << i << " visited " << visits[i] << " times" << std::endl;
+        return false;
+      }
+    }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    vpThreadPool pool(4);
+    if (pool.getNbThreads() != 4 && pool.getNbThreads() != 1) {
+      std::cerr << "The pool has " << pool.getNbThreads() << " threads" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Parallel loops with the default split, a grain and a maximum number of threads
+    unsigned int grains[] = { 0, 1, 1000, 0 };
+    unsigned int maxThreads[] = { 0, 0, 0, 2 };
+    for (unsigned int k = 0; k < 4; k++) {
+      std::vector<unsigned int> visits(100003, 0);
+      vpVisitTask body(visits);
+      pool.parallelFor(0, (unsigned int)visits.size(), body, grains[k], maxThreads[k]);
+      if (! checkVisits(visits, "parallelFor"))
+        return EXIT_FAILURE;
+    }
+
+    // Task group whose tasks run nested parallel loops on the same pool
+    {
+      std::vector<unsigned int> visits(50000, 0);
+      std::vector<vpNestedTask> tasks(20);
+      vpThreadPool::vpTaskGroup group(pool);
+      for (unsigned int i = 0; i < tasks.size(); i++) {
+        tasks[i].pool = &pool;
+        tasks[i].visits = &visits;
+        tasks[i].begin = (unsigned int)(visits.size() * i / tasks.size());
+        tasks[i].end = (unsigned int)(visits.size() * (i + 1) / tasks.size());
+        group.run(tasks[i]);
+      }
+      group.wait();
+      if (! checkVisits(visits, "nested parallelFor"))
+        return EXIT_FAILURE;
+    }
+
+    // An exception thrown by a task is thrown again by parallelFor()
+    bool exception = false;
+    try {
+      vpThrowingTask body;
+      pool.parallelFor(0, 1000, body, 10);
+    }
+    catch(vpException &e) {
+      exception = (e.getCode() == vpException::badValue);
+    }
+    if (! exception) {
+      std::cerr << "The exception of the task was not thrown again" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Sequential pool
+    pool.setNbThreads(1);
+    {
+      std::vector<unsigned int> visits(1000, 0);
+      vpVisitTask body(visits);
+      pool.parallelFor(0, 1000, body);
+      if (pool.getNbThreads() != 1 || ! checkVisits(visits, "sequential parallelFor"))
+        return EXIT_FAILURE;
+    }
+
+#if !defined(_WIN32)
+    setenv("VISP_NUM_THREADS", "3", 1);
+    if (vpThreadPool::getDefaultNbThreads() != 3) {
+      std::cerr << "VISP_NUM_THREADS is ignored" << std::endl;
+      return EXIT_FAILURE;
+    }
+    unsetenv("VISP_NUM_THREADS");
+#endif
+
+    // Functions ported to the shared pool give the same result with 1 and 4 threads
+    vpThreadPool::getInstance().setNbThreads(4);
+    vpImage<unsigned char> I(481, 641);
+    vpImage<vpRGBa> Ic(I.getHeight(), I.getWidth());
+    for (unsigned int i = 0; i < I.getSize(); i++) {
+      I.bitmap[i] = (unsigned char)(rand() % 256);
+      Ic.bitmap[i] = vpRGBa(I.bitmap[i], (unsigned char)(rand() % 256), (unsigned char)(rand() % 256), 0);
+    }
+    unsigned char lut[256];
+    vpRGBa lutRGBa[256];
+    for (unsigned int l = 0; l < 256; l++) {
+      lut[l] = (unsigned char)(255 - l);
+      lutRGBa[l] = vpRGBa((unsigned char)(255 - l), (unsigned char)(l / 2), (unsigned char)l, 7);
+    }
+    vpImage<unsigned char> I1 = I, I4 = I;
+    vpImage<vpRGBa> Ic1 = Ic, Ic4 = Ic;
+    I1.performLut(lut);
+    I4.performLut(lut, 4);
+    Ic1.performLut(lutRGBa);
+    Ic4.performLut(lutRGBa, 4);
+    if (I1 != I4 || memcmp(Ic1.bitmap, Ic4.bitmap, Ic1.getSize() * sizeof(vpRGBa)) != 0) {
+      std::cerr << "performLut() differs with 4 threads" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    vpCameraParameters cam(600, 600, 320, 240, -0.2, 0.2);
+    vpImage<unsigned char> Iu4, Iu1;
+    vpImageTools::undistort(I, cam, Iu4);
+    vpThreadPool::getInstance().setNbThreads(1);
+    vpImageTools::undistort(I, cam, Iu1);
+    if (Iu1 != Iu4) {
+      std::cerr << "undistort() differs with 4 threads" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // Overhead of a parallel call on a small image
+    vpThreadPool::getInstance().setNbThreads(4);
+    vpImage<unsigned char> Ismall(64, 64, 0);
+    const unsigned int nbIterations = 10000;
+    double t = vpTime::measureTimeMs();
+    for (unsigned int iter = 0; iter < nbIterations; iter++)
+      Ismall.performLut(lut, 4);
+    std::cout << "performLut() on a 64x64 image with 4 threads: "
+              << 1000. * (vpTime::measureTimeMs() - t) / nbIterations << " us" << std::endl;
+
+    std::cout << "All tests succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
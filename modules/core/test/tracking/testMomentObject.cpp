@@ -0,0 +1,148 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the computation of the moments of an image.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMomentObject.cpp
+
+  \brief Test vpMomentObject::fromImage() against a direct summation of the
+  moments over the pixels, for binary and photometric moments, with and
+  without distortion, with one or several threads.
+*/
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <visp3/core/vpMomentObject.h>
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+  // Moments of order lower than order summed pixel by pixel, each pixel weighted by weights[I[j][i]]
+  std::vector<double> directMoments(const vpImage<unsigned char> &I, const vpCameraParameters &cam,
+                                    const double (&weights)[256], unsigned int order)
+  {
+    std::vector<double> values(order * order, 0.);
+    for (unsigned int j = 0; j < I.getHeight(); j++) {
+      for (unsigned int i = 0; i < I.getWidth(); i++) {
+        double x = 0, y = 0;
+        vpPixelMeterConversion::convertPoint(cam, i, j, x, y);
+        for (unsigned int k = 0; k < order; k++)
+          for (unsigned int l = 0; l < order - k; l++)
+            values[k * order + l] += weights[I[j][i]] * pow(x, (int)l) * pow(y, (int)k);
+      }
+    }
+    return values;
+  }
+
+  bool equal(const vpMomentObject &obj, const std::vector<double> &ref, double scale, const std::string &what)
+  {
+    unsigned int order = obj.getOrder() + 1;
+    for (unsigned int k = 0; k < order; k++) {
+      for (unsigned int l = 0; l < order - k; l++) {
+        double value = obj.get(l, k), expected = ref[k * order + l] * scale;
+        if (!(std::fabs(value - expected) <= 1e-9 * (std::fabs(expected) + std::fabs(ref[0] * scale)))) {
+          std::cerr << what << ": m" << l << k << " = " << value << " instead of " << expected << std::endl;
+          return false;
+        }
+      }
+    }
+    return true;
+  }
+}
+
+int main()
+{
+  try {
+    srand(0);
+    // A noisy disk on a black background
+    vpImage<unsigned char> I(240, 320, 0);
+    for (unsigned int j = 0; j < I.getHeight(); j++)
+      for (unsigned int i = 0; i < I.getWidth(); i++)
+        if ((i - 180.) * (i - 180.) + (j - 100.) * (j - 100.) < 60. * 60.)
+          I[j][i] = (unsigned char)(155 + rand() % 100);
+
+    vpCameraParameters cams[2];
+    cams[0].initPersProjWithoutDistortion(600, 580, 160, 120);
+    cams[1].initPersProjWithDistortion(600, 580, 160, 120, -0.2, 0.2);
+
+    const unsigned int maxOrder = 4;
+    const unsigned int order = maxOrder + 1;
+    for (unsigned int c = 0; c < 2; c++) {
+      const vpCameraParameters &cam = cams[c];
+      double scale = 1. / (cam.get_px() * cam.get_py());
+      for (unsigned int nbThreads = 1; nbThreads <= 4; nbThreads += 3) {
+        std::string suffix = std::string(c ? " with distortion" : " without distortion") +
+                             (nbThreads > 1 ? " and 4 threads" : "");
+
+        double binary[256];
+        for (unsigned int i = 0; i < 256; i++)
+          binary[i] = (i > 128) ? 1. : 0.;
+        vpMomentObject obj(maxOrder);
+        obj.fromImage(I, 128, cam, nbThreads);
+        if (!equal(obj, directMoments(I, cam, binary, order), scale, "Binary moments" + suffix))
+          return EXIT_FAILURE;
+
+        double black[256], white[256];
+        for (unsigned int i = 0; i < 256; i++) {
+          black[i] = i / 255.;
+          white[i] = 1. - i / 255.;
+        }
+        vpMomentObject photometric(maxOrder);
+        photometric.fromImage(I, cam, vpMomentObject::BLACK, true, nbThreads);
+        if (!equal(photometric, directMoments(I, cam, black, order), scale, "Photometric moments" + suffix))
+          return EXIT_FAILURE;
+        photometric.fromImage(I, cam, vpMomentObject::WHITE, false, nbThreads);
+        if (!equal(photometric, directMoments(I, cam, white, order), 1., "White background moments" + suffix))
+          return EXIT_FAILURE;
+      }
+    }
+    std::cout << "Moments are ok" << std::endl;
+
+    vpImage<unsigned char> J(480, 640, 0);
+    for (unsigned int j = 100; j < 380; j++)
+      for (unsigned int i = 150; i < 500; i++)
+        J[j][i] = 255;
+    vpMomentObject obj(maxOrder);
+    const unsigned int niter = 100;
+    double t = vpTime::measureTimeMs();
+    for (unsigned int k = 0; k < niter; k++)
+      obj.fromImage(J, 128, cams[0]);
+    std::cout << "Binary moments of order " << maxOrder << " of a 640x480 image: " << (vpTime::measureTimeMs() - t) / niter
+              << " ms" << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
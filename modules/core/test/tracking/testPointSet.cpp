@@ -0,0 +1,157 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the projection of a set of points.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testPointSet.cpp
+
+  \brief Test vpPointSet against the projection of each vpPoint, with and
+  without distortion.
+*/
+
+#include <iostream>
+#include <stdlib.h>
+
+#include <visp3/core/vpMeterPixelConversion.h>
+#include <visp3/core/vpPointSet.h>
+#include <visp3/core/vpTime.h>
+
+namespace {
+  double random(double a, double b) { return a + (b - a) * rand() / RAND_MAX; }
+
+  void generatePoints(unsigned int n, std::vector<vpPoint> &points)
+  {
+    points.resize(n);
+    for (unsigned int i = 0; i < n; i++)
+      points[i].setWorldCoordinates(random(-0.5, 0.5), random(-0.5, 0.5), random(-0.2, 0.2));
+  }
+}
+
+int main()
+{
+  try {
+    srand(0);
+    vpHomogeneousMatrix cMo(0.05, -0.1, 1.5, vpMath::rad(10), vpMath::rad(-20), vpMath::rad(30));
+    vpCameraParameters cams[2];
+    cams[0].initPersProjWithoutDistortion(600, 610, 320, 240);
+    cams[1].initPersProjWithDistortion(600, 610, 320, 240, -0.2, 0.21);
+
+    std::vector<vpPoint> points;
+    generatePoints(101, points);
+    vpPointSet set(points);
+    if (set.size() != points.size()) {
+      std::cerr << "Wrong number of points" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    for (unsigned int c = 0; c < 2; c++) {
+      vpPointSet steps(points);
+      set.track(cMo, cams[c]);
+      steps.changeFrame(cMo);
+      steps.projection();
+      steps.meterToPixel(cams[c]);
+
+      for (unsigned int i = 0; i < points.size(); i++) {
+        vpPoint P(points[i].get_oX(), points[i].get_oY(), points[i].get_oZ());
+        P.track(cMo);
+        double u = 0, v = 0;
+        vpMeterPixelConversion::convertPoint(cams[c], P.get_x(), P.get_y(), u, v);
+
+        if (set.get_X()[i] != P.get_X() || set.get_Y()[i] != P.get_Y() || set.get_Z()[i] != P.get_Z() ||
+            set.get_x()[i] != P.get_x() || set.get_y()[i] != P.get_y() || set.get_u()[i] != u ||
+            set.get_v()[i] != v) {
+          std::cerr << "Point " << i << " differs from vpPoint::track() with camera model " << c << std::endl;
+          return EXIT_FAILURE;
+        }
+        if (steps.get_x()[i] != P.get_x() || steps.get_y()[i] != P.get_y() || steps.get_u()[i] != u ||
+            steps.get_v()[i] != v) {
+          std::cerr << "Point " << i << " differs when projected step by step" << std::endl;
+          return EXIT_FAILURE;
+        }
+
+        vpPoint Q;
+        set.getPoint(i, Q);
+        if (Q.get_oX() != P.get_oX() || Q.get_Z() != P.get_Z() || Q.get_x() != P.get_x()) {
+          std::cerr << "Point " << i << " not retrieved" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+
+    // Homogeneous coordinates normalized when adding a vpPoint
+    vpPoint P(0.2, 0.4, 0.6);
+    P.set_oW(2);
+    set.clear();
+    set.addPoint(P);
+    if (set.size() != 1 || set.get_oX()[0] != 0.1 || set.get_oZ()[0] != 0.3) {
+      std::cerr << "Homogeneous coordinates not normalized" << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    try {
+      set.projection();
+      std::cerr << "An exception should be thrown when projecting before changing the frame" << std::endl;
+      return EXIT_FAILURE;
+    }
+    catch(vpException &) {
+    }
+
+    // Benchmark on a large model
+    const unsigned int n = 50000;
+    const unsigned int nbIterations = 20;
+    generatePoints(n, points);
+    set.buildFrom(points);
+    double t = vpTime::measureTimeMs();
+    for (unsigned int k = 0; k < nbIterations; k++) {
+      for (unsigned int i = 0; i < n; i++) {
+        points[i].track(cMo);
+        double u = 0, v = 0;
+        vpMeterPixelConversion::convertPoint(cams[0], points[i].get_x(), points[i].get_y(), u, v);
+      }
+    }
+    std::cout << "vpPoint::track() of " << n << " points: " << (vpTime::measureTimeMs() - t) / nbIterations << " ms"
+              << std::endl;
+    t = vpTime::measureTimeMs();
+    for (unsigned int k = 0; k < nbIterations; k++)
+      set.track(cMo, cams[0]);
+    std::cout << "vpPointSet::track() of " << n << " points: " << (vpTime::measureTimeMs() - t) / nbIterations
+              << " ms" << std::endl;
+
+    std::cout << "All tests succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cerr << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
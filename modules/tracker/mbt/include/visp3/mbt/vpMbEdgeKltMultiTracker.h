@@ -69,6 +69,11 @@
   or in a cao file. The cao format is described in loadCAOModel().
   It may also use an xml file used to tune the behavior of the tracker and an
   init file used to compute the pose at the very first image.
+
+  With setNbThreads(), the KLT points and the moving edges of all the cameras
+  are tracked concurrently, and updated concurrently after the pose
+  estimation, which is shared by the cameras. The result doesn't depend on
+  the number of threads.
 */
 class VISP_EXPORT vpMbEdgeKltMultiTracker: public vpMbEdgeMultiTracker, public vpMbKltMultiTracker
 {
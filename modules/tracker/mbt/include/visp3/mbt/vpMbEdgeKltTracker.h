@@ -353,6 +353,33 @@ public:
   virtual void  track(const vpImage<unsigned char>& I);
 
 protected:
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  /*!
+    Half of the tracking run by track() concurrently with the other half,
+    before the joint virtual visual servoing. The KLT half only modifies the
+    KLT features and the pose, the moving-edge half only the moving edges
+    that are already initialized.
+  */
+  class vpHalfTrackingJob : public vpThreadPool::vpTask
+  {
+  public:
+    typedef enum {
+      KLT,        //!< Track the KLT features and estimate the pose from them.
+      MOVING_EDGE //!< Track the initialized moving edges.
+    } vpHalf;
+
+    vpHalfTrackingJob(vpMbEdgeKltTracker *tracker, const vpHalf half, const vpImage<unsigned char> &I);
+    void run();
+
+    vpMbEdgeKltTracker *tracker;
+    vpHalf half;
+    const vpImage<unsigned char> *I;
+    // KLT
+    unsigned int nbInfos;
+    vpColVector w;
+  };
+#endif
+
   void  computeVVS(const vpImage<unsigned char>& I, const unsigned int &nbInfos, vpColVector &w_mbt,
                    vpColVector &w_klt, const unsigned int lvl=0);
 
@@ -50,6 +50,7 @@
 
 #include <visp3/mbt/vpMbEdgeTracker.h>
 #include <visp3/core/vpRobust.h>
+#include <visp3/core/vpVelocityTwistMatrix.h>
 
 /*!
   \class vpMbEdgeMultiTracker
@@ -63,6 +64,12 @@
   or in a cao file. The cao format is described in loadCAOModel().
   It may also use an xml file used to tune the behavior of the tracker and an
   init file used to compute the pose at the very first image.
+
+  With setNbThreads(), the cameras are processed concurrently: the pyramids,
+  the tracking of the moving edges, the interaction matrices of the virtual
+  visual servoing and the update of the moving edges after the pose
+  estimation. Only the estimation of the pose itself is shared by the
+  cameras. The result doesn't depend on the number of threads.
 */
 class VISP_EXPORT vpMbEdgeMultiTracker: public vpMbEdgeTracker
 {
@@ -76,6 +83,9 @@ protected:
   //! Map of pyramidal images for each camera
   std::map<std::string, std::vector<const vpImage<unsigned char>* > > m_mapOfPyramidalImages;
 
+  //! Map of the image pyramids keeping the levels of m_mapOfPyramidalImages across the frames
+  std::map<std::string, vpImagePyramid> m_mapOfImagePyramids;
+
   //! Name of the reference camera
   std::string m_referenceCameraName;
 
@@ -286,6 +296,8 @@ public:
   virtual void setNearClippingDistance(const double &dist);
   virtual void setNearClippingDistance(const std::string &cameraName, const double &dist);
 
+  virtual void setNbThreads(const unsigned int nbThreads);
+
   /*!
     Enable/Disable the appearance of Ogre config dialog on startup.
 
@@ -333,6 +345,51 @@ protected:
     LINE, CYLINDER, CIRCLE
   } FeatureType;
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  /*!
+    Stage of the tracking run by one camera, concurrently with the other
+    cameras. The job only works on the tracker of its camera.
+  */
+  class vpEdgeCameraJob : public vpThreadPool::vpTask
+  {
+  public:
+    typedef enum {
+      PYRAMID,      //!< Build the image pyramid.
+      MOVING_EDGE,  //!< Track the moving edges at level lvl.
+      FIRST_PHASE,  //!< Interaction matrix and error of the first phase of the VVS.
+      SECOND_PHASE, //!< Interaction matrix and error of the second phase of the VVS.
+      UPDATE        //!< Visibility, update of the moving edges and projection error after the VVS.
+    } vpStage;
+
+    vpEdgeCameraJob();
+    void run();
+
+    vpStage stage;
+    vpMbEdgeMultiTracker *owner;
+    vpMbEdgeTracker *tracker;
+    const vpImage<unsigned char> *I;
+    unsigned int lvl;
+    // PYRAMID
+    vpImagePyramid *imagePyramid;
+    std::vector<const vpImage<unsigned char>* > *pyramid;
+    unsigned int nbLevels;
+    // FIRST_PHASE and SECOND_PHASE
+    vpVelocityTwistMatrix cVo;
+    unsigned int nbRows;
+    unsigned int iter;
+    vpMatrix L;
+    vpColVector *factor;
+    double count;
+    vpColVector error;
+    vpColVector errorLines;
+    vpColVector errorCylinders;
+    vpColVector errorCircles;
+  };
+
+  void runCameraJobs(std::vector<vpEdgeCameraJob> &jobs, const vpEdgeCameraJob::vpStage stage,
+      const unsigned int nbThreads) const;
+#endif
+
   /** @name Protected Member Functions Inherited from vpMbEdgeMultiTracker */
   //@{
   virtual void cleanPyramid(std::map<std::string, std::vector<const vpImage<unsigned char>* > >& pyramid);
@@ -54,6 +54,8 @@
 #include <visp3/mbt/vpMbtDistanceCylinder.h>
 #include <visp3/core/vpXmlParser.h>
 #include <visp3/core/vpRobust.h>
+#include <visp3/core/vpImagePyramid.h>
+#include <visp3/core/vpNormalEquationSolver.h>
 
 #include <iostream>
 #include <fstream>
@@ -311,6 +313,20 @@ class VISP_EXPORT vpMbEdgeTracker: virtual public vpMbTracker
     //! Number of features used in the computation of the projection error
     unsigned int nbFeaturesForProjErrorComputation;
 
+    //! Workspace providing the storage of the matrices and vectors used in computeVVS(). It is reset at each call.
+    vpArrayWorkspace m_workspace;
+
+    //! Pyramid providing the storage of the levels of Ipyramid across the frames.
+    vpImagePyramid m_imagePyramid;
+
+    //! Pyramid built by the caller and used by the next calls to track() instead of m_imagePyramid. NULL if none.
+    const vpImagePyramid *m_sharedImagePyramid;
+    //! Build count of m_sharedImagePyramid when it was last used, to detect a pyramid that was not built again for the current image.
+    unsigned long m_sharedImagePyramidBuildCount;
+
+    //! If true, computeVVS() accumulates the rows of the primitives in the normal equations instead of stacking them.
+    bool m_accumulateNormalEquations;
+
 public:
   
   vpMbEdgeTracker(); 
@@ -356,6 +372,13 @@ public:
     \return The scales levels used for the tracking. 
   */
   std::vector<bool> getScales() const {return scales;}
+  /*!
+     \return The workspace providing the storage of the matrices and vectors used
+     in the virtual visual servoing. Its vpArrayWorkspace::getBytesRequested() and
+     vpArrayWorkspace::getBytesServed() counters allow to check that the tracking
+     loop doesn't allocate memory once the workspace is large enough.
+   */
+  inline const vpArrayWorkspace &getWorkspace() const { return m_workspace; }
   /*!
      \return The threshold value between 0 and 1 over good moving edges ratio. It allows to
      decide if the tracker has enough valid moving edges to compute a pose. 1 means that all
@@ -366,6 +389,13 @@ public:
    */
   inline double getGoodMovingEdgesRatioThreshold() const { return percentageGdPt;}
 
+  /*!
+     \return true if the virtual visual servoing accumulates the normal equations.
+
+     \sa setNormalEquationsAccumulation()
+   */
+  inline bool getNormalEquationsAccumulation() const { return m_accumulateNormalEquations; }
+
   void loadConfigFile(const std::string &configFile);
   void loadConfigFile(const char* configFile);
   virtual void reInitModel(const vpImage<unsigned char>& I, const std::string &cad_name, const vpHomogeneousMatrix& cMo_,
@@ -450,6 +480,8 @@ public:
    */
   void setGoodMovingEdgesRatioThreshold(const double  threshold) {percentageGdPt = threshold;}
 
+  void setImagePyramid(const vpImagePyramid *pyramid);
+
   /*!
     Set the value of the gain used to compute the control law.
     
@@ -459,6 +491,26 @@ public:
   
   void setMovingEdge(const vpMe &me);
 
+  /*!
+     Enable or disable the accumulation mode of the virtual visual servoing.
+
+     By default, the interaction matrices and the errors of all the moving
+     edges are stacked in a Nx6 matrix, copied and weighted at each
+     iteration. In the accumulation mode, each line, cylinder and circle
+     adds its weighted rows straight into the 6x6 normal equations of a
+     vpNormalEquationSolver. The primitives are then processed in parallel
+     with the number of threads given by setNbThreads(), and the partial
+     normal equations are summed.
+
+     The covariance matrix needs the stacked matrices: when
+     setCovarianceComputation() is enabled, the stacked mode is used.
+
+     \param accumulate : true to accumulate the normal equations.
+
+     \sa getNormalEquationsAccumulation()
+   */
+  void setNormalEquationsAccumulation(const bool accumulate) { m_accumulateNormalEquations = accumulate; }
+
   virtual void setPose(const vpImage<unsigned char> &I, const vpHomogeneousMatrix& cdMo);
   
   void setScales(const std::vector<bool>& _scales);
@@ -469,6 +521,18 @@ public:
   //@}
 
 protected:
+  /*!
+    Primitives whose moving edges are tracked by trackMovingEdge().
+  */
+  typedef enum {
+    ALL_PRIMITIVES,         /*!< All the visible and tracked primitives. */
+    INITIALIZED_PRIMITIVES, /*!< Only the primitives whose moving edges are
+                                 already initialized. The current pose is not
+                                 used. */
+    NEW_PRIMITIVES          /*!< Only the primitives whose moving edges have
+                                 to be initialized at the current pose. */
+  } vpPrimitiveSelection;
+
   /** @name Protected Member Functions Inherited from vpMbEdgeTracker */
   //@{
   bool samePoint(const vpPoint &P1, const vpPoint &P2) const;
@@ -482,12 +546,19 @@ protected:
 
   void computeVVS(const vpImage<unsigned char>& _I, const unsigned int lvl);
   void computeVVSFirstPhase(const vpImage<unsigned char>& I, const unsigned int iter,
-      vpMatrix &L, vpColVector &factor, double &count, vpColVector &error, vpColVector &w_mbt, const unsigned int lvl = 0);
+      vpMatrix &L, vpColVector &factor, double &count, vpColVector &error, vpColVector &w_mbt, const unsigned int lvl = 0,
+      const bool stackL = true);
   void computeVVSFirstPhaseFactor(const vpImage<unsigned char>& I, vpColVector &factor, const unsigned int lvl = 0);
   void computeVVSFirstPhasePoseEstimation(const unsigned int nerror, const unsigned int iter, const vpColVector &factor,
       vpColVector &weighted_error, vpMatrix &L, bool &isoJoIdentity_);
+  void computeVVSFirstPhasePoseEstimation(const unsigned int iter, const vpColVector &factor, const unsigned int lvl,
+      bool &isoJoIdentity_);
+  void computeVVSInteractionMatrixAndError(const vpImage<unsigned char>& I, const unsigned int lvl);
+  void computeVVSNormalEquations(const vpColVector &factor, const bool weightInteraction, const unsigned int lvl,
+      vpNormalEquationSolver &solver);
   void computeVVSSecondPhase(const vpImage<unsigned char>& I, vpMatrix &L, vpColVector &error_lines,
-      vpColVector &error_cylinders, vpColVector &error_circles, vpColVector &error, const unsigned int lvl);
+      vpColVector &error_cylinders, vpColVector &error_circles, vpColVector &error, const unsigned int lvl,
+      const bool stackL = true);
   void computeVVSSecondPhaseCheckLevenbergMarquardt(const unsigned int iter, const unsigned int nbrow,
       const vpColVector &m_error_prev, const vpColVector &m_w_prev, const vpHomogeneousMatrix &cMoPrev,
       double &mu, bool &reStartFromLastIncrement);
@@ -495,6 +566,9 @@ protected:
       vpColVector &W_true, const vpColVector &factor, const unsigned int iter, const bool isoJoIdentity_,
       vpColVector &weighted_error, double &mu, vpColVector &m_error_prev, vpColVector &m_w_prev,
       vpHomogeneousMatrix &cMoPrev, double &residu_1, double &r);
+  void computeVVSSecondPhasePoseEstimation(const unsigned int nerror, const vpColVector &factor,
+      const unsigned int iter, const bool isoJoIdentity_, const unsigned int lvl, double &mu,
+      vpColVector &m_error_prev, vpColVector &m_w_prev, vpHomogeneousMatrix &cMoPrev, double &residu_1, double &r);
   void computeVVSSecondPhaseWeights(const unsigned int iter, const unsigned int nerror,
       const unsigned int nbrow, vpColVector &weighted_error,
       vpRobust &robust_lines, vpRobust &robust_cylinders, vpRobust &robust_circles,
@@ -514,6 +588,7 @@ protected:
   unsigned int initMbtTracking(unsigned int &nberrors_lines, unsigned int &nberrors_cylinders, unsigned int &nberrors_circles);
   void initMovingEdge(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &_cMo) ;
   void initPyramid(const vpImage<unsigned char>& _I, std::vector<const vpImage<unsigned char>* >& _pyramid);
+  void initPyramid(const vpImagePyramid& _imagePyramid, std::vector<const vpImage<unsigned char>* >& _pyramid);
   void reInitLevel(const unsigned int _lvl);
   void reinitMovingEdge(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &_cMo);
   void removeCircle(const std::string& name);
@@ -521,7 +596,7 @@ protected:
   void removeLine(const std::string& name);
   void resetMovingEdge();
   void testTracking();
-  void trackMovingEdge(const vpImage<unsigned char> &I) ;
+  void trackMovingEdge(const vpImage<unsigned char> &I, const vpPrimitiveSelection selection=ALL_PRIMITIVES) ;
   void updateMovingEdge(const vpImage<unsigned char> &I) ;
   void updateMovingEdgeWeights();
   void upScale(const unsigned int _scale); 
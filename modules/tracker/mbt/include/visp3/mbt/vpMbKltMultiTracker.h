@@ -68,6 +68,10 @@
   or in a cao file. The cao format is described in loadCAOModel().
   It may also use an xml file used to tune the behavior of the tracker and an
   init file used to compute the pose at the very first image.
+
+  With setNbThreads(), the KLT points of the cameras are tracked concurrently,
+  and updated concurrently after the pose estimation, which is shared by the
+  cameras. The result doesn't depend on the number of threads.
 */
 class VISP_EXPORT vpMbKltMultiTracker: public vpMbKltTracker
 {
@@ -301,6 +305,38 @@ public:
   //@}
 
 protected:
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+  /*!
+    Stage of the tracking run by one camera, concurrently with the other
+    cameras. The job only works on the tracker of its camera.
+  */
+  class vpKltCameraJob : public vpThreadPool::vpTask
+  {
+  public:
+    typedef enum {
+      PRE_TRACKING, //!< Track the KLT points.
+      POST_TRACKING //!< Remove the outliers after the VVS and reinitialize the KLT points if needed.
+    } vpStage;
+
+    vpKltCameraJob();
+    void run();
+
+    vpStage stage;
+    vpMbKltTracker *tracker;
+    const vpImage<unsigned char> *I;
+    // PRE_TRACKING
+    unsigned int nbInfos;
+    unsigned int nbFaceUsed;
+    // POST_TRACKING
+    vpColVector *w;
+    unsigned int shift;
+    bool reinitialised;
+  };
+
+  void runCameraJobs(std::vector<vpKltCameraJob> &jobs, const vpKltCameraJob::vpStage stage,
+      const unsigned int nbThreads) const;
+#endif
+
   /** @name Protected Member Functions Inherited from vpMbKltMultiTracker */
   //@{
   virtual void computeVVS(std::map<std::string, unsigned int> &mapOfNbInfos, vpColVector &w);
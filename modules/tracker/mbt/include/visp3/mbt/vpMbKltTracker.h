@@ -456,8 +456,10 @@ protected:
                             const std::string &name="");
 
   void preTracking(const vpImage<unsigned char>& I, unsigned int &nbInfos, unsigned int &nbFaceUsed);
+  void preTracking(unsigned int &nbInfos, unsigned int &nbFaceUsed);
   bool postTracking(const vpImage<unsigned char>& I, vpColVector &w);
   virtual void reinit(const vpImage<unsigned char>& I);
+  void reinitKltPoints(const vpImage<unsigned char>& I);
   //@}
 };
 
@@ -63,6 +63,7 @@
 #include <visp3/core/vpRGBa.h>
 #include <visp3/core/vpCameraParameters.h>
 #include <visp3/core/vpPoint.h>
+#include <visp3/core/vpThreadPool.h>
 #include <visp3/mbt/vpMbtPolygon.h>
 #include <visp3/mbt/vpMbHiddenFaces.h>
 #include <visp3/core/vpPolygon.h>
@@ -179,6 +180,8 @@ protected:
   double minPolygonAreaThresholdGeneral;
   //! Map with [map.first]=parameter_names and [map.second]=type (string, number or boolean)
   std::map<std::string, std::string> mapOfParameterNames;
+  //! Number of threads of the vpThreadPool used by the tracker
+  unsigned int m_nbThreads;
 
 public:
   vpMbTracker();
@@ -287,6 +290,13 @@ public:
     return static_cast<unsigned int>(faces.size());
   }
 
+  /*!
+    Get the number of threads used by the tracker.
+
+    \sa setNbThreads()
+  */
+  inline unsigned int getNbThreads() const { return m_nbThreads; }
+
   /*!
     Get the near distance for clipping.
 
@@ -422,6 +432,17 @@ public:
 
   virtual void setNearClippingDistance(const double &dist);
 
+  /*!
+    Set the number of threads of the vpThreadPool used by the tracker. The
+    trackers that split their work, for instance by primitive or by camera,
+    give the same result whatever the number of threads.
+
+    \param nbThreads : Number of threads. Default value is 1.
+
+    \sa getNbThreads()
+  */
+  virtual void setNbThreads(const unsigned int nbThreads) { m_nbThreads = nbThreads > 0 ? nbThreads : 1; }
+
   /*!
     Set the optimization method used during the tracking.
 
@@ -584,6 +605,8 @@ protected:
   void createCylinderBBox(const vpPoint& p1, const vpPoint &p2, const double &radius, std::vector<std::vector<vpPoint> > &listFaces);
 
   void computeJTR(const vpMatrix& J, const vpColVector& R, vpColVector& JTR) const;
+
+  void runTasks(const std::vector<vpThreadPool::vpTask *> &tasks, const unsigned int nbThreads) const;
   
 #ifdef VISP_HAVE_COIN3D
   virtual void extractGroup(SoVRMLGroup *sceneGraphVRML2, vpHomogeneousMatrix &transform, int &idFace);
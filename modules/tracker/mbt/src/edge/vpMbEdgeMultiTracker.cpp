@@ -53,7 +53,7 @@
   Basic constructor
 */
 vpMbEdgeMultiTracker::vpMbEdgeMultiTracker() : m_mapOfCameraTransformationMatrix(), m_mapOfEdgeTrackers(),
-    m_mapOfPyramidalImages(), m_referenceCameraName("Camera") {
+    m_mapOfPyramidalImages(), m_mapOfImagePyramids(), m_referenceCameraName("Camera") {
   m_mapOfEdgeTrackers["Camera"] = new vpMbEdgeTracker();
 
   //Add default camera transformation matrix
@@ -66,7 +66,7 @@ vpMbEdgeMultiTracker::vpMbEdgeMultiTracker() : m_mapOfCameraTransformationMatrix
   \param nbCameras : Number of cameras to use.
 */
 vpMbEdgeMultiTracker::vpMbEdgeMultiTracker(const unsigned int nbCameras) : m_mapOfCameraTransformationMatrix(),
-    m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(), m_referenceCameraName("Camera") {
+    m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(), m_mapOfImagePyramids(), m_referenceCameraName("Camera") {
 
   if(nbCameras == 0) {
     throw vpException(vpTrackingException::fatalError, "Cannot construct a vpMbEdgeMultiTracker with no camera !");
@@ -107,7 +107,7 @@ vpMbEdgeMultiTracker::vpMbEdgeMultiTracker(const unsigned int nbCameras) : m_map
   \param cameraNames : List of camera names.
 */
 vpMbEdgeMultiTracker::vpMbEdgeMultiTracker(const std::vector<std::string> &cameraNames) : m_mapOfCameraTransformationMatrix(),
-    m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(), m_referenceCameraName("Camera") {
+    m_mapOfEdgeTrackers(), m_mapOfPyramidalImages(), m_mapOfImagePyramids(), m_referenceCameraName("Camera") {
 
   if(cameraNames.empty()) {
     throw vpException(vpTrackingException::fatalError, "Cannot construct a vpMbEdgeMultiTracker with no camera !");
@@ -138,16 +138,7 @@ vpMbEdgeMultiTracker::~vpMbEdgeMultiTracker() {
 void vpMbEdgeMultiTracker::cleanPyramid(std::map<std::string, std::vector<const vpImage<unsigned char>* > >& pyramid) {
   for(std::map<std::string, std::vector<const vpImage<unsigned char>* > >::iterator it1 = pyramid.begin();
       it1 != pyramid.end(); ++it1) {
-    if(it1->second.size() > 0){
-      it1->second[0] = NULL;
-      for(size_t i = 1; i < it1->second.size(); i++) {
-        if(it1->second[i] != NULL) {
-          delete it1->second[i];
-          it1->second[i] = NULL;
-        }
-      }
-      it1->second.clear();
-    }
+    it1->second.clear();
   }
 }
 
@@ -252,6 +243,20 @@ void vpMbEdgeMultiTracker::computeVVS(std::map<std::string, const vpImage<unsign
     mapOfVelocityTwist[it->first] = cVo;
   }
 
+  //The interaction matrices and the errors of the cameras are computed concurrently
+  std::vector<vpEdgeCameraJob> jobs(m_mapOfEdgeTrackers.size());
+  unsigned int cpt_job = 0;
+  for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
+      it != m_mapOfEdgeTrackers.end(); ++it, cpt_job++) {
+    jobs[cpt_job].owner = this;
+    jobs[cpt_job].tracker = it->second;
+    jobs[cpt_job].I = mapOfImages[it->first];
+    jobs[cpt_job].lvl = lvl;
+    jobs[cpt_job].cVo = mapOfVelocityTwist[it->first];
+    jobs[cpt_job].nbRows = mapOfNumberOfRows[it->first];
+    jobs[cpt_job].factor = &mapOfFactors[it->first];
+  }
+
 //  std::cout << "\n\n\ncMo used before the first phase=\n" << cMo << std::endl;
 
   /*** First phase ***/
@@ -289,21 +294,21 @@ void vpMbEdgeMultiTracker::computeVVS(std::map<std::string, const vpImage<unsign
     factor = vpColVector();
 
 
-    for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
-        it != m_mapOfEdgeTrackers.end(); ++it) {
-      vpMatrix L_tmp(mapOfNumberOfRows[it->first], 6);
+    for(unsigned int i = 0; i < jobs.size(); i++) {
+      jobs[i].iter = iter;
+      jobs[i].L.resize(jobs[i].nbRows, 6);
+      jobs[i].count = 0.0;
+    }
 
-      double count_tmp = 0.0;
-      it->second->computeVVSFirstPhase(*mapOfImages[it->first], iter, L_tmp, mapOfFactors[it->first], count_tmp,
-          it->second->m_error, it->second->m_w, lvl);
-      count += count_tmp;
+    runCameraJobs(jobs, vpEdgeCameraJob::FIRST_PHASE, m_nbThreads);
 
-      L_tmp = L_tmp*mapOfVelocityTwist[it->first];
+    for(unsigned int i = 0; i < jobs.size(); i++) {
+      count += jobs[i].count;
 
-      L.stack(L_tmp);
-      factor.stack(mapOfFactors[it->first]);
-      m_w.stack(it->second->m_w);
-      m_error.stack(it->second->m_error);
+      L.stack(jobs[i].L);
+      factor.stack(*jobs[i].factor);
+      m_w.stack(jobs[i].tracker->m_w);
+      m_error.stack(jobs[i].tracker->m_error);
     }
 
     count = count / (double) nbrow;
@@ -379,32 +384,33 @@ void vpMbEdgeMultiTracker::computeVVS(std::map<std::string, const vpImage<unsign
     std::map<std::string, vpColVector> mapOfErrorCylinders;
     std::map<std::string, vpColVector> mapOfErrorCircles;
 
+    cpt_job = 0;
     for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
-        it != m_mapOfEdgeTrackers.end(); ++it) {
-      vpMatrix L_tmp(mapOfNumberOfRows[it->first], 6);
-      vpColVector error_lines_tmp(mapOfNumberOfLines[it->first]);
-      vpColVector error_cylinders_tmp(mapOfNumberOfCylinders[it->first]);
-      vpColVector error_circles_tmp(mapOfNumberOfCircles[it->first]);
+        it != m_mapOfEdgeTrackers.end(); ++it, cpt_job++) {
+      jobs[cpt_job].L.resize(mapOfNumberOfRows[it->first], 6);
+      jobs[cpt_job].errorLines.resize(mapOfNumberOfLines[it->first]);
+      jobs[cpt_job].errorCylinders.resize(mapOfNumberOfCylinders[it->first]);
+      jobs[cpt_job].errorCircles.resize(mapOfNumberOfCircles[it->first]);
+      jobs[cpt_job].error.resize(mapOfNumberOfRows[it->first]);
 
       it->second->cMo = m_mapOfCameraTransformationMatrix[it->first]*cMo;
+    }
 
-      vpColVector error_tmp;
-      error_tmp.resize(mapOfNumberOfRows[it->first]);
-
-      it->second->computeVVSSecondPhase(*mapOfImages[it->first], L_tmp, error_lines_tmp,
-          error_cylinders_tmp, error_circles_tmp, error_tmp, lvl);
-      L_tmp = L_tmp*mapOfVelocityTwist[it->first];
+    runCameraJobs(jobs, vpEdgeCameraJob::SECOND_PHASE, m_nbThreads);
 
-      L.stack(L_tmp);
-      m_error.stack(error_tmp);
+    cpt_job = 0;
+    for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
+        it != m_mapOfEdgeTrackers.end(); ++it, cpt_job++) {
+      L.stack(jobs[cpt_job].L);
+      m_error.stack(jobs[cpt_job].error);
 
-      error_lines.stack(error_lines_tmp);
-      error_cylinders.stack(error_cylinders_tmp);
-      error_circles.stack(error_circles_tmp);
+      error_lines.stack(jobs[cpt_job].errorLines);
+      error_cylinders.stack(jobs[cpt_job].errorCylinders);
+      error_circles.stack(jobs[cpt_job].errorCircles);
 
-      mapOfErrorLines[it->first] = error_lines_tmp;
-      mapOfErrorCylinders[it->first] = error_cylinders_tmp;
-      mapOfErrorCircles[it->first] = error_circles_tmp;
+      mapOfErrorLines[it->first] = jobs[cpt_job].errorLines;
+      mapOfErrorCylinders[it->first] = jobs[cpt_job].errorCylinders;
+      mapOfErrorCircles[it->first] = jobs[cpt_job].errorCircles;
     }
 
     bool reStartFromLastIncrement = false;
@@ -1646,14 +1652,107 @@ void vpMbEdgeMultiTracker::initFromPose(const std::map<std::string, const vpImag
 void vpMbEdgeMultiTracker::initPyramid(const std::map<std::string, const vpImage<unsigned char> * >& mapOfImages,
     std::map<std::string, std::vector<const vpImage<unsigned char>* > >& pyramid)
 {
+  unsigned int nbLevels = 1;
+  for(unsigned int i = 1; i < scales.size(); i++) {
+    if(scales[i]) {
+      nbLevels = i + 1;
+    }
+  }
+
+  //The pyramids of the cameras are built concurrently
+  std::vector<vpEdgeCameraJob> jobs(mapOfImages.size());
+  unsigned int cpt = 0;
   for(std::map<std::string, const vpImage<unsigned char> * >::const_iterator it = mapOfImages.begin();
-      it != mapOfImages.end(); ++it) {
-    pyramid[it->first].resize(scales.size());
+      it != mapOfImages.end(); ++it, cpt++) {
+    jobs[cpt].owner = this;
+    jobs[cpt].I = it->second;
+    jobs[cpt].imagePyramid = &m_mapOfImagePyramids[it->first];
+    jobs[cpt].pyramid = &pyramid[it->first];
+    jobs[cpt].nbLevels = nbLevels;
+  }
 
-    vpMbEdgeTracker::initPyramid(*it->second, pyramid[it->first]);
+  runCameraJobs(jobs, vpEdgeCameraJob::PYRAMID, m_nbThreads);
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+vpMbEdgeMultiTracker::vpEdgeCameraJob::vpEdgeCameraJob()
+  : stage(MOVING_EDGE), owner(NULL), tracker(NULL), I(NULL), lvl(0), imagePyramid(NULL), pyramid(NULL), nbLevels(1),
+    cVo(), nbRows(0), iter(0), L(), factor(NULL), count(0.0), error(), errorLines(), errorCylinders(), errorCircles()
+{
+}
+
+void vpMbEdgeMultiTracker::vpEdgeCameraJob::run()
+{
+  switch(stage) {
+  case PYRAMID:
+    imagePyramid->setType(vpImagePyramid::SUBSAMPLING);
+    imagePyramid->build(*I, nbLevels);
+    owner->vpMbEdgeTracker::initPyramid(*imagePyramid, *pyramid);
+    break;
+
+  case MOVING_EDGE:
+    try {
+      tracker->trackMovingEdge(*I);
+    } catch(...) {
+      vpTRACE("Error in moving edge tracking") ;
+      throw ;
+    }
+    break;
+
+  case FIRST_PHASE:
+    tracker->computeVVSFirstPhase(*I, iter, L, *factor, count, tracker->m_error, tracker->m_w, lvl);
+    L = L*cVo;
+    break;
+
+  case SECOND_PHASE:
+    tracker->computeVVSSecondPhase(*I, L, errorLines, errorCylinders, errorCircles, error, lvl);
+    L = L*cVo;
+    break;
+
+  case UPDATE: {
+    bool newvisibleface = false;
+    tracker->visibleFace(*I, tracker->cMo, newvisibleface);
+
+    if(owner->useScanLine) {
+      tracker->faces.computeClippedPolygons(tracker->cMo, tracker->cam);
+      tracker->faces.computeScanLineRender(tracker->cam, I->getWidth(), I->getHeight());
+    }
+
+    tracker->updateMovingEdge(*I);
+
+    tracker->initMovingEdge(*I, tracker->cMo);
+
+    // Reinit the moving edge for the lines which need it.
+    tracker->reinitMovingEdge(*I, tracker->cMo);
+
+    if(owner->computeProjError) {
+      //Compute the projection error
+      tracker->computeProjectionError(*I);
+    }
+    break;
+  }
+
+  default:
+    break;
   }
 }
 
+/*!
+  Run the same stage of the jobs of all the cameras with at most \e nbThreads
+  threads, and wait for them.
+*/
+void vpMbEdgeMultiTracker::runCameraJobs(std::vector<vpEdgeCameraJob> &jobs, const vpEdgeCameraJob::vpStage stage,
+    const unsigned int nbThreads) const {
+  std::vector<vpThreadPool::vpTask *> tasks(jobs.size());
+  for(size_t i = 0; i < jobs.size(); i++) {
+    jobs[i].stage = stage;
+    tasks[i] = &jobs[i];
+  }
+
+  runTasks(tasks, nbThreads);
+}
+#endif
+
 /*!
   Load the xml configuration file.
   From the configuration file, initialize the parameters corresponding to the objects: moving-edges,
@@ -2498,6 +2597,22 @@ void vpMbEdgeMultiTracker::setNearClippingDistance(const std::string &cameraName
   }
 }
 
+/*!
+  Set the number of threads of the vpThreadPool used by the tracker. The
+  cameras are processed concurrently, and each camera tracks its moving edges
+  with the same number of threads.
+
+  \param nbThreads : Number of threads. Default value is 1.
+*/
+void vpMbEdgeMultiTracker::setNbThreads(const unsigned int nbThreads) {
+  vpMbEdgeTracker::setNbThreads(nbThreads);
+
+  for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it = m_mapOfEdgeTrackers.begin();
+      it != m_mapOfEdgeTrackers.end(); ++it) {
+    it->second->setNbThreads(nbThreads);
+  }
+}
+
 /*!
   Enable/Disable the appearance of Ogre config dialog on startup.
 
@@ -2875,6 +2990,14 @@ void vpMbEdgeMultiTracker::track(std::map<std::string, const vpImage<unsigned ch
 
   initPyramid(mapOfImages, m_mapOfPyramidalImages);
 
+  std::vector<vpEdgeCameraJob> jobs(m_mapOfEdgeTrackers.size());
+  unsigned int cpt = 0;
+  for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
+      it != m_mapOfEdgeTrackers.end(); ++it, cpt++) {
+    jobs[cpt].owner = this;
+    jobs[cpt].tracker = it->second;
+  }
+
   unsigned int lvl = (unsigned int) scales.size();
   do {
     lvl--;
@@ -2886,20 +3009,17 @@ void vpMbEdgeMultiTracker::track(std::map<std::string, const vpImage<unsigned ch
       try
       {
         downScale(lvl);
+        cpt = 0;
         for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it1 = m_mapOfEdgeTrackers.begin();
-            it1 != m_mapOfEdgeTrackers.end(); ++it1) {
+            it1 != m_mapOfEdgeTrackers.end(); ++it1, cpt++) {
           //Downscale for each camera
           it1->second->downScale(lvl);
-
-          //Track moving edges
-          try {
-            it1->second->trackMovingEdge(*m_mapOfPyramidalImages[it1->first][lvl]);
-          } catch(...) {
-            vpTRACE("Error in moving edge tracking") ;
-            throw ;
-          }
+          jobs[cpt].I = m_mapOfPyramidalImages[it1->first][lvl];
         }
 
+        //Track moving edges of all the cameras concurrently
+        runCameraJobs(jobs, vpEdgeCameraJob::MOVING_EDGE, m_nbThreads);
+
         try {
           std::map<std::string, const vpImage<unsigned char> *> mapOfPyramidImages;
           for(std::map<std::string, std::vector<const vpImage<unsigned char>* > >::const_iterator
@@ -2944,43 +3064,15 @@ void vpMbEdgeMultiTracker::track(std::map<std::string, const vpImage<unsigned ch
           }
         }
 
-        // Looking for new visible face
-        bool newvisibleface = false;
+        // Looking for new visible face, update the moving edges and compute the projection error
+        // of all the cameras concurrently. Ogre is not thread safe, the cameras are then processed in sequence.
+        cpt = 0;
         for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
-            it != m_mapOfEdgeTrackers.end(); ++it) {
-          it->second->visibleFace(*mapOfImages[it->first], it->second->cMo, newvisibleface);
-        }
-
-        if(useScanLine) {
-          for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
-                      it != m_mapOfEdgeTrackers.end(); ++it) {
-            it->second->faces.computeClippedPolygons(it->second->cMo, it->second->cam);
-            it->second->faces.computeScanLineRender(it->second->cam, mapOfImages[it->first]->getWidth(),
-                mapOfImages[it->first]->getHeight());
-          }
-        }
-
-        try {
-          for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
-                      it != m_mapOfEdgeTrackers.end(); ++it) {
-            it->second->updateMovingEdge(*mapOfImages[it->first]);
-          }
-        } catch(...) {
-          throw; // throw the original exception
+            it != m_mapOfEdgeTrackers.end(); ++it, cpt++) {
+          jobs[cpt].I = mapOfImages[it->first];
         }
 
-        for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
-            it != m_mapOfEdgeTrackers.end(); ++it) {
-          it->second->initMovingEdge(*mapOfImages[it->first], it->second->cMo);
-
-          // Reinit the moving edge for the lines which need it.
-          it->second->reinitMovingEdge(*mapOfImages[it->first], it->second->cMo);
-
-          if(computeProjError) {
-            //Compute the projection error
-            it->second->computeProjectionError(*mapOfImages[it->first]);
-          }
-        }
+        runCameraJobs(jobs, vpEdgeCameraJob::UPDATE, useOgre ? 1 : m_nbThreads);
 
         computeProjectionError();
 
@@ -48,9 +48,11 @@
 #include <visp3/core/vpPixelMeterConversion.h>
 #include <visp3/core/vpRobust.h>
 #include <visp3/core/vpMatrixException.h>
+#include <visp3/core/vpNormalEquationSolver.h>
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpException.h>
 #include <visp3/core/vpTrackingException.h>
+#include <visp3/core/vpThreadPool.h>
 #include <visp3/mbt/vpMbEdgeTracker.h>
 #include <visp3/mbt/vpMbtDistanceLine.h>
 #include <visp3/mbt/vpMbtXmlParser.h>
@@ -70,7 +72,9 @@
 vpMbEdgeTracker::vpMbEdgeTracker()
   : compute_interaction(1), lambda(1), me(), lines(1), circles(1), cylinders(1), nline(0), ncircle(0), ncylinder(0),
     nbvisiblepolygone(0), percentageGdPt(0.4), scales(1),
-    Ipyramid(0), scaleLevel(0), nbFeaturesForProjErrorComputation(0)
+    Ipyramid(0), scaleLevel(0), nbFeaturesForProjErrorComputation(0), m_workspace(),
+    m_imagePyramid(vpImagePyramid::SUBSAMPLING), m_sharedImagePyramid(NULL), m_sharedImagePyramidBuildCount(0),
+    m_accumulateNormalEquations(false)
 {
   angleAppears = vpMath::rad(89);
   angleDisappears = vpMath::rad(89);
@@ -156,6 +160,133 @@ vpMbEdgeTracker::setMovingEdge(const vpMe &p_me)
   }
 }
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Tracked lines, cylinders and circles of a scale level, in the order of their rows in the virtual visual servoing
+class vpMbtFeatureGroups
+{
+public:
+  vpMbtFeatureGroups(const std::list<vpMbtDistanceLine *> &l, const std::list<vpMbtDistanceCylinder *> &cy,
+                     const std::list<vpMbtDistanceCircle *> &ci)
+    : lines(), cylinders(), circles(), rows(1, 0)
+  {
+    for (std::list<vpMbtDistanceLine *>::const_iterator it = l.begin(); it != l.end(); ++it) {
+      if ((*it)->isTracked()) {
+        lines.push_back(*it);
+        rows.push_back(rows.back() + (*it)->nbFeatureTotal);
+      }
+    }
+    for (std::list<vpMbtDistanceCylinder *>::const_iterator it = cy.begin(); it != cy.end(); ++it) {
+      if ((*it)->isTracked()) {
+        cylinders.push_back(*it);
+        rows.push_back(rows.back() + (*it)->nbFeature);
+      }
+    }
+    for (std::list<vpMbtDistanceCircle *>::const_iterator it = ci.begin(); it != ci.end(); ++it) {
+      if ((*it)->isTracked()) {
+        circles.push_back(*it);
+        rows.push_back(rows.back() + (*it)->nbFeature);
+      }
+    }
+  }
+
+  //! Number of groups
+  inline unsigned int size() const { return (unsigned int)rows.size() - 1; }
+
+  //! Interaction matrix of the group k
+  const vpMatrix &L(unsigned int k) const
+  {
+    if (k < lines.size())
+      return lines[k]->L;
+    k -= (unsigned int)lines.size();
+    if (k < cylinders.size())
+      return cylinders[k]->L;
+    return circles[k - cylinders.size()]->L;
+  }
+
+  std::vector<vpMbtDistanceLine *> lines;
+  std::vector<vpMbtDistanceCylinder *> cylinders;
+  std::vector<vpMbtDistanceCircle *> circles;
+  //! Index of the first row of each group, followed by the total number of rows
+  std::vector<unsigned int> rows;
+};
+
+// Compute the interaction matrices and the errors of a range of groups
+class vpMbtInteractionMatrixTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpMbtInteractionMatrixTask(const vpMbtFeatureGroups &groups, const vpHomogeneousMatrix &cMo,
+                             const vpImage<unsigned char> &I)
+    : m_groups(groups), m_cMo(cMo), m_I(I)
+  {
+  }
+
+  void run(unsigned int begin, unsigned int end)
+  {
+    const size_t nl = m_groups.lines.size();
+    const size_t ncy = m_groups.cylinders.size();
+    for (size_t k = begin; k < end; k++) {
+      if (k < nl)
+        m_groups.lines[k]->computeInteractionMatrixError(m_cMo);
+      else if (k < nl + ncy)
+        m_groups.cylinders[k - nl]->computeInteractionMatrixError(m_cMo, m_I);
+      else
+        m_groups.circles[k - nl - ncy]->computeInteractionMatrixError(m_cMo);
+    }
+  }
+
+private:
+  const vpMbtFeatureGroups &m_groups;
+  const vpHomogeneousMatrix &m_cMo;
+  const vpImage<unsigned char> &m_I;
+};
+
+// Accumulate the weighted rows of bands of groups in one solver per band
+class vpMbtNormalEquationsTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpMbtNormalEquationsTask(const vpMbtFeatureGroups &groups, const std::vector<unsigned int> &bands,
+                           const vpColVector &error, const vpColVector &w, const vpColVector &factor,
+                           bool weightInteraction, std::vector<vpNormalEquationSolver> &solvers)
+    : m_groups(groups), m_bands(bands), m_error(error), m_w(w), m_factor(factor),
+      m_weightInteraction(weightInteraction), m_solvers(solvers)
+  {
+  }
+
+  void run(unsigned int begin, unsigned int end)
+  {
+    for (unsigned int b = begin; b < end; b++) {
+      vpNormalEquationSolver &solver = m_solvers[b];
+      solver.reset();
+      for (unsigned int k = m_bands[b]; k < m_bands[b + 1]; k++) {
+        const vpMatrix &L = m_groups.L(k);
+        const unsigned int n = m_groups.rows[k];
+        for (unsigned int i = 0; i < m_groups.rows[k + 1] - n; i++) {
+          // Same rows as the stacked weighted interaction matrix and error
+          const double wi = m_w[n + i] * m_factor[n + i];
+          const double s = m_weightInteraction ? wi : 1.0;
+          double row[6];
+          for (unsigned int j = 0; j < 6; j++)
+            row[j] = s * L[i][j];
+          solver.addRow(row, wi * m_error[n + i]);
+        }
+      }
+    }
+  }
+
+private:
+  const vpMbtFeatureGroups &m_groups;
+  const std::vector<unsigned int> &m_bands;
+  const vpColVector &m_error;
+  const vpColVector &m_w;
+  const vpColVector &m_factor;
+  bool m_weightInteraction;
+  std::vector<vpNormalEquationSolver> &m_solvers;
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Compute the visual servoing loop to get the pose of the feature set.
   
@@ -170,8 +301,6 @@ vpMbEdgeTracker::computeVVS(const vpImage<unsigned char>& _I, const unsigned int
 {
   double residu_1 = 1e3;
   double r = 1e3-1;
-  vpMatrix LTL;
-  vpColVector LTR;
 
   //vpColVector w;
   vpColVector factor;
@@ -193,7 +322,31 @@ vpMbEdgeTracker::computeVVS(const vpImage<unsigned char>& _I, const unsigned int
     throw vpTrackingException(vpTrackingException::notEnoughPointError, "No data found to compute the interaction matrix...");
   }
   
-  vpMatrix L(nbrow,6), Lp;
+  // The matrices and vectors which size depends on the number of moving
+  // edges get their storage from the workspace
+  m_workspace.reset();
+  vpMatrix L, Lp;
+  vpColVector m_error_prev, m_w_prev;
+  vpColVector W_true;
+  vpMatrix L_true;
+  vpMatrix LVJ_true;
+  L.setWorkspace(&m_workspace);
+  factor.setWorkspace(&m_workspace);
+  weighted_error.setWorkspace(&m_workspace);
+  m_error.setWorkspace(&m_workspace);
+  m_w.setWorkspace(&m_workspace);
+  m_error_prev.setWorkspace(&m_workspace);
+  m_w_prev.setWorkspace(&m_workspace);
+  W_true.setWorkspace(&m_workspace);
+  L_true.setWorkspace(&m_workspace);
+  LVJ_true.setWorkspace(&m_workspace);
+
+  // In the accumulation mode, the rows of the primitives are added straight
+  // into the normal equations and L is not used. The covariance needs the
+  // stacked matrices
+  const bool accumulate = m_accumulateNormalEquations && !computeCovariance;
+  if (!accumulate)
+    L.resize(nbrow,6);
 
   // compute the error vector
   m_error.resize(nbrow);
@@ -224,14 +377,17 @@ vpMbEdgeTracker::computeVVS(const vpImage<unsigned char>& _I, const unsigned int
 //    unsigned int n = 0;
     reloop = false;
 
-    computeVVSFirstPhase(_I, iter, L, factor, count, m_error, m_w, lvl);
+    computeVVSFirstPhase(_I, iter, L, factor, count, m_error, m_w, lvl, !accumulate);
 
     count = count / (double)nbrow;
     if (count < 0.85){
       reloop = true;
     }
 
-    computeVVSFirstPhasePoseEstimation(nerror, iter, factor, weighted_error, L, isoJoIdentity_);
+    if (accumulate)
+      computeVVSFirstPhasePoseEstimation(iter, factor, lvl, isoJoIdentity_);
+    else
+      computeVVSFirstPhasePoseEstimation(nerror, iter, factor, weighted_error, L, isoJoIdentity_);
 
     iter++;
   }
@@ -256,18 +412,15 @@ vpMbEdgeTracker::computeVVS(const vpImage<unsigned char>& _I, const unsigned int
   vpColVector error_circles(nberrors_circles);
 
   vpHomogeneousMatrix cMoPrev;
-  vpColVector W_true;
-  vpMatrix L_true;
-  vpMatrix LVJ_true;
 
   double mu = 0.01;
-  vpColVector m_error_prev(nbrow);
-  vpColVector m_w_prev(nbrow);
+  m_error_prev.resize(nbrow);
+  m_w_prev.resize(nbrow);
   
   //while ( ((int)((residu_1 - r)*1e8) !=0 )  && (iter<30))
   while(std::fabs((residu_1 - r)*1e8) > std::numeric_limits<double>::epsilon() && (iter<30))
   {
-    computeVVSSecondPhase(_I, L, error_lines, error_cylinders, error_circles, m_error, lvl);
+    computeVVSSecondPhase(_I, L, error_lines, error_cylinders, error_circles, m_error, lvl, !accumulate);
 
     bool reStartFromLastIncrement = false;
 
@@ -278,8 +431,12 @@ vpMbEdgeTracker::computeVVS(const vpImage<unsigned char>& _I, const unsigned int
           w_lines, w_cylinders, w_circles, error_lines, error_cylinders, error_circles, nberrors_lines, nberrors_cylinders,
           nberrors_circles);
 
-      computeVVSSecondPhasePoseEstimation(nerror, L, L_true, LVJ_true, W_true, factor, iter, isoJoIdentity_,
-          weighted_error, mu, m_error_prev, m_w_prev, cMoPrev, residu_1, r);
+      if (accumulate)
+        computeVVSSecondPhasePoseEstimation(nerror, factor, iter, isoJoIdentity_, lvl, mu, m_error_prev, m_w_prev,
+            cMoPrev, residu_1, r);
+      else
+        computeVVSSecondPhasePoseEstimation(nerror, L, L_true, LVJ_true, W_true, factor, iter, isoJoIdentity_,
+            weighted_error, mu, m_error_prev, m_w_prev, cMoPrev, residu_1, r);
 
     } // endif(!restartFromLast)
 
@@ -305,7 +462,8 @@ vpMbEdgeTracker::computeVVS(const vpImage<unsigned char>& _I, const unsigned int
 
 void
 vpMbEdgeTracker::computeVVSFirstPhase(const vpImage<unsigned char>& _I, const unsigned int iter, vpMatrix &L,
-    vpColVector &factor, double &count, vpColVector &error, vpColVector &w_mbt, const unsigned int lvl) {
+    vpColVector &factor, double &count, vpColVector &error, vpColVector &w_mbt, const unsigned int lvl,
+    const bool stackL) {
   vpMbtDistanceLine *l;
   vpMbtDistanceCylinder *cy;
   vpMbtDistanceCircle *ci;
@@ -318,6 +476,8 @@ vpMbEdgeTracker::computeVVSFirstPhase(const vpImage<unsigned char>& _I, const un
   //Parametre pour la premiere phase d'asservissement
   double e_prev = 0, e_cur, e_next;
 
+  // L is left untouched when the normal equations are accumulated (stackL false)
+
   for(std::list<vpMbtDistanceLine*>::const_iterator it=lines[lvl].begin(); it!=lines[lvl].end(); ++it){
     if((*it)->isTracked())
     {
@@ -353,9 +513,12 @@ vpMbEdgeTracker::computeVVSFirstPhase(const vpImage<unsigned char>& _I, const un
 
         for (unsigned int i=0 ; i < l->nbFeature[a] ; i++)
         {
-          for (unsigned int j=0; j < 6 ; j++)
+          if (stackL)
           {
-            L[n+i][j] = l->L[indexFeature][j]; //On remplit la matrice d'interaction globale
+            for (unsigned int j=0; j < 6 ; j++)
+            {
+              L[n+i][j] = l->L[indexFeature][j]; //On remplit la matrice d'interaction globale
+            }
           }
           error[n+i] = l->error[indexFeature]; //On remplit la matrice d'erreur
 
@@ -433,8 +596,10 @@ vpMbEdgeTracker::computeVVSFirstPhase(const vpImage<unsigned char>& _I, const un
       }
 
       for(unsigned int i=0 ; i < cy->nbFeature ; i++){
-        for(unsigned int j=0; j < 6 ; j++){
-          L[n+i][j] = cy->L[i][j]; //On remplit la matrice d'interaction globale
+        if (stackL) {
+          for(unsigned int j=0; j < 6 ; j++){
+            L[n+i][j] = cy->L[i][j]; //On remplit la matrice d'interaction globale
+          }
         }
         error[n+i] = cy->error[i]; //On remplit la matrice d'erreur
 
@@ -537,8 +702,10 @@ vpMbEdgeTracker::computeVVSFirstPhase(const vpImage<unsigned char>& _I, const un
       }
 
       for(unsigned int i=0 ; i < ci->nbFeature ; i++){
-        for(unsigned int j=0; j < 6 ; j++){
-          L[n+i][j] = ci->L[i][j]; //On remplit la matrice d'interaction globale
+        if (stackL) {
+          for(unsigned int j=0; j < 6 ; j++){
+            L[n+i][j] = ci->L[i][j]; //On remplit la matrice d'interaction globale
+          }
         }
         error[n+i] = ci->error[i]; //On remplit la matrice d'erreur
 
@@ -746,30 +913,78 @@ vpMbEdgeTracker::computeVVSFirstPhasePoseEstimation(const unsigned int nerror, c
   }
 
   vpColVector v;
-  vpMatrix LTL;
-  vpColVector LTR;
 
   if(isoJoIdentity_){
-      LTL = L.AtA();
-      computeJTR(L, weighted_error, LTR);
-      v = -0.7*LTL.pseudoInverse(LTL.getRows()*std::numeric_limits<double>::epsilon())*LTR;
+      vpNormalEquationSolver solver;
+      solver.addRows(L, weighted_error);
+      solver.solve(v);
+      v = -0.7*v;
   }
   else{
       cVo.buildFrom(cMo);
       vpMatrix LVJ = (L*cVo*oJo);
-      vpMatrix LVJTLVJ = (LVJ).AtA();
-      vpColVector LVJTR;
-      computeJTR(LVJ, weighted_error, LVJTR);
-      v = -0.7*LVJTLVJ.pseudoInverse(LVJTLVJ.getRows()*std::numeric_limits<double>::epsilon())*LVJTR;
+      vpNormalEquationSolver solver;
+      solver.addRows(LVJ, weighted_error);
+      solver.solve(v);
+      v = -0.7*v;
       v = cVo * v;
   }
 
   cMo =  vpExponentialMap::direct(v).inverse() * cMo;
 }
 
+/*!
+  Pose estimation of the first phase of the virtual visual servoing, with
+  normal equations accumulated by computeVVSNormalEquations() instead of the
+  stacked interaction matrix.
+*/
+void
+vpMbEdgeTracker::computeVVSFirstPhasePoseEstimation(const unsigned int iter, const vpColVector &factor,
+    const unsigned int lvl, bool &isoJoIdentity_) {
+  vpNormalEquationSolver solver;
+  computeVVSNormalEquations(factor, (iter==0) || compute_interaction, lvl, solver);
+
+  vpVelocityTwistMatrix cVo;
+  cVo.buildFrom(cMo);
+
+  // If all the 6 dof should be estimated, we check if the interaction matrix is full rank.
+  // The kernel of L*cVo is the one of its normal equations, which singular
+  // values are the square of the ones of L*cVo: the threshold is squared.
+  if (isoJoIdentity_) {
+    vpNormalEquationSolver solverVo = solver;
+    solverVo.transform(vpMatrix(cVo));
+    vpMatrix JTJ;
+    solverVo.getJTJ(JTJ);
+
+    vpMatrix K; // kernel
+    unsigned int rank = JTJ.kernel(K, 1e-12);
+    if(rank == 0) {
+      throw vpException(vpException::fatalError, "Rank=0, cannot estimate the pose !");
+    }
+    if (rank != 6) {
+      vpMatrix I; // Identity
+      I.eye(6);
+      oJo = I-K.AtA();
+
+      isoJoIdentity_ = false;
+    }
+  }
+
+  vpColVector v;
+  if (!isoJoIdentity_)
+    solver.transform(cVo * oJo);
+  solver.solve(v);
+  v = -0.7*v;
+  if (!isoJoIdentity_)
+    v = cVo * v;
+
+  cMo =  vpExponentialMap::direct(v).inverse() * cMo;
+}
+
 void
 vpMbEdgeTracker::computeVVSSecondPhase(const vpImage<unsigned char>& _I, vpMatrix &L, vpColVector &error_lines,
-    vpColVector &error_cylinders, vpColVector &error_circles, vpColVector &error, const unsigned int lvl) {
+    vpColVector &error_cylinders, vpColVector &error_circles, vpColVector &error, const unsigned int lvl,
+    const bool stackL) {
   vpMbtDistanceLine *l;
   vpMbtDistanceCylinder *cy;
   vpMbtDistanceCircle *ci;
@@ -779,16 +994,25 @@ vpMbEdgeTracker::computeVVSSecondPhase(const vpImage<unsigned char>& _I, vpMatri
   unsigned int ncylinders = 0;
   unsigned int ncircles = 0;
 
+  // When the normal equations are accumulated (stackL false), L is left
+  // untouched: the interaction matrices of the primitives are computed in
+  // parallel and only the errors are stacked
+  if (!stackL)
+    computeVVSInteractionMatrixAndError(_I, lvl);
+
   for(std::list<vpMbtDistanceLine*>::const_iterator it=lines[lvl].begin(); it!=lines[lvl].end(); ++it){
     if((*it)->isTracked()){
       l = *it;
-      l->computeInteractionMatrixError(cMo) ;
+      if (stackL)
+        l->computeInteractionMatrixError(cMo) ;
       for (unsigned int i=0 ; i < l->nbFeatureTotal ; i++){
-        for (unsigned int j=0; j < 6 ; j++){
-          L[n+i][j] = l->L[i][j];
-          error[n+i] = l->error[i];
-          error_lines[nlines+i] = error[n+i];
+        if (stackL) {
+          for (unsigned int j=0; j < 6 ; j++){
+            L[n+i][j] = l->L[i][j];
+          }
         }
+        error[n+i] = l->error[i];
+        error_lines[nlines+i] = error[n+i];
       }
       n+= l->nbFeatureTotal;
       nlines+= l->nbFeatureTotal;
@@ -798,13 +1022,16 @@ vpMbEdgeTracker::computeVVSSecondPhase(const vpImage<unsigned char>& _I, vpMatri
   for(std::list<vpMbtDistanceCylinder*>::const_iterator it=cylinders[lvl].begin(); it!=cylinders[lvl].end(); ++it){
     if((*it)->isTracked()){
       cy = *it;
-      cy->computeInteractionMatrixError(cMo, _I) ;
+      if (stackL)
+        cy->computeInteractionMatrixError(cMo, _I) ;
       for(unsigned int i=0 ; i < cy->nbFeature ; i++){
-        for(unsigned int j=0; j < 6 ; j++){
-          L[n+i][j] = cy->L[i][j];
-          error[n+i] = cy->error[i];
-          error_cylinders[ncylinders+i] = error[n+i];
+        if (stackL) {
+          for (unsigned int j=0; j < 6 ; j++){
+            L[n+i][j] = cy->L[i][j];
+          }
         }
+        error[n+i] = cy->error[i];
+        error_cylinders[ncylinders+i] = error[n+i];
       }
 
       n+= cy->nbFeature ;
@@ -815,13 +1042,16 @@ vpMbEdgeTracker::computeVVSSecondPhase(const vpImage<unsigned char>& _I, vpMatri
   for(std::list<vpMbtDistanceCircle*>::const_iterator it=circles[lvl].begin(); it!=circles[lvl].end(); ++it){
     if((*it)->isTracked()){
       ci = *it;
-      ci->computeInteractionMatrixError(cMo) ;
+      if (stackL)
+        ci->computeInteractionMatrixError(cMo) ;
       for(unsigned int i=0 ; i < ci->nbFeature ; i++){
-        for(unsigned int j=0; j < 6 ; j++){
-          L[n+i][j] = ci->L[i][j];
-          error[n+i] = ci->error[i];
-          error_circles[ncircles+i] = error[n+i];
+        if (stackL) {
+          for (unsigned int j=0; j < 6 ; j++){
+            L[n+i][j] = ci->L[i][j];
+          }
         }
+        error[n+i] = ci->error[i];
+        error_circles[ncircles+i] = error[n+i];
       }
 
       n+= ci->nbFeature ;
@@ -830,6 +1060,64 @@ vpMbEdgeTracker::computeVVSSecondPhase(const vpImage<unsigned char>& _I, vpMatri
   }
 }
 
+/*!
+  Compute the interaction matrices and the errors of the tracked lines,
+  cylinders and circles, in parallel with the number of threads given by
+  setNbThreads().
+
+  \param I : The current image.
+  \param lvl : The level in the pyramid scale.
+*/
+void
+vpMbEdgeTracker::computeVVSInteractionMatrixAndError(const vpImage<unsigned char>& I, const unsigned int lvl)
+{
+  vpMbtFeatureGroups groups(lines[lvl], cylinders[lvl], circles[lvl]);
+  vpMbtInteractionMatrixTask task(groups, cMo, I);
+  vpThreadPool::getInstance().parallelFor(0, groups.size(), task, 0, m_nbThreads);
+}
+
+/*!
+  Accumulate the weighted rows of the tracked lines, cylinders and circles
+  in the normal equations of the virtual visual servoing. The rows are the
+  same as the ones of the stacked weighted interaction matrix and error,
+  without building them. With setNbThreads(), the primitives are split into
+  bands of about the same number of rows, accumulated in parallel and
+  summed in the order of the bands.
+
+  \param factor : Factors of the weights of the rows.
+  \param weightInteraction : If true, the rows of the interaction matrix
+  are weighted as the error. Otherwise only the error is weighted.
+  \param lvl : The level in the pyramid scale.
+  \param solver : Normal equations, reset before the accumulation.
+*/
+void
+vpMbEdgeTracker::computeVVSNormalEquations(const vpColVector &factor, const bool weightInteraction,
+    const unsigned int lvl, vpNormalEquationSolver &solver)
+{
+  solver.reset();
+  vpMbtFeatureGroups groups(lines[lvl], cylinders[lvl], circles[lvl]);
+  if (groups.size() == 0)
+    return;
+
+  // Split the groups into bands of about the same number of rows
+  const unsigned int nbBands = vpMath::minimum(m_nbThreads, groups.size());
+  const unsigned int nbRows = groups.rows.back();
+  std::vector<unsigned int> bands(nbBands + 1, groups.size());
+  bands[0] = 0;
+  unsigned int k = 0;
+  for (unsigned int b = 1; b < nbBands; b++) {
+    while (k < groups.size() && (size_t)groups.rows[k] * nbBands < (size_t)nbRows * b)
+      k++;
+    bands[b] = k;
+  }
+
+  std::vector<vpNormalEquationSolver> solvers(nbBands);
+  vpMbtNormalEquationsTask task(groups, bands, m_error, m_w, factor, weightInteraction, solvers);
+  vpThreadPool::getInstance().parallelFor(0, nbBands, task, 1, nbBands);
+  for (unsigned int b = 0; b < nbBands; b++)
+    solver.add(solvers[b]);
+}
+
 void
 vpMbEdgeTracker::computeVVSSecondPhaseCheckLevenbergMarquardt(const unsigned int iter, const unsigned int nbrow,
     const vpColVector &m_error_prev, const vpColVector &m_w_prev, const vpHomogeneousMatrix &cMoPrev,
@@ -859,8 +1147,6 @@ vpMbEdgeTracker::computeVVSSecondPhasePoseEstimation(const unsigned int nerror,
   double wi;
   double eri;
 
-  vpMatrix LTL;
-  vpColVector LTR;
 
   L_true = L;
   W_true = vpColVector(nerror);
@@ -902,16 +1188,14 @@ vpMbEdgeTracker::computeVVSSecondPhasePoseEstimation(const unsigned int nerror,
 
   vpColVector v;
   if(isoJoIdentity_){
-    LTL = L.AtA();
-    computeJTR(L, weighted_error, LTR);
+    vpNormalEquationSolver solver;
+    solver.addRows(L, weighted_error);
 
     switch(m_optimizationMethod){
     case vpMbTracker::LEVENBERG_MARQUARDT_OPT:
     {
-      vpMatrix LMA(LTL.getRows(), LTL.getCols());
-      LMA.eye();
-      vpMatrix LTLmuI = LTL + (LMA*mu);
-      v = -lambda*LTLmuI.pseudoInverse(LTLmuI.getRows()*std::numeric_limits<double>::epsilon())*LTR;
+      solver.solve(v, mu);
+      v = -lambda*v;
 
       if(iter != 0)
         mu /= 10.0;
@@ -922,23 +1206,21 @@ vpMbEdgeTracker::computeVVSSecondPhasePoseEstimation(const unsigned int nerror,
     }
     case vpMbTracker::GAUSS_NEWTON_OPT:
     default:
-      v = -lambda*LTL.pseudoInverse(LTL.getRows()*std::numeric_limits<double>::epsilon())*LTR;
+      solver.solve(v);
+      v = -lambda*v;
     }
   }
   else{
     cVo.buildFrom(cMo);
     vpMatrix LVJ = (L*cVo*oJo);
-    vpMatrix LVJTLVJ = (LVJ).AtA();
-    vpColVector LVJTR;
-    computeJTR(LVJ, weighted_error, LVJTR);
+    vpNormalEquationSolver solver;
+    solver.addRows(LVJ, weighted_error);
 
     switch(m_optimizationMethod){
     case vpMbTracker::LEVENBERG_MARQUARDT_OPT:
     {
-      vpMatrix LMA(LVJTLVJ.getRows(), LVJTLVJ.getCols());
-      LMA.eye();
-      vpMatrix LTLmuI = LVJTLVJ + (LMA*mu);
-      v = -lambda*LTLmuI.pseudoInverse(LTLmuI.getRows()*std::numeric_limits<double>::epsilon())*LVJTR;
+      solver.solve(v, mu);
+      v = -lambda*v;
       v = cVo * v;
 
       if(iter != 0)
@@ -951,7 +1233,8 @@ vpMbEdgeTracker::computeVVSSecondPhasePoseEstimation(const unsigned int nerror,
     case vpMbTracker::GAUSS_NEWTON_OPT:
     default:
     {
-      v = -lambda*LVJTLVJ.pseudoInverse(LVJTLVJ.getRows()*std::numeric_limits<double>::epsilon())*LVJTR;
+      solver.solve(v);
+      v = -lambda*v;
       v = cVo * v;
       break;
     }
@@ -965,6 +1248,60 @@ vpMbEdgeTracker::computeVVSSecondPhasePoseEstimation(const unsigned int nerror,
   cMo =  vpExponentialMap::direct(v).inverse() * cMo;
 }
 
+/*!
+  Pose estimation of the second phase of the virtual visual servoing, with
+  normal equations accumulated by computeVVSNormalEquations() instead of the
+  stacked interaction matrix.
+*/
+void
+vpMbEdgeTracker::computeVVSSecondPhasePoseEstimation(const unsigned int nerror, const vpColVector &factor,
+    const unsigned int iter, const bool isoJoIdentity_, const unsigned int lvl, double &mu,
+    vpColVector &m_error_prev, vpColVector &m_w_prev, vpHomogeneousMatrix &cMoPrev, double &residu_1, double &r) {
+  double num=0;
+  double den=0;
+  for (unsigned int i = 0; i < nerror; i++) {
+    double wi = m_w[i]*factor[i];
+    num += wi*vpMath::sqr(m_error[i]);
+    den += wi;
+  }
+
+  vpNormalEquationSolver solver;
+  computeVVSNormalEquations(factor, (iter==0) || compute_interaction, lvl, solver);
+
+  vpVelocityTwistMatrix cVo;
+  if(!isoJoIdentity_){
+    cVo.buildFrom(cMo);
+    solver.transform(cVo * oJo);
+  }
+
+  vpColVector v;
+  switch(m_optimizationMethod){
+  case vpMbTracker::LEVENBERG_MARQUARDT_OPT:
+  {
+    solver.solve(v, mu);
+
+    if(iter != 0)
+      mu /= 10.0;
+
+    m_error_prev = m_error;
+    m_w_prev = m_w;
+    break;
+  }
+  case vpMbTracker::GAUSS_NEWTON_OPT:
+  default:
+    solver.solve(v);
+  }
+  v = -lambda*v;
+  if(!isoJoIdentity_)
+    v = cVo * v;
+
+  residu_1 = r;
+  r = sqrt(num/den); //Le critere d'arret prend en compte le poids
+
+  cMoPrev = cMo;
+  cMo =  vpExponentialMap::direct(v).inverse() * cMo;
+}
+
 void
 vpMbEdgeTracker::computeVVSSecondPhaseWeights(const unsigned int iter, const unsigned int nerror,
     const unsigned int nbrow, vpColVector &weighted_error,
@@ -1718,43 +2055,141 @@ vpMbEdgeTracker::initMovingEdge(const vpImage<unsigned char> &I, const vpHomogen
 }
 
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Track the moving edges of bands of the primitives gathered by vpMbEdgeTracker::trackMovingEdge().
+// The primitives are indexed as the lines, followed by the cylinders and the circles.
+class vpMbtTrackMovingEdgeTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpMbtTrackMovingEdgeTask(const vpImage<unsigned char> &I, const vpHomogeneousMatrix &cMo,
+                           const std::vector<vpMbtDistanceLine *> &lines,
+                           const std::vector<vpMbtDistanceCylinder *> &cylinders,
+                           const std::vector<vpMbtDistanceCircle *> &circles,
+                           const std::vector<size_t> &bands)
+    : m_I(I), m_cMo(cMo), m_lines(lines), m_cylinders(cylinders), m_circles(circles), m_bands(bands)
+  {
+  }
+
+  void run(unsigned int begin, unsigned int end)
+  {
+    const size_t nl = m_lines.size();
+    const size_t ncy = m_cylinders.size();
+    for (size_t k = m_bands[begin]; k < m_bands[end]; k++) {
+      if (k < nl)
+        m_lines[k]->trackMovingEdge(m_I, m_cMo);
+      else if (k < nl + ncy)
+        m_cylinders[k - nl]->trackMovingEdge(m_I, m_cMo);
+      else
+        m_circles[k - nl - ncy]->trackMovingEdge(m_I, m_cMo);
+    }
+  }
+
+private:
+  const vpImage<unsigned char> &m_I;
+  const vpHomogeneousMatrix &m_cMo;
+  const std::vector<vpMbtDistanceLine *> &m_lines;
+  const std::vector<vpMbtDistanceCylinder *> &m_cylinders;
+  const std::vector<vpMbtDistanceCircle *> &m_circles;
+  const std::vector<size_t> &m_bands;
+};
+
+size_t nbSites(const vpMeTracker *tracker)
+{
+  return tracker != NULL ? tracker->getMeList().size() : 0;
+}
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Track the moving edges in the image.
-  
+
+  The moving edges that have to be initialized are first initialized
+  sequentially. The primitives are then tracked independently from each
+  other: with setNbThreads(), they are split into bands holding about the
+  same number of sites, tracked in parallel by the vpThreadPool.
+
+  Restricted to the INITIALIZED_PRIMITIVES, the current pose is not used:
+  vpMbEdgeKltTracker::track() tracks them while the pose is estimated from
+  the KLT features, then tracks the NEW_PRIMITIVES at that pose.
+
   \param I : the image.
+  \param selection : the primitives to track.
 */
 void
-vpMbEdgeTracker::trackMovingEdge(const vpImage<unsigned char> &I)
+vpMbEdgeTracker::trackMovingEdge(const vpImage<unsigned char> &I, const vpPrimitiveSelection selection)
 {
+  std::vector<vpMbtDistanceLine *> trackedLines;
+  std::vector<vpMbtDistanceCylinder *> trackedCylinders;
+  std::vector<vpMbtDistanceCircle *> trackedCircles;
+  // Number of sites of the primitives, plus one for their fixed cost, used to balance the bands
+  std::vector<size_t> cost;
+
   for(std::list<vpMbtDistanceLine*>::const_iterator it=lines[scaleLevel].begin(); it!=lines[scaleLevel].end(); ++it){
     vpMbtDistanceLine *l = *it;
     if(l->isVisible() && l->isTracked()){
-      if(l->meline.size() == 0){
+      const bool uninitialized = (l->meline.size() == 0);
+      if((selection == INITIALIZED_PRIMITIVES && uninitialized) || (selection == NEW_PRIMITIVES && ! uninitialized))
+        continue;
+      if(uninitialized){
         l->initMovingEdge(I, cMo);
       }
-      l->trackMovingEdge(I, cMo) ;
+      size_t n = 0;
+      for(size_t i = 0; i < l->meline.size(); i++)
+        n += nbSites(l->meline[i]);
+      trackedLines.push_back(l);
+      cost.push_back(1 + n);
     }
   }
 
   for(std::list<vpMbtDistanceCylinder*>::const_iterator it=cylinders[scaleLevel].begin(); it!=cylinders[scaleLevel].end(); ++it){
     vpMbtDistanceCylinder *cy = *it;
     if(cy->isVisible() && cy->isTracked()) {
-        if(cy->meline1 == NULL || cy->meline2 == NULL){
+        const bool uninitialized = (cy->meline1 == NULL || cy->meline2 == NULL);
+        if((selection == INITIALIZED_PRIMITIVES && uninitialized) || (selection == NEW_PRIMITIVES && ! uninitialized))
+          continue;
+        if(uninitialized){
           cy->initMovingEdge(I, cMo);
         }
-        cy->trackMovingEdge(I, cMo) ;
+        trackedCylinders.push_back(cy);
+        cost.push_back(1 + nbSites(cy->meline1) + nbSites(cy->meline2));
     }
   }
 
   for(std::list<vpMbtDistanceCircle*>::const_iterator it=circles[scaleLevel].begin(); it!=circles[scaleLevel].end(); ++it){
     vpMbtDistanceCircle *ci = *it;
     if(ci->isVisible() && ci->isTracked()){
-      if(ci->meEllipse == NULL){
+      const bool uninitialized = (ci->meEllipse == NULL);
+      if((selection == INITIALIZED_PRIMITIVES && uninitialized) || (selection == NEW_PRIMITIVES && ! uninitialized))
+        continue;
+      if(uninitialized){
         ci->initMovingEdge(I, cMo);
       }
-      ci->trackMovingEdge(I, cMo) ;
+      trackedCircles.push_back(ci);
+      cost.push_back(1 + nbSites(ci->meEllipse));
     }
   }
+
+  if (cost.empty())
+    return;
+
+  // Split the primitives into bands of about the same number of sites
+  unsigned int nbBands = vpMath::minimum(m_nbThreads, (unsigned int)cost.size());
+  size_t total = 0;
+  for(size_t k = 0; k < cost.size(); k++)
+    total += cost[k];
+  std::vector<size_t> bands(nbBands + 1, cost.size());
+  bands[0] = 0;
+  size_t sum = 0, k = 0;
+  for(unsigned int b = 1; b < nbBands; b++) {
+    while (k < cost.size() && sum * nbBands < total * b)
+      sum += cost[k++];
+    bands[b] = k;
+  }
+
+  vpMbtTrackMovingEdgeTask task(I, cMo, trackedLines, trackedCylinders, trackedCircles, bands);
+  vpThreadPool::getInstance().parallelFor(0, nbBands, task, 1, nbBands);
 }
 
 
@@ -2785,52 +3220,62 @@ vpMbEdgeTracker::setClipping(const unsigned int &flags)
 }
 
 /*!
-  Compute the pyramid of image associated to the image in parameter. The scales 
-  computed are the ones corresponding to the scales  attribute of the class. If 
-  OpenCV is detected, the functions used to computed a smoothed pyramid come 
-  from OpenCV, otherwise a simple subsampling (no smoothing, no interpolation) 
-  is realized. 
-  
-  \warning The pyramid contains pointers to vpImage. To properly deallocate the
-  pyramid. All the element but the first (which is a pointer to the input image)
-  must be freed. A proper cleaning is implemented in the cleanPyramid() method. 
-  
+  Compute the pyramid of image associated to the image in parameter. The scales
+  computed are the ones corresponding to the scales  attribute of the class. The
+  levels are obtained by a simple subsampling (no smoothing, no interpolation)
+  and stored in buffers kept across the frames.
+
+  If a pyramid was given with setImagePyramid(), it is used instead when it was
+  built from \e _I, with enough levels, since its last use by the tracker.
+
   \param _I : The input image.
   \param _pyramid : The pyramid of image to build from the input image.
 */
-void 
+void
 vpMbEdgeTracker::initPyramid(const vpImage<unsigned char>& _I, std::vector< const vpImage<unsigned char>* >& _pyramid)
 {
-  _pyramid.resize(scales.size());
-  
-  if(scales[0]){
-    _pyramid[0] = &_I;
+  unsigned int nbLevels = 1;
+  for (unsigned int i = 1; i < scales.size(); i += 1){
+    if(scales[i]){
+      nbLevels = i + 1;
+    }
+  }
+
+  // A shared pyramid built from another image, or from the same image at a
+  // previous frame, is not used
+  const vpImagePyramid *imagePyramid = m_sharedImagePyramid;
+  if(imagePyramid == NULL || imagePyramid->getBaseImage() != &_I || imagePyramid->getNbLevels() < nbLevels
+     || imagePyramid->getBuildCount() == m_sharedImagePyramidBuildCount){
+    m_imagePyramid.build(_I, nbLevels);
+    imagePyramid = &m_imagePyramid;
   }
   else{
-    _pyramid[0] = NULL;
+    m_sharedImagePyramidBuildCount = imagePyramid->getBuildCount();
   }
-  
-  for(unsigned int i=1; i<_pyramid.size(); i += 1){
+
+  initPyramid(*imagePyramid, _pyramid);
+  if(scales[0]){
+    _pyramid[0] = &_I;
+  }
+}
+
+/*!
+  Fill the pyramid of image with pointers to the levels of an image pyramid
+  already built. The levels that are not used according to the scales
+  attribute of the class are set to NULL.
+
+  \param _imagePyramid : Image pyramid with at least as many levels as the
+  scales attribute.
+  \param _pyramid : The pyramid of image pointing to the levels of \e _imagePyramid.
+*/
+void
+vpMbEdgeTracker::initPyramid(const vpImagePyramid& _imagePyramid, std::vector< const vpImage<unsigned char>* >& _pyramid)
+{
+  _pyramid.resize(scales.size());
+
+  for(unsigned int i=0; i<_pyramid.size(); i += 1){
     if(scales[i]){
-      unsigned int cScale = static_cast<unsigned int>(pow(2., (int)i));
-      vpImage<unsigned char>* I = new vpImage<unsigned char>(_I.getHeight() / cScale, _I.getWidth() / cScale);
-#if (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION < 0x020408))
-      IplImage* vpI0 = cvCreateImageHeader(cvSize((int)_I.getWidth(), (int)_I.getHeight()), IPL_DEPTH_8U, 1);
-      vpI0->imageData = (char*)(_I.bitmap);
-      IplImage* vpI = cvCreateImage(cvSize((int)(_I.getWidth() / cScale), (int)(_I.getHeight() / cScale)), IPL_DEPTH_8U, 1);
-      cvResize(vpI0, vpI, CV_INTER_NN);
-      vpImageConvert::convert(vpI, *I);
-      cvReleaseImage(&vpI);  
-      vpI0->imageData = NULL;
-      cvReleaseImageHeader(&vpI0);    
-#else
-      for (unsigned int k = 0, ii = 0; k < I->getHeight(); k += 1, ii += cScale){
-        for (unsigned int l = 0, jj = 0; l < I->getWidth(); l += 1, jj += cScale){
-          (*I)[k][l] = _I[ii][jj];
-        }
-      }
-#endif   
-      _pyramid[i] = I;
+      _pyramid[i] = &_imagePyramid[i];
     }
     else{
       _pyramid[i] = NULL;
@@ -2839,24 +3284,51 @@ vpMbEdgeTracker::initPyramid(const vpImage<unsigned char>& _I, std::vector< cons
 }
 
 /*!
-  Clean the pyramid of image allocated with the initPyramid() method. The vector
-  has a size equal to zero at the end of the method. 
-  
+  Clean the pyramid of image filled with the initPyramid() method. The vector
+  has a size equal to zero at the end of the method. The levels themselves are
+  kept by the image pyramid for the next frame.
+
   \param _pyramid : The pyramid of image to clean.
 */
-void 
+void
 vpMbEdgeTracker::cleanPyramid(std::vector< const vpImage<unsigned char>* >& _pyramid)
 {
-  if(_pyramid.size() > 0){
-    _pyramid[0] = NULL;
-    for (unsigned int i = 1; i < _pyramid.size(); i += 1){
-      if(_pyramid[i] != NULL){
-        delete _pyramid[i];
-        _pyramid[i] = NULL;
-      }
-    }
-    _pyramid.resize(0);
+  _pyramid.resize(0);
+}
+
+/*!
+  Use an image pyramid built by the caller for the next calls to track(),
+  instead of the pyramid computed by the tracker. This avoids to compute the
+  pyramid of the same image several times when it is processed by several
+  trackers. The pyramid is only used when it was built from the image given to
+  track(), with at least as many levels as given to setScales(), and when it
+  was built again since its last use by the tracker. Otherwise, for instance
+  when the pyramid was not built for the current frame, the tracker computes
+  its own pyramid.
+
+  The tracker computes its pyramid by subsampling the image, while a pyramid
+  of type vpImagePyramid::GAUSSIAN can also be shared with a vpTemplateTracker.
+
+  \code
+  vpImagePyramid pyramid(vpImagePyramid::SUBSAMPLING);
+  tracker1.setImagePyramid(&pyramid);
+  tracker2.setImagePyramid(&pyramid);
+  for (;;) { // For each frame
+    pyramid.build(I, 3);
+    tracker1.track(I);
+    tracker2.track(I);
   }
+  \endcode
+
+  \param pyramid : Pyramid of the images given to track(). It has to be built
+  before each call to track() and to outlive the tracker. NULL to come back to
+  the pyramid computed by the tracker.
+*/
+void
+vpMbEdgeTracker::setImagePyramid(const vpImagePyramid *pyramid)
+{
+  m_sharedImagePyramid = pyramid;
+  m_sharedImagePyramidBuildCount = 0;
 }
 
 /*!
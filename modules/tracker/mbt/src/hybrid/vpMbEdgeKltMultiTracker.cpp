@@ -46,6 +46,7 @@
 
 #if (defined(VISP_HAVE_OPENCV) && (VISP_HAVE_OPENCV_VERSION >= 0x020100))
 
+#include <visp3/core/vpNormalEquationSolver.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/core/vpVelocityTwistMatrix.h>
 #include <visp3/mbt/vpMbEdgeKltMultiTracker.h>
@@ -240,9 +241,6 @@ void vpMbEdgeKltMultiTracker::computeVVS(std::map<std::string, const vpImage<uns
   vpColVector v;
   vpHomography H;
 
-  vpMatrix LTL;
-  vpColVector LTR;
-
   while( ((int)((residu - residu_1)*1e8) !=0 )  && (iter<maxIter) ){
     L = new vpMatrix();
     R = new vpColVector();
@@ -450,16 +448,14 @@ void vpMbEdgeKltMultiTracker::computeVVS(std::map<std::string, const vpImage<uns
       residu = sqrt(num/den);
 
       if(isoJoIdentity) {
-        LTL = L->AtA();
-        computeJTR(*L, *R, LTR);
+        vpNormalEquationSolver solver;
+        solver.addRows(*L, *R);
 
         switch(m_optimizationMethod) {
         case vpMbTracker::LEVENBERG_MARQUARDT_OPT:
         {
-          vpMatrix LMA(LTL.getRows(), LTL.getCols());
-          LMA.eye();
-          vpMatrix LTLmuI = LTL + (LMA*mu);
-          v = -lambda*LTLmuI.pseudoInverse(LTLmuI.getRows()*std::numeric_limits<double>::epsilon())*LTR;
+          solver.solve(v, mu);
+          v = -lambda*v;
 
           if(iter != 0) {
             mu /= 10.0;
@@ -471,7 +467,8 @@ void vpMbEdgeKltMultiTracker::computeVVS(std::map<std::string, const vpImage<uns
         }
         case vpMbTracker::GAUSS_NEWTON_OPT:
         default:
-          v = -lambda * LTL.pseudoInverse(LTL.getRows()*std::numeric_limits<double>::epsilon()) * LTR;
+          solver.solve(v);
+          v = -lambda*v;
           break;
         }
       }
@@ -479,17 +476,14 @@ void vpMbEdgeKltMultiTracker::computeVVS(std::map<std::string, const vpImage<uns
         vpVelocityTwistMatrix cVo;
         cVo.buildFrom(cMo);
         vpMatrix LVJ = ((*L)*cVo*oJo);
-        vpMatrix LVJTLVJ = (LVJ).AtA();
-        vpColVector LVJTR;
-        computeJTR(LVJ, *R, LVJTR);
+        vpNormalEquationSolver solver;
+        solver.addRows(LVJ, *R);
 
         switch(m_optimizationMethod) {
         case vpMbTracker::LEVENBERG_MARQUARDT_OPT:
         {
-          vpMatrix LMA(LVJTLVJ.getRows(), LVJTLVJ.getCols());
-          LMA.eye();
-          vpMatrix LTLmuI = LVJTLVJ + (LMA*mu);
-          v = -lambda*LTLmuI.pseudoInverse(LTLmuI.getRows()*std::numeric_limits<double>::epsilon())*LVJTR;
+          solver.solve(v, mu);
+          v = -lambda*v;
           v = cVo * v;
 
           if(iter != 0) {
@@ -503,7 +497,8 @@ void vpMbEdgeKltMultiTracker::computeVVS(std::map<std::string, const vpImage<uns
         case vpMbTracker::GAUSS_NEWTON_OPT:
         default:
         {
-          v = -lambda*LVJTLVJ.pseudoInverse(LVJTLVJ.getRows()*std::numeric_limits<double>::epsilon())*LVJTR;
+          solver.solve(v);
+          v = -lambda*v;
           v = cVo * v;
           break;
         }
@@ -1475,43 +1470,53 @@ void vpMbEdgeKltMultiTracker::postTracking(std::map<std::string, const vpImage<u
     }
   }
 
-  //KLT
-  vpMbKltMultiTracker::postTracking(mapOfImages, mapOfNbInfos, w_klt);
+  //KLT: remove the outliers and reinitialize the points if needed
+  std::vector<vpKltCameraJob> kltJobs;
+  unsigned int shift = 0;
+  for(std::map<std::string, vpMbKltTracker *>::const_iterator it = m_mapOfKltTrackers.begin();
+      it != m_mapOfKltTrackers.end(); ++it) {
+    //Set the camera pose
+    it->second->cMo = m_mapOfCameraTransformationMatrix[it->first]*cMo;
+
+    if(mapOfNbInfos[it->first] > 0) {
+      vpKltCameraJob job;
+      job.stage = vpKltCameraJob::POST_TRACKING;
+      job.tracker = it->second;
+      job.I = mapOfImages[it->first];
+      job.nbInfos = mapOfNbInfos[it->first];
+      job.w = &w_klt;
+      job.shift = shift;
+      kltJobs.push_back(job);
+      shift += 2*mapOfNbInfos[it->first];
+    }
+  }
 
-  // Looking for new visible face
-  bool newvisibleface = false;
+  //MBT: look for new visible faces, update the moving edges and compute the projection error
+  std::vector<vpEdgeCameraJob> edgeJobs(m_mapOfEdgeTrackers.size());
+  unsigned int cpt_job = 0;
   for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
-      it != m_mapOfEdgeTrackers.end(); ++it) {
-    it->second->visibleFace(*mapOfImages[it->first], it->second->cMo, newvisibleface);
+      it != m_mapOfEdgeTrackers.end(); ++it, cpt_job++) {
+    edgeJobs[cpt_job].stage = vpEdgeCameraJob::UPDATE;
+    edgeJobs[cpt_job].owner = this;
+    edgeJobs[cpt_job].tracker = it->second;
+    edgeJobs[cpt_job].I = mapOfImages[it->first];
   }
 
-  if(useScanLine) {
-    for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
-                it != m_mapOfEdgeTrackers.end(); ++it) {
-      it->second->faces.computeClippedPolygons(it->second->cMo, it->second->cam);
-      it->second->faces.computeScanLineRender(it->second->cam, mapOfImages[it->first]->getWidth(),
-          mapOfImages[it->first]->getHeight());
-    }
+  //Both features of all the cameras are processed concurrently, or in sequence with Ogre which is not thread safe
+  std::vector<vpThreadPool::vpTask *> tasks;
+  for(size_t i = 0; i < kltJobs.size(); i++) {
+    tasks.push_back(&kltJobs[i]);
   }
-
-  try {
-    for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
-                it != m_mapOfEdgeTrackers.end(); ++it) {
-      it->second->updateMovingEdge(*mapOfImages[it->first]);
-    }
-  } catch(vpException &e) {
-    throw e;
+  for(size_t i = 0; i < edgeJobs.size(); i++) {
+    tasks.push_back(&edgeJobs[i]);
   }
+  runTasks(tasks, useOgre ? 1 : m_nbThreads);
 
-  for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
-      it != m_mapOfEdgeTrackers.end(); ++it) {
-    it->second->initMovingEdge(*mapOfImages[it->first], it->second->cMo);
-
-    // Reinit the moving edge for the lines which need it.
-    it->second->reinitMovingEdge(*mapOfImages[it->first], it->second->cMo);
-
-    if(computeProjError) {
-      it->second->computeProjectionError(*mapOfImages[it->first]);
+  std::map<std::string, vpMbKltTracker *>::const_iterator it_ref = m_mapOfKltTrackers.find(m_referenceCameraName);
+  for(size_t i = 0; i < kltJobs.size(); i++) {
+    //set ctTc0 to identity
+    if(kltJobs[i].reinitialised && it_ref != m_mapOfKltTrackers.end() && kltJobs[i].tracker == it_ref->second) {
+      reinit(/*mapOfImages[it->first]*/);
     }
   }
 }
@@ -2181,16 +2186,45 @@ void vpMbEdgeKltMultiTracker::track(std::map<std::string, const vpImage<unsigned
   std::map<std::string, unsigned int> mapOfNbInfos;
   std::map<std::string, unsigned int> mapOfNbFaceUsed;
 
-  try {
-    vpMbKltMultiTracker::preTracking(mapOfImages, mapOfNbInfos, mapOfNbFaceUsed);
-  } catch(/*vpException &e*/...) {
-//    std::cerr << "Catch an exception in vpMbKltMultiTracker::preTracking: " << e.what() << std::endl;
+  //KLT: track the KLT points, the exceptions are ignored
+  std::vector<vpKltCameraJob> kltJobs(m_mapOfKltTrackers.size());
+  unsigned int cpt_job = 0;
+  for(std::map<std::string, vpMbKltTracker*>::const_iterator it = m_mapOfKltTrackers.begin();
+      it != m_mapOfKltTrackers.end(); ++it, cpt_job++) {
+    kltJobs[cpt_job].stage = vpKltCameraJob::PRE_TRACKING;
+    kltJobs[cpt_job].tracker = it->second;
+    kltJobs[cpt_job].I = mapOfImages[it->first];
   }
 
-  vpColVector w_klt;
-
   //MBT: track moving edges
-  trackMovingEdges(mapOfImages);
+  std::vector<vpEdgeCameraJob> edgeJobs(m_mapOfEdgeTrackers.size());
+  cpt_job = 0;
+  for(std::map<std::string, vpMbEdgeTracker*>::const_iterator it = m_mapOfEdgeTrackers.begin();
+      it != m_mapOfEdgeTrackers.end(); ++it, cpt_job++) {
+    edgeJobs[cpt_job].stage = vpEdgeCameraJob::MOVING_EDGE;
+    edgeJobs[cpt_job].owner = this;
+    edgeJobs[cpt_job].tracker = it->second;
+    edgeJobs[cpt_job].I = mapOfImages[it->first];
+  }
+
+  //The KLT points and the moving edges of all the cameras only meet in the VVS: they are tracked concurrently
+  std::vector<vpThreadPool::vpTask *> tasks;
+  for(size_t i = 0; i < kltJobs.size(); i++) {
+    tasks.push_back(&kltJobs[i]);
+  }
+  for(size_t i = 0; i < edgeJobs.size(); i++) {
+    tasks.push_back(&edgeJobs[i]);
+  }
+  runTasks(tasks, m_nbThreads);
+
+  cpt_job = 0;
+  for(std::map<std::string, vpMbKltTracker*>::const_iterator it = m_mapOfKltTrackers.begin();
+      it != m_mapOfKltTrackers.end(); ++it, cpt_job++) {
+    mapOfNbInfos[it->first] = kltJobs[cpt_job].nbInfos;
+    mapOfNbFaceUsed[it->first] = kltJobs[cpt_job].nbFaceUsed;
+  }
+
+  vpColVector w_klt;
 
   vpColVector w_mbt;
   std::map<std::string, unsigned int> mapOfNumberOfRows;
@@ -2237,16 +2271,17 @@ unsigned int vpMbEdgeKltMultiTracker::trackFirstLoop(std::map<std::string, const
 }
 
 void vpMbEdgeKltMultiTracker::trackMovingEdges(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages) {
+  //Track moving edges of all the cameras concurrently
+  std::vector<vpEdgeCameraJob> jobs(m_mapOfEdgeTrackers.size());
+  unsigned int cpt_job = 0;
   for(std::map<std::string, vpMbEdgeTracker *>::const_iterator it1 = m_mapOfEdgeTrackers.begin();
-      it1 != m_mapOfEdgeTrackers.end(); ++it1) {
-    //Track moving edges
-    try {
-      it1->second->trackMovingEdge(*mapOfImages[it1->first]);
-    } catch(...) {
-      std::cerr << "Error in moving edge tracking" << std::endl;
-      throw ;
-    }
+      it1 != m_mapOfEdgeTrackers.end(); ++it1, cpt_job++) {
+    jobs[cpt_job].owner = this;
+    jobs[cpt_job].tracker = it1->second;
+    jobs[cpt_job].I = mapOfImages[it1->first];
   }
+
+  vpMbEdgeMultiTracker::runCameraJobs(jobs, vpEdgeCameraJob::MOVING_EDGE, m_nbThreads);
 }
 
 #elif !defined(VISP_BUILD_SHARED_LIBS)
@@ -39,7 +39,9 @@
 //#define VP_DEBUG_MODE 1 // Activate debug level 1
 
 #include <visp3/core/vpDebug.h>
+#include <visp3/core/vpImageConvert.h>
 #include <visp3/mbt/vpMbEdgeKltTracker.h>
+#include <visp3/core/vpNormalEquationSolver.h>
 #include <visp3/core/vpTrackingException.h>
 #include <visp3/core/vpVelocityTwistMatrix.h>
 
@@ -388,7 +390,6 @@ vpMbEdgeKltTracker::postTracking(const vpImage<unsigned char>& I, vpColVector &w
   bool reInit = vpMbKltTracker::postTracking(I, w_klt);
 
   if(useScanLine){
-    cam.computeFov(I.getWidth(), I.getHeight());
     faces.computeClippedPolygons(cMo,cam);
     faces.computeScanLineRender(cam, I.getWidth(), I.getHeight());
   }
@@ -620,8 +621,6 @@ vpMbEdgeKltTracker::computeVVS(const vpImage<unsigned char>& I, const unsigned i
   vpRobust robust_mbt(0), robust_klt(0);
   vpHomography H;
 
-  vpMatrix LTL;
-  vpColVector LTR;
   
   double factorMBT = 1.0;
   double factorKLT = 1.0;
@@ -791,16 +790,14 @@ vpMbEdgeKltTracker::computeVVS(const vpImage<unsigned char>& I, const unsigned i
       residu = sqrt(num/den);
 
       if(isoJoIdentity){
-          LTL = L->AtA();
-          computeJTR(*L, *R, LTR);
+          vpNormalEquationSolver solver;
+          solver.addRows(*L, *R);
 
           switch(m_optimizationMethod){
           case vpMbTracker::LEVENBERG_MARQUARDT_OPT:
           {
-            vpMatrix LMA(LTL.getRows(), LTL.getCols());
-            LMA.eye();
-            vpMatrix LTLmuI = LTL + (LMA*mu);
-            v = -lambda*LTLmuI.pseudoInverse(LTLmuI.getRows()*std::numeric_limits<double>::epsilon())*LTR;
+            solver.solve(v, mu);
+            v = -lambda*v;
 
             if(iter != 0)
               mu /= 10.0;
@@ -811,24 +808,22 @@ vpMbEdgeKltTracker::computeVVS(const vpImage<unsigned char>& I, const unsigned i
           }
           case vpMbTracker::GAUSS_NEWTON_OPT:
           default:
-            v = -lambda * LTL.pseudoInverse(LTL.getRows()*std::numeric_limits<double>::epsilon()) * LTR;
+            solver.solve(v);
+            v = -lambda*v;
           }
       }
       else{
           vpVelocityTwistMatrix cVo;
           cVo.buildFrom(cMo);
           vpMatrix LVJ = ((*L)*cVo*oJo);
-          vpMatrix LVJTLVJ = (LVJ).AtA();
-          vpColVector LVJTR;
-          computeJTR(LVJ, *R, LVJTR);
+          vpNormalEquationSolver solver;
+          solver.addRows(LVJ, *R);
 
           switch(m_optimizationMethod){
           case vpMbTracker::LEVENBERG_MARQUARDT_OPT:
           {
-            vpMatrix LMA(LVJTLVJ.getRows(), LVJTLVJ.getCols());
-            LMA.eye();
-            vpMatrix LTLmuI = LVJTLVJ + (LMA*mu);
-            v = -lambda*LTLmuI.pseudoInverse(LTLmuI.getRows()*std::numeric_limits<double>::epsilon())*LVJTR;
+            solver.solve(v, mu);
+            v = -lambda*v;
             v = cVo * v;
 
             if(iter != 0)
@@ -841,7 +836,8 @@ vpMbEdgeKltTracker::computeVVS(const vpImage<unsigned char>& I, const unsigned i
           case vpMbTracker::GAUSS_NEWTON_OPT:
           default:
           {
-            v = -lambda*LVJTLVJ.pseudoInverse(LVJTLVJ.getRows()*std::numeric_limits<double>::epsilon())*LVJTR;
+            solver.solve(v);
+            v = -lambda*v;
             v = cVo * v;
             break;
           }
@@ -877,6 +873,15 @@ vpMbEdgeKltTracker::computeVVS(const vpImage<unsigned char>& I, const unsigned i
 /*!
   Realize the tracking of the object in the image.
 
+  The grey image of the KLT tracker and the field of view of the camera are
+  computed once per frame and shared by both halves of the tracker. The
+  tracking of the KLT features, followed by a first pose estimation from the
+  features only, and the tracking of the moving edges are independent until
+  the joint virtual visual servoing: they are run concurrently when
+  setNbThreads() allows more than one thread. The moving edges that have to
+  be initialized are then initialized and tracked at the pose estimated from
+  the KLT features, whatever the number of threads.
+
   \throw vpException : if the tracking is supposed to have failed.
 
   \param I : the input image.
@@ -884,29 +889,30 @@ vpMbEdgeKltTracker::computeVVS(const vpImage<unsigned char>& I, const unsigned i
 void
 vpMbEdgeKltTracker::track(const vpImage<unsigned char>& I)
 { 
-  unsigned int nbInfos  = 0;
-  unsigned int nbFaceUsed = 0;
-  vpColVector w_klt;
-
-  try{
-    vpMbKltTracker::preTracking(I, nbInfos, nbFaceUsed);
-  }
-  catch(...){}
-  
-  if(nbInfos >= 4)
-    vpMbKltTracker::computeVVS(nbInfos, w_klt);
-  else{
-    nbInfos = 0;
-    // std::cout << "[Warning] Unable to init with KLT" << std::endl;
-  }
-  
-  vpMbEdgeTracker::trackMovingEdge(I);
+  // Per frame preprocessing shared by the KLT and moving-edge halves
+  vpImageConvert::convert(I, cur);
+  cam.computeFov(I.getWidth(), I.getHeight());
+
+  vpHalfTrackingJob kltJob(this, vpHalfTrackingJob::KLT, I);
+  vpHalfTrackingJob edgeJob(this, vpHalfTrackingJob::MOVING_EDGE, I);
+  std::vector<vpThreadPool::vpTask *> tasks;
+  tasks.push_back(&kltJob);
+  tasks.push_back(&edgeJob);
+  runTasks(tasks, m_nbThreads);
+
+  // The new moving edges are initialized at the pose given by the KLT half
+  vpMbEdgeTracker::trackMovingEdge(I, NEW_PRIMITIVES);
+
+  unsigned int nbInfos = kltJob.nbInfos;
+  vpColVector &w_klt = kltJob.w;
  
   vpColVector w_mbt;
   computeVVS(I, nbInfos, w_mbt, w_klt);
 
   if(postTracking(I, w_mbt, w_klt)){
-    vpMbKltTracker::reinit(I);
+    // The grey image, the field of view and the scanline rendering at the
+    // final pose are already up to date
+    vpMbKltTracker::reinitKltPoints(I);
     
     // AY : Removed as edge tracked, if necessary, is reinitialized in postTracking()
 
@@ -926,6 +932,36 @@ vpMbEdgeKltTracker::track(const vpImage<unsigned char>& I)
   }
 }
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+vpMbEdgeKltTracker::vpHalfTrackingJob::vpHalfTrackingJob(vpMbEdgeKltTracker *_tracker, const vpHalf _half,
+                                                         const vpImage<unsigned char> &_I)
+  : tracker(_tracker), half(_half), I(&_I), nbInfos(0), w()
+{
+}
+
+void vpMbEdgeKltTracker::vpHalfTrackingJob::run()
+{
+  if(half == KLT){
+    unsigned int nbFaceUsed = 0;
+    try{
+      tracker->vpMbKltTracker::preTracking(nbInfos, nbFaceUsed);
+    }
+    catch(...){}
+
+    if(nbInfos >= 4)
+      tracker->vpMbKltTracker::computeVVS(nbInfos, w);
+    else{
+      nbInfos = 0;
+      // std::cout << "[Warning] Unable to init with KLT" << std::endl;
+    }
+  }
+  else{
+    // The KLT half modifies the current pose concurrently
+    tracker->vpMbEdgeTracker::trackMovingEdge(*I, INITIALIZED_PRIMITIVES);
+  }
+}
+#endif
+
 unsigned int
 vpMbEdgeKltTracker::trackFirstLoop(const vpImage<unsigned char>& I, vpColVector &factor, const unsigned int lvl)
 {
@@ -1559,24 +1559,30 @@ void vpMbKltMultiTracker::loadModel(const std::string &modelFile, const bool ver
 void vpMbKltMultiTracker::preTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
     std::map<std::string, unsigned int> &mapOfNbInfos,
     std::map<std::string, unsigned int> &mapOfNbFaceUsed) {
+  //The KLT points of the cameras are tracked concurrently
+  std::vector<vpKltCameraJob> jobs(m_mapOfKltTrackers.size());
+  unsigned int cpt = 0;
   for(std::map<std::string, vpMbKltTracker*>::const_iterator it = m_mapOfKltTrackers.begin();
-      it != m_mapOfKltTrackers.end(); ++it) {
-    mapOfNbInfos[it->first] = 0;
-    mapOfNbFaceUsed[it->first] = 0;
+      it != m_mapOfKltTrackers.end(); ++it, cpt++) {
+    jobs[cpt].tracker = it->second;
+    jobs[cpt].I = mapOfImages[it->first];
   }
 
-  for (std::map<std::string, vpMbKltTracker*>::const_iterator it =
-      m_mapOfKltTrackers.begin(); it != m_mapOfKltTrackers.end(); ++it) {
-    try {
-      it->second->preTracking(*mapOfImages[it->first], mapOfNbInfos[it->first], mapOfNbFaceUsed[it->first]);
-    } catch (/*vpException &e*/...) {
-//      throw e;
-    }
+  runCameraJobs(jobs, vpKltCameraJob::PRE_TRACKING, m_nbThreads);
+
+  cpt = 0;
+  for(std::map<std::string, vpMbKltTracker*>::const_iterator it = m_mapOfKltTrackers.begin();
+      it != m_mapOfKltTrackers.end(); ++it, cpt++) {
+    mapOfNbInfos[it->first] = jobs[cpt].nbInfos;
+    mapOfNbFaceUsed[it->first] = jobs[cpt].nbFaceUsed;
   }
 }
 
 void vpMbKltMultiTracker::postTracking(std::map<std::string, const vpImage<unsigned char> *> &mapOfImages,
     std::map<std::string, unsigned int> &mapOfNbInfos, vpColVector &w_klt) {
+  //The cameras with KLT points are updated concurrently. Ogre, used by the visibility
+  //test of the reinitialisation, is not thread safe: the cameras are then updated in sequence.
+  std::vector<vpKltCameraJob> jobs;
   unsigned int shift = 0;
   for(std::map<std::string, vpMbKltTracker *>::const_iterator it = m_mapOfKltTrackers.begin();
       it != m_mapOfKltTrackers.end(); ++it) {
@@ -1584,19 +1590,76 @@ void vpMbKltMultiTracker::postTracking(std::map<std::string, const vpImage<unsig
     it->second->cMo = m_mapOfCameraTransformationMatrix[it->first]*cMo;
 
     if(mapOfNbInfos[it->first] > 0) {
-      vpSubColVector sub_w(w_klt, shift, 2*mapOfNbInfos[it->first]);
+      vpKltCameraJob job;
+      job.tracker = it->second;
+      job.I = mapOfImages[it->first];
+      job.nbInfos = mapOfNbInfos[it->first];
+      job.w = &w_klt;
+      job.shift = shift;
+      jobs.push_back(job);
       shift += 2*mapOfNbInfos[it->first];
-      if(it->second->postTracking(*mapOfImages[it->first], sub_w)) {
-        it->second->reinit(*mapOfImages[it->first]);
+    }
+  }
 
-        //set ctTc0 to identity
-        if(it->first == m_referenceCameraName) {
-          reinit(/*mapOfImages[it->first]*/);
-        }
-      }
+  runCameraJobs(jobs, vpKltCameraJob::POST_TRACKING, useOgre ? 1 : m_nbThreads);
+
+  std::map<std::string, vpMbKltTracker *>::const_iterator it_ref = m_mapOfKltTrackers.find(m_referenceCameraName);
+  for(size_t i = 0; i < jobs.size(); i++) {
+    //set ctTc0 to identity
+    if(jobs[i].reinitialised && it_ref != m_mapOfKltTrackers.end() && jobs[i].tracker == it_ref->second) {
+      reinit(/*mapOfImages[it->first]*/);
+    }
+  }
+}
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+vpMbKltMultiTracker::vpKltCameraJob::vpKltCameraJob()
+  : stage(PRE_TRACKING), tracker(NULL), I(NULL), nbInfos(0), nbFaceUsed(0), w(NULL), shift(0), reinitialised(false)
+{
+}
+
+void vpMbKltMultiTracker::vpKltCameraJob::run()
+{
+  switch(stage) {
+  case PRE_TRACKING:
+    nbInfos = 0;
+    nbFaceUsed = 0;
+    try {
+      tracker->preTracking(*I, nbInfos, nbFaceUsed);
+    } catch (/*vpException &e*/...) {
+//      throw e;
+    }
+    break;
+
+  case POST_TRACKING: {
+    vpSubColVector sub_w(*w, shift, 2*nbInfos);
+    reinitialised = tracker->postTracking(*I, sub_w);
+    if(reinitialised) {
+      tracker->reinit(*I);
     }
+    break;
   }
+
+  default:
+    break;
+  }
+}
+
+/*!
+  Run the same stage of the jobs of all the cameras with at most \e nbThreads
+  threads, and wait for them.
+*/
+void vpMbKltMultiTracker::runCameraJobs(std::vector<vpKltCameraJob> &jobs, const vpKltCameraJob::vpStage stage,
+    const unsigned int nbThreads) const {
+  std::vector<vpThreadPool::vpTask *> tasks(jobs.size());
+  for(size_t i = 0; i < jobs.size(); i++) {
+    jobs[i].stage = stage;
+    tasks[i] = &jobs[i];
+  }
+
+  runTasks(tasks, nbThreads);
 }
+#endif
 
 /*!
  The parameter is not used.
@@ -38,6 +38,7 @@
 
 #include <visp3/core/vpImageConvert.h>
 #include <visp3/mbt/vpMbKltTracker.h>
+#include <visp3/core/vpNormalEquationSolver.h>
 #include <visp3/core/vpVelocityTwistMatrix.h>
 #include <visp3/core/vpTrackingException.h>
 
@@ -157,9 +158,6 @@ vpMbKltTracker::init(const vpImage<unsigned char>& I)
 void 
 vpMbKltTracker::reinit(const vpImage<unsigned char>& I)
 {
-  c0Mo = cMo;
-  ctTc0.eye();
-
   vpImageConvert::convert(I, cur);
 
   cam.computeFov(I.getWidth(), I.getHeight());
@@ -168,7 +166,26 @@ vpMbKltTracker::reinit(const vpImage<unsigned char>& I)
     faces.computeClippedPolygons(cMo,cam);
     faces.computeScanLineRender(cam, I.getWidth(), I.getHeight());
   }
-  
+
+  reinitKltPoints(I);
+}
+
+/*!
+  Detect new KLT points in the visible faces and take the current pose as the
+  reference pose of the points.
+
+  Unlike reinit(), the grey image \e cur, the field of view of the camera and,
+  when the scanline visibility test is used, the scanline rendering are not
+  computed: they are expected to be up to date with \e I and the current pose.
+
+  \param I : the image.
+*/
+void
+vpMbKltTracker::reinitKltPoints(const vpImage<unsigned char>& I)
+{
+  c0Mo = cMo;
+  ctTc0.eye();
+
   // mask
 #if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
   cv::Mat mask((int)I.getRows(), (int)I.getCols(), CV_8UC1, cv::Scalar(0));
@@ -625,6 +642,20 @@ void
 vpMbKltTracker::preTracking(const vpImage<unsigned char>& I, unsigned int &nbInfos, unsigned int &nbFaceUsed)
 {
   vpImageConvert::convert(I, cur);
+  preTracking(nbInfos, nbFaceUsed);
+}
+
+/*!
+  Achieve the tracking of the KLT features in the grey image \e cur, that has
+  to be already converted from the input image, and associate the features to
+  the faces.
+
+  \param nbInfos : Size of the features.
+  \param nbFaceUsed : Number of face used for the tracking.
+*/
+void
+vpMbKltTracker::preTracking(unsigned int &nbInfos, unsigned int &nbFaceUsed)
+{
   tracker.track(cur);
   
   nbInfos = 0;
@@ -901,16 +932,16 @@ vpMbKltTracker::computeVVSPoseEstimation(const unsigned int iter, vpMatrix &L,
   }
 
   if(isoJoIdentity){
-      LTL = L.AtA();
-      computeJTR(L, R, LTR);
+      vpNormalEquationSolver solver;
+      solver.addRows(L, R);
+      solver.getJTJ(LTL);
+      solver.getJTe(LTR);
 
       switch(m_optimizationMethod){
       case vpMbTracker::LEVENBERG_MARQUARDT_OPT:
       {
-        vpMatrix LMA(LTL.getRows(), LTL.getCols());
-        LMA.eye();
-        vpMatrix LTLmuI = LTL + (LMA*mu);
-        v = -lambda*LTLmuI.pseudoInverse(LTLmuI.getRows()*std::numeric_limits<double>::epsilon())*LTR;
+        solver.solve(v, mu);
+        v = -lambda*v;
 
         if(iter != 0)
           mu /= 10.0;
@@ -920,24 +951,22 @@ vpMbKltTracker::computeVVSPoseEstimation(const unsigned int iter, vpMatrix &L,
       }
       case vpMbTracker::GAUSS_NEWTON_OPT:
       default:
-        v = -lambda * LTL.pseudoInverse(LTL.getRows()*std::numeric_limits<double>::epsilon()) * LTR;
+        solver.solve(v);
+        v = -lambda*v;
       }
   }
   else{
       vpVelocityTwistMatrix cVo;
       cVo.buildFrom(cMo);
       vpMatrix LVJ = (L*cVo*oJo);
-      vpMatrix LVJTLVJ = (LVJ).AtA();
-      vpColVector LVJTR;
-      computeJTR(LVJ, R, LVJTR);
+      vpNormalEquationSolver solver;
+      solver.addRows(LVJ, R);
 
       switch(m_optimizationMethod){
       case vpMbTracker::LEVENBERG_MARQUARDT_OPT:
       {
-        vpMatrix LMA(LVJTLVJ.getRows(), LVJTLVJ.getCols());
-        LMA.eye();
-        vpMatrix LTLmuI = LVJTLVJ + (LMA*mu);
-        v = -lambda*LTLmuI.pseudoInverse(LTLmuI.getRows()*std::numeric_limits<double>::epsilon())*LVJTR;
+        solver.solve(v, mu);
+        v = -lambda*v;
         v = cVo * v;
 
         if(iter != 0)
@@ -949,7 +978,8 @@ vpMbKltTracker::computeVVSPoseEstimation(const unsigned int iter, vpMatrix &L,
       case vpMbTracker::GAUSS_NEWTON_OPT:
       default:
       {
-        v = -lambda*LVJTLVJ.pseudoInverse(LVJTLVJ.getRows()*std::numeric_limits<double>::epsilon())*LVJTR;
+        solver.solve(v);
+        v = -lambda*v;
         v = cVo * v;
         break;
       }
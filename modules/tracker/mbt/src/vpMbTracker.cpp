@@ -119,6 +119,24 @@ struct PolygonFaceInfo {
   vpPolygon polygon;
   std::vector<vpPoint> faceCorners;
 };
+
+/*!
+  Range of the tasks given to vpMbTracker::runTasks().
+ */
+class vpMbtTaskRange : public vpThreadPool::vpRangeTask
+{
+public:
+  vpMbtTaskRange(const std::vector<vpThreadPool::vpTask *> &tasks) : m_tasks(tasks) {}
+
+  void run(unsigned int begin, unsigned int end)
+  {
+    for (unsigned int i = begin; i < end; i++)
+      m_tasks[i]->run();
+  }
+
+private:
+  const std::vector<vpThreadPool::vpTask *> &m_tasks;
+};
 #endif // DOXYGEN_SHOULD_SKIP_THIS
 
 /*!
@@ -134,7 +152,7 @@ vpMbTracker::vpMbTracker()
   distFarClip(100), clippingFlag(vpPolygon3D::NO_CLIPPING), useOgre(false), ogreShowConfigDialog(false), useScanLine(false),
   nbPoints(0), nbLines(0), nbPolygonLines(0), nbPolygonPoints(0), nbCylinders(0), nbCircles(0),
   useLodGeneral(false), applyLodSettingInConfig(false), minLineLengthThresholdGeneral(50.0),
-  minPolygonAreaThresholdGeneral(2500.0), mapOfParameterNames()
+  minPolygonAreaThresholdGeneral(2500.0), mapOfParameterNames(), m_nbThreads(1)
 {
     oJo.eye();
     //Map used to parse additional information in CAO model files,
@@ -2364,6 +2382,23 @@ vpMbTracker::computeJTR(const vpMatrix& interaction, const vpColVector& error, v
   }
 }
 
+/*!
+  Run the tasks concurrently with at most \e nbThreads threads of the
+  vpThreadPool, and wait for them. With a single thread, the tasks are run in
+  sequence by the calling thread and their exceptions are thrown unchanged;
+  otherwise an exception thrown by a task is thrown again as a vpException
+  once all the tasks are finished.
+
+  \param tasks : Independent tasks, typically one per camera or per subtracker.
+  \param nbThreads : Maximum number of threads, usually m_nbThreads.
+*/
+void
+vpMbTracker::runTasks(const std::vector<vpThreadPool::vpTask *> &tasks, const unsigned int nbThreads) const
+{
+  vpMbtTaskRange range(tasks);
+  vpThreadPool::getInstance().parallelFor(0, (unsigned int)tasks.size(), range, 1, nbThreads);
+}
+
 /*!
   Get a 1x6 vpColVector representing the estimated degrees of freedom.
   vpColVector[0] = 1 if translation on X is estimated, 0 otherwise;
@@ -0,0 +1,232 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the accumulation of the normal equations of the edge tracker.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMbEdgeNormalEquations.cpp
+
+  \brief Test that vpMbEdgeTracker gives the same poses when the rows of the
+  primitives are stacked in an interaction matrix and when they are
+  accumulated in the normal equations (see
+  vpMbEdgeTracker::setNormalEquationsAccumulation()), with 1 and 4 threads,
+  for the Gauss-Newton and the Levenberg-Marquardt optimizations. The box is
+  tracked along a synthetic sequence rendered by the test.
+*/
+
+#include <fstream>
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+#include <visp3/core/vpIoTools.h>
+#include <visp3/core/vpPixelMeterConversion.h>
+#include <visp3/core/vpPoseVector.h>
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/mbt/vpMbEdgeTracker.h>
+
+namespace {
+  // Box [0, 0.165] x [0, 0.068] x [-0.08, 0] of the model
+  const double boxMin[3] = { 0, 0, -0.08 };
+  const double boxMax[3] = { 0.165, 0.068, 0 };
+
+  // Ray cast of the box, whose faces have different gray levels, on a
+  // textured background
+  void render(const vpCameraParameters &cam, const vpHomogeneousMatrix &cMo, vpImage<unsigned char> &I)
+  {
+    vpHomogeneousMatrix oMc = cMo.inverse();
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        double x, y;
+        vpPixelMeterConversion::convertPoint(cam, j, i, x, y);
+        double o[3], d[3];
+        for (unsigned int k = 0; k < 3; k++) {
+          o[k] = oMc[k][3];
+          d[k] = oMc[k][0] * x + oMc[k][1] * y + oMc[k][2];
+        }
+        double t0 = -1e9, t1 = 1e9;
+        int face = -1;
+        bool hit = true;
+        for (unsigned int k = 0; k < 3 && hit; k++) {
+          if (fabs(d[k]) < 1e-12) {
+            hit = (o[k] >= boxMin[k] && o[k] <= boxMax[k]);
+            continue;
+          }
+          double ta = (boxMin[k] - o[k]) / d[k], tb = (boxMax[k] - o[k]) / d[k];
+          int fa = 2 * (int)k, fb = 2 * (int)k + 1;
+          if (ta > tb) {
+            std::swap(ta, tb);
+            std::swap(fa, fb);
+          }
+          if (ta > t0) {
+            t0 = ta;
+            face = fa;
+          }
+          if (tb < t1)
+            t1 = tb;
+          hit = (t0 <= t1);
+        }
+        if (hit && t0 > 0)
+          I[i][j] = (unsigned char)(90 + 30 * face + (i + j) % 3);
+        else
+          I[i][j] = (unsigned char)(30 + (i * 7 + j * 3) % 5);
+      }
+    }
+  }
+
+  vpHomogeneousMatrix groundTruth(unsigned int k)
+  {
+    return vpHomogeneousMatrix(-0.07 + 0.0015 * k, -0.02 + 0.0005 * k, 0.5 - 0.001 * k,
+                               vpMath::rad(-30 + 0.5 * k), vpMath::rad(40 - 1.5 * k), vpMath::rad(10 + 0.3 * k));
+  }
+
+  // Track the box along the sequence and return the pose estimated at each frame
+  std::vector<vpPoseVector> track(const std::string &model, const std::vector<vpImage<unsigned char> > &frames,
+                                  const vpCameraParameters &cam, vpMbTracker::vpMbtOptimizationMethod method,
+                                  bool accumulate, unsigned int nbThreads)
+  {
+    vpMbEdgeTracker tracker;
+    vpMe me;
+    me.setMaskSize(5);
+    me.setMaskNumber(180);
+    me.setRange(8);
+    me.setThreshold(10000);
+    me.setMu1(0.5);
+    me.setMu2(0.5);
+    me.setSampleStep(4);
+    tracker.setMovingEdge(me);
+    tracker.setCameraParameters(cam);
+    tracker.setAngleAppear(vpMath::rad(70));
+    tracker.setAngleDisappear(vpMath::rad(80));
+    tracker.setNearClippingDistance(0.1);
+    tracker.setFarClippingDistance(100.0);
+    tracker.setClipping(tracker.getClipping() | vpMbtPolygon::FOV_CLIPPING);
+    tracker.loadModel(model);
+    tracker.setOptimizationMethod(method);
+    tracker.setNormalEquationsAccumulation(accumulate);
+    tracker.setNbThreads(nbThreads);
+
+    vpHomogeneousMatrix cMo0(-0.066, -0.023, 0.505, vpMath::rad(-28), vpMath::rad(38), vpMath::rad(11));
+    tracker.initFromPose(frames[0], cMo0);
+
+    std::vector<vpPoseVector> poses;
+    for (size_t k = 1; k < frames.size(); k++) {
+      tracker.track(frames[k]);
+      vpHomogeneousMatrix cMo;
+      tracker.getPose(cMo);
+      poses.push_back(vpPoseVector(cMo));
+    }
+    return poses;
+  }
+}
+
+int main()
+{
+  try {
+    // Write the model of the box in a temporary directory
+    std::string username;
+    vpIoTools::getUserName(username);
+#if defined(_WIN32)
+    std::string dirname = "C:/temp/" + username;
+#else
+    std::string dirname = "/tmp/" + username;
+#endif
+    if (vpIoTools::checkDirectory(dirname) == false)
+      vpIoTools::makeDirectory(dirname);
+    const std::string model = dirname + "/testMbEdgeNormalEquations.cao";
+    {
+      std::ofstream f(model.c_str());
+      f << "V1\n"
+           "8\n"
+           "0 0 0\n0 0 -0.08\n0.165 0 -0.08\n0.165 0 0\n"
+           "0.165 0.068 0\n0.165 0.068 -0.08\n0 0.068 -0.08\n0 0.068 0\n"
+           "0\n"
+           "0\n"
+           "6\n"
+           "4 0 1 2 3\n4 1 6 5 2\n4 4 5 6 7\n4 0 3 4 7\n4 5 4 3 2\n4 0 7 6 1\n"
+           "0\n"
+           "0\n";
+    }
+
+    vpThreadPool::getInstance().setNbThreads(4);
+    vpCameraParameters cam(839.2147, 839.44555, 325.66776, 243.69727);
+    const unsigned int nbFrames = 20;
+    std::vector<vpImage<unsigned char> > frames(nbFrames, vpImage<unsigned char>(480, 640));
+    for (unsigned int k = 0; k < nbFrames; k++)
+      render(cam, groundTruth(k), frames[k]);
+
+    const char *methodNames[2] = { "Gauss-Newton", "Levenberg-Marquardt" };
+    const vpMbTracker::vpMbtOptimizationMethod methods[2] = { vpMbTracker::GAUSS_NEWTON_OPT,
+                                                              vpMbTracker::LEVENBERG_MARQUARDT_OPT };
+    for (unsigned int m = 0; m < 2; m++) {
+      // The stacked interaction matrix with 1 thread is the reference
+      std::vector<vpPoseVector> ref = track(model, frames, cam, methods[m], false, 1);
+
+      // The reference has to follow the box
+      vpPoseVector last(groundTruth(nbFrames - 1));
+      for (unsigned int i = 0; i < 6; i++) {
+        if (fabs(ref.back()[i] - last[i]) > (i < 3 ? 5e-3 : vpMath::rad(1))) {
+          std::cerr << methodNames[m] << ": the box is lost, pose " << ref.back().t() << " instead of " << last.t()
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+
+      for (unsigned int c = 0; c < 3; c++) {
+        const bool accumulate = (c != 0);
+        const unsigned int nbThreads = (c == 1) ? 1 : 4;
+        std::vector<vpPoseVector> poses = track(model, frames, cam, methods[m], accumulate, nbThreads);
+        for (size_t k = 0; k < ref.size(); k++) {
+          for (unsigned int i = 0; i < 6; i++) {
+            // The sums are done in another order: the poses only agree within rounding errors
+            if (fabs(poses[k][i] - ref[k][i]) > 1e-6) {
+              std::cerr << methodNames[m] << (accumulate ? ", accumulated" : ", stacked") << ", " << nbThreads
+                        << " thread(s): pose " << poses[k].t() << " at frame " << k + 1 << " instead of "
+                        << ref[k].t() << std::endl;
+              return EXIT_FAILURE;
+            }
+          }
+        }
+        std::cout << methodNames[m] << (accumulate ? ", accumulated" : ", stacked") << ", " << nbThreads
+                  << " thread(s): same poses as the stacked interaction matrix" << std::endl;
+      }
+    }
+
+    vpIoTools::remove(model);
+    std::cout << "All tests succeed" << std::endl;
+    return EXIT_SUCCESS;
+  }
+  catch(vpException &e) {
+    std::cerr << "Catch an exception: " << e.getMessage() << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -45,6 +45,8 @@
 #ifndef vpMe_H
 #define vpMe_H
 
+#include <vector>
+
 #include <visp3/core/vpMatrix.h>
 #include <visp3/core/vpMath.h>
 #include <visp3/core/vpImage.h>
@@ -85,6 +87,10 @@ private:
   //int graph ;
   vpMatrix *mask ; //! Array of matrices defining the different masks (one for every angle step).
 
+private:
+  //! Coefficients of the masks as 16 bits integers, mask after mask and row after row.
+  std::vector<short> int_mask;
+
 public:
   vpMe() ;
   vpMe(const vpMe &me) ;
@@ -104,6 +110,16 @@ public:
   */
   inline vpMatrix* getMask() const { return mask; }
 
+  /*!
+    Get the coefficients of a mask as 16 bits integers, stored row after
+    row. The coefficients of the masks are integers in [-100, 100], so that
+    this is the same mask as getMask()[index].
+
+    \param index : Index of the mask, lower than getMaskNumber().
+    \return Pointer to the getMaskSize() x getMaskSize() coefficients of the mask.
+  */
+  inline const short *getIntMask(unsigned int index) const { return &int_mask[index * mask_size * mask_size]; }
+
   /*!
     Set the number of mask applied to determine the object contour. The number of mask determines the precision of
     the normal of the edge for every sample. If precision is 2deg, then there
@@ -170,8 +170,8 @@ class VISP_EXPORT vpMeNurbs : public vpMeTracker
     /*!
       Enables to set the two thresholds use by the canny detection.
       
-      \param th1 : The first threshold;
-      \param th2 : The second threshold;
+      \param th1 : The lower hysteresis threshold;
+      \param th2 : The upper hysteresis threshold;
     */
     void setCannyThreshold(const double th1, const double th2)
     {
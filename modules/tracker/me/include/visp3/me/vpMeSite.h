@@ -47,6 +47,8 @@
 #ifndef vpMeSite_H
 #define vpMeSite_H
 
+#include <vector>
+
 #include <visp3/core/vpMatrix.h>
 #include <visp3/core/vpImage.h>
 #include <visp3/core/vpDisplay.h>
@@ -109,6 +111,9 @@ private:
   vpMeSiteDisplayType selectDisplay ;
   vpMeSiteState state;
 
+  void trackCandidates(const vpImage<unsigned char>& I, const vpMe *me, const bool test_contraste,
+                       int *convolutions, int *ci, int *cj);
+
 public:
   void init() ;
   void init(double ip, double jp, double alphap) ;
@@ -126,9 +131,26 @@ public:
 
   vpMeSite *getQueryList(const vpImage<unsigned char> &I, const int range) ;
 
+  /*!
+    \class vpTrackBuffer
+    Buffers in which track() stores the candidates along the normal and
+    their convolutions. Owned by the caller and reused from a site to the
+    next one, they avoid any memory allocation in track().
+  */
+  class vpTrackBuffer
+  {
+  public:
+    vpTrackBuffer() : convolutions(), i(), j() {}
+    //! Convolution of each candidate with the mask.
+    std::vector<int> convolutions;
+    //! Pixel coordinates of the candidates.
+    std::vector<int> i, j;
+  };
+
   void track(const vpImage<unsigned char>& im,
 	     const vpMe *me,
 	     const  bool test_contraste=true);
+  void track(const vpImage<unsigned char>& im, const vpMe *me, const bool test_contraste, vpTrackBuffer &buffer);
   
   /*!
     Set the angle of tangent at site
@@ -78,6 +78,8 @@ protected:
   
 protected:
   vpMeSite::vpMeSiteDisplayType selectDisplay ;
+  //! Number of threads used by track()
+  unsigned int nbThreads;
 
 public:
   // Constructor/Destructor
@@ -140,6 +142,20 @@ public:
     \return Moving Edges.
   */
   inline vpMe* getMe(){ return me; }
+
+  /*!
+    Set the number of threads of the vpThreadPool used by track() to
+    track the sites. The sites are tracked independently from each other,
+    so that the result doesn't depend on the number of threads.
+
+    \param nb : Number of threads. Default value is 1.
+  */
+  void setNbThreads(const unsigned int nb) { nbThreads = nb > 0 ? nb : 1; }
+
+  /*!
+    Return the number of threads used by track().
+  */
+  inline unsigned int getNbThreads() const { return nbThreads; }
   
   /*!
     Set the list of moving edges
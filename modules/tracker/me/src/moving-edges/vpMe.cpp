@@ -379,6 +379,11 @@ vpMe::initMask()
 
   calcul_masques(angle, mask_size, mask ) ;
 
+  int_mask.resize(n_mask * mask_size * mask_size) ;
+  for (unsigned int k = 0 ; k < n_mask ; k++)
+    for (unsigned int a = 0 ; a < mask_size ; a++)
+      for (unsigned int b = 0 ; b < mask_size ; b++)
+        int_mask[(k * mask_size + a) * mask_size + b] = (short)mask[k][a][b] ;
 }
 
 
@@ -403,7 +408,7 @@ vpMe::print( )
 vpMe::vpMe()
   : threshold(1500), mu1(0.5), mu2(0.5), min_samplestep(4), anglestep(1), mask_sign(0),
     range(4), sample_step(10), ntotal_sample(0), points_to_track(500), mask_size(5),
-    n_mask(180), strip(2), mask(NULL)
+    n_mask(180), strip(2), mask(NULL), int_mask()
 {
   //ntotal_sample = 0; // not sure that it is used
   //points_to_track = 500; // not sure that it is used
@@ -415,7 +420,7 @@ vpMe::vpMe()
 vpMe::vpMe(const vpMe &me)
   : threshold(1500), mu1(0.5), mu2(0.5), min_samplestep(4), anglestep(1), mask_sign(0),
     range(4), sample_step(10), ntotal_sample(0), points_to_track(500), mask_size(5),
-    n_mask(180), strip(2), mask(NULL)
+    n_mask(180), strip(2), mask(NULL), int_mask()
 {
   *this = me;
 }
@@ -56,14 +56,6 @@
 #include <stdlib.h>
 #include <cmath>    // std::fabs
 #include <limits>   // numeric_limits
-#ifdef VISP_HAVE_OPENCV
-#  if (VISP_HAVE_OPENCV_VERSION >= 0x020101) // Require opencv >= 2.1.1
-//#    include <opencv2/imgproc/imgproc.hpp>
-#    include <opencv2/imgproc/imgproc_c.h>
-#  else
-#    include <cv.h>
-#  endif
-#endif
 
 double computeDelta(double deltai, double deltaj);
 void findAngle(const vpImage<unsigned char> &I, const vpImagePoint &iP,
@@ -580,17 +572,7 @@ vpMeNurbs::seekExtremitiesCanny(const vpImage<unsigned char> & /* I */)
     if( u > 0)
       lastPtInSubIm = nurbs.computeCurvePoint(u);
     
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
-    vpImageFilter::canny(Isub, Isub, 3, cannyTh1, 3);
-#else
-    IplImage* Ip = NULL;
-    vpImageConvert::convert(Isub, Ip);
-    
-    IplImage* dst = cvCreateImage( cvSize((int)Isub.getWidth(), (int)Isub.getHeight()), 8, 1 );
-    cvCanny( Ip, dst, cannyTh1, cannyTh2, 3 );
-    
-    vpImageConvert::convert(dst, Isub);
-#endif
+    vpImageFilter::canny(Isub, Isub, 3, cannyTh1, cannyTh2, 3);
     
     vpImagePoint firstBorder(-1,-1);
     
@@ -599,7 +581,7 @@ vpMeNurbs::seekExtremitiesCanny(const vpImage<unsigned char> & /* I */)
     std::list<vpImagePoint> ip_edges_list;
     if (firstBorder != vpImagePoint(-1, -1))
     {
-      unsigned int dir;
+      unsigned int dir = 0;
       double fi = firstBorder.get_i();
       double fj = firstBorder.get_j();
       double w = Isub.getWidth()-1;
@@ -717,17 +699,7 @@ vpMeNurbs::seekExtremitiesCanny(const vpImage<unsigned char> & /* I */)
     if( u < 1.0)
       lastPtInSubIm = nurbs.computeCurvePoint(u);
     
-#if (VISP_HAVE_OPENCV_VERSION >= 0x020408)
-    vpImageFilter::canny(Isub, Isub, 3, cannyTh1, 3);
-#else
-    IplImage* Ip = NULL;
-    vpImageConvert::convert(Isub, Ip);
-
-    IplImage* dst = cvCreateImage( cvSize((int)Isub.getWidth(), (int)Isub.getHeight()), 8, 1 );
-    cvCanny( Ip, dst, cannyTh1, cannyTh2, 3 );
-
-    vpImageConvert::convert(dst, Isub);
-#endif
+    vpImageFilter::canny(Isub, Isub, 3, cannyTh1, cannyTh2, 3);
     
     vpImagePoint firstBorder(-1,-1);
     
@@ -736,7 +708,7 @@ vpMeNurbs::seekExtremitiesCanny(const vpImage<unsigned char> & /* I */)
     std::list<vpImagePoint> ip_edges_list;
     if (firstBorder != vpImagePoint(-1, -1))
     {
-      unsigned int dir;
+      unsigned int dir = 0;
       double fi = firstBorder.get_i();
       double fj = firstBorder.get_j();
       double w = Isub.getWidth()-1;
@@ -772,13 +744,13 @@ vpMeNurbs::seekExtremitiesCanny(const vpImage<unsigned char> & /* I */)
     {
 //      list.end();
       vpMeSite s;
-      while(true)//{//!list.outside())
+      while(!list.empty())//{//!list.outside())
       {
         s = list.back();//list.value() ;
         vpImagePoint iP(s.ifloat,s.jfloat);
         if (inRectangle(iP,rect))
         {
-          list.erase(list.end()) ;
+          list.pop_back() ;
 //          list.end();
         }
         else
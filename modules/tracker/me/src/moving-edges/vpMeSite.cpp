@@ -48,12 +48,20 @@
 #include <visp3/me/vpMe.h>
 #include <visp3/core/vpTrackingException.h>
 #include <stdlib.h>
+#include <string.h>
 #include <cmath>    // std::fabs
 #include <limits>   // numeric_limits
 #include <visp3/me/vpMeSite.h>
 
+#if defined __SSE2__ || defined _M_X64 || (defined _M_IX86_FP && _M_IX86_FP >= 2)
+#  include <emmintrin.h>
+#  define VISP_HAVE_SSE2 1
+#endif
 
 #ifndef DOXYGEN_SHOULD_SKIP_THIS
+// Largest number of candidates stored on the stack by track()
+static const unsigned int maxStackCandidates = 128;
+
 static
 bool horsImage(int i , int j, int half, int rows, int cols)
 {
@@ -63,6 +71,35 @@ bool horsImage(int i , int j, int half, int rows, int cols)
   //return((i < half + 1) || ( i > (rows - half - 3) )||(j < half + 1) || (j > (cols - half - 3) )) ;
   return( (0 < (half_1 - i) ) || ( (i - rows + half_3) > 0 ) || ( 0 < (half_1 -j) ) || ( (j - cols + half_3)  > 0 ) ) ;
 }
+
+#if VISP_HAVE_SSE2
+// Partial sums of the convolution of the msize x msize window centered on
+// (i, j) with the mask rows padded to 8 coefficients, or 0 if i < 0.
+static inline
+__m128i dotCandidate(const vpImage<unsigned char> &I, int i, int j, int half, unsigned int msize,
+                     const __m128i *maskRows)
+{
+  const __m128i zero = _mm_setzero_si128();
+  __m128i acc = zero;
+  if (i < 0)
+    return acc;
+  const unsigned int first = (unsigned int)(j - half);
+  for (unsigned int a = 0; a < msize; a++) {
+    const unsigned char *row = I[(unsigned int)(i - half) + a] + first;
+    __m128i pixels;
+    if (first + 8 <= I.getWidth())
+      pixels = _mm_loadl_epi64((const __m128i *)row);
+    else {
+      // Don't read past the end of the image
+      unsigned char tail[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+      memcpy(tail, row, msize);
+      pixels = _mm_loadl_epi64((const __m128i *)tail);
+    }
+    acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_unpacklo_epi8(pixels, zero), maskRows[a]));
+  }
+  return acc;
+}
+#endif
 #endif
 
 void
@@ -366,6 +403,17 @@ vpMeSite::convolution(const vpImage<unsigned char>&I, const  vpMe *me)
 
   Specific function for ME.
 
+  Search along the normal to the contour, within +/- vpMe::getRange()
+  pixels, the site whose convolution with the mask is the most likely to
+  be the edge, and move the site to it.
+
+  The candidates are convolved with the 16 bits integer mask of
+  vpMe::getIntMask(), a row of the mask at a time with SSE2 when available,
+  and the convolutions of 4 candidates are summed together. Up to a range
+  of 63 pixels, the candidates are stored on the stack so that no memory is
+  allocated; otherwise see track(const vpImage<unsigned char>&, const vpMe *,
+  const bool, vpTrackBuffer &).
+
   \warning To display the moving edges graphics a call to vpDisplay::flush()
   is needed.
 
@@ -375,152 +423,136 @@ vpMeSite::track(const vpImage<unsigned char>& I,
                 const vpMe *me,
                 const bool test_contraste)
 {
-  //   vpMeSite  *list_query_pixels ;
-  //   int  max_rank =0 ;
-  //   int max_rank1=0 ;
-  //   int max_rank2 = 0;
-  //   double  convolution = 0 ;
-  //   double  max_convolution = 0 ;
-  //   double max = 0 ;
-  //   double contraste = 0;
-  //   //  vpDisplay::display(I) ;
-  //   //  vpERROR_TRACE("getclcik %d",me->getRange()) ;
-  //   //  vpDisplay::getClick(I) ;
-  //
-  //   // range = +/- range of pixels within which the correspondent
-  //   // of the current pixel will be sought
-  //   int range  = me->getRange() ;
-  //
-  //   //  std::cout << i << "  " << j<<"  " << range << "  " << suppress  << std::endl ;
-  //   list_query_pixels = getQueryList(I, range) ;
-  //
-  //   double  contraste_max = 1 + me->getMu2();
-  //   double  contraste_min = 1 - me->getMu1();
-  //
-  //   // array in which likelihood ratios will be stored
-  //   double  *likelihood= new double[ 2 * range + 1 ] ;
-  //
-  //   int ii_1 = i ;
-  //   int jj_1 = j ;
-  //   i_1 = i ;
-  //   j_1 = j ;
-  //   double threshold;
-  //   threshold = me->getThreshold();
-  //
-  //   //    std::cout <<"---------------------"<<std::endl ;
-  //   for(int n = 0 ; n < 2 * range + 1 ; n++)
-  //     {
-  //
-  //       //   convolution results
-  //       convolution = list_query_pixels[n].convolution(I, me) ;
-  //
-  //       // luminance ratio of reference pixel to potential correspondent pixel
-  //       // the luminance must be similar, hence the ratio value should
-  //       // lay between, for instance, 0.5 and 1.5 (parameter tolerance)
-  //       if( test_contraste )
-  // 	{
-  // 	  // Include this to eliminate temporal calculation
-  // 	  if (convlt==0)
-  // 	    {
-  // 	      std::cout << "vpMeSite::track : Division by zero  convlt = 0" << std::endl ;
-  // 	      delete []list_query_pixels ;
-  // 	      delete []likelihood;
-  // 	      throw(vpTrackingException(vpTrackingException::initializationError,
-  // 					"Division by zero")) ;
-  // 	    }
-  //
-  // // 	  contraste = fabs(convolution / convlt) ;
-  // 	  contraste = convolution / convlt ;
-  // 	  // likelihood ratios
-  // 	  if((contraste > contraste_min) && (contraste < contraste_max))
-  // 	    likelihood[n] = fabs(convolution + convlt ) ;
-  // 	  else
-  // 	    likelihood[n] = 0 ;
-  // 	}
-  //       else
-  // 	likelihood[n] = fabs(2*convolution) ;
-  //
-  //
-  //       // establishment of the maximal likelihood ratios's  rank
-  //       // in the array, the value of the likelihood ratio can now be
-  //     // referenced by its rank in the array
-  //     if (likelihood[n] > max)
-  //     {
-  //       max_convolution= convolution;
-  //       max = likelihood[n] ;
-  //       max_rank = n ;
-  //       max_rank2 = max_rank1;
-  //       max_rank1 = max_rank;
-  //     }
-  //
-  //   }
-  //
-  //   // test on the likelihood threshold if threshold==-1 then
-  //   // the me->threshold is  selected
-  //
-  //   vpImagePoint ip;
-  //
-  //   //  if (test_contrast)
-  //   if(max > threshold)
-  //     {
-  //       if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
-  // 	{
-  // 	  ip.set_i( list_query_pixels[max_rank].i );
-  // 	  ip.set_j( list_query_pixels[max_rank].j );
-  // 	  vpDisplay::displayPoint(I, ip, vpColor::red);
-  // 	}
-  //
-  //       *this = list_query_pixels[max_rank] ;//The vpMeSite is replaced by the vpMeSite of max likelihood
-  //       normGradient =  vpMath::sqr(max_convolution);
-  //
-  //       convlt = max_convolution;
-  //       i_1 = ii_1; //list_query_pixels[max_rank].i ;
-  //       j_1 = jj_1; //list_query_pixels[max_rank].j ;
-  //       delete []list_query_pixels ;
-  //       delete []likelihood;
-  //     }
-  //   else //none of the query sites is better than the threshold
-  //     {
-  //       if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
-  // 	{
-  // 	  ip.set_i( list_query_pixels[max_rank].i );
-  // 	  ip.set_j( list_query_pixels[max_rank].j );
-  // 	  vpDisplay::displayPoint(I, ip, vpColor::green);
-  // 	}
-  //       normGradient = 0 ;
-  //       if(max == 0)
-  // 	suppress = 1; // contrast suppression
-  //       else
-  // 	suppress = 2; // threshold suppression
-  //
-  //       delete []list_query_pixels ;
-  //       delete []likelihood; // modif portage
-  //     }
-
-  vpMeSite  *list_query_pixels ;
-  int  max_rank =-1 ;
-  //   int max_rank1=-1 ;
-  //   int max_rank2 = -1;
-  double  max_convolution = 0 ;
-  double max = 0 ;
-  double contraste = 0;
-  //  vpDisplay::display(I) ;
-  //  vpERROR_TRACE("getclcik %d",me->range) ;
-  //  vpDisplay::getClick(I) ;
+  const unsigned int ncand = 2 * me->getRange() + 1;
+  if (ncand <= maxStackCandidates) {
+    int convolutions[maxStackCandidates], ci[maxStackCandidates], cj[maxStackCandidates];
+    trackCandidates(I, me, test_contraste, convolutions, ci, cj);
+  }
+  else {
+    vpTrackBuffer buffer;
+    track(I, me, test_contraste, buffer);
+  }
+}
+
+/*!
+
+  Same as track(const vpImage<unsigned char>&, const vpMe *, const bool),
+  with the candidates stored in \e buffer. Reusing the same buffer for all
+  the sites avoids any memory allocation, whatever the range and the mask
+  size.
+
+*/
+void
+vpMeSite::track(const vpImage<unsigned char>& I, const vpMe *me, const bool test_contraste, vpTrackBuffer &buffer)
+{
+  const unsigned int ncand = 2 * me->getRange() + 1;
+  if (buffer.convolutions.size() < ncand) {
+    buffer.convolutions.resize(ncand);
+    buffer.i.resize(ncand);
+    buffer.j.resize(ncand);
+  }
+  trackCandidates(I, me, test_contraste, &buffer.convolutions[0], &buffer.i[0], &buffer.j[0]);
+}
 
+/*
+  Core of track(). convolutions, ci and cj hold 2 * range + 1 values.
+*/
+void
+vpMeSite::trackCandidates(const vpImage<unsigned char>& I, const vpMe *me, const bool test_contraste,
+                          int *convolutions, int *ci, int *cj)
+{
   // range = +/- range of pixels within which the correspondent
   // of the current pixel will be sought
-  unsigned int range  = me->getRange() ;
+  const int range = (int)me->getRange();
+  const unsigned int ncand = 2 * (unsigned int)range + 1;
+  const unsigned int msize = me->getMaskSize();
+  const int half = (static_cast<int>(msize) - 1) >> 1;
+  const int height_ = static_cast<int>(I.getHeight());
+  const int width_ = static_cast<int>(I.getWidth());
+
+  // Mask of the direction of the normal, the same for all the candidates
+  double theta = alpha+M_PI/2;
+  while (theta<0) theta += M_PI;
+  while (theta>M_PI) theta -= M_PI;
+  int thetadeg = vpMath::round(theta * 180 / M_PI) ;
+  if(abs(thetadeg) == 180 )
+    thetadeg= 0 ;
+  unsigned int index_mask = (unsigned int)(thetadeg/(double)me->getAngleStep());
+  if (index_mask >= me->getMaskNumber())
+    index_mask = me->getMaskNumber() - 1;
+  const short *mask = me->getIntMask(index_mask);
+
+  // Candidates along the normal. The ones outside the image have a null
+  // convolution and are moved to (0, 0), as in convolution()
+  double salpha = sin(alpha);
+  double calpha = cos(alpha);
+  vpImagePoint ip;
+  for (int k = -range; k <= range; k++) {
+    const unsigned int n = (unsigned int)(k + range);
+    double ii = (ifloat+k*salpha);
+    double jj = (jfloat+k*calpha);
+
+    // Display
+    if    ((selectDisplay==RANGE_RESULT)||(selectDisplay==RANGE)) {
+      ip.set_i( ii );
+      ip.set_j( jj );
+      vpDisplay::displayCross(I, ip, 1, vpColor::yellow) ;
+    }
+
+    ci[n] = (int)ii;
+    cj[n] = (int)jj;
+    if (horsImage(ci[n], cj[n], half + me->getStrip(), height_, width_))
+      ci[n] = cj[n] = -1;
+  }
+
+  // Convolutions of the candidates with the mask, as 16 bits dot products
+  unsigned int c = 0;
+#if VISP_HAVE_SSE2
+  if (msize <= 8) {
+    // Rows of the mask padded to 8 coefficients
+    __m128i maskRows[8];
+    for (unsigned int a = 0; a < msize; a++) {
+      short row[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+      for (unsigned int b = 0; b < msize; b++)
+        row[b] = mask[a * msize + b];
+      maskRows[a] = _mm_loadu_si128((const __m128i *)row);
+    }
+    for (; c + 4 <= ncand; c += 4) {
+      __m128i acc[4];
+      for (unsigned int q = 0; q < 4; q++)
+        acc[q] = dotCandidate(I, ci[c + q], cj[c + q], half, msize, maskRows);
+      // Horizontal sums of the 4 accumulators at once
+      __m128i t0 = _mm_add_epi32(_mm_unpacklo_epi32(acc[0], acc[1]), _mm_unpackhi_epi32(acc[0], acc[1]));
+      __m128i t1 = _mm_add_epi32(_mm_unpacklo_epi32(acc[2], acc[3]), _mm_unpackhi_epi32(acc[2], acc[3]));
+      _mm_storeu_si128((__m128i *)(convolutions + c),
+                       _mm_add_epi32(_mm_unpacklo_epi64(t0, t1), _mm_unpackhi_epi64(t0, t1)));
+    }
+  }
+#endif
+  for (; c < ncand; c++) {
+    int conv = 0;
+    if (ci[c] >= 0) {
+      for (unsigned int a = 0; a < msize; a++) {
+        const unsigned char *row = I[(unsigned int)(ci[c] - half) + a] + (cj[c] - half);
+        for (unsigned int b = 0; b < msize; b++)
+          conv += mask[a * msize + b] * row[b];
+      }
+    }
+    convolutions[c] = conv;
+  }
+  for (c = 0; c < ncand; c++) {
+    if (ci[c] < 0)
+      ci[c] = cj[c] = 0;
+  }
 
-  //  std::cout << i << "  " << j<<"  " << range << "  " << suppress  << std::endl ;
-  list_query_pixels = getQueryList(I, (int)range) ;
+  int  max_rank =-1 ;
+  double  max_convolution = 0 ;
+  double max = 0 ;
+  double contraste = 0;
 
   double  contraste_max = 1 + me->getMu2();
   double  contraste_min = 1 - me->getMu1();
 
-  // array in which likelihood ratios will be stored
-  double  *likelihood= new double[ 2 * range + 1 ] ;
-
   int ii_1 = i ;
   int jj_1 = j ;
   i_1 = i ;
@@ -529,77 +561,76 @@ vpMeSite::track(const vpImage<unsigned char>& I,
   threshold = me->getThreshold() ;
   double diff = 1e6;
 
-  //    std::cout <<"---------------------"<<std::endl ;
-  for(unsigned int n = 0 ; n < 2 * range + 1 ; n++)
+  for(unsigned int n = 0 ; n < ncand ; n++)
   {
     //   convolution results
-    double convolution_ = list_query_pixels[n].convolution(I, me) ;
+    double convolution_ = (double)(mask_sign * convolutions[n]) ;
+    double likelihood;
 
     // luminance ratio of reference pixel to potential correspondent pixel
     // the luminance must be similar, hence the ratio value should
     // lay between, for instance, 0.5 and 1.5 (parameter tolerance)
     if( test_contraste )
     {
-      likelihood[n] = fabs(convolution_ + convlt );
-      if (likelihood[n]> threshold)
+      likelihood = fabs(convolution_ + convlt );
+      if (likelihood> threshold)
       {
         contraste = convolution_ / convlt;
         if((contraste > contraste_min) && (contraste < contraste_max) && fabs(1-contraste) < diff)
         {
           diff = fabs(1-contraste);
           max_convolution= convolution_;
-          max = likelihood[n] ;
+          max = likelihood ;
           max_rank = (int)n ;
-          // 	    max_rank2 = max_rank1;
-          // 	    max_rank1 = max_rank;
         }
       }
     }
 
     else
     {
-      likelihood[n] = fabs(2*convolution_) ;
-      if (likelihood[n] > max  && likelihood[n] > threshold)
+      likelihood = fabs(2*convolution_) ;
+      if (likelihood > max  && likelihood > threshold)
       {
         max_convolution= convolution_;
-        max = likelihood[n] ;
+        max = likelihood ;
         max_rank = (int)n ;
-        //           max_rank2 = max_rank1;
-        //           max_rank1 = max_rank;
       }
     }
   }
-  
-  // test on the likelihood threshold if threshold==-1 then
-  // the me->threshold is  selected
-
-  vpImagePoint ip;
 
-  //  if (test_contrast)
   if(max_rank >= 0)
   {
     if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
     {
-      ip.set_i( list_query_pixels[max_rank].i );
-      ip.set_j( list_query_pixels[max_rank].j );
+      ip.set_i( ci[max_rank] );
+      ip.set_j( cj[max_rank] );
       vpDisplay::displayPoint(I, ip, vpColor::red);
     }
-		
-    *this = list_query_pixels[max_rank] ;//The vpMeSite2 is replaced by the vpMeSite2 of max likelihood
+
+    // The site is replaced by the candidate of max likelihood
+    const int k = max_rank - range;
+    ifloat = ifloat+k*salpha;
+    jfloat = jfloat+k*calpha;
+    i = ci[max_rank];
+    j = cj[max_rank];
+    v = 0;
+    weight = 1;
+    state = NO_SUPPRESSION;
+#ifdef VISP_BUILD_DEPRECATED_FUNCTIONS
+    suppress = 0;
+#endif
     normGradient =  vpMath::sqr(max_convolution);
 
     convlt = max_convolution;
-    i_1 = ii_1; //list_query_pixels[max_rank].i ;
-    j_1 = jj_1; //list_query_pixels[max_rank].j ;
-    delete []list_query_pixels ;
-    delete []likelihood;
+    i_1 = ii_1;
+    j_1 = jj_1;
   }
   else //none of the query sites is better than the threshold
   {
     if ((selectDisplay==RANGE_RESULT)||(selectDisplay==RESULT))
     {
-      ip.set_i( list_query_pixels[0].i );
-      ip.set_j( list_query_pixels[0].j );
+      ip.set_i( ci[0] );
+      ip.set_j( cj[0] );
       vpDisplay::displayPoint(I, ip, vpColor::green);
     }
     normGradient = 0 ;
@@ -608,9 +639,6 @@ vpMeSite::track(const vpImage<unsigned char>& I,
       state = CONSTRAST; // contrast suppression
     else
       state = THRESHOLD; // threshold suppression
-
-    delete []list_query_pixels ;
-    delete []likelihood; // modif portage
   }
 }
 
@@ -47,8 +47,10 @@
 #include <visp3/core/vpColor.h>
 
 #include <visp3/core/vpTrackingException.h>
+#include <visp3/core/vpThreadPool.h>
 #include <visp3/core/vpDebug.h>
 #include <algorithm>
+#include <vector>
 
 #define DEBUG_LEVEL1 0
 #define DEBUG_LEVEL2 0
@@ -62,7 +64,7 @@ vpMeTracker::init()
 }
 
 vpMeTracker::vpMeTracker()
-  : list(), me(NULL), init_range(1), nGoodElement(0), selectDisplay(vpMeSite::NONE)
+  : list(), me(NULL), init_range(1), nGoodElement(0), selectDisplay(vpMeSite::NONE), nbThreads(1)
 #ifdef VISP_BUILD_DEPRECATED_FUNCTIONS
   , query_range (0), display_point(false)
 #endif
@@ -72,7 +74,7 @@ vpMeTracker::vpMeTracker()
 
 vpMeTracker::vpMeTracker(const vpMeTracker& meTracker)
   : vpTracker(meTracker),
-    list(), me(NULL), init_range(1), nGoodElement(0), selectDisplay(vpMeSite::NONE)
+    list(), me(NULL), init_range(1), nGoodElement(0), selectDisplay(vpMeSite::NONE), nbThreads(1)
 #ifdef VISP_BUILD_DEPRECATED_FUNCTIONS
     , query_range (0), display_point(false)
 #endif
@@ -84,6 +86,7 @@ vpMeTracker::vpMeTracker(const vpMeTracker& meTracker)
   nGoodElement = meTracker.nGoodElement;
   init_range = meTracker.init_range;
   selectDisplay = meTracker.selectDisplay;
+  nbThreads = meTracker.nbThreads;
   
   #ifdef VISP_BUILD_DEPRECATED_FUNCTIONS
   display_point = meTracker.display_point;
@@ -111,6 +114,7 @@ vpMeTracker::operator = (vpMeTracker& p_me)
   list = p_me.list;
   me = p_me.me;
   selectDisplay = p_me.selectDisplay ;
+  nbThreads = p_me.nbThreads;
 
   return *this;
 }
@@ -242,9 +246,47 @@ vpMeTracker::initTracking(const vpImage<unsigned char>& I)
   me->setRange(range_tmp);
 }
 
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+namespace
+{
+// Track a range of the sites gathered by vpMeTracker::track()
+class vpMeSiteTrackTask : public vpThreadPool::vpRangeTask
+{
+public:
+  vpMeSiteTrackTask(const vpImage<unsigned char> &I, const vpMe *me, std::vector<vpMeSite *> &sites)
+    : m_I(I), m_me(me), m_sites(sites)
+  {
+  }
+
+  void run(unsigned int begin, unsigned int end)
+  {
+    for (unsigned int k = begin; k < end; k++) {
+      vpMeSite &s = *m_sites[k];
+      try {
+        s.track(m_I, m_me, true);
+      }
+      catch(vpTrackingException &) {
+        vpERROR_TRACE("catch exception ") ;
+        s.setState(vpMeSite::THRESHOLD);
+      }
+    }
+  }
+
+private:
+  const vpImage<unsigned char> &m_I;
+  const vpMe *m_me;
+  std::vector<vpMeSite *> &m_sites;
+};
+}
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
 /*!
   Track moving-edges.
 
+  The sites are tracked independently from each other. With
+  setNbThreads(), they are partitioned across the threads of the
+  vpThreadPool.
+
   \param I : Image.
 
   \exception vpTrackingException::initializationError : Moving edges not initialized.
@@ -267,50 +309,39 @@ vpMeTracker::track(const vpImage<unsigned char>& I)
 
   }
 
-  vpImagePoint ip1, ip2;
-  nGoodElement=0;
-  //  int d =0;
-  // Loop through list of sites to track
+  // Gather the sites that were not suppressed, to partition them across the threads
+  std::vector<vpMeSite *> sites;
+  sites.reserve(list.size());
   for(std::list<vpMeSite>::iterator it=list.begin(); it!=list.end(); ++it){
-    vpMeSite s = *it;//current reference pixel
-
-    //    d++ ;
-    // If element hasn't been suppressed
-    if(s.getState() == vpMeSite::NO_SUPPRESSION)
-    {
+    if(it->getState() == vpMeSite::NO_SUPPRESSION)
+      sites.push_back(&(*it));
+  }
 
-      try{
-        //	vpERROR_TRACE("%d",d ) ;
-        //	vpERROR_TRACE("range %d",me->range) ;
-        s.track(I,me,true);
-      }
-      catch(vpTrackingException)
-      {
-        vpERROR_TRACE("catch exception ") ;
-        s.setState(vpMeSite::THRESHOLD);
-      }
+  vpMeSiteTrackTask task(I, me, sites);
+  vpThreadPool::getInstance().parallelFor(0, (unsigned int)sites.size(), task, 0, nbThreads);
 
-      if(s.getState() != vpMeSite::THRESHOLD)
-      {
-        nGoodElement++;
+  vpImagePoint ip1, ip2;
+  nGoodElement=0;
+  for(size_t k = 0; k < sites.size(); k++){
+    const vpMeSite &s = *sites[k];
+    if(s.getState() != vpMeSite::THRESHOLD)
+    {
+      nGoodElement++;
 
 #if (DEBUG_LEVEL2)
-        {
-          double a,b ;
-          a = s.i_1 - s.i ;
-          b = s.j_1 - s.j ;
-          if(s.getState() == vpMeSite::NO_SUPPRESSION) {
-            ip1.set_i( s.i );
-            ip1.set_j( s.j );
-            ip2.set_i( s.i+a*5 );
-            ip2.set_j( s.j+b*5 );
-            vpDisplay::displayArrow(I, ip1, ip2, vpColor::green) ;
-          }
+      {
+        double a,b ;
+        a = s.i_1 - s.i ;
+        b = s.j_1 - s.j ;
+        if(s.getState() == vpMeSite::NO_SUPPRESSION) {
+          ip1.set_i( s.i );
+          ip1.set_j( s.j );
+          ip2.set_i( s.i+a*5 );
+          ip2.set_j( s.j+b*5 );
+          vpDisplay::displayArrow(I, ip1, ip2, vpColor::green) ;
         }
-#endif
-
       }
-      *it = s;
+#endif
     }
   }
 }
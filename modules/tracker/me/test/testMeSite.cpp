@@ -0,0 +1,235 @@
+/****************************************************************************
+ *
+ * This file is part of the ViSP software.
+ * Copyright (C) 2005 - 2015 by Inria. All rights reserved.
+ *
+ * This software is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * ("GPL") version 2 as published by the Free Software Foundation.
+ * See the file LICENSE.txt at the root directory of this source
+ * distribution for additional information about the GNU GPL.
+ *
+ * For using ViSP with software that can not be combined with the GNU
+ * GPL, please contact Inria about acquiring a ViSP Professional
+ * Edition License.
+ *
+ * See http://visp.inria.fr for more information.
+ *
+ * This software was developed at:
+ * Inria Rennes - Bretagne Atlantique
+ * Campus Universitaire de Beaulieu
+ * 35042 Rennes Cedex
+ * France
+ *
+ * If you have questions regarding the use of this file, please contact
+ * Inria at visp@inria.fr
+ *
+ * This file is provided AS IS with NO WARRANTY OF ANY KIND, INCLUDING THE
+ * WARRANTY OF DESIGN, MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * Description:
+ * Test the search of a moving edge site along its normal.
+ *
+ *****************************************************************************/
+
+/*!
+  \example testMeSite.cpp
+
+  \brief Test vpMeSite::track() against the search of the most likely
+  site among the query list of vpMeSite::getQueryList(), each candidate
+  being convolved with vpMeSite::convolution(). Test also that
+  vpMeTracker::track() gives the same sites with several threads.
+*/
+
+#include <iostream>
+#include <stdlib.h>
+#include <vector>
+
+#include <visp3/core/vpThreadPool.h>
+#include <visp3/core/vpTime.h>
+#include <visp3/me/vpMeSite.h>
+#include <visp3/me/vpMeTracker.h>
+
+namespace {
+  // Search of vpMeSite::track() written with the query list of the site
+  void referenceTrack(vpMeSite &site, const vpImage<unsigned char> &I, const vpMe *me, bool test_contraste)
+  {
+    int range = (int)me->getRange();
+    vpMeSite *list_query_pixels = site.getQueryList(I, range);
+    int max_rank = -1;
+    double max_convolution = 0, max = 0, contraste = 0, diff = 1e6;
+    int ii_1 = site.i, jj_1 = site.j;
+    site.i_1 = site.i;
+    site.j_1 = site.j;
+    for (int n = 0; n < 2 * range + 1; n++) {
+      double convolution = list_query_pixels[n].convolution(I, me);
+      if (test_contraste) {
+        double likelihood = fabs(convolution + site.convlt);
+        if (likelihood > me->getThreshold()) {
+          contraste = convolution / site.convlt;
+          if ((contraste > 1 - me->getMu1()) && (contraste < 1 + me->getMu2()) && fabs(1 - contraste) < diff) {
+            diff = fabs(1 - contraste);
+            max_convolution = convolution;
+            max = likelihood;
+            max_rank = n;
+          }
+        }
+      } else {
+        double likelihood = fabs(2 * convolution);
+        if (likelihood > max && likelihood > me->getThreshold()) {
+          max_convolution = convolution;
+          max = likelihood;
+          max_rank = n;
+        }
+      }
+    }
+    if (max_rank >= 0) {
+      site = list_query_pixels[max_rank];
+      site.normGradient = vpMath::sqr(max_convolution);
+      site.convlt = max_convolution;
+      site.i_1 = ii_1;
+      site.j_1 = jj_1;
+    } else {
+      site.normGradient = 0;
+      site.setState(std::fabs(contraste) > std::numeric_limits<double>::epsilon() ? vpMeSite::CONSTRAST
+                                                                                  : vpMeSite::THRESHOLD);
+    }
+    delete[] list_query_pixels;
+  }
+
+  bool equal(const vpMeSite &a, const vpMeSite &b)
+  {
+    return a.i == b.i && a.j == b.j && a.i_1 == b.i_1 && a.j_1 == b.j_1 && a.ifloat == b.ifloat &&
+           a.jfloat == b.jfloat && a.convlt == b.convlt && a.normGradient == b.normGradient &&
+           a.weight == b.weight && a.alpha == b.alpha && a.getState() == b.getState();
+  }
+
+  // Sites on a circle close to the edge of the disk, with the normal of the circle
+  std::vector<vpMeSite> sites(unsigned int n, double ci, double cj, double radius)
+  {
+    std::vector<vpMeSite> s(n);
+    for (unsigned int k = 0; k < n; k++) {
+      double theta = 2 * M_PI * k / n;
+      double r = radius + 4 * sin(7. * theta);
+      s[k].init(ci + r * sin(theta), cj + r * cos(theta), theta, 0, 1);
+      s[k].setWeight(0.5);
+    }
+    return s;
+  }
+
+  // Tracker of a given list of sites
+  class vpMeSiteSet : public vpMeTracker
+  {
+  public:
+    void display(const vpImage<unsigned char> &, vpColor) {}
+    void sample(const vpImage<unsigned char> &) {}
+  };
+}
+
+int main()
+{
+  try {
+    // A noisy disk whose edge is blurred
+    const double ci = 240, cj = 320, radius = 150;
+    vpImage<unsigned char> I(480, 640);
+    srand(0);
+    for (unsigned int i = 0; i < I.getHeight(); i++) {
+      for (unsigned int j = 0; j < I.getWidth(); j++) {
+        double d = sqrt(vpMath::sqr(i - ci) + vpMath::sqr(j - cj)) - radius;
+        double value = 60 + 140 / (1 + exp(d / 1.5)) + rand() % 20;
+        I[i][j] = (unsigned char)value;
+      }
+    }
+
+    unsigned int ranges[] = {1, 4, 7, 40};
+    unsigned int maskSizes[] = {5, 7, 3};
+    for (unsigned int r = 0; r < 4; r++) {
+      for (unsigned int m = 0; m < 3; m++) {
+        vpMe me;
+        me.setRange(ranges[r]);
+        me.setMaskSize(maskSizes[m]);
+        me.setThreshold(1000);
+        std::vector<vpMeSite> s = sites(1000, ci, cj, radius + 2.5 * ranges[r] / 4);
+        vpMeSite::vpTrackBuffer buffer;
+        // Track twice, without then with the contrast test that uses the convolution of the first track
+        for (unsigned int pass = 0; pass < 2; pass++) {
+          bool test_contraste = (pass == 1);
+          for (unsigned int k = 0; k < s.size(); k++) {
+            vpMeSite expected = s[k], site = s[k], siteBuffer = s[k];
+            referenceTrack(expected, I, &me, test_contraste);
+            site.track(I, &me, test_contraste);
+            siteBuffer.track(I, &me, test_contraste, buffer);
+            if (!equal(site, expected) || !equal(siteBuffer, expected)) {
+              std::cerr << "Site " << k << " with range " << ranges[r] << " and mask size " << maskSizes[m]
+                        << " tracked at (" << site.i << ", " << site.j << ") convolution " << site.convlt
+                        << " instead of (" << expected.i << ", " << expected.j << ") convolution " << expected.convlt
+                        << std::endl;
+              return EXIT_FAILURE;
+            }
+            s[k] = site;
+          }
+        }
+      }
+    }
+    std::cout << "Tracked sites are ok" << std::endl;
+
+    {
+      vpThreadPool::getInstance().setNbThreads(4);
+      vpMe me;
+      me.setRange(7);
+      me.setThreshold(1000);
+      std::vector<vpMeSite> s = sites(1000, ci, cj, radius + 4);
+      s[10].setState(vpMeSite::CONSTRAST);
+      vpMeSiteSet sequential, parallel;
+      sequential.setMe(&me);
+      parallel.setMe(&me);
+      parallel.setNbThreads(4);
+      sequential.setMeList(std::list<vpMeSite>(s.begin(), s.end()));
+      parallel.setMeList(std::list<vpMeSite>(s.begin(), s.end()));
+      for (unsigned int pass = 0; pass < 2; pass++) {
+        sequential.track(I);
+        parallel.track(I);
+        std::list<vpMeSite>::const_iterator it1 = sequential.getMeList().begin();
+        std::list<vpMeSite>::const_iterator it2 = parallel.getMeList().begin();
+        for (; it1 != sequential.getMeList().end(); ++it1, ++it2) {
+          if (!equal(*it1, *it2)) {
+            std::cerr << "Site tracked at (" << it2->i << ", " << it2->j << ") with 4 threads instead of (" << it1->i
+                      << ", " << it1->j << ")" << std::endl;
+            return EXIT_FAILURE;
+          }
+        }
+        if (sequential.getNbPoints() != parallel.getNbPoints()) {
+          std::cerr << parallel.getNbPoints() << " good sites with 4 threads instead of " << sequential.getNbPoints()
+                    << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+      vpThreadPool::getInstance().setNbThreads(0);
+      std::cout << "Sites tracked with 4 threads are ok" << std::endl;
+    }
+
+    vpMe me;
+    me.setRange(7);
+    me.setThreshold(1000);
+    std::vector<vpMeSite> s = sites(3000, ci, cj, radius + 4);
+    const unsigned int niter = 20;
+    double t_reference = 0, t_track = 0;
+    for (unsigned int iter = 0; iter < niter; iter++) {
+      std::vector<vpMeSite> s1 = s, s2 = s;
+      double t = vpTime::measureTimeMs();
+      for (unsigned int k = 0; k < s1.size(); k++)
+        referenceTrack(s1[k], I, &me, false);
+      t_reference += vpTime::measureTimeMs() - t;
+      t = vpTime::measureTimeMs();
+      for (unsigned int k = 0; k < s2.size(); k++)
+        s2[k].track(I, &me, false);
+      t_track += vpTime::measureTimeMs() - t;
+    }
+    std::cout << "3000 sites at range 7: query list " << t_reference / niter << " ms, track " << t_track / niter
+              << " ms" << std::endl;
+    return EXIT_SUCCESS;
+  } catch (const vpException &e) {
+    std::cout << "Catch an exception: " << e << std::endl;
+    return EXIT_FAILURE;
+  }
+}
@@ -50,6 +50,7 @@
 #include <visp3/tt/vpTemplateTrackerZone.h>
 #include <visp3/tt/vpTemplateTrackerWarp.h>
 #include <visp3/core/vpImageFilter.h>
+#include <visp3/core/vpImagePyramid.h>
 
 /*!
   \class vpTemplateTracker
@@ -86,6 +87,8 @@ class VISP_EXPORT vpTemplateTracker
     vpTemplateTrackerZone               *zoneTrackedPyr;
     
     vpImage<unsigned char>     *pyr_IDes;
+    //! Pyramid of the current image, its levels are kept across the frames
+    vpImagePyramid              pyr_I;
     
     vpMatrix                    H;
     vpMatrix                    Hdesire;
@@ -106,6 +109,8 @@ class VISP_EXPORT vpTemplateTracker
     unsigned int                taillef;
     double                     *fgG;
     double                     *fgdG;
+    //! Number of threads used to blur the images and compute their gradients
+    unsigned int                nbFilterThreads;
     double                      ratioPixelIn;
     int                         mod_i;
     int                         mod_j;//variable de sampling de zone de reference
@@ -166,11 +171,11 @@ class VISP_EXPORT vpTemplateTracker
         ptTemplateInit(false), templateSize(0), templateSizePyr(NULL), ptTemplateSelect(NULL),
         ptTemplateSelectPyr(NULL), ptTemplateSelectInit(false), templateSelectSize(0),
         ptTemplateSupp(NULL), ptTemplateSuppPyr(NULL), ptTemplateCompo(NULL), ptTemplateCompoPyr(NULL),
-        zoneTracked(NULL), zoneTrackedPyr(NULL), pyr_IDes(NULL), H(), Hdesire(), HdesirePyr(NULL),
+        zoneTracked(NULL), zoneTrackedPyr(NULL), pyr_IDes(NULL), pyr_I(), H(), Hdesire(), HdesirePyr(NULL),
         HLM(), HLMdesire(), HLMdesirePyr(NULL), HLMdesireInverse(), HLMdesireInversePyr(NULL),
         G(), gain(0), thresholdGradient(0), costFunctionVerification(false),
         blur(false), useBrent(false), nbIterBrent(0), taillef(0), fgG(NULL), fgdG(NULL),
-        ratioPixelIn(0), mod_i(0), mod_j(0), nbParam(), lambdaDep(0), iterationMax(0),
+        nbFilterThreads(1), ratioPixelIn(0), mod_i(0), mod_j(0), nbParam(), lambdaDep(0), iterationMax(0),
         iterationGlobale(0), diverge(false), nbIteration(0), useCompositionnal(false),
         useInverse(false), Warp(NULL), p(), dp(), X1(), X2(), dW(), BI(), dIx(), dIy(), zoneRef_()
     {}
@@ -222,6 +227,12 @@ class VISP_EXPORT vpTemplateTracker
       */
     void    setLambda(double l) { lambdaDep = l ; }
     void    setNbIterBrent(const unsigned int &b){nbIterBrent=b;}
+    /*!
+      Set the number of threads used to blur the images and to compute their
+      gradients. Each thread filters a horizontal band of the image.
+      \param n : Number of threads. By default a single thread is used.
+     */
+    void    setNbFilterThreads(unsigned int n) { nbFilterThreads = n; }
     void    setp(const vpColVector &tp){ p=tp; diverge=false; iterationGlobale=0; }
     /*!
      Set the number of pyramid levels used in the multi-resolution scheme.
@@ -253,13 +264,14 @@ class VISP_EXPORT vpTemplateTracker
     void    setUseBrent(bool b){useBrent = b;}
     
     void    track(const vpImage<unsigned char> &I);
+    void    track(const vpImagePyramid &pyramid);
     void    trackRobust(const vpImage<unsigned char> &I);
     
   protected:
 
     void            computeOptimalBrentGain(const vpImage<unsigned char> &I,vpColVector &tp,double tMI,vpColVector &direction,double &alpha);
     virtual double  getCost(const vpImage<unsigned char> &I, const vpColVector &tp) = 0;
-    void            getGaussianBluredImage(const vpImage<unsigned char> &I){ vpImageFilter::filter(I, BI,fgG,taillef); }
+    void            getGaussianBluredImage(const vpImage<unsigned char> &I){ vpImageFilter::filter(I, BI,fgG,taillef, nbFilterThreads); }
     virtual void    initHessienDesired(const vpImage<unsigned char> &I)=0;
     virtual void    initHessienDesiredPyr(const vpImage<unsigned char> &I);
     virtual void    initPyramidal(unsigned int nbLvl,unsigned int l0);
@@ -267,6 +279,7 @@ class VISP_EXPORT vpTemplateTracker
     virtual void    initTrackingPyr(const vpImage<unsigned char>& I,vpTemplateTrackerZone &zone);
     virtual void    trackNoPyr(const vpImage<unsigned char> &I) = 0;
     virtual void    trackPyr(const vpImage<unsigned char> &I);
+    void            trackPyr(const vpImagePyramid &pyramid);
 };
 #endif
 
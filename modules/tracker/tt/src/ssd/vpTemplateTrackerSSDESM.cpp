@@ -103,9 +103,9 @@ compoInitialised=true;
 void vpTemplateTrackerSSDESM::trackNoPyr(const vpImage<unsigned char> &I)
 {
   if(blur)
-    vpImageFilter::filter(I, BI,fgG,taillef);
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef);
+    vpImageFilter::filter(I, BI,fgG,taillef, nbFilterThreads);
+  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef, nbFilterThreads);
+  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef, nbFilterThreads);
 
   double IW,dIWx,dIWy;
   double Tij;
@@ -51,9 +51,9 @@ vpTemplateTrackerSSDForwardAdditional::vpTemplateTrackerSSDForwardAdditional(vpT
 void vpTemplateTrackerSSDForwardAdditional::trackNoPyr(const vpImage<unsigned char> &I)
 {
   if(blur)
-    vpImageFilter::filter(I, BI,fgG,taillef);
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef);
+    vpImageFilter::filter(I, BI,fgG,taillef, nbFilterThreads);
+  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef, nbFilterThreads);
+  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef, nbFilterThreads);
 
   dW=0;
 
@@ -71,9 +71,9 @@ void vpTemplateTrackerSSDForwardCompositional::trackNoPyr(const vpImage<unsigned
     std::cout<<"Compositionnal tracking no initialised\nUse InitCompo(vpImage<unsigned char> &I) function"<<std::endl;
 
   if(blur)
-    vpImageFilter::filter(I, BI,fgG,taillef);
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef);
+    vpImageFilter::filter(I, BI,fgG,taillef, nbFilterThreads);
+  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef, nbFilterThreads);
+  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef, nbFilterThreads);
 
   dW=0;
 
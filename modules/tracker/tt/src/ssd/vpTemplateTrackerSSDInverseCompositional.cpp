@@ -109,7 +109,7 @@ void vpTemplateTrackerSSDInverseCompositional::initHessienDesired(const vpImage<
 void vpTemplateTrackerSSDInverseCompositional::trackNoPyr(const vpImage<unsigned char> &I)
 {
   if(blur)
-    vpImageFilter::filter(I, BI,fgG,taillef);
+    vpImageFilter::filter(I, BI,fgG,taillef, nbFilterThreads);
 
   vpColVector dpinv(nbParam);
   double IW;
@@ -46,10 +46,10 @@ vpTemplateTracker::vpTemplateTracker(vpTemplateTrackerWarp *_warp)
     ptTemplateSelect(NULL), ptTemplateSelectPyr(NULL), ptTemplateSelectInit(false),
     templateSelectSize(0), ptTemplateSupp(NULL), ptTemplateSuppPyr(NULL),
     ptTemplateCompo(NULL), ptTemplateCompoPyr(NULL), zoneTracked(NULL), zoneTrackedPyr(NULL),
-    pyr_IDes(NULL), H(), Hdesire(), HdesirePyr(), HLM(), HLMdesire(), HLMdesirePyr(),
+    pyr_IDes(NULL), pyr_I(), H(), Hdesire(), HdesirePyr(), HLM(), HLMdesire(), HLMdesirePyr(),
     HLMdesireInverse(), HLMdesireInversePyr(), G(), gain(1.), thresholdGradient(40),
     costFunctionVerification(false), blur(true), useBrent(false), nbIterBrent(3),
-    taillef(7), fgG(NULL), fgdG(NULL), ratioPixelIn(0), mod_i(1), mod_j(1), nbParam(0),
+    taillef(7), fgG(NULL), fgdG(NULL), nbFilterThreads(1), ratioPixelIn(0), mod_i(1), mod_j(1), nbParam(0),
     lambdaDep(0.001), iterationMax(30), iterationGlobale(0), diverge(false), nbIteration(0),
     useCompositionnal(true), useInverse(false), Warp(_warp), p(0), dp(), X1(), X2(),
     dW(), BI(), dIx(), dIy(), zoneRef_()
@@ -112,9 +112,9 @@ void vpTemplateTracker::initTracking(const vpImage<unsigned char>& I, vpTemplate
   vpTemplateTrackerPoint pt;
   //vpTemplateTrackerZPoint ptZ;
   vpImage<double> GaussI ;
-  vpImageFilter::filter(I, GaussI,fgG,taillef);
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef);
+  vpImageFilter::filter(I, GaussI,fgG,taillef, nbFilterThreads);
+  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef, nbFilterThreads);
+  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef, nbFilterThreads);
 
   unsigned int cpt_point=0;
   templateSelectSize=0;
@@ -643,10 +643,13 @@ void vpTemplateTracker::initTrackingPyr(const vpImage<unsigned char>& I,vpTempla
   //creationpyramide de zones et images desiree
   if(nbLvlPyr>1)
   {
+    // Same reduction as the pyramid of the tracked images, see trackPyr()
+    vpImagePyramid pyramid(vpImagePyramid::GAUSSIAN);
+    pyramid.build(pyr_IDes[0], nbLvlPyr);
     for(unsigned int i=1;i<nbLvlPyr;i++)
     {
       zoneTrackedPyr[i]=zoneTrackedPyr[i-1].getPyramidDown();
-      vpImageFilter::getGaussPyramidal(pyr_IDes[i-1],pyr_IDes[i]);
+      pyr_IDes[i]=pyramid[i];
 
       initTracking(pyr_IDes[i],zoneTrackedPyr[i]);
       ptTemplatePyr[i]=ptTemplate;
@@ -778,10 +781,11 @@ void vpTemplateTracker::initHessienDesiredPyr(const vpImage<unsigned char> &I)
 
   if(nbLvlPyr>1)
   {
-    vpImage<unsigned char> Itemp;Itemp=I;
+    vpImagePyramid pyramid(vpImagePyramid::GAUSSIAN);
+    pyramid.build(I, nbLvlPyr);
     for(unsigned int i=1;i<nbLvlPyr;i++)
     {
-      vpImageFilter::getGaussPyramidal(Itemp,Itemp);
+      const vpImage<unsigned char> &Itemp = pyramid[i];
 
       templateSize=templateSizePyr[i];
       ptTemplate=ptTemplatePyr[i];
@@ -821,13 +825,37 @@ void vpTemplateTracker::track(const vpImage<unsigned char> &I)
     trackNoPyr(I);
 }
 
+/*!
+   Track the template on the levels of a pyramid built by the caller, which
+   avoids to compute the pyramid of the same image for each tracked template.
+   \param pyramid: Pyramid of the image to process, of type
+   vpImagePyramid::GAUSSIAN with at least as many levels as given to
+   setPyramidal().
+
+   \exception vpTrackingException::badValue : If the pyramid does not fit the
+   pyramidal parameters of the tracker.
+ */
+void vpTemplateTracker::track(const vpImagePyramid &pyramid)
+{
+  if (nbLvlPyr > 1)
+    trackPyr(pyramid);
+  else
+    trackNoPyr(pyramid[0]);
+}
+
 void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
+{
+  pyr_I.build(I, nbLvlPyr);
+  trackPyr(pyr_I);
+}
+
+void vpTemplateTracker::trackPyr(const vpImagePyramid &pyramid)
 {
   //vpTRACE("trackPyr");
-  vpImage<unsigned char> *pyr_I;
-//  pyr_I=new vpImage<unsigned char>[nbLvlPyr+1]; // Why +1 ?
-  pyr_I=new vpImage<unsigned char>[nbLvlPyr]; // Why +1 ?
-  pyr_I[0]=I;
+  if (pyramid.getType() != vpImagePyramid::GAUSSIAN || pyramid.getNbLevels() < nbLvlPyr) {
+    throw(vpTrackingException(vpTrackingException::badValue,
+                              "The pyramid is not a Gaussian pyramid of %u levels", nbLvlPyr));
+  }
 
   try
   {
@@ -840,7 +868,6 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
     //    p_sauv[0]=p;
         for(unsigned int i=1;i<nbLvlPyr;i++)
         {
-          vpImageFilter::getGaussPyramidal(pyr_I[i-1],pyr_I[i]);
           //test getParamPyramidDown
           /*vpColVector vX_test(2);vX_test[0]=15.;vX_test[1]=30.;
           vpColVector vX_test2(2);
@@ -878,7 +905,7 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
             HLM=HLMdesirePyr[i];
             HLMdesireInverse=HLMdesireInversePyr[i];
     //        zoneTracked=&zoneTrackedPyr[i];
-            trackRobust(pyr_I[i]);
+            trackRobust(pyramid[(unsigned int)i]);
           }
           //std::cout<<"get p up"<<std::endl;
     //      ptemp=p_sauv[i-1];
@@ -900,7 +927,7 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
           HLM=HLMdesirePyr[0];
           HLMdesireInverse=HLMdesireInversePyr[0];
           zoneTracked=&zoneTrackedPyr[0];
-          trackRobust(pyr_I[0]);
+          trackRobust(pyramid[0]);
         }
 
         if (l0Pyr > 0) {
@@ -916,12 +943,10 @@ void vpTemplateTracker::trackPyr(const vpImage<unsigned char> &I)
       else
       {
         //std::cout<<"reviens a tracker de base"<<std::endl;
-        trackRobust(I);
+        trackRobust(pyramid[0]);
       }
-      delete[] pyr_I;
   }
   catch(vpException &e){
-      delete[] pyr_I;
       throw(vpTrackingException(vpTrackingException::badValue, e.getMessage()));
   }
 }
@@ -47,16 +47,16 @@ vpTemplateTrackerZNCCForwardAdditional::vpTemplateTrackerZNCCForwardAdditional(v
 void vpTemplateTrackerZNCCForwardAdditional::initHessienDesired(const vpImage<unsigned char> &I)
 {
   if(blur)
-    vpImageFilter::filter(I, BI,fgG,taillef);
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef);
+    vpImageFilter::filter(I, BI,fgG,taillef, nbFilterThreads);
+  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef, nbFilterThreads);
+  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef, nbFilterThreads);
 
   vpImage<double> dIxx,dIxy,dIyx,dIyy;
-  vpImageFilter::getGradX(dIx, dIxx, fgdG,taillef);
-  vpImageFilter::getGradY(dIx, dIxy, fgdG,taillef);
+  vpImageFilter::getGradX(dIx, dIxx, fgdG,taillef, nbFilterThreads);
+  vpImageFilter::getGradY(dIx, dIxy, fgdG,taillef, nbFilterThreads);
 
-  vpImageFilter::getGradX(dIy, dIyx, fgdG,taillef);
-  vpImageFilter::getGradY(dIy, dIyy, fgdG,taillef);
+  vpImageFilter::getGradX(dIy, dIyx, fgdG,taillef, nbFilterThreads);
+  vpImageFilter::getGradY(dIy, dIyy, fgdG,taillef, nbFilterThreads);
 
   Warp->computeCoeff(p);
   double IW,dIWx,dIWy;
@@ -157,9 +157,9 @@ void vpTemplateTrackerZNCCForwardAdditional::initHessienDesired(const vpImage<un
 void vpTemplateTrackerZNCCForwardAdditional::trackNoPyr(const vpImage<unsigned char> &I)
 {
   if(blur)
-    vpImageFilter::filter(I, BI,fgG,taillef);
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef);
+    vpImageFilter::filter(I, BI,fgG,taillef, nbFilterThreads);
+  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef, nbFilterThreads);
+  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef, nbFilterThreads);
 
   /*vpImage<double> dIxx,dIxy,dIyx,dIyy;
   getGradX(dIx, dIxx, fgdG,taillef);
@@ -51,8 +51,8 @@ vpTemplateTrackerZNCCInverseCompositional::vpTemplateTrackerZNCCInverseCompositi
 void vpTemplateTrackerZNCCInverseCompositional::initCompInverse(const vpImage<unsigned char> &I)
 {
   //std::cout<<"Initialise precomputed value of Compositionnal Inverse"<<std::endl;
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef);
+  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef, nbFilterThreads);
+  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef, nbFilterThreads);
 
   for(unsigned int point=0;point<templateSize;point++)
   {
@@ -79,16 +79,16 @@ void vpTemplateTrackerZNCCInverseCompositional::initHessienDesired(const vpImage
   initCompInverse(I);
 
   if(blur)
-    vpImageFilter::filter(I, BI,fgG,taillef);
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef);
+    vpImageFilter::filter(I, BI,fgG,taillef, nbFilterThreads);
+  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef, nbFilterThreads);
+  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef, nbFilterThreads);
 
   vpImage<double> dIxx,dIxy,dIyx,dIyy;
-  vpImageFilter::getGradX(dIx, dIxx, fgdG,taillef);
-  vpImageFilter::getGradY(dIx, dIxy, fgdG,taillef);
+  vpImageFilter::getGradX(dIx, dIxx, fgdG,taillef, nbFilterThreads);
+  vpImageFilter::getGradY(dIx, dIxy, fgdG,taillef, nbFilterThreads);
 
-  vpImageFilter::getGradX(dIy, dIyx, fgdG,taillef);
-  vpImageFilter::getGradY(dIy, dIyy, fgdG,taillef);
+  vpImageFilter::getGradX(dIy, dIyx, fgdG,taillef, nbFilterThreads);
+  vpImageFilter::getGradY(dIy, dIyy, fgdG,taillef, nbFilterThreads);
 
   Warp->computeCoeff(p);
   double Ic,dIcx=0.,dIcy=0.;
@@ -243,7 +243,7 @@ void vpTemplateTrackerZNCCInverseCompositional::initHessienDesired(const vpImage
 void vpTemplateTrackerZNCCInverseCompositional::trackNoPyr(const vpImage<unsigned char> &I)
 {
   if(blur)
-    vpImageFilter::filter(I, BI,fgG,taillef);
+    vpImageFilter::filter(I, BI,fgG,taillef, nbFilterThreads);
 
   //double erreur=0;
   vpColVector dpinv(nbParam);
@@ -673,7 +673,7 @@ double vpTemplateTrackerMI::getMI(const vpImage<unsigned char> &I,int &nc, const
   double IW;
 
   vpImage<double> GaussI ;
-  vpImageFilter::filter(I, GaussI,fgG,taillef);
+  vpImageFilter::filter(I, GaussI,fgG,taillef, nbFilterThreads);
 
   memset(tPrt, 0, tNcb*tNcb*sizeof(double));
   memset(tPrtD, 0, nc_*nc_*tinfluBspline*sizeof(double));
@@ -792,7 +792,7 @@ double vpTemplateTrackerMI::getMI256(const vpImage<unsigned char> &I, const vpCo
 
   vpImage<double> GaussI ;
   if(blur)
-    vpImageFilter::filter(I, GaussI,fgG,taillef);
+    vpImageFilter::filter(I, GaussI,fgG,taillef, nbFilterThreads);
 
   //Warp->ComputeMAtWarp(tp);
   Warp->computeCoeff(tp);
@@ -74,7 +74,7 @@ void vpTemplateTrackerMIESM::initHessienDesired(const vpImage<unsigned char> &I)
   //erreur=0;
 
   if(blur)
-    vpImageFilter::filter(I, BI,fgG,taillef);
+    vpImageFilter::filter(I, BI,fgG,taillef, nbFilterThreads);
 
   zeroProbabilities();
 
@@ -122,13 +122,13 @@ void vpTemplateTrackerMIESM::initHessienDesired(const vpImage<unsigned char> &I)
   /////////////////////////////////////////////////////////////////////////
   // DIRECT COMPO
 
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef);
+  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef, nbFilterThreads);
+  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef, nbFilterThreads);
   if(ApproxHessian!=HESSIAN_NONSECOND && ApproxHessian!=HESSIAN_0 && ApproxHessian!=HESSIAN_NEW && ApproxHessian!=HESSIAN_YOUCEF)
   {
-    vpImageFilter::getGradX(dIx, d2Ix,fgdG,taillef);
-    vpImageFilter::getGradY(dIx, d2Ixy,fgdG,taillef);
-    vpImageFilter::getGradY(dIy, d2Iy,fgdG,taillef);
+    vpImageFilter::getGradX(dIx, d2Ix,fgdG,taillef, nbFilterThreads);
+    vpImageFilter::getGradY(dIx, d2Ixy,fgdG,taillef, nbFilterThreads);
+    vpImageFilter::getGradY(dIy, d2Iy,fgdG,taillef, nbFilterThreads);
   }
 
   Nbpoint=0;
@@ -258,9 +258,9 @@ void vpTemplateTrackerMIESM::trackNoPyr(const vpImage<unsigned char> &I)
   dW=0;
 
   if(blur)
-    vpImageFilter::filter(I, BI,fgG,taillef);
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef);
+    vpImageFilter::filter(I, BI,fgG,taillef, nbFilterThreads);
+  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef, nbFilterThreads);
+  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef, nbFilterThreads);
   /*	if(ApproxHessian!=HESSIAN_NONSECOND && ApproxHessian!=HESSIAN_0 && ApproxHessian!=HESSIAN_NEW && ApproxHessian!=HESSIAN_YOUCEF)
   {
     getGradX(dIx, d2Ix,fgdG,taillef);
@@ -90,14 +90,14 @@ void vpTemplateTrackerMIInverseCompositional::initCompInverse(const vpImage<unsi
 {
   ptTemplateSupp=new vpTemplateTrackerPointSuppMIInv[templateSize];
 
-  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef);
-  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef);
+  vpImageFilter::getGradXGauss2D(I, dIx, fgG,fgdG,taillef, nbFilterThreads);
+  vpImageFilter::getGradYGauss2D(I, dIy, fgG,fgdG,taillef, nbFilterThreads);
 
   if(ApproxHessian!=HESSIAN_NONSECOND && ApproxHessian!=HESSIAN_0 && ApproxHessian!=HESSIAN_NEW && ApproxHessian!=HESSIAN_YOUCEF)
   {
-    vpImageFilter::getGradX(dIx, d2Ix,fgdG,taillef);
-    vpImageFilter::getGradY(dIx, d2Ixy,fgdG,taillef);
-    vpImageFilter::getGradY(dIy, d2Iy,fgdG,taillef);
+    vpImageFilter::getGradX(dIx, d2Ix,fgdG,taillef, nbFilterThreads);
+    vpImageFilter::getGradY(dIx, d2Ixy,fgdG,taillef, nbFilterThreads);
+    vpImageFilter::getGradY(dIy, d2Iy,fgdG,taillef, nbFilterThreads);
   }
 
   Warp->computeCoeff(p);
@@ -147,7 +147,7 @@ void vpTemplateTrackerMIInverseCompositional::initHessienDesired(const vpImage<u
   //erreur=0;
 
   if(blur)
-    vpImageFilter::filter(I, BI,fgG,taillef);
+    vpImageFilter::filter(I, BI,fgG,taillef, nbFilterThreads);
 
   zeroProbabilities();
   Warp->computeCoeff(p);
@@ -241,7 +241,7 @@ void vpTemplateTrackerMIInverseCompositional::trackNoPyr(const vpImage<unsigned
   dW=0;
 
   if(blur)
-    vpImageFilter::filter(I, BI,fgG,taillef);
+    vpImageFilter::filter(I, BI,fgG,taillef, nbFilterThreads);
 
   lambda=lambdaDep;
   double MI=0,MIprec=-1000;
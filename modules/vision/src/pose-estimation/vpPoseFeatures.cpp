@@ -34,6 +34,7 @@
  * Aurelien Yol
  *
  *****************************************************************************/
+#include <visp3/core/vpNormalEquationSolver.h>
 #include <visp3/vision/vpPoseFeatures.h>
 
 #ifdef VISP_HAVE_MODULE_VISUAL_FEATURES
@@ -441,6 +442,7 @@ void vpPoseFeatures::computePoseVVS(vpHomogeneousMatrix & cMo)
     vpMatrix L;
     vpColVector err;
     vpColVector v ;
+    vpNormalEquationSolver solver;
     
     unsigned int iter = 0;
     
@@ -455,9 +457,10 @@ void vpPoseFeatures::computePoseVVS(vpHomogeneousMatrix & cMo)
       // compute the residual
       r = err.sumSquare() ;
 
-      // compute the pseudo inverse of the interaction matrix
-      vpMatrix Lp ;
-      unsigned int rank = L.pseudoInverse(Lp,1e-16) ;
+      // solve the normal equations of the interaction matrix
+      solver.reset();
+      solver.addRows(L, err);
+      unsigned int rank = solver.solve(v);
       
       if(rank < 6){
         if(verbose)
@@ -467,7 +470,7 @@ void vpPoseFeatures::computePoseVVS(vpHomogeneousMatrix & cMo)
       }
       
       // compute the VVS control law
-      v = -lambda*Lp*err ;
+      v = -lambda*v ;
 
       cMo = vpExponentialMap::direct(v).inverse()*cMo ;
       if (iter++>vvsIterMax){
@@ -501,9 +504,10 @@ void vpPoseFeatures::computePoseRobustVVS(vpHomogeneousMatrix & cMo)
 
     // we stop the minimization when the error is bellow 1e-8
     vpMatrix L, W;
-    vpColVector w, res;
+    vpColVector w, res, Wd;
     vpColVector v ;
     vpColVector error ; // error vector
+    vpNormalEquationSolver solver, rankSolver;
     
     vpRobust robust(2*totalSize) ;
     robust.setThreshold(0.0000) ;
@@ -525,6 +529,7 @@ void vpPoseFeatures::computePoseRobustVVS(vpHomogeneousMatrix & cMo)
         res.resize(error.getRows()/2);
         w.resize(error.getRows()/2);
         W.resize(error.getRows(),error.getRows());
+        Wd.resize(error.getRows());
         w = 1;
       }
 
@@ -540,12 +545,21 @@ void vpPoseFeatures::computePoseRobustVVS(vpHomogeneousMatrix & cMo)
       {
         W[2*k][2*k] = w[k] ;
         W[2*k+1][2*k+1] = w[k] ;
+        Wd[2*k] = w[k] ;
+        Wd[2*k+1] = w[k] ;
+      }
+      // solve the normal equations of the weighted interaction matrix WL,
+      // the threshold on the singular values of WL and L being 1e-6
+      solver.reset();
+      for (unsigned int k=0 ; k < error.getRows() ; k++)
+        solver.addRow(L[k], error[k], Wd[k]*Wd[k]);
+      unsigned int rank = solver.solve(v, 0, 1e-12);
+      if(rank < 6){
+        // the rank is tested on the unweighted interaction matrix
+        rankSolver.reset();
+        rankSolver.addRows(L, error);
+        rank = rankSolver.getRank(1e-12);
       }
-      // compute the pseudo inverse of the interaction matrix
-      vpMatrix Lp ;
-      vpMatrix LRank;
-      (W*L).pseudoInverse(Lp,1e-6) ;
-      unsigned int rank = L.pseudoInverse(LRank,1e-6) ;
 
       if(rank < 6){
         if(verbose)
@@ -555,7 +569,7 @@ void vpPoseFeatures::computePoseRobustVVS(vpHomogeneousMatrix & cMo)
       }
 
       // compute the VVS control law
-      v = -lambda*Lp*W*error ;
+      v = -lambda*v ;
 
       cMo = vpExponentialMap::direct(v).inverse()*cMo ; ;
       if (iter++>vvsIterMax){
@@ -58,6 +58,7 @@
 #include <visp3/core/vpList.h>
 #include <visp3/vision/vpPoseException.h>
 #include <visp3/core/vpMath.h>
+#include <visp3/core/vpPointSet.h>
 
 #define eps 1e-6
 
@@ -131,6 +132,17 @@ bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMat
   }
 
 
+  //Object coordinates of the points, projected all at once for each pose
+  //hypothesis, and their measured normalized coordinates
+  vpPointSet model(listOfUniquePoints);
+  std::vector<double> xm, ym;
+  xm.reserve(size);
+  ym.reserve(size);
+  for (std::list<vpPoint>::const_iterator it = listOfUniquePoints.begin(); it != listOfUniquePoints.end(); ++it) {
+    xm.push_back(it->get_x());
+    ym.push_back(it->get_y());
+  }
+
   bool foundSolution = false;
   
   while (nbTrials < ransacMaxTrials && nbInliers < (unsigned)ransacNbInlierConsensus)
@@ -261,14 +273,12 @@ bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMat
       if (isPoseValid && r < ransacThreshold)
       {
         unsigned int nbInliersCur = 0;
-        unsigned int iter = 0;
-        for (std::list<vpPoint>::const_iterator it = listOfUniquePoints.begin(); it != listOfUniquePoints.end(); ++it)
+        model.track(cMo);
+        const double *x = model.get_x();
+        const double *y = model.get_y();
+        for (unsigned int iter = 0; iter < size; iter++)
         {
-          vpPoint pt = *it;
-          vpPoint p(pt) ;
-          p.track(cMo) ;
-
-          double d = vpMath::sqr(p.get_x() - pt.get_x()) + vpMath::sqr(p.get_y() - pt.get_y()) ;
+          double d = vpMath::sqr(x[iter] - xm[iter]) + vpMath::sqr(y[iter] - ym[iter]) ;
           double error = sqrt(d) ;
           if(error < ransacThreshold) {
             // the point is considered as inlier if the error is below the threshold
@@ -303,8 +313,6 @@ bool vpPose::poseRansac(vpHomogeneousMatrix & cMo, bool (*func)(vpHomogeneousMat
           else {
             cur_outliers.push_back(iter);
           }
-
-          iter++;
         }
 
         if(nbInliersCur > nbInliers)
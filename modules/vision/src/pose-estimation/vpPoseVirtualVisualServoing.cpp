@@ -43,6 +43,7 @@
 #include <visp3/vision/vpPose.h>
 #include <visp3/core/vpPoint.h>
 #include <visp3/core/vpExponentialMap.h>
+#include <visp3/core/vpNormalEquationSolver.h>
 #include <visp3/core/vpRobust.h>
 
 /*!
@@ -70,6 +71,7 @@ vpPose::poseVirtualVS(vpHomogeneousMatrix & cMo)
     vpColVector err(2*nb) ;
     vpColVector sd(2*nb),s(2*nb) ;
     vpColVector v ;
+    vpNormalEquationSolver solver;
     
     vpPoint P;
     std::list<vpPoint> lP ;
@@ -125,12 +127,13 @@ vpPose::poseVirtualVS(vpHomogeneousMatrix & cMo)
       // compute the residual
       r = err.sumSquare() ;
 
-      // compute the pseudo inverse of the interaction matrix
-      vpMatrix Lp ;
-      L.pseudoInverse(Lp,1e-16) ;
+      // solve the normal equations of the interaction matrix
+      solver.reset();
+      solver.addRows(L, err);
+      solver.solve(v);
 
       // compute the VVS control law
-      v = -lambda*Lp*err ;
+      v = -lambda*v ;
 
       //std::cout << "r=" << r <<std::endl ;
       // update the pose
@@ -170,13 +173,14 @@ vpPose::poseVirtualVSrobust(vpHomogeneousMatrix & cMo)
     vpMatrix W ;
     vpRobust robust((unsigned int)(2*listP.size())) ;
     robust.setThreshold(0.0000) ;
-    vpColVector w,res ;
+    vpColVector w,res,Wd ;
 
     unsigned int nb = (unsigned int)listP.size() ;
     vpMatrix L(2*nb,6) ;
     vpColVector error(2*nb) ;
     vpColVector sd(2*nb),s(2*nb) ;
     vpColVector v ;
+    vpNormalEquationSolver solver;
 
     listP.front() ;
     vpPoint P;
@@ -196,6 +200,7 @@ vpPose::poseVirtualVSrobust(vpHomogeneousMatrix & cMo)
     res.resize(s.getRows()/2) ;
     w.resize(s.getRows()/2) ;
     W.resize(s.getRows(), s.getRows()) ;
+    Wd.resize(s.getRows()) ;
     w =1 ;
 
     //while((int)((residu_1 - r)*1e12) !=0)
@@ -250,13 +255,18 @@ vpPose::poseVirtualVSrobust(vpHomogeneousMatrix & cMo)
       {
         W[2*k][2*k] = w[k] ;
         W[2*k+1][2*k+1] = w[k] ;
+        Wd[2*k] = w[k] ;
+        Wd[2*k+1] = w[k] ;
       }
-      // compute the pseudo inverse of the interaction matrix
-      vpMatrix Lp ;
-      (W*L).pseudoInverse(Lp,1e-6) ;
+      // solve the normal equations of the weighted interaction matrix WL,
+      // the threshold on the singular values of WL being 1e-6
+      solver.reset();
+      for (unsigned int k=0 ; k < error.getRows() ; k++)
+        solver.addRow(L[k], error[k], Wd[k]*Wd[k]);
+      solver.solve(v, 0, 1e-12);
 
       // compute the VVS control law
-      v = -lambda*Lp*W*error ;
+      v = -lambda*v ;
 
       cMo = vpExponentialMap::direct(v).inverse()*cMo ; ;
       if (iter++>vvsIterMax) break ;
@@ -94,6 +94,14 @@ class VISP_EXPORT vpFeatureLuminance : public vpBasicFeature
   //! Store the image (as a vector with intensity and gradient I, Ix, Iy) 
   vpLuminance *pixInfo ;
   int  firstTimeIn  ;
+  //! Image gradient along X
+  vpImage<float> imIx ;
+  //! Image gradient along Y
+  vpImage<float> imIy ;
+  //! Number of threads used to compute the image gradients
+  unsigned int nbThreads ;
+  //! If true, the image gradients are computed in float by whole rows
+  bool useFloatGradients ;
 
  public:
   vpFeatureLuminance() ;
@@ -132,6 +140,20 @@ class VISP_EXPORT vpFeatureLuminance : public vpBasicFeature
   void print(const unsigned int select = FEATURE_ALL ) const ;
 
   void setCameraParameters(vpCameraParameters &_cam)  ;
+  /*!
+    Set the number of threads used by buildFrom() to compute the image
+    gradients when they are computed in float, see setUseFloatGradients().
+    By default a single thread is used.
+  */
+  void setNbThreads(unsigned int n) { nbThreads = n ; }
+  /*!
+    If true, buildFrom() computes the image gradients with the float 7 taps
+    filter of vpImageFilter::getGradX() and vpImageFilter::getGradY() applied
+    by whole rows, possibly on several threads. It is faster, but the
+    gradients differ from the default double precision ones by a rounding
+    error. By default the gradients are computed in double precision.
+  */
+  void setUseFloatGradients(bool use) { useFloatGradients = use ; }
   void set_Z(const double Z) ;
 
 
@@ -104,7 +104,7 @@ vpFeatureLuminance::init(unsigned int _nbr, unsigned int _nbc, double _Z)
   Default constructor that build a visual feature.
 */
 vpFeatureLuminance::vpFeatureLuminance()
-  : Z(1), nbr(0), nbc(0), bord(10), pixInfo(NULL), firstTimeIn(0), cam()
+  : Z(1), nbr(0), nbc(0), bord(10), pixInfo(NULL), firstTimeIn(0), imIx(), imIy(), nbThreads(1), useFloatGradients(false), cam()
 {
     nbParameters = 1;
     dim_s = 0 ;
@@ -117,7 +117,7 @@ vpFeatureLuminance::vpFeatureLuminance()
  Copy constructor.
  */
 vpFeatureLuminance::vpFeatureLuminance(const vpFeatureLuminance& f)
-  : vpBasicFeature(f), Z(1), nbr(0), nbc(0), bord(10), pixInfo(NULL), firstTimeIn(0), cam()
+  : vpBasicFeature(f), Z(1), nbr(0), nbc(0), bord(10), pixInfo(NULL), firstTimeIn(0), imIx(), imIy(), nbThreads(1), useFloatGradients(false), cam()
 {
   *this = f;
 }
@@ -132,6 +132,8 @@ vpFeatureLuminance &vpFeatureLuminance::operator=(const vpFeatureLuminance& f)
   nbc = f.nbc;
   bord = f.bord;
   firstTimeIn = f.firstTimeIn;
+  nbThreads = f.nbThreads;
+  useFloatGradients = f.useFloatGradients;
   cam = f.cam;
   if (pixInfo)
     delete [] pixInfo;
@@ -219,6 +221,12 @@ vpFeatureLuminance::buildFrom(vpImage<unsigned char> &I)
 	}
     }
 
+  if (useFloatGradients) {
+    // The 3 pixels wide borders where the gradients are zero lie within bord
+    vpImageFilter::getGradX(I, imIx, nbThreads) ;
+    vpImageFilter::getGradY(I, imIy, nbThreads) ;
+  }
+
   l= 0 ;
   for (unsigned int i=bord; i < nbr-bord ; i++)
     {
@@ -226,8 +234,14 @@ vpFeatureLuminance::buildFrom(vpImage<unsigned char> &I)
       for (unsigned int j = bord ; j < nbc-bord; j++)
 	{
 	  // cout << dim_s <<" " <<l <<"  " <<i << "  " << j <<endl ;
-          Ix =  px * vpImageFilter::derivativeFilterX(I,i,j) ;
-	  Iy =  py * vpImageFilter::derivativeFilterY(I,i,j) ;
+          if (useFloatGradients) {
+            Ix =  px * imIx[i][j] ;
+            Iy =  py * imIy[i][j] ;
+          }
+          else {
+            Ix =  px * vpImageFilter::derivativeFilterX(I,i,j) ;
+            Iy =  py * vpImageFilter::derivativeFilterY(I,i,j) ;
+          }
 	  
 	  // Calcul de Z
 	  